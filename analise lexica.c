@@ -1,289 +1,389 @@
 /*
- * Analisador Léxico para C#
- * 
- * Este código implementa um analisador léxico (scanner) que identifica e classifica
- * tokens em código fonte C#. Ele processa o texto de entrada e gera uma sequência
- * de tokens classificados.
- * 
- * Características principais:
- * - Reconhece 20 palavras reservadas do C#
- * - Processa identificadores, números, strings e operadores
- * - Mantém controle de linha para rastreamento de erros
- * - Suporta comentários de linha (//) e bloco (/*)
- * - Detecta tokens desconhecidos para análise de erro
- * 
- * Estruturas principais:
- * - TokenType: Enumera todos os tipos possíveis de tokens
- * - Token: Estrutura que armazena informações de cada token
- *   (valor, linha, tipo e tamanho em bytes)
- * 
- * Limitações:
- * - Máximo de 1000 tokens por arquivo
- * - Tamanho máximo de 100 caracteres por token
+ * Programa da análise léxica
+ *
+ * Lê os arquivos de entrada, executa o analisador léxico (analise lexica.h)
+ * e exibe a lista de tokens encontrados em cada um. Um arquivo que não está
+ * em UTF-8 sem BOM é convertido antes da análise (codificacao de entrada.h)
+ * e a codificação original é informada. Os arquivos são lidos em lote à
+ * frente da análise (leitura em lote.h), então a leitura do próximo arquivo
+ * acontece enquanto o atual é analisado e exibido.
+ *
+ * Opções:
+ * - --definir <símbolo>: define um símbolo para '#if' (pode se repetir)
+ * - --inclusoes: resolve os '#include' (inclusao de arquivos.h); os tokens
+ *   de cada cabeçalho aparecem logo depois da diretiva, precedidos do nome
+ *   do arquivo, e cada cabeçalho é analisado uma única vez para todos os
+ *   arquivos de entrada; cada '#include' não encontrado gera um aviso com
+ *   arquivo, linha e coluna (localizacao de codigo.h)
+ * - --incluir <diretório>: acrescenta um diretório de busca (implica
+ *   --inclusoes; pode se repetir)
+ * - --trivia: grava os espaços e comentários pulados (sem --inclusoes) e
+ *   exibe, depois dos tokens, um resumo da trivia e os comentários de
+ *   documentação ('///') de cada token que os tem
+ * - --leitura <io_uring|pread>: forma da leitura em lote (padrão: io_uring,
+ *   ou pread se o kernel não permitir); com --inclusoes, os cabeçalhos
+ *   também são lidos por ela
+ * - --threads <n>: com --inclusoes, analisa os arquivos de entrada em n
+ *   threads que compartilham o cache de cabeçalhos e recebem os arquivos
+ *   do mesmo leitor em lote, na ordem em que ficam prontos (padrão: número
+ *   de processadores)
+ * - --paginas <nenhuma|transparentes|explicitas>: páginas da lista de
+ *   tokens e do código lido (memoria grande.h; padrão: transparentes)
+ * - --benchmark: analisa cada arquivo várias vezes com cada tipo de página
+ *   e exibe o melhor tempo, as falhas de leitura no dTLB e as falhas de
+ *   página de cada um
  */
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
+#include <unistd.h>
+#include "inclusao de arquivos.h"
+#include "leitura em lote.h"
 
-#define MAX_TOKENS 1000
-#define MAX_TOKEN_LENGTH 100
+#define LEXER_MAX_THREADS 64
+#define BENCHMARK_RUNS 5
 
-// Enumeração para tipos de tokens
-typedef enum {
-    KEYWORD,
-    TYPE,
-    IDENTIFIER,
-    NUM_LITERAL,
-    STRING_LITERAL,
-    SEMICOLON,
-    COMMA,
-    OPERATOR,
-    ASSIGNMENT,
-    OPEN_PARENTHESIS,
-    CLOSE_PARENTHESIS,
-    OPEN_BRACE,
-    CLOSE_BRACE,
-    OPEN_BRACKET,
-    CLOSE_BRACKET,
-    COMPARATOR,
-    QUOTE,           // Novo tipo para aspas
-    UNKNOWN
-} TokenType;
-
-// Estrutura para armazenar um token
+// Estrutura do trabalho compartilhado pelas threads (somente leitura, exceto o leitor)
 typedef struct {
-    char value[MAX_TOKEN_LENGTH];
-    int line;
-    TokenType type;
-    int size;  // Novo campo: Tamanho do token
-} Token;
+    HeaderCache *cache;
+    char **paths;
+    TranslationUnit *units;
+    int *status;
+    int count;
+    BatchReader reader;
+} UnitJob;
 
-// Lista de palavras-chave e tipos
-const char *keywords[] = {
-    "if", "else", "while", "for", "return",
-    "class", "public", "private", "static",
-    "void", "using", "namespace", "new", "try", "catch"
-};
-const char *types[] = {"int", "float", "double", "char", "bool"};
+// Função para exibir um token com a sua localização
+void printToken(const Token *token, int line, int column) {
+    printf("Token: %-15s Linha: %-4d Coluna: %-4d Tipo: %-19s Tamanho: %-3d Byte\n",
+           token->value, line, column, tokenTypeToString(token->type), token->size);
+}
 
-// Variáveis globais
-Token tokens[MAX_TOKENS];
-int tokenCount = 0;
+// Função para exibir os tokens
+void printTokens() {
+    printf("\nTokens encontrados:\n");
+    for (int i = 0; i < tokenCount; i++) {
+        int line, column;
+        offsetToLocation(tokens[i].offset, &line, &column);
+        printToken(&tokens[i], line, column);
+    }
+}
 
-// Função para identificar o tipo de token
-TokenType identifyTokenType(const char *word) {
-    for (int i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++) {
-        if (strcmp(word, keywords[i]) == 0)
-            return KEYWORD;
+// Função para exibir o resumo da trivia e os comentários de documentação de cada token
+void printTrivia(const char *code) {
+    int counts[4] = {0}, bytes = 0;
+    for (int i = 0; i < triviaCount; i++) {
+        counts[trivia[i].kind]++;
+        bytes += trivia[i].length;
     }
-    for (int i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
-        if (strcmp(word, types[i]) == 0)
-            return TYPE;
+    printf("\nTrivia: %d trecho(s), %d byte(s): %d de espaços, %d comentário(s) de linha, %d de bloco, "
+           "%d de documentação\n", triviaCount, bytes, counts[TRIVIA_WHITESPACE], counts[TRIVIA_LINE_COMMENT],
+           counts[TRIVIA_BLOCK_COMMENT], counts[TRIVIA_DOC_COMMENT]);
+    int previous = -1;
+    for (int i = 0; i < triviaCount; i++) {
+        // Só o primeiro comentário de documentação antes de cada token dispara a extração
+        if (trivia[i].kind != TRIVIA_DOC_COMMENT || trivia[i].token == previous) {
+            continue;
+        }
+        int index = previous = trivia[i].token, line, column;
+        char *text = docComment(code, index);
+        if (!text) {
+            continue;
+        }
+        if (index < tokenCount) {
+            offsetToLocation(tokens[index].offset, &line, &column);
+            printf("Documentação de '%s' (Linha %d):\n%s\n", tokens[index].value, line, text);
+        } else {
+            printf("Documentação no fim do arquivo:\n%s\n", text);
+        }
+        free(text);
     }
-    if (isdigit(word[0]) || (word[0] == '-' && isdigit(word[1])))
-        return NUM_LITERAL;
-    if (isalpha(word[0]) || word[0] == '_')
-        return IDENTIFIER;
-    return UNKNOWN;
 }
 
-// Função para adicionar um token à lista
-void addToken(const char *value, int line, TokenType type) {
-    if (tokenCount >= MAX_TOKENS) {
-        fprintf(stderr, "Erro: Número máximo de tokens excedido.\n");
-        exit(EXIT_FAILURE);
+// Função para exibir os tokens de uma unidade de tradução (o nome do arquivo aparece quando ele muda)
+void printUnitTokens(const TranslationUnit *unit) {
+    const FileTableEntry *current = sourceLocFile(unit->file->base);
+    printf("\nTokens encontrados:\n");
+    for (int s = 0; s < unit->spanCount; s++) {
+        const TokenSpan *span = &unit->spans[s];
+        const FileTableEntry *file = sourceLocFile(span->base);
+        if (file != current) {
+            current = file;
+            printf("Arquivo: %s\n", current->path);
+        }
+        for (int i = 0; i < span->count; i++) {
+            const char *path;
+            int line, column;
+            sourceLocResolve(span->base + (SourceLoc)span->tokens[i].offset, &path, &line, &column);
+            printToken(&span->tokens[i], line, column);
+        }
     }
-    Token *token = &tokens[tokenCount++];
-    strncpy(token->value, value, MAX_TOKEN_LENGTH);
-    token->line = line;
-    token->type = type;
-    token->size = strlen(value); // Armazena o tamanho do token
 }
 
-// Função para converter TokenType em string
-const char* tokenTypeToString(TokenType type) {
-    switch (type) {
-        case KEYWORD: return "KEYWORD";
-        case TYPE: return "TYPE";
-        case IDENTIFIER: return "IDENTIFIER";
-        case NUM_LITERAL: return "NUM_LITERAL";
-        case STRING_LITERAL: return "STRING_LITERAL";
-        case SEMICOLON: return "SEMICOLON";
-        case COMMA: return "COMMA";
-        case OPERATOR: return "OPERATOR";
-        case ASSIGNMENT: return "ASSIGNMENT";
-        case OPEN_PARENTHESIS: return "OPEN_PARENTHESIS";
-        case CLOSE_PARENTHESIS: return "CLOSE_PARENTHESIS";
-        case OPEN_BRACE: return "OPEN_BRACE";
-        case CLOSE_BRACE: return "CLOSE_BRACE";
-        case OPEN_BRACKET: return "OPEN_BRACKET";
-        case CLOSE_BRACKET: return "CLOSE_BRACKET";
-        case COMPARATOR: return "COMPARATOR";
-        case QUOTE: return "QUOTE";
-        case UNKNOWN: return "UNKNOWN";
-        default: return "UNKNOWN";
+// Função para avisar sobre os '#include' não resolvidos de uma unidade (arquivo, linha e coluna de cada um)
+void reportMissingIncludes(const TranslationUnit *unit) {
+    for (int i = 0; i < unit->missing; i++) {
+        const FileTableEntry *file = sourceLocFile(unit->missingAt[i]);
+        const char *path, *text = file->code + (unit->missingAt[i] - file->base);
+        int line, column;
+        sourceLocResolve(unit->missingAt[i], &path, &line, &column);
+        fprintf(stderr, "Aviso: %s:%d:%d: cabeçalho não encontrado: %.*s\n", path, line, column,
+                (int)strcspn(text, "\r\n"), text);
     }
 }
 
-// Função principal de análise léxica
-void lexicalAnalysis(const char *code) {
-    const char *ptr = code;
-    int lineNumber = 1;
+// Função executada por cada thread: monta as unidades de tradução dos arquivos que o leitor entrega
+void *unitWorker(void *context) {
+    UnitJob *job = context;
+    uint32_t index;
+    while ((index = batchReaderNext(&job->reader)) != UINT32_MAX) {
+        BatchFile *file = &job->reader.files[index];
+        job->status[index] = file->code ? unitLoad(&job->units[index], job->cache, job->paths[index], file->code,
+                                                   file->size)
+                                        : -1;
+    }
+    return NULL;
+}
 
-    while (*ptr) {
-        // Ignorar espaços e quebras de linha
-        if (isspace(*ptr)) {
-            if (*ptr == '\n') {
-                lineNumber++;
-            }
-            ptr++;
-            continue;
-        }
+// Função para analisar os arquivos resolvendo os '#include'; devolve o código de saída
+int analyzeWithIncludes(HeaderCache *cache, char **paths, int count, int threads, BatchReadMode readMode) {
+    UnitJob job = {.cache = cache, .paths = paths, .units = calloc(count, sizeof(TranslationUnit)),
+                   .status = calloc(count, sizeof(int)), .count = count};
+    pthread_t workers[LEXER_MAX_THREADS];
+    struct timespec start, end;
+    if (!job.units || !job.status) {
+        fprintf(stderr, "Erro: Falha ao alocar as unidades de tradução.\n");
+        return EXIT_FAILURE;
+    }
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    threads = threads > LEXER_MAX_THREADS ? LEXER_MAX_THREADS : threads;
+    threads = threads > count ? count : threads;
 
-        // Ignorar comentários de linha
-        if (*ptr == '/' && *(ptr + 1) == '/') {
-            while (*ptr && *ptr != '\n') ptr++;
-            continue;
-        }
+    // A thread principal também trabalha
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (batchReaderStart(&job.reader, paths, (uint32_t)count, readMode) != 0) {
+        free(job.units);
+        free(job.status);
+        return EXIT_FAILURE;
+    }
+    cache->reader = &job.reader;
+    int started = 1;
+    while (started < threads && pthread_create(&workers[started], NULL, unitWorker, &job) == 0) {
+        started++;
+    }
+    unitWorker(&job);
+    for (int t = 1; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    cache->reader = NULL;
+    batchReaderFinish(&job.reader);
+    clock_gettime(CLOCK_MONOTONIC, &end);
 
-        // Ignorar comentários de bloco '/**/'
-        if (*ptr == '/' && *(ptr + 1) == '*') {
-            ptr += 2; // Avançar sobre '/*'
-            int insideBlockComment = 1;
-            while (insideBlockComment && *ptr) {
-                if (*ptr == '*' && *(ptr + 1) == '/') {
-                    ptr += 2;
-                    insideBlockComment = 0;
-                } else if (*ptr == '\n') {
-                    lineNumber++;
-                    ptr++;
-                } else {
-                    ptr++;
-                }
-            }
+    int status = EXIT_SUCCESS, spliced = 0, skipped = 0, missing = 0, tooDeep = 0;
+    long tokenTotal = 0;
+    for (int i = 0; i < count; i++) {
+        TranslationUnit *unit = &job.units[i];
+        if (job.status[i] != 0) {
+            status = EXIT_FAILURE;
             continue;
         }
+        printf("%sAnalisando código do arquivo: %s\n", i ? "\n" : "", paths[i]);
+        printUnitTokens(unit);
+        reportMissingIncludes(unit);
+        spliced += unit->spliced;
+        skipped += unit->skipped;
+        missing += unit->missing;
+        tooDeep += unit->tooDeep;
+        tokenTotal += unit->tokenCount;
+        unitFree(unit);
+    }
 
-        // Delimitadores
-        if (strchr(";,(){}[]", *ptr)) {
-            char token[2] = {*ptr, '\0'};
-            addToken(token, lineNumber, (*ptr == ';') ? SEMICOLON :
-                                          (*ptr == ',') ? COMMA :
-                                          (*ptr == '(') ? OPEN_PARENTHESIS :
-                                          (*ptr == ')') ? CLOSE_PARENTHESIS :
-                                          (*ptr == '{') ? OPEN_BRACE :
-                                          (*ptr == '}') ? CLOSE_BRACE :
-                                          (*ptr == '[') ? OPEN_BRACKET :
-                                          CLOSE_BRACKET);
-            ptr++;
-            continue;
-        }
+    double elapsed = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    printf("\nCabeçalhos: %ld analisado(s) uma vez (%.3f ms), %d inclusão(ões) com tokens do cache, "
+           "%d pulada(s) por include guard ou #pragma once, %d não encontrada(s)\n",
+           atomic_load(&cache->lexed), atomic_load(&cache->lexNs) / 1e6, spliced, skipped, missing);
+    if (tooDeep) {
+        printf("Aviso: %d inclusão(ões) além de %d níveis de aninhamento ignorada(s).\n", tooDeep,
+               INCLUDE_MAX_DEPTH);
+    }
+    printf("Tempo: %.3f ms para %d arquivo(s), %ld token(s) (%d thread(s))\n", elapsed, count, tokenTotal, threads);
+    free(job.units);
+    free(job.status);
+    return status;
+}
 
-        // Verificador de Operadores e atribuidores
-        if (strchr("=+-*/><!", *ptr)) {
-            char token[3] = {*ptr, '\0', '\0'};
-            if (*(ptr + 1) == '=') {
-                token[1] = *(ptr + 1);
-                ptr++;
-            }
-            addToken(token, lineNumber, (*ptr == '=') ? ASSIGNMENT : OPERATOR);
-            ptr++;
-            continue;
-        }
+// Função para exibir uma contagem dos contadores de desempenho ("n/d" se o contador não existe)
+void printCounter(uint64_t value) {
+    if (value == UINT64_MAX) {
+        printf(" %14s", "n/d");
+    } else {
+        printf(" %14llu", (unsigned long long)value);
+    }
+}
 
-        // Verificação de números (incluindo números de ponto flutuante)
-        if (isdigit(*ptr) || (*ptr == '.' && isdigit(*(ptr + 1)))) {
-            char number[MAX_TOKEN_LENGTH];
-            int length = 0;
-            int hasDot = 0;
-            while (isdigit(*ptr) || (*ptr == '.' && !hasDot)) {
-                if (*ptr == '.') {
-                    hasDot = 1; // Marca a presença de um ponto decimal
-                }
-                if (length < MAX_TOKEN_LENGTH - 1) {
-                    number[length++] = *ptr;
-                }
-                ptr++;
-            }
-            number[length] = '\0';
-            addToken(number, lineNumber, NUM_LITERAL);
+// Função para medir a análise de cada arquivo com cada tipo de página; devolve o código de saída
+int runBenchmark(char **paths, int count) {
+    int status = EXIT_SUCCESS;
+    int tlb = tlbCounterOpen(1), faults = tlbCounterOpen(0);
+    HugePageMode configured = hugePageMode;
+    for (int i = 0; i < count; i++) {
+        long size;
+        char *source = readSourceFile(paths[i], &size);
+        if (!source) {
+            status = EXIT_FAILURE;
             continue;
         }
-
-        // Identificadores e palavras-chave
-        if (isalnum(*ptr) || *ptr == '_') {
-            char word[MAX_TOKEN_LENGTH];
-            int length = 0;
-            while (isalnum(*ptr) || *ptr == '_') {
-                if (length < MAX_TOKEN_LENGTH - 1) {
-                    word[length++] = *ptr;
+        printf("%sArquivo: %s (%ld bytes)\n", i ? "\n" : "", paths[i], size);
+        printf("%-14s %10s %10s %10s %14s %14s\n", "Páginas", "Tokens", "Tempo (ms)", "MB/s", "Falhas dTLB",
+               "Falhas página");
+        for (int mode = HUGE_PAGES_NONE; mode <= HUGE_PAGES_EXPLICIT; mode++) {
+            hugePageMode = (HugePageMode)mode;
+            double best = 0;
+            uint64_t bestMisses = 0, bestFaults = 0;
+            int lexed = 0;
+            for (int run = 0; run < BENCHMARK_RUNS; run++) {
+                // O código também é copiado para um bloco do modo medido
+                char *code = bigAlloc((size_t)size + 1);
+                if (!code) {
+                    fprintf(stderr, "Erro: Falha ao alocar o código.\n");
+                    exit(EXIT_FAILURE);
+                }
+                memcpy(code, source, (size_t)size + 1);
+                struct timespec start, end;
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                tlbCounterStart(tlb);
+                tlbCounterStart(faults);
+                tokenCount = 0;
+                lexicalAnalysis(code);
+                uint64_t misses = tlbCounterStop(tlb), pageFaults = tlbCounterStop(faults);
+                clock_gettime(CLOCK_MONOTONIC, &end);
+                double elapsed = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+                lexed = tokenCount;
+                freeTokens();
+                freeLineIndex();
+                bigFree(code);
+                if (run == 0 || elapsed < best) {
+                    best = elapsed;
+                    bestMisses = misses;
+                    bestFaults = pageFaults;
                 }
-                ptr++;
             }
-            word[length] = '\0';
-            addToken(word, lineNumber, identifyTokenType(word));
-            continue;
+            printf("%-14s %10d %10.3f %10.1f", hugePageModeName((HugePageMode)mode), lexed, best,
+                   best > 0 ? size / 1e3 / best : 0.0);
+            printCounter(bestMisses);
+            printCounter(bestFaults);
+            printf("\n");
         }
-
-        // Identificar aspas
-        if (*ptr == '"') {
-            char quote[2] = {*ptr, '\0'};
-            addToken(quote, lineNumber, QUOTE);
-            ptr++;
-            continue;
-        }
-
-        // Verificador de Token desconhecido
-        char unknown[2] = {*ptr, '\0'};
-        addToken(unknown, lineNumber, UNKNOWN);
-        ptr++;
+        free(source);
     }
-}
-
-// Função para exibir os tokens
-void printTokens() {
-    printf("\nTokens encontrados:\n");
-    for (int i = 0; i < tokenCount; i++) {
-        printf("Token: %-15s Linha: %-4d Tipo: %-19s Tamanho: %-3d Byte\n",
-               tokens[i].value, tokens[i].line, tokenTypeToString(tokens[i].type), tokens[i].size);
+    if (tlb < 0) {
+        printf("\nFalhas dTLB: n/d (sem contador de hardware ou sem permissão em perf_event_paranoid)\n");
+    }
+    if (atomic_load(&bigHugetlbFallbacks)) {
+        printf("Aviso: %ld bloco(s) sem páginas explícitas reservadas (/proc/sys/vm/nr_hugepages); "
+               "usadas as transparentes.\n", atomic_load(&bigHugetlbFallbacks));
+    }
+    if (tlb >= 0) {
+        close(tlb);
     }
+    if (faults >= 0) {
+        close(faults);
+    }
+    hugePageMode = configured;
+    return status;
 }
 
 // Função principal
-int main() {
-    // Abrir o arquivo fonte
-    FILE *file = fopen("../input.txt", "r");
-
-    // Verificador de erro
-    if (!file) {
-        perror("Erro ao abrir o arquivo");
+int main(int argc, char *argv[]) {
+    char **paths = malloc(argc * sizeof(char *));
+    int pathCount = 0, includes = 0, threads = 0, benchmark = 0;
+    BatchReadMode readMode = BATCH_READ_AUTO;
+    HeaderCache *cache = malloc(sizeof(HeaderCache));
+    if (!paths || !cache) {
+        fprintf(stderr, "Erro: Falha ao alocar memória.\n");
         return EXIT_FAILURE;
     }
+    headerCacheInit(cache);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--definir") == 0 && i + 1 < argc) {
+            defineSymbol(argv[++i]);
+        } else if (strcmp(argv[i], "--inclusoes") == 0) {
+            includes = 1;
+        } else if (strcmp(argv[i], "--incluir") == 0 && i + 1 < argc) {
+            includeDirectory(cache, argv[++i]);
+            includes = 1;
+        } else if (strcmp(argv[i], "--leitura") == 0 && i + 1 < argc) {
+            readMode = strcmp(argv[++i], "pread") == 0 ? BATCH_READ_PREAD : BATCH_READ_AUTO;
+        } else if (strcmp(argv[i], "--trivia") == 0) {
+            recordTrivia = 1;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--paginas") == 0 && i + 1 < argc) {
+            if (hugePageModeParse(argv[++i], &hugePageMode) != 0) {
+                fprintf(stderr, "Erro: Tipo de página desconhecido: %s\n", argv[i]);
+                free(cache);
+                free(paths);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--benchmark") == 0) {
+            benchmark = 1;
+        } else {
+            paths[pathCount++] = argv[i];
+        }
+    }
+    if (pathCount == 0) {
+        paths[pathCount++] = "../input.txt";
+    }
 
-    // Ler todo o conteúdo do arquivo
-    fseek(file, 0, SEEK_END);
-    long fileSize = ftell(file);
-    rewind(file);
-    char *code = malloc(fileSize + 1);
+    int status = EXIT_SUCCESS;
+    if (benchmark) {
+        status = runBenchmark(paths, pathCount);
+    } else if (includes) {
+        recordTrivia = 0;   // A trivia é só do modo de um arquivo por vez
+        status = analyzeWithIncludes(cache, paths, pathCount, threads, readMode);
+    } else {
+        BatchReader reader;
+        if (batchReaderStart(&reader, paths, (uint32_t)pathCount, readMode) != 0) {
+            free(cache);
+            free(paths);
+            return EXIT_FAILURE;
+        }
+        for (int i = 0; i < pathCount; i++) {
+            // Todo o conteúdo do arquivo fonte, já lido em segundo plano
+            BatchFile *file = batchReaderTake(&reader, (uint32_t)i);
+            SourceEncoding encoding = file->encoding;
+            char *code = file->code;
+            if (!code) {
+                status = EXIT_FAILURE;
+                continue;
+            }
 
-    // Verificador de problema de alocação de memória
-    if (!code) {
-        perror("Erro ao alocar memória");
-        fclose(file);
-        return EXIT_FAILURE;
-    }
-    fread(code, 1, fileSize, file);
-    code[fileSize] = '\0';
-    fclose(file);
+            // Analisar o código
+            printf("%sAnalisando código do arquivo: %s\n", i ? "\n" : "", paths[i]);
+            if (encoding != ENCODING_UTF8) {
+                printf("Codificação: %s, %s\n", encodingName(encoding),
+                       encoding == ENCODING_UTF8_BOM ? "BOM removido" : "convertido para UTF-8");
+            }
+            tokenCount = 0;
+            lexicalAnalysis(code);
+            printTokens();
+            if (recordTrivia) {
+                printTrivia(code);
+            }
 
-    // Analisar o código
-    printf("Analisando código do arquivo: ../input.txt\n");
-    lexicalAnalysis(code);
-    printTokens();
+            // Limpar memória
+            freeTokens();
+            freeTrivia();
+            freeLineIndex();
+            free(code);
+        }
+        batchReaderFinish(&reader);
+    }
 
-    // Limpar memória
-    free(code);
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+    headerCacheFree(cache);
+    fileTableFree();
+    free(cache);
+    free(paths);
+    return status;
+}
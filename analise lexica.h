@@ -0,0 +1,1036 @@
+/*
+ * Analisador Léxico para C#
+ * 
+ * Este código implementa um analisador léxico (scanner) que identifica e classifica
+ * tokens em código fonte C#. Ele processa o texto de entrada e gera uma sequência
+ * de tokens classificados.
+ * 
+ * Características principais:
+ * - Reconhece 20 palavras reservadas do C#
+ * - Processa identificadores, números, strings e operadores
+ * - Identificadores com letras Unicode (ID_Start/ID_Continue de tabelas
+ *   unicode.h, em UTF-8). Os trechos só ASCII são medidos em blocos de 32
+ *   bytes (o limite avança sempre que a análise o passa) e, dentro deles,
+ *   nenhum byte passa pela decodificação UTF-8; um caractere não ASCII que
+ *   não forma identificador vira um único token UNKNOWN
+ * - Guarda apenas o deslocamento em bytes de cada token; linha e coluna são
+ *   calculadas sob demanda por um índice de início de linhas
+ * - Suporta comentários de linha (//) e bloco (/*)
+ *   (ignorados entre aspas, onde '\"' não fecha a string)
+ * - Detecta tokens desconhecidos para análise de erro
+ * - Classifica os caracteres por uma tabela própria de 256 entradas
+ *   (charClasses) em vez de <ctype.h>: o resultado não depende de LC_CTYPE
+ *   e um 'char' negativo é um índice válido
+ * - readSourceFile entrega o arquivo em UTF-8 (codificacao de entrada.h
+ *   converte UTF-16 e Latin-1 e remove o BOM)
+ * - Diretivas ('#' no início da linha) viram um único token DIRECTIVE com o
+ *   texto da diretiva até o fim da linha ou até um comentário
+ * - Compilação condicional: '#if', '#elif', '#else' e '#endif' (e '#ifdef',
+ *   '#ifndef') são avaliados com os símbolos de '#define'/'#undef' e de
+ *   defineSymbol; os trechos inativos são pulados sem gerar tokens, por uma
+ *   varredura em blocos de 16 bytes que só para em '#' no início de linha
+ * 
+ * Estruturas principais:
+ * - TokenType: Enumera todos os tipos possíveis de tokens
+ * - Token: Estrutura que armazena informações de cada token
+ *   (valor, deslocamento, tipo e tamanho em bytes)
+ * - lineStarts: Tabela de inícios de linha, construída na primeira vez que
+ *   uma localização (linha, coluna) é necessária
+ * - braceMatch: Índice lateral que liga cada '{' ao seu '}' (e vice-versa),
+ *   permitindo pular um corpo inteiro em O(1)
+ * - tokens, braceMatch e braceStack crescem com bigRealloc (memoria
+ *   grande.h): acima de 4 MB ficam em páginas de 2 MB, no nó NUMA da
+ *   thread que analisa, e são liberados com bigFree
+ * - tokenSink: Destino opcional que recebe os tokens em fluxo em vez da
+ *   lista global (usado pelo pipeline léxico -> sintático)
+ * - trivia: Tabela lateral opcional (recordTrivia) com os trechos de
+ *   espaços e comentários pulados, cada um ligado ao token que o segue.
+ *   Comentários de documentação ('///' e os de bloco que começam com duas
+ *   estrelas) são marcados e o texto só é extraído quando pedido
+ *   (docComment). Desligada, a análise não grava nada e pula os espaços um
+ *   byte por vez, como antes
+ *
+ * Threads: a lista de tokens e o estado das diretivas são próprios de cada
+ * thread (_Thread_local), então threads diferentes podem chamar lexTokens
+ * ao mesmo tempo. O código fonte, o índice de linhas, tokenSink e os
+ * símbolos de defineSymbol continuam globais (lexicalAnalysis os reinicia).
+ * 
+ * Limitações:
+ * - Tamanho máximo de 100 caracteres por token (o texto guardado de uma
+ *   diretiva é truncado, mas 'size' cobre a diretiva inteira)
+ * - Até MAX_CONDITIONAL_DEPTH '#if' aninhados e MAX_DIRECTIVE_SYMBOLS símbolos.
+ *   Um '#if' mais fundo não é avaliado: todos os seus ramos ficam ativos,
+ *   mas o nível é contado para que cada '#endif' feche o seu próprio '#if'
+ * - Os trechos inativos de '#if' não entram na tabela de trivia (ficam
+ *   entre o token da diretiva e o próximo token)
+ */
+
+#ifndef ANALISE_LEXICA_H
+#define ANALISE_LEXICA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "codificacao de entrada.h"
+#include "memoria grande.h"
+#include "tabelas unicode.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define INITIAL_TOKEN_CAPACITY 1024
+#define MAX_TOKEN_LENGTH 100
+#define MAX_DIRECTIVE_SYMBOLS 64
+#define MAX_CONDITIONAL_DEPTH 64
+
+// Classes de caracteres (bits de charClasses)
+#define CHAR_SPACE 0x01          // ' ', '\t', '\n', '\v', '\f', '\r'
+#define CHAR_DIGIT 0x02
+#define CHAR_ALPHA 0x04          // Letras ASCII
+#define CHAR_UNDERSCORE 0x08
+#define CHAR_DELIMITER 0x10      // ; , ( ) { } [ ]
+#define CHAR_OPERATOR 0x20       // = + - * / % > < !
+#define CHAR_IDENTIFIER (CHAR_ALPHA | CHAR_DIGIT | CHAR_UNDERSCORE)
+
+// Macro para testar as classes de um caractere (qualquer 'char', inclusive negativo)
+#define CHAR_IS(c, classes) (charClasses[(unsigned char)(c)] & (classes))
+
+// Tabela de classes dos 256 valores de byte: não depende de LC_CTYPE, ao contrário de <ctype.h>.
+// Os bytes a partir de 0x80 não têm classe (UTF-8 é tratado à parte)
+#define SP CHAR_SPACE
+#define DG CHAR_DIGIT
+#define AL CHAR_ALPHA
+#define UN CHAR_UNDERSCORE
+#define DL CHAR_DELIMITER
+#define OP CHAR_OPERATOR
+static const unsigned char charClasses[256] = {
+     0,  0,  0,  0,  0,  0,  0,  0,   // 0x00
+     0, SP, SP, SP, SP, SP,  0,  0,   // 0x08
+     0,  0,  0,  0,  0,  0,  0,  0,   // 0x10
+     0,  0,  0,  0,  0,  0,  0,  0,   // 0x18
+    SP, OP,  0,  0,  0, OP,  0,  0,   // 0x20
+    DL, DL, OP, OP, DL, OP,  0, OP,   // 0x28
+    DG, DG, DG, DG, DG, DG, DG, DG,   // 0x30
+    DG, DG,  0, DL, OP, OP, OP,  0,   // 0x38
+     0, AL, AL, AL, AL, AL, AL, AL,   // 0x40
+    AL, AL, AL, AL, AL, AL, AL, AL,   // 0x48
+    AL, AL, AL, AL, AL, AL, AL, AL,   // 0x50
+    AL, AL, AL, DL,  0, DL,  0, UN,   // 0x58
+     0, AL, AL, AL, AL, AL, AL, AL,   // 0x60
+    AL, AL, AL, AL, AL, AL, AL, AL,   // 0x68
+    AL, AL, AL, AL, AL, AL, AL, AL,   // 0x70
+    AL, AL, AL, DL,  0, DL,  0,  0,   // 0x78
+};
+#undef SP
+#undef DG
+#undef AL
+#undef UN
+#undef DL
+#undef OP
+
+// Enumeração para tipos de tokens
+typedef enum {
+    KEYWORD,
+    TYPE,
+    IDENTIFIER,
+    NUM_LITERAL,
+    STRING_LITERAL,
+    SEMICOLON,
+    COMMA,
+    OPERATOR,
+    ASSIGNMENT,
+    OPEN_PARENTHESIS,
+    CLOSE_PARENTHESIS,
+    OPEN_BRACE,
+    CLOSE_BRACE,
+    OPEN_BRACKET,
+    CLOSE_BRACKET,
+    COMPARATOR,
+    QUOTE,           // Novo tipo para aspas
+    DIRECTIVE,       // Linha de pré-processamento ('#include <stdio.h>', '#if DEBUG', ...)
+    UNKNOWN
+} TokenType;
+
+// Estrutura para armazenar um token
+typedef struct {
+    char value[MAX_TOKEN_LENGTH];
+    int offset;  // Deslocamento em bytes no código fonte
+    TokenType type;
+    int size;  // Novo campo: Tamanho do token
+} Token;
+
+// Enumeração para tipos de trivia (trecho pulado entre tokens)
+typedef enum {
+    TRIVIA_WHITESPACE,
+    TRIVIA_LINE_COMMENT,
+    TRIVIA_BLOCK_COMMENT,
+    TRIVIA_DOC_COMMENT      // '///' ou '/** ... * /'
+} TriviaKind;
+
+// Estrutura de um trecho de trivia (12 bytes)
+typedef struct {
+    int offset;              // Deslocamento em bytes no código fonte
+    unsigned length : 30;
+    unsigned kind : 2;       // TriviaKind
+    int token;               // Índice do token seguinte (tokenCount no fim do arquivo)
+} Trivia;
+
+// Lista de palavras-chave e tipos
+const char *keywords[] = {
+    "if", "else", "while", "for", "return",
+    "class", "public", "private", "static",
+    "void", "using", "namespace", "new", "try", "catch"
+};
+const char *types[] = {"int", "float", "double", "char", "bool"};
+
+// Variáveis globais (a lista de tokens é de cada thread)
+_Thread_local Token *tokens = NULL;
+_Thread_local int tokenCount = 0;
+_Thread_local int tokenCapacity = 0;
+
+// Pares de chaves: índice do token correspondente (-1 se não houver par)
+_Thread_local int *braceMatch = NULL;
+_Thread_local int *braceStack = NULL;
+_Thread_local int braceDepth = 0;
+
+// Tabela de trivia (gravada só com recordTrivia ligado), em ordem de deslocamento
+int recordTrivia = 0;
+_Thread_local Trivia *trivia = NULL;
+_Thread_local int triviaCount = 0;
+_Thread_local int triviaCapacity = 0;
+
+// Destino dos tokens em fluxo: devolve onde gravar o próximo token (NULL = lista global)
+Token *(*tokenSink)(void *context) = NULL;
+void *tokenSinkContext = NULL;
+
+// Índice de linhas (construído sob demanda)
+const char *sourceCode = NULL;
+int *lineStarts = NULL;
+int lineCount = 0;
+
+// Símbolos de compilação condicional: os de defineSymbol valem para todos os arquivos,
+// os de '#define' e '#undef' só para o arquivo sendo analisado
+char predefinedSymbols[MAX_DIRECTIVE_SYMBOLS][MAX_TOKEN_LENGTH];
+int predefinedSymbolCount = 0;
+_Thread_local char directiveSymbols[MAX_DIRECTIVE_SYMBOLS][MAX_TOKEN_LENGTH];
+_Thread_local int directiveSymbolCount = 0;
+
+// '#if' abertos: 1 se algum ramo do '#if' já foi escolhido
+_Thread_local int conditionalTaken[MAX_CONDITIONAL_DEPTH];
+_Thread_local int conditionalDepth = 0;
+_Thread_local int conditionalOverflow = 0;   // '#if' abertos além de MAX_CONDITIONAL_DEPTH
+// O próximo lexTokens começa no meio de uma linha (ex.: depois do '*/' de um comentário de linhas anteriores):
+// um '#' antes da primeira quebra de linha não inicia uma diretiva. Vale para uma chamada
+_Thread_local int lexMidLine = 0;
+_Thread_local const char *sourceEnd = NULL;
+
+// Função para identificar o tipo de token
+TokenType identifyTokenType(const char *word) {
+    for (int i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++) {
+        if (strcmp(word, keywords[i]) == 0)
+            return KEYWORD;
+    }
+    for (int i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        if (strcmp(word, types[i]) == 0)
+            return TYPE;
+    }
+    if (CHAR_IS(word[0], CHAR_DIGIT) || (word[0] == '-' && CHAR_IS(word[1], CHAR_DIGIT)))
+        return NUM_LITERAL;
+    if (CHAR_IS(word[0], CHAR_ALPHA | CHAR_UNDERSCORE) || (unsigned char)word[0] >= 0x80)   // Não ASCII: letra Unicode já verificada
+        return IDENTIFIER;
+    return UNKNOWN;
+}
+
+// Função para dobrar a capacidade da lista de tokens (e dos índices paralelos)
+void growTokens() {
+    int capacity = tokenCapacity ? tokenCapacity * 2 : INITIAL_TOKEN_CAPACITY;
+    Token *grownTokens = bigRealloc(tokens, capacity * sizeof(Token));
+    int *grownMatch = bigRealloc(braceMatch, capacity * sizeof(int));
+    int *grownStack = bigRealloc(braceStack, capacity * sizeof(int));
+    if (!grownTokens || !grownMatch || !grownStack) {
+        fprintf(stderr, "Erro: Falha ao alocar a lista de tokens.\n");
+        exit(EXIT_FAILURE);
+    }
+    tokens = grownTokens;
+    braceMatch = grownMatch;
+    braceStack = grownStack;
+    tokenCapacity = capacity;
+}
+
+// Função para liberar a lista de tokens
+void freeTokens() {
+    bigFree(tokens);
+    bigFree(braceMatch);
+    bigFree(braceStack);
+    tokens = NULL;
+    braceMatch = braceStack = NULL;
+    tokenCount = tokenCapacity = 0;
+}
+
+// Função para adicionar um token à lista; devolve o token gravado
+Token *addToken(const char *value, int offset, TokenType type) {
+    Token *token;
+    if (tokenSink) {
+        token = tokenSink(tokenSinkContext);
+    } else {
+        if (tokenCount >= tokenCapacity) {
+            growTokens();
+        }
+        token = &tokens[tokenCount];
+    }
+    tokenCount++;
+    size_t length = strnlen(value, MAX_TOKEN_LENGTH - 1);   // Os chamadores já truncam o texto
+    memcpy(token->value, value, length);
+    token->value[length] = '\0';
+    token->offset = offset;
+    token->type = type;
+    token->size = (int)length; // Armazena o tamanho do token
+    return token;
+}
+
+// Função para registrar um trecho de trivia antes do próximo token
+static void addTrivia(int offset, int length, TriviaKind kind) {
+    if (triviaCount >= triviaCapacity) {
+        int capacity = triviaCapacity ? triviaCapacity * 2 : INITIAL_TOKEN_CAPACITY;
+        Trivia *grown = realloc(trivia, capacity * sizeof(Trivia));
+        if (!grown) {
+            fprintf(stderr, "Erro: Falha ao alocar a tabela de trivia.\n");
+            exit(EXIT_FAILURE);
+        }
+        trivia = grown;
+        triviaCapacity = capacity;
+    }
+    trivia[triviaCount++] = (Trivia){offset, (unsigned)length, kind, tokenCount};
+}
+
+// Função para liberar a tabela de trivia
+void freeTrivia() {
+    free(trivia);
+    trivia = NULL;
+    triviaCount = triviaCapacity = 0;
+}
+
+// Função para converter TokenType em string
+const char* tokenTypeToString(TokenType type) {
+    switch (type) {
+        case KEYWORD: return "KEYWORD";
+        case TYPE: return "TYPE";
+        case IDENTIFIER: return "IDENTIFIER";
+        case NUM_LITERAL: return "NUM_LITERAL";
+        case STRING_LITERAL: return "STRING_LITERAL";
+        case SEMICOLON: return "SEMICOLON";
+        case COMMA: return "COMMA";
+        case OPERATOR: return "OPERATOR";
+        case ASSIGNMENT: return "ASSIGNMENT";
+        case OPEN_PARENTHESIS: return "OPEN_PARENTHESIS";
+        case CLOSE_PARENTHESIS: return "CLOSE_PARENTHESIS";
+        case OPEN_BRACE: return "OPEN_BRACE";
+        case CLOSE_BRACE: return "CLOSE_BRACE";
+        case OPEN_BRACKET: return "OPEN_BRACKET";
+        case CLOSE_BRACKET: return "CLOSE_BRACKET";
+        case COMPARATOR: return "COMPARATOR";
+        case QUOTE: return "QUOTE";
+        case DIRECTIVE: return "DIRECTIVE";
+        case UNKNOWN: return "UNKNOWN";
+        default: return "UNKNOWN";
+    }
+}
+
+// Função para registrar o início de uma nova linha em um índice
+static void appendLineStart(int **starts, int *count, int *capacity, int offset) {
+    if (*count >= *capacity) {
+        *capacity *= 2;
+        int *grown = realloc(*starts, *capacity * sizeof(int));
+        if (!grown) {
+            fprintf(stderr, "Erro: Falha ao alocar o índice de linhas.\n");
+            exit(EXIT_FAILURE);
+        }
+        *starts = grown;
+    }
+    (*starts)[(*count)++] = offset;
+}
+
+// Função para construir o índice de inícios de linha de 'code' (varre o código em blocos de 16 bytes)
+int *buildLineStarts(const char *code, int *count) {
+    int length = (int)strlen(code);
+    int capacity = 64;
+    int i = 0;
+
+    int *starts = malloc(capacity * sizeof(int));
+    if (!starts) {
+        fprintf(stderr, "Erro: Falha ao alocar o índice de linhas.\n");
+        exit(EXIT_FAILURE);
+    }
+    *count = 0;
+    appendLineStart(&starts, count, &capacity, 0);
+
+#ifdef __SSE2__
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(code + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+        while (mask) {
+            appendLineStart(&starts, count, &capacity, i + __builtin_ctz(mask) + 1);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < length; i++) {
+        if (code[i] == '\n') {
+            appendLineStart(&starts, count, &capacity, i + 1);
+        }
+    }
+    return starts;
+}
+
+// Função para construir o índice de linhas global (de sourceCode)
+void buildLineIndex() {
+    lineStarts = buildLineStarts(sourceCode, &lineCount);
+}
+
+// Função para converter um deslocamento em linha e coluna com um índice qualquer (busca binária)
+void locateOffset(const int *starts, int count, int offset, int *line, int *column) {
+    int low = 0, high = count - 1;
+    while (low < high) {
+        int mid = (low + high + 1) / 2;
+        if (starts[mid] <= offset)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    *line = low + 1;
+    *column = offset - starts[low] + 1;
+}
+
+// Função para converter um deslocamento de sourceCode em linha e coluna
+void offsetToLocation(int offset, int *line, int *column) {
+    if (!lineStarts) {
+        buildLineIndex();
+    }
+    locateOffset(lineStarts, lineCount, offset, line, column);
+}
+
+// Função para liberar o índice de linhas
+void freeLineIndex() {
+    free(lineStarts);
+    lineStarts = NULL;
+    lineCount = 0;
+}
+
+// Estrutura de uma linha de diretiva
+typedef struct {
+    const char *name;          // Nome sem '#' (ex.: "if")
+    int nameLength;
+    const char *argument;      // Argumento, sem espaços nas pontas
+    const char *end;           // Fim do texto: quebra de linha, comentário ou fim do código
+} Directive;
+
+// Função para registrar um símbolo definido para todos os arquivos (como '-D' na linha de comando)
+void defineSymbol(const char *name) {
+    if (predefinedSymbolCount < MAX_DIRECTIVE_SYMBOLS) {
+        snprintf(predefinedSymbols[predefinedSymbolCount++], MAX_TOKEN_LENGTH, "%s", name);
+    }
+}
+
+// Função para procurar um símbolo definido; devolve o índice ou -1
+static int findSymbol(const char *name, int length) {
+    for (int i = 0; i < directiveSymbolCount; i++) {
+        if ((int)strlen(directiveSymbols[i]) == length && memcmp(directiveSymbols[i], name, length) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Função para tamanho de um nome de símbolo (letras, dígitos e '_')
+static int symbolLength(const char *p, const char *end) {
+    int length = 0;
+    while (p + length < end && CHAR_IS(p[length], CHAR_IDENTIFIER)) {
+        length++;
+    }
+    return length;
+}
+
+// Função para tratar '#define' (defined = 1) e '#undef' (defined = 0)
+static void setSymbol(const char *name, const char *end, int defined) {
+    int length = symbolLength(name, end);
+    int index = findSymbol(name, length);
+    if (defined && index < 0 && length > 0 && length < MAX_TOKEN_LENGTH &&
+        directiveSymbolCount < MAX_DIRECTIVE_SYMBOLS) {
+        memcpy(directiveSymbols[directiveSymbolCount], name, length);
+        directiveSymbols[directiveSymbolCount++][length] = '\0';
+    } else if (!defined && index >= 0) {
+        if (index != --directiveSymbolCount) {
+            memcpy(directiveSymbols[index], directiveSymbols[directiveSymbolCount], MAX_TOKEN_LENGTH);
+        }
+    }
+}
+
+static int evaluateOr(const char **p, const char *end);
+
+// Função para pular espaços dentro de uma expressão de diretiva
+static void skipBlanks(const char **p, const char *end) {
+    while (*p < end && (**p == ' ' || **p == '\t')) {
+        (*p)++;
+    }
+}
+
+// Função para avaliar um operando: '(' expr ')', '!' operando, true, false, número, defined(X) ou símbolo
+static int evaluatePrimary(const char **p, const char *end) {
+    skipBlanks(p, end);
+    if (*p >= end) {
+        return 0;
+    }
+    if (**p == '(') {
+        (*p)++;
+        int value = evaluateOr(p, end);
+        skipBlanks(p, end);
+        if (*p < end && **p == ')') {
+            (*p)++;
+        }
+        return value;
+    }
+    if (**p == '!') {
+        (*p)++;
+        return !evaluatePrimary(p, end);
+    }
+    int length = symbolLength(*p, end);
+    if (length == 0) {
+        *p = end;   // Expressão inválida: falsa
+        return 0;
+    }
+    const char *word = *p;
+    *p += length;
+    if (CHAR_IS(word[0], CHAR_DIGIT)) {
+        return strtol(word, NULL, 0) != 0;
+    }
+    if (length == 4 && memcmp(word, "true", 4) == 0) {
+        return 1;
+    }
+    if (length == 5 && memcmp(word, "false", 5) == 0) {
+        return 0;
+    }
+    if (length == 7 && memcmp(word, "defined", 7) == 0) {
+        skipBlanks(p, end);
+        int parenthesis = *p < end && **p == '(';
+        *p += parenthesis;
+        skipBlanks(p, end);
+        word = *p;
+        length = symbolLength(word, end);
+        *p += length;
+        skipBlanks(p, end);
+        if (parenthesis && *p < end && **p == ')') {
+            (*p)++;
+        }
+    }
+    return findSymbol(word, length) >= 0;
+}
+
+// Função para avaliar '==' e '!='
+static int evaluateEquality(const char **p, const char *end) {
+    int value = evaluatePrimary(p, end);
+    for (;;) {
+        skipBlanks(p, end);
+        if (*p + 1 < end && ((*p)[0] == '=' || (*p)[0] == '!') && (*p)[1] == '=') {
+            int equal = (*p)[0] == '=';
+            *p += 2;
+            int right = evaluatePrimary(p, end);
+            value = equal ? value == right : value != right;
+        } else {
+            return value;
+        }
+    }
+}
+
+// Função para avaliar '&&'
+static int evaluateAnd(const char **p, const char *end) {
+    int value = evaluateEquality(p, end);
+    for (;;) {
+        skipBlanks(p, end);
+        if (*p + 1 < end && (*p)[0] == '&' && (*p)[1] == '&') {
+            *p += 2;
+            value = evaluateEquality(p, end) && value;
+        } else {
+            return value;
+        }
+    }
+}
+
+// Função para avaliar '||'
+static int evaluateOr(const char **p, const char *end) {
+    int value = evaluateAnd(p, end);
+    for (;;) {
+        skipBlanks(p, end);
+        if (*p + 1 < end && (*p)[0] == '|' && (*p)[1] == '|') {
+            *p += 2;
+            value = evaluateAnd(p, end) || value;
+        } else {
+            return value;
+        }
+    }
+}
+
+// Função para avaliar a condição de '#if' ou '#elif'
+int evaluateCondition(const char *text, const char *end) {
+    return evaluateOr(&text, end);
+}
+
+// Função para separar nome e argumento de uma diretiva ('hash' aponta para o '#')
+static void parseDirective(const char *hash, Directive *directive) {
+    const char *p = hash + 1;
+    while (*p == ' ' || *p == '\t') p++;
+    directive->name = p;
+    while (CHAR_IS(*p, CHAR_ALPHA)) p++;
+    directive->nameLength = (int)(p - directive->name);
+    while (*p == ' ' || *p == '\t') p++;
+    directive->argument = p;
+    while (*p && *p != '\n' && !(*p == '/' && (p[1] == '/' || p[1] == '*'))) p++;
+    while (p > directive->argument && CHAR_IS(p[-1], CHAR_SPACE)) p--;
+    directive->end = p;
+}
+
+// Função para comparar o nome de uma diretiva
+static int directiveIs(const Directive *directive, const char *name) {
+    return directive->nameLength == (int)strlen(name) && memcmp(directive->name, name, directive->nameLength) == 0;
+}
+
+// Função para gravar o token de uma diretiva (o texto é truncado; o tamanho cobre a diretiva inteira)
+static void addDirective(const char *code, const char *hash, const Directive *directive) {
+    char text[MAX_TOKEN_LENGTH];
+    int length = (int)(directive->end - hash);
+    int stored = length < MAX_TOKEN_LENGTH - 1 ? length : MAX_TOKEN_LENGTH - 1;
+    memcpy(text, hash, stored);
+    text[stored] = '\0';
+    addToken(text, (int)(hash - code), DIRECTIVE)->size = length;
+}
+
+// Função para obter o argumento de um token DIRECTIVE: devolve o deslocamento no código e o tamanho em 'length'
+int directiveArgument(const Token *token, int *length) {
+    int i = 1;
+    while (token->value[i] == ' ' || token->value[i] == '\t') i++;
+    while (CHAR_IS(token->value[i], CHAR_ALPHA)) i++;
+    while (token->value[i] == ' ' || token->value[i] == '\t') i++;
+    *length = token->size - i;
+    return token->offset + i;
+}
+
+// Função para verificar se só há espaços entre o início da linha e 'p'
+static int startsLine(const char *code, const char *p) {
+    while (p > code && (p[-1] == ' ' || p[-1] == '\t' || p[-1] == '\r' || p[-1] == '\f' || p[-1] == '\v')) {
+        p--;
+    }
+    return p == code || p[-1] == '\n';
+}
+
+// Função para encontrar o próximo '#' no início de uma linha a partir de 'p' (sourceEnd se não houver)
+static const char *findDirectiveLine(const char *code, const char *p) {
+#ifdef __SSE2__
+    const __m128i hash = _mm_set1_epi8('#');
+    for (; p + 16 <= sourceEnd; p += 16) {
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), hash));
+        while (mask) {
+            const char *candidate = p + __builtin_ctz(mask);
+            if (startsLine(code, candidate)) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; p < sourceEnd; p++) {
+        if (*p == '#' && startsLine(code, p)) {
+            return p;
+        }
+    }
+    return sourceEnd;
+}
+
+// Função para pular um trecho inativo até o ramo que volta a ser ativo; devolve onde a análise continua.
+// Com 'seekEndif', um ramo anterior já foi escolhido e só o '#endif' encerra o trecho
+static const char *skipInactive(const char *code, const char *p, int seekEndif) {
+    int nested = 0;
+    while ((p = findDirectiveLine(code, p)) < sourceEnd) {
+        const char *hash = p;
+        Directive directive;
+        parseDirective(hash, &directive);
+        p = directive.end;
+        if (directiveIs(&directive, "if") || directiveIs(&directive, "ifdef") || directiveIs(&directive, "ifndef")) {
+            nested++;
+            continue;
+        }
+        if (nested > 0) {
+            nested -= directiveIs(&directive, "endif");
+            continue;
+        }
+        int *taken = &conditionalTaken[conditionalDepth - 1];
+        if (directiveIs(&directive, "endif")) {
+            addDirective(code, hash, &directive);
+            conditionalDepth--;
+            return p;
+        }
+        if (directiveIs(&directive, "else")) {
+            addDirective(code, hash, &directive);
+            if (!seekEndif && !*taken) {
+                *taken = 1;
+                return p;
+            }
+        } else if (directiveIs(&directive, "elif")) {
+            addDirective(code, hash, &directive);
+            if (!seekEndif && !*taken && evaluateCondition(directive.argument, directive.end)) {
+                *taken = 1;
+                return p;
+            }
+        }
+    }
+    conditionalDepth--;   // '#if' sem '#endif': fecha no fim do arquivo
+    return sourceEnd;
+}
+
+// Função para tratar uma diretiva em trecho ativo; devolve onde a análise continua
+static const char *lexDirective(const char *code, const char *hash) {
+    Directive directive;
+    parseDirective(hash, &directive);
+    addDirective(code, hash, &directive);
+
+    int opens = directiveIs(&directive, "if") || directiveIs(&directive, "ifdef") || directiveIs(&directive, "ifndef");
+    int closes = directiveIs(&directive, "endif");
+    if (opens && conditionalDepth == MAX_CONDITIONAL_DEPTH) {
+        conditionalOverflow++;   // Sem lugar na pilha: todos os ramos ficam ativos
+        return directive.end;
+    }
+    if (conditionalOverflow > 0 && (closes || directiveIs(&directive, "elif") || directiveIs(&directive, "else"))) {
+        conditionalOverflow -= closes;
+        return directive.end;
+    }
+    if (opens) {
+        int value;
+        if (directiveIs(&directive, "if")) {
+            value = evaluateCondition(directive.argument, directive.end);
+        } else {
+            value = findSymbol(directive.argument, symbolLength(directive.argument, directive.end)) >= 0;
+            value = directiveIs(&directive, "ifdef") ? value : !value;
+        }
+        conditionalTaken[conditionalDepth++] = value;
+        return value ? directive.end : skipInactive(code, directive.end, 0);
+    }
+    if ((directiveIs(&directive, "elif") || directiveIs(&directive, "else")) && conditionalDepth > 0) {
+        return skipInactive(code, directive.end, 1);   // O ramo ativo terminou
+    }
+    if (closes && conditionalDepth > 0) {
+        conditionalDepth--;
+    } else if (directiveIs(&directive, "define") || directiveIs(&directive, "undef")) {
+        setSymbol(directive.argument, directive.end, directiveIs(&directive, "define"));
+    }
+    return directive.end;
+}
+
+// Função para medir um caractere não ASCII de identificador em 'p' (ID_Start se 'first'); devolve os bytes (0 se não for)
+static int unicodeIdentifierChar(const char *p, int first) {
+    uint32_t codepoint;
+    int size = utf8Decode((const unsigned char *)p, (size_t)(sourceEnd - p), &codepoint);
+    if (size && (first ? unicodeIdStart(codepoint) : unicodeIdContinue(codepoint))) {
+        return size;
+    }
+    return 0;
+}
+
+// Função para saber se 'ptr' está fora do trecho ASCII atual [.., *asciiEnd); ao passar o limite, mede o próximo
+// trecho em blocos (asciiPrefix), então só os bytes não ASCII chegam à decodificação UTF-8
+static inline int lexPastAscii(const char *ptr, const char **asciiEnd) {
+    if (ptr < *asciiEnd) {
+        return 0;
+    }
+    *asciiEnd = ptr + asciiPrefix((const unsigned char *)ptr, (size_t)(sourceEnd - ptr));
+    return ptr == *asciiEnd;
+}
+
+// Função para analisar 'code' só com o estado da thread (não toca em sourceCode nem no índice de linhas)
+void lexTokens(const char *code) {
+    const char *ptr = code;
+    int insideString = 0;  // Entre aspas: '//' e '/*' não iniciam comentários
+    int atLineStart = !lexMidLine;   // Só espaços desde a última quebra de linha: '#' inicia uma diretiva
+    lexMidLine = 0;
+    sourceEnd = code + strlen(code);
+    // Dentro de um trecho ASCII, os identificadores são só [A-Za-z0-9_]
+    const char *asciiEnd = code;
+    braceDepth = 0;
+    conditionalDepth = conditionalOverflow = 0;
+    directiveSymbolCount = predefinedSymbolCount;
+    memcpy(directiveSymbols, predefinedSymbols, sizeof(predefinedSymbols[0]) * predefinedSymbolCount);
+    const int withTrivia = recordTrivia;   // Lido uma vez: desligado, só estes testes de registrador
+    triviaCount = 0;
+
+    while (*ptr) {
+        int offset = (int)(ptr - code);
+
+        // Ignorar espaços e quebras de linha (com trivia, a sequência inteira vira um trecho)
+        if (CHAR_IS(*ptr, CHAR_SPACE)) {
+            do {
+                if (*ptr == '\n') {
+                    insideString = 0;
+                    atLineStart = 1;
+                }
+                ptr++;
+            } while (withTrivia && CHAR_IS(*ptr, CHAR_SPACE));
+            if (withTrivia) {
+                addTrivia(offset, (int)(ptr - code) - offset, TRIVIA_WHITESPACE);
+            }
+            continue;
+        }
+
+        // Diretivas de pré-processamento
+        if (*ptr == '#' && atLineStart) {
+            ptr = lexDirective(code, ptr);
+            continue;
+        }
+        atLineStart = 0;
+
+        // Sequência de escape dentro de aspas (ex.: '\"' não fecha a string)
+        if (insideString && *ptr == '\\' && *(ptr + 1) && *(ptr + 1) != '\n') {
+            char escape[3] = {*ptr, *(ptr + 1), '\0'};
+            addToken(escape, offset, UNKNOWN);
+            ptr += 2;
+            continue;
+        }
+
+        // Ignorar comentários de linha ('///', mas não '////', é documentação)
+        if (!insideString && *ptr == '/' && *(ptr + 1) == '/') {
+            while (*ptr && *ptr != '\n') ptr++;
+            if (withTrivia) {
+                int doc = offset + 3 <= (int)(ptr - code) && code[offset + 2] == '/' && code[offset + 3] != '/';
+                addTrivia(offset, (int)(ptr - code) - offset, doc ? TRIVIA_DOC_COMMENT : TRIVIA_LINE_COMMENT);
+            }
+            continue;
+        }
+
+        // Ignorar comentários de bloco '/**/' ('/**' seguido de outro caractere é documentação)
+        if (!insideString && *ptr == '/' && *(ptr + 1) == '*') {
+            ptr += 2; // Avançar sobre '/*'
+            while (*ptr && !(*ptr == '*' && *(ptr + 1) == '/')) ptr++;
+            if (*ptr) ptr += 2;
+            if (withTrivia) {
+                int doc = code[offset + 2] == '*' && code[offset + 3] && code[offset + 3] != '/' && code[offset + 3] != '*';
+                addTrivia(offset, (int)(ptr - code) - offset, doc ? TRIVIA_DOC_COMMENT : TRIVIA_BLOCK_COMMENT);
+            }
+            continue;
+        }
+
+        // Delimitadores
+        if (CHAR_IS(*ptr, CHAR_DELIMITER)) {
+            char token[2] = {*ptr, '\0'};
+            addToken(token, offset, (*ptr == ';') ? SEMICOLON :
+                                          (*ptr == ',') ? COMMA :
+                                          (*ptr == '(') ? OPEN_PARENTHESIS :
+                                          (*ptr == ')') ? CLOSE_PARENTHESIS :
+                                          (*ptr == '{') ? OPEN_BRACE :
+                                          (*ptr == '}') ? CLOSE_BRACE :
+                                          (*ptr == '[') ? OPEN_BRACKET :
+                                          CLOSE_BRACKET);
+            if (!tokenSink && (*ptr == '{' || *ptr == '}')) {
+                int index = tokenCount - 1;
+                if (*ptr == '{') {
+                    braceMatch[index] = -1;
+                    braceStack[braceDepth++] = index;
+                } else {
+                    int open = braceDepth > 0 ? braceStack[--braceDepth] : -1;
+                    braceMatch[index] = open;
+                    if (open >= 0) {
+                        braceMatch[open] = index;
+                    }
+                }
+            }
+            ptr++;
+            continue;
+        }
+
+        // Verificador de Operadores, comparadores e atribuidores
+        if (CHAR_IS(*ptr, CHAR_OPERATOR) || ((*ptr == '&' || *ptr == '|') && *(ptr + 1) == *ptr)) {
+            char token[3] = {*ptr, '\0', '\0'};
+            TokenType type;
+            if (*(ptr + 1) == '=') {
+                // '==', '!=', '<=', '>=' comparam; '+=', '-=', ... atribuem
+                token[1] = '=';
+                type = strchr("=!<>", *ptr) ? COMPARATOR : ASSIGNMENT;
+            } else if (strchr("+-&|", *ptr) && *(ptr + 1) == *ptr) {
+                // '++', '--', '&&', '||'
+                token[1] = *ptr;
+                type = OPERATOR;
+            } else {
+                type = (*ptr == '=') ? ASSIGNMENT : (*ptr == '<' || *ptr == '>') ? COMPARATOR : OPERATOR;
+            }
+            addToken(token, offset, type);
+            ptr += token[1] ? 2 : 1;
+            continue;
+        }
+
+        // Verificação de números (incluindo números de ponto flutuante)
+        if (CHAR_IS(*ptr, CHAR_DIGIT) || (*ptr == '.' && CHAR_IS(*(ptr + 1), CHAR_DIGIT))) {
+            char number[MAX_TOKEN_LENGTH];
+            int length = 0;
+            int hasDot = 0;
+            while (CHAR_IS(*ptr, CHAR_DIGIT) || (*ptr == '.' && !hasDot)) {
+                if (*ptr == '.') {
+                    hasDot = 1; // Marca a presença de um ponto decimal
+                }
+                if (length < MAX_TOKEN_LENGTH - 1) {
+                    number[length++] = *ptr;
+                }
+                ptr++;
+            }
+            number[length] = '\0';
+            addToken(number, offset, NUM_LITERAL);
+            continue;
+        }
+
+        // Identificadores e palavras-chave (o texto guardado é truncado em um caractere inteiro)
+        if (CHAR_IS(*ptr, CHAR_IDENTIFIER) || (lexPastAscii(ptr, &asciiEnd) && unicodeIdentifierChar(ptr, 1))) {
+            char word[MAX_TOKEN_LENGTH];
+            int length = 0, full = 0, size;
+            while ((size = CHAR_IS(*ptr, CHAR_IDENTIFIER)       ? 1
+                           : lexPastAscii(ptr, &asciiEnd) ? unicodeIdentifierChar(ptr, 0)
+                                                          : 0)) {
+                if (!full && length + size < MAX_TOKEN_LENGTH) {
+                    memcpy(word + length, ptr, size);
+                    length += size;
+                } else {
+                    full = 1;
+                }
+                ptr += size;
+            }
+            word[length] = '\0';
+            addToken(word, offset, identifyTokenType(word));
+            continue;
+        }
+
+        // Identificar aspas
+        if (*ptr == '"') {
+            char quote[2] = {*ptr, '\0'};
+            addToken(quote, offset, QUOTE);
+            insideString = !insideString;
+            ptr++;
+            continue;
+        }
+
+        // Verificador de Token desconhecido (um caractere UTF-8 inteiro)
+        uint32_t codepoint;
+        int size = lexPastAscii(ptr, &asciiEnd) ? utf8Decode((const unsigned char *)ptr, (size_t)(sourceEnd - ptr), &codepoint)
+                                                : 0;
+        char unknown[5] = {*ptr, '\0'};
+        if (size > 1) {
+            memcpy(unknown, ptr, size);
+            unknown[size] = '\0';
+        } else {
+            size = 1;
+        }
+        addToken(unknown, offset, UNKNOWN);
+        ptr += size;
+    }
+}
+
+// Função para encontrar a trivia antes do token 'token' (busca binária); devolve o primeiro trecho e a quantidade
+const Trivia *leadingTrivia(int token, int *count) {
+    int low = 0, high = triviaCount;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (trivia[mid].token < token)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    int end = low;
+    while (end < triviaCount && trivia[end].token == token) end++;
+    *count = end - low;
+    return trivia + low;
+}
+
+// Função para extrair os comentários de documentação antes do token 'token' (sem '///', '/**' e '*/', uma
+// linha por comentário '///'); devolve um texto alocado ou NULL se não houver
+char *docComment(const char *code, int token) {
+    int count, length = 0;
+    const Trivia *first = leadingTrivia(token, &count);
+    for (int i = 0; i < count; i++) {
+        length += first[i].kind == TRIVIA_DOC_COMMENT ? (int)first[i].length + 1 : 0;
+    }
+    if (length == 0) {
+        return NULL;
+    }
+    char *text = malloc(length + 1);
+    if (!text) {
+        fprintf(stderr, "Erro: Falha ao alocar o comentário de documentação.\n");
+        exit(EXIT_FAILURE);
+    }
+    int out = 0;
+    for (int i = 0; i < count; i++) {
+        if (first[i].kind != TRIVIA_DOC_COMMENT) {
+            continue;
+        }
+        const char *p = code + first[i].offset + 3, *end = code + first[i].offset + first[i].length;
+        if (code[first[i].offset + 1] == '*' && end - p >= 2 && end[-2] == '*' && end[-1] == '/') {
+            end -= 2;
+        }
+        if (p < end && *p == ' ') p++;
+        while (end > p && CHAR_IS(end[-1], CHAR_SPACE)) end--;
+        if (out > 0) {
+            text[out++] = '\n';
+        }
+        memcpy(text + out, p, end - p);
+        out += (int)(end - p);
+    }
+    text[out] = '\0';
+    return text;
+}
+
+// Função principal de análise léxica
+void lexicalAnalysis(const char *code) {
+    sourceCode = code;
+    freeLineIndex();
+    lexTokens(code);
+}
+
+// Função para ler todo o conteúdo de um arquivo fonte, convertido para UTF-8 e terminado em '\0'
+// ('encoding' recebe a codificação original, se não for NULL)
+char *readSourceFileEncoded(const char *path, long *size, SourceEncoding *encoding) {
+    FILE *file = fopen(path, "r");
+
+    // Verificador de erro
+    if (!file) {
+        perror("Erro ao abrir o arquivo");
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    rewind(file);
+    char *code = malloc(fileSize + 1);
+
+    // Verificador de problema de alocação de memória
+    if (!code) {
+        perror("Erro ao alocar memória");
+        fclose(file);
+        return NULL;
+    }
+    bigAdvise(code, fileSize + 1);
+    fileSize = (long)fread(code, 1, fileSize, file);
+    code[fileSize] = '\0';
+    fclose(file);
+
+    SourceEncoding detected = decodeSource(&code, &fileSize);
+    if (!code) {
+        perror("Erro ao alocar memória");
+        return NULL;
+    }
+    if (size) {
+        *size = fileSize;
+    }
+    if (encoding) {
+        *encoding = detected;
+    }
+    return code;
+}
+
+// Função para ler todo o conteúdo de um arquivo fonte (UTF-8 terminado em '\0')
+char *readSourceFile(const char *path, long *size) {
+    return readSourceFileEncoded(path, size, NULL);
+}
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * Programa da análise semântica
+ *
+ * Lê o arquivo de entrada, executa as análises léxica, sintática e
+ * semântica (analise semantica.h), exibe os símbolos declarados e os erros
+ * encontrados.
+ */
+
+#include "analise semantica.h"
+
+// Função principal
+int main(int argc, char *argv[]) {
+    const char *path = (argc > 1) ? argv[1] : "../input.txt";
+
+    // Ler todo o conteúdo do arquivo fonte
+    char *code = readSourceFile(path, NULL);
+    if (!code) {
+        return EXIT_FAILURE;
+    }
+
+    // Analisar o código
+    printf("Analisando código do arquivo: %s\n", path);
+    lexicalAnalysis(code);
+
+    Ast ast;
+    Parser parser;
+    astInit(&ast, code, tokenCount);
+    parserInit(&parser, &ast, tokens, tokenCount);
+    parseProgram(&parser);
+
+    int status = EXIT_FAILURE;
+    if (parser.errorCount) {
+        printf("\n%d erro(s) sintático(s); análise semântica não realizada.\n", parser.errorCount);
+    } else {
+        Checker checker;
+        printf("\nSímbolos declarados:\n");
+        int errors = semanticAnalysis(&checker, &ast, stdout);
+        printf("\n%d erro(s) semântico(s) encontrado(s).\n", errors);
+        status = errors ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    // Limpar memória
+    astFree(&ast);
+    freeTokens();
+    freeLineIndex();
+    free(code);
+    return status;
+}
@@ -0,0 +1,801 @@
+/*
+ * Analisador Semântico para C#
+ *
+ * Percorre a AST produzida pela análise sintática, resolve os nomes com uma
+ * tabela de símbolos com escopos e verifica os tipos das expressões.
+ *
+ * Verificações realizadas:
+ * - Uso de nomes não declarados e redeclaração no mesmo escopo
+ * - Atribuição composta em declaração (ex.: 'float b += 3.14;')
+ * - Conversões implícitas inválidas em inicializações, atribuições,
+ *   argumentos e retornos (ex.: double para int, bool para int)
+ * - Operandos incompatíveis com o operador
+ * - Condições de if/while/for que não são bool
+ * - Número de argumentos em chamadas a métodos declarados no programa
+ *
+ * Estruturas principais:
+ * - SymbolTable: Um único mapa de endereçamento aberto (nome -> símbolo
+ *   visível) e uma pilha de símbolos com marcadores de escopo. Entrar em um
+ *   escopo empilha um marcador; sair desempilha os símbolos até o marcador,
+ *   restaurando o símbolo que cada um ocultava. As buscas custam O(1)
+ *   independentemente da profundidade de aninhamento.
+ * - Checker: Estado da verificação (método atual, contagem de erros)
+ *
+ * Limitações:
+ * - Membros de objetos (obj.campo) não são verificados; o tipo resultante
+ *   é desconhecido e não gera erros em cascata
+ */
+
+#ifndef ANALISE_SEMANTICA_H
+#define ANALISE_SEMANTICA_H
+
+#include <stdarg.h>
+#include "analise sintatica.h"
+
+// Bit de vetor combinado ao TypeKind nos tipos de expressões (ex.: int[])
+#define TYPE_ARRAY_BIT 0x80
+#define TYPE_BASE(t) ((t) & ~TYPE_ARRAY_BIT)
+
+// Enumeração para categorias de símbolos
+typedef enum {
+    SYM_VARIABLE,
+    SYM_PARAMETER,
+    SYM_FIELD,
+    SYM_METHOD,
+    SYM_CLASS
+} SymbolKind;
+
+// Estrutura de um símbolo declarado
+typedef struct {
+    const char *name;
+    uint32_t length;
+    uint32_t hash;
+    uint8_t kind;       // SymbolKind
+    uint8_t type;       // TypeKind (| TYPE_ARRAY_BIT)
+    uint8_t builtin;    // Símbolo da biblioteca (printf, Console, ...)
+    int depth;          // Profundidade do escopo da declaração
+    NodeId decl;        // Nó da declaração (0 para símbolos da biblioteca)
+    int shadowed;       // Símbolo ocultado por este (-1 se nenhum)
+    uint32_t slot;      // Geração de código: registrador, global ou função do símbolo
+} Symbol;
+
+// Entrada do mapa: um nome distinto e o símbolo visível com esse nome
+typedef struct {
+    const char *name;   // NULL = entrada livre
+    uint32_t length;
+    uint32_t hash;
+    int binding;        // Índice em 'symbols' (-1 se nenhum símbolo visível)
+} SymbolSlot;
+
+// Estrutura da tabela de símbolos
+typedef struct {
+    Symbol *symbols;    // Pilha de símbolos declarados nos escopos abertos
+    int count;
+    int capacity;
+    SymbolSlot *slots;  // Mapa de endereçamento aberto (sondagem linear)
+    uint32_t slotMask;
+    int slotCount;      // Nomes distintos no mapa
+    int *scopeMarks;    // Tamanho da pilha ao entrar em cada escopo
+    int depth;
+    int markCapacity;
+} SymbolTable;
+
+// Estrutura do verificador semântico
+typedef struct {
+    Ast *ast;
+    SymbolTable table;
+    int errorCount;
+    uint8_t returnType;   // Tipo de retorno do método atual
+    FILE *log;            // Se não for NULL, recebe a lista de símbolos declarados
+} Checker;
+
+// ---------------------------------------------------------------------------
+// Tabela de símbolos
+// ---------------------------------------------------------------------------
+
+// Função de hash FNV-1a para nomes
+uint32_t hashName(const char *name, uint32_t length) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Função para localizar a entrada de um nome no mapa (livre se o nome não existir)
+SymbolSlot *findSlot(SymbolTable *table, const char *name, uint32_t length, uint32_t hash) {
+    uint32_t i = hash & table->slotMask;
+    for (;;) {
+        SymbolSlot *slot = &table->slots[i];
+        if (!slot->name || (slot->hash == hash && slot->length == length &&
+                            memcmp(slot->name, name, length) == 0)) {
+            return slot;
+        }
+        i = (i + 1) & table->slotMask;
+    }
+}
+
+// Função para dobrar o mapa quando ele passa da metade da ocupação
+void growSlots(SymbolTable *table) {
+    SymbolSlot *old = table->slots;
+    uint32_t oldSize = table->slotMask + 1;
+
+    table->slotMask = oldSize * 2 - 1;
+    table->slots = calloc(oldSize * 2, sizeof(SymbolSlot));
+    if (!table->slots) {
+        fprintf(stderr, "Erro: Falha ao alocar a tabela de símbolos.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < oldSize; i++) {
+        if (old[i].name) {
+            *findSlot(table, old[i].name, old[i].length, old[i].hash) = old[i];
+        }
+    }
+    free(old);
+}
+
+// Função para inicializar a tabela de símbolos
+void symbolTableInit(SymbolTable *table) {
+    memset(table, 0, sizeof(*table));
+    table->capacity = 64;
+    table->symbols = malloc(table->capacity * sizeof(Symbol));
+    table->slotMask = 63;
+    table->slots = calloc(64, sizeof(SymbolSlot));
+    table->markCapacity = 16;
+    table->scopeMarks = malloc(table->markCapacity * sizeof(int));
+    if (!table->symbols || !table->slots || !table->scopeMarks) {
+        fprintf(stderr, "Erro: Falha ao alocar a tabela de símbolos.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Função para liberar a tabela de símbolos
+void symbolTableFree(SymbolTable *table) {
+    free(table->symbols);
+    free(table->slots);
+    free(table->scopeMarks);
+    memset(table, 0, sizeof(*table));
+}
+
+// Função para abrir um escopo (empilha um marcador)
+void enterScope(SymbolTable *table) {
+    if (table->depth >= table->markCapacity) {
+        table->markCapacity *= 2;
+        table->scopeMarks = realloc(table->scopeMarks, table->markCapacity * sizeof(int));
+        if (!table->scopeMarks) {
+            fprintf(stderr, "Erro: Falha ao alocar a tabela de símbolos.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    table->scopeMarks[table->depth++] = table->count;
+}
+
+// Função para fechar o escopo atual, restaurando os símbolos ocultados
+void leaveScope(SymbolTable *table) {
+    int mark = table->scopeMarks[--table->depth];
+    while (table->count > mark) {
+        const Symbol *symbol = &table->symbols[--table->count];
+        findSlot(table, symbol->name, symbol->length, symbol->hash)->binding = symbol->shadowed;
+    }
+}
+
+// Função para buscar o símbolo visível com o nome informado (NULL se não declarado)
+Symbol *lookupSymbol(SymbolTable *table, const char *name, uint32_t length) {
+    const SymbolSlot *slot = findSlot(table, name, length, hashName(name, length));
+    return (slot->name && slot->binding >= 0) ? &table->symbols[slot->binding] : NULL;
+}
+
+// Função para declarar um símbolo no escopo atual (NULL se já existir neste escopo)
+Symbol *declareSymbol(SymbolTable *table, const char *name, uint32_t length,
+                      SymbolKind kind, uint8_t type, NodeId decl) {
+    uint32_t hash = hashName(name, length);
+    SymbolSlot *slot = findSlot(table, name, length, hash);
+
+    if (slot->name && slot->binding >= 0 && table->symbols[slot->binding].depth == table->depth) {
+        return NULL;
+    }
+    if (!slot->name) {
+        if ((uint32_t)(table->slotCount + 1) * 2 > table->slotMask + 1) {
+            growSlots(table);
+            slot = findSlot(table, name, length, hash);
+        }
+        slot->name = name;
+        slot->length = length;
+        slot->hash = hash;
+        slot->binding = -1;
+        table->slotCount++;
+    }
+    if (table->count >= table->capacity) {
+        table->capacity *= 2;
+        table->symbols = realloc(table->symbols, table->capacity * sizeof(Symbol));
+        if (!table->symbols) {
+            fprintf(stderr, "Erro: Falha ao alocar a tabela de símbolos.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    Symbol *symbol = &table->symbols[table->count];
+    symbol->name = name;
+    symbol->length = length;
+    symbol->hash = hash;
+    symbol->kind = (uint8_t)kind;
+    symbol->type = type;
+    symbol->builtin = 0;
+    symbol->depth = table->depth;
+    symbol->decl = decl;
+    symbol->shadowed = slot->binding;
+    symbol->slot = 0;
+    slot->binding = table->count++;
+    return symbol;
+}
+
+// ---------------------------------------------------------------------------
+// Verificação de tipos
+// ---------------------------------------------------------------------------
+
+// Função para converter SymbolKind em string
+const char *symbolKindToString(SymbolKind kind) {
+    switch (kind) {
+        case SYM_VARIABLE: return "VARIABLE";
+        case SYM_PARAMETER: return "PARAMETER";
+        case SYM_FIELD: return "FIELD";
+        case SYM_METHOD: return "METHOD";
+        case SYM_CLASS: return "CLASS";
+        default: return "UNKNOWN";
+    }
+}
+
+// Função para escrever o nome de um tipo (com '[]' para vetores) em um buffer
+const char *typeName(uint8_t type, char *buffer, size_t size) {
+    snprintf(buffer, size, "%s%s", typeKindToString((TypeKind)TYPE_BASE(type)),
+             (type & TYPE_ARRAY_BIT) ? "[]" : "");
+    return buffer;
+}
+
+// Função para reportar um erro semântico na posição de um nó
+void semanticError(Checker *c, NodeId id, const char *format, ...) {
+    va_list args;
+    int line, column;
+    offsetToLocation((int)astNode(c->ast, id)->offset, &line, &column);
+    fprintf(stderr, "Erro semântico (linha %d, coluna %d): ", line, column);
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+    c->errorCount++;
+}
+
+// Função para declarar um símbolo de um nó, reportando redeclarações
+void declareNode(Checker *c, NodeId id, SymbolKind kind, uint8_t type) {
+    const AstNode *node = astNode(c->ast, id);
+    const char *name = c->ast->source + node->offset;
+    if (!declareSymbol(&c->table, name, node->length, kind, type, id)) {
+        semanticError(c, id, "'%.*s' já foi declarado neste escopo", (int)node->length, name);
+        return;
+    }
+    if (c->log) {
+        char buffer[32];
+        int line, column;
+        offsetToLocation((int)node->offset, &line, &column);
+        fprintf(c->log, "Símbolo: %-15.*s Categoria: %-10s Tipo: %-10s Escopo: %-3d Linha: %d\n",
+                (int)node->length, name, symbolKindToString(kind),
+                typeName(type, buffer, sizeof(buffer)), c->table.depth, line);
+    }
+}
+
+// Função para obter o tipo representado por um nó TYPE
+uint8_t typeOfNode(const Ast *ast, NodeId id) {
+    const AstNode *node = astNode(ast, id);
+    uint8_t type = node->type;
+    if (type == TY_CLASS) {
+        uint32_t length = node->length;
+        if (node->flags & TYPE_ARRAY) {
+            length -= 2;  // Remove '[]' do trecho
+        }
+        if (length == 6 && strncmp(ast->source + node->offset, "string", 6) == 0) {
+            type = TY_STRING;
+        } else if (length == 3 && strncmp(ast->source + node->offset, "var", 3) == 0) {
+            type = TY_UNKNOWN;  // Inferido pela inicialização
+        }
+    }
+    return (node->flags & TYPE_ARRAY) ? (uint8_t)(type | TYPE_ARRAY_BIT) : type;
+}
+
+// Função para obter o tipo representado por um nó TYPE durante a verificação
+uint8_t resolveType(Checker *c, NodeId id) {
+    return typeOfNode(c->ast, id);
+}
+
+// Função para verificar se um tipo é numérico
+int isNumericType(uint8_t type) {
+    return type == TY_INT || type == TY_FLOAT || type == TY_DOUBLE || type == TY_CHAR;
+}
+
+// Função para obter o tipo numérico resultante de uma operação entre dois tipos
+uint8_t widerNumericType(uint8_t a, uint8_t b) {
+    if (a == TY_DOUBLE || b == TY_DOUBLE) return TY_DOUBLE;
+    if (a == TY_FLOAT || b == TY_FLOAT) return TY_FLOAT;
+    return TY_INT;
+}
+
+// Função para verificar se um nó é um literal numérico (opcionalmente negado)
+int isNumericLiteral(const Ast *ast, NodeId id) {
+    const AstNode *node = astNode(ast, id);
+    if (node->kind == AST_UNARY && node->op == OP_NEG) {
+        node = astNode(ast, node->firstChild);
+    }
+    return node->kind == AST_NUMBER;
+}
+
+// Função para verificar se um valor de tipo 'from' pode ser convertido implicitamente para 'to'
+int canConvert(const Ast *ast, uint8_t from, uint8_t to, NodeId value) {
+    if (from == to || from == TY_UNKNOWN || to == TY_UNKNOWN) {
+        return 1;
+    }
+    if ((from & TYPE_ARRAY_BIT) || (to & TYPE_ARRAY_BIT)) {
+        return 0;
+    }
+    if (to == TY_CLASS || from == TY_CLASS) {
+        return to == TY_CLASS || from == TY_CLASS;  // Classes da biblioteca não são modeladas
+    }
+    if (isNumericType(from) && isNumericType(to)) {
+        // Literais numéricos (sem sufixo 'f' no analisador léxico) valem para qualquer tipo numérico
+        if (to != TY_CHAR && isNumericLiteral(ast, value)) {
+            return 1;
+        }
+        switch (to) {
+            case TY_INT: return from == TY_CHAR;
+            case TY_FLOAT: return from == TY_INT || from == TY_CHAR;
+            case TY_DOUBLE: return from != TY_DOUBLE;
+            default: return 0;
+        }
+    }
+    return 0;
+}
+
+// Função para exigir uma conversão implícita válida
+void expectConvertible(Checker *c, uint8_t from, uint8_t to, NodeId value, const char *context) {
+    if (!canConvert(c->ast, from, to, value)) {
+        char a[32], b[32];
+        semanticError(c, value, "não é possível converter implicitamente %s para %s %s",
+                      typeName(from, a, sizeof(a)), typeName(to, b, sizeof(b)), context);
+    }
+}
+
+uint8_t checkExpression(Checker *c, NodeId id);
+
+// Função para verificar se um nó pode receber atribuição
+int isAssignable(const Ast *ast, NodeId id) {
+    uint8_t kind = astNode(ast, id)->kind;
+    return kind == AST_IDENTIFIER || kind == AST_MEMBER || kind == AST_INDEX;
+}
+
+// Função para verificar um identificador usado em uma expressão
+uint8_t checkIdentifier(Checker *c, NodeId id) {
+    const AstNode *node = astNode(c->ast, id);
+    const char *name = c->ast->source + node->offset;
+    const Symbol *symbol = lookupSymbol(&c->table, name, node->length);
+    if (!symbol) {
+        semanticError(c, id, "'%.*s' não foi declarado", (int)node->length, name);
+        return TY_UNKNOWN;
+    }
+    if (symbol->kind == SYM_METHOD || symbol->kind == SYM_CLASS) {
+        return TY_UNKNOWN;  // Grupo de métodos ou nome de classe
+    }
+    return symbol->type;
+}
+
+// Função para verificar uma chamada de método
+uint8_t checkCall(Checker *c, NodeId id) {
+    NodeId callee = astNode(c->ast, id)->firstChild;
+    const AstNode *calleeNode = astNode(c->ast, callee);
+    const Symbol *method = NULL;
+
+    if (calleeNode->kind == AST_IDENTIFIER) {
+        const char *name = c->ast->source + calleeNode->offset;
+        method = lookupSymbol(&c->table, name, calleeNode->length);
+        if (!method) {
+            semanticError(c, callee, "'%.*s' não foi declarado", (int)calleeNode->length, name);
+        } else if (method->kind != SYM_METHOD) {
+            semanticError(c, callee, "'%.*s' não é um método", (int)calleeNode->length, name);
+            method = NULL;
+        }
+    } else {
+        checkExpression(c, callee);
+    }
+
+    // Argumentos, comparados aos parâmetros quando o método é do programa
+    NodeId param = (method && !method->builtin) ? astNode(c->ast, method->decl)->firstChild : 0;
+    if (param) {
+        param = astNode(c->ast, param)->nextSibling;  // Pula o tipo de retorno
+    }
+    int arguments = 0, parameters = 0;
+    for (NodeId arg = astNode(c->ast, callee)->nextSibling; arg; arg = astNode(c->ast, arg)->nextSibling) {
+        uint8_t type = checkExpression(c, arg);
+        arguments++;
+        if (param && astNode(c->ast, param)->kind == AST_PARAM) {
+            expectConvertible(c, type, resolveType(c, astNode(c->ast, param)->firstChild), arg, "no argumento");
+            param = astNode(c->ast, param)->nextSibling;
+        }
+    }
+    if (method && !method->builtin) {
+        for (NodeId p = nodeChild(c->ast, method->decl, 1); p && astNode(c->ast, p)->kind == AST_PARAM;
+             p = astNode(c->ast, p)->nextSibling) {
+            parameters++;
+        }
+        if (arguments != parameters) {
+            semanticError(c, id, "'%.*s' espera %d argumento(s), mas recebeu %d",
+                          (int)calleeNode->length, c->ast->source + calleeNode->offset, parameters, arguments);
+        }
+    }
+    return method ? method->type : TY_UNKNOWN;
+}
+
+// Função para verificar uma operação binária e obter o tipo do resultado
+uint8_t checkBinary(Checker *c, NodeId id, OperatorKind op, uint8_t left, uint8_t right) {
+    char a[32], b[32];
+    if (left == TY_UNKNOWN || right == TY_UNKNOWN) {
+        return (op >= OP_LT && op <= OP_OR) ? TY_BOOL : TY_UNKNOWN;
+    }
+    switch (op) {
+        case OP_ADD:
+            if (left == TY_STRING || right == TY_STRING) {
+                return TY_STRING;
+            }
+            /* fall through */
+        case OP_SUB:
+        case OP_MUL:
+        case OP_DIV:
+        case OP_MOD:
+            if (isNumericType(left) && isNumericType(right)) {
+                return widerNumericType(left, right);
+            }
+            break;
+        case OP_LT:
+        case OP_GT:
+        case OP_LE:
+        case OP_GE:
+            if (isNumericType(left) && isNumericType(right)) {
+                return TY_BOOL;
+            }
+            break;
+        case OP_EQ:
+        case OP_NE:
+            if ((isNumericType(left) && isNumericType(right)) || left == right ||
+                left == TY_CLASS || right == TY_CLASS) {
+                return TY_BOOL;
+            }
+            break;
+        case OP_AND:
+        case OP_OR:
+            if (left == TY_BOOL && right == TY_BOOL) {
+                return TY_BOOL;
+            }
+            break;
+        default:
+            break;
+    }
+    semanticError(c, id, "operador '%s' não se aplica aos tipos %s e %s", operatorToString(op),
+                  typeName(left, a, sizeof(a)), typeName(right, b, sizeof(b)));
+    return TY_UNKNOWN;
+}
+
+// Função para verificar uma expressão; guarda e devolve o seu tipo
+uint8_t checkExpression(Checker *c, NodeId id) {
+    AstNode *node = astNode(c->ast, id);
+    NodeId first = node->firstChild;
+    NodeId second = first ? astNode(c->ast, first)->nextSibling : 0;
+    OperatorKind op = (OperatorKind)node->op;
+    uint8_t type = TY_UNKNOWN;
+    char buffer[32];
+
+    switch ((NodeKind)node->kind) {
+        case AST_NUMBER:
+            type = memchr(c->ast->source + node->offset, '.', node->length) ? TY_DOUBLE : TY_INT;
+            break;
+        case AST_STRING:
+            type = TY_STRING;
+            break;
+        case AST_CHAR:
+            type = TY_CHAR;
+            break;
+        case AST_BOOL:
+            type = TY_BOOL;
+            break;
+        case AST_IDENTIFIER:
+            type = checkIdentifier(c, id);
+            break;
+        case AST_CALL:
+            type = checkCall(c, id);
+            break;
+        case AST_MEMBER: {
+            uint8_t object = checkExpression(c, first);
+            if (nodeTextIs(c->ast, id, "Length") && (object == TY_STRING || (object & TYPE_ARRAY_BIT))) {
+                type = TY_INT;
+            }
+            break;
+        }
+        case AST_INDEX: {
+            uint8_t object = checkExpression(c, first);
+            uint8_t index = checkExpression(c, second);
+            if (index != TY_UNKNOWN && index != TY_INT && index != TY_CHAR) {
+                semanticError(c, second, "o índice deve ser int, encontrado %s", typeName(index, buffer, sizeof(buffer)));
+            }
+            if (object & TYPE_ARRAY_BIT) {
+                type = TYPE_BASE(object);
+            } else if (object == TY_STRING) {
+                type = TY_CHAR;
+            } else if (object != TY_UNKNOWN && object != TY_CLASS) {
+                semanticError(c, id, "indexação aplicada a %s", typeName(object, buffer, sizeof(buffer)));
+            }
+            break;
+        }
+        case AST_NEW: {
+            type = resolveType(c, first);
+            for (NodeId arg = second; arg; arg = astNode(c->ast, arg)->nextSibling) {
+                uint8_t argType = checkExpression(c, arg);
+                if ((node->flags & TYPE_ARRAY) && argType != TY_UNKNOWN && argType != TY_INT) {
+                    semanticError(c, arg, "o tamanho do vetor deve ser int");
+                }
+            }
+            if (node->flags & TYPE_ARRAY) {
+                type |= TYPE_ARRAY_BIT;
+            }
+            break;
+        }
+        case AST_UNARY: {
+            uint8_t operand = checkExpression(c, first);
+            if (operand == TY_UNKNOWN) {
+                type = (op == OP_NOT) ? TY_BOOL : TY_UNKNOWN;
+            } else if (op == OP_NOT) {
+                if (operand != TY_BOOL) {
+                    semanticError(c, id, "operador '!' exige bool, encontrado %s", typeName(operand, buffer, sizeof(buffer)));
+                }
+                type = TY_BOOL;
+            } else if (!isNumericType(operand)) {
+                semanticError(c, id, "operador '%s' exige um tipo numérico, encontrado %s",
+                              operatorToString(op), typeName(operand, buffer, sizeof(buffer)));
+            } else {
+                type = (op == OP_NEG && operand == TY_CHAR) ? TY_INT : operand;
+            }
+            if (op != OP_NOT && op != OP_NEG && !isAssignable(c->ast, first)) {
+                semanticError(c, id, "operador '%s' exige uma variável", operatorToString(op));
+            }
+            break;
+        }
+        case AST_BINARY:
+            type = checkBinary(c, id, op, checkExpression(c, first), checkExpression(c, second));
+            break;
+        case AST_ASSIGN: {
+            uint8_t target = checkExpression(c, first);
+            uint8_t value = checkExpression(c, second);
+            if (!isAssignable(c->ast, first)) {
+                semanticError(c, id, "o lado esquerdo da atribuição deve ser uma variável");
+            } else if (op == OP_ASSIGN) {
+                expectConvertible(c, value, target, second, "na atribuição");
+            } else if (!(op == OP_ADD_ASSIGN && target == TY_STRING) && target != TY_UNKNOWN &&
+                       value != TY_UNKNOWN && (!isNumericType(target) || !isNumericType(value))) {
+                char a[32];
+                semanticError(c, id, "operador '%s' não se aplica aos tipos %s e %s", operatorToString(op),
+                              typeName(target, buffer, sizeof(buffer)), typeName(value, a, sizeof(a)));
+            }
+            type = target;
+            break;
+        }
+        default:
+            break;
+    }
+
+    astNode(c->ast, id)->type = type;
+    return type;
+}
+
+// Função para exigir uma condição bool
+void checkCondition(Checker *c, NodeId id) {
+    if (astNode(c->ast, id)->kind == AST_EMPTY) {
+        return;
+    }
+    uint8_t type = checkExpression(c, id);
+    if (type != TY_BOOL && type != TY_UNKNOWN) {
+        char buffer[32];
+        semanticError(c, id, "a condição deve ser bool, encontrado %s", typeName(type, buffer, sizeof(buffer)));
+    }
+}
+
+// Função para verificar uma declaração de variável (ou campo) e declará-la
+void checkVarDecl(Checker *c, NodeId id, SymbolKind kind, int declare) {
+    const AstNode *node = astNode(c->ast, id);
+    NodeId typeNode = node->firstChild;
+    NodeId init = astNode(c->ast, typeNode)->nextSibling;
+    uint8_t type = resolveType(c, typeNode);
+
+    if (node->op != OP_NONE && node->op != OP_ASSIGN) {
+        semanticError(c, id, "atribuição composta '%s' na declaração de '%.*s'; use '='",
+                      operatorToString((OperatorKind)node->op), (int)node->length,
+                      c->ast->source + node->offset);
+    }
+    if (init) {
+        uint8_t value = checkExpression(c, init);
+        if (type == TY_UNKNOWN) {
+            type = value;  // 'var'
+        } else if (node->op == OP_ASSIGN) {
+            expectConvertible(c, value, type, init, "na inicialização");
+        }
+    }
+    astNode(c->ast, id)->type = type;
+    if (declare) {
+        declareNode(c, id, kind, type);
+    }
+}
+
+void checkStatement(Checker *c, NodeId id);
+
+// Função para verificar os comandos de um bloco (abrindo ou não um novo escopo)
+void checkBlock(Checker *c, NodeId id, int newScope) {
+    if (newScope) {
+        enterScope(&c->table);
+    }
+    for (NodeId stmt = astNode(c->ast, id)->firstChild; stmt; stmt = astNode(c->ast, stmt)->nextSibling) {
+        checkStatement(c, stmt);
+    }
+    if (newScope) {
+        leaveScope(&c->table);
+    }
+}
+
+// Função para verificar um comando
+void checkStatement(Checker *c, NodeId id) {
+    const AstNode *node = astNode(c->ast, id);
+    NodeId first = node->firstChild;
+    char buffer[32];
+
+    switch ((NodeKind)node->kind) {
+        case AST_BLOCK:
+            checkBlock(c, id, 1);
+            break;
+        case AST_VAR_DECL:
+            checkVarDecl(c, id, SYM_VARIABLE, 1);
+            break;
+        case AST_EXPR_STMT:
+            checkExpression(c, first);
+            break;
+        case AST_IF:
+            checkCondition(c, first);
+            for (NodeId branch = astNode(c->ast, first)->nextSibling; branch; branch = astNode(c->ast, branch)->nextSibling) {
+                checkStatement(c, branch);
+            }
+            break;
+        case AST_WHILE:
+            checkCondition(c, first);
+            checkStatement(c, astNode(c->ast, first)->nextSibling);
+            break;
+        case AST_FOR: {
+            NodeId cond = astNode(c->ast, first)->nextSibling;
+            NodeId step = astNode(c->ast, cond)->nextSibling;
+            enterScope(&c->table);
+            if (astNode(c->ast, first)->kind == AST_VAR_DECL) {
+                checkVarDecl(c, first, SYM_VARIABLE, 1);
+            } else if (astNode(c->ast, first)->kind != AST_EMPTY) {
+                checkExpression(c, first);
+            }
+            checkCondition(c, cond);
+            if (astNode(c->ast, step)->kind != AST_EMPTY) {
+                checkExpression(c, step);
+            }
+            checkStatement(c, astNode(c->ast, step)->nextSibling);
+            leaveScope(&c->table);
+            break;
+        }
+        case AST_RETURN:
+            if (first) {
+                uint8_t type = checkExpression(c, first);
+                if (c->returnType == TY_VOID) {
+                    semanticError(c, id, "método void não pode retornar um valor");
+                } else {
+                    expectConvertible(c, type, c->returnType, first, "no retorno");
+                }
+            } else if (c->returnType != TY_VOID && c->returnType != TY_UNKNOWN) {
+                semanticError(c, id, "esperado um valor de retorno do tipo %s", typeName(c->returnType, buffer, sizeof(buffer)));
+            }
+            break;
+        case AST_TRY:
+            checkBlock(c, first, 1);
+            for (NodeId handler = astNode(c->ast, first)->nextSibling; handler; handler = astNode(c->ast, handler)->nextSibling) {
+                NodeId child = astNode(c->ast, handler)->firstChild;
+                enterScope(&c->table);
+                if (astNode(c->ast, child)->kind == AST_TYPE) {
+                    if (!nodeTextIs(c->ast, handler, "catch")) {
+                        declareNode(c, handler, SYM_VARIABLE, resolveType(c, child));
+                    }
+                    child = astNode(c->ast, child)->nextSibling;
+                }
+                checkBlock(c, child, 0);
+                leaveScope(&c->table);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Função para verificar o corpo de um método
+void checkMethod(Checker *c, NodeId id) {
+    NodeId child = astNode(c->ast, id)->firstChild;
+    uint8_t previous = c->returnType;
+    c->returnType = resolveType(c, child);
+
+    enterScope(&c->table);
+    for (child = astNode(c->ast, child)->nextSibling; child; child = astNode(c->ast, child)->nextSibling) {
+        if (astNode(c->ast, child)->kind == AST_PARAM) {
+            declareNode(c, child, SYM_PARAMETER, resolveType(c, astNode(c->ast, child)->firstChild));
+        } else {
+            checkBlock(c, child, 0);
+        }
+    }
+    leaveScope(&c->table);
+    c->returnType = previous;
+}
+
+// Função para verificar uma lista de declarações (programa, namespace ou classe)
+void checkDeclarations(Checker *c, NodeId parent) {
+    // Primeira passagem: declara métodos, campos e classes para permitir referências adiante
+    for (NodeId id = astNode(c->ast, parent)->firstChild; id; id = astNode(c->ast, id)->nextSibling) {
+        const AstNode *node = astNode(c->ast, id);
+        if (node->kind == AST_METHOD && !(node->flags & MOD_CONSTRUCTOR)) {
+            declareNode(c, id, SYM_METHOD, resolveType(c, node->firstChild));
+        } else if (node->kind == AST_VAR_DECL) {
+            declareNode(c, id, SYM_FIELD, resolveType(c, node->firstChild));
+        } else if (node->kind == AST_CLASS) {
+            declareNode(c, id, SYM_CLASS, TY_CLASS);
+        }
+    }
+
+    // Segunda passagem: verifica inicializações de campos e corpos
+    for (NodeId id = astNode(c->ast, parent)->firstChild; id; id = astNode(c->ast, id)->nextSibling) {
+        switch ((NodeKind)astNode(c->ast, id)->kind) {
+            case AST_VAR_DECL:
+                checkVarDecl(c, id, SYM_FIELD, 0);
+                break;
+            case AST_METHOD:
+                checkMethod(c, id);
+                break;
+            case AST_CLASS:
+            case AST_NAMESPACE:
+                enterScope(&c->table);
+                checkDeclarations(c, id);
+                leaveScope(&c->table);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// Função para declarar os nomes da biblioteca usados pelos programas de exemplo
+void declareBuiltins(Checker *c) {
+    static const char *classes[] = {"Console", "Math", "Convert", "String", "Exception"};
+    Symbol *printfSymbol = declareSymbol(&c->table, "printf", 6, SYM_METHOD, TY_INT, 0);
+    printfSymbol->builtin = 1;
+    for (size_t i = 0; i < sizeof(classes) / sizeof(classes[0]); i++) {
+        Symbol *symbol = declareSymbol(&c->table, classes[i], (uint32_t)strlen(classes[i]), SYM_CLASS, TY_CLASS, 0);
+        symbol->builtin = 1;
+    }
+}
+
+// Função principal da análise semântica; devolve o número de erros
+int semanticAnalysis(Checker *c, Ast *ast, FILE *log) {
+    memset(c, 0, sizeof(*c));
+    c->ast = ast;
+    c->log = log;
+    symbolTableInit(&c->table);
+
+    declareBuiltins(c);
+    enterScope(&c->table);
+    checkDeclarations(c, ast->root);
+    leaveScope(&c->table);
+
+    symbolTableFree(&c->table);
+    return c->errorCount;
+}
+
+#endif
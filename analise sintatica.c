@@ -0,0 +1,152 @@
+/*
+ * Programa da análise sintática
+ *
+ * Lê o arquivo de entrada, executa as análises léxica e sintática
+ * (analise sintatica.h) e exibe a árvore sintática abstrata.
+ *
+ * Uso: analise sintatica [--declaracoes] [--metodo Nome] [--pipeline] [arquivo]
+ * - --declaracoes: pula os corpos dos métodos (análise preguiçosa)
+ * - --metodo Nome: como --declaracoes, mas analisa sob demanda o corpo do
+ *   método informado
+ * - --pipeline: executa o analisador léxico em outra thread (pipeline.h),
+ *   entregando os tokens ao sintático em lotes; incompatível com a análise
+ *   preguiçosa, que precisa dos pares de chaves do arquivo inteiro
+ */
+
+#include <time.h>
+#include "pipeline.h"
+
+// Pipeline estático: o anel ocupa ~112 KB, grande demais para a pilha
+static Pipeline pipeline;
+
+// Função para medir o tempo decorrido em milissegundos
+double elapsedMs(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e3 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Função para exibir um nó e seus filhos com indentação
+void printAst(const Ast *ast, NodeId id, int depth) {
+    for (; id; id = astNode(ast, id)->nextSibling) {
+        const AstNode *node = astNode(ast, id);
+        int line, column;
+        offsetToLocation((int)node->offset, &line, &column);
+
+        printf("%*s%s", depth * 2, "", nodeKindToString((NodeKind)node->kind));
+        if (node->kind == AST_TYPE) {
+            printf(" %s", typeKindToString((TypeKind)node->type));
+        }
+        if (node->op != OP_NONE) {
+            printf(" %s", operatorToString((OperatorKind)node->op));
+        }
+        if (node->length > 0 && node->kind != AST_BLOCK && node->kind != AST_CALL &&
+            node->kind != AST_INDEX && node->kind != AST_EXPR_STMT) {
+            printf(" '%.*s'", (int)node->length, ast->source + node->offset);
+        }
+        if (node->flags & MOD_PUBLIC) printf(" public");
+        if (node->flags & MOD_PRIVATE) printf(" private");
+        if (node->flags & MOD_STATIC) printf(" static");
+        if (node->flags & BLOCK_UNPARSED && node->kind == AST_BLOCK) {
+            printf(" (não analisado, %u bytes)", node->length);
+        }
+        printf("  (Linha: %d, Coluna: %d)\n", line, column);
+
+        printAst(ast, node->firstChild, depth + 1);
+    }
+}
+
+// Função para analisar sob demanda os corpos dos métodos com o nome informado
+void parseMethodBodies(Parser *p, NodeId parent, const char *name) {
+    for (NodeId id = astNode(p->ast, parent)->firstChild; id; id = astNode(p->ast, id)->nextSibling) {
+        const AstNode *node = astNode(p->ast, id);
+        if (node->kind == AST_METHOD && nodeTextIs(p->ast, id, name)) {
+            NodeId body = id;
+            for (NodeId child = node->firstChild; child; child = astNode(p->ast, child)->nextSibling) {
+                body = child;  // O corpo é o último filho
+            }
+            parseLazyBody(p, body);
+        } else if (node->kind == AST_CLASS || node->kind == AST_NAMESPACE) {
+            parseMethodBodies(p, id, name);
+        }
+    }
+}
+
+// Função principal
+int main(int argc, char *argv[]) {
+    const char *path = "../input.txt";
+    const char *method = NULL;
+    int lazy = 0;
+    int pipelined = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--declaracoes") == 0) {
+            lazy = 1;
+        } else if (strcmp(argv[i], "--metodo") == 0 && i + 1 < argc) {
+            lazy = 1;
+            method = argv[++i];
+        } else if (strcmp(argv[i], "--pipeline") == 0) {
+            pipelined = 1;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    // Ler todo o conteúdo do arquivo fonte
+    char *code = readSourceFile(path, NULL);
+    if (!code) {
+        return EXIT_FAILURE;
+    }
+
+    // Analisar o código
+    printf("Analisando código do arquivo: %s\n", path);
+    if (pipelined && lazy) {
+        fprintf(stderr, "Aviso: --pipeline ignora a análise preguiçosa.\n");
+        lazy = 0;
+        method = NULL;
+    }
+
+    Ast ast;
+    Parser parser;
+    struct timespec start;
+    double elapsed;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (pipelined) {
+        // O número de tokens ainda não é conhecido; estima-se ~1 token a cada 4 bytes
+        astInit(&ast, code, (int)(strlen(code) / 4));
+        pipelineParse(&pipeline, &parser, &ast, code);
+        elapsed = elapsedMs(&start);
+    } else {
+        lexicalAnalysis(code);
+        // Na análise preguiçosa a árvore cresce sob demanda a partir de uma reserva menor
+        astInit(&ast, code, lazy ? tokenCount / 8 : tokenCount);
+        parserInit(&parser, &ast, tokens, tokenCount);
+        parser.braceMatch = braceMatch;
+        parser.lazyBodies = lazy;
+        parseProgram(&parser);
+        elapsed = elapsedMs(&start);
+        if (method) {
+            parseMethodBodies(&parser, ast.root, method);
+        }
+    }
+
+    printf("\nÁrvore sintática:\n");
+    printAst(&ast, ast.root, 0);
+    printf("\nMemória da árvore: %u bytes\n", ast.arena.used);
+    printf("%d erro(s) sintático(s) encontrado(s).\n", parser.errorCount);
+    printf("Tempo das análises léxica e sintática: %.3f ms (%d tokens)\n", elapsed, tokenCount);
+    if (pipelined) {
+        printf("Pipeline: %ld lotes, produtor esperou %ld vez(es), consumidor esperou %ld vez(es), "
+               "janela máxima de %d lote(s)\n",
+               pipeline.batches, pipeline.producerWaits, pipeline.consumerWaits, pipeline.peakChunks);
+    }
+
+    // Limpar memória
+    int status = parser.errorCount ? EXIT_FAILURE : EXIT_SUCCESS;
+    astFree(&ast);
+    pipelineFree(&pipeline);
+    freeTokens();
+    freeLineIndex();
+    free(code);
+    return status;
+}
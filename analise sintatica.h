@@ -0,0 +1,1102 @@
+/*
+ * Analisador Sintático para C#
+ *
+ * Consome a sequência de tokens produzida por lexicalAnalysis e constrói a
+ * árvore sintática abstrata (AST) do subconjunto de C# reconhecido pelo
+ * analisador léxico: using, namespace, classes, campos, métodos, blocos,
+ * if/else, while, for, return, try/catch e expressões.
+ *
+ * Estruturas principais:
+ * - AstNode: Nó da árvore (20 bytes). Os filhos formam uma lista encadeada
+ *   (primeiro filho / próximo irmão) por índices de 32 bits
+ * - Ast: Arena onde todos os nós são alocados; liberar a árvore é uma única
+ *   chamada (arenaFree)
+ * - Parser: Estado do analisador descendente recursivo
+ * - operatorTable: Forças de ligação das expressões (analisador de Pratt),
+ *   indexadas pelo tipo e texto do token de operador
+ *
+ * Forma dos nós (filhos na ordem):
+ * - PROGRAM, NAMESPACE, CLASS, BLOCK: declarações ou comandos
+ * - METHOD: TYPE de retorno, PARAM..., BLOCK
+ * - PARAM, VAR_DECL: TYPE [, inicializador]  (op guarda '=', '+=', ...)
+ * - IF: condição, então [, senão]     WHILE: condição, corpo
+ * - FOR: inicialização, condição, passo, corpo (EMPTY quando ausentes)
+ * - TRY: BLOCK, CATCH...              CATCH: [TYPE,] BLOCK
+ * - BLOCK com BLOCK_UNPARSED: corpo de método ainda não analisado; o trecho
+ *   do nó cobre de '{' a '}' e parseLazyBody o analisa sob demanda
+ * - CALL: função, argumentos...       NEW: TYPE, argumentos...
+ *
+ * Erros sintáticos são exibidos com linha e coluna; o analisador se recupera
+ * avançando até o próximo ';' ou '}' e continua a análise.
+ *
+ * Os tokens vêm de uma lista (parserInit) ou de um fluxo (fetchToken), em que
+ * o analisador pede cada token pelo índice e avisa em releaseTokens, no
+ * início de cada comando ou declaração, que os anteriores não serão mais
+ * acessados (nenhum ponteiro para Token é mantido entre comandos).
+ */
+
+#ifndef ANALISE_SINTATICA_H
+#define ANALISE_SINTATICA_H
+
+#include <stdint.h>
+#include "analise lexica.h"
+#include "arena.h"
+
+typedef uint32_t NodeId;  // Deslocamento do nó na arena (0 = nenhum)
+
+// Enumeração para tipos de nós da AST
+typedef enum {
+    AST_PROGRAM,
+    AST_USING,
+    AST_NAMESPACE,
+    AST_CLASS,
+    AST_METHOD,
+    AST_PARAM,
+    AST_TYPE,
+    AST_BLOCK,
+    AST_VAR_DECL,
+    AST_IF,
+    AST_WHILE,
+    AST_FOR,
+    AST_RETURN,
+    AST_TRY,
+    AST_CATCH,
+    AST_EXPR_STMT,
+    AST_EMPTY,
+    AST_ASSIGN,
+    AST_BINARY,
+    AST_UNARY,
+    AST_CALL,
+    AST_MEMBER,
+    AST_INDEX,
+    AST_NEW,
+    AST_IDENTIFIER,
+    AST_NUMBER,
+    AST_STRING,
+    AST_CHAR,
+    AST_BOOL
+} NodeKind;
+
+// Enumeração para operadores
+typedef enum {
+    OP_NONE,
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_MOD,
+    OP_LT,
+    OP_GT,
+    OP_LE,
+    OP_GE,
+    OP_EQ,
+    OP_NE,
+    OP_AND,
+    OP_OR,
+    OP_NOT,
+    OP_NEG,
+    OP_PRE_INC,
+    OP_PRE_DEC,
+    OP_POST_INC,
+    OP_POST_DEC,
+    OP_ASSIGN,
+    OP_ADD_ASSIGN,
+    OP_SUB_ASSIGN,
+    OP_MUL_ASSIGN,
+    OP_DIV_ASSIGN,
+    OP_MOD_ASSIGN
+} OperatorKind;
+
+// Enumeração para tipos da linguagem
+typedef enum {
+    TY_UNKNOWN,
+    TY_VOID,
+    TY_INT,
+    TY_FLOAT,
+    TY_DOUBLE,
+    TY_CHAR,
+    TY_BOOL,
+    TY_STRING,
+    TY_CLASS
+} TypeKind;
+
+// Modificadores (campo flags de CLASS, METHOD e VAR_DECL)
+#define MOD_PUBLIC      0x01
+#define MOD_PRIVATE     0x02
+#define MOD_STATIC      0x04
+#define MOD_CONSTRUCTOR 0x08
+
+// Marcação de tipo vetor (campo flags de TYPE e NEW)
+#define TYPE_ARRAY      0x10
+
+// Corpo de método pulado pela análise preguiçosa (campo flags de BLOCK)
+#define BLOCK_UNPARSED  0x20
+
+// Estrutura de um nó da AST
+typedef struct {
+    uint8_t kind;        // NodeKind
+    uint8_t op;          // OperatorKind
+    uint8_t flags;       // Modificadores / TYPE_ARRAY
+    uint8_t type;        // TypeKind (tipos declarados e, após a análise semântica, expressões)
+    uint32_t offset;     // Trecho do código fonte (nome, literal ou operador)
+    uint32_t length;
+    NodeId firstChild;
+    NodeId nextSibling;
+} AstNode;
+
+// Estrutura da árvore
+typedef struct {
+    Arena arena;
+    NodeId root;
+    const char *source;
+} Ast;
+
+// Estrutura do analisador sintático
+typedef struct {
+    const Token *tokens;
+    int count;
+    int pos;
+    Token end;           // Token sentinela para o fim do arquivo
+    Ast *ast;
+    int errorCount;
+    int panic;           // Suprime erros em cascata até a próxima sincronização
+    const int *braceMatch;  // Pares de chaves do analisador léxico (análise preguiçosa)
+    int lazyBodies;      // Se 1, corpos de métodos são pulados até parseLazyBody
+    const Token *(*fetchToken)(void *context, int index);  // Fluxo: token pelo índice (NULL no fim)
+    void (*releaseTokens)(void *context, int index);       // Fluxo: tokens antes de 'index' liberados
+    void *streamContext;
+} Parser;
+
+// Função para acessar um nó pelo índice
+AstNode *astNode(const Ast *ast, NodeId id) {
+    return ARENA_AT(&ast->arena, AstNode, id);
+}
+
+// Função para inicializar a árvore (reserva espaço proporcional aos tokens)
+void astInit(Ast *ast, const char *source, int tokenCount) {
+    arenaInit(&ast->arena, (uint32_t)(tokenCount + 16) * 2 * sizeof(AstNode));
+    ast->root = 0;
+    ast->source = source;
+}
+
+// Função para liberar a árvore inteira
+void astFree(Ast *ast) {
+    arenaFree(&ast->arena);
+    ast->root = 0;
+}
+
+// Função para criar um novo nó
+NodeId newNode(Ast *ast, NodeKind kind, uint32_t offset, uint32_t length) {
+    NodeId id = arenaAlloc(&ast->arena, sizeof(AstNode));
+    AstNode *node = astNode(ast, id);
+    node->kind = (uint8_t)kind;
+    node->offset = offset;
+    node->length = length;
+    return id;
+}
+
+// Função para anexar um filho (ou uma cadeia de irmãos) após 'last'; devolve o novo último filho
+NodeId appendChild(Ast *ast, NodeId parent, NodeId last, NodeId child) {
+    if (!child) {
+        return last;
+    }
+    if (last) {
+        astNode(ast, last)->nextSibling = child;
+    } else {
+        astNode(ast, parent)->firstChild = child;
+    }
+    while (astNode(ast, child)->nextSibling) {
+        child = astNode(ast, child)->nextSibling;
+    }
+    return child;
+}
+
+// Função para obter o n-ésimo filho de um nó (0 se não existir)
+NodeId nodeChild(const Ast *ast, NodeId id, int index) {
+    NodeId child = astNode(ast, id)->firstChild;
+    while (child && index-- > 0) {
+        child = astNode(ast, child)->nextSibling;
+    }
+    return child;
+}
+
+// Função para comparar o trecho de código de um nó com um texto
+int nodeTextIs(const Ast *ast, NodeId id, const char *text) {
+    const AstNode *node = astNode(ast, id);
+    return strlen(text) == node->length && strncmp(ast->source + node->offset, text, node->length) == 0;
+}
+
+// Função para converter NodeKind em string
+const char *nodeKindToString(NodeKind kind) {
+    switch (kind) {
+        case AST_PROGRAM: return "PROGRAM";
+        case AST_USING: return "USING";
+        case AST_NAMESPACE: return "NAMESPACE";
+        case AST_CLASS: return "CLASS";
+        case AST_METHOD: return "METHOD";
+        case AST_PARAM: return "PARAM";
+        case AST_TYPE: return "TYPE";
+        case AST_BLOCK: return "BLOCK";
+        case AST_VAR_DECL: return "VAR_DECL";
+        case AST_IF: return "IF";
+        case AST_WHILE: return "WHILE";
+        case AST_FOR: return "FOR";
+        case AST_RETURN: return "RETURN";
+        case AST_TRY: return "TRY";
+        case AST_CATCH: return "CATCH";
+        case AST_EXPR_STMT: return "EXPR_STMT";
+        case AST_EMPTY: return "EMPTY";
+        case AST_ASSIGN: return "ASSIGN";
+        case AST_BINARY: return "BINARY";
+        case AST_UNARY: return "UNARY";
+        case AST_CALL: return "CALL";
+        case AST_MEMBER: return "MEMBER";
+        case AST_INDEX: return "INDEX";
+        case AST_NEW: return "NEW";
+        case AST_IDENTIFIER: return "IDENTIFIER";
+        case AST_NUMBER: return "NUMBER";
+        case AST_STRING: return "STRING";
+        case AST_CHAR: return "CHAR";
+        case AST_BOOL: return "BOOL";
+        default: return "UNKNOWN";
+    }
+}
+
+// Função para converter OperatorKind em string
+const char *operatorToString(OperatorKind op) {
+    switch (op) {
+        case OP_ADD: return "+";
+        case OP_SUB: return "-";
+        case OP_MUL: return "*";
+        case OP_DIV: return "/";
+        case OP_MOD: return "%";
+        case OP_LT: return "<";
+        case OP_GT: return ">";
+        case OP_LE: return "<=";
+        case OP_GE: return ">=";
+        case OP_EQ: return "==";
+        case OP_NE: return "!=";
+        case OP_AND: return "&&";
+        case OP_OR: return "||";
+        case OP_NOT: return "!";
+        case OP_NEG: return "-";
+        case OP_PRE_INC: return "++x";
+        case OP_PRE_DEC: return "--x";
+        case OP_POST_INC: return "x++";
+        case OP_POST_DEC: return "x--";
+        case OP_ASSIGN: return "=";
+        case OP_ADD_ASSIGN: return "+=";
+        case OP_SUB_ASSIGN: return "-=";
+        case OP_MUL_ASSIGN: return "*=";
+        case OP_DIV_ASSIGN: return "/=";
+        case OP_MOD_ASSIGN: return "%=";
+        default: return "";
+    }
+}
+
+// Função para converter TypeKind em string
+const char *typeKindToString(TypeKind type) {
+    switch (type) {
+        case TY_VOID: return "void";
+        case TY_INT: return "int";
+        case TY_FLOAT: return "float";
+        case TY_DOUBLE: return "double";
+        case TY_CHAR: return "char";
+        case TY_BOOL: return "bool";
+        case TY_STRING: return "string";
+        case TY_CLASS: return "class";
+        default: return "?";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Acesso aos tokens
+// ---------------------------------------------------------------------------
+
+// Função para olhar o k-ésimo token à frente sem consumi-lo
+const Token *peekToken(Parser *p, int k) {
+    if (p->pos + k < p->count) {
+        return &p->tokens[p->pos + k];
+    }
+    if (p->fetchToken) {
+        const Token *tok = p->fetchToken(p->streamContext, p->pos + k);
+        if (tok) {
+            return tok;
+        }
+    }
+    return &p->end;
+}
+
+// Função para verificar se todos os tokens foram consumidos
+int atEnd(Parser *p) {
+    return peekToken(p, 0) == &p->end;
+}
+
+// Função para consumir o token atual
+const Token *advanceToken(Parser *p) {
+    const Token *tok = peekToken(p, 0);
+    if (tok != &p->end) {
+        p->pos++;
+    }
+    return tok;
+}
+
+// Função para marcar um ponto seguro: no modo em fluxo, libera os tokens já consumidos
+void releaseConsumed(Parser *p) {
+    if (p->releaseTokens) {
+        p->releaseTokens(p->streamContext, p->pos);
+    }
+}
+
+// Função para verificar o tipo (e opcionalmente o valor) de um token
+int tokenIs(const Token *tok, TokenType type, const char *value) {
+    return tok->type == type && (!value || strcmp(tok->value, value) == 0);
+}
+
+// Função para verificar o token atual
+int checkToken(Parser *p, TokenType type, const char *value) {
+    const Token *tok = peekToken(p, 0);
+    return tok != &p->end && tokenIs(tok, type, value);
+}
+
+// Função para consumir o token atual se ele for do tipo esperado
+int matchToken(Parser *p, TokenType type, const char *value) {
+    if (checkToken(p, type, value)) {
+        p->pos++;
+        return 1;
+    }
+    return 0;
+}
+
+// Função para reportar um erro sintático no token informado
+void syntaxError(Parser *p, const Token *tok, const char *message) {
+    if (p->panic) {
+        return;
+    }
+    int line, column;
+    offsetToLocation(tok->offset, &line, &column);
+    if (tok == &p->end) {
+        fprintf(stderr, "Erro sintático (linha %d, coluna %d): %s, encontrado fim do arquivo\n",
+                line, column, message);
+    } else {
+        fprintf(stderr, "Erro sintático (linha %d, coluna %d): %s, encontrado '%s'\n",
+                line, column, message, tok->value);
+    }
+    p->errorCount++;
+    p->panic = 1;
+}
+
+// Função para exigir um token; reporta erro se ele não estiver presente
+const Token *expectToken(Parser *p, TokenType type, const char *value, const char *message) {
+    if (checkToken(p, type, value)) {
+        return advanceToken(p);
+    }
+    syntaxError(p, peekToken(p, 0), message);
+    return NULL;
+}
+
+// Função para recuperar de um erro: avança até depois do próximo ';' ou até o próximo '}'
+void synchronize(Parser *p) {
+    if (!p->panic) {
+        return;
+    }
+    while (!atEnd(p)) {
+        if (matchToken(p, SEMICOLON, NULL) || checkToken(p, CLOSE_BRACE, NULL)) {
+            break;
+        }
+        p->pos++;
+    }
+    p->panic = 0;
+}
+
+// Função para ignorar diretivas ('#include', '#region', ...): cada uma é um único token
+void skipDirectives(Parser *p) {
+    while (matchToken(p, DIRECTIVE, NULL)) {
+    }
+}
+
+// Função para criar um nó cujo trecho é o texto de um token
+NodeId tokenNode(Parser *p, NodeKind kind, const Token *tok) {
+    return newNode(p->ast, kind, (uint32_t)tok->offset, (uint32_t)tok->size);
+}
+
+// ---------------------------------------------------------------------------
+// Expressões
+// ---------------------------------------------------------------------------
+
+NodeId parseExpression(Parser *p);
+NodeId parseType(Parser *p);
+NodeId parseBlock(Parser *p);
+
+// Estrutura com o papel de um token em expressões (tabela de precedência)
+typedef struct {
+    uint8_t infixOp;       // OperatorKind binário/atribuição (OP_NONE se não for infixo)
+    uint8_t leftPower;     // Força de ligação à esquerda (infixo e pós-fixo)
+    uint8_t rightPower;    // Força de ligação do operando à direita
+    uint8_t prefixOp;      // OperatorKind prefixo (OP_NONE se não for prefixo)
+    uint8_t postfixOp;     // OperatorKind pós-fixo; '(' '[' '.' usam OP_NONE com postfix = 1
+    uint8_t postfix;       // 1 se o token continua a expressão como pós-fixo
+} OperatorInfo;
+
+// Forças de ligação (quanto maior, mais forte); à esquerda < à direita = associativo à esquerda
+enum {
+    BP_ASSIGNMENT = 2,
+    BP_OR = 4,
+    BP_AND = 6,
+    BP_EQUALITY = 8,
+    BP_RELATIONAL = 10,
+    BP_ADDITIVE = 12,
+    BP_MULTIPLICATIVE = 14,
+    BP_PREFIX = 16,
+    BP_POSTFIX = 18
+};
+
+#define INFIX(op, power)       { (op), (power), (power) + 1, OP_NONE, OP_NONE, 0 }
+#define INFIX_RIGHT(op, power) { (op), (power), (power) - 1, OP_NONE, OP_NONE, 0 }
+
+// Tabela de operadores indexada por [forma][primeiro caractere]:
+// forma 0 = um caractere, 1 = seguido de '=', 2 = caractere dobrado ('++', '&&')
+static const OperatorInfo operatorTable[3][128] = {
+    [0] = {
+        ['+'] = { OP_ADD, BP_ADDITIVE, BP_ADDITIVE + 1, OP_NONE, OP_NONE, 0 },
+        ['-'] = { OP_SUB, BP_ADDITIVE, BP_ADDITIVE + 1, OP_NEG, OP_NONE, 0 },
+        ['*'] = INFIX(OP_MUL, BP_MULTIPLICATIVE),
+        ['/'] = INFIX(OP_DIV, BP_MULTIPLICATIVE),
+        ['%'] = INFIX(OP_MOD, BP_MULTIPLICATIVE),
+        ['<'] = INFIX(OP_LT, BP_RELATIONAL),
+        ['>'] = INFIX(OP_GT, BP_RELATIONAL),
+        ['!'] = { OP_NONE, 0, 0, OP_NOT, OP_NONE, 0 },
+        ['='] = INFIX_RIGHT(OP_ASSIGN, BP_ASSIGNMENT),
+        ['('] = { OP_NONE, BP_POSTFIX, 0, OP_NONE, OP_NONE, 1 },
+        ['['] = { OP_NONE, BP_POSTFIX, 0, OP_NONE, OP_NONE, 1 },
+        ['.'] = { OP_NONE, BP_POSTFIX, 0, OP_NONE, OP_NONE, 1 },
+    },
+    [1] = {
+        ['='] = INFIX(OP_EQ, BP_EQUALITY),
+        ['!'] = INFIX(OP_NE, BP_EQUALITY),
+        ['<'] = INFIX(OP_LE, BP_RELATIONAL),
+        ['>'] = INFIX(OP_GE, BP_RELATIONAL),
+        ['+'] = INFIX_RIGHT(OP_ADD_ASSIGN, BP_ASSIGNMENT),
+        ['-'] = INFIX_RIGHT(OP_SUB_ASSIGN, BP_ASSIGNMENT),
+        ['*'] = INFIX_RIGHT(OP_MUL_ASSIGN, BP_ASSIGNMENT),
+        ['/'] = INFIX_RIGHT(OP_DIV_ASSIGN, BP_ASSIGNMENT),
+        ['%'] = INFIX_RIGHT(OP_MOD_ASSIGN, BP_ASSIGNMENT),
+    },
+    [2] = {
+        ['&'] = INFIX(OP_AND, BP_AND),
+        ['|'] = INFIX(OP_OR, BP_OR),
+        ['+'] = { OP_NONE, BP_POSTFIX, 0, OP_PRE_INC, OP_POST_INC, 1 },
+        ['-'] = { OP_NONE, BP_POSTFIX, 0, OP_PRE_DEC, OP_POST_DEC, 1 },
+    },
+};
+
+// Tipos de token que podem participar de expressões como operadores
+static const uint8_t operatorTokenTypes[UNKNOWN + 1] = {
+    [OPERATOR] = 1, [ASSIGNMENT] = 1, [COMPARATOR] = 1,
+    [OPEN_PARENTHESIS] = 1, [OPEN_BRACKET] = 1, [UNKNOWN] = 1
+};
+
+// Função para consultar o papel de um token em expressões (NULL se não for operador)
+const OperatorInfo *operatorInfo(const Token *tok) {
+    unsigned char first = (unsigned char)tok->value[0];
+    if (!operatorTokenTypes[tok->type] || first >= 128) {
+        return NULL;
+    }
+    int form = tok->value[1] == '\0' ? 0 : tok->value[1] == '=' ? 1 : 2;
+    const OperatorInfo *info = &operatorTable[form][first];
+    return (info->leftPower || info->prefixOp) ? info : NULL;
+}
+
+// Função para verificar se um operador é de atribuição
+int isAssignmentOperator(OperatorKind op) {
+    return op >= OP_ASSIGN && op <= OP_MOD_ASSIGN;
+}
+
+// Função para ler um literal delimitado ("texto" ou 'c') direto do código fonte
+NodeId parseQuotedLiteral(Parser *p, NodeKind kind, char delimiter) {
+    const Token *open = advanceToken(p);
+    const char *source = p->ast->source;
+    uint32_t start = (uint32_t)open->offset;
+    uint32_t i = start + 1;
+
+    while (source[i] && source[i] != delimiter && source[i] != '\n') {
+        if (source[i] == '\\' && source[i + 1]) {
+            i++;
+        }
+        i++;
+    }
+    if (source[i] == delimiter) {
+        i++;
+    } else {
+        syntaxError(p, open, "literal não terminado");
+    }
+
+    // Descarta os tokens que o analisador léxico gerou dentro do literal
+    while (!atEnd(p) && (uint32_t)peekToken(p, 0)->offset < i) {
+        p->pos++;
+    }
+    return newNode(p->ast, kind, start, i - start);
+}
+
+// Função para analisar uma lista de argumentos "(a, b, ...)" anexando-os a 'parent'
+void parseArguments(Parser *p, NodeId parent, NodeId last) {
+    expectToken(p, OPEN_PARENTHESIS, NULL, "esperado '('");
+    if (!checkToken(p, CLOSE_PARENTHESIS, NULL)) {
+        do {
+            last = appendChild(p->ast, parent, last, parseExpression(p));
+        } while (matchToken(p, COMMA, NULL));
+    }
+    expectToken(p, CLOSE_PARENTHESIS, NULL, "esperado ')'");
+}
+
+// Função para analisar uma expressão primária
+NodeId parsePrimary(Parser *p) {
+    const Token *tok = peekToken(p, 0);
+
+    if (tok->type == NUM_LITERAL) {
+        return tokenNode(p, AST_NUMBER, advanceToken(p));
+    }
+    if (tok->type == IDENTIFIER) {
+        advanceToken(p);
+        NodeKind kind = (strcmp(tok->value, "true") == 0 || strcmp(tok->value, "false") == 0)
+                        ? AST_BOOL : AST_IDENTIFIER;
+        return tokenNode(p, kind, tok);
+    }
+    if (tok->type == QUOTE) {
+        return parseQuotedLiteral(p, AST_STRING, '"');
+    }
+    if (tokenIs(tok, UNKNOWN, "'")) {
+        return parseQuotedLiteral(p, AST_CHAR, '\'');
+    }
+    if (tok->type == OPEN_PARENTHESIS) {
+        advanceToken(p);
+        NodeId inner = parseExpression(p);
+        expectToken(p, CLOSE_PARENTHESIS, NULL, "esperado ')'");
+        return inner;
+    }
+    if (tokenIs(tok, KEYWORD, "new")) {
+        NodeId node = tokenNode(p, AST_NEW, advanceToken(p));
+        NodeId last = appendChild(p->ast, node, 0, parseType(p));
+        if (matchToken(p, OPEN_BRACKET, NULL)) {
+            astNode(p->ast, node)->flags |= TYPE_ARRAY;
+            appendChild(p->ast, node, last, parseExpression(p));
+            expectToken(p, CLOSE_BRACKET, NULL, "esperado ']'");
+        } else {
+            parseArguments(p, node, last);
+        }
+        return node;
+    }
+
+    syntaxError(p, tok, "esperada uma expressão");
+    return newNode(p->ast, AST_EMPTY, (uint32_t)tok->offset, 0);
+}
+
+// Função para criar um nó com um ou dois operandos
+NodeId operatorNode(Parser *p, NodeKind kind, const Token *tok, OperatorKind op, NodeId left, NodeId right) {
+    NodeId node = tokenNode(p, kind, tok);
+    astNode(p->ast, node)->op = (uint8_t)op;
+    NodeId last = appendChild(p->ast, node, 0, left);
+    appendChild(p->ast, node, last, right);
+    return node;
+}
+
+// Função para analisar um operador pós-fixo (chamada, índice, membro, '++', '--')
+NodeId parsePostfixOperator(Parser *p, NodeId left, const OperatorInfo *info) {
+    const Token *tok = advanceToken(p);
+
+    if (info->postfixOp != OP_NONE) {
+        return operatorNode(p, AST_UNARY, tok, (OperatorKind)info->postfixOp, left, 0);
+    }
+    if (tok->type == OPEN_PARENTHESIS) {
+        NodeId call = tokenNode(p, AST_CALL, tok);
+        NodeId last = appendChild(p->ast, call, 0, left);
+        p->pos--;  // parseArguments consome o '('
+        parseArguments(p, call, last);
+        return call;
+    }
+    if (tok->type == OPEN_BRACKET) {
+        NodeId index = operatorNode(p, AST_INDEX, tok, OP_NONE, left, parseExpression(p));
+        expectToken(p, CLOSE_BRACKET, NULL, "esperado ']'");
+        return index;
+    }
+    const Token *name = expectToken(p, IDENTIFIER, NULL, "esperado nome do membro");
+    return operatorNode(p, AST_MEMBER, name ? name : tok, OP_NONE, left, 0);
+}
+
+// Função para analisar uma expressão cujos operadores ligam com força maior ou igual a 'minPower'
+// (analisador de Pratt: cada operador custa uma consulta à tabela operatorTable)
+NodeId parseExpressionPower(Parser *p, int minPower) {
+    const Token *tok = peekToken(p, 0);
+    const OperatorInfo *info = operatorInfo(tok);
+    NodeId left;
+
+    if (info && info->prefixOp != OP_NONE) {
+        advanceToken(p);
+        left = operatorNode(p, AST_UNARY, tok, (OperatorKind)info->prefixOp,
+                            parseExpressionPower(p, BP_PREFIX), 0);
+    } else {
+        left = parsePrimary(p);
+    }
+
+    for (;;) {
+        tok = peekToken(p, 0);
+        info = operatorInfo(tok);
+        if (!info || info->leftPower < minPower) {
+            return left;
+        }
+        if (info->postfix) {
+            left = parsePostfixOperator(p, left, info);
+            continue;
+        }
+        if (info->infixOp == OP_NONE) {
+            return left;
+        }
+        advanceToken(p);
+        OperatorKind op = (OperatorKind)info->infixOp;
+        NodeId right = parseExpressionPower(p, info->rightPower);
+        left = operatorNode(p, isAssignmentOperator(op) ? AST_ASSIGN : AST_BINARY, tok, op, left, right);
+    }
+}
+
+// Função para analisar uma expressão
+NodeId parseExpression(Parser *p) {
+    return parseExpressionPower(p, BP_ASSIGNMENT - 1);
+}
+
+// ---------------------------------------------------------------------------
+// Declarações e comandos
+// ---------------------------------------------------------------------------
+
+// Função para mapear um token TYPE para TypeKind
+TypeKind builtinType(const char *name) {
+    if (strcmp(name, "int") == 0) return TY_INT;
+    if (strcmp(name, "float") == 0) return TY_FLOAT;
+    if (strcmp(name, "double") == 0) return TY_DOUBLE;
+    if (strcmp(name, "char") == 0) return TY_CHAR;
+    if (strcmp(name, "bool") == 0) return TY_BOOL;
+    return TY_UNKNOWN;
+}
+
+// Função para analisar um nome qualificado (A.B.C); devolve o trecho completo
+NodeId parseQualifiedName(Parser *p, NodeKind kind) {
+    const Token *first = expectToken(p, IDENTIFIER, NULL, "esperado um nome");
+    if (!first) {
+        return newNode(p->ast, kind, (uint32_t)peekToken(p, 0)->offset, 0);
+    }
+    const Token *last = first;
+    while (checkToken(p, UNKNOWN, ".") && peekToken(p, 1)->type == IDENTIFIER) {
+        advanceToken(p);
+        last = advanceToken(p);
+    }
+    return newNode(p->ast, kind, (uint32_t)first->offset,
+                   (uint32_t)(last->offset + last->size - first->offset));
+}
+
+// Função para analisar um tipo (int, void, Nome.Qualificado, tipo[])
+NodeId parseType(Parser *p) {
+    const Token *tok = peekToken(p, 0);
+    NodeId node;
+
+    if (tok->type == TYPE) {
+        node = tokenNode(p, AST_TYPE, advanceToken(p));
+        astNode(p->ast, node)->type = (uint8_t)builtinType(tok->value);
+    } else if (tokenIs(tok, KEYWORD, "void")) {
+        node = tokenNode(p, AST_TYPE, advanceToken(p));
+        astNode(p->ast, node)->type = TY_VOID;
+    } else {
+        node = parseQualifiedName(p, AST_TYPE);
+        astNode(p->ast, node)->type = TY_CLASS;
+    }
+
+    if (checkToken(p, OPEN_BRACKET, NULL) && peekToken(p, 1)->type == CLOSE_BRACKET) {
+        const Token *close = peekToken(p, 1);
+        p->pos += 2;
+        AstNode *type = astNode(p->ast, node);
+        type->flags |= TYPE_ARRAY;
+        type->length = (uint32_t)close->offset + 1 - type->offset;
+    }
+    return node;
+}
+
+// Função para verificar se o comando atual começa com uma declaração de variável
+int isDeclarationStart(Parser *p) {
+    const Token *tok = peekToken(p, 0);
+    if (tok->type == TYPE) {
+        return 1;
+    }
+    if (tok->type != IDENTIFIER) {
+        return 0;
+    }
+    const Token *next = peekToken(p, 1);
+    return next->type == IDENTIFIER ||
+           (next->type == OPEN_BRACKET && peekToken(p, 2)->type == CLOSE_BRACKET);
+}
+
+// Função para copiar o nó de tipo (cada declarador recebe o seu)
+NodeId copyTypeNode(Ast *ast, NodeId type) {
+    NodeId copy = newNode(ast, AST_TYPE, 0, 0);
+    AstNode *dst = astNode(ast, copy);
+    *dst = *astNode(ast, type);
+    dst->nextSibling = 0;
+    return copy;
+}
+
+// Função para analisar "nome [op expr] {, nome [op expr]}" após o tipo; devolve a cadeia de VAR_DECL
+NodeId parseDeclarators(Parser *p, NodeId type, uint8_t flags) {
+    NodeId first = 0, last = 0;
+    do {
+        const Token *name = expectToken(p, IDENTIFIER, NULL, "esperado nome da variável");
+        if (!name) {
+            break;
+        }
+        NodeId decl = tokenNode(p, AST_VAR_DECL, name);
+        astNode(p->ast, decl)->flags = flags;
+        NodeId child = appendChild(p->ast, decl, 0, first ? copyTypeNode(p->ast, type) : type);
+
+        // O operador é guardado para a análise semântica (ex.: 'float b += 3.14;')
+        const OperatorInfo *info = operatorInfo(peekToken(p, 0));
+        OperatorKind op = info ? (OperatorKind)info->infixOp : OP_NONE;
+        if (isAssignmentOperator(op)) {
+            advanceToken(p);
+            astNode(p->ast, decl)->op = (uint8_t)op;
+            appendChild(p->ast, decl, child, parseExpression(p));
+        }
+
+        if (last) {
+            astNode(p->ast, last)->nextSibling = decl;
+        } else {
+            first = decl;
+        }
+        last = decl;
+    } while (matchToken(p, COMMA, NULL));
+    return first;
+}
+
+NodeId parseStatement(Parser *p);
+
+// Função para analisar um comando opcional em 'for' (EMPTY se ausente)
+NodeId parseOptionalExpression(Parser *p, TokenType terminator) {
+    if (checkToken(p, terminator, NULL)) {
+        return newNode(p->ast, AST_EMPTY, (uint32_t)peekToken(p, 0)->offset, 0);
+    }
+    return parseExpression(p);
+}
+
+// Função para analisar o comando 'for'
+NodeId parseFor(Parser *p) {
+    NodeId node = tokenNode(p, AST_FOR, advanceToken(p));
+    NodeId last = 0;
+    expectToken(p, OPEN_PARENTHESIS, NULL, "esperado '(' após 'for'");
+
+    NodeId init;
+    if (isDeclarationStart(p)) {
+        init = parseDeclarators(p, parseType(p), 0);
+        if (astNode(p->ast, init)->nextSibling) {
+            syntaxError(p, peekToken(p, 0), "apenas uma variável pode ser declarada no 'for'");
+            astNode(p->ast, init)->nextSibling = 0;
+        }
+    } else {
+        init = parseOptionalExpression(p, SEMICOLON);
+    }
+    last = appendChild(p->ast, node, last, init);
+    expectToken(p, SEMICOLON, NULL, "esperado ';'");
+    last = appendChild(p->ast, node, last, parseOptionalExpression(p, SEMICOLON));
+    expectToken(p, SEMICOLON, NULL, "esperado ';'");
+    last = appendChild(p->ast, node, last, parseOptionalExpression(p, CLOSE_PARENTHESIS));
+    expectToken(p, CLOSE_PARENTHESIS, NULL, "esperado ')'");
+    appendChild(p->ast, node, last, parseStatement(p));
+    return node;
+}
+
+// Função para analisar o comando 'try' com seus blocos 'catch'
+NodeId parseTry(Parser *p) {
+    NodeId node = tokenNode(p, AST_TRY, advanceToken(p));
+    NodeId last = appendChild(p->ast, node, 0, parseBlock(p));
+
+    if (!checkToken(p, KEYWORD, "catch")) {
+        syntaxError(p, peekToken(p, 0), "esperado 'catch' após o bloco 'try'");
+    }
+    while (checkToken(p, KEYWORD, "catch")) {
+        NodeId handler = tokenNode(p, AST_CATCH, advanceToken(p));
+        NodeId child = 0;
+        if (matchToken(p, OPEN_PARENTHESIS, NULL)) {
+            child = appendChild(p->ast, handler, child, parseType(p));
+            if (checkToken(p, IDENTIFIER, NULL)) {
+                const Token *name = advanceToken(p);
+                AstNode *h = astNode(p->ast, handler);
+                h->offset = (uint32_t)name->offset;
+                h->length = (uint32_t)name->size;
+            }
+            expectToken(p, CLOSE_PARENTHESIS, NULL, "esperado ')'");
+        }
+        appendChild(p->ast, handler, child, parseBlock(p));
+        last = appendChild(p->ast, node, last, handler);
+    }
+    return node;
+}
+
+// Função para analisar um comando
+NodeId parseStatement(Parser *p) {
+    const Token *tok = peekToken(p, 0);
+
+    if (tok->type == OPEN_BRACE) {
+        return parseBlock(p);
+    }
+    if (tok->type == SEMICOLON) {
+        return tokenNode(p, AST_EMPTY, advanceToken(p));
+    }
+    if (tokenIs(tok, KEYWORD, "if")) {
+        NodeId node = tokenNode(p, AST_IF, advanceToken(p));
+        expectToken(p, OPEN_PARENTHESIS, NULL, "esperado '(' após 'if'");
+        NodeId last = appendChild(p->ast, node, 0, parseExpression(p));
+        expectToken(p, CLOSE_PARENTHESIS, NULL, "esperado ')'");
+        last = appendChild(p->ast, node, last, parseStatement(p));
+        if (matchToken(p, KEYWORD, "else")) {
+            appendChild(p->ast, node, last, parseStatement(p));
+        }
+        return node;
+    }
+    if (tokenIs(tok, KEYWORD, "while")) {
+        NodeId node = tokenNode(p, AST_WHILE, advanceToken(p));
+        expectToken(p, OPEN_PARENTHESIS, NULL, "esperado '(' após 'while'");
+        NodeId last = appendChild(p->ast, node, 0, parseExpression(p));
+        expectToken(p, CLOSE_PARENTHESIS, NULL, "esperado ')'");
+        appendChild(p->ast, node, last, parseStatement(p));
+        return node;
+    }
+    if (tokenIs(tok, KEYWORD, "for")) {
+        return parseFor(p);
+    }
+    if (tokenIs(tok, KEYWORD, "return")) {
+        NodeId node = tokenNode(p, AST_RETURN, advanceToken(p));
+        if (!checkToken(p, SEMICOLON, NULL)) {
+            appendChild(p->ast, node, 0, parseExpression(p));
+        }
+        expectToken(p, SEMICOLON, NULL, "esperado ';'");
+        return node;
+    }
+    if (tokenIs(tok, KEYWORD, "try")) {
+        return parseTry(p);
+    }
+    if (isDeclarationStart(p)) {
+        NodeId decls = parseDeclarators(p, parseType(p), 0);
+        expectToken(p, SEMICOLON, NULL, "esperado ';'");
+        return decls;
+    }
+
+    NodeId node = tokenNode(p, AST_EXPR_STMT, tok);
+    appendChild(p->ast, node, 0, parseExpression(p));
+    expectToken(p, SEMICOLON, NULL, "esperado ';'");
+    return node;
+}
+
+// Função para analisar "{ comandos }" anexando os comandos ao nó BLOCK informado
+void parseBlockInto(Parser *p, NodeId node) {
+    NodeId last = 0;
+
+    if (!expectToken(p, OPEN_BRACE, NULL, "esperado '{'")) {
+        return;
+    }
+    for (;;) {
+        releaseConsumed(p);
+        skipDirectives(p);
+        if (atEnd(p) || checkToken(p, CLOSE_BRACE, NULL)) {
+            break;
+        }
+        last = appendChild(p->ast, node, last, parseStatement(p));
+        synchronize(p);
+    }
+    expectToken(p, CLOSE_BRACE, NULL, "esperado '}'");
+}
+
+// Função para analisar um bloco "{ comandos }"
+NodeId parseBlock(Parser *p) {
+    NodeId node = tokenNode(p, AST_BLOCK, peekToken(p, 0));
+    parseBlockInto(p, node);
+    return node;
+}
+
+// Função para pular um corpo de método sem analisá-lo (usa o par de chaves do analisador léxico)
+NodeId skipBody(Parser *p) {
+    const Token *open = peekToken(p, 0);
+    int close = (p->braceMatch && p->pos < p->count) ? p->braceMatch[p->pos] : -1;
+    if (open->type != OPEN_BRACE || close < 0) {
+        return parseBlock(p);
+    }
+    NodeId node = newNode(p->ast, AST_BLOCK, (uint32_t)open->offset,
+                          (uint32_t)(p->tokens[close].offset + 1 - open->offset));
+    astNode(p->ast, node)->flags = BLOCK_UNPARSED;
+    p->pos = close + 1;
+    return node;
+}
+
+// Função para analisar sob demanda um corpo pulado; não faz nada se ele já foi analisado
+void parseLazyBody(Parser *p, NodeId block) {
+    AstNode *node = astNode(p->ast, block);
+    if (!(node->flags & BLOCK_UNPARSED)) {
+        return;
+    }
+    node->flags &= (uint8_t)~BLOCK_UNPARSED;
+
+    // Localiza o '{' pelo deslocamento (tokens estão em ordem crescente de deslocamento)
+    int low = 0, high = p->count - 1;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if ((uint32_t)p->tokens[mid].offset < node->offset)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    int saved = p->pos;
+    p->pos = low;
+    parseBlockInto(p, block);
+    p->panic = 0;
+    p->pos = saved;
+}
+
+// Função para analisar os parâmetros de um método, anexando-os a 'method'
+NodeId parseParameters(Parser *p, NodeId method, NodeId last) {
+    expectToken(p, OPEN_PARENTHESIS, NULL, "esperado '('");
+    if (!checkToken(p, CLOSE_PARENTHESIS, NULL)) {
+        do {
+            NodeId type = parseType(p);
+            const Token *name = expectToken(p, IDENTIFIER, NULL, "esperado nome do parâmetro");
+            NodeId param = name ? tokenNode(p, AST_PARAM, name)
+                                : newNode(p->ast, AST_PARAM, (uint32_t)peekToken(p, 0)->offset, 0);
+            appendChild(p->ast, param, 0, type);
+            last = appendChild(p->ast, method, last, param);
+        } while (matchToken(p, COMMA, NULL));
+    }
+    expectToken(p, CLOSE_PARENTHESIS, NULL, "esperado ')'");
+    return last;
+}
+
+// Função para analisar o restante de um método após o tipo e o nome
+NodeId parseMethod(Parser *p, NodeId returnType, const Token *name, uint8_t flags) {
+    NodeId method = tokenNode(p, AST_METHOD, name);
+    astNode(p->ast, method)->flags = flags;
+    NodeId last = appendChild(p->ast, method, 0, returnType);
+    last = parseParameters(p, method, last);
+    appendChild(p->ast, method, last, p->lazyBodies ? skipBody(p) : parseBlock(p));
+    return method;
+}
+
+NodeId parseDeclaration(Parser *p);
+
+// Função para descartar um token que não inicia nenhuma declaração (garante progresso)
+void skipUnexpected(Parser *p, int errorsBefore) {
+    if (p->errorCount == errorsBefore) {
+        syntaxError(p, peekToken(p, 0), "token inesperado");
+    }
+    p->panic = 0;
+    p->pos++;
+}
+
+// Função para analisar uma lista de declarações entre chaves, anexando-as a 'parent'
+void parseMembers(Parser *p, NodeId parent) {
+    NodeId last = 0;
+    expectToken(p, OPEN_BRACE, NULL, "esperado '{'");
+    for (;;) {
+        releaseConsumed(p);
+        skipDirectives(p);
+        if (atEnd(p) || checkToken(p, CLOSE_BRACE, NULL)) {
+            break;
+        }
+        int start = p->pos, errors = p->errorCount;
+        last = appendChild(p->ast, parent, last, parseDeclaration(p));
+        synchronize(p);
+        if (p->pos == start) {
+            skipUnexpected(p, errors);
+        }
+    }
+    expectToken(p, CLOSE_BRACE, NULL, "esperado '}'");
+}
+
+// Função para analisar uma declaração (using, namespace, classe, método ou campo)
+NodeId parseDeclaration(Parser *p) {
+    if (matchToken(p, KEYWORD, "using")) {
+        NodeId node = parseQualifiedName(p, AST_USING);
+        expectToken(p, SEMICOLON, NULL, "esperado ';'");
+        return node;
+    }
+    if (matchToken(p, KEYWORD, "namespace")) {
+        NodeId node = parseQualifiedName(p, AST_NAMESPACE);
+        parseMembers(p, node);
+        return node;
+    }
+
+    uint8_t flags = 0;
+    for (;;) {
+        if (matchToken(p, KEYWORD, "public")) flags |= MOD_PUBLIC;
+        else if (matchToken(p, KEYWORD, "private")) flags |= MOD_PRIVATE;
+        else if (matchToken(p, KEYWORD, "static")) flags |= MOD_STATIC;
+        else break;
+    }
+
+    if (matchToken(p, KEYWORD, "class")) {
+        const Token *name = expectToken(p, IDENTIFIER, NULL, "esperado nome da classe");
+        NodeId node = name ? tokenNode(p, AST_CLASS, name)
+                           : newNode(p->ast, AST_CLASS, (uint32_t)peekToken(p, 0)->offset, 0);
+        astNode(p->ast, node)->flags = flags;
+        parseMembers(p, node);
+        return node;
+    }
+
+    // Construtor: Nome(...)
+    if (checkToken(p, IDENTIFIER, NULL) && peekToken(p, 1)->type == OPEN_PARENTHESIS) {
+        const Token *name = advanceToken(p);
+        NodeId type = newNode(p->ast, AST_TYPE, (uint32_t)name->offset, 0);
+        astNode(p->ast, type)->type = TY_VOID;
+        return parseMethod(p, type, name, flags | MOD_CONSTRUCTOR);
+    }
+
+    const Token *tok = peekToken(p, 0);
+    if (tok->type != TYPE && tok->type != IDENTIFIER && !tokenIs(tok, KEYWORD, "void")) {
+        syntaxError(p, tok, "esperada uma declaração");
+        return 0;
+    }
+
+    NodeId type = parseType(p);
+    if (checkToken(p, IDENTIFIER, NULL) && peekToken(p, 1)->type == OPEN_PARENTHESIS) {
+        return parseMethod(p, type, advanceToken(p), flags);
+    }
+    NodeId fields = parseDeclarators(p, type, flags);
+    expectToken(p, SEMICOLON, NULL, "esperado ';'");
+    return fields;
+}
+
+// Função para inicializar o analisador sintático sobre uma lista de tokens
+// (para um fluxo, use count = 0 e preencha fetchToken/releaseTokens/streamContext)
+void parserInit(Parser *p, Ast *ast, const Token *tokenList, int count) {
+    memset(p, 0, sizeof(*p));
+    p->tokens = tokenList;
+    p->count = count;
+    p->ast = ast;
+    p->end.type = UNKNOWN;
+    p->end.offset = (int)strlen(ast->source);
+}
+
+// Função principal da análise sintática: constrói a AST do programa inteiro
+NodeId parseProgram(Parser *p) {
+    NodeId root = newNode(p->ast, AST_PROGRAM, 0, 0);
+    NodeId last = 0;
+    p->ast->root = root;
+
+    for (;;) {
+        releaseConsumed(p);
+        skipDirectives(p);
+        if (atEnd(p)) {
+            break;
+        }
+        int start = p->pos, errors = p->errorCount;
+        last = appendChild(p->ast, root, last, parseDeclaration(p));
+        synchronize(p);
+        if (p->pos == start) {
+            skipUnexpected(p, errors);
+        }
+    }
+    return root;
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Arena de alocação (bump pointer)
+ *
+ * Reserva um único bloco contíguo e entrega pedaços dele avançando um
+ * ponteiro. Os objetos são referenciados por deslocamentos de 32 bits em vez
+ * de ponteiros, de modo que o bloco pode crescer (realloc) sem invalidar as
+ * referências. Liberar a arena inteira é uma única chamada a bigFree(); o
+ * bloco de uma arena grande fica em páginas de 2 MB (memoria grande.h).
+ *
+ * O deslocamento 0 é reservado e representa "nenhum objeto".
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "memoria grande.h"
+
+#define ARENA_ALIGNMENT 8
+
+typedef struct {
+    char *base;
+    uint32_t used;
+    uint32_t capacity;
+} Arena;
+
+// Macro para obter o ponteiro de um objeto a partir do seu deslocamento
+#define ARENA_AT(arena, type, ref) ((type *)((arena)->base + (ref)))
+
+// Função para inicializar a arena com uma capacidade inicial estimada
+void arenaInit(Arena *arena, uint32_t capacity) {
+    if (capacity < 64) {
+        capacity = 64;
+    }
+    arena->base = bigAlloc(capacity);
+    if (!arena->base) {
+        fprintf(stderr, "Erro: Falha ao alocar a arena.\n");
+        exit(EXIT_FAILURE);
+    }
+    arena->capacity = capacity;
+    arena->used = ARENA_ALIGNMENT; // Reserva o deslocamento 0
+}
+
+// Função para alocar 'size' bytes zerados na arena; devolve o deslocamento
+uint32_t arenaAlloc(Arena *arena, uint32_t size) {
+    uint32_t offset = (arena->used + ARENA_ALIGNMENT - 1) & ~(uint32_t)(ARENA_ALIGNMENT - 1);
+    if ((uint64_t)offset + size > arena->capacity) {
+        uint64_t capacity = (uint64_t)arena->capacity * 2;
+        while (capacity < (uint64_t)offset + size) {
+            capacity *= 2;
+        }
+        if (capacity > UINT32_MAX) {
+            fprintf(stderr, "Erro: Arena excedeu o limite de 4 GB.\n");
+            exit(EXIT_FAILURE);
+        }
+        char *grown = bigRealloc(arena->base, capacity);
+        if (!grown) {
+            fprintf(stderr, "Erro: Falha ao aumentar a arena.\n");
+            exit(EXIT_FAILURE);
+        }
+        arena->base = grown;
+        arena->capacity = (uint32_t)capacity;
+    }
+    memset(arena->base + offset, 0, size);
+    arena->used = offset + size;
+    return offset;
+}
+
+// Função para descartar todo o conteúdo mantendo o bloco reservado
+void arenaReset(Arena *arena) {
+    arena->used = ARENA_ALIGNMENT;
+}
+
+// Função para liberar a arena
+void arenaFree(Arena *arena) {
+    bigFree(arena->base);
+    arena->base = NULL;
+    arena->used = arena->capacity = 0;
+}
+
+#endif
@@ -0,0 +1,188 @@
+/*
+ * Programa da busca de código por tokens
+ *
+ * Monta o índice de tokens de um conjunto de arquivos C# e busca nele
+ * sequências de tokens (indice de tokens.h). A busca só mapeia o índice:
+ * nenhum arquivo é analisado de novo, e só os arquivos com ocorrências são
+ * lidos, para converter o deslocamento de cada uma em linha e coluna.
+ *
+ * Uso:
+ * - --indexar <índice> <arquivo ou diretório>...: analisa os arquivos (os
+ *   diretórios são percorridos recursivamente atrás de arquivos .cs) e
+ *   grava o índice
+ * - --buscar <índice> <padrão>...: exibe as ocorrências do padrão (as
+ *   palavras seguintes formam um único padrão, ex.: new IDENTIFIER '(')
+ *
+ * Opções:
+ * - --threads <n>: threads da indexação (padrão: número de processadores)
+ * - --leitura <io_uring|pread>: forma da leitura dos arquivos na indexação
+ *   (padrão: io_uring, ou pread se o kernel não permitir)
+ * - --paginas <nenhuma|transparentes|explicitas>: páginas das listas de
+ *   tokens das threads da indexação (memoria grande.h; padrão:
+ *   transparentes)
+ * - --limite <n>: exibe no máximo n ocorrências (a contagem para junto)
+ */
+
+#include "indice de tokens.h"
+
+// Estrutura do estado da exibição das ocorrências
+typedef struct {
+    uint32_t file;             // Arquivo cujo índice de linhas está carregado
+    int *lineStarts;
+    int lineCount;
+    int length;                // Tokens do padrão
+    uint64_t shown;
+    uint64_t limit;            // 0 = sem limite
+} SearchOutput;
+
+// Função para exibir uma ocorrência: arquivo, linha, coluna e os tokens encontrados
+int printMatch(const TokenIndex *index, uint32_t token, void *context) {
+    SearchOutput *output = context;
+    uint32_t file = indexFileOf(index, token);
+    const char *path = index->strings + index->files[file].path;
+    if (file != output->file) {
+        // Índice de linhas do arquivo, lido uma vez por arquivo com ocorrências
+        free(output->lineStarts);
+        output->lineStarts = NULL;
+        output->file = file;
+        char *code = readSourceFile(path, NULL);
+        if (code) {
+            output->lineStarts = buildLineStarts(code, &output->lineCount);
+            free(code);
+        }
+    }
+    if (output->lineStarts) {
+        int line, column;
+        locateOffset(output->lineStarts, output->lineCount, (int)index->offsets[token], &line, &column);
+        printf("%s:%d:%d:", path, line, column);
+    } else {
+        printf("%s:+%u:", path, index->offsets[token]);
+    }
+    for (int i = 0; i < output->length; i++) {
+        printf(" %s", indexTermText(index, INDEX_TERM(index->codes[token + i])));
+    }
+    printf("\n");
+    output->shown++;
+    return output->limit == 0 || output->shown < output->limit;
+}
+
+// Função para indexar os caminhos; devolve o código de saída
+int runIndex(const char *output, char **arguments, int count, int threads, BatchReadMode readMode) {
+    char **paths = NULL;
+    uint32_t pathCount = 0, capacity = 0;
+    for (int i = 0; i < count; i++) {
+        indexCollect(arguments[i], &paths, &pathCount, &capacity);
+    }
+    if (pathCount > 1) {
+        qsort(paths, pathCount, sizeof(char *), indexComparePaths);
+    }
+
+    IndexStats stats;
+    int status = indexBuild(paths, pathCount, threads, readMode, output, &stats);
+    if (status == 0) {
+        printf("Índice: %s\n", output);
+        printf("Arquivos: %u (%u ilegível(is)), %lu token(s), %u texto(s) distinto(s)\n",
+               stats.files, stats.unreadable, (unsigned long)stats.tokens, stats.terms);
+        printf("Tempo: %.3f ms na análise, %.3f ms na montagem e gravação; %lu byte(s)\n",
+               stats.lexMs, stats.buildMs, (unsigned long)stats.bytes);
+        if (stats.enters) {
+            printf("Leitura: %s, %lu chamada(s) a io_uring_enter\n", stats.readMode, (unsigned long)stats.enters);
+        } else {
+            printf("Leitura: %s\n", stats.readMode);
+        }
+    }
+    for (uint32_t i = 0; i < pathCount; i++) {
+        free(paths[i]);
+    }
+    free(paths);
+    return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Função para buscar um padrão no índice; devolve o código de saída
+int runSearch(const char *path, char **arguments, int count, uint64_t limit) {
+    TokenIndex index;
+    if (indexOpen(&index, path) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    // As palavras do padrão podem vir em vários argumentos
+    size_t length = 1;
+    for (int i = 0; i < count; i++) {
+        length += strlen(arguments[i]) + 1;
+    }
+    char *text = calloc(length, 1);
+    if (!text) {
+        fprintf(stderr, "Erro: Falha ao alocar o padrão.\n");
+        indexClose(&index);
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < count; i++) {
+        strcat(text, arguments[i]);
+        strcat(text, " ");
+    }
+
+    TokenPattern pattern;
+    if (patternParse(&index, text, &pattern) != 0) {
+        fprintf(stderr, "Erro: Padrão vazio ou com mais de %d elementos.\n", INDEX_MAX_PATTERN);
+        free(text);
+        indexClose(&index);
+        return EXIT_FAILURE;
+    }
+    SearchOutput output = {UINT32_MAX, NULL, 0, pattern.count, 0, limit};
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint64_t matches = indexSearch(&index, &pattern, printMatch, &output);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    printf("\n%lu ocorrência(s)%s em %u arquivo(s) indexado(s) (%.3f ms)\n", (unsigned long)matches,
+           limit && matches >= limit ? " (limite atingido)" : "", index.header->fileCount, elapsed);
+
+    free(output.lineStarts);
+    free(text);
+    indexClose(&index);
+    return EXIT_SUCCESS;
+}
+
+// Função principal
+int main(int argc, char *argv[]) {
+    char **arguments = malloc(argc * sizeof(char *));
+    const char *indexPath = NULL;
+    int count = 0, threads = 0, search = -1;
+    uint64_t limit = 0;
+    BatchReadMode readMode = BATCH_READ_AUTO;
+    if (!arguments) {
+        fprintf(stderr, "Erro: Falha ao alocar memória.\n");
+        return EXIT_FAILURE;
+    }
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--indexar") == 0 || strcmp(argv[i], "--buscar") == 0) && i + 1 < argc) {
+            search = strcmp(argv[i], "--buscar") == 0;
+            indexPath = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--leitura") == 0 && i + 1 < argc) {
+            readMode = strcmp(argv[++i], "pread") == 0 ? BATCH_READ_PREAD : BATCH_READ_AUTO;
+        } else if (strcmp(argv[i], "--paginas") == 0 && i + 1 < argc) {
+            if (hugePageModeParse(argv[++i], &hugePageMode) != 0) {
+                fprintf(stderr, "Erro: Tipo de página desconhecido: %s\n", argv[i]);
+                free(arguments);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--limite") == 0 && i + 1 < argc) {
+            limit = strtoull(argv[++i], NULL, 10);
+        } else {
+            arguments[count++] = argv[i];
+        }
+    }
+    if (search < 0 || count == 0) {
+        fprintf(stderr, "Uso: %s --indexar <índice> <arquivo ou diretório>... [--threads n]\n"
+                        "     %s --buscar <índice> <padrão>... [--limite n]\n", argv[0], argv[0]);
+        free(arguments);
+        return EXIT_FAILURE;
+    }
+
+    int status = search ? runSearch(indexPath, arguments, count, limit)
+                        : runIndex(indexPath, arguments, count, threads, readMode);
+    free(arguments);
+    return status;
+}
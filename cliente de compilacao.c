@@ -0,0 +1,92 @@
+/*
+ * Cliente do servidor de compilação
+ *
+ * Repassa o diretório atual e os argumentos da linha de comando ao
+ * servidor (servidor de compilacao.c) e reproduz a saída e o código de
+ * saída do comando, como se ele tivesse rodado neste processo.
+ *
+ * Uso: cliente de compilacao [--socket <caminho>] <comando> [argumentos...]
+ * Comandos: lexico, compilar, estado, limpar, parar (ver servidor de compilacao.h)
+ */
+
+#define _GNU_SOURCE   // struct ucred (SO_PEERCRED)
+#include "protocolo do servidor.h"
+
+// Função principal
+int main(int argc, char *argv[]) {
+    const char *socketOption = NULL;
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "--socket") == 0) {
+        socketOption = argv[2];
+        first = 3;
+    }
+    if (first >= argc) {
+        fprintf(stderr, "Uso: %s [--socket <caminho>] <comando> [argumentos...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    char path[512];
+    struct sockaddr_un address;
+    if (serverSocketPath(path, sizeof(path), socketOption) != 0 || serverAddress(&address, path) != 0) {
+        return EXIT_FAILURE;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        fprintf(stderr, "Erro: o servidor de compilação não está em execução (%s)\n", path);
+        return EXIT_FAILURE;
+    }
+
+    // O pedido leva o diretório e os argumentos e a resposta vira a saída deste processo: só com um servidor
+    // do mesmo usuário
+    struct ucred peer;
+    socklen_t peerLength = sizeof(peer);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &peerLength) != 0 || peer.uid != getuid()) {
+        fprintf(stderr, "Erro: o servidor em %s não pertence a este usuário\n", path);
+        return EXIT_FAILURE;
+    }
+
+    // Pedido: diretório atual e argumentos, separados por '\0'
+    char cwd[4096];
+    if (!getcwd(cwd, sizeof(cwd))) {
+        perror("Erro ao obter o diretório atual");
+        return EXIT_FAILURE;
+    }
+    size_t length = strlen(cwd) + 1;
+    for (int i = first; i < argc; i++) {
+        length += strlen(argv[i]) + 1;
+    }
+    char *request = malloc(length), *p = request;
+    p += strlen(strcpy(p, cwd)) + 1;
+    for (int i = first; i < argc; i++) {
+        p += strlen(strcpy(p, argv[i])) + 1;
+    }
+    if (length > FRAME_MAX_LENGTH || frameSend(fd, FRAME_REQUEST, request, (uint32_t)length) != 0) {
+        fprintf(stderr, "Erro: falha ao enviar o pedido ao servidor\n");
+        return EXIT_FAILURE;
+    }
+    free(request);
+
+    // Resposta: saída do comando e, por último, o código de saída
+    int status = EXIT_FAILURE;
+    for (;;) {
+        FrameType type;
+        char *payload;
+        uint32_t size;
+        if (frameReceive(fd, &type, &payload, &size) != 0) {
+            fprintf(stderr, "Erro: conexão com o servidor interrompida\n");
+            break;
+        }
+        if (type == FRAME_STDOUT || type == FRAME_STDERR) {
+            fwrite(payload, 1, size, type == FRAME_STDOUT ? stdout : stderr);
+        } else if (type == FRAME_EXIT && size == sizeof(int32_t)) {
+            int32_t code;
+            memcpy(&code, payload, sizeof(code));
+            status = code;
+            free(payload);
+            break;
+        }
+        free(payload);
+    }
+    close(fd);
+    return status;
+}
@@ -0,0 +1,289 @@
+/*
+ * Codificação dos arquivos de entrada
+ *
+ * Os analisadores trabalham com UTF-8 terminado em '\0'. Esta camada
+ * descobre a codificação de um arquivo recém-lido e o converte para UTF-8
+ * antes da análise léxica:
+ * - BOM UTF-8 (EF BB BF): removido
+ * - BOM UTF-16LE (FF FE) ou UTF-16BE (FE FF): convertido para UTF-8
+ * - Sem BOM: se muitos bytes da amostra inicial forem '\0', sempre na mesma
+ *   posição de cada par, o arquivo é UTF-16 (LE com os '\0' nas posições
+ *   ímpares, BE nas pares)
+ * - Caso contrário, o arquivo é validado como UTF-8; um arquivo que não é
+ *   UTF-8 válido é tratado como Latin-1 e convertido
+ *
+ * Caminho rápido: código fonte é quase todo ASCII, então a validação e a
+ * conversão avançam em blocos de 32 bytes (AVX2, ou dois registradores
+ * SSE2) enquanto nenhum byte tiver o bit alto ligado, e só decodificam
+ * caractere por caractere a partir do primeiro byte não ASCII. Na
+ * conversão de UTF-16, cada bloco de 8 unidades ASCII vira 8 bytes com um
+ * único empacotamento (packus).
+ *
+ * Limitações:
+ * - Um '\0' no meio do texto termina a análise, como em qualquer arquivo
+ * - Surrogates UTF-16 sem par viram U+FFFD
+ */
+
+#ifndef CODIFICACAO_DE_ENTRADA_H
+#define CODIFICACAO_DE_ENTRADA_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define ENCODING_SAMPLE_BYTES 4096
+
+// Codificações reconhecidas
+typedef enum {
+    ENCODING_UTF8,
+    ENCODING_UTF8_BOM,
+    ENCODING_UTF16LE_BOM,
+    ENCODING_UTF16BE_BOM,
+    ENCODING_UTF16LE,          // Sem BOM, pela densidade de '\0'
+    ENCODING_UTF16BE,
+    ENCODING_LATIN1            // Não era UTF-8 válido
+} SourceEncoding;
+
+// Função para converter SourceEncoding em texto
+const char *encodingName(SourceEncoding encoding) {
+    switch (encoding) {
+        case ENCODING_UTF8: return "UTF-8";
+        case ENCODING_UTF8_BOM: return "UTF-8 com BOM";
+        case ENCODING_UTF16LE_BOM: return "UTF-16LE com BOM";
+        case ENCODING_UTF16BE_BOM: return "UTF-16BE com BOM";
+        case ENCODING_UTF16LE: return "UTF-16LE sem BOM";
+        case ENCODING_UTF16BE: return "UTF-16BE sem BOM";
+        case ENCODING_LATIN1: return "Latin-1";
+        default: return "desconhecida";
+    }
+}
+
+// Função para medir o prefixo ASCII de 'bytes' (blocos de 32 bytes, depois byte a byte)
+size_t asciiPrefix(const unsigned char *bytes, size_t length) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= length; i += 32) {
+        if (_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)(bytes + i)))) {
+            break;
+        }
+    }
+#elif defined(__SSE2__)
+    for (; i + 32 <= length; i += 32) {
+        __m128i low = _mm_loadu_si128((const __m128i *)(bytes + i));
+        __m128i high = _mm_loadu_si128((const __m128i *)(bytes + i + 16));
+        if (_mm_movemask_epi8(_mm_or_si128(low, high))) {
+            break;
+        }
+    }
+#endif
+    while (i < length && bytes[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+// Função para decodificar um caractere UTF-8 não ASCII em 'bytes'; devolve o tamanho (0 se inválido)
+int utf8Decode(const unsigned char *bytes, size_t length, uint32_t *codepoint) {
+    unsigned char lead = bytes[0];
+    int size = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+    if (size == 0 || lead > 0xF4 || (size_t)size > length) {
+        return 0;
+    }
+    uint32_t value = lead & (0x7F >> size);
+    for (int k = 1; k < size; k++) {
+        if ((bytes[k] & 0xC0) != 0x80) {
+            return 0;
+        }
+        value = (value << 6) | (bytes[k] & 0x3F);
+    }
+    // Formas longas demais, surrogates e valores acima de U+10FFFF
+    static const uint32_t minimum[5] = {0, 0, 0x80, 0x800, 0x10000};
+    if (value < minimum[size] || (value >= 0xD800 && value <= 0xDFFF) || value > 0x10FFFF) {
+        return 0;
+    }
+    *codepoint = value;
+    return size;
+}
+
+// Função para validar UTF-8; devolve a posição do primeiro byte inválido ('length' se for válido)
+size_t utf8Validate(const unsigned char *bytes, size_t length) {
+    size_t i = 0;
+    while ((i += asciiPrefix(bytes + i, length - i)) < length) {
+        uint32_t codepoint;
+        int size = utf8Decode(bytes + i, length - i, &codepoint);
+        if (size == 0) {
+            return i;
+        }
+        i += size;
+    }
+    return length;
+}
+
+// Função para gravar um caractere em UTF-8; devolve o número de bytes
+static int utf8Encode(uint32_t codepoint, unsigned char *out) {
+    if (codepoint < 0x80) {
+        out[0] = (unsigned char)codepoint;
+        return 1;
+    }
+    if (codepoint < 0x800) {
+        out[0] = (unsigned char)(0xC0 | (codepoint >> 6));
+        out[1] = (unsigned char)(0x80 | (codepoint & 0x3F));
+        return 2;
+    }
+    if (codepoint < 0x10000) {
+        out[0] = (unsigned char)(0xE0 | (codepoint >> 12));
+        out[1] = (unsigned char)(0x80 | ((codepoint >> 6) & 0x3F));
+        out[2] = (unsigned char)(0x80 | (codepoint & 0x3F));
+        return 3;
+    }
+    out[0] = (unsigned char)(0xF0 | (codepoint >> 18));
+    out[1] = (unsigned char)(0x80 | ((codepoint >> 12) & 0x3F));
+    out[2] = (unsigned char)(0x80 | ((codepoint >> 6) & 0x3F));
+    out[3] = (unsigned char)(0x80 | (codepoint & 0x3F));
+    return 4;
+}
+
+// Função para descobrir a codificação pelo BOM ou pela densidade de '\0' na amostra inicial
+SourceEncoding detectEncoding(const unsigned char *bytes, size_t length) {
+    if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+        return ENCODING_UTF8_BOM;
+    }
+    if (length >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE) {
+        return ENCODING_UTF16LE_BOM;
+    }
+    if (length >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF) {
+        return ENCODING_UTF16BE_BOM;
+    }
+
+    // Em UTF-16 o texto ASCII tem um '\0' em cada par, sempre do mesmo lado
+    size_t sample = length < ENCODING_SAMPLE_BYTES ? length & ~(size_t)1 : ENCODING_SAMPLE_BYTES;
+    size_t evenZeros = 0, oddZeros = 0;
+    for (size_t i = 0; i < sample; i += 2) {
+        evenZeros += bytes[i] == 0;
+        oddZeros += bytes[i + 1] == 0;
+    }
+    if (sample >= 2 && oddZeros * 4 >= sample && evenZeros * 8 <= oddZeros) {
+        return ENCODING_UTF16LE;
+    }
+    if (sample >= 2 && evenZeros * 4 >= sample && oddZeros * 8 <= evenZeros) {
+        return ENCODING_UTF16BE;
+    }
+    return ENCODING_UTF8;
+}
+
+// Função para converter UTF-16 para UTF-8 (blocos de 8 unidades ASCII de uma vez); devolve o texto terminado em '\0'
+char *utf16ToUtf8(const unsigned char *bytes, size_t length, int bigEndian, long *size) {
+    size_t units = length / 2;
+    unsigned char *out = malloc(units * 3 + 4);   // Até 3 bytes por unidade (um par vira 4 bytes)
+    if (!out) {
+        return NULL;
+    }
+    size_t i = 0, o = 0;
+    while (i < units) {
+#ifdef __SSE2__
+        const __m128i highMask = _mm_set1_epi16((short)0xFF80);
+        while (i + 8 <= units) {
+            __m128i block = _mm_loadu_si128((const __m128i *)(bytes + i * 2));
+            if (bigEndian) {
+                block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+            }
+            __m128i high = _mm_cmpeq_epi16(_mm_and_si128(block, highMask), _mm_setzero_si128());
+            if (_mm_movemask_epi8(high) != 0xFFFF) {
+                break;
+            }
+            _mm_storel_epi64((__m128i *)(out + o), _mm_packus_epi16(block, block));
+            i += 8;
+            o += 8;
+        }
+        // Decodifica o bloco com caracteres não ASCII unidade por unidade
+        size_t blockEnd = i + 8 < units ? i + 8 : units;
+#else
+        size_t blockEnd = units;
+#endif
+        while (i < blockEnd) {
+            const unsigned char *p = bytes + i * 2;
+            uint32_t unit = bigEndian ? (uint32_t)(p[0] << 8 | p[1]) : (uint32_t)(p[1] << 8 | p[0]);
+            i++;
+            if (unit >= 0xD800 && unit <= 0xDBFF && i < units) {
+                const unsigned char *q = bytes + i * 2;
+                uint32_t low = bigEndian ? (uint32_t)(q[0] << 8 | q[1]) : (uint32_t)(q[1] << 8 | q[0]);
+                if (low >= 0xDC00 && low <= 0xDFFF) {
+                    unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                    i++;
+                }
+            }
+            if (unit >= 0xD800 && unit <= 0xDFFF) {
+                unit = 0xFFFD;   // Surrogate sem par
+            }
+            o += utf8Encode(unit, out + o);
+        }
+    }
+    out[o] = '\0';
+    *size = (long)o;
+    return (char *)out;
+}
+
+// Função para converter Latin-1 para UTF-8 (os trechos ASCII são copiados em bloco)
+static char *latin1ToUtf8(const unsigned char *bytes, size_t length, long *size) {
+    unsigned char *out = malloc(length * 2 + 1);
+    if (!out) {
+        return NULL;
+    }
+    size_t o = 0;
+    for (size_t i = 0; i < length;) {
+        size_t ascii = asciiPrefix(bytes + i, length - i);
+        memcpy(out + o, bytes + i, ascii);
+        i += ascii;
+        o += ascii;
+        if (i < length) {
+            o += utf8Encode(bytes[i++], out + o);
+        }
+    }
+    out[o] = '\0';
+    *size = (long)o;
+    return (char *)out;
+}
+
+// Função para converter o texto lido para UTF-8; 'code' e 'size' são substituídos se preciso (NULL se faltar memória)
+SourceEncoding decodeSource(char **code, long *size) {
+    const unsigned char *bytes = (const unsigned char *)*code;
+    size_t length = (size_t)*size;
+    SourceEncoding encoding = detectEncoding(bytes, length);
+    char *converted = NULL;
+    long convertedSize = 0;
+
+    switch (encoding) {
+        case ENCODING_UTF8_BOM:
+            memmove(*code, *code + 3, length - 2);   // Inclui o '\0'
+            *size -= 3;
+            return encoding;
+        case ENCODING_UTF16LE_BOM:
+        case ENCODING_UTF16BE_BOM:
+            converted = utf16ToUtf8(bytes + 2, length - 2, encoding == ENCODING_UTF16BE_BOM, &convertedSize);
+            break;
+        case ENCODING_UTF16LE:
+        case ENCODING_UTF16BE:
+            converted = utf16ToUtf8(bytes, length, encoding == ENCODING_UTF16BE, &convertedSize);
+            break;
+        default: {
+            if (utf8Validate(bytes, length) == length) {
+                return ENCODING_UTF8;
+            }
+            encoding = ENCODING_LATIN1;
+            converted = latin1ToUtf8(bytes, length, &convertedSize);
+            break;
+        }
+    }
+    free(*code);
+    *code = converted;
+    *size = convertedSize;
+    return encoding;
+}
+
+#endif
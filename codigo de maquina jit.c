@@ -0,0 +1,172 @@
+/*
+ * Programa do JIT
+ *
+ * Lê o arquivo de entrada, executa as análises, gera o código de máquina
+ * (codigo de maquina.h), carrega-o em páginas executáveis
+ * (codigo de maquina jit.h) e executa o Main imediatamente, sem montador,
+ * ligador nem processo filho. O código de saída é o do Main.
+ *
+ * Opções:
+ * - --sem-otimizacao: gera o código sem os passos de otimização (menor
+ *   latência, código pior)
+ * - --tempos: exibe, ao final, o tempo de cada fase e o tempo até a
+ *   primeira instrução do programa (da leitura do fonte até a chamada)
+ */
+
+#include "codigo de maquina jit.h"
+
+// Fases medidas até a primeira instrução
+enum {
+    PHASE_READ,
+    PHASE_LEXICAL,
+    PHASE_SYNTAX,
+    PHASE_SEMANTIC,
+    PHASE_IR,
+    PHASE_OPTIMIZE,
+    PHASE_GENERATE,
+    PHASE_LOAD,
+    PHASE_COUNT
+};
+
+static const char *phaseNames[PHASE_COUNT] = {
+    "leitura", "análise léxica", "análise sintática", "análise semântica", "código intermediário",
+    "otimização", "código de máquina", "carga na memória"
+};
+
+// Estrutura das medições (exibidas na saída do programa, mesmo se ele falhar)
+static struct {
+    double phases[PHASE_COUNT];
+    double firstInstruction;
+    struct timespec started;   // Início da execução do programa
+    uint32_t codeBytes;
+    uint32_t functions;
+} timings;
+
+// Função para medir o tempo em milissegundos desde 'start' e reiniciar a contagem
+double lapMs(struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double ms = (now.tv_sec - start->tv_sec) * 1e3 + (now.tv_nsec - start->tv_nsec) / 1e6;
+    *start = now;
+    return ms;
+}
+
+// Função para exibir uma linha das medições (alinhada pelo número de caracteres UTF-8, não de bytes)
+void printTiming(const char *name, double ms) {
+    int width = 0;
+    for (const char *c = name; *c; c++) {
+        width += ((unsigned char)*c & 0xC0) != 0x80;
+    }
+    fprintf(stderr, "  %s%*s %9.3f ms\n", name, width < 22 ? 22 - width : 0, "", ms);
+}
+
+// Função para exibir as medições (registrada com atexit: rtFail encerra o processo)
+void printTimings(void) {
+    double runMs = lapMs(&timings.started);
+    fflush(stdout);
+    fprintf(stderr, "\nTempos (%u função(ões), %u bytes de código):\n", timings.functions, timings.codeBytes);
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        printTiming(phaseNames[p], timings.phases[p]);
+    }
+    printTiming("até a 1ª instrução", timings.firstInstruction);
+    printTiming("execução", runMs);
+}
+
+// Função principal
+int main(int argc, char *argv[]) {
+    const char *path = "../input.txt";
+    int optimize = 1, showTimings = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--sem-otimizacao") == 0) {
+            optimize = 0;
+        } else if (strcmp(argv[i], "--tempos") == 0) {
+            showTimings = 1;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    struct timespec start, lap;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    lap = start;
+
+    // Ler todo o conteúdo do arquivo fonte
+    char *code = readSourceFile(path, NULL);
+    if (!code) {
+        return EXIT_FAILURE;
+    }
+    timings.phases[PHASE_READ] = lapMs(&lap);
+
+    lexicalAnalysis(code);
+    timings.phases[PHASE_LEXICAL] = lapMs(&lap);
+
+    Ast ast;
+    Parser parser;
+    astInit(&ast, code, tokenCount);
+    parserInit(&parser, &ast, tokens, tokenCount);
+    parseProgram(&parser);
+    timings.phases[PHASE_SYNTAX] = lapMs(&lap);
+
+    Checker checker;
+    IrModule module;
+    int status = EXIT_FAILURE, generated = 0;
+    if (parser.errorCount) {
+        printf("\n%d erro(s) sintático(s); programa não executado.\n", parser.errorCount);
+    } else if (semanticAnalysis(&checker, &ast, NULL)) {
+        printf("\n%d erro(s) semântico(s); programa não executado.\n", checker.errorCount);
+    } else {
+        timings.phases[PHASE_SEMANTIC] = lapMs(&lap);
+        IrGenerator generator;
+        int errors = generateIr(&generator, &module, &ast);
+        timings.phases[PHASE_IR] = lapMs(&lap);
+        if (errors) {
+            printf("\n%d erro(s) na geração de código; programa não executado.\n", errors);
+            irModuleFree(&module);
+        } else if (module.entry < 0) {
+            fprintf(stderr, "Erro: o programa não tem um método Main\n");
+            irModuleFree(&module);
+        } else {
+            generated = 1;
+        }
+    }
+
+    X86Asm as;
+    memset(&as, 0, sizeof(as));
+    JitProgram jit;
+    memset(&jit, 0, sizeof(jit));
+    if (generated) {
+        if (optimize) {
+            OptStats stats;
+            optimizeModule(&module, &stats, 0);
+        }
+        timings.phases[PHASE_OPTIMIZE] = lapMs(&lap);
+
+        X86Stats stats;
+        int errors = x86Generate(&as, &module, &stats);
+        timings.phases[PHASE_GENERATE] = lapMs(&lap);
+        timings.functions = stats.functions;
+        timings.codeBytes = as.size;
+
+        if (errors) {
+            printf("\n%d erro(s) na geração de código de máquina; programa não executado.\n", errors);
+        } else if (jitLoad(&jit, &as) == 0) {
+            timings.phases[PHASE_LOAD] = lapMs(&lap);
+            timings.firstInstruction = lapMs(&start);
+            timings.started = start;
+            if (showTimings) {
+                atexit(printTimings);
+            }
+            status = jitRun(&jit, stdout) & 0xFF;
+        }
+        irModuleFree(&module);
+    }
+
+    jitFree(&jit);
+    x86Free(&as);
+    astFree(&ast);
+    freeTokens();
+    freeLineIndex();
+    free(code);
+    return status;
+}
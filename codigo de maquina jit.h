@@ -0,0 +1,137 @@
+/*
+ * JIT do código de máquina
+ *
+ * Carrega o código gerado por codigo de maquina.h na memória do próprio
+ * processo e o executa, sem montador nem ligador. As relocações que o
+ * objeto ELF deixaria para o ligador são resolvidas aqui:
+ * - RELOC_DATA: deslocamento de 32 bits até o dado em .rodata ou .bss,
+ *   que ficam nas páginas logo depois do código
+ * - RELOC_CALL: chamada a uma função do runtime (tempo de execucao.h) ou
+ *   da libm, feita por um trampolim 'jmp [rip]' com o endereço absoluto,
+ *   já que a biblioteca pode estar a mais de 2 GB do código
+ *
+ * Disposição (uma única região mapeada, em páginas separadas):
+ *   código + trampolins | .rodata | .bss
+ *
+ * As páginas nunca são graváveis e executáveis ao mesmo tempo (W^X): a
+ * região nasce como leitura e escrita, recebe o código e os dados e só
+ * então o código passa a leitura e execução e .rodata a somente leitura.
+ */
+
+#ifndef CODIGO_DE_MAQUINA_JIT_H
+#define CODIGO_DE_MAQUINA_JIT_H
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "tempo de execucao.h"
+
+#define JIT_TRAMPOLINE_SIZE 16
+
+// Estrutura de um programa carregado na memória
+typedef struct {
+    uint8_t *memory;           // Região mapeada
+    size_t size;
+    size_t codePages;          // Bytes das páginas de código (leitura e execução)
+    size_t rodataPages;        // Bytes das páginas de .rodata (somente leitura)
+    int32_t (*entry)(void);    // programa_executar
+} JitProgram;
+
+// Endereços das funções externas, na ordem de X86Runtime
+static void *const jitRuntime[RT_COUNT] = {
+    (void *)rtPrintf, (void *)rtWrite, (void *)rtToString, (void *)rtConcat, (void *)rtStringEquals,
+    (void *)rtNewArray, (void *)rtFail, (void *)pow, (void *)fmod, (void *)fmax, (void *)fmin
+};
+
+// Função para arredondar um tamanho para páginas inteiras
+size_t jitPages(size_t size, size_t page) {
+    return (size + page - 1) / page * page;
+}
+
+// Função para liberar um programa carregado
+void jitFree(JitProgram *jit) {
+    if (jit->memory) {
+        munmap(jit->memory, jit->size);
+    }
+    memset(jit, 0, sizeof(*jit));
+}
+
+// Função para carregar o código do montador na memória; devolve 0 em caso de sucesso
+int jitLoad(JitProgram *jit, const X86Asm *as) {
+    memset(jit, 0, sizeof(*jit));
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t trampolines = (as->size + JIT_TRAMPOLINE_SIZE - 1) / JIT_TRAMPOLINE_SIZE * JIT_TRAMPOLINE_SIZE;
+    jit->codePages = jitPages(trampolines + RT_COUNT * JIT_TRAMPOLINE_SIZE, page);
+    jit->rodataPages = jitPages(as->rodataSize, page);
+    jit->size = jit->codePages + jit->rodataPages + jitPages(as->bssSize, page);
+
+    void *memory = mmap(NULL, jit->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        fprintf(stderr, "Erro: não foi possível reservar memória para o código (%s)\n", strerror(errno));
+        jit->size = 0;
+        return -1;
+    }
+    jit->memory = memory;
+    uint8_t *code = jit->memory;
+    uint8_t *rodata = code + jit->codePages;
+    uint8_t *bss = rodata + jit->rodataPages;   // Já zerada pelo mmap
+
+    memcpy(code, as->code, as->size);
+    memset(code + as->size, 0xCC, jit->codePages - as->size);
+    if (as->rodataSize) {
+        memcpy(rodata, as->rodata, as->rodataSize);
+    }
+
+    // Trampolins: jmp qword ptr [rip + 2], int3 int3, endereço de 64 bits
+    for (int r = 0; r < RT_COUNT; r++) {
+        uint8_t *stub = code + trampolines + (size_t)r * JIT_TRAMPOLINE_SIZE;
+        static const uint8_t jump[8] = {0xFF, 0x25, 0x02, 0x00, 0x00, 0x00, 0xCC, 0xCC};
+        memcpy(stub, jump, sizeof(jump));
+        memcpy(stub + 8, &jitRuntime[r], 8);
+    }
+
+    // Relocações: o campo recebe destino + adendo - posição do campo
+    for (uint32_t i = 0; i < as->relocCount; i++) {
+        const X86Reloc *reloc = &as->relocs[i];
+        const uint8_t *target;
+        int64_t addend = reloc->addend;
+        if (reloc->kind == RELOC_CALL) {
+            target = code + trampolines + (size_t)reloc->target * JIT_TRAMPOLINE_SIZE;
+        } else {
+            const X86Data *data = &as->data[reloc->target];
+            target = data->section == SECTION_BSS ? bss : rodata;
+            addend += data->offset;
+        }
+        int64_t value = (int64_t)(target - (code + reloc->at)) + addend;
+        int32_t field = (int32_t)value;
+        memcpy(code + reloc->at, &field, 4);
+    }
+
+    // Ponto de entrada: o símbolo global programa_executar
+    for (uint32_t i = 0; i < as->symbolCount; i++) {
+        if (as->symbols[i].global && strcmp(as->symbols[i].name, X86_ENTRY_SYMBOL) == 0) {
+            jit->entry = (int32_t (*)(void))(void *)(code + as->labels[as->symbols[i].label]);
+        }
+    }
+
+    // W^X: o código deixa de ser gravável antes de poder ser executado
+    __builtin___clear_cache((char *)code, (char *)code + jit->codePages);
+    if (!jit->entry || mprotect(code, jit->codePages, PROT_READ | PROT_EXEC) != 0 ||
+        (jit->rodataPages && mprotect(rodata, jit->rodataPages, PROT_READ) != 0)) {
+        fprintf(stderr, "Erro: não foi possível tornar o código executável (%s)\n",
+                jit->entry ? strerror(errno) : "sem ponto de entrada");
+        jitFree(jit);
+        return -1;
+    }
+    return 0;
+}
+
+// Função para executar o programa carregado com a saída em 'output'; devolve o código de saída do Main
+int32_t jitRun(const JitProgram *jit, FILE *output) {
+    rtStart(output);
+    int32_t status = jit->entry();
+    rtFinish();
+    return status;
+}
+
+#endif
@@ -0,0 +1,359 @@
+/*
+ * Programa do gerador de código de máquina
+ *
+ * Lê o arquivo de entrada, executa as análises, gera e otimiza o código
+ * intermediário e o traduz para x86-64 (codigo de maquina.h). O resultado
+ * é gravado como objeto ELF relocável e ligado pelo compilador C do
+ * sistema com o runtime (tempo de execucao.c), produzindo um executável.
+ *
+ * Opções:
+ * - --saida <nome>: nome do executável (padrão: programa); o objeto fica em <nome>.o
+ * - --montador: grava também o código em texto do GNU as (<nome>.s)
+ * - --sem-otimizacao: gera o código sem os passos de otimização
+ * - --comparar: executa o programa compilado e a máquina virtual e compara
+ *   a saída e o código de saída dos dois
+ * - --runtime <arquivo>: fonte do runtime (padrão: tempo de execucao.c ao
+ *   lado deste arquivo), compilado uma vez para um objeto em $TMPDIR (ou
+ *   /tmp) cujo nome depende do caminho do fonte
+ * - --threads <n>: compila as funções em paralelo com n threads (padrão:
+ *   número de processadores; compilacao paralela.h). O objeto é o mesmo
+ *   com qualquer n. Com --montador a geração é feita em série
+ *
+ * O compilador C e o programa gerado são executados com posix_spawn e a
+ * lista de argumentos, sem passar por um shell: nenhum caminho precisa de
+ * aspas.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "compilacao paralela.h"
+
+#define RUNTIME_SOURCE "tempo de execucao.c"
+
+extern char **environ;
+
+// Função para obter o caminho padrão do runtime: o diretório deste fonte
+void defaultRuntime(char *path, size_t size) {
+    const char *slash = strrchr(__FILE__, '/');
+    if (slash) {
+        snprintf(path, size, "%.*s/%s", (int)(slash - __FILE__), __FILE__, RUNTIME_SOURCE);
+    } else {
+        snprintf(path, size, "%s", RUNTIME_SOURCE);
+    }
+}
+
+// Função para medir o tempo em milissegundos
+double elapsedMs(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e3 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Função para gerar o código intermediário otimizado e o código de máquina; devolve 0 em caso de sucesso.
+// Sem texto do montador, cada função é compilada como uma tarefa independente em 'threads' threads
+int buildModule(const char *code, int optimize, uint32_t threads, IrModule *module, X86Asm *as, ParallelStats *stats) {
+    int status = -1;
+    lexicalAnalysis(code);
+
+    Ast ast;
+    Parser parser;
+    astInit(&ast, code, tokenCount);
+    parserInit(&parser, &ast, tokens, tokenCount);
+    parseProgram(&parser);
+
+    Checker checker;
+    if (parser.errorCount) {
+        printf("\n%d erro(s) sintático(s); código não gerado.\n", parser.errorCount);
+    } else if (semanticAnalysis(&checker, &ast, NULL)) {
+        printf("\n%d erro(s) semântico(s); código não gerado.\n", checker.errorCount);
+    } else if (!as->text) {
+        int errors = parallelCompile(as, module, &ast, optimize, threads, stats);
+        if (errors) {
+            printf("\n%d erro(s) na geração de código; código não gerado.\n", errors);
+        } else {
+            status = 0;
+        }
+    } else {
+        IrGenerator generator;
+        int errors = generateIr(&generator, module, &ast);
+        if (errors) {
+            printf("\n%d erro(s) na geração de código; código não gerado.\n", errors);
+            irModuleFree(module);
+        } else {
+            memset(stats, 0, sizeof(*stats));
+            stats->threads = 1;
+            if (optimize) {
+                optimizeModule(module, &stats->opt, 0);
+            }
+            errors = x86Generate(as, module, &stats->x86);
+            if (errors) {
+                printf("\n%d erro(s) na geração de código de máquina; programa não gerado.\n", errors);
+                irModuleFree(module);
+            } else {
+                status = 0;
+            }
+        }
+    }
+    astFree(&ast);
+    freeTokens();
+    freeLineIndex();
+    return status;
+}
+
+// Função para executar um programa (procurado no PATH) e esperar o seu fim; devolve o código de saída ou -1
+int runCommand(char *const argv[]) {
+    pid_t child;
+    int result;
+    if (posix_spawnp(&child, argv[0], NULL, NULL, argv, environ) != 0) {
+        fprintf(stderr, "Erro: não foi possível executar %s\n", argv[0]);
+        return -1;
+    }
+    while (waitpid(child, &result, 0) < 0) {
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+    return WIFEXITED(result) ? WEXITSTATUS(result) : -1;
+}
+
+// Função para obter o objeto do runtime: $TMPDIR (ou /tmp), com o hash do caminho do fonte no nome
+void runtimeObject(const char *source, char *path, size_t size) {
+    char resolved[PATH_MAX];
+    const char *key = realpath(source, resolved) ? resolved : source;
+    uint32_t hash = 2166136261u;   // FNV-1a
+    for (const char *p = key; *p; p++) {
+        hash = (hash ^ (unsigned char)*p) * 16777619u;
+    }
+    const char *directory = getenv("TMPDIR");
+    if (!directory || !*directory) {
+        directory = "/tmp";
+    }
+    snprintf(path, size, "%s/tempo de execucao-%08x.o", directory, hash);
+}
+
+// Função para compilar o runtime uma vez (refeito só se o fonte for mais novo); devolve 0 em caso de sucesso
+int buildRuntime(const char *source, const char *object) {
+    struct stat sourceInfo, objectInfo;
+    if (stat(source, &sourceInfo) != 0) {
+        fprintf(stderr, "Erro: runtime não encontrado (%s)\n", source);
+        return -1;
+    }
+    if (stat(object, &objectInfo) == 0 && objectInfo.st_mtime >= sourceInfo.st_mtime) {
+        return 0;
+    }
+
+    // Compila para um nome próprio do processo e renomeia: outra compilação ao mesmo tempo não vê um objeto pela metade
+    char partial[PATH_MAX + 32];
+    snprintf(partial, sizeof(partial), "%s.%ld", object, (long)getpid());
+    char *argv[] = {"cc", "-O2", "-c", "-o", partial, (char *)source, NULL};
+    if (runCommand(argv) != 0 || rename(partial, object) != 0) {
+        unlink(partial);
+        return -1;
+    }
+    return 0;
+}
+
+// Função para ler toda a saída de um arquivo aberto; devolve o texto (terminado em nulo)
+char *readAll(FILE *file, size_t *length) {
+    size_t capacity = 4096, size = 0, n;
+    char *text = malloc(capacity);
+    while (text && (n = fread(text + size, 1, capacity - size - 1, file)) > 0) {
+        size += n;
+        if (capacity - size - 1 == 0) {
+            capacity *= 2;
+            text = realloc(text, capacity);
+        }
+    }
+    if (text) {
+        text[size] = '\0';
+    }
+    *length = size;
+    return text;
+}
+
+// Função para executar o módulo na máquina virtual, capturando a saída
+char *runOnVm(const IrModule *module, size_t *length, int *status) {
+    VmProgram program;
+    if (vmCompile(&program, module) != 0) {
+        vmProgramFree(&program);
+        return NULL;
+    }
+    static Vm vm;
+    FILE *output = tmpfile();
+    if (!output) {
+        vmProgramFree(&program);
+        return NULL;
+    }
+    vmInit(&vm, &program, output);
+    int failed = vmRun(&vm) != 0;
+    *status = failed ? EXIT_FAILURE : 0;
+    if (!failed && program.entry >= 0 && program.functions[program.entry].returnType == IR_INT) {
+        *status = vm.result.i & 0xFF;
+    }
+    vmFree(&vm);
+    vmProgramFree(&program);
+    rewind(output);
+    char *text = readAll(output, length);
+    fclose(output);
+    return text;
+}
+
+// Função para executar o programa compilado, capturando a saída (a saída de erro é descartada)
+char *runExecutable(const char *executable, size_t *length, int *status) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s%s", strchr(executable, '/') ? "" : "./", executable);
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return NULL;
+    }
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fds[0]);
+    posix_spawn_file_actions_addclose(&actions, fds[1]);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+    char *argv[] = {path, NULL};
+    pid_t child;
+    int spawned = posix_spawn(&child, path, &actions, NULL, argv, environ) == 0;
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+    if (!spawned) {
+        close(fds[0]);
+        return NULL;
+    }
+
+    FILE *output = fdopen(fds[0], "r");
+    char *text = output ? readAll(output, length) : NULL;
+    if (output) {
+        fclose(output);
+    } else {
+        close(fds[0]);
+    }
+    int result = 0;
+    pid_t waited;
+    do {
+        waited = waitpid(child, &result, 0);
+    } while (waited < 0 && errno == EINTR);
+    *status = waited == child && WIFEXITED(result) ? WEXITSTATUS(result) : -1;
+    return text;
+}
+
+// Função principal
+int main(int argc, char *argv[]) {
+    const char *path = "../input.txt";
+    const char *executable = "programa";
+    char runtime[512];
+    int optimize = 1, writeAssembly = 0, compare = 0;
+    uint32_t threads = 0;
+    defaultRuntime(runtime, sizeof(runtime));
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--saida") == 0 && i + 1 < argc) {
+            executable = argv[++i];
+        } else if (strcmp(argv[i], "--montador") == 0) {
+            writeAssembly = 1;
+        } else if (strcmp(argv[i], "--sem-otimizacao") == 0) {
+            optimize = 0;
+        } else if (strcmp(argv[i], "--comparar") == 0) {
+            compare = 1;
+        } else if (strcmp(argv[i], "--runtime") == 0 && i + 1 < argc) {
+            snprintf(runtime, sizeof(runtime), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = (uint32_t)atoi(argv[++i]);
+        } else {
+            path = argv[i];
+        }
+    }
+
+    // Ler todo o conteúdo do arquivo fonte
+    char *code = readSourceFile(path, NULL);
+    if (!code) {
+        return EXIT_FAILURE;
+    }
+
+    char objectPath[512], assemblyPath[512];
+    snprintf(objectPath, sizeof(objectPath), "%s.o", executable);
+    snprintf(assemblyPath, sizeof(assemblyPath), "%s.s", executable);
+
+    X86Asm as;
+    memset(&as, 0, sizeof(as));
+    if (writeAssembly && !(as.text = fopen(assemblyPath, "w"))) {
+        fprintf(stderr, "Erro: Não foi possível criar o arquivo %s\n", assemblyPath);
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    IrModule module;
+    ParallelStats stats;
+    int built = buildModule(code, optimize, threads, &module, &as, &stats);
+    double buildMs = elapsedMs(&start);
+    if (as.text) {
+        if (built == 0) {
+            x86PrintData(&as);
+        }
+        fclose(as.text);
+        as.text = NULL;
+    }
+    if (built != 0) {
+        x86Free(&as);
+        free(code);
+        return EXIT_FAILURE;
+    }
+    if (module.entry < 0) {
+        fprintf(stderr, "Erro: o programa não tem um método Main\n");
+        x86Free(&as);
+        irModuleFree(&module);
+        free(code);
+        return EXIT_FAILURE;
+    }
+
+    int status = EXIT_FAILURE;
+    if (x86WriteElf(&as, objectPath) == 0) {
+        printf("Código de máquina: %u função(ões), %u bytes de código, %u bytes de dados, %u relocações\n",
+               stats.x86.functions, as.size, as.rodataSize, as.relocCount);
+        printf("Registradores: %u intervalos, %u na pilha\n", stats.x86.intervals, stats.x86.spilled);
+        printf("Tempo: compilação %.3f ms (%u thread(s))\n", buildMs, stats.threads);
+
+        // Ligação com o runtime pelo compilador do sistema
+        char runtimePath[PATH_MAX];
+        runtimeObject(runtime, runtimePath, sizeof(runtimePath));
+        char *link[] = {"cc", "-o", (char *)executable, objectPath, runtimePath, "-lm", NULL};
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (buildRuntime(runtime, runtimePath) != 0 || runCommand(link) != 0) {
+            fprintf(stderr, "Erro: a ligação falhou (%s)\n", executable);
+        } else {
+            printf("Executável: %s (ligação %.3f ms)\n", executable, elapsedMs(&start));
+            status = EXIT_SUCCESS;
+        }
+    }
+
+    if (status == EXIT_SUCCESS && compare) {
+        size_t nativeLength = 0, vmLength = 0;
+        int nativeStatus = 0, vmStatus = 0;
+        char *native = runExecutable(executable, &nativeLength, &nativeStatus);
+        char *interpreted = runOnVm(&module, &vmLength, &vmStatus);
+        if (!native || !interpreted) {
+            fprintf(stderr, "Erro: não foi possível executar o programa para a comparação\n");
+            status = EXIT_FAILURE;
+        } else if (nativeLength != vmLength || memcmp(native, interpreted, vmLength) != 0 ||
+                   nativeStatus != vmStatus) {
+            printf("Comparação: DIFERENTE da máquina virtual (%zu x %zu bytes, código de saída %d x %d)\n",
+                   nativeLength, vmLength, nativeStatus, vmStatus);
+            status = EXIT_FAILURE;
+        } else {
+            printf("Comparação: saída idêntica à da máquina virtual (%zu bytes, código de saída %d)\n",
+                   nativeLength, nativeStatus);
+        }
+        free(native);
+        free(interpreted);
+    }
+
+    x86Free(&as);
+    irModuleFree(&module);
+    free(code);
+    return status;
+}
@@ -0,0 +1,2045 @@
+/*
+ * Gerador de código de máquina x86-64
+ *
+ * Traduz o código intermediário otimizado (fora da forma SSA) para código
+ * x86-64. O resultado pode ser um objeto ELF relocável, gravado
+ * diretamente sem montador, ou texto do GNU as (sintaxe Intel). Os dois
+ * vêm da mesma passada: cada instrução é codificada em bytes e, se
+ * houver um arquivo de texto, também é escrita como assembly.
+ *
+ * Estruturas principais:
+ * - X86Asm: Montador em memória. Guarda o código, os dados somente
+ *   leitura (strings no formato VmString, constantes double, tipos dos
+ *   argumentos de printf), o tamanho das variáveis globais (.bss), os
+ *   rótulos e as relocações. O JIT (codigo de maquina jit.h) usa as mesmas
+ *   relocações para ligar o código na memória
+ * - X86Interval: Intervalo de vida de um registrador virtual para a
+ *   alocação por varredura linear (Poletto e Sarkar)
+ * - X86Generator: Estado da geração de uma função
+ *
+ * Alocação de registradores:
+ * - Os intervalos vão da primeira à última ocorrência na ordem linear do
+ *   código e são estendidos até o fim de cada laço (desvio para trás) que
+ *   atravessam
+ * - Inteiros e referências usam r10 e r11 (só se o intervalo não
+ *   atravessa uma chamada) e rbx, r12-r15 (preservados pelas chamadas);
+ *   double usa xmm8-xmm15 quando não atravessa chamadas
+ * - Sem registrador livre, vai para a pilha o intervalo que termina mais
+ *   tarde. rax, rcx, rdx, rsi, rdi, r8, r9, xmm0 e xmm1 ficam livres para
+ *   as sequências de instruções e para os argumentos do runtime
+ *
+ * Convenção de chamada entre as funções geradas: o chamador grava os
+ * argumentos em [rsp + 8k] e a função os lê em [rbp + 16 + 8k]; o
+ * resultado volta em eax, rax ou xmm0. As funções do runtime
+ * (tempo de execucao.h) e da libm seguem a ABI System V.
+ *
+ * O programa gerado exporta 'programa_executar', que executa a
+ * inicialização dos campos e o Main e devolve o código de saída.
+ */
+
+#ifndef CODIGO_DE_MAQUINA_H
+#define CODIGO_DE_MAQUINA_H
+
+#include <elf.h>
+#include "maquina virtual.h"
+
+#define X86_NOREG 0xFF
+#define X86_ENTRY_SYMBOL "programa_executar"
+
+// Registradores
+enum {
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15
+};
+
+// Códigos de condição
+typedef enum {
+    CC_O, CC_NO, CC_B, CC_AE, CC_E, CC_NE, CC_BE, CC_A, CC_S, CC_NS, CC_P, CC_NP, CC_L, CC_GE, CC_LE, CC_G
+} X86Condition;
+
+static const char *x86ConditionNames[16] = {
+    "o", "no", "b", "ae", "e", "ne", "be", "a", "s", "ns", "p", "np", "l", "ge", "le", "g"
+};
+
+static const char *x86RegisterNames[3][16] = {
+    {"al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil", "r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b"},
+    {"eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi", "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d"},
+    {"rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15"},
+};
+
+// Tipos de operando
+typedef enum {
+    X86_REG,
+    X86_XMM,
+    X86_MEM,
+    X86_RIP,     // Dado do programa relativo ao rip
+    X86_IMM
+} X86OperandKind;
+
+// Estrutura de um operando
+typedef struct {
+    uint8_t kind;
+    uint8_t size;    // 1, 4 ou 8 bytes (0 em lea)
+    uint8_t reg;     // X86_REG, X86_XMM; base em X86_MEM
+    uint8_t index;   // X86_MEM: registrador de índice (X86_NOREG se não houver)
+    uint8_t scale;
+    int32_t disp;    // X86_MEM: deslocamento; X86_RIP: dado
+    int64_t imm;     // X86_IMM: valor; X86_RIP: deslocamento dentro do dado
+} X86Operand;
+
+// Seções de dados
+typedef enum {
+    SECTION_RODATA,
+    SECTION_BSS
+} X86Section;
+
+// Tipos de dado (para o texto do montador)
+typedef enum {
+    DATA_STRING,     // VmString: cabeçalho, comprimento e texto
+    DATA_DOUBLE,
+    DATA_BYTES,
+    DATA_GLOBALS     // Variáveis globais (.bss)
+} X86DataKind;
+
+// Estrutura de um dado do programa
+typedef struct {
+    uint8_t section;
+    uint8_t kind;
+    uint16_t align;
+    uint32_t offset;
+    uint32_t size;
+} X86Data;
+
+// Tipos de relocação
+typedef enum {
+    RELOC_DATA,      // rel32 para um dado (R_X86_64_PC32)
+    RELOC_CALL       // rel32 para uma função externa (R_X86_64_PLT32)
+} X86RelocKind;
+
+// Estrutura de uma relocação
+typedef struct {
+    uint32_t at;       // Posição do campo de 32 bits no código
+    uint8_t kind;
+    uint32_t target;   // Dado ou função externa
+    int32_t addend;
+} X86Reloc;
+
+// Estrutura de uma referência a um rótulo ainda não resolvido
+typedef struct {
+    uint32_t at;
+    uint32_t label;
+} X86Fixup;
+
+// Estrutura de um símbolo de função
+typedef struct {
+    char name[64];
+    uint32_t label;
+    int global;
+} X86Symbol;
+
+// Estrutura do montador
+typedef struct {
+    uint8_t *code;
+    uint32_t size;
+    uint32_t capacity;
+    uint8_t *rodata;
+    uint32_t rodataSize;
+    uint32_t rodataCapacity;
+    uint32_t bssSize;
+    X86Data *data;
+    uint32_t dataCount;
+    uint32_t dataCapacity;
+    uint32_t *labels;          // Posição de cada rótulo (OPT_NONE até ser definido)
+    uint32_t labelCount;
+    uint32_t labelCapacity;
+    X86Fixup *fixups;
+    uint32_t fixupCount;
+    uint32_t fixupCapacity;
+    X86Reloc *relocs;
+    uint32_t relocCount;
+    uint32_t relocCapacity;
+    X86Symbol *symbols;
+    uint32_t symbolCount;
+    uint32_t symbolCapacity;
+    FILE *text;                // Texto do montador (NULL = só bytes)
+} X86Asm;
+
+// Funções do runtime chamadas pelo código gerado
+typedef enum {
+    RT_PRINTF,
+    RT_WRITE,
+    RT_TOSTRING,
+    RT_CONCAT,
+    RT_STRING_EQUALS,
+    RT_NEW_ARRAY,
+    RT_FAIL,
+    RT_POW,
+    RT_FMOD,
+    RT_FMAX,
+    RT_FMIN,
+    RT_COUNT
+} X86Runtime;
+
+static const char *x86RuntimeNames[RT_COUNT] = {
+    "rtPrintf", "rtWrite", "rtToString", "rtConcat", "rtStringEquals", "rtNewArray", "rtFail",
+    "pow", "fmod", "fmax", "fmin"
+};
+
+// Falhas em tempo de execução detectadas pelo código gerado (argumento de rtFail)
+typedef enum {
+    FAIL_DIVISION,
+    FAIL_OVERFLOW,
+    FAIL_INDEX,
+    FAIL_NULL,
+    FAIL_NEGATIVE_LENGTH,
+    FAIL_COUNT
+} X86Failure;
+
+// ---------------------------------------------------------------------------
+// Montador: bytes, dados e rótulos
+// ---------------------------------------------------------------------------
+
+// Função para liberar o montador
+void x86Free(X86Asm *as) {
+    free(as->code);
+    free(as->rodata);
+    free(as->data);
+    free(as->labels);
+    free(as->fixups);
+    free(as->relocs);
+    free(as->symbols);
+    memset(as, 0, sizeof(*as));
+}
+
+// Função para esvaziar o montador mantendo os vetores já reservados
+void x86Reset(X86Asm *as) {
+    as->size = as->rodataSize = as->bssSize = 0;
+    as->dataCount = as->labelCount = as->fixupCount = as->relocCount = as->symbolCount = 0;
+}
+
+// Função para gravar um byte no código
+void x86Byte(X86Asm *as, uint8_t byte) {
+    if (as->size == as->capacity) {
+        as->code = vectorGrow(as->code, &as->capacity, as->size + 1, 1);
+    }
+    as->code[as->size++] = byte;
+}
+
+// Função para gravar um inteiro little-endian de 'size' bytes no código
+void x86Bytes(X86Asm *as, uint64_t value, int size) {
+    for (int i = 0; i < size; i++) {
+        x86Byte(as, (uint8_t)(value >> (8 * i)));
+    }
+}
+
+// Função para criar um rótulo
+uint32_t x86NewLabel(X86Asm *as) {
+    as->labels = vectorGrow(as->labels, &as->labelCapacity, as->labelCount + 1, sizeof(uint32_t));
+    as->labels[as->labelCount] = OPT_NONE;
+    return as->labelCount++;
+}
+
+// Função para exibir o nome de um rótulo no texto do montador
+void x86PrintLabel(const X86Asm *as, uint32_t label) {
+    for (uint32_t i = 0; i < as->symbolCount; i++) {
+        if (as->symbols[i].label == label) {
+            fputs(as->symbols[i].name, as->text);
+            return;
+        }
+    }
+    fprintf(as->text, ".L%u", label);
+}
+
+// Função para definir um rótulo na posição atual
+void x86Bind(X86Asm *as, uint32_t label) {
+    as->labels[label] = as->size;
+    if (as->text) {
+        x86PrintLabel(as, label);
+        fputs(":\n", as->text);
+    }
+}
+
+// Função para criar um símbolo de função com nome legível
+uint32_t x86AddSymbol(X86Asm *as, const char *prefix, const char *name, uint32_t length, int global) {
+    as->symbols = vectorGrow(as->symbols, &as->symbolCapacity, as->symbolCount + 1, sizeof(X86Symbol));
+    X86Symbol *symbol = &as->symbols[as->symbolCount++];
+    int out = snprintf(symbol->name, sizeof(symbol->name), "%s", prefix);
+    for (uint32_t i = 0; i < length && out < (int)sizeof(symbol->name) - 1; i++) {
+        unsigned char c = (unsigned char)name[i];
+        symbol->name[out++] = CHAR_IS(c, CHAR_IDENTIFIER) ? (char)c : '_';
+    }
+    symbol->name[out] = '\0';
+    symbol->label = x86NewLabel(as);
+    symbol->global = global;
+    return symbol->label;
+}
+
+// Função para acrescentar um dado; devolve o índice
+uint32_t x86AddData(X86Asm *as, X86Section section, X86DataKind kind, const void *bytes, uint32_t size, uint32_t align) {
+    as->data = vectorGrow(as->data, &as->dataCapacity, as->dataCount + 1, sizeof(X86Data));
+    X86Data *data = &as->data[as->dataCount];
+    data->section = (uint8_t)section;
+    data->kind = (uint8_t)kind;
+    data->align = (uint16_t)align;
+    data->size = size;
+    if (section == SECTION_BSS) {
+        as->bssSize = (as->bssSize + align - 1) & ~(align - 1);
+        data->offset = as->bssSize;
+        as->bssSize += size;
+    } else {
+        uint32_t offset = (as->rodataSize + align - 1) & ~(align - 1);
+        as->rodata = vectorGrow(as->rodata, &as->rodataCapacity, offset + size, 1);
+        memset(as->rodata + as->rodataSize, 0, offset - as->rodataSize);
+        memcpy(as->rodata + offset, bytes, size);
+        data->offset = offset;
+        as->rodataSize = offset + size;
+    }
+    return as->dataCount++;
+}
+
+// Função para acrescentar uma string no formato VmString (cabeçalho nulo, comprimento e texto)
+uint32_t x86AddString(X86Asm *as, const char *text, uint32_t length) {
+    uint8_t *bytes = optCalloc(offsetof(VmString, data) + length + 1, 1);
+    memcpy(bytes + offsetof(VmString, length), &length, sizeof(length));
+    memcpy(bytes + offsetof(VmString, data), text, length);
+    uint32_t item = x86AddData(as, SECTION_RODATA, DATA_STRING, bytes, offsetof(VmString, data) + length + 1, 8);
+    free(bytes);
+    return item;
+}
+
+// Função para registrar uma relocação no campo de 32 bits da posição atual
+void x86AddReloc(X86Asm *as, X86RelocKind kind, uint32_t target, int32_t addend) {
+    as->relocs = vectorGrow(as->relocs, &as->relocCapacity, as->relocCount + 1, sizeof(X86Reloc));
+    as->relocs[as->relocCount++] = (X86Reloc){as->size, (uint8_t)kind, target, addend};
+}
+
+// Função para gravar o deslocamento de 32 bits até um rótulo (resolvido em x86ResolveLabels)
+void x86LabelRef(X86Asm *as, uint32_t label) {
+    as->fixups = vectorGrow(as->fixups, &as->fixupCapacity, as->fixupCount + 1, sizeof(X86Fixup));
+    as->fixups[as->fixupCount++] = (X86Fixup){as->size, label};
+    x86Bytes(as, 0, 4);
+}
+
+// Função para alinhar o código (preenchido com int3)
+void x86Align(X86Asm *as, uint32_t alignment) {
+    if (as->text) {
+        fprintf(as->text, "    .p2align %d, 0xcc\n", __builtin_ctz(alignment));
+    }
+    while (as->size % alignment) {
+        x86Byte(as, 0xCC);
+    }
+}
+
+// Função para resolver as referências a rótulos
+void x86ResolveLabels(X86Asm *as) {
+    for (uint32_t i = 0; i < as->fixupCount; i++) {
+        const X86Fixup *fixup = &as->fixups[i];
+        int32_t rel = (int32_t)(as->labels[fixup->label] - (fixup->at + 4));
+        memcpy(as->code + fixup->at, &rel, sizeof(rel));
+    }
+    as->fixupCount = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Montador: operandos e codificação
+// ---------------------------------------------------------------------------
+
+X86Operand x86Reg(int reg, int size) {
+    return (X86Operand){X86_REG, (uint8_t)size, (uint8_t)reg, X86_NOREG, 1, 0, 0};
+}
+
+X86Operand x86Xmm(int reg) {
+    return (X86Operand){X86_XMM, 8, (uint8_t)reg, X86_NOREG, 1, 0, 0};
+}
+
+X86Operand x86Mem(int base, int32_t disp, int size) {
+    return (X86Operand){X86_MEM, (uint8_t)size, (uint8_t)base, X86_NOREG, 1, disp, 0};
+}
+
+X86Operand x86MemIndex(int base, int index, int scale, int32_t disp, int size) {
+    return (X86Operand){X86_MEM, (uint8_t)size, (uint8_t)base, (uint8_t)index, (uint8_t)scale, disp, 0};
+}
+
+X86Operand x86Rip(uint32_t data, int size) {
+    return (X86Operand){X86_RIP, (uint8_t)size, 0, X86_NOREG, 1, (int32_t)data, 0};
+}
+
+X86Operand x86Imm(int64_t value) {
+    return (X86Operand){X86_IMM, 4, 0, X86_NOREG, 1, 0, value};
+}
+
+// Variável global 'index' (dado 0: o vetor de globais no .bss)
+X86Operand x86Global(uint32_t index) {
+    return (X86Operand){X86_RIP, 8, 0, X86_NOREG, 1, 0, 8 * (int64_t)index};
+}
+
+// Função para escrever um operando no texto do montador
+void x86PrintOperand(const X86Asm *as, const X86Operand *op) {
+    static const char *sizes[9] = {"", "byte ptr ", "", "", "dword ptr ", "", "", "", "qword ptr "};
+    switch (op->kind) {
+        case X86_REG:
+            fputs(x86RegisterNames[op->size == 1 ? 0 : op->size == 4 ? 1 : 2][op->reg], as->text);
+            break;
+        case X86_XMM:
+            fprintf(as->text, "xmm%d", op->reg);
+            break;
+        case X86_MEM:
+            fprintf(as->text, "%s[%s", sizes[op->size], x86RegisterNames[2][op->reg]);
+            if (op->index != X86_NOREG) {
+                fprintf(as->text, "+%s*%d", x86RegisterNames[2][op->index], op->scale);
+            }
+            if (op->disp) {
+                fprintf(as->text, "%+d", op->disp);
+            }
+            fputc(']', as->text);
+            break;
+        case X86_RIP:
+            fprintf(as->text, "%s[rip+.LD%d", sizes[op->size], op->disp);
+            if (op->imm) {
+                fprintf(as->text, "%+lld", (long long)op->imm);
+            }
+            fputc(']', as->text);
+            break;
+        case X86_IMM:
+            fprintf(as->text, "%lld", (long long)op->imm);
+            break;
+    }
+}
+
+// Função para escrever uma instrução no texto do montador
+void x86Print(const X86Asm *as, const char *mnemonic, const X86Operand *a, const X86Operand *b) {
+    if (!as->text) {
+        return;
+    }
+    fprintf(as->text, "    %s", mnemonic);
+    if (a) {
+        fputc(' ', as->text);
+        x86PrintOperand(as, a);
+    }
+    if (b) {
+        fputs(", ", as->text);
+        x86PrintOperand(as, b);
+    }
+    fputc('\n', as->text);
+}
+
+// Função para gravar o prefixo REX (se necessário)
+void x86Rex(X86Asm *as, int w, int reg, const X86Operand *rm, int force) {
+    int r = (reg >> 3) & 1, x = 0, b = 0;
+    if (rm->kind == X86_REG || rm->kind == X86_XMM) {
+        b = (rm->reg >> 3) & 1;
+    } else if (rm->kind == X86_MEM) {
+        b = (rm->reg >> 3) & 1;
+        x = rm->index != X86_NOREG ? (rm->index >> 3) & 1 : 0;
+    }
+    if (w || r || x || b || force) {
+        x86Byte(as, (uint8_t)(0x40 | (w << 3) | (r << 2) | (x << 1) | b));
+    }
+}
+
+// Função para gravar o ModRM (e SIB e deslocamento); 'trailing' são os bytes de imediato que seguem
+void x86ModRM(X86Asm *as, int reg, const X86Operand *rm, int trailing) {
+    reg &= 7;
+    if (rm->kind == X86_REG || rm->kind == X86_XMM) {
+        x86Byte(as, (uint8_t)(0xC0 | (reg << 3) | (rm->reg & 7)));
+        return;
+    }
+    if (rm->kind == X86_RIP) {
+        x86Byte(as, (uint8_t)(0x05 | (reg << 3)));
+        x86AddReloc(as, RELOC_DATA, (uint32_t)rm->disp, (int32_t)rm->imm - 4 - trailing);
+        x86Bytes(as, 0, 4);
+        return;
+    }
+    int base = rm->reg & 7;
+    int mod = rm->disp == 0 && base != 5 ? 0 : rm->disp >= -128 && rm->disp <= 127 ? 1 : 2;
+    if (rm->index != X86_NOREG || base == 4) {
+        int scale = rm->scale == 8 ? 3 : rm->scale == 4 ? 2 : rm->scale == 2 ? 1 : 0;
+        int index = rm->index != X86_NOREG ? rm->index & 7 : 4;
+        x86Byte(as, (uint8_t)((mod << 6) | (reg << 3) | 4));
+        x86Byte(as, (uint8_t)((scale << 6) | (index << 3) | base));
+    } else {
+        x86Byte(as, (uint8_t)((mod << 6) | (reg << 3) | base));
+    }
+    if (mod == 1) {
+        x86Byte(as, (uint8_t)(int8_t)rm->disp);
+    } else if (mod == 2) {
+        x86Bytes(as, (uint32_t)rm->disp, 4);
+    }
+}
+
+// Função para codificar uma instrução: [prefixo] [REX] opcode ModRM [imediato]
+void x86Encode(X86Asm *as, uint8_t prefix, int w, const char *opcode, int reg, const X86Operand *rm,
+               int immSize, int64_t imm) {
+    if (prefix) {
+        x86Byte(as, prefix);
+    }
+    x86Rex(as, w, reg, rm, 0);
+    for (const char *c = opcode; *c; c++) {
+        x86Byte(as, (uint8_t)*c);
+    }
+    x86ModRM(as, reg, rm, immSize);
+    x86Bytes(as, (uint64_t)imm, immSize);
+}
+
+// Função que indica se um imediato cabe em 8 bits com sinal
+int x86IsImm8(int64_t value) {
+    return value >= -128 && value <= 127;
+}
+
+// Função para 'mov' entre registradores, memória e imediatos
+void x86Mov(X86Asm *as, X86Operand dst, X86Operand src) {
+    int w = dst.size == 8;
+    if (src.kind == X86_IMM) {
+        if (dst.kind == X86_REG && (!w || (src.imm >= 0 && src.imm <= UINT32_MAX))) {
+            // mov r32, imm32 (zera a parte alta)
+            x86Rex(as, 0, 0, &dst, 0);
+            x86Byte(as, (uint8_t)(0xB8 + (dst.reg & 7)));
+            x86Bytes(as, (uint64_t)src.imm, 4);
+            X86Operand d32 = x86Reg(dst.reg, 4);
+            x86Print(as, "mov", &d32, &src);
+            return;
+        }
+        if (dst.kind == X86_REG && (src.imm < INT32_MIN || src.imm > INT32_MAX)) {
+            x86Rex(as, 1, 0, &dst, 0);
+            x86Byte(as, (uint8_t)(0xB8 + (dst.reg & 7)));
+            x86Bytes(as, (uint64_t)src.imm, 8);
+            x86Print(as, "movabs", &dst, &src);
+            return;
+        }
+        x86Encode(as, 0, w, "\xC7", 0, &dst, 4, src.imm);
+    } else if (dst.kind == X86_REG) {
+        x86Encode(as, 0, w, "\x8B", dst.reg, &src, 0, 0);
+    } else {
+        x86Encode(as, 0, w, "\x89", src.reg, &dst, 0, 0);
+    }
+    x86Print(as, "mov", &dst, &src);
+}
+
+// Operações aritméticas e lógicas com a mesma forma (dígito do ModRM no grupo 0x81)
+typedef enum {
+    ALU_ADD = 0,
+    ALU_OR = 1,
+    ALU_AND = 4,
+    ALU_SUB = 5,
+    ALU_XOR = 6,
+    ALU_CMP = 7
+} X86Alu;
+
+static const char *x86AluNames[8] = {"add", "or", "", "", "and", "sub", "xor", "cmp"};
+
+// Função para add/or/and/sub/xor/cmp
+void x86Alu(X86Asm *as, X86Alu op, X86Operand dst, X86Operand src) {
+    int w = dst.size == 8;
+    char opcode[2] = {0, 0};
+    if (src.kind == X86_IMM) {
+        int small = x86IsImm8(src.imm);
+        opcode[0] = (char)(small ? 0x83 : 0x81);
+        x86Encode(as, 0, w, opcode, op, &dst, small ? 1 : 4, src.imm);
+    } else if (dst.kind == X86_REG) {
+        opcode[0] = (char)(op * 8 + 3);
+        x86Encode(as, 0, w, opcode, dst.reg, &src, 0, 0);
+    } else {
+        opcode[0] = (char)(op * 8 + 1);
+        x86Encode(as, 0, w, opcode, src.reg, &dst, 0, 0);
+    }
+    x86Print(as, x86AluNames[op], &dst, &src);
+}
+
+// Função para imul r, r/m
+void x86Imul(X86Asm *as, X86Operand dst, X86Operand src) {
+    x86Encode(as, 0, dst.size == 8, "\x0F\xAF", dst.reg, &src, 0, 0);
+    x86Print(as, "imul", &dst, &src);
+}
+
+// Função para instruções de um operando do grupo 0xF7 (not 2, neg 3, idiv 7)
+void x86Unary(X86Asm *as, int digit, X86Operand op) {
+    static const char *names[8] = {"test", "", "not", "neg", "mul", "imul", "div", "idiv"};
+    x86Encode(as, 0, op.size == 8, "\xF7", digit, &op, 0, 0);
+    x86Print(as, names[digit], &op, NULL);
+}
+
+// Função para test r/m, r
+void x86Test(X86Asm *as, X86Operand a, X86Operand b) {
+    x86Encode(as, 0, a.size == 8, "\x85", b.reg, &a, 0, 0);
+    x86Print(as, "test", &a, &b);
+}
+
+// Função para lea r64, m
+void x86Lea(X86Asm *as, int reg, X86Operand mem) {
+    X86Operand dst = x86Reg(reg, 8);
+    mem.size = 0;
+    x86Encode(as, 0, 1, "\x8D", reg, &mem, 0, 0);
+    x86Print(as, "lea", &dst, &mem);
+}
+
+// Função para setcc r8 (apenas al, cl, dl e bl: os demais exigiriam REX)
+void x86Setcc(X86Asm *as, X86Condition cc, int reg) {
+    char opcode[3] = {0x0F, (char)(0x90 + cc), 0};
+    char name[8];
+    X86Operand byte = x86Reg(reg, 1);
+    x86Encode(as, 0, 0, opcode, 0, &byte, 0, 0);
+    snprintf(name, sizeof(name), "set%s", x86ConditionNames[cc]);
+    x86Print(as, name, &byte, NULL);
+}
+
+// Função para movzx r32, r8
+void x86Movzx(X86Asm *as, int reg) {
+    X86Operand byte = x86Reg(reg, 1), dword = x86Reg(reg, 4);
+    x86Encode(as, 0, 0, "\x0F\xB6", reg, &byte, 0, 0);
+    x86Print(as, "movzx", &dword, &byte);
+}
+
+// Função para cmovcc r, r/m
+void x86Cmov(X86Asm *as, X86Condition cc, X86Operand dst, X86Operand src) {
+    char opcode[3] = {0x0F, (char)(0x40 + cc), 0};
+    char name[8];
+    x86Encode(as, 0, dst.size == 8, opcode, dst.reg, &src, 0, 0);
+    snprintf(name, sizeof(name), "cmov%s", x86ConditionNames[cc]);
+    x86Print(as, name, &dst, &src);
+}
+
+// Função para jmp rel32
+void x86Jump(X86Asm *as, uint32_t label) {
+    x86Byte(as, 0xE9);
+    x86LabelRef(as, label);
+    if (as->text) {
+        fputs("    jmp ", as->text);
+        x86PrintLabel(as, label);
+        fputc('\n', as->text);
+    }
+}
+
+// Função para jcc rel32
+void x86JumpIf(X86Asm *as, X86Condition cc, uint32_t label) {
+    x86Byte(as, 0x0F);
+    x86Byte(as, (uint8_t)(0x80 + cc));
+    x86LabelRef(as, label);
+    if (as->text) {
+        fprintf(as->text, "    j%s ", x86ConditionNames[cc]);
+        x86PrintLabel(as, label);
+        fputc('\n', as->text);
+    }
+}
+
+// Função para call rel32 para uma função gerada
+void x86CallLabel(X86Asm *as, uint32_t label) {
+    x86Byte(as, 0xE8);
+    x86LabelRef(as, label);
+    if (as->text) {
+        fputs("    call ", as->text);
+        x86PrintLabel(as, label);
+        fputc('\n', as->text);
+    }
+}
+
+// Função para call rel32 para uma função do runtime ou da libm
+void x86CallRuntime(X86Asm *as, X86Runtime function) {
+    x86Byte(as, 0xE8);
+    x86AddReloc(as, RELOC_CALL, function, -4);
+    x86Bytes(as, 0, 4);
+    if (as->text) {
+        fprintf(as->text, "    call %s@PLT\n", x86RuntimeNames[function]);
+    }
+}
+
+// Função para push/pop de um registrador de 64 bits
+void x86PushPop(X86Asm *as, int reg, int pop) {
+    X86Operand op = x86Reg(reg, 8);
+    if (reg >= R8) {
+        x86Byte(as, 0x41);
+    }
+    x86Byte(as, (uint8_t)((pop ? 0x58 : 0x50) + (reg & 7)));
+    x86Print(as, pop ? "pop" : "push", &op, NULL);
+}
+
+// Função para instruções sem operandos (ret, cdq)
+void x86Simple(X86Asm *as, uint8_t opcode, const char *name) {
+    x86Byte(as, opcode);
+    x86Print(as, name, NULL, NULL);
+}
+
+// Função para instruções SSE da forma xmm, xmm/m64 (prefixo F2 ou 66)
+void x86Sse(X86Asm *as, uint8_t prefix, uint8_t opcode, const char *name, int dst, X86Operand src) {
+    char bytes[3] = {0x0F, (char)opcode, 0};
+    X86Operand d = x86Xmm(dst);
+    if (src.kind == X86_MEM || src.kind == X86_RIP) {
+        src.size = 8;
+    }
+    x86Encode(as, prefix, 0, bytes, dst, &src, 0, 0);
+    x86Print(as, name, &d, &src);
+}
+
+// Função para movsd m64, xmm
+void x86StoreSd(X86Asm *as, X86Operand dst, int src) {
+    X86Operand s = x86Xmm(src);
+    dst.size = 8;
+    x86Encode(as, 0xF2, 0, "\x0F\x11", src, &dst, 0, 0);
+    x86Print(as, "movsd", &dst, &s);
+}
+
+// Função para movq entre xmm e registrador de 64 bits
+void x86Movq(X86Asm *as, X86Operand dst, X86Operand src) {
+    if (dst.kind == X86_XMM) {
+        x86Encode(as, 0x66, 1, "\x0F\x6E", dst.reg, &src, 0, 0);
+    } else {
+        x86Encode(as, 0x66, 1, "\x0F\x7E", src.reg, &dst, 0, 0);
+    }
+    x86Print(as, "movq", &dst, &src);
+}
+
+// Função para cvtsi2sd xmm, r/m32
+void x86Cvtsi2sd(X86Asm *as, int dst, X86Operand src) {
+    X86Operand d = x86Xmm(dst);
+    src.size = 4;
+    x86Encode(as, 0xF2, 0, "\x0F\x2A", dst, &src, 0, 0);
+    x86Print(as, "cvtsi2sd", &d, &src);
+}
+
+// Função para cvttsd2si r32, xmm/m64
+void x86Cvttsd2si(X86Asm *as, int dst, X86Operand src) {
+    X86Operand d = x86Reg(dst, 4);
+    x86Encode(as, 0xF2, 0, "\x0F\x2C", dst, &src, 0, 0);
+    x86Print(as, "cvttsd2si", &d, &src);
+}
+
+// Função para btr r64, imm8
+void x86Btr(X86Asm *as, int reg, int bit) {
+    X86Operand op = x86Reg(reg, 8), imm = x86Imm(bit);
+    x86Encode(as, 0, 1, "\x0F\xBA", 6, &op, 1, bit);
+    x86Print(as, "btr", &op, &imm);
+}
+
+// ---------------------------------------------------------------------------
+// Alocação de registradores (varredura linear)
+// ---------------------------------------------------------------------------
+
+// Tipos de localização de um registrador virtual
+typedef enum {
+    LOC_NONE,
+    LOC_REG,
+    LOC_XMM,
+    LOC_STACK
+} X86LocationKind;
+
+// Estrutura da localização de um registrador virtual
+typedef struct {
+    uint8_t kind;
+    uint8_t reg;
+    int32_t offset;   // LOC_STACK: deslocamento em relação a rbp
+} X86Location;
+
+// Estrutura de um intervalo de vida
+typedef struct {
+    VReg v;
+    uint32_t start;
+    uint32_t end;
+    uint8_t isDouble;
+    uint8_t crossesCall;
+} X86Interval;
+
+// Registradores alocáveis: os que não sobrevivem a chamadas vêm primeiro
+static const uint8_t x86GprOrder[] = {R10, R11, RBX, R12, R13, R14, R15};
+static const uint8_t x86CalleeSaved[] = {RBX, R12, R13, R14, R15};
+#define X86_GPR_VOLATILE 2
+#define X86_XMM_FIRST 8
+
+// Função que indica se um tipo do código intermediário usa registradores xmm
+int x86IsDouble(uint8_t type) {
+    return type == IR_DOUBLE;
+}
+
+// Função que indica se uma instrução vira uma chamada (destrói rax..r11 e xmm)
+int x86IsCall(const IrInstr *instr) {
+    switch (instr->op) {
+        case IR_CALL:
+        case IR_CALL_BUILTIN:
+        case IR_CONCAT:
+        case IR_NEW_ARRAY:
+            return 1;
+        case IR_MOD:
+            return instr->type == IR_DOUBLE;
+        case IR_EQ:
+        case IR_NE:
+            return instr->type == IR_STRING;
+        default:
+            return 0;
+    }
+}
+
+// Função para comparar intervalos pelo início (e pelo registrador, para um resultado determinístico)
+int x86CompareIntervals(const void *a, const void *b) {
+    const X86Interval *x = a, *y = b;
+    if (x->start != y->start) return x->start < y->start ? -1 : 1;
+    return x->v < y->v ? -1 : x->v > y->v;
+}
+
+// Estrutura do resultado da alocação
+typedef struct {
+    X86Location *locations;   // Por registrador virtual
+    uint32_t spillSlots;
+    uint32_t savedMask;       // Registradores preservados usados (bits por número de registrador)
+    uint32_t intervals;
+    uint32_t spilled;         // Intervalos que ficaram na pilha
+} X86Allocation;
+
+// Função para calcular os intervalos de vida; devolve o número de intervalos
+// (a instrução i ocupa a posição i + 1; os parâmetros nascem na posição 0). Os registradores
+// marcados em 'skip' (constantes usadas só como imediatos) não recebem intervalo
+uint32_t x86Intervals(const IrFunction *fn, const uint8_t *skip, X86Interval **out) {
+    uint32_t *first = optCalloc(fn->vregCount, sizeof(uint32_t));
+    uint32_t *last = optCalloc(fn->vregCount, sizeof(uint32_t));
+    uint32_t *labelAt = optCalloc(fn->labelCount, sizeof(uint32_t));
+    uint32_t *calls = optCalloc(fn->count + 1, sizeof(uint32_t));
+    uint32_t callCount = 0, n = fn->count + 1;
+    memset(first, 0xFF, fn->vregCount * sizeof(uint32_t));
+
+    for (VReg v = 1; v <= fn->paramCount && v < fn->vregCount; v++) {
+        first[v] = 0;
+    }
+    for (uint32_t i = 0; i < fn->count; i++) {
+        if (fn->code[i].op == IR_LABEL) {
+            labelAt[fn->code[i].src1] = i + 1;
+        }
+    }
+    for (uint32_t i = 0; i < fn->count; i++) {
+        const IrInstr *instr = &fn->code[i];
+        uint32_t at = i;
+        if (instr->op == IR_ARG) {
+            // O argumento é lido na chamada seguinte
+            while (at < fn->count && fn->code[at].op != IR_CALL && fn->code[at].op != IR_CALL_BUILTIN) {
+                at++;
+            }
+        }
+        at++;
+        if (x86IsCall(instr)) {
+            calls[callCount++] = i + 1;
+        }
+        VReg regs[4];
+        int count = irUses(instr, regs);
+        VReg def = irDefinition(instr);
+        if (def) {
+            regs[count++] = def;
+        }
+        for (int k = 0; k < count; k++) {
+            VReg v = regs[k];
+            if (first[v] == OPT_NONE || at < first[v]) first[v] = at;
+            if (at > last[v]) last[v] = at;
+        }
+    }
+
+    // Desvios para trás: maior origem por destino, consultada por uma tabela esparsa de máximos
+    uint32_t levels = 1;
+    while ((1u << levels) <= n) {
+        levels++;
+    }
+    uint32_t *table = optCalloc((size_t)levels * n, sizeof(uint32_t));
+    for (uint32_t i = 0; i < fn->count; i++) {
+        const IrInstr *instr = &fn->code[i];
+        uint32_t target = instr->op == IR_JUMP ? instr->src1 :
+                          instr->op == IR_JUMP_IF || instr->op == IR_JUMP_IFNOT ? instr->src2 : OPT_NONE;
+        if (target != OPT_NONE && labelAt[target] <= i + 1 && i + 1 > table[labelAt[target]]) {
+            table[labelAt[target]] = i + 1;
+        }
+    }
+    for (uint32_t k = 1; k < levels; k++) {
+        for (uint32_t i = 0; i + (1u << k) <= n; i++) {
+            uint32_t a = table[(k - 1) * n + i], b = table[(k - 1) * n + i + (1u << (k - 1))];
+            table[k * n + i] = a > b ? a : b;
+        }
+    }
+
+    X86Interval *intervals = optCalloc(fn->vregCount, sizeof(X86Interval));
+    uint32_t count = 0;
+    for (VReg v = 1; v < fn->vregCount; v++) {
+        if (first[v] == OPT_NONE || skip[v]) {
+            continue;
+        }
+        uint32_t start = first[v], end = last[v];
+        // Um valor vivo na entrada de um laço fica vivo até o último desvio para trás do laço
+        while (end > start) {
+            uint32_t low = start + 1, length = end - start, k = 0;
+            while ((2u << k) <= length) k++;
+            uint32_t a = table[k * n + low], b = table[k * n + end + 1 - (1u << k)];
+            uint32_t reach = a > b ? a : b;
+            if (reach <= end) {
+                break;
+            }
+            end = reach;
+        }
+        X86Interval *interval = &intervals[count++];
+        interval->v = v;
+        interval->start = start;
+        interval->end = end;
+        interval->isDouble = x86IsDouble(fn->vregTypes[v]);
+
+        // Atravessa uma chamada se alguma está estritamente dentro do intervalo
+        uint32_t low = 0, high = callCount;
+        while (low < high) {
+            uint32_t mid = (low + high) / 2;
+            if (calls[mid] <= start) low = mid + 1;
+            else high = mid;
+        }
+        interval->crossesCall = low < callCount && calls[low] < end;
+    }
+    qsort(intervals, count, sizeof(X86Interval), x86CompareIntervals);
+
+    free(first);
+    free(last);
+    free(labelAt);
+    free(calls);
+    free(table);
+    *out = intervals;
+    return count;
+}
+
+// Função para mandar um registrador virtual para a pilha; parâmetros ficam onde o chamador os gravou
+void x86Spill(X86Allocation *allocation, const IrFunction *fn, VReg v) {
+    X86Location *location = &allocation->locations[v];
+    location->kind = LOC_STACK;
+    location->offset = v <= fn->paramCount ? 16 + 8 * (int32_t)(v - 1) : -8 * (int32_t)++allocation->spillSlots;
+    allocation->spilled++;
+}
+
+// Função para alocar os registradores de uma função por varredura linear
+void x86Allocate(const IrFunction *fn, const uint8_t *skip, X86Allocation *allocation) {
+    X86Interval *intervals;
+    uint32_t count = x86Intervals(fn, skip, &intervals);
+    allocation->locations = optCalloc(fn->vregCount, sizeof(X86Location));
+    allocation->spillSlots = 0;
+    allocation->savedMask = 0;
+    allocation->spilled = 0;
+    allocation->intervals = count;
+
+    // Ativos: índice do intervalo que ocupa cada registrador (OPT_NONE se livre)
+    uint32_t gprOwner[16], xmmOwner[16];
+    memset(gprOwner, 0xFF, sizeof(gprOwner));
+    memset(xmmOwner, 0xFF, sizeof(xmmOwner));
+
+    for (uint32_t i = 0; i < count; i++) {
+        X86Interval *current = &intervals[i];
+        uint32_t *owner = current->isDouble ? xmmOwner : gprOwner;
+
+        // Libera os registradores de intervalos que terminaram
+        for (int r = 0; r < 16; r++) {
+            if (gprOwner[r] != OPT_NONE && intervals[gprOwner[r]].end <= current->start) gprOwner[r] = OPT_NONE;
+            if (xmmOwner[r] != OPT_NONE && intervals[xmmOwner[r]].end <= current->start) xmmOwner[r] = OPT_NONE;
+        }
+
+        // Registradores permitidos para o intervalo
+        uint8_t allowed[16];
+        int allowedCount = 0;
+        if (current->isDouble) {
+            for (int r = X86_XMM_FIRST; r < 16 && !current->crossesCall; r++) allowed[allowedCount++] = (uint8_t)r;
+        } else {
+            for (size_t k = current->crossesCall ? X86_GPR_VOLATILE : 0; k < sizeof(x86GprOrder); k++) {
+                allowed[allowedCount++] = x86GprOrder[k];
+            }
+        }
+
+        int chosen = -1;
+        for (int k = 0; k < allowedCount && chosen < 0; k++) {
+            if (owner[allowed[k]] == OPT_NONE) chosen = allowed[k];
+        }
+        if (chosen < 0 && allowedCount) {
+            // Sem registrador livre: cede o do intervalo ativo que termina mais tarde
+            int victim = -1;
+            for (int k = 0; k < allowedCount; k++) {
+                if (victim < 0 || intervals[owner[allowed[k]]].end > intervals[owner[victim]].end) victim = allowed[k];
+            }
+            if (intervals[owner[victim]].end > current->end) {
+                x86Spill(allocation, fn, intervals[owner[victim]].v);
+                chosen = victim;
+            }
+        }
+
+        X86Location *location = &allocation->locations[current->v];
+        if (chosen >= 0) {
+            owner[chosen] = i;
+            location->kind = current->isDouble ? LOC_XMM : LOC_REG;
+            location->reg = (uint8_t)chosen;
+        } else {
+            x86Spill(allocation, fn, current->v);
+        }
+    }
+
+    // Registradores preservados efetivamente usados
+    for (VReg v = 1; v < fn->vregCount; v++) {
+        const X86Location *location = &allocation->locations[v];
+        if (location->kind == LOC_REG) {
+            for (size_t k = 0; k < sizeof(x86CalleeSaved); k++) {
+                if (location->reg == x86CalleeSaved[k]) allocation->savedMask |= 1u << location->reg;
+            }
+        }
+    }
+    free(intervals);
+}
+
+// ---------------------------------------------------------------------------
+// Geração de código
+// ---------------------------------------------------------------------------
+
+// Estrutura das estatísticas da geração
+typedef struct {
+    uint32_t functions;
+    uint32_t intervals;     // Intervalos de vida alocados
+    uint32_t spilled;       // Intervalos que ficaram na pilha
+} X86Stats;
+
+// Estrutura do estado da geração de uma função
+typedef struct {
+    X86Asm *as;
+    const IrModule *module;
+    const IrFunction *fn;
+    X86Allocation allocation;
+    const uint32_t *functionLabels;
+    uint32_t *labels;          // Rótulo do código intermediário -> rótulo do montador
+    uint32_t epilogue;
+    uint32_t failLabels[FAIL_COUNT];
+    uint32_t nameData;         // Nome da função (para as mensagens de erro)
+    uint32_t *uses;
+    uint8_t *isConstant;       // Definido uma única vez, por ICONST
+    int32_t *constants;
+    uint8_t *skipped;          // Constantes usadas apenas como imediatos (sem registrador)
+    int32_t savedBytes;
+    int32_t tempOffset;        // Duas posições temporárias (CONCAT)
+    VReg args[IR_MAX_ARGUMENTS];
+    uint32_t argCount;
+    int errorCount;
+} X86Generator;
+
+// Função para exibir um erro de geração
+void x86Error(X86Generator *g, const char *message) {
+    fprintf(stderr, "Erro na geração de código x86-64 (%.*s): %s\n", (int)g->fn->nameLength, g->fn->name, message);
+    g->errorCount++;
+}
+
+// Função para obter o operando de um registrador virtual (registrador ou posição na pilha)
+X86Operand x86Value(const X86Generator *g, VReg v) {
+    const X86Location *location = &g->allocation.locations[v];
+    uint8_t type = g->fn->vregTypes[v];
+    int size = x86IsDouble(type) || type == IR_STRING || type == IR_REF ? 8 : 4;
+    switch (location->kind) {
+        case LOC_REG: return x86Reg(location->reg, size);
+        case LOC_XMM: return x86Xmm(location->reg);
+        case LOC_STACK: return x86Mem(RBP, location->offset, size);
+        default: return x86Mem(RBP, g->tempOffset, size);  // Valor nunca usado
+    }
+}
+
+// Função que indica se o operando 'slot' (0 = src1, 1 = src2, 2 = dst lido) vira um imediato
+int x86Folds(const X86Generator *g, const IrInstr *instr, int slot) {
+    switch (instr->op) {
+        case IR_ADD: case IR_MUL:
+        case IR_LT: case IR_GT: case IR_LE: case IR_GE: case IR_EQ: case IR_NE:
+            // O primeiro operando troca de lugar com o segundo (comutativo ou condição espelhada)
+            if (!vmIsInteger(instr->type)) {
+                return 0;
+            }
+            return slot == 1 ? g->isConstant[instr->src2] :
+                   slot == 0 && g->isConstant[instr->src1] && !g->isConstant[instr->src2];
+        case IR_SUB:
+            return vmIsInteger(instr->type) && slot == 1 && g->isConstant[instr->src2];
+        case IR_STORE_GLOBAL:
+            return slot == 1 && g->isConstant[instr->src2];
+        case IR_STORE_INDEX:
+            return slot == 2 && g->isConstant[instr->dst];
+        default:
+            return 0;
+    }
+}
+
+// Função que indica se um argumento de uma chamada é gravado como imediato
+int x86FoldsArgument(const X86Generator *g, const IrInstr *call, VReg v) {
+    return g->isConstant[v] && (call->op == IR_CALL || call->src1 == BUILTIN_PRINTF ||
+                                call->src1 == BUILTIN_WRITE || call->src1 == BUILTIN_WRITELINE);
+}
+
+// Função para carregar um valor em um registrador inteiro (não copia se já estiver nele)
+void x86Load(X86Generator *g, int reg, VReg v) {
+    X86Operand src = x86Value(g, v);
+    if (src.kind == X86_REG && src.reg == reg) {
+        return;
+    }
+    x86Mov(g->as, x86Reg(reg, src.size), src);
+}
+
+// Função para gravar um registrador inteiro no destino
+void x86Store(X86Generator *g, VReg v, int reg) {
+    if (!v) {
+        return;
+    }
+    X86Operand dst = x86Value(g, v);
+    if (dst.kind == X86_REG && dst.reg == reg) {
+        return;
+    }
+    x86Mov(g->as, dst, x86Reg(reg, dst.size));
+}
+
+// Função para carregar um double em um registrador xmm
+void x86LoadXmm(X86Generator *g, int xmm, VReg v) {
+    X86Operand src = x86Value(g, v);
+    if (src.kind == X86_XMM && src.reg == xmm) {
+        return;
+    }
+    x86Sse(g->as, 0xF2, 0x10, "movsd", xmm, src);
+}
+
+// Função para gravar um registrador xmm no destino
+void x86StoreXmm(X86Generator *g, VReg v, int xmm) {
+    if (!v) {
+        return;
+    }
+    X86Operand dst = x86Value(g, v);
+    if (dst.kind == X86_XMM) {
+        if (dst.reg != xmm) x86Sse(g->as, 0xF2, 0x10, "movsd", dst.reg, x86Xmm(xmm));
+    } else {
+        x86StoreSd(g->as, dst, xmm);
+    }
+}
+
+// Função para copiar um valor qualquer para a memória (argumentos)
+void x86StoreToMemory(X86Generator *g, X86Operand dst, VReg v) {
+    X86Operand src = x86Value(g, v);
+    if (src.kind == X86_XMM) {
+        x86StoreSd(g->as, dst, src.reg);
+    } else if (src.kind == X86_REG) {
+        dst.size = src.size;
+        x86Mov(g->as, dst, src);
+    } else {
+        x86Mov(g->as, x86Reg(RAX, 8), (X86Operand){X86_MEM, 8, src.reg, X86_NOREG, 1, src.disp, 0});
+        dst.size = 8;
+        x86Mov(g->as, dst, x86Reg(RAX, 8));
+    }
+}
+
+// Função para gravar um argumento em [rsp + 8k]
+void x86StoreArgument(X86Generator *g, const IrInstr *call, uint32_t k, VReg v) {
+    X86Operand dst = x86Mem(RSP, 8 * (int32_t)k, 8);
+    if (x86FoldsArgument(g, call, v)) {
+        x86Mov(g->as, dst, x86Imm(g->constants[v]));
+    } else {
+        x86StoreToMemory(g, dst, v);
+    }
+}
+
+// Função para gravar um valor em uma posição de 8 bytes (global ou elemento de vetor)
+void x86StoreValue(X86Generator *g, X86Operand dst, VReg v, int immediate) {
+    X86Operand src = x86Value(g, v);
+    dst.size = 8;
+    if (immediate) {
+        x86Mov(g->as, dst, x86Imm(g->constants[v]));
+    } else if (src.kind == X86_XMM) {
+        x86StoreSd(g->as, dst, src.reg);
+    } else if (src.kind == X86_REG) {
+        x86Mov(g->as, dst, x86Reg(src.reg, 8));
+    } else {
+        x86Mov(g->as, x86Reg(RAX, 8), (X86Operand){X86_MEM, 8, src.reg, X86_NOREG, 1, src.disp, 0});
+        x86Mov(g->as, dst, x86Reg(RAX, 8));
+    }
+}
+
+// Função para obter o rótulo de uma falha em tempo de execução (criado no primeiro uso)
+uint32_t x86FailLabel(X86Generator *g, X86Failure failure) {
+    if (g->failLabels[failure] == OPT_NONE) {
+        g->failLabels[failure] = x86NewLabel(g->as);
+    }
+    return g->failLabels[failure];
+}
+
+// Função para gerar add/sub/imul inteiros (op < 0 = imul), com imediato quando um operando é constante
+void x86IntegerBinary(X86Generator *g, int op, const IrInstr *instr) {
+    VReg a = instr->src1;
+    X86Operand right;
+    if (x86Folds(g, instr, 1)) {
+        right = x86Imm(g->constants[instr->src2]);
+    } else if (x86Folds(g, instr, 0)) {
+        right = x86Imm(g->constants[instr->src1]);
+        a = instr->src2;
+    } else {
+        right = x86Value(g, instr->src2);
+        right.size = 4;
+    }
+    X86Operand d = x86Value(g, instr->dst), left = x86Value(g, a);
+    int reg = d.kind == X86_REG ? d.reg : RAX;
+    if (right.kind == X86_REG && right.reg == reg && !(left.kind == X86_REG && left.reg == reg)) {
+        reg = RAX;  // O destino é o segundo operando: calcula em rax
+    }
+    X86Operand r = x86Reg(reg, 4);
+    if (op < 0 && right.kind == X86_IMM) {
+        // imul r32, r/m32, imm: dispensa a cópia do primeiro operando
+        int small = x86IsImm8(right.imm);
+        left.size = 4;
+        x86Encode(g->as, 0, 0, small ? "\x6B" : "\x69", reg, &left, small ? 1 : 4, right.imm);
+        if (g->as->text) {
+            fprintf(g->as->text, "    imul ");
+            x86PrintOperand(g->as, &r);
+            fputs(", ", g->as->text);
+            x86PrintOperand(g->as, &left);
+            fprintf(g->as->text, ", %lld\n", (long long)right.imm);
+        }
+    } else {
+        x86Load(g, reg, a);
+        if (op < 0) {
+            x86Imul(g->as, r, right);
+        } else {
+            x86Alu(g->as, (X86Alu)op, r, right);
+        }
+    }
+    x86Store(g, instr->dst, reg);
+}
+
+// Função para gerar divisão e resto inteiros com as verificações do C#
+void x86Divide(X86Generator *g, const IrInstr *instr) {
+    X86Asm *as = g->as;
+    uint32_t ok = x86NewLabel(as);
+    x86Load(g, RAX, instr->src1);
+    x86Load(g, RCX, instr->src2);
+    x86Test(as, x86Reg(RCX, 4), x86Reg(RCX, 4));
+    x86JumpIf(as, CC_E, x86FailLabel(g, FAIL_DIVISION));
+    x86Alu(as, ALU_CMP, x86Reg(RCX, 4), x86Imm(-1));
+    x86JumpIf(as, CC_NE, ok);
+    x86Alu(as, ALU_CMP, x86Reg(RAX, 4), x86Imm(INT32_MIN));
+    x86JumpIf(as, CC_E, x86FailLabel(g, FAIL_OVERFLOW));
+    x86Bind(as, ok);
+    x86Simple(as, 0x99, "cdq");
+    x86Unary(as, 7, x86Reg(RCX, 4));
+    x86Store(g, instr->dst, instr->op == IR_DIV ? RAX : RDX);
+}
+
+// Condições das comparações inteiras (IR_LT..IR_NE) e double (após ucomisd com os operandos na ordem indicada)
+static const X86Condition x86IntConditions[6] = {CC_L, CC_G, CC_LE, CC_GE, CC_E, CC_NE};
+static const X86Condition x86Negated[16] = {
+    CC_NO, CC_O, CC_AE, CC_B, CC_NE, CC_E, CC_A, CC_BE, CC_NS, CC_S, CC_NP, CC_P, CC_GE, CC_L, CC_G, CC_LE
+};
+
+// Função para gerar uma comparação double; devolve a condição (flags de ucomisd)
+X86Condition x86CompareDouble(X86Generator *g, const IrInstr *instr) {
+    // a < b e a <= b comparam b com a para que NaN (CF = 1) resulte em falso
+    int swap = instr->op == IR_LT || instr->op == IR_LE;
+    VReg left = swap ? instr->src2 : instr->src1, right = swap ? instr->src1 : instr->src2;
+    x86LoadXmm(g, 0, left);
+    X86Operand r = x86Value(g, right);
+    x86Sse(g->as, 0x66, 0x2E, "ucomisd", 0, r);
+    switch (instr->op) {
+        case IR_LT: case IR_GT: return CC_A;
+        case IR_LE: case IR_GE: return CC_AE;
+        case IR_EQ: return CC_E;
+        default: return CC_NE;
+    }
+}
+
+// Função para gerar uma comparação; com 'branch' desvia em vez de produzir um bool
+void x86Compare(X86Generator *g, const IrInstr *instr, const IrInstr *branch) {
+    X86Asm *as = g->as;
+    X86Condition cc;
+    if (instr->type == IR_DOUBLE) {
+        cc = x86CompareDouble(g, instr);
+        if (instr->op == IR_EQ || instr->op == IR_NE) {
+            // Igualdade também olha a paridade (NaN é diferente de tudo)
+            x86Setcc(as, cc, RAX);
+            x86Setcc(as, instr->op == IR_EQ ? CC_NP : CC_P, RCX);
+            x86Alu(as, instr->op == IR_EQ ? ALU_AND : ALU_OR, x86Reg(RAX, 4), x86Reg(RCX, 4));
+            x86Movzx(as, RAX);
+            x86Store(g, instr->dst, RAX);
+            return;
+        }
+    } else if (instr->type == IR_STRING) {
+        x86Load(g, RDI, instr->src1);
+        x86Load(g, RSI, instr->src2);
+        x86CallRuntime(as, RT_STRING_EQUALS);
+        if (instr->op == IR_NE) {
+            x86Alu(as, ALU_XOR, x86Reg(RAX, 4), x86Imm(1));
+        }
+        x86Store(g, instr->dst, RAX);
+        return;
+    } else {
+        // Com o primeiro operando constante, a comparação é espelhada (a < b vira b > a)
+        static const uint8_t mirrored[6] = {1, 0, 3, 2, 4, 5};
+        int index = instr->op - IR_LT;
+        VReg a = instr->src1, b = instr->src2;
+        X86Operand right;
+        if (x86Folds(g, instr, 1)) {
+            right = x86Imm(g->constants[b]);
+        } else if (x86Folds(g, instr, 0)) {
+            right = x86Imm(g->constants[a]);
+            a = b;
+            index = mirrored[index];
+        } else {
+            right = x86Value(g, b);
+        }
+        X86Operand left = x86Value(g, a);
+        int size = instr->type == IR_REF ? 8 : 4;
+        if (left.kind != X86_REG && right.kind != X86_IMM) {
+            x86Load(g, RAX, a);
+            left = x86Reg(RAX, size);
+        }
+        left.size = (uint8_t)size;
+        if (right.kind != X86_IMM) {
+            right.size = (uint8_t)size;
+        }
+        x86Alu(as, ALU_CMP, left, right);
+        cc = x86IntConditions[index];
+    }
+    if (branch) {
+        uint32_t target = g->labels[branch->src2];
+        x86JumpIf(as, branch->op == IR_JUMP_IF ? cc : x86Negated[cc], target);
+        return;
+    }
+    x86Setcc(as, cc, RAX);
+    x86Movzx(as, RAX);
+    x86Store(g, instr->dst, RAX);
+}
+
+// Função para converter um valor em string (rtToString) quando necessário; resultado em rax
+void x86StringOperand(X86Generator *g, X86Operand src, uint8_t type) {
+    if (type == IR_STRING) {
+        x86Mov(g->as, x86Reg(RAX, 8), src);
+        return;
+    }
+    if (src.kind == X86_XMM) {
+        x86Movq(g->as, x86Reg(RDI, 8), src);
+    } else {
+        x86Mov(g->as, x86Reg(RDI, src.size), src);
+    }
+    x86Mov(g->as, x86Reg(RSI, 4), x86Imm(type));
+    x86CallRuntime(g->as, RT_TOSTRING);
+}
+
+// Função para gerar uma chamada da biblioteca
+void x86Builtin(X86Generator *g, const IrInstr *instr) {
+    X86Asm *as = g->as;
+    uint32_t argc = g->argCount;
+    const VReg *args = g->args;
+    int isDouble = instr->type == IR_DOUBLE;
+
+    switch ((IrBuiltin)instr->src1) {
+        case BUILTIN_PRINTF:
+        case BUILTIN_WRITE:
+        case BUILTIN_WRITELINE: {
+            // Argumentos como Value em [rsp + 8k] e os tipos em um vetor constante
+            int isPrintf = instr->src1 == BUILTIN_PRINTF;
+            uint32_t first = isPrintf && argc ? 1 : 0;
+            uint8_t types[IR_MAX_ARGUMENTS];
+            for (uint32_t i = first; i < argc; i++) {
+                types[i - first] = g->fn->vregTypes[args[i]];
+                x86StoreArgument(g, instr, i - first, args[i]);
+            }
+            uint32_t typeData = x86AddData(as, SECTION_RODATA, DATA_BYTES, types, argc - first ? argc - first : 1, 1);
+            if (isPrintf) {
+                if (argc) x86Load(g, RDI, args[0]);
+                else x86Mov(as, x86Reg(RDI, 4), x86Imm(0));
+                x86Lea(as, RSI, x86Mem(RSP, 0, 0));
+                x86Lea(as, RDX, x86Rip(typeData, 0));
+                x86Mov(as, x86Reg(RCX, 4), x86Imm(argc - first));
+                x86CallRuntime(as, RT_PRINTF);
+                x86Store(g, instr->dst, RAX);
+            } else {
+                x86Lea(as, RDI, x86Mem(RSP, 0, 0));
+                x86Lea(as, RSI, x86Rip(typeData, 0));
+                x86Mov(as, x86Reg(RDX, 4), x86Imm(argc));
+                x86Mov(as, x86Reg(RCX, 4), x86Imm(instr->src1 == BUILTIN_WRITELINE));
+                x86CallRuntime(as, RT_WRITE);
+            }
+            return;
+        }
+        case BUILTIN_SQRT:
+            if (argc != 1) break;
+            x86Sse(as, 0xF2, 0x51, "sqrtsd", 0, x86Value(g, args[0]));
+            x86StoreXmm(g, instr->dst, 0);
+            return;
+        case BUILTIN_ABS:
+            if (argc != 1) break;
+            if (isDouble) {
+                // Limpa o bit de sinal
+                X86Operand src = x86Value(g, args[0]);
+                if (src.kind == X86_XMM) x86Movq(as, x86Reg(RAX, 8), src);
+                else x86Mov(as, x86Reg(RAX, 8), src);
+                x86Btr(as, RAX, 63);
+                x86Movq(as, x86Xmm(0), x86Reg(RAX, 8));
+                x86StoreXmm(g, instr->dst, 0);
+            } else {
+                x86Load(g, RAX, args[0]);
+                x86Mov(as, x86Reg(RCX, 4), x86Reg(RAX, 4));
+                x86Unary(as, 3, x86Reg(RCX, 4));
+                x86Cmov(as, CC_S, x86Reg(RCX, 4), x86Reg(RAX, 4));
+                x86Store(g, instr->dst, RCX);
+            }
+            return;
+        case BUILTIN_POW:
+        case BUILTIN_MAX:
+        case BUILTIN_MIN:
+            if (argc != 2) break;
+            if (instr->src1 == BUILTIN_POW || isDouble) {
+                x86LoadXmm(g, 0, args[0]);
+                x86LoadXmm(g, 1, args[1]);
+                x86CallRuntime(as, instr->src1 == BUILTIN_POW ? RT_POW : instr->src1 == BUILTIN_MAX ? RT_FMAX : RT_FMIN);
+                x86StoreXmm(g, instr->dst, 0);
+            } else {
+                x86Load(g, RAX, args[0]);
+                X86Operand other = x86Value(g, args[1]);
+                if (other.kind != X86_REG) {
+                    x86Load(g, RCX, args[1]);
+                    other = x86Reg(RCX, 4);
+                }
+                other.size = 4;
+                x86Alu(as, ALU_CMP, x86Reg(RAX, 4), other);
+                x86Cmov(as, instr->src1 == BUILTIN_MAX ? CC_L : CC_G, x86Reg(RAX, 4), other);
+                x86Store(g, instr->dst, RAX);
+            }
+            return;
+        default:
+            break;
+    }
+    x86Error(g, "chamada da biblioteca não suportada");
+}
+
+// Função para gerar uma instrução; devolve 1 se consumiu também a seguinte
+int x86Instruction(X86Generator *g, const IrInstr *instr, const IrInstr *next) {
+    X86Asm *as = g->as;
+    switch (instr->op) {
+        case IR_NOP:
+            return 0;
+        case IR_LABEL:
+            x86Bind(as, g->labels[instr->src1]);
+            return 0;
+        case IR_ICONST: {
+            if (g->skipped[instr->dst]) {
+                return 0;
+            }
+            X86Operand d = x86Value(g, instr->dst);
+            if (d.kind == X86_REG && instr->src1 == 0) {
+                x86Alu(as, ALU_XOR, x86Reg(d.reg, 4), x86Reg(d.reg, 4));
+            } else {
+                x86Mov(as, d, x86Imm((int32_t)instr->src1));
+            }
+            return 0;
+        }
+        case IR_FCONST: {
+            double value = g->fn->floats[instr->src1];
+            uint32_t data = x86AddData(as, SECTION_RODATA, DATA_DOUBLE, &value, 8, 8);
+            X86Operand d = x86Value(g, instr->dst);
+            int reg = d.kind == X86_XMM ? d.reg : 0;
+            x86Sse(as, 0xF2, 0x10, "movsd", reg, x86Rip(data, 8));
+            x86StoreXmm(g, instr->dst, reg);
+            return 0;
+        }
+        case IR_SCONST: {
+            uint32_t data = x86AddString(as, irStringText(g->fn, instr->src1), g->fn->strings[instr->src1].length);
+            X86Operand d = x86Value(g, instr->dst);
+            int reg = d.kind == X86_REG ? d.reg : RAX;
+            x86Lea(as, reg, x86Rip(data, 0));
+            x86Store(g, instr->dst, reg);
+            return 0;
+        }
+        case IR_MOV:
+        case IR_I2F:
+        case IR_F2I: {
+            X86Operand d = x86Value(g, instr->dst);
+            if (instr->op == IR_I2F) {
+                int reg = d.kind == X86_XMM ? d.reg : 0;
+                x86Cvtsi2sd(as, reg, x86Value(g, instr->src1));
+                x86StoreXmm(g, instr->dst, reg);
+            } else if (instr->op == IR_F2I) {
+                int reg = d.kind == X86_REG ? d.reg : RAX;
+                x86Cvttsd2si(as, reg, x86Value(g, instr->src1));
+                x86Store(g, instr->dst, reg);
+            } else {
+                // Sem registrador intermediário quando um dos lados já está em registrador
+                X86Operand src = x86Value(g, instr->src1);
+                int isDouble = x86IsDouble(instr->type);
+                int reg = d.kind == (isDouble ? X86_XMM : X86_REG) ? d.reg :
+                          src.kind == (isDouble ? X86_XMM : X86_REG) ? src.reg : isDouble ? 0 : RAX;
+                if (isDouble) {
+                    x86LoadXmm(g, reg, instr->src1);
+                    x86StoreXmm(g, instr->dst, reg);
+                } else {
+                    x86Load(g, reg, instr->src1);
+                    x86Store(g, instr->dst, reg);
+                }
+            }
+            return 0;
+        }
+        case IR_ADD: case IR_SUB: case IR_MUL: case IR_DIV: case IR_MOD:
+            if (instr->type == IR_DOUBLE) {
+                if (instr->op == IR_MOD) {
+                    x86LoadXmm(g, 0, instr->src1);
+                    x86LoadXmm(g, 1, instr->src2);
+                    x86CallRuntime(as, RT_FMOD);
+                    x86StoreXmm(g, instr->dst, 0);
+                    return 0;
+                }
+                static const uint8_t opcodes[] = {0x58, 0x5C, 0x59, 0x5E};
+                static const char *names[] = {"addsd", "subsd", "mulsd", "divsd"};
+                X86Operand d = x86Value(g, instr->dst), right = x86Value(g, instr->src2);
+                int reg = d.kind == X86_XMM && !(right.kind == X86_XMM && right.reg == d.reg) ? d.reg : 0;
+                x86LoadXmm(g, reg, instr->src1);
+                x86Sse(as, 0xF2, opcodes[instr->op - IR_ADD], names[instr->op - IR_ADD], reg, right);
+                x86StoreXmm(g, instr->dst, reg);
+                return 0;
+            }
+            if (instr->op == IR_DIV || instr->op == IR_MOD) {
+                x86Divide(g, instr);
+            } else {
+                x86IntegerBinary(g, instr->op == IR_ADD ? ALU_ADD : instr->op == IR_SUB ? ALU_SUB : -1, instr);
+            }
+            return 0;
+        case IR_NEG:
+        case IR_NOT:
+            if (instr->type == IR_DOUBLE) {
+                X86Operand src = x86Value(g, instr->src1);
+                if (src.kind == X86_XMM) x86Movq(as, x86Reg(RAX, 8), src);
+                else x86Mov(as, x86Reg(RAX, 8), src);
+                x86Mov(as, x86Reg(RCX, 8), x86Imm(INT64_MIN));
+                x86Alu(as, ALU_XOR, x86Reg(RAX, 8), x86Reg(RCX, 8));
+                x86Movq(as, x86Xmm(0), x86Reg(RAX, 8));
+                x86StoreXmm(g, instr->dst, 0);
+            } else {
+                x86Load(g, RAX, instr->src1);
+                if (instr->op == IR_NEG) x86Unary(as, 3, x86Reg(RAX, 4));
+                else x86Alu(as, ALU_XOR, x86Reg(RAX, 4), x86Imm(1));
+                x86Store(g, instr->dst, RAX);
+            }
+            return 0;
+        case IR_LT: case IR_GT: case IR_LE: case IR_GE: case IR_EQ: case IR_NE:
+            if ((vmIsInteger(instr->type) || instr->type == IR_REF ||
+                 (instr->type == IR_DOUBLE && instr->op != IR_EQ && instr->op != IR_NE)) && next &&
+                (next->op == IR_JUMP_IF || next->op == IR_JUMP_IFNOT) && next->src1 == instr->dst &&
+                g->uses[instr->dst] == 1) {
+                x86Compare(g, instr, next);
+                return 1;
+            }
+            x86Compare(g, instr, NULL);
+            return 0;
+        case IR_CONCAT: {
+            const uint8_t *types = g->fn->vregTypes;
+            X86Operand right = x86Value(g, instr->src2);
+            if (types[instr->src1] != IR_STRING &&
+                (right.kind == X86_XMM || (right.kind == X86_REG && (right.reg == R10 || right.reg == R11)))) {
+                // A conversão do primeiro operando é uma chamada: o segundo não pode ficar em um registrador volátil
+                X86Operand saved = x86Mem(RBP, g->tempOffset + 8, right.size);
+                if (right.kind == X86_XMM) x86StoreSd(as, saved, right.reg);
+                else x86Mov(as, saved, right);
+                right = saved;
+            }
+            x86StringOperand(g, x86Value(g, instr->src1), types[instr->src1]);
+            x86Mov(as, x86Mem(RBP, g->tempOffset, 8), x86Reg(RAX, 8));
+            x86StringOperand(g, right, types[instr->src2]);
+            x86Mov(as, x86Reg(RSI, 8), x86Reg(RAX, 8));
+            x86Mov(as, x86Reg(RDI, 8), x86Mem(RBP, g->tempOffset, 8));
+            x86CallRuntime(as, RT_CONCAT);
+            x86Store(g, instr->dst, RAX);
+            return 0;
+        }
+        case IR_LOAD_GLOBAL: {
+            X86Operand d = x86Value(g, instr->dst);
+            if (x86IsDouble(g->fn->vregTypes[instr->dst])) {
+                int reg = d.kind == X86_XMM ? d.reg : 0;
+                x86Sse(as, 0xF2, 0x10, "movsd", reg, x86Global(instr->src1));
+                x86StoreXmm(g, instr->dst, reg);
+            } else {
+                int reg = d.kind == X86_REG ? d.reg : RAX;
+                x86Mov(as, x86Reg(reg, 8), x86Global(instr->src1));
+                x86Store(g, instr->dst, reg);
+            }
+            return 0;
+        }
+        case IR_STORE_GLOBAL:
+            x86StoreValue(g, x86Global(instr->src1), instr->src2, x86Folds(g, instr, 1));
+            return 0;
+        case IR_NEW_ARRAY:
+            x86Load(g, RDI, instr->src1);
+            x86Mov(as, x86Reg(RSI, 4), x86Imm(instr->type));
+            x86Lea(as, RDX, x86Rip(g->nameData, 0));
+            x86CallRuntime(as, RT_NEW_ARRAY);
+            x86Store(g, instr->dst, RAX);
+            return 0;
+        case IR_LOAD_INDEX:
+        case IR_STORE_INDEX:
+        case IR_LENGTH: {
+            x86Load(g, RCX, instr->src1);
+            X86Operand array = x86Reg(RCX, 8);
+            x86Test(as, array, array);
+            x86JumpIf(as, CC_E, x86FailLabel(g, FAIL_NULL));
+            X86Operand length = x86Mem(RCX, offsetof(VmArray, length), 4);
+            if (instr->op == IR_LENGTH) {
+                X86Operand d = x86Value(g, instr->dst);
+                int reg = d.kind == X86_REG ? d.reg : RAX;
+                x86Mov(as, x86Reg(reg, 4), length);
+                x86Store(g, instr->dst, reg);
+                return 0;
+            }
+            x86Load(g, RDX, instr->src2);
+            x86Alu(as, ALU_CMP, x86Reg(RDX, 4), length);
+            x86JumpIf(as, CC_AE, x86FailLabel(g, FAIL_INDEX));
+            X86Operand item = x86MemIndex(RCX, RDX, 8, offsetof(VmArray, items), 8);
+            int isDouble = x86IsDouble(g->fn->vregTypes[instr->dst]);
+            if (instr->op == IR_LOAD_INDEX) {
+                if (isDouble) {
+                    x86Sse(as, 0xF2, 0x10, "movsd", 0, item);
+                    x86StoreXmm(g, instr->dst, 0);
+                } else {
+                    x86Mov(as, x86Reg(RAX, 8), item);
+                    x86Store(g, instr->dst, RAX);
+                }
+            } else {
+                x86StoreValue(g, item, instr->dst, x86Folds(g, instr, 2));
+            }
+            return 0;
+        }
+        case IR_ARG:
+            g->args[g->argCount++] = instr->src1;
+            return 0;
+        case IR_CALL:
+            for (uint32_t i = 0; i < g->argCount; i++) {
+                x86StoreArgument(g, instr, i, g->args[i]);
+            }
+            x86CallLabel(as, g->functionLabels[instr->src1]);
+            if (instr->dst) {
+                if (x86IsDouble(instr->type)) x86StoreXmm(g, instr->dst, 0);
+                else x86Store(g, instr->dst, RAX);
+            }
+            g->argCount = 0;
+            return 0;
+        case IR_CALL_BUILTIN:
+            x86Builtin(g, instr);
+            g->argCount = 0;
+            return 0;
+        case IR_RET:
+            if (instr->src1) {
+                if (x86IsDouble(g->fn->vregTypes[instr->src1])) x86LoadXmm(g, 0, instr->src1);
+                else x86Load(g, RAX, instr->src1);
+            }
+            if (next) {
+                x86Jump(as, g->epilogue);
+            }
+            return 0;
+        case IR_JUMP:
+            x86Jump(as, g->labels[instr->src1]);
+            return 0;
+        case IR_JUMP_IF:
+        case IR_JUMP_IFNOT: {
+            X86Operand condition = x86Value(g, instr->src1);
+            if (condition.kind != X86_REG) {
+                x86Load(g, RAX, instr->src1);
+                condition = x86Reg(RAX, 4);
+            }
+            x86Test(as, condition, condition);
+            x86JumpIf(as, instr->op == IR_JUMP_IF ? CC_NE : CC_E, g->labels[instr->src2]);
+            return 0;
+        }
+        default:
+            x86Error(g, "instrução não suportada (a função ainda está na forma SSA?)");
+            return 0;
+    }
+}
+
+// Função para gerar uma função
+int x86Function(X86Asm *as, const IrModule *module, uint32_t index, const uint32_t *functionLabels, X86Stats *stats) {
+    const IrFunction *fn = &module->functions[index];
+    X86Generator g;
+    memset(&g, 0, sizeof(g));
+    g.as = as;
+    g.module = module;
+    g.fn = fn;
+    g.functionLabels = functionLabels;
+    memset(g.failLabels, 0xFF, sizeof(g.failLabels));
+
+    // Usos e constantes inteiras definidas uma única vez (fora da forma SSA um registrador pode ter várias definições)
+    g.uses = optCalloc(fn->vregCount, sizeof(uint32_t));
+    g.isConstant = optCalloc(fn->vregCount, 1);
+    g.constants = optCalloc(fn->vregCount, sizeof(int32_t));
+    g.skipped = optCalloc(fn->vregCount, 1);
+    uint32_t *definitions = optCalloc(fn->vregCount, sizeof(uint32_t));
+    uint32_t *folded = optCalloc(fn->vregCount, sizeof(uint32_t));
+    uint32_t maxArgs = 0, argCount = 0;
+    for (uint32_t i = 0; i < fn->count; i++) {
+        const IrInstr *instr = &fn->code[i];
+        VReg uses[3];
+        int count = irUses(instr, uses);
+        for (int k = 0; k < count; k++) {
+            g.uses[uses[k]]++;
+        }
+        VReg def = irDefinition(instr);
+        if (def && definitions[def]++ == 0 && instr->op == IR_ICONST) {
+            g.isConstant[def] = 1;
+            g.constants[def] = (int32_t)instr->src1;
+        } else if (def) {
+            g.isConstant[def] = 0;
+        }
+        argCount = instr->op == IR_ARG ? argCount + 1 : 0;
+        if (argCount > maxArgs) {
+            maxArgs = argCount;
+        }
+    }
+    for (uint32_t i = 0; i < fn->count; i++) {
+        const IrInstr *instr = &fn->code[i];
+        if (instr->op == IR_CALL || instr->op == IR_CALL_BUILTIN) {
+            // Os argumentos precedem a chamada
+            for (uint32_t k = 0; k < instr->src2 && k < i; k++) {
+                VReg v = fn->code[i - 1 - k].src1;
+                folded[v] += x86FoldsArgument(&g, instr, v);
+            }
+        } else {
+            for (int slot = 0; slot < 3; slot++) {
+                if (x86Folds(&g, instr, slot)) {
+                    folded[slot == 0 ? instr->src1 : slot == 1 ? instr->src2 : instr->dst]++;
+                }
+            }
+        }
+    }
+    for (VReg v = 1; v < fn->vregCount; v++) {
+        g.skipped[v] = g.isConstant[v] && folded[v] == g.uses[v];
+    }
+    free(definitions);
+    free(folded);
+
+    x86Allocate(fn, g.skipped, &g.allocation);
+    stats->intervals += g.allocation.intervals;
+    stats->spilled += g.allocation.spilled;
+
+    // Quadro: rbp salvo, registradores preservados, posições da pilha, temporárias e argumentos de saída
+    int saved = 0;
+    for (size_t k = 0; k < sizeof(x86CalleeSaved); k++) {
+        saved += (g.allocation.savedMask >> x86CalleeSaved[k]) & 1;
+    }
+    g.savedBytes = 8 * saved;
+    for (VReg v = 1; v < fn->vregCount; v++) {
+        X86Location *location = &g.allocation.locations[v];
+        if (location->kind == LOC_STACK && location->offset < 0) {
+            location->offset -= g.savedBytes;
+        }
+    }
+    int32_t locals = 8 * (int32_t)g.allocation.spillSlots + 16;
+    g.tempOffset = -g.savedBytes - locals;
+    int32_t frame = locals + 8 * (int32_t)maxArgs;
+    if ((g.savedBytes + frame) % 16) {
+        frame += 8;
+    }
+
+    g.labels = optCalloc(fn->labelCount ? fn->labelCount : 1, sizeof(uint32_t));
+    for (uint32_t i = 0; i < fn->labelCount; i++) {
+        g.labels[i] = x86NewLabel(as);
+    }
+    g.epilogue = x86NewLabel(as);
+    g.nameData = x86AddString(as, fn->name, fn->nameLength);
+
+    // Prólogo
+    if (as->text) {
+        fprintf(as->text, "\n    .type ");
+        x86PrintLabel(as, functionLabels[index]);
+        fputs(", @function\n", as->text);
+    }
+    x86Align(as, 16);
+    x86Bind(as, functionLabels[index]);
+    x86PushPop(as, RBP, 0);
+    x86Mov(as, x86Reg(RBP, 8), x86Reg(RSP, 8));
+    for (size_t k = 0; k < sizeof(x86CalleeSaved); k++) {
+        if ((g.allocation.savedMask >> x86CalleeSaved[k]) & 1) {
+            x86PushPop(as, x86CalleeSaved[k], 0);
+        }
+    }
+    x86Alu(as, ALU_SUB, x86Reg(RSP, 8), x86Imm(frame));
+
+    // Parâmetros: lidos de [rbp + 16 + 8k] para o registrador alocado
+    for (VReg v = 1; v <= fn->paramCount && v < fn->vregCount; v++) {
+        X86Location *location = &g.allocation.locations[v];
+        X86Operand incoming = x86Mem(RBP, 16 + 8 * (int32_t)(v - 1), 8);
+        if (location->kind == LOC_REG) {
+            x86Mov(as, x86Reg(location->reg, 8), incoming);
+        } else if (location->kind == LOC_XMM) {
+            x86Sse(as, 0xF2, 0x10, "movsd", location->reg, incoming);
+        }
+    }
+
+    for (uint32_t i = 0; i < fn->count; i++) {
+        i += x86Instruction(&g, &fn->code[i], i + 1 < fn->count ? &fn->code[i + 1] : NULL);
+    }
+
+    // Epílogo
+    x86Bind(as, g.epilogue);
+    x86Lea(as, RSP, x86Mem(RBP, -g.savedBytes, 0));
+    for (int k = (int)sizeof(x86CalleeSaved) - 1; k >= 0; k--) {
+        if ((g.allocation.savedMask >> x86CalleeSaved[k]) & 1) {
+            x86PushPop(as, x86CalleeSaved[k], 1);
+        }
+    }
+    x86PushPop(as, RBP, 1);
+    x86Simple(as, 0xC3, "ret");
+
+    // Falhas: rtFail(código, nome da função) não retorna
+    for (int failure = 0; failure < FAIL_COUNT; failure++) {
+        if (g.failLabels[failure] != OPT_NONE) {
+            x86Bind(as, g.failLabels[failure]);
+            x86Mov(as, x86Reg(RDI, 4), x86Imm(failure));
+            x86Lea(as, RSI, x86Rip(g.nameData, 0));
+            x86CallRuntime(as, RT_FAIL);
+        }
+    }
+
+    free(g.labels);
+    free(g.uses);
+    free(g.isConstant);
+    free(g.constants);
+    free(g.skipped);
+    free(g.allocation.locations);
+    return g.errorCount;
+}
+
+
+// Função para criar os dados globais, os símbolos e a entrada do programa; devolve os rótulos das funções
+uint32_t *x86GenerateEntry(X86Asm *as, const IrModule *module) {
+    uint32_t *functionLabels = optCalloc(module->functionCount + 1, sizeof(uint32_t));
+
+    // Dado 0: variáveis globais
+    x86AddData(as, SECTION_BSS, DATA_GLOBALS, NULL, 8 * (module->globalCount ? module->globalCount : 1), 16);
+
+    uint32_t entry = x86AddSymbol(as, "", X86_ENTRY_SYMBOL, (uint32_t)strlen(X86_ENTRY_SYMBOL), 1);
+    for (uint32_t i = 0; i < module->functionCount; i++) {
+        char prefix[16];
+        snprintf(prefix, sizeof(prefix), "f%u_", i);
+        functionLabels[i] = x86AddSymbol(as, prefix, module->functions[i].name, module->functions[i].nameLength, 0);
+    }
+
+    if (as->text) {
+        fprintf(as->text, "    .intel_syntax noprefix\n    .text\n    .globl %s\n", X86_ENTRY_SYMBOL);
+    }
+
+    // programa_executar: inicialização dos campos, Main (com args nulo) e código de saída em eax
+    if (as->text) {
+        fprintf(as->text, "\n    .p2align 4\n    .type %s, @function\n", X86_ENTRY_SYMBOL);
+    }
+    x86Bind(as, entry);
+    x86PushPop(as, RBP, 0);
+    x86Mov(as, x86Reg(RBP, 8), x86Reg(RSP, 8));
+    x86Alu(as, ALU_SUB, x86Reg(RSP, 8), x86Imm(16));
+    x86Mov(as, x86Mem(RSP, 0, 8), x86Imm(0));
+    if (module->functionCount) {
+        x86CallLabel(as, functionLabels[0]);
+    }
+    if (module->entry >= 0) {
+        x86CallLabel(as, functionLabels[module->entry]);
+    }
+    if (module->entry < 0 || module->functions[module->entry].returnType != IR_INT) {
+        x86Alu(as, ALU_XOR, x86Reg(RAX, 4), x86Reg(RAX, 4));
+    }
+    x86Mov(as, x86Reg(RSP, 8), x86Reg(RBP, 8));
+    x86PushPop(as, RBP, 1);
+    x86Simple(as, 0xC3, "ret");
+    return functionLabels;
+}
+
+// Função para gerar o módulo inteiro (já fora da forma SSA); devolve o número de erros
+int x86Generate(X86Asm *as, const IrModule *module, X86Stats *stats) {
+    int errors = 0;
+    memset(stats, 0, sizeof(*stats));
+    uint32_t *functionLabels = x86GenerateEntry(as, module);
+    for (uint32_t i = 0; i < module->functionCount; i++) {
+        errors += x86Function(as, module, i, functionLabels, stats);
+        stats->functions++;
+    }
+    x86ResolveLabels(as);
+    free(functionLabels);
+    return errors;
+}
+
+// Função para escrever os dados no texto do montador
+void x86PrintData(const X86Asm *as) {
+    FILE *out = as->text;
+    fputs("\n    .section .rodata\n", out);
+    for (uint32_t i = 0; i < as->dataCount; i++) {
+        const X86Data *data = &as->data[i];
+        const uint8_t *bytes = as->rodata + data->offset;
+        if (data->section != SECTION_RODATA) {
+            continue;
+        }
+        fprintf(out, "    .p2align %d\n.LD%u:\n", data->kind == DATA_BYTES ? 0 : 3, i);
+        if (data->kind == DATA_STRING) {
+            uint32_t length;
+            memcpy(&length, bytes + offsetof(VmString, length), sizeof(length));
+            fprintf(out, "    .quad 0\n    .long %u\n    .string \"", length);
+            for (uint32_t k = 0; k < length; k++) {
+                unsigned char c = bytes[offsetof(VmString, data) + k];
+                if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+                else if (c >= 32 && c < 127) fputc(c, out);
+                else fprintf(out, "\\%03o", c);
+            }
+            fputs("\"\n", out);
+        } else if (data->kind == DATA_DOUBLE) {
+            uint64_t bits;
+            memcpy(&bits, bytes, sizeof(bits));
+            fprintf(out, "    .quad 0x%016llx\n", (unsigned long long)bits);
+        } else {
+            fputs("    .byte ", out);
+            for (uint32_t k = 0; k < data->size; k++) {
+                fprintf(out, "%s%u", k ? ", " : "", bytes[k]);
+            }
+            fputc('\n', out);
+        }
+    }
+    fprintf(out, "\n    .bss\n    .p2align 4\n.LD0:\n    .zero %u\n", as->data[0].size);
+    fputs("\n    .section .note.GNU-stack,\"\",@progbits\n", out);
+}
+
+// ---------------------------------------------------------------------------
+// Objeto ELF relocável
+// ---------------------------------------------------------------------------
+
+// Função para acrescentar um nome a uma tabela de strings; devolve o deslocamento
+uint32_t elfAddName(char **table, uint32_t *size, uint32_t *capacity, const char *name) {
+    uint32_t length = (uint32_t)strlen(name) + 1;
+    *table = vectorGrow(*table, capacity, *size + length, 1);
+    memcpy(*table + *size, name, length);
+    *size += length;
+    return *size - length;
+}
+
+// Função para gravar o objeto ELF; devolve 0 em caso de sucesso
+int x86WriteElf(const X86Asm *as, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Erro: Não foi possível criar o arquivo %s\n", path);
+        return -1;
+    }
+
+    // Seções
+    enum { S_NULL, S_TEXT, S_RODATA, S_BSS, S_RELA, S_SYMTAB, S_STRTAB, S_SHSTRTAB, S_NOTE, S_COUNT };
+    static const char *sectionNames[S_COUNT] = {
+        "", ".text", ".rodata", ".bss", ".rela.text", ".symtab", ".strtab", ".shstrtab", ".note.GNU-stack"
+    };
+    char *shstrtab = NULL, *strtab = NULL;
+    uint32_t shstrSize = 0, shstrCapacity = 0, strSize = 0, strCapacity = 0;
+    uint32_t sectionName[S_COUNT];
+    for (int s = 0; s < S_COUNT; s++) {
+        sectionName[s] = elfAddName(&shstrtab, &shstrSize, &shstrCapacity, sectionNames[s]);
+    }
+    elfAddName(&strtab, &strSize, &strCapacity, "");
+
+    // Símbolos: nulo, seções, funções locais, depois os globais (entrada e funções externas)
+    uint32_t symbolCapacity = 4 + as->symbolCount + RT_COUNT;
+    Elf64_Sym *symbols = optCalloc(symbolCapacity, sizeof(Elf64_Sym));
+    uint32_t symbolCount = 1;
+    for (int s = S_TEXT; s <= S_BSS; s++) {
+        symbols[symbolCount].st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+        symbols[symbolCount++].st_shndx = (uint16_t)s;
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint32_t i = 0; i < as->symbolCount; i++) {
+            const X86Symbol *symbol = &as->symbols[i];
+            if (symbol->global != pass) {
+                continue;
+            }
+            Elf64_Sym *sym = &symbols[symbolCount++];
+            sym->st_name = elfAddName(&strtab, &strSize, &strCapacity, symbol->name);
+            sym->st_info = ELF64_ST_INFO(pass ? STB_GLOBAL : STB_LOCAL, STT_FUNC);
+            sym->st_shndx = S_TEXT;
+            sym->st_value = as->labels[symbol->label];
+        }
+    }
+    uint32_t firstGlobal = 4;
+    for (uint32_t i = 0; i < as->symbolCount; i++) {
+        firstGlobal += !as->symbols[i].global;
+    }
+    uint32_t externalBase = symbolCount;
+    for (int r = 0; r < RT_COUNT; r++) {
+        Elf64_Sym *sym = &symbols[symbolCount++];
+        sym->st_name = elfAddName(&strtab, &strSize, &strCapacity, x86RuntimeNames[r]);
+        sym->st_info = ELF64_ST_INFO(STB_GLOBAL, STT_NOTYPE);
+        sym->st_shndx = SHN_UNDEF;
+    }
+
+    // Relocações
+    Elf64_Rela *relas = optCalloc(as->relocCount + 1, sizeof(Elf64_Rela));
+    for (uint32_t i = 0; i < as->relocCount; i++) {
+        const X86Reloc *reloc = &as->relocs[i];
+        relas[i].r_offset = reloc->at;
+        if (reloc->kind == RELOC_CALL) {
+            relas[i].r_info = ELF64_R_INFO(externalBase + reloc->target, R_X86_64_PLT32);
+            relas[i].r_addend = reloc->addend;
+        } else {
+            const X86Data *data = &as->data[reloc->target];
+            relas[i].r_info = ELF64_R_INFO(data->section == SECTION_BSS ? S_BSS : S_RODATA, R_X86_64_PC32);
+            relas[i].r_addend = (int64_t)data->offset + reloc->addend;
+        }
+    }
+
+    // Disposição do arquivo
+    Elf64_Shdr sections[S_COUNT];
+    memset(sections, 0, sizeof(sections));
+    uint64_t offset = sizeof(Elf64_Ehdr);
+    struct { int section; const void *bytes; uint64_t size; uint64_t align; } parts[] = {
+        {S_TEXT, as->code, as->size, 16},
+        {S_RODATA, as->rodata, as->rodataSize, 16},
+        {S_RELA, relas, (uint64_t)as->relocCount * sizeof(Elf64_Rela), 8},
+        {S_SYMTAB, symbols, (uint64_t)symbolCount * sizeof(Elf64_Sym), 8},
+        {S_STRTAB, strtab, strSize, 1},
+        {S_SHSTRTAB, shstrtab, shstrSize, 1},
+    };
+    uint8_t zeros[16] = {0};
+    Elf64_Ehdr header;
+    memset(&header, 0, sizeof(header));
+    fwrite(&header, sizeof(header), 1, file);
+    for (size_t p = 0; p < sizeof(parts) / sizeof(parts[0]); p++) {
+        uint64_t aligned = (offset + parts[p].align - 1) & ~(parts[p].align - 1);
+        fwrite(zeros, 1, aligned - offset, file);
+        fwrite(parts[p].bytes, 1, parts[p].size, file);
+        sections[parts[p].section].sh_offset = aligned;
+        sections[parts[p].section].sh_size = parts[p].size;
+        sections[parts[p].section].sh_addralign = parts[p].align;
+        offset = aligned + parts[p].size;
+    }
+    for (int s = 0; s < S_COUNT; s++) {
+        sections[s].sh_name = sectionName[s];
+    }
+    sections[S_TEXT].sh_type = SHT_PROGBITS;
+    sections[S_TEXT].sh_flags = SHF_ALLOC | SHF_EXECINSTR;
+    sections[S_RODATA].sh_type = SHT_PROGBITS;
+    sections[S_RODATA].sh_flags = SHF_ALLOC;
+    sections[S_BSS].sh_type = SHT_NOBITS;
+    sections[S_BSS].sh_flags = SHF_ALLOC | SHF_WRITE;
+    sections[S_BSS].sh_size = as->bssSize;
+    sections[S_BSS].sh_addralign = 16;
+    sections[S_BSS].sh_offset = offset;
+    sections[S_RELA].sh_type = SHT_RELA;
+    sections[S_RELA].sh_flags = SHF_INFO_LINK;
+    sections[S_RELA].sh_link = S_SYMTAB;
+    sections[S_RELA].sh_info = S_TEXT;
+    sections[S_RELA].sh_entsize = sizeof(Elf64_Rela);
+    sections[S_SYMTAB].sh_type = SHT_SYMTAB;
+    sections[S_SYMTAB].sh_link = S_STRTAB;
+    sections[S_SYMTAB].sh_info = firstGlobal;
+    sections[S_SYMTAB].sh_entsize = sizeof(Elf64_Sym);
+    sections[S_STRTAB].sh_type = SHT_STRTAB;
+    sections[S_SHSTRTAB].sh_type = SHT_STRTAB;
+    sections[S_NOTE].sh_type = SHT_PROGBITS;
+    sections[S_NOTE].sh_offset = offset;
+    sections[S_NOTE].sh_addralign = 1;
+
+    uint64_t sectionOffset = (offset + 7) & ~7ull;
+    fwrite(zeros, 1, sectionOffset - offset, file);
+    fwrite(sections, sizeof(Elf64_Shdr), S_COUNT, file);
+
+    memcpy(header.e_ident, ELFMAG, SELFMAG);
+    header.e_ident[EI_CLASS] = ELFCLASS64;
+    header.e_ident[EI_DATA] = ELFDATA2LSB;
+    header.e_ident[EI_VERSION] = EV_CURRENT;
+    header.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    header.e_type = ET_REL;
+    header.e_machine = EM_X86_64;
+    header.e_version = EV_CURRENT;
+    header.e_shoff = sectionOffset;
+    header.e_ehsize = sizeof(Elf64_Ehdr);
+    header.e_shentsize = sizeof(Elf64_Shdr);
+    header.e_shnum = S_COUNT;
+    header.e_shstrndx = S_SHSTRTAB;
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+
+    int status = ferror(file) ? -1 : 0;
+    fclose(file);
+    free(symbols);
+    free(relas);
+    free(strtab);
+    free(shstrtab);
+    return status;
+}
+
+#endif
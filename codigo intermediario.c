@@ -0,0 +1,62 @@
+/*
+ * Programa do código intermediário
+ *
+ * Lê o arquivo de entrada, executa as análises léxica, sintática e
+ * semântica e exibe o código de três endereços gerado
+ * (codigo intermediario.h) com o tamanho ocupado pelas instruções.
+ */
+
+#include "codigo intermediario.h"
+
+// Função principal
+int main(int argc, char *argv[]) {
+    const char *path = (argc > 1) ? argv[1] : "../input.txt";
+
+    // Ler todo o conteúdo do arquivo fonte
+    char *code = readSourceFile(path, NULL);
+    if (!code) {
+        return EXIT_FAILURE;
+    }
+
+    // Analisar o código
+    printf("Analisando código do arquivo: %s\n", path);
+    lexicalAnalysis(code);
+
+    Ast ast;
+    Parser parser;
+    astInit(&ast, code, tokenCount);
+    parserInit(&parser, &ast, tokens, tokenCount);
+    parseProgram(&parser);
+
+    int status = EXIT_FAILURE;
+    Checker checker;
+    if (parser.errorCount) {
+        printf("\n%d erro(s) sintático(s); código intermediário não gerado.\n", parser.errorCount);
+    } else if (semanticAnalysis(&checker, &ast, NULL)) {
+        printf("\n%d erro(s) semântico(s); código intermediário não gerado.\n", checker.errorCount);
+    } else {
+        IrModule module;
+        IrGenerator generator;
+        int errors = generateIr(&generator, &module, &ast);
+        printf("\nCódigo intermediário:\n");
+        irPrintModule(stdout, &module);
+
+        uint32_t instructions = 0, registers = 0;
+        for (uint32_t i = 0; i < module.functionCount; i++) {
+            instructions += module.functions[i].count;
+            registers += module.functions[i].vregCount - 1;
+        }
+        printf("\n%u função(ões), %u instruções (%zu bytes), %u registradores virtuais\n",
+               module.functionCount, instructions, instructions * sizeof(IrInstr), registers);
+        printf("%d erro(s) na geração de código.\n", errors);
+        status = errors ? EXIT_FAILURE : EXIT_SUCCESS;
+        irModuleFree(&module);
+    }
+
+    // Limpar memória
+    astFree(&ast);
+    freeTokens();
+    freeLineIndex();
+    free(code);
+    return status;
+}
@@ -0,0 +1,1334 @@
+/*
+ * Código Intermediário (código de três endereços)
+ *
+ * Traduz a AST verificada pela análise semântica em uma representação
+ * intermediária linear: cada método vira uma IrFunction com um vetor
+ * contíguo de instruções de tamanho fixo, que os passos seguintes
+ * (otimização e geração de código) percorrem sequencialmente.
+ *
+ * Estruturas principais:
+ * - IrInstr: Instrução de 16 bytes (opcode, tipo, destino e dois operandos).
+ *   Os operandos são registradores virtuais (VReg, 32 bits) ou, conforme o
+ *   opcode, imediatos, rótulos e índices nas tabelas da função ou do módulo
+ * - irOpcodeInfo: Tabela com o nome e a forma dos operandos de cada opcode;
+ *   impressão e análises consultam a tabela em vez de tratar cada opcode
+ * - IrFunction: Instruções, tipos dos registradores e tabelas de constantes
+ *   (double e strings) próprias da função, sem estado compartilhado
+ * - IrModule: Funções e variáveis globais do programa
+ *
+ * Convenções:
+ * - O registrador 0 significa "nenhum"; os parâmetros são v1..vN
+ * - Variáveis locais e parâmetros ocupam um registrador fixo e podem ser
+ *   atribuídos várias vezes (a forma SSA é construída depois); valores
+ *   intermediários recebem registradores novos
+ * - Desvios usam rótulos (IR_LABEL) numerados por função
+ * - Os argumentos de uma chamada são as IR_ARG imediatamente anteriores
+ * - A função 0 inicializa os campos; 'entry' indica Main/main
+ *
+ * Limitações:
+ * - Objetos não são modelados: campos são variáveis globais e
+ *   'new Classe(...)' apenas executa o construtor
+ * - Não há exceções: o bloco 'try' é gerado e os 'catch' são descartados
+ * - float é representado como double
+ */
+
+#ifndef CODIGO_INTERMEDIARIO_H
+#define CODIGO_INTERMEDIARIO_H
+
+#include "analise semantica.h"
+#include "vetor dinamico.h"
+
+#define IR_MAX_ARGUMENTS 64
+
+typedef uint32_t VReg;  // Registrador virtual (0 = nenhum)
+
+// Enumeração para tipos dos registradores
+typedef enum {
+    IR_VOID,
+    IR_INT,
+    IR_BOOL,
+    IR_CHAR,
+    IR_DOUBLE,
+    IR_STRING,
+    IR_REF      // Vetores e objetos
+} IrType;
+
+// Enumeração para os opcodes (na ordem de irOpcodeInfo)
+typedef enum {
+    IR_NOP,
+    IR_ICONST,        // dst = src1 (imediato de 32 bits)
+    IR_FCONST,        // dst = floats[src1]
+    IR_SCONST,        // dst = strings[src1]
+    IR_MOV,           // dst = src1
+    IR_ADD,           // dst = src1 op src2
+    IR_SUB,
+    IR_MUL,
+    IR_DIV,
+    IR_MOD,
+    IR_NEG,           // dst = op src1
+    IR_NOT,
+    IR_LT,            // dst = src1 op src2 (type = tipo dos operandos)
+    IR_GT,
+    IR_LE,
+    IR_GE,
+    IR_EQ,
+    IR_NE,
+    IR_I2F,           // dst = (double) src1
+    IR_F2I,           // dst = (int) src1
+    IR_CONCAT,        // dst = texto(src1) + texto(src2)
+    IR_LOAD_GLOBAL,   // dst = globals[src1]
+    IR_STORE_GLOBAL,  // globals[src1] = src2
+    IR_NEW_ARRAY,     // dst = novo vetor com src1 elementos (type = tipo dos elementos)
+    IR_LOAD_INDEX,    // dst = src1[src2]
+    IR_STORE_INDEX,   // src1[src2] = dst (dst é lido)
+    IR_LENGTH,        // dst = comprimento de src1 (vetor ou string)
+    IR_ARG,           // Argumento src1 da próxima chamada
+    IR_CALL,          // dst = functions[src1](src2 argumentos)
+    IR_CALL_BUILTIN,  // dst = builtin src1 (src2 argumentos)
+    IR_RET,           // Retorna src1 (0 = sem valor)
+    IR_LABEL,         // Rótulo src1
+    IR_JUMP,          // Desvia para o rótulo src1
+    IR_JUMP_IF,       // Se src1, desvia para o rótulo src2
+    IR_JUMP_IFNOT,    // Se não src1, desvia para o rótulo src2
+    IR_PHI,           // dst = phi(phiOperands[src1 .. src1 + src2)) (apenas na forma SSA)
+    IR_OPCODE_COUNT
+} IrOpcode;
+
+// Enumeração para funções da biblioteca
+typedef enum {
+    BUILTIN_PRINTF,
+    BUILTIN_WRITE,
+    BUILTIN_WRITELINE,
+    BUILTIN_SQRT,
+    BUILTIN_POW,
+    BUILTIN_ABS,
+    BUILTIN_MAX,
+    BUILTIN_MIN,
+    BUILTIN_COUNT
+} IrBuiltin;
+
+// Forma de um operando
+typedef enum {
+    OPND_NONE,
+    OPND_VREG,
+    OPND_IMM,
+    OPND_LABEL,
+    OPND_FLOAT,
+    OPND_STRING,
+    OPND_GLOBAL,
+    OPND_FUNCTION,
+    OPND_BUILTIN,
+    OPND_PHI,
+    OPND_COUNT
+} IrOperand;
+
+// Propriedades dos opcodes
+#define IRF_SIDE_EFFECT 0x01  // Não pode ser removida nem movida
+#define IRF_DST_READ    0x02  // dst é um operando lido, não definido
+#define IRF_BRANCH      0x04  // Desvio ou retorno (encerra um bloco básico)
+#define IRF_MAY_TRAP    0x08  // Pode falhar em tempo de execução (divisão por zero, índice)
+
+// Estrutura de uma instrução (16 bytes)
+typedef struct {
+    uint8_t op;       // IrOpcode
+    uint8_t type;     // IrType da operação
+    uint16_t flags;   // Livre para os passos de otimização
+    VReg dst;
+    uint32_t src1;
+    uint32_t src2;
+} IrInstr;
+
+_Static_assert(sizeof(IrInstr) == 16, "IrInstr deve ocupar 16 bytes");
+
+// Estrutura da descrição de um opcode
+typedef struct {
+    const char *name;
+    uint8_t dst, src1, src2;   // IrOperand
+    uint8_t properties;        // IRF_*
+} IrOpcodeInfo;
+
+static const IrOpcodeInfo irOpcodeInfo[IR_OPCODE_COUNT] = {
+    [IR_NOP]          = {"nop", OPND_NONE, OPND_NONE, OPND_NONE, 0},
+    [IR_ICONST]       = {"const", OPND_VREG, OPND_IMM, OPND_NONE, 0},
+    [IR_FCONST]       = {"const", OPND_VREG, OPND_FLOAT, OPND_NONE, 0},
+    [IR_SCONST]       = {"const", OPND_VREG, OPND_STRING, OPND_NONE, 0},
+    [IR_MOV]          = {"mov", OPND_VREG, OPND_VREG, OPND_NONE, 0},
+    [IR_ADD]          = {"add", OPND_VREG, OPND_VREG, OPND_VREG, 0},
+    [IR_SUB]          = {"sub", OPND_VREG, OPND_VREG, OPND_VREG, 0},
+    [IR_MUL]          = {"mul", OPND_VREG, OPND_VREG, OPND_VREG, 0},
+    [IR_DIV]          = {"div", OPND_VREG, OPND_VREG, OPND_VREG, IRF_MAY_TRAP},
+    [IR_MOD]          = {"mod", OPND_VREG, OPND_VREG, OPND_VREG, IRF_MAY_TRAP},
+    [IR_NEG]          = {"neg", OPND_VREG, OPND_VREG, OPND_NONE, 0},
+    [IR_NOT]          = {"not", OPND_VREG, OPND_VREG, OPND_NONE, 0},
+    [IR_LT]           = {"lt", OPND_VREG, OPND_VREG, OPND_VREG, 0},
+    [IR_GT]           = {"gt", OPND_VREG, OPND_VREG, OPND_VREG, 0},
+    [IR_LE]           = {"le", OPND_VREG, OPND_VREG, OPND_VREG, 0},
+    [IR_GE]           = {"ge", OPND_VREG, OPND_VREG, OPND_VREG, 0},
+    [IR_EQ]           = {"eq", OPND_VREG, OPND_VREG, OPND_VREG, 0},
+    [IR_NE]           = {"ne", OPND_VREG, OPND_VREG, OPND_VREG, 0},
+    [IR_I2F]          = {"i2f", OPND_VREG, OPND_VREG, OPND_NONE, 0},
+    [IR_F2I]          = {"f2i", OPND_VREG, OPND_VREG, OPND_NONE, 0},
+    [IR_CONCAT]       = {"concat", OPND_VREG, OPND_VREG, OPND_VREG, 0},
+    [IR_LOAD_GLOBAL]  = {"load", OPND_VREG, OPND_GLOBAL, OPND_NONE, 0},
+    [IR_STORE_GLOBAL] = {"store", OPND_NONE, OPND_GLOBAL, OPND_VREG, IRF_SIDE_EFFECT},
+    [IR_NEW_ARRAY]    = {"newarray", OPND_VREG, OPND_VREG, OPND_NONE, IRF_SIDE_EFFECT},
+    [IR_LOAD_INDEX]   = {"loadindex", OPND_VREG, OPND_VREG, OPND_VREG, IRF_MAY_TRAP},
+    [IR_STORE_INDEX]  = {"storeindex", OPND_VREG, OPND_VREG, OPND_VREG, IRF_SIDE_EFFECT | IRF_DST_READ | IRF_MAY_TRAP},
+    [IR_LENGTH]       = {"length", OPND_VREG, OPND_VREG, OPND_NONE, 0},
+    [IR_ARG]          = {"arg", OPND_NONE, OPND_VREG, OPND_NONE, IRF_SIDE_EFFECT},
+    [IR_CALL]         = {"call", OPND_VREG, OPND_FUNCTION, OPND_IMM, IRF_SIDE_EFFECT},
+    [IR_CALL_BUILTIN] = {"call", OPND_VREG, OPND_BUILTIN, OPND_IMM, IRF_SIDE_EFFECT},
+    [IR_RET]          = {"ret", OPND_NONE, OPND_VREG, OPND_NONE, IRF_SIDE_EFFECT | IRF_BRANCH},
+    [IR_LABEL]        = {"label", OPND_NONE, OPND_LABEL, OPND_NONE, IRF_SIDE_EFFECT},
+    [IR_JUMP]         = {"jump", OPND_NONE, OPND_LABEL, OPND_NONE, IRF_SIDE_EFFECT | IRF_BRANCH},
+    [IR_JUMP_IF]      = {"jumpif", OPND_NONE, OPND_VREG, OPND_LABEL, IRF_SIDE_EFFECT | IRF_BRANCH},
+    [IR_JUMP_IFNOT]   = {"jumpifnot", OPND_NONE, OPND_VREG, OPND_LABEL, IRF_SIDE_EFFECT | IRF_BRANCH},
+    [IR_PHI]          = {"phi", OPND_VREG, OPND_PHI, OPND_NONE, 0},
+};
+
+static const char *irBuiltinNames[BUILTIN_COUNT] = {
+    "printf", "Console.Write", "Console.WriteLine", "Math.Sqrt", "Math.Pow",
+    "Math.Abs", "Math.Max", "Math.Min"
+};
+
+// Estrutura de uma constante string (bytes já decodificados em 'data')
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+} IrString;
+
+// Estrutura de um operando de phi: o valor que chega pelo bloco predecessor com o rótulo 'label'
+typedef struct {
+    uint32_t label;
+    VReg value;
+} IrPhiOperand;
+
+// Estrutura de uma função
+typedef struct {
+    const char *name;     // Trecho do código fonte (não terminado em '\0')
+    uint32_t nameLength;
+    NodeId decl;          // Nó METHOD (0 na função de inicialização)
+    uint8_t returnType;   // IrType
+    uint8_t constructor;
+    uint32_t paramCount;  // Parâmetros em v1..vN
+    uint8_t *paramTypes;  // IrType de cada parâmetro (cópia lida pelos chamadores; vregTypes cresce durante a geração)
+
+    IrInstr *code;
+    uint32_t count;
+    uint32_t capacity;
+
+    uint8_t *vregTypes;   // IrType de cada registrador (índice 0 sem uso)
+    uint32_t vregCount;   // Inclui o registrador 0
+    uint32_t vregCapacity;
+    uint32_t labelCount;
+
+    double *floats;
+    uint32_t floatCount;
+    uint32_t floatCapacity;
+    IrString *strings;
+    uint32_t stringCount;
+    uint32_t stringCapacity;
+    char *data;
+    uint32_t dataSize;
+    uint32_t dataCapacity;
+
+    IrPhiOperand *phiOperands;  // Operandos das instruções IR_PHI
+    uint32_t phiOperandCount;
+    uint32_t phiOperandCapacity;
+} IrFunction;
+
+// Estrutura de uma variável global (campo)
+typedef struct {
+    const char *name;
+    uint32_t nameLength;
+    NodeId decl;
+    uint8_t type;         // IrType
+} IrGlobal;
+
+// Estrutura do módulo
+typedef struct {
+    IrFunction *functions;
+    uint32_t functionCount;
+    uint32_t functionCapacity;
+    IrGlobal *globals;
+    uint32_t globalCount;
+    uint32_t globalCapacity;
+    int entry;            // Função Main/main (-1 se não houver)
+} IrModule;
+
+// Estrutura do gerador de código intermediário
+typedef struct {
+    Ast *ast;
+    IrModule *module;
+    IrFunction *fn;       // Função sendo gerada
+    SymbolTable table;
+    int errorCount;
+
+    // Geração adiada dos métodos (irGenerateMethod, um por tarefa)
+    int deferMethods;
+    NodeId *scopes;       // Contêineres abertos: raiz, namespaces e classes
+    uint32_t scopeCount;
+    uint32_t scopeCapacity;
+    NodeId *paths;        // Contêineres de cada método, a partir de pathStart[função]
+    uint32_t pathCount;
+    uint32_t pathCapacity;
+    uint32_t *pathStart;  // Por função (os métodos são adiados na ordem em que as funções foram criadas,
+                          // então o caminho da função i termina em pathStart[i + 1])
+} IrGenerator;
+
+// ---------------------------------------------------------------------------
+// Módulo e funções
+// ---------------------------------------------------------------------------
+
+// Função para converter um tipo da linguagem (TypeKind | TYPE_ARRAY_BIT) em IrType
+IrType irTypeFromKind(uint8_t type) {
+    if (type & TYPE_ARRAY_BIT) {
+        return IR_REF;
+    }
+    switch ((TypeKind)type) {
+        case TY_VOID: return IR_VOID;
+        case TY_BOOL: return IR_BOOL;
+        case TY_CHAR: return IR_CHAR;
+        case TY_FLOAT:
+        case TY_DOUBLE: return IR_DOUBLE;
+        case TY_STRING: return IR_STRING;
+        case TY_CLASS: return IR_REF;
+        default: return IR_INT;
+    }
+}
+
+// Função para verificar se um tipo é representado por um inteiro de 32 bits
+int irIsInteger(uint8_t type) {
+    return type == IR_INT || type == IR_BOOL || type == IR_CHAR;
+}
+
+// Função para converter IrType em string
+const char *irTypeToString(uint8_t type) {
+    switch ((IrType)type) {
+        case IR_VOID: return "void";
+        case IR_INT: return "int";
+        case IR_BOOL: return "bool";
+        case IR_CHAR: return "char";
+        case IR_DOUBLE: return "double";
+        case IR_STRING: return "string";
+        case IR_REF: return "ref";
+        default: return "?";
+    }
+}
+
+// Função para inicializar o módulo
+void irModuleInit(IrModule *module) {
+    memset(module, 0, sizeof(*module));
+    module->entry = -1;
+}
+
+// Função para liberar uma função
+void irFunctionFree(IrFunction *fn) {
+    free(fn->code);
+    free(fn->vregTypes);
+    free(fn->paramTypes);
+    free(fn->floats);
+    free(fn->strings);
+    free(fn->data);
+    free(fn->phiOperands);
+    memset(fn, 0, sizeof(*fn));
+}
+
+// Função para liberar o módulo
+void irModuleFree(IrModule *module) {
+    for (uint32_t i = 0; i < module->functionCount; i++) {
+        irFunctionFree(&module->functions[i]);
+    }
+    free(module->functions);
+    free(module->globals);
+    memset(module, 0, sizeof(*module));
+}
+
+// Função para criar um registrador virtual do tipo informado
+VReg irNewVreg(IrFunction *fn, uint8_t type) {
+    fn->vregTypes = vectorGrow(fn->vregTypes, &fn->vregCapacity, fn->vregCount + 1, 1);
+    fn->vregTypes[fn->vregCount] = type;
+    return fn->vregCount++;
+}
+
+// Função para criar uma função no módulo; devolve o índice
+uint32_t irNewFunction(IrModule *module, const char *name, uint32_t nameLength, NodeId decl, uint8_t returnType) {
+    module->functions = vectorGrow(module->functions, &module->functionCapacity,
+                                   module->functionCount + 1, sizeof(IrFunction));
+    IrFunction *fn = &module->functions[module->functionCount];
+    memset(fn, 0, sizeof(*fn));
+    fn->name = name;
+    fn->nameLength = nameLength;
+    fn->decl = decl;
+    fn->returnType = returnType;
+    irNewVreg(fn, IR_VOID);  // Registrador 0 (nenhum)
+    return module->functionCount++;
+}
+
+// Função para anexar uma instrução; devolve o seu índice
+uint32_t irEmit(IrFunction *fn, IrOpcode op, uint8_t type, VReg dst, uint32_t src1, uint32_t src2) {
+    fn->code = vectorGrow(fn->code, &fn->capacity, fn->count + 1, sizeof(IrInstr));
+    IrInstr *instr = &fn->code[fn->count];
+    instr->op = (uint8_t)op;
+    instr->type = type;
+    instr->flags = 0;
+    instr->dst = dst;
+    instr->src1 = src1;
+    instr->src2 = src2;
+    return fn->count++;
+}
+
+// Função para adicionar uma constante double; devolve o índice
+uint32_t irAddFloat(IrFunction *fn, double value) {
+    for (uint32_t i = 0; i < fn->floatCount; i++) {
+        if (memcmp(&fn->floats[i], &value, sizeof(double)) == 0) {
+            return i;
+        }
+    }
+    fn->floats = vectorGrow(fn->floats, &fn->floatCapacity, fn->floatCount + 1, sizeof(double));
+    fn->floats[fn->floatCount] = value;
+    return fn->floatCount++;
+}
+
+// Função para adicionar uma constante string (copiada e terminada em '\0'); devolve o índice
+uint32_t irAddString(IrFunction *fn, const char *text, uint32_t length) {
+    fn->data = vectorGrow(fn->data, &fn->dataCapacity, fn->dataSize + length + 1, 1);
+    fn->strings = vectorGrow(fn->strings, &fn->stringCapacity, fn->stringCount + 1, sizeof(IrString));
+    memcpy(fn->data + fn->dataSize, text, length);
+    fn->data[fn->dataSize + length] = '\0';
+    fn->strings[fn->stringCount].offset = fn->dataSize;
+    fn->strings[fn->stringCount].length = length;
+    fn->dataSize += length + 1;
+    return fn->stringCount++;
+}
+
+// Função para adicionar os operandos de um phi (contíguos); devolve o índice do primeiro
+uint32_t irAddPhiOperands(IrFunction *fn, const IrPhiOperand *operands, uint32_t count) {
+    fn->phiOperands = vectorGrow(fn->phiOperands, &fn->phiOperandCapacity, fn->phiOperandCount + count,
+                                 sizeof(IrPhiOperand));
+    memcpy(fn->phiOperands + fn->phiOperandCount, operands, count * sizeof(IrPhiOperand));
+    fn->phiOperandCount += count;
+    return fn->phiOperandCount - count;
+}
+
+// Função para obter o texto de uma constante string
+const char *irStringText(const IrFunction *fn, uint32_t index) {
+    return fn->data + fn->strings[index].offset;
+}
+
+// Função para localizar a função declarada pelo nó 'decl' (as funções estão em ordem de nó)
+int irFunctionByDecl(const IrModule *module, NodeId decl) {
+    uint32_t low = 1, high = module->functionCount;
+    while (low < high) {
+        uint32_t mid = (low + high) / 2;
+        if (module->functions[mid].decl < decl) low = mid + 1;
+        else high = mid;
+    }
+    return (low < module->functionCount && module->functions[low].decl == decl) ? (int)low : -1;
+}
+
+// Função para localizar o campo declarado pelo nó 'decl' (os campos estão em ordem de nó)
+int irGlobalByDecl(const IrModule *module, NodeId decl) {
+    uint32_t low = 0, high = module->globalCount;
+    while (low < high) {
+        uint32_t mid = (low + high) / 2;
+        if (module->globals[mid].decl < decl) low = mid + 1;
+        else high = mid;
+    }
+    return (low < module->globalCount && module->globals[low].decl == decl) ? (int)low : -1;
+}
+
+// Função para localizar uma função pelo nome (métodos de outras classes e construtores)
+int irFindFunction(const IrModule *module, const char *name, uint32_t length, int constructor) {
+    for (uint32_t i = 1; i < module->functionCount; i++) {
+        const IrFunction *fn = &module->functions[i];
+        if (fn->constructor == constructor && fn->nameLength == length && memcmp(fn->name, name, length) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+// Função para obter os registradores lidos por uma instrução; devolve a quantidade
+// (os operandos de IR_PHI ficam em phiOperands)
+int irUses(const IrInstr *instr, VReg uses[3]) {
+    const IrOpcodeInfo *info = &irOpcodeInfo[instr->op];
+    int count = 0;
+    if (info->src1 == OPND_VREG && instr->src1) uses[count++] = instr->src1;
+    if (info->src2 == OPND_VREG && instr->src2) uses[count++] = instr->src2;
+    if ((info->properties & IRF_DST_READ) && instr->dst) uses[count++] = instr->dst;
+    return count;
+}
+
+// Função para obter o registrador definido por uma instrução (0 se nenhum)
+VReg irDefinition(const IrInstr *instr) {
+    const IrOpcodeInfo *info = &irOpcodeInfo[instr->op];
+    return (info->dst == OPND_VREG && !(info->properties & IRF_DST_READ)) ? instr->dst : 0;
+}
+
+// ---------------------------------------------------------------------------
+// Impressão
+// ---------------------------------------------------------------------------
+
+// Função para exibir um operando conforme a sua forma
+void irPrintOperand(FILE *out, const IrModule *module, const IrFunction *fn, IrOperand kind, uint32_t value) {
+    switch (kind) {
+        case OPND_VREG:
+            fprintf(out, "v%u", value);
+            break;
+        case OPND_IMM:
+            fprintf(out, "%d", (int32_t)value);
+            break;
+        case OPND_LABEL:
+            fprintf(out, "L%u", value);
+            break;
+        case OPND_FLOAT:
+            fprintf(out, "%g", fn->floats[value]);
+            break;
+        case OPND_STRING:
+            fputc('"', out);
+            for (const char *c = irStringText(fn, value); *c; c++) {
+                if (*c == '\n') fputs("\\n", out);
+                else if (*c == '\t') fputs("\\t", out);
+                else if (*c == '"' || *c == '\\') fprintf(out, "\\%c", *c);
+                else fputc(*c, out);
+            }
+            fputc('"', out);
+            break;
+        case OPND_GLOBAL:
+            fprintf(out, "@%.*s", (int)module->globals[value].nameLength, module->globals[value].name);
+            break;
+        case OPND_FUNCTION:
+            fprintf(out, "%.*s", (int)module->functions[value].nameLength, module->functions[value].name);
+            break;
+        case OPND_BUILTIN:
+            fputs(irBuiltinNames[value], out);
+            break;
+        case OPND_PHI:
+            break;
+        default:
+            break;
+    }
+}
+
+// Função para exibir uma instrução
+void irPrintInstr(FILE *out, const IrModule *module, const IrFunction *fn, const IrInstr *instr) {
+    const IrOpcodeInfo *info = &irOpcodeInfo[instr->op];
+
+    if (instr->op == IR_LABEL) {
+        fprintf(out, "L%u:\n", instr->src1);
+        return;
+    }
+    fputs("    ", out);
+    if (instr->dst && info->dst == OPND_VREG && !(info->properties & IRF_DST_READ)) {
+        fprintf(out, "v%u = ", instr->dst);
+    }
+    fputs(info->name, out);
+    if (instr->type != IR_VOID) {
+        fprintf(out, ".%s", irTypeToString(instr->type));
+    }
+    if (info->src1 != OPND_NONE && !(info->src1 == OPND_VREG && !instr->src1)) {
+        fputc(' ', out);
+        irPrintOperand(out, module, fn, (IrOperand)info->src1, instr->src1);
+    }
+    if (instr->op == IR_PHI) {
+        for (uint32_t i = 0; i < instr->src2; i++) {
+            const IrPhiOperand *operand = &fn->phiOperands[instr->src1 + i];
+            fprintf(out, "%s[L%u: v%u]", i ? ", " : "", operand->label, operand->value);
+        }
+    }
+    if (info->src2 != OPND_NONE) {
+        fputs(", ", out);
+        irPrintOperand(out, module, fn, (IrOperand)info->src2, instr->src2);
+    }
+    if (info->properties & IRF_DST_READ) {
+        fprintf(out, ", v%u", instr->dst);
+    }
+    fputc('\n', out);
+}
+
+// Função para exibir uma função inteira
+void irPrintFunction(FILE *out, const IrModule *module, const IrFunction *fn) {
+    fprintf(out, "função %.*s(", (int)fn->nameLength, fn->name);
+    for (uint32_t i = 1; i <= fn->paramCount; i++) {
+        fprintf(out, "%sv%u: %s", i > 1 ? ", " : "", i, irTypeToString(fn->vregTypes[i]));
+    }
+    fprintf(out, "): %s  [%u instruções, %u registradores]\n", irTypeToString(fn->returnType),
+            fn->count, fn->vregCount - 1);
+    for (uint32_t i = 0; i < fn->count; i++) {
+        irPrintInstr(out, module, fn, &fn->code[i]);
+    }
+}
+
+// Função para exibir o módulo
+void irPrintModule(FILE *out, const IrModule *module) {
+    for (uint32_t i = 0; i < module->globalCount; i++) {
+        fprintf(out, "global @%.*s: %s\n", (int)module->globals[i].nameLength, module->globals[i].name,
+                irTypeToString(module->globals[i].type));
+    }
+    for (uint32_t i = 0; i < module->functionCount; i++) {
+        fputc('\n', out);
+        irPrintFunction(out, module, &module->functions[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Geração a partir da AST
+// ---------------------------------------------------------------------------
+
+// Função para reportar um erro de geração na posição de um nó
+void irError(IrGenerator *g, NodeId id, const char *format, ...) {
+    va_list args;
+    int line, column;
+    offsetToLocation((int)astNode(g->ast, id)->offset, &line, &column);
+    fprintf(stderr, "Erro na geração de código (linha %d, coluna %d): ", line, column);
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+    g->errorCount++;
+}
+
+// Função para decodificar um literal entre aspas (com as sequências de escape); devolve o tamanho
+uint32_t irDecodeLiteral(const char *text, uint32_t length, char *out) {
+    uint32_t size = 0;
+    for (uint32_t i = 1; i + 1 < length; i++) {
+        char c = text[i];
+        if (c == '\\' && i + 2 < length) {
+            switch (text[++i]) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case '0': c = '\0'; break;
+                default: c = text[i]; break;
+            }
+        }
+        out[size++] = c;
+    }
+    return size;
+}
+
+// Função para emitir uma instrução com resultado em um registrador novo
+VReg irValue(IrGenerator *g, IrOpcode op, uint8_t type, uint8_t resultType, uint32_t src1, uint32_t src2) {
+    VReg dst = irNewVreg(g->fn, resultType);
+    irEmit(g->fn, op, type, dst, src1, src2);
+    return dst;
+}
+
+// Função para carregar uma constante inteira
+VReg irConstant(IrGenerator *g, uint8_t type, int32_t value) {
+    if (type == IR_DOUBLE) {
+        return irValue(g, IR_FCONST, IR_DOUBLE, IR_DOUBLE, irAddFloat(g->fn, value), 0);
+    }
+    return irValue(g, IR_ICONST, type, type, (uint32_t)value, 0);
+}
+
+// Função para converter um valor para o tipo informado (int <-> double)
+VReg irConvert(IrGenerator *g, VReg value, uint8_t to) {
+    uint8_t from = g->fn->vregTypes[value];
+    if (to == IR_DOUBLE && irIsInteger(from)) {
+        return irValue(g, IR_I2F, IR_DOUBLE, IR_DOUBLE, value, 0);
+    }
+    if (irIsInteger(to) && from == IR_DOUBLE) {
+        return irValue(g, IR_F2I, to, to, value, 0);
+    }
+    return value;
+}
+
+// Função para obter o tipo aritmético comum de dois valores
+uint8_t irArithmeticType(const IrFunction *fn, VReg a, VReg b) {
+    return (fn->vregTypes[a] == IR_DOUBLE || fn->vregTypes[b] == IR_DOUBLE) ? IR_DOUBLE : IR_INT;
+}
+
+// Enumeração para destinos de atribuição
+typedef enum {
+    LV_NONE,
+    LV_VREG,
+    LV_GLOBAL,
+    LV_INDEX
+} LValueKind;
+
+// Estrutura de um destino de atribuição
+typedef struct {
+    LValueKind kind;
+    uint8_t type;     // IrType do valor armazenado
+    uint32_t slot;    // Registrador ou global
+    VReg array;
+    VReg index;
+} LValue;
+
+VReg irExpression(IrGenerator *g, NodeId id);
+
+// Função para resolver o destino de uma atribuição
+LValue irLValue(IrGenerator *g, NodeId id) {
+    const AstNode *node = astNode(g->ast, id);
+    LValue lv = {LV_NONE, IR_INT, 0, 0, 0};
+
+    if (node->kind == AST_IDENTIFIER) {
+        const Symbol *symbol = lookupSymbol(&g->table, g->ast->source + node->offset, node->length);
+        if (symbol && (symbol->kind == SYM_VARIABLE || symbol->kind == SYM_PARAMETER)) {
+            lv.kind = LV_VREG;
+            lv.slot = symbol->slot;
+            lv.type = g->fn->vregTypes[symbol->slot];
+            return lv;
+        }
+        if (symbol && symbol->kind == SYM_FIELD) {
+            lv.kind = LV_GLOBAL;
+            lv.slot = symbol->slot;
+            lv.type = g->module->globals[symbol->slot].type;
+            return lv;
+        }
+    } else if (node->kind == AST_INDEX) {
+        NodeId index = astNode(g->ast, node->firstChild)->nextSibling;
+        lv.kind = LV_INDEX;
+        lv.type = irTypeFromKind(node->type);
+        lv.array = irExpression(g, node->firstChild);
+        lv.index = irConvert(g, irExpression(g, index), IR_INT);
+        return lv;
+    }
+    irError(g, id, "destino de atribuição não suportado");
+    return lv;
+}
+
+// Função para ler o valor atual de um destino
+VReg irLoadLValue(IrGenerator *g, const LValue *lv) {
+    switch (lv->kind) {
+        case LV_VREG: return lv->slot;
+        case LV_GLOBAL: return irValue(g, IR_LOAD_GLOBAL, lv->type, lv->type, lv->slot, 0);
+        case LV_INDEX: return irValue(g, IR_LOAD_INDEX, lv->type, lv->type, lv->array, lv->index);
+        default: return irConstant(g, IR_INT, 0);
+    }
+}
+
+// Função para armazenar um valor (já convertido) em um destino
+void irStoreLValue(IrGenerator *g, const LValue *lv, VReg value) {
+    switch (lv->kind) {
+        case LV_VREG:
+            irEmit(g->fn, IR_MOV, lv->type, lv->slot, value, 0);
+            break;
+        case LV_GLOBAL:
+            irEmit(g->fn, IR_STORE_GLOBAL, lv->type, 0, lv->slot, value);
+            break;
+        case LV_INDEX:
+            irEmit(g->fn, IR_STORE_INDEX, lv->type, value, lv->array, lv->index);
+            break;
+        default:
+            break;
+    }
+}
+
+// Tabela de opcodes dos operadores binários e atribuições compostas
+static const uint8_t irBinaryOpcode[] = {
+    [OP_ADD] = IR_ADD, [OP_SUB] = IR_SUB, [OP_MUL] = IR_MUL, [OP_DIV] = IR_DIV, [OP_MOD] = IR_MOD,
+    [OP_LT] = IR_LT, [OP_GT] = IR_GT, [OP_LE] = IR_LE, [OP_GE] = IR_GE, [OP_EQ] = IR_EQ, [OP_NE] = IR_NE,
+    [OP_ADD_ASSIGN] = IR_ADD, [OP_SUB_ASSIGN] = IR_SUB, [OP_MUL_ASSIGN] = IR_MUL,
+    [OP_DIV_ASSIGN] = IR_DIV, [OP_MOD_ASSIGN] = IR_MOD
+};
+
+// Função para gerar uma operação aritmética ou concatenação entre dois valores
+VReg irArithmetic(IrGenerator *g, IrOpcode op, VReg left, VReg right) {
+    const uint8_t *types = g->fn->vregTypes;
+    if (op == IR_ADD && (types[left] == IR_STRING || types[right] == IR_STRING)) {
+        return irValue(g, IR_CONCAT, IR_STRING, IR_STRING, left, right);
+    }
+    uint8_t type = irArithmeticType(g->fn, left, right);
+    left = irConvert(g, left, type);
+    right = irConvert(g, right, type);
+    return irValue(g, op, type, type, left, right);
+}
+
+// Função para gerar '&&' e '||' com avaliação em curto-circuito
+VReg irLogical(IrGenerator *g, NodeId id, OperatorKind op) {
+    NodeId left = astNode(g->ast, id)->firstChild;
+    NodeId right = astNode(g->ast, left)->nextSibling;
+    VReg result = irNewVreg(g->fn, IR_BOOL);
+    uint32_t end = g->fn->labelCount++;
+
+    irEmit(g->fn, IR_MOV, IR_BOOL, result, irExpression(g, left), 0);
+    irEmit(g->fn, op == OP_AND ? IR_JUMP_IFNOT : IR_JUMP_IF, IR_BOOL, 0, result, end);
+    irEmit(g->fn, IR_MOV, IR_BOOL, result, irExpression(g, right), 0);
+    irEmit(g->fn, IR_LABEL, IR_VOID, 0, end, 0);
+    return result;
+}
+
+// Função para gerar uma operação binária
+VReg irBinary(IrGenerator *g, NodeId id) {
+    const AstNode *node = astNode(g->ast, id);
+    OperatorKind op = (OperatorKind)node->op;
+    if (op == OP_AND || op == OP_OR) {
+        return irLogical(g, id, op);
+    }
+
+    NodeId rightNode = astNode(g->ast, node->firstChild)->nextSibling;
+    VReg left = irExpression(g, node->firstChild);
+    VReg right = irExpression(g, rightNode);
+    IrOpcode opcode = (IrOpcode)irBinaryOpcode[op];
+    if (opcode < IR_LT) {
+        return irArithmetic(g, opcode, left, right);
+    }
+
+    // Comparação: operandos numéricos são promovidos ao tipo comum
+    const uint8_t *types = g->fn->vregTypes;
+    uint8_t type = types[left];
+    if ((irIsInteger(types[left]) || types[left] == IR_DOUBLE) &&
+        (irIsInteger(types[right]) || types[right] == IR_DOUBLE) && types[left] != types[right]) {
+        type = irArithmeticType(g->fn, left, right);
+        left = irConvert(g, left, type);
+        right = irConvert(g, right, type);
+    }
+    return irValue(g, opcode, type, IR_BOOL, left, right);
+}
+
+// Função para gerar '++' e '--' (prefixos e pós-fixos)
+VReg irIncrement(IrGenerator *g, NodeId id, OperatorKind op) {
+    LValue lv = irLValue(g, astNode(g->ast, id)->firstChild);
+    VReg old = irLoadLValue(g, &lv);
+    IrOpcode opcode = (op == OP_PRE_INC || op == OP_POST_INC) ? IR_ADD : IR_SUB;
+
+    if (op == OP_POST_INC || op == OP_POST_DEC) {
+        // O registrador de uma variável local é sobrescrito; preserva o valor antigo
+        VReg copy = irNewVreg(g->fn, lv.type);
+        irEmit(g->fn, IR_MOV, lv.type, copy, old, 0);
+        old = copy;
+    }
+    uint8_t type = lv.type == IR_DOUBLE ? IR_DOUBLE : IR_INT;
+    VReg updated = irConvert(g, irValue(g, opcode, type, type, old, irConstant(g, type, 1)), lv.type);
+    irStoreLValue(g, &lv, updated);
+    return (op == OP_POST_INC || op == OP_POST_DEC) ? old : updated;
+}
+
+// Função para gerar uma atribuição (simples ou composta)
+VReg irAssign(IrGenerator *g, NodeId id) {
+    const AstNode *node = astNode(g->ast, id);
+    OperatorKind op = (OperatorKind)node->op;
+    NodeId valueNode = astNode(g->ast, node->firstChild)->nextSibling;
+    LValue lv = irLValue(g, node->firstChild);
+    VReg value;
+
+    if (op == OP_ASSIGN) {
+        value = irConvert(g, irExpression(g, valueNode), lv.type);
+    } else {
+        VReg current = irLoadLValue(g, &lv);
+        value = irConvert(g, irArithmetic(g, (IrOpcode)irBinaryOpcode[op], current, irExpression(g, valueNode)), lv.type);
+    }
+    irStoreLValue(g, &lv, value);
+    return value;
+}
+
+// Função para localizar uma função da biblioteca pelo objeto e membro (-1 se não existir)
+int irFindBuiltin(const char *object, uint32_t objectLength, const char *member, uint32_t memberLength) {
+    for (int i = 0; i < BUILTIN_COUNT; i++) {
+        const char *name = irBuiltinNames[i];
+        const char *dot = strchr(name, '.');
+        uint32_t prefix = dot ? (uint32_t)(dot - name) : 0;
+        const char *suffix = dot ? dot + 1 : name;
+        if (prefix == objectLength && strncmp(name, object, prefix) == 0 &&
+            strlen(suffix) == memberLength && strncmp(suffix, member, memberLength) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Função para obter o tipo do resultado de uma função da biblioteca
+uint8_t irBuiltinType(IrBuiltin builtin, const uint8_t *argTypes, int count) {
+    switch (builtin) {
+        case BUILTIN_PRINTF: return IR_INT;
+        case BUILTIN_WRITE:
+        case BUILTIN_WRITELINE: return IR_VOID;
+        case BUILTIN_SQRT:
+        case BUILTIN_POW: return IR_DOUBLE;
+        default:
+            for (int i = 0; i < count; i++) {
+                if (argTypes[i] == IR_DOUBLE) {
+                    return IR_DOUBLE;
+                }
+            }
+            return IR_INT;
+    }
+}
+
+// Função para gerar uma chamada (métodos do programa ou da biblioteca)
+VReg irCall(IrGenerator *g, NodeId id) {
+    NodeId callee = astNode(g->ast, id)->firstChild;
+    const AstNode *calleeNode = astNode(g->ast, callee);
+    const char *name = g->ast->source + calleeNode->offset;
+    int function = -1, builtin = -1;
+
+    if (calleeNode->kind == AST_IDENTIFIER) {
+        const Symbol *symbol = lookupSymbol(&g->table, name, calleeNode->length);
+        if (symbol && symbol->kind == SYM_METHOD) {
+            if (symbol->builtin) builtin = (int)symbol->slot;
+            else function = (int)symbol->slot;
+        }
+    } else if (calleeNode->kind == AST_MEMBER) {
+        const AstNode *object = astNode(g->ast, calleeNode->firstChild);
+        if (object->kind == AST_IDENTIFIER) {
+            builtin = irFindBuiltin(g->ast->source + object->offset, object->length, name, calleeNode->length);
+        }
+        if (builtin < 0) {
+            function = irFindFunction(g->module, name, calleeNode->length, 0);
+        }
+    }
+    if (function < 0 && builtin < 0) {
+        irError(g, callee, "chamada a '%.*s' não suportada", (int)calleeNode->length, name);
+        return irConstant(g, IR_INT, 0);
+    }
+
+    // Avalia todos os argumentos antes de emitir as IR_ARG (chamadas aninhadas)
+    VReg args[IR_MAX_ARGUMENTS];
+    uint8_t argTypes[IR_MAX_ARGUMENTS];
+    int count = 0;
+    const IrFunction *target = function >= 0 ? &g->module->functions[function] : NULL;
+    for (NodeId arg = calleeNode->nextSibling; arg; arg = astNode(g->ast, arg)->nextSibling) {
+        if (count == IR_MAX_ARGUMENTS) {
+            irError(g, arg, "mais de %d argumentos", IR_MAX_ARGUMENTS);
+            break;
+        }
+        VReg value = irExpression(g, arg);
+        if (target && (uint32_t)count < target->paramCount) {
+            value = irConvert(g, value, target->paramTypes[count]);
+        }
+        args[count] = value;
+        argTypes[count++] = g->fn->vregTypes[value];
+    }
+
+    uint8_t resultType;
+    if (target) {
+        resultType = target->returnType;
+    } else {
+        resultType = irBuiltinType((IrBuiltin)builtin, argTypes, count);
+        if (builtin != BUILTIN_PRINTF && builtin != BUILTIN_WRITE && builtin != BUILTIN_WRITELINE) {
+            // Funções matemáticas recebem os argumentos já no tipo do resultado
+            for (int i = 0; i < count; i++) {
+                args[i] = irConvert(g, args[i], builtin == BUILTIN_ABS || builtin == BUILTIN_MAX ||
+                                                builtin == BUILTIN_MIN ? resultType : IR_DOUBLE);
+            }
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        irEmit(g->fn, IR_ARG, g->fn->vregTypes[args[i]], 0, args[i], 0);
+    }
+    VReg dst = resultType == IR_VOID ? 0 : irNewVreg(g->fn, resultType);
+    irEmit(g->fn, target ? IR_CALL : IR_CALL_BUILTIN, resultType, dst,
+           (uint32_t)(target ? function : builtin), (uint32_t)count);
+    return dst;
+}
+
+// Função para gerar 'new' (vetores e construtores)
+VReg irNew(IrGenerator *g, NodeId id) {
+    const AstNode *node = astNode(g->ast, id);
+    NodeId typeNode = node->firstChild;
+    NodeId arg = astNode(g->ast, typeNode)->nextSibling;
+
+    if (node->flags & TYPE_ARRAY) {
+        uint8_t element = irTypeFromKind(TYPE_BASE(typeOfNode(g->ast, typeNode)));
+        VReg size = irConvert(g, irExpression(g, arg), IR_INT);
+        return irValue(g, IR_NEW_ARRAY, element, IR_REF, size, 0);
+    }
+
+    // Objetos não são modelados: executa o construtor (se houver) e devolve uma referência nula
+    const AstNode *type = astNode(g->ast, typeNode);
+    int constructor = irFindFunction(g->module, g->ast->source + type->offset, type->length, 1);
+    VReg args[IR_MAX_ARGUMENTS];
+    int count = 0;
+    for (; arg && count < IR_MAX_ARGUMENTS; arg = astNode(g->ast, arg)->nextSibling) {
+        args[count] = irExpression(g, arg);
+        if (constructor >= 0 && (uint32_t)count < g->module->functions[constructor].paramCount) {
+            args[count] = irConvert(g, args[count], g->module->functions[constructor].paramTypes[count]);
+        }
+        count++;
+    }
+    if (constructor >= 0) {
+        for (int i = 0; i < count; i++) {
+            irEmit(g->fn, IR_ARG, g->fn->vregTypes[args[i]], 0, args[i], 0);
+        }
+        irEmit(g->fn, IR_CALL, IR_VOID, 0, (uint32_t)constructor, (uint32_t)count);
+    }
+    return irConstant(g, IR_REF, 0);
+}
+
+// Função para gerar uma expressão; devolve o registrador com o resultado (0 se void)
+VReg irExpression(IrGenerator *g, NodeId id) {
+    const AstNode *node = astNode(g->ast, id);
+    const char *text = g->ast->source + node->offset;
+
+    switch ((NodeKind)node->kind) {
+        case AST_NUMBER:
+            if (memchr(text, '.', node->length)) {
+                return irValue(g, IR_FCONST, IR_DOUBLE, IR_DOUBLE, irAddFloat(g->fn, strtod(text, NULL)), 0);
+            }
+            return irConstant(g, IR_INT, (int32_t)strtol(text, NULL, 10));
+        case AST_BOOL:
+            return irConstant(g, IR_BOOL, node->length == 4);  // "true"
+        case AST_CHAR: {
+            char buffer[8];
+            uint32_t size = node->length < sizeof(buffer) ? irDecodeLiteral(text, node->length, buffer) : 0;
+            return irConstant(g, IR_CHAR, size ? (unsigned char)buffer[0] : 0);
+        }
+        case AST_STRING: {
+            char *buffer = malloc(node->length + 1);
+            if (!buffer) {
+                fprintf(stderr, "Erro: Falha ao alocar o código intermediário.\n");
+                exit(EXIT_FAILURE);
+            }
+            uint32_t size = irDecodeLiteral(text, node->length, buffer);
+            uint32_t index = irAddString(g->fn, buffer, size);
+            free(buffer);
+            return irValue(g, IR_SCONST, IR_STRING, IR_STRING, index, 0);
+        }
+        case AST_IDENTIFIER: {
+            const Symbol *symbol = lookupSymbol(&g->table, text, node->length);
+            if (symbol && (symbol->kind == SYM_VARIABLE || symbol->kind == SYM_PARAMETER)) {
+                return symbol->slot;
+            }
+            if (symbol && symbol->kind == SYM_FIELD) {
+                uint8_t type = g->module->globals[symbol->slot].type;
+                return irValue(g, IR_LOAD_GLOBAL, type, type, symbol->slot, 0);
+            }
+            irError(g, id, "'%.*s' não pode ser usado como valor", (int)node->length, text);
+            return irConstant(g, IR_INT, 0);
+        }
+        case AST_MEMBER:
+            if (nodeTextIs(g->ast, id, "Length")) {
+                return irValue(g, IR_LENGTH, IR_INT, IR_INT, irExpression(g, node->firstChild), 0);
+            }
+            irError(g, id, "acesso ao membro '%.*s' não suportado", (int)node->length, text);
+            return irConstant(g, IR_INT, 0);
+        case AST_INDEX: {
+            uint8_t type = irTypeFromKind(node->type);
+            VReg array = irExpression(g, node->firstChild);
+            VReg index = irConvert(g, irExpression(g, astNode(g->ast, node->firstChild)->nextSibling), IR_INT);
+            return irValue(g, IR_LOAD_INDEX, type, type, array, index);
+        }
+        case AST_CALL:
+            return irCall(g, id);
+        case AST_NEW:
+            return irNew(g, id);
+        case AST_UNARY:
+            if (node->op == OP_NOT) {
+                return irValue(g, IR_NOT, IR_BOOL, IR_BOOL, irExpression(g, node->firstChild), 0);
+            }
+            if (node->op == OP_NEG) {
+                VReg operand = irExpression(g, node->firstChild);
+                uint8_t type = g->fn->vregTypes[operand] == IR_DOUBLE ? IR_DOUBLE : IR_INT;
+                return irValue(g, IR_NEG, type, type, operand, 0);
+            }
+            return irIncrement(g, id, (OperatorKind)node->op);
+        case AST_BINARY:
+            return irBinary(g, id);
+        case AST_ASSIGN:
+            return irAssign(g, id);
+        default:
+            irError(g, id, "expressão não suportada");
+            return irConstant(g, IR_INT, 0);
+    }
+}
+
+// Função para declarar uma variável local em um registrador próprio
+void irLocal(IrGenerator *g, NodeId id) {
+    const AstNode *node = astNode(g->ast, id);
+    NodeId init = astNode(g->ast, node->firstChild)->nextSibling;
+    uint8_t type = irTypeFromKind(node->type);
+    VReg value = init ? irConvert(g, irExpression(g, init), type) : irConstant(g, type, 0);
+    VReg local = irNewVreg(g->fn, type);
+
+    irEmit(g->fn, IR_MOV, type, local, value, 0);
+    Symbol *symbol = declareSymbol(&g->table, g->ast->source + node->offset, node->length, SYM_VARIABLE, node->type, id);
+    if (symbol) {
+        symbol->slot = local;
+    }
+}
+
+void irStatement(IrGenerator *g, NodeId id);
+
+// Função para gerar os comandos de um bloco em um novo escopo
+void irBlock(IrGenerator *g, NodeId id) {
+    enterScope(&g->table);
+    for (NodeId stmt = astNode(g->ast, id)->firstChild; stmt; stmt = astNode(g->ast, stmt)->nextSibling) {
+        irStatement(g, stmt);
+    }
+    leaveScope(&g->table);
+}
+
+// Função para gerar um laço: [início] rótulo; condição; corpo; passo; desvio
+void irLoop(IrGenerator *g, NodeId cond, NodeId step, NodeId body) {
+    uint32_t head = g->fn->labelCount++;
+    uint32_t end = g->fn->labelCount++;
+
+    irEmit(g->fn, IR_LABEL, IR_VOID, 0, head, 0);
+    if (astNode(g->ast, cond)->kind != AST_EMPTY) {
+        irEmit(g->fn, IR_JUMP_IFNOT, IR_BOOL, 0, irExpression(g, cond), end);
+    }
+    irStatement(g, body);
+    if (step && astNode(g->ast, step)->kind != AST_EMPTY) {
+        irExpression(g, step);
+    }
+    irEmit(g->fn, IR_JUMP, IR_VOID, 0, head, 0);
+    irEmit(g->fn, IR_LABEL, IR_VOID, 0, end, 0);
+}
+
+// Função para gerar um comando
+void irStatement(IrGenerator *g, NodeId id) {
+    const AstNode *node = astNode(g->ast, id);
+    NodeId first = node->firstChild;
+
+    switch ((NodeKind)node->kind) {
+        case AST_BLOCK:
+            irBlock(g, id);
+            break;
+        case AST_VAR_DECL:
+            irLocal(g, id);
+            break;
+        case AST_EXPR_STMT:
+            irExpression(g, first);
+            break;
+        case AST_IF: {
+            NodeId thenBranch = astNode(g->ast, first)->nextSibling;
+            NodeId elseBranch = astNode(g->ast, thenBranch)->nextSibling;
+            uint32_t otherwise = g->fn->labelCount++;
+            irEmit(g->fn, IR_JUMP_IFNOT, IR_BOOL, 0, irExpression(g, first), otherwise);
+            irStatement(g, thenBranch);
+            if (elseBranch) {
+                uint32_t end = g->fn->labelCount++;
+                irEmit(g->fn, IR_JUMP, IR_VOID, 0, end, 0);
+                irEmit(g->fn, IR_LABEL, IR_VOID, 0, otherwise, 0);
+                irStatement(g, elseBranch);
+                irEmit(g->fn, IR_LABEL, IR_VOID, 0, end, 0);
+            } else {
+                irEmit(g->fn, IR_LABEL, IR_VOID, 0, otherwise, 0);
+            }
+            break;
+        }
+        case AST_WHILE:
+            irLoop(g, first, 0, astNode(g->ast, first)->nextSibling);
+            break;
+        case AST_FOR: {
+            NodeId cond = astNode(g->ast, first)->nextSibling;
+            NodeId step = astNode(g->ast, cond)->nextSibling;
+            enterScope(&g->table);
+            if (astNode(g->ast, first)->kind == AST_VAR_DECL) {
+                irLocal(g, first);
+            } else if (astNode(g->ast, first)->kind != AST_EMPTY) {
+                irExpression(g, first);
+            }
+            irLoop(g, cond, step, astNode(g->ast, step)->nextSibling);
+            leaveScope(&g->table);
+            break;
+        }
+        case AST_RETURN: {
+            VReg value = first ? irConvert(g, irExpression(g, first), g->fn->returnType) : 0;
+            irEmit(g->fn, IR_RET, g->fn->returnType, 0, value, 0);
+            break;
+        }
+        case AST_TRY:
+            irBlock(g, first);  // Sem exceções, os blocos 'catch' nunca executam
+            break;
+        default:
+            break;
+    }
+}
+
+// Função para gerar o corpo de um método
+void irMethod(IrGenerator *g, NodeId id) {
+    int index = irFunctionByDecl(g->module, id);
+    g->fn = &g->module->functions[index];
+
+    enterScope(&g->table);
+    VReg param = 1;
+    for (NodeId child = astNode(g->ast, astNode(g->ast, id)->firstChild)->nextSibling; child;
+         child = astNode(g->ast, child)->nextSibling) {
+        const AstNode *node = astNode(g->ast, child);
+        if (node->kind == AST_PARAM) {
+            Symbol *symbol = declareSymbol(&g->table, g->ast->source + node->offset, node->length,
+                                           SYM_PARAMETER, typeOfNode(g->ast, node->firstChild), child);
+            if (symbol) {
+                symbol->slot = param;
+            }
+            param++;
+        } else {
+            irBlock(g, child);
+        }
+    }
+    leaveScope(&g->table);
+
+    // Retorno implícito ao fim do corpo
+    if (!g->fn->count || g->fn->code[g->fn->count - 1].op != IR_RET) {
+        VReg value = g->fn->returnType == IR_VOID ? 0 : irConstant(g, g->fn->returnType, 0);
+        irEmit(g->fn, IR_RET, g->fn->returnType, 0, value, 0);
+    }
+}
+
+// Função para criar as funções e globais do programa, em ordem de nó (primeira passagem)
+void irCreateDeclarations(IrGenerator *g, NodeId parent) {
+    for (NodeId id = astNode(g->ast, parent)->firstChild; id; id = astNode(g->ast, id)->nextSibling) {
+        const AstNode *node = astNode(g->ast, id);
+        if (node->kind == AST_METHOD) {
+            uint8_t returnType = irTypeFromKind(typeOfNode(g->ast, node->firstChild));
+            uint32_t index = irNewFunction(g->module, g->ast->source + node->offset, node->length, id, returnType);
+            IrFunction *fn = &g->module->functions[index];
+            fn->constructor = (node->flags & MOD_CONSTRUCTOR) != 0;
+            for (NodeId child = astNode(g->ast, node->firstChild)->nextSibling; child;
+                 child = astNode(g->ast, child)->nextSibling) {
+                if (astNode(g->ast, child)->kind == AST_PARAM) {
+                    irNewVreg(fn, irTypeFromKind(typeOfNode(g->ast, astNode(g->ast, child)->firstChild)));
+                    fn->paramCount++;
+                }
+            }
+            if (fn->paramCount) {
+                fn->paramTypes = malloc(fn->paramCount);
+                memcpy(fn->paramTypes, fn->vregTypes + 1, fn->paramCount);
+            }
+            if (!fn->constructor && (nodeTextIs(g->ast, id, "Main") || nodeTextIs(g->ast, id, "main")) &&
+                g->module->entry < 0) {
+                g->module->entry = (int)index;
+            }
+        } else if (node->kind == AST_VAR_DECL) {
+            g->module->globals = vectorGrow(g->module->globals, &g->module->globalCapacity,
+                                            g->module->globalCount + 1, sizeof(IrGlobal));
+            IrGlobal *global = &g->module->globals[g->module->globalCount++];
+            global->name = g->ast->source + node->offset;
+            global->nameLength = node->length;
+            global->decl = id;
+            global->type = irTypeFromKind(node->type);
+        } else if (node->kind == AST_CLASS || node->kind == AST_NAMESPACE) {
+            irCreateDeclarations(g, id);
+        }
+    }
+}
+
+// Função para declarar os membros de um contêiner (métodos, campos e classes) no escopo atual
+void irDeclareMembers(IrGenerator *g, NodeId parent) {
+    for (NodeId id = astNode(g->ast, parent)->firstChild; id; id = astNode(g->ast, id)->nextSibling) {
+        const AstNode *node = astNode(g->ast, id);
+        Symbol *symbol = NULL;
+        if (node->kind == AST_METHOD && !(node->flags & MOD_CONSTRUCTOR)) {
+            symbol = declareSymbol(&g->table, g->ast->source + node->offset, node->length, SYM_METHOD, 0, id);
+            if (symbol) symbol->slot = (uint32_t)irFunctionByDecl(g->module, id);
+        } else if (node->kind == AST_VAR_DECL) {
+            symbol = declareSymbol(&g->table, g->ast->source + node->offset, node->length, SYM_FIELD, node->type, id);
+            if (symbol) symbol->slot = (uint32_t)irGlobalByDecl(g->module, id);
+        } else if (node->kind == AST_CLASS) {
+            declareSymbol(&g->table, g->ast->source + node->offset, node->length, SYM_CLASS, TY_CLASS, id);
+        }
+    }
+}
+
+// Função para registrar um método adiado com o caminho de contêineres que o envolve
+void irDeferMethod(IrGenerator *g, NodeId id) {
+    uint32_t index = (uint32_t)irFunctionByDecl(g->module, id);
+    g->paths = vectorGrow(g->paths, &g->pathCapacity, g->pathCount + g->scopeCount, sizeof(NodeId));
+    memcpy(g->paths + g->pathCount, g->scopes, g->scopeCount * sizeof(NodeId));
+    g->pathStart[index] = g->pathCount;
+    g->pathCount += g->scopeCount;
+    g->pathStart[index + 1] = g->pathCount;
+}
+
+// Função para gerar uma lista de declarações com os mesmos escopos da análise semântica
+void irDeclarations(IrGenerator *g, NodeId parent) {
+    g->scopes = vectorGrow(g->scopes, &g->scopeCapacity, g->scopeCount + 1, sizeof(NodeId));
+    g->scopes[g->scopeCount++] = parent;
+    irDeclareMembers(g, parent);
+
+    for (NodeId id = astNode(g->ast, parent)->firstChild; id; id = astNode(g->ast, id)->nextSibling) {
+        const AstNode *node = astNode(g->ast, id);
+        switch ((NodeKind)node->kind) {
+            case AST_VAR_DECL: {
+                // Inicializações de campos vão para a função 0
+                NodeId init = astNode(g->ast, node->firstChild)->nextSibling;
+                if (init) {
+                    const IrGlobal *global = &g->module->globals[irGlobalByDecl(g->module, id)];
+                    g->fn = &g->module->functions[0];
+                    VReg value = irConvert(g, irExpression(g, init), global->type);
+                    irEmit(g->fn, IR_STORE_GLOBAL, global->type, 0, (uint32_t)(global - g->module->globals), value);
+                }
+                break;
+            }
+            case AST_METHOD:
+                if (g->deferMethods) {
+                    irDeferMethod(g, id);
+                } else {
+                    irMethod(g, id);
+                }
+                break;
+            case AST_CLASS:
+            case AST_NAMESPACE:
+                enterScope(&g->table);
+                irDeclarations(g, id);
+                leaveScope(&g->table);
+                break;
+            default:
+                break;
+        }
+    }
+    g->scopeCount--;
+}
+
+// Função para declarar os nomes pré-definidos no escopo mais externo
+void irDeclareBuiltins(IrGenerator *g) {
+    Symbol *printfSymbol = declareSymbol(&g->table, "printf", 6, SYM_METHOD, TY_INT, 0);
+    printfSymbol->builtin = 1;
+    printfSymbol->slot = BUILTIN_PRINTF;
+}
+
+// Função para liberar o estado do gerador
+void irGeneratorFree(IrGenerator *g) {
+    symbolTableFree(&g->table);
+    free(g->scopes);
+    free(g->paths);
+    free(g->pathStart);
+    g->scopes = g->paths = NULL;
+    g->pathStart = NULL;
+}
+
+// Função para gerar as declarações e, se 'deferMethods' for 0, os corpos dos métodos; devolve o número de erros
+int irGenerateModule(IrGenerator *g, IrModule *module, Ast *ast, int deferMethods) {
+    memset(g, 0, sizeof(*g));
+    g->ast = ast;
+    g->module = module;
+    g->deferMethods = deferMethods;
+    irModuleInit(module);
+    symbolTableInit(&g->table);
+
+    // Função 0: inicialização dos campos
+    static const char initName[] = "<inicialização>";
+    irNewFunction(module, initName, sizeof(initName) - 1, 0, IR_VOID);
+    irCreateDeclarations(g, ast->root);
+    g->pathStart = calloc(module->functionCount + 1, sizeof(uint32_t));
+
+    irDeclareBuiltins(g);
+    enterScope(&g->table);
+    irDeclarations(g, ast->root);
+    leaveScope(&g->table);
+
+    irEmit(&module->functions[0], IR_RET, IR_VOID, 0, 0, 0);
+    return g->errorCount;
+}
+
+// Função principal da geração: traduz a AST (já verificada) em 'module'; devolve o número de erros
+int generateIr(IrGenerator *g, IrModule *module, Ast *ast) {
+    int errors = irGenerateModule(g, module, ast, 0);
+    irGeneratorFree(g);
+    return errors;
+}
+
+// Função para gerar o corpo de um método adiado por irGenerateModule; devolve o número de erros.
+// Usa uma tabela de símbolos própria, reconstruída a partir dos contêineres que envolvem o método,
+// e só escreve na sua função: chamadas para funções diferentes podem rodar em threads diferentes
+int irGenerateMethod(const IrGenerator *deferred, uint32_t index) {
+    IrGenerator g;
+    memset(&g, 0, sizeof(g));
+    g.ast = deferred->ast;
+    g.module = deferred->module;
+    symbolTableInit(&g.table);
+    irDeclareBuiltins(&g);
+    for (uint32_t i = deferred->pathStart[index]; i < deferred->pathStart[index + 1]; i++) {
+        enterScope(&g.table);
+        irDeclareMembers(&g, deferred->paths[i]);
+    }
+    irMethod(&g, g.module->functions[index].decl);
+    symbolTableFree(&g.table);
+    return g.errorCount;
+}
+
+#endif
@@ -0,0 +1,284 @@
+/*
+ * Compilação paralela por função
+ *
+ * Depois da análise semântica, as declarações e a inicialização dos campos
+ * são geradas em série (irGenerateModule com os métodos adiados) e cada
+ * função vira uma tarefa independente: geração do código intermediário
+ * (irGenerateMethod), otimização e código de máquina (x86Function). As
+ * threads retiram o próximo índice de um contador atômico; cada tarefa só
+ * escreve na sua própria função e no seu próprio resultado.
+ *
+ * Estruturas principais:
+ * - ParallelResult: Código de máquina de uma função, guardado em uma arena
+ *   própria (arena.h) até a junção: bytes do código e de .rodata, dados,
+ *   relocações e chamadas a outras funções ainda não resolvidas
+ * - ParallelWorker: Montador de rascunho da thread, reaproveitado de uma
+ *   função para a outra (os vetores crescem só nas primeiras funções)
+ *
+ * Memória: durante a geração nenhuma estrutura é compartilhada para
+ * escrita; o resultado de cada função é um único bloco, liberado de uma vez
+ * depois da junção.
+ *
+ * Determinismo: a junção percorre as funções em ordem, alinhando cada uma
+ * em 16 bytes e readicionando os seus dados com o mesmo alinhamento. Os
+ * desvios internos já estão resolvidos (são relativos) e as chamadas entre
+ * funções viram referências aos rótulos do montador final. O objeto é
+ * idêntico, byte a byte, ao de x86Generate, com qualquer número de threads.
+ */
+
+#ifndef COMPILACAO_PARALELA_H
+#define COMPILACAO_PARALELA_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "arena.h"
+#include "codigo de maquina.h"
+
+#define PARALLEL_MAX_THREADS 64
+
+// Estrutura do código de máquina de uma função (deslocamentos na arena)
+typedef struct {
+    Arena arena;
+    uint32_t code;
+    uint32_t codeSize;
+    uint32_t entry;            // Posição do rótulo da função no seu código
+    uint32_t rodata;
+    uint32_t rodataSize;
+    uint32_t data;             // X86Data a partir do dado 1 (o dado 0 são as globais)
+    uint32_t dataCount;
+    uint32_t relocs;
+    uint32_t relocCount;
+    uint32_t calls;            // X86Fixup com o índice da função chamada em 'label'
+    uint32_t callCount;
+    X86Stats stats;
+    OptStats optStats;
+    int errors;
+} ParallelResult;
+
+// Estrutura do estado compartilhado (somente leitura, exceto o contador)
+typedef struct {
+    IrGenerator generator;     // Caminhos dos métodos adiados
+    IrModule *module;
+    int optimize;
+    uint32_t *identity;        // Rótulo i = função i no montador de rascunho
+    ParallelResult *results;
+    atomic_uint next;
+} ParallelJob;
+
+// Estrutura de uma thread
+typedef struct {
+    ParallelJob *job;
+    X86Asm scratch;
+    pthread_t thread;
+} ParallelWorker;
+
+// Estrutura das estatísticas da compilação
+typedef struct {
+    X86Stats x86;
+    OptStats opt;
+    uint32_t threads;
+} ParallelStats;
+
+// Função para copiar 'size' bytes para a arena; devolve o deslocamento
+uint32_t parallelCopy(Arena *arena, const void *bytes, uint32_t size) {
+    if (!size) {
+        return 0;
+    }
+    uint32_t ref = arenaAlloc(arena, size);
+    memcpy(arena->base + ref, bytes, size);
+    return ref;
+}
+
+// Função para compilar a função 'index' até o código de máquina
+void parallelCompileFunction(ParallelWorker *worker, uint32_t index) {
+    ParallelJob *job = worker->job;
+    ParallelResult *result = &job->results[index];
+    IrFunction *fn = &job->module->functions[index];
+    if (index > 0) {
+        result->errors += irGenerateMethod(&job->generator, index);
+    }
+    if (result->errors) {
+        return;
+    }
+    if (job->optimize) {
+        optimizeFunction(fn, &result->optStats, 0);
+    }
+
+    // Montador de rascunho com a mesma numeração de dados e de rótulos de função do montador final
+    X86Asm *as = &worker->scratch;
+    x86Reset(as);
+    x86AddData(as, SECTION_BSS, DATA_GLOBALS, NULL, 8 * (job->module->globalCount ? job->module->globalCount : 1), 16);
+    for (uint32_t i = 0; i < job->module->functionCount; i++) {
+        x86NewLabel(as);
+    }
+    result->errors += x86Function(as, job->module, index, job->identity, &result->stats);
+
+    // Desvios internos resolvidos aqui; sobram as chamadas a outras funções
+    uint32_t pending = 0;
+    for (uint32_t i = 0; i < as->fixupCount; i++) {
+        X86Fixup fixup = as->fixups[i];
+        if (as->labels[fixup.label] != OPT_NONE) {
+            int32_t rel = (int32_t)(as->labels[fixup.label] - (fixup.at + 4));
+            memcpy(as->code + fixup.at, &rel, sizeof(rel));
+        } else {
+            as->fixups[pending++] = fixup;
+        }
+    }
+
+    // Um único bloco por função
+    uint32_t dataCount = as->dataCount - 1;
+    arenaInit(&result->arena, as->size + as->rodataSize + dataCount * sizeof(X86Data) +
+                              as->relocCount * sizeof(X86Reloc) + pending * sizeof(X86Fixup) + 64);
+    result->code = parallelCopy(&result->arena, as->code, as->size);
+    result->codeSize = as->size;
+    result->entry = as->labels[index];
+    result->rodata = parallelCopy(&result->arena, as->rodata, as->rodataSize);
+    result->rodataSize = as->rodataSize;
+    result->data = parallelCopy(&result->arena, as->data + 1, dataCount * sizeof(X86Data));
+    result->dataCount = dataCount;
+    result->relocs = parallelCopy(&result->arena, as->relocs, as->relocCount * sizeof(X86Reloc));
+    result->relocCount = as->relocCount;
+    result->calls = parallelCopy(&result->arena, as->fixups, pending * sizeof(X86Fixup));
+    result->callCount = pending;
+}
+
+// Função executada por cada thread: compila funções até o contador passar do fim
+void *parallelWorkerRun(void *argument) {
+    ParallelWorker *worker = argument;
+    ParallelJob *job = worker->job;
+    uint32_t index;
+    while ((index = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed)) < job->module->functionCount) {
+        parallelCompileFunction(worker, index);
+    }
+    return NULL;
+}
+
+// Função para anexar o código de uma função ao montador final
+void parallelMerge(X86Asm *as, const ParallelResult *result, uint32_t functionLabel, uint32_t *dataMap,
+                   const uint32_t *functionLabels) {
+    const Arena *arena = &result->arena;
+    x86Align(as, 16);
+    uint32_t base = as->size;
+    as->code = vectorGrow(as->code, &as->capacity, base + result->codeSize, 1);
+    memcpy(as->code + base, arena->base + result->code, result->codeSize);
+    as->size = base + result->codeSize;
+    as->labels[functionLabel] = base + result->entry;
+
+    // Dados na mesma ordem e com o mesmo alinhamento que x86Generate usaria
+    const X86Data *data = ARENA_AT(arena, const X86Data, result->data);
+    dataMap[0] = 0;
+    for (uint32_t i = 0; i < result->dataCount; i++) {
+        const void *bytes = data[i].section == SECTION_RODATA ? arena->base + result->rodata + data[i].offset : NULL;
+        dataMap[i + 1] = x86AddData(as, (X86Section)data[i].section, (X86DataKind)data[i].kind, bytes,
+                                    data[i].size, data[i].align);
+    }
+
+    const X86Reloc *relocs = ARENA_AT(arena, const X86Reloc, result->relocs);
+    as->relocs = vectorGrow(as->relocs, &as->relocCapacity, as->relocCount + result->relocCount, sizeof(X86Reloc));
+    for (uint32_t i = 0; i < result->relocCount; i++) {
+        X86Reloc reloc = relocs[i];
+        reloc.at += base;
+        if (reloc.kind == RELOC_DATA) {
+            reloc.target = dataMap[reloc.target];
+        }
+        as->relocs[as->relocCount++] = reloc;
+    }
+
+    const X86Fixup *calls = ARENA_AT(arena, const X86Fixup, result->calls);
+    as->fixups = vectorGrow(as->fixups, &as->fixupCapacity, as->fixupCount + result->callCount, sizeof(X86Fixup));
+    for (uint32_t i = 0; i < result->callCount; i++) {
+        as->fixups[as->fixupCount++] = (X86Fixup){base + calls[i].at, functionLabels[calls[i].label]};
+    }
+}
+
+// Função para compilar a AST (já verificada) em 'as' com 'threads' threads (0 = número de processadores).
+// Deixa em 'module' o código intermediário final; devolve o número de erros (com erros, 'module' é liberado)
+int parallelCompile(X86Asm *as, IrModule *module, Ast *ast, int optimize, uint32_t threads, ParallelStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    ParallelJob job;
+    memset(&job, 0, sizeof(job));
+    job.module = module;
+    job.optimize = optimize;
+    int errors = irGenerateModule(&job.generator, module, ast, 1);
+    if (errors) {
+        irGeneratorFree(&job.generator);
+        irModuleFree(module);
+        return errors;
+    }
+
+    // Estado global preguiçoso construído antes das threads (mensagens de erro com linha e coluna)
+    if (!lineStarts) {
+        buildLineIndex();
+    }
+
+    if (!threads) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (uint32_t)online : 1;
+    }
+    if (threads > PARALLEL_MAX_THREADS) {
+        threads = PARALLEL_MAX_THREADS;
+    }
+    if (threads > module->functionCount) {
+        threads = module->functionCount ? module->functionCount : 1;
+    }
+    stats->threads = threads;
+
+    job.identity = optCalloc(module->functionCount + 1, sizeof(uint32_t));
+    for (uint32_t i = 0; i < module->functionCount; i++) {
+        job.identity[i] = i;
+    }
+    job.results = optCalloc(module->functionCount + 1, sizeof(ParallelResult));
+    atomic_init(&job.next, 0);
+
+    // A thread atual é a de índice 0
+    ParallelWorker *workers = optCalloc(threads, sizeof(ParallelWorker));
+    for (uint32_t t = 0; t < threads; t++) {
+        workers[t].job = &job;
+    }
+    for (uint32_t t = 1; t < threads; t++) {
+        if (pthread_create(&workers[t].thread, NULL, parallelWorkerRun, &workers[t]) != 0) {
+            workers[t].job = NULL;   // Sem a thread, as funções ficam com as demais
+        }
+    }
+    parallelWorkerRun(&workers[0]);
+    for (uint32_t t = 1; t < threads; t++) {
+        if (workers[t].job) {
+            pthread_join(workers[t].thread, NULL);
+        }
+    }
+    for (uint32_t t = 0; t < threads; t++) {
+        x86Free(&workers[t].scratch);
+    }
+    free(workers);
+
+    // Junção em ordem
+    uint32_t *functionLabels = x86GenerateEntry(as, module);
+    uint32_t *dataMap = NULL, dataCapacity = 0;
+    for (uint32_t i = 0; i < module->functionCount; i++) {
+        ParallelResult *result = &job.results[i];
+        errors += result->errors;
+        optAddStats(&stats->opt, &result->optStats);
+        stats->x86.intervals += result->stats.intervals;
+        stats->x86.spilled += result->stats.spilled;
+        stats->x86.functions++;
+        if (!errors) {
+            dataMap = vectorGrow(dataMap, &dataCapacity, result->dataCount + 1, sizeof(uint32_t));
+            parallelMerge(as, result, functionLabels[i], dataMap, functionLabels);
+        }
+        arenaFree(&result->arena);
+    }
+    x86ResolveLabels(as);
+
+    free(dataMap);
+    free(functionLabels);
+    free(job.results);
+    free(job.identity);
+    irGeneratorFree(&job.generator);
+    if (errors) {
+        irModuleFree(module);
+    }
+    return errors;
+}
+
+#endif
@@ -0,0 +1,230 @@
+/*
+ * Fluxo de tokens compactado
+ *
+ * Guarda uma lista de tokens em poucos bytes por token, ao lado do código
+ * fonte que a originou. O texto de um token é sempre o trecho do código no
+ * seu deslocamento (só truncado em MAX_TOKEN_LENGTH - 1 bytes), então o
+ * fluxo guarda apenas onde cada token começa, o seu tamanho e o seu tipo,
+ * e a decodificação copia o texto do próprio código.
+ *
+ * Formato (um único bloco):
+ * - Tipos: 4 bits por token, dois por byte. Os 15 tipos mais comuns têm
+ *   código próprio; o código 15 diz que o tipo está no próximo byte dos
+ *   escapes (STRING_LITERAL, colchetes e DIRECTIVE)
+ * - Escapes: um byte por token com tipo fora dos 15 códigos
+ * - Valores em stream-vbyte: para cada token, a distância entre o fim do
+ *   token anterior e o seu início (quase sempre 0 ou 1) e o seu tamanho.
+ *   Um byte de controle descreve 4 valores (2 bits cada: 1 a 4 bytes) e
+ *   os bytes dos valores ficam em uma seção separada, seguida de 16 bytes
+ *   de folga. Com SSSE3, cada byte de controle vira uma única instrução
+ *   pshufb com a máscara da sua tabela de 256 entradas; sem SSSE3, uma
+ *   tabela com a posição de cada valor permite 4 leituras independentes de
+ *   32 bits com máscara, sem laço por byte
+ *
+ * Os tokens não guardam linha: linha e coluna continuam vindo do índice de
+ * inícios de linha do código (buildLineStarts).
+ *
+ * Limitações:
+ * - A codificação falha (devolve -1) se algum token não for um trecho do
+ *   código na sua posição, e o chamador deve manter a lista original
+ */
+
+#ifndef FLUXO_DE_TOKENS_H
+#define FLUXO_DE_TOKENS_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "analise lexica.h"
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#define TOKEN_STREAM_ESCAPE 15
+#define TOKEN_STREAM_PADDING 16
+
+// Estrutura de um fluxo compactado
+typedef struct {
+    uint8_t *bytes;
+    uint32_t count;            // Tokens
+    uint32_t escapes;          // Bytes da seção de escapes
+    uint32_t dataSize;         // Bytes dos valores (sem a folga)
+    uint32_t size;             // Tamanho total do bloco
+} TokenStream;
+
+// Código de 4 bits de cada tipo (TOKEN_STREAM_ESCAPE = tipo no byte de escape)
+static const uint8_t tokenStreamNibble[UNKNOWN + 1] = {
+    [KEYWORD] = 0, [TYPE] = 1, [IDENTIFIER] = 2, [NUM_LITERAL] = 3, [SEMICOLON] = 4, [COMMA] = 5,
+    [OPERATOR] = 6, [ASSIGNMENT] = 7, [OPEN_PARENTHESIS] = 8, [CLOSE_PARENTHESIS] = 9, [OPEN_BRACE] = 10,
+    [CLOSE_BRACE] = 11, [COMPARATOR] = 12, [QUOTE] = 13, [UNKNOWN] = 14,
+    [STRING_LITERAL] = TOKEN_STREAM_ESCAPE, [OPEN_BRACKET] = TOKEN_STREAM_ESCAPE,
+    [CLOSE_BRACKET] = TOKEN_STREAM_ESCAPE, [DIRECTIVE] = TOKEN_STREAM_ESCAPE
+};
+
+// Tipo de cada código de 4 bits
+static const uint8_t tokenStreamType[TOKEN_STREAM_ESCAPE] = {
+    KEYWORD, TYPE, IDENTIFIER, NUM_LITERAL, SEMICOLON, COMMA, OPERATOR, ASSIGNMENT,
+    OPEN_PARENTHESIS, CLOSE_PARENTHESIS, OPEN_BRACE, CLOSE_BRACE, COMPARATOR, QUOTE, UNKNOWN
+};
+
+// Tabelas do stream-vbyte: bytes usados pelos 4 valores de cada byte de controle e máscaras do pshufb
+static uint8_t tokenStreamLengths[256];
+static uint8_t tokenStreamShuffles[256][16];
+static uint8_t tokenStreamStarts[256][4];     // Posição de cada um dos 4 valores (caminho sem SSSE3)
+static pthread_once_t tokenStreamTablesOnce = PTHREAD_ONCE_INIT;
+
+// Função para montar as tabelas do stream-vbyte
+static void tokenStreamBuildTables(void) {
+    for (int control = 0; control < 256; control++) {
+        int used = 0;
+        for (int k = 0; k < 4; k++) {
+            int length = ((control >> (2 * k)) & 3) + 1;
+            tokenStreamStarts[control][k] = (uint8_t)used;
+            for (int b = 0; b < 4; b++) {
+                tokenStreamShuffles[control][4 * k + b] = b < length ? (uint8_t)(used + b) : 0x80;   // 0x80 zera o byte
+            }
+            used += length;
+        }
+        tokenStreamLengths[control] = (uint8_t)used;
+    }
+}
+
+// Função para liberar um fluxo
+void tokenStreamFree(TokenStream *stream) {
+    free(stream->bytes);
+    memset(stream, 0, sizeof(*stream));
+}
+
+// Função para medir em quantos bytes (1 a 4) um valor cabe
+static int tokenStreamValueLength(uint32_t value) {
+    return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+}
+
+// Função para compactar 'count' tokens de 'code'; devolve 0 ou -1 (algum token não é um trecho do código)
+int tokenStreamEncode(TokenStream *stream, const Token *tokens, int count, const char *code) {
+    pthread_once(&tokenStreamTablesOnce, tokenStreamBuildTables);
+    memset(stream, 0, sizeof(*stream));
+
+    // Primeira passada: confere os tokens e mede as seções
+    uint64_t dataSize = 0;
+    uint32_t escapes = 0, end = 0;
+    for (int i = 0; i < count; i++) {
+        const Token *token = &tokens[i];
+        uint32_t stored = (uint32_t)token->size < MAX_TOKEN_LENGTH - 1 ? (uint32_t)token->size : MAX_TOKEN_LENGTH - 1;
+        if (token->offset < 0 || (uint32_t)token->offset < end || (uint32_t)token->type > UNKNOWN ||
+            token->size < 0 || strlen(token->value) != stored || memcmp(token->value, code + token->offset, stored) != 0) {
+            return -1;
+        }
+        dataSize += tokenStreamValueLength((uint32_t)token->offset - end) + tokenStreamValueLength((uint32_t)token->size);
+        escapes += tokenStreamNibble[token->type] == TOKEN_STREAM_ESCAPE;
+        end = (uint32_t)token->offset + (uint32_t)token->size;
+    }
+    uint64_t nibbleBytes = ((uint64_t)count + 1) / 2, controlBytes = ((uint64_t)count * 2 + 3) / 4;
+    uint64_t size = nibbleBytes + escapes + controlBytes + dataSize + TOKEN_STREAM_PADDING;
+    if (size > UINT32_MAX) {
+        return -1;
+    }
+    uint8_t *bytes = calloc(size, 1);
+    if (!bytes) {
+        fprintf(stderr, "Erro: Falha ao alocar o fluxo de tokens.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Segunda passada: grava tipos, escapes, controles e valores
+    uint8_t *nibbles = bytes, *escape = bytes + nibbleBytes, *control = escape + escapes;
+    uint8_t *data = control + controlBytes;
+    uint32_t value = 0;
+    end = 0;
+    for (int i = 0; i < count; i++) {
+        const Token *token = &tokens[i];
+        uint8_t nibble = tokenStreamNibble[token->type];
+        nibbles[i / 2] |= (uint8_t)(nibble << (4 * (i & 1)));
+        if (nibble == TOKEN_STREAM_ESCAPE) {
+            *escape++ = (uint8_t)token->type;
+        }
+        uint32_t pair[2] = {(uint32_t)token->offset - end, (uint32_t)token->size};
+        for (int k = 0; k < 2; k++, value++) {
+            int length = tokenStreamValueLength(pair[k]);
+            control[value / 4] |= (uint8_t)((length - 1) << (2 * (value % 4)));
+            memcpy(data, &pair[k], length);   // Ordem de bytes little-endian (x86)
+            data += length;
+        }
+        end = (uint32_t)token->offset + (uint32_t)token->size;
+    }
+    stream->bytes = bytes;
+    stream->count = (uint32_t)count;
+    stream->escapes = escapes;
+    stream->dataSize = (uint32_t)dataSize;
+    stream->size = (uint32_t)size;
+    return 0;
+}
+
+// Função para decodificar deslocamentos, tamanhos e tipos de todos os tokens (vetores com 'count' posições)
+void tokenStreamDecodeFields(const TokenStream *stream, uint32_t *offsets, uint32_t *sizes, uint8_t *types) {
+    pthread_once(&tokenStreamTablesOnce, tokenStreamBuildTables);
+    uint32_t count = stream->count;
+    const uint8_t *nibbles = stream->bytes, *escape = nibbles + (count + 1) / 2;
+    const uint8_t *control = escape + stream->escapes;
+    const uint8_t *data = control + ((uint64_t)count * 2 + 3) / 4;
+
+    // Tipos: dois por byte, o escape só quando o código é 15
+    for (uint32_t i = 0; i < count; i += 2) {
+        uint8_t pair = nibbles[i / 2];
+        types[i] = (pair & 0x0F) == TOKEN_STREAM_ESCAPE ? *escape++ : tokenStreamType[pair & 0x0F];
+        if (i + 1 < count) {
+            types[i + 1] = (pair >> 4) == TOKEN_STREAM_ESCAPE ? *escape++ : tokenStreamType[pair >> 4];
+        }
+    }
+
+    // Valores: um byte de controle = 4 valores = 2 tokens
+    uint32_t end = 0;
+    uint32_t values[4];
+    for (uint32_t i = 0; i < count; i += 2) {
+        uint8_t bits = *control++;
+#ifdef __SSSE3__
+        __m128i block = _mm_loadu_si128((const __m128i *)data);
+        block = _mm_shuffle_epi8(block, _mm_loadu_si128((const __m128i *)tokenStreamShuffles[bits]));
+        _mm_storeu_si128((__m128i *)values, block);
+#else
+        for (int k = 0; k < 4; k++) {
+            uint32_t word;
+            memcpy(&word, data + tokenStreamStarts[bits][k], sizeof(word));
+            values[k] = word & (0xFFFFFFFFu >> (8 * (3 - ((bits >> (2 * k)) & 3))));
+        }
+#endif
+        data += tokenStreamLengths[bits];
+        offsets[i] = end + values[0];
+        sizes[i] = values[1];
+        end = offsets[i] + values[1];
+        if (i + 1 < count) {
+            offsets[i + 1] = end + values[2];
+            sizes[i + 1] = values[3];
+            end = offsets[i + 1] + values[3];
+        }
+    }
+}
+
+// Função para reconstruir a lista de tokens de um fluxo ('tokens' com 'count' posições)
+void tokenStreamDecode(const TokenStream *stream, const char *code, Token *tokens) {
+    uint32_t *offsets = malloc(((size_t)stream->count + 1) * sizeof(uint32_t));
+    uint32_t *sizes = malloc(((size_t)stream->count + 1) * sizeof(uint32_t));
+    uint8_t *types = malloc((size_t)stream->count + 1);
+    if (!offsets || !sizes || !types) {
+        fprintf(stderr, "Erro: Falha ao alocar a decodificação dos tokens.\n");
+        exit(EXIT_FAILURE);
+    }
+    tokenStreamDecodeFields(stream, offsets, sizes, types);
+    for (uint32_t i = 0; i < stream->count; i++) {
+        Token *token = &tokens[i];
+        uint32_t stored = sizes[i] < MAX_TOKEN_LENGTH - 1 ? sizes[i] : MAX_TOKEN_LENGTH - 1;
+        memcpy(token->value, code + offsets[i], stored);
+        token->value[stored] = '\0';
+        token->offset = (int)offsets[i];
+        token->type = (TokenType)types[i];
+        token->size = (int)sizes[i];
+    }
+    free(offsets);
+    free(sizes);
+    free(types);
+}
+
+#endif
@@ -0,0 +1,634 @@
+/*
+ * Inclusão de arquivos ('#include') com cache de tokens dos cabeçalhos
+ *
+ * Resolve as diretivas '#include' de um arquivo e monta a sequência de
+ * tokens da unidade de tradução sem copiar tokens: cada cabeçalho é lido e
+ * analisado uma única vez por processo, e a unidade é uma lista de trechos
+ * (TokenSpan) que apontam para a lista de tokens do próprio arquivo ou para
+ * a de um cabeçalho em cache. Cada arquivo é registrado na tabela de
+ * arquivos (localizacao de codigo.h): um trecho guarda só a base do seu
+ * arquivo, e base + deslocamento do token é a SourceLoc que o localiza.
+ *
+ * Estruturas principais:
+ * - SourceFile: Arquivo analisado (código, tokens, base na tabela de
+ *   arquivos, guard e as diretivas #include/#define/#undef em ordem).
+ *   Imutável depois de publicado, exceto o destino de cada '#include',
+ *   resolvido uma vez
+ * - HeaderCache: Mapa caminho canônico -> SourceFile compartilhado pelas
+ *   threads, de leitura frequente e escrita rara. A busca não usa trava
+ *   (endereçamento aberto; cada posição é preenchida uma única vez, com
+ *   release); só a inserção usa o mutex, e a análise do cabeçalho acontece
+ *   fora dele. Quem encontra um cabeçalho ainda em análise espera na
+ *   variável de condição. Com um leitor em lote (leitura em lote.h), os
+ *   cabeçalhos são lidos pela mesma E/S dos arquivos de entrada
+ * - TranslationUnit: Trechos de tokens na ordem da unidade e os símbolos
+ *   definidos até o ponto atual
+ *
+ * Include guards: um cabeçalho cujo primeiro token é '#ifndef X' (ou
+ * '#if !defined X'), o segundo '#define X' e cujo '#endif' correspondente
+ * é o último token é protegido por X; com '#pragma once' ele é protegido
+ * pela própria identidade. Uma nova inclusão de um cabeçalho protegido é
+ * pulada sem olhar os seus tokens enquanto X continuar definido na unidade
+ * (com '#pragma once', sempre).
+ *
+ * Busca: '#include "x"' procura no diretório do arquivo que inclui e depois
+ * nos diretórios de busca; '#include <x>' só nos diretórios de busca (os de
+ * includeDirectory e depois os do sistema). Cabeçalhos não encontrados são
+ * contados e deixados de fora.
+ *
+ * Limitações:
+ * - Os '#if' de um cabeçalho são avaliados uma vez, só com os símbolos de
+ *   defineSymbol e os do próprio cabeçalho (não com os de quem o inclui)
+ * - Sem expansão de macros: '#include MACRO' não é resolvido
+ * - Até INCLUDE_MAX_DEPTH inclusões aninhadas (um ciclo sem guard para aí)
+ * - Até HEADER_CACHE_SLOTS / 2 cabeçalhos distintos por processo
+ */
+
+#ifndef INCLUSAO_DE_ARQUIVOS_H
+#define INCLUSAO_DE_ARQUIVOS_H
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "localizacao de codigo.h"
+#include "leitura em lote.h"
+#include "vetor dinamico.h"
+
+#define HEADER_CACHE_SLOTS 4096
+#define INCLUDE_MAX_DIRECTORIES 64
+#define INCLUDE_MAX_DEPTH 200
+
+// Diretórios de busca do sistema, depois dos de includeDirectory
+static const char *systemIncludeDirectories[] = {
+    "/usr/local/include",
+#if defined(__x86_64__)
+    "/usr/include/x86_64-linux-gnu",
+#elif defined(__aarch64__)
+    "/usr/include/aarch64-linux-gnu",
+#endif
+    "/usr/include",
+};
+
+// Diretivas que interessam à unidade de tradução
+typedef enum {
+    EVENT_INCLUDE,
+    EVENT_DEFINE,
+    EVENT_UNDEF
+} DirectiveEventKind;
+
+typedef struct SourceFile SourceFile;
+
+// Estrutura de uma diretiva '#include', '#define' ou '#undef' de um arquivo
+typedef struct {
+    int token;                       // Índice do token DIRECTIVE
+    DirectiveEventKind kind;
+    _Atomic(SourceFile *) target;    // '#include': cabeçalho resolvido (NULL = ainda não resolvido)
+} DirectiveEvent;
+
+// Estrutura de um arquivo analisado
+struct SourceFile {
+    char *path;                      // Caminho canônico (realpath)
+    uint64_t hash;
+    char *code;
+    Token *tokens;
+    int tokenCount;
+    SourceLoc base;                  // Localização do primeiro byte
+    DirectiveEvent *events;
+    int eventCount;
+    char guard[MAX_TOKEN_LENGTH];    // Símbolo do include guard ("" se não houver)
+    int pragmaOnce;
+    atomic_int ready;                // Publicado: tokens e diretivas prontos
+};
+
+// Destino de um '#include' que não foi encontrado
+static SourceFile missingHeader;
+
+// Estrutura do cache de cabeçalhos compartilhado pelas threads
+typedef struct {
+    _Atomic(SourceFile *) slots[HEADER_CACHE_SLOTS];
+    int count;                       // Posições ocupadas (protegido por 'lock')
+    pthread_mutex_t lock;
+    pthread_cond_t loaded;
+    char *directories[INCLUDE_MAX_DIRECTORIES];
+    int directoryCount;
+    BatchReader *reader;             // Leitura dos cabeçalhos (NULL = readSourceFile)
+    atomic_long lexed;               // Cabeçalhos lidos e analisados
+    atomic_long lexNs;               // Tempo gasto analisando cabeçalhos
+} HeaderCache;
+
+// Estrutura de um trecho de tokens da unidade (o token i está em base + tokens[i].offset)
+typedef struct {
+    const Token *tokens;
+    int count;
+    SourceLoc base;
+} TokenSpan;
+
+// Estrutura de um símbolo da unidade (o nome aponta para o código de um arquivo)
+typedef struct {
+    const char *name;
+    int length;
+    int defined;
+} UnitSymbol;
+
+// Estrutura de uma unidade de tradução
+typedef struct {
+    SourceFile *file;                // Arquivo principal (fora do cache)
+    TokenSpan *spans;
+    int spanCount;
+    uint32_t spanCapacity;
+    int tokenCount;
+    UnitSymbol *symbols;             // Tabela de endereçamento aberto (potência de 2)
+    int symbolCount;
+    int symbolCapacity;
+    const SourceFile **onceHeaders;  // Cabeçalhos com '#pragma once' já incluídos
+    int onceCount;
+    uint32_t onceCapacity;
+    int spliced;                     // Inclusões feitas com os tokens do cache
+    int skipped;                     // Inclusões puladas por guard ou '#pragma once'
+    int missing;                     // Inclusões não resolvidas
+    SourceLoc *missingAt;            // Localização de cada uma
+    uint32_t missingCapacity;
+    int tooDeep;                     // Inclusões além de INCLUDE_MAX_DEPTH
+} TranslationUnit;
+
+// Função para calcular o hash FNV-1a de 64 bits
+static uint64_t includeHash(const char *bytes, size_t length) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)bytes[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// ---------------------------------------------------------------------------
+// Arquivos
+// ---------------------------------------------------------------------------
+
+// Função para analisar o código de um arquivo com a lista de tokens da thread (a lista atual é preservada)
+static void sourceFileLex(SourceFile *file) {
+    Token *savedTokens = tokens;
+    int *savedMatch = braceMatch, *savedStack = braceStack;
+    int savedCount = tokenCount, savedCapacity = tokenCapacity;
+
+    tokens = NULL;
+    braceMatch = braceStack = NULL;
+    tokenCount = tokenCapacity = 0;
+    lexTokens(file->code);
+    file->tokens = tokens;
+    file->tokenCount = tokenCount;
+    bigFree(braceMatch);
+    bigFree(braceStack);
+
+    tokens = savedTokens;
+    braceMatch = savedMatch;
+    braceStack = savedStack;
+    tokenCount = savedCount;
+    tokenCapacity = savedCapacity;
+}
+
+// Função para ler o nome do símbolo de '#if !defined X' ou '#if !defined(X)'; devolve o tamanho (0 se não for)
+static int notDefinedSymbol(const char *p, const char *end, const char **name) {
+    if (p >= end || *p++ != '!') {
+        return 0;
+    }
+    skipBlanks(&p, end);
+    if (end - p < 7 || strncmp(p, "defined", 7) != 0) {
+        return 0;
+    }
+    p += 7;
+    skipBlanks(&p, end);
+    int parenthesis = p < end && *p == '(';
+    if (parenthesis) {
+        p++;
+        skipBlanks(&p, end);
+    }
+    int length = symbolLength(p, end);
+    *name = p;
+    p += length;
+    skipBlanks(&p, end);
+    if (parenthesis && (p >= end || *p++ != ')')) {
+        return 0;
+    }
+    skipBlanks(&p, end);
+    return p == end ? length : 0;
+}
+
+// Função para reconhecer o include guard: '#ifndef X' + '#define X' no início e o '#endif' do par no fim
+static void sourceFileDetectGuard(SourceFile *file) {
+    if (file->tokenCount < 3 || file->tokens[0].type != DIRECTIVE || file->tokens[1].type != DIRECTIVE ||
+        file->tokens[file->tokenCount - 1].type != DIRECTIVE) {
+        return;
+    }
+    Directive open, define;
+    parseDirective(file->code + file->tokens[0].offset, &open);
+    parseDirective(file->code + file->tokens[1].offset, &define);
+    const char *name = open.argument;
+    int length = 0;
+    if (directiveIs(&open, "ifndef")) {
+        length = symbolLength(open.argument, open.end);
+    } else if (directiveIs(&open, "if")) {
+        length = notDefinedSymbol(open.argument, open.end, &name);
+    }
+    if (length == 0 || length >= MAX_TOKEN_LENGTH || !directiveIs(&define, "define") ||
+        symbolLength(define.argument, define.end) != length || memcmp(define.argument, name, length) != 0) {
+        return;
+    }
+
+    // O '#if' do guard só pode fechar no último token, sem '#else' ou '#elif' no seu nível
+    int depth = 0;
+    for (int i = 0; i < file->tokenCount; i++) {
+        if (file->tokens[i].type != DIRECTIVE) {
+            continue;
+        }
+        Directive directive;
+        parseDirective(file->code + file->tokens[i].offset, &directive);
+        if (directiveIs(&directive, "if") || directiveIs(&directive, "ifdef") || directiveIs(&directive, "ifndef")) {
+            depth++;
+        } else if (directiveIs(&directive, "endif")) {
+            if (--depth == 0 && i != file->tokenCount - 1) {
+                return;
+            }
+        } else if (depth == 1 && (directiveIs(&directive, "else") || directiveIs(&directive, "elif"))) {
+            return;
+        }
+    }
+    if (depth == 0) {
+        memcpy(file->guard, name, length);
+        file->guard[length] = '\0';
+    }
+}
+
+// Função para registrar as diretivas da unidade e '#pragma once'
+static void sourceFileScan(SourceFile *file) {
+    uint32_t capacity = 0;
+    for (int i = 0; i < file->tokenCount; i++) {
+        if (file->tokens[i].type != DIRECTIVE) {
+            continue;
+        }
+        Directive directive;
+        parseDirective(file->code + file->tokens[i].offset, &directive);
+        DirectiveEventKind kind;
+        if (directiveIs(&directive, "include")) {
+            kind = EVENT_INCLUDE;
+        } else if (directiveIs(&directive, "define")) {
+            kind = EVENT_DEFINE;
+        } else if (directiveIs(&directive, "undef")) {
+            kind = EVENT_UNDEF;
+        } else {
+            if (directiveIs(&directive, "pragma") && directive.end - directive.argument == 4 &&
+                memcmp(directive.argument, "once", 4) == 0) {
+                file->pragmaOnce = 1;
+            }
+            continue;
+        }
+        file->events = vectorGrow(file->events, &capacity, file->eventCount + 1, sizeof(DirectiveEvent));
+        DirectiveEvent *event = &file->events[file->eventCount++];
+        event->token = i;
+        event->kind = kind;
+        atomic_init(&event->target, NULL);
+    }
+    sourceFileDetectGuard(file);
+}
+
+// Função para registrar e analisar um arquivo já lido ('code' passa a ser do arquivo; NULL = ilegível, fica vazio)
+static void sourceFileLoad(SourceFile *file, char *code, long size) {
+    file->code = code;
+    if (!file->code) {
+        file->code = calloc(1, 1);
+        size = 0;
+    }
+    file->base = fileTableAdd(file->path, file->code, (uint32_t)size);
+    if (!file->base) {
+        fprintf(stderr, "Erro: Mais de 4 GB de código carregado.\n");
+        exit(EXIT_FAILURE);
+    }
+    sourceFileLex(file);
+    sourceFileScan(file);
+}
+
+// Função para liberar um arquivo
+static void sourceFileFree(SourceFile *file) {
+    free(file->path);
+    free(file->code);
+    bigFree(file->tokens);
+    free(file->events);
+    free(file);
+}
+
+// ---------------------------------------------------------------------------
+// Cache de cabeçalhos
+// ---------------------------------------------------------------------------
+
+// Função para inicializar o cache
+void headerCacheInit(HeaderCache *cache) {
+    memset(cache, 0, sizeof(*cache));
+    pthread_mutex_init(&cache->lock, NULL);
+    pthread_cond_init(&cache->loaded, NULL);
+}
+
+// Função para acrescentar um diretório de busca (antes dos do sistema)
+void includeDirectory(HeaderCache *cache, const char *directory) {
+    if (cache->directoryCount < INCLUDE_MAX_DIRECTORIES) {
+        cache->directories[cache->directoryCount++] = strdup(directory);
+    }
+}
+
+// Função para procurar um caminho no cache sem trava; sem o arquivo, 'slot' recebe a posição livre
+static SourceFile *headerCacheFind(HeaderCache *cache, const char *path, uint64_t hash, uint32_t *slot) {
+    uint32_t index = (uint32_t)hash & (HEADER_CACHE_SLOTS - 1);
+    for (;;) {
+        SourceFile *file = atomic_load_explicit(&cache->slots[index], memory_order_acquire);
+        if (!file) {
+            *slot = index;
+            return NULL;
+        }
+        if (file->hash == hash && strcmp(file->path, path) == 0) {
+            return file;
+        }
+        index = (index + 1) & (HEADER_CACHE_SLOTS - 1);
+    }
+}
+
+// Função para obter um cabeçalho pelo caminho canônico: analisa na primeira vez e espera se outra thread o analisa
+SourceFile *headerCacheGet(HeaderCache *cache, const char *path) {
+    uint64_t hash = includeHash(path, strlen(path));
+    uint32_t slot;
+    SourceFile *file = headerCacheFind(cache, path, hash, &slot);
+
+    if (!file) {
+        pthread_mutex_lock(&cache->lock);
+        file = headerCacheFind(cache, path, hash, &slot);   // Outra thread pode ter inserido enquanto esperávamos
+        if (!file) {
+            if (cache->count >= HEADER_CACHE_SLOTS / 2) {
+                fprintf(stderr, "Erro: Mais de %d cabeçalhos distintos.\n", HEADER_CACHE_SLOTS / 2);
+                exit(EXIT_FAILURE);
+            }
+            file = calloc(1, sizeof(SourceFile));
+            if (!file || !(file->path = strdup(path))) {
+                fprintf(stderr, "Erro: Falha ao alocar o cache de cabeçalhos.\n");
+                exit(EXIT_FAILURE);
+            }
+            file->hash = hash;
+            atomic_init(&file->ready, 0);
+            cache->count++;
+            atomic_store_explicit(&cache->slots[slot], file, memory_order_release);
+            pthread_mutex_unlock(&cache->lock);
+
+            // Análise fora da trava: as outras threads continuam lendo o cache
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            long size = 0;
+            char *code = cache->reader ? batchReaderRead(cache->reader, file->path, &size)
+                                       : readSourceFile(file->path, &size);
+            sourceFileLoad(file, code, size);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            atomic_fetch_add_explicit(&cache->lexNs,
+                                      (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec),
+                                      memory_order_relaxed);
+            atomic_fetch_add_explicit(&cache->lexed, 1, memory_order_relaxed);
+
+            pthread_mutex_lock(&cache->lock);
+            atomic_store_explicit(&file->ready, 1, memory_order_release);
+            pthread_cond_broadcast(&cache->loaded);
+            pthread_mutex_unlock(&cache->lock);
+            return file;
+        }
+        pthread_mutex_unlock(&cache->lock);
+    }
+
+    if (!atomic_load_explicit(&file->ready, memory_order_acquire)) {
+        pthread_mutex_lock(&cache->lock);
+        while (!atomic_load_explicit(&file->ready, memory_order_acquire)) {
+            pthread_cond_wait(&cache->loaded, &cache->lock);
+        }
+        pthread_mutex_unlock(&cache->lock);
+    }
+    return file;
+}
+
+// Função para liberar o cache e os cabeçalhos
+void headerCacheFree(HeaderCache *cache) {
+    for (int i = 0; i < HEADER_CACHE_SLOTS; i++) {
+        SourceFile *file = atomic_load_explicit(&cache->slots[i], memory_order_relaxed);
+        if (file) {
+            sourceFileFree(file);
+        }
+    }
+    for (int i = 0; i < cache->directoryCount; i++) {
+        free(cache->directories[i]);
+    }
+    pthread_mutex_destroy(&cache->lock);
+    pthread_cond_destroy(&cache->loaded);
+}
+
+// ---------------------------------------------------------------------------
+// Resolução de '#include'
+// ---------------------------------------------------------------------------
+
+// Função para testar um candidato 'directory/name'; devolve 1 e o caminho canônico em 'resolved'
+static int includeCandidate(const char *directory, int directoryLength, const char *name, int nameLength,
+                            char *resolved) {
+    char candidate[PATH_MAX];
+    struct stat info;
+    int written = directoryLength > 0
+                      ? snprintf(candidate, sizeof(candidate), "%.*s/%.*s", directoryLength, directory, nameLength, name)
+                      : snprintf(candidate, sizeof(candidate), "%.*s", nameLength, name);
+    return written < (int)sizeof(candidate) && realpath(candidate, resolved) && stat(resolved, &info) == 0 &&
+           S_ISREG(info.st_mode);
+}
+
+// Função para resolver o '#include' de um token de 'includer'; devolve o cabeçalho ou &missingHeader
+static SourceFile *resolveInclude(HeaderCache *cache, const SourceFile *includer, const Token *token) {
+    Directive directive;
+    parseDirective(includer->code + token->offset, &directive);
+    const char *name = directive.argument + 1;
+    char close = *directive.argument == '"' ? '"' : *directive.argument == '<' ? '>' : '\0';
+    const char *end = close ? memchr(name, close, directive.end - name) : NULL;
+    if (!end || end == name) {
+        return &missingHeader;   // '#include MACRO' ou nome vazio
+    }
+    int length = (int)(end - name);
+    char resolved[PATH_MAX];
+    int found = 0;
+
+    if (*name == '/') {
+        found = includeCandidate(NULL, 0, name, length, resolved);
+    } else {
+        if (close == '"') {
+            const char *slash = strrchr(includer->path, '/');
+            found = includeCandidate(includer->path, slash ? (int)(slash - includer->path) : 0, name, length,
+                                     resolved);
+        }
+        for (int i = 0; !found && i < cache->directoryCount; i++) {
+            found = includeCandidate(cache->directories[i], (int)strlen(cache->directories[i]), name, length,
+                                     resolved);
+        }
+        for (size_t i = 0; !found && i < sizeof(systemIncludeDirectories) / sizeof(systemIncludeDirectories[0]);
+             i++) {
+            found = includeCandidate(systemIncludeDirectories[i], (int)strlen(systemIncludeDirectories[i]), name,
+                                     length, resolved);
+        }
+    }
+    return found ? headerCacheGet(cache, resolved) : &missingHeader;
+}
+
+// ---------------------------------------------------------------------------
+// Unidade de tradução
+// ---------------------------------------------------------------------------
+
+// Função para encontrar a posição de um símbolo na tabela da unidade
+static UnitSymbol *unitSymbolSlot(TranslationUnit *unit, const char *name, int length) {
+    uint32_t mask = (uint32_t)unit->symbolCapacity - 1;
+    uint32_t index = (uint32_t)includeHash(name, length) & mask;
+    while (unit->symbols[index].name &&
+           (unit->symbols[index].length != length || memcmp(unit->symbols[index].name, name, length) != 0)) {
+        index = (index + 1) & mask;
+    }
+    return &unit->symbols[index];
+}
+
+// Função para verificar se um símbolo está definido na unidade
+static int unitDefined(TranslationUnit *unit, const char *name, int length) {
+    return unit->symbolCapacity && unitSymbolSlot(unit, name, length)->defined;
+}
+
+// Função para tratar '#define' e '#undef' na ordem da unidade
+static void unitSetSymbol(TranslationUnit *unit, const SourceFile *file, const Token *token, int defined) {
+    Directive directive;
+    parseDirective(file->code + token->offset, &directive);
+    int length = symbolLength(directive.argument, directive.end);
+    if (length == 0) {
+        return;
+    }
+    if ((unit->symbolCount + 1) * 2 > unit->symbolCapacity) {
+        UnitSymbol *old = unit->symbols;
+        int oldCapacity = unit->symbolCapacity;
+        unit->symbolCapacity = oldCapacity ? oldCapacity * 2 : 64;
+        unit->symbols = calloc(unit->symbolCapacity, sizeof(UnitSymbol));
+        if (!unit->symbols) {
+            fprintf(stderr, "Erro: Falha ao alocar a unidade de tradução.\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < oldCapacity; i++) {
+            if (old[i].name) {
+                *unitSymbolSlot(unit, old[i].name, old[i].length) = old[i];
+            }
+        }
+        free(old);
+    }
+    UnitSymbol *symbol = unitSymbolSlot(unit, directive.argument, length);
+    if (!symbol->name) {
+        symbol->name = directive.argument;
+        symbol->length = length;
+        unit->symbolCount++;
+    }
+    symbol->defined = defined;
+}
+
+// Função para verificar se uma nova inclusão do cabeçalho pode ser pulada
+static int unitGuarded(TranslationUnit *unit, const SourceFile *header) {
+    if (header->guard[0]) {
+        return unitDefined(unit, header->guard, (int)strlen(header->guard));
+    }
+    if (header->pragmaOnce) {
+        for (int i = 0; i < unit->onceCount; i++) {
+            if (unit->onceHeaders[i] == header) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Função para acrescentar um trecho de tokens de um arquivo à unidade
+static void unitAddSpan(TranslationUnit *unit, const SourceFile *file, int start, int count) {
+    if (count <= 0) {
+        return;
+    }
+    unit->spans = vectorGrow(unit->spans, &unit->spanCapacity, unit->spanCount + 1, sizeof(TokenSpan));
+    unit->spans[unit->spanCount++] = (TokenSpan){file->tokens + start, count, file->base};
+    unit->tokenCount += count;
+}
+
+// Função para montar os trechos de 'file', entrando em cada '#include' (o token da diretiva fica antes do cabeçalho)
+static void unitSplice(TranslationUnit *unit, HeaderCache *cache, SourceFile *file, int depth) {
+    int next = 0;   // Primeiro token de 'file' ainda fora dos trechos
+    for (int e = 0; e < file->eventCount; e++) {
+        DirectiveEvent *event = &file->events[e];
+        const Token *token = &file->tokens[event->token];
+        if (event->kind != EVENT_INCLUDE) {
+            unitSetSymbol(unit, file, token, event->kind == EVENT_DEFINE);
+            continue;
+        }
+
+        // A resolução não depende da unidade: a primeira thread grava o destino e as outras só o leem
+        SourceFile *header = atomic_load_explicit(&event->target, memory_order_acquire);
+        if (!header) {
+            header = resolveInclude(cache, file, token);
+            atomic_store_explicit(&event->target, header, memory_order_release);
+        }
+        if (header == &missingHeader) {
+            unit->missingAt = vectorGrow(unit->missingAt, &unit->missingCapacity, unit->missing + 1,
+                                         sizeof(SourceLoc));
+            unit->missingAt[unit->missing++] = file->base + (SourceLoc)token->offset;
+            continue;
+        }
+        if (depth >= INCLUDE_MAX_DEPTH) {
+            unit->tooDeep++;
+            continue;
+        }
+        if (unitGuarded(unit, header)) {
+            unit->skipped++;
+            continue;
+        }
+        if (header->pragmaOnce) {
+            unit->onceHeaders = vectorGrow(unit->onceHeaders, &unit->onceCapacity, unit->onceCount + 1,
+                                           sizeof(SourceFile *));
+            unit->onceHeaders[unit->onceCount++] = header;
+        }
+        unitAddSpan(unit, file, next, event->token + 1 - next);
+        next = event->token + 1;
+        unit->spliced++;
+        unitSplice(unit, cache, header, depth + 1);
+    }
+    unitAddSpan(unit, file, next, file->tokenCount - next);
+}
+
+// Função para analisar e montar a unidade de tradução de 'path', já lido em 'code' (passa a ser da unidade);
+// devolve 0 ou -1 se o arquivo não existe
+int unitLoad(TranslationUnit *unit, HeaderCache *cache, const char *path, char *code, long size) {
+    char resolved[PATH_MAX];
+    memset(unit, 0, sizeof(*unit));
+    if (!realpath(path, resolved)) {
+        fprintf(stderr, "Erro ao abrir o arquivo %s: %s\n", path, strerror(errno));
+        free(code);
+        return -1;
+    }
+    unit->file = calloc(1, sizeof(SourceFile));
+    if (!unit->file || !(unit->file->path = strdup(resolved))) {
+        fprintf(stderr, "Erro: Falha ao alocar a unidade de tradução.\n");
+        exit(EXIT_FAILURE);
+    }
+    sourceFileLoad(unit->file, code, size);
+    atomic_init(&unit->file->ready, 1);
+    unitSplice(unit, cache, unit->file, 0);
+    return 0;
+}
+
+// Função para liberar a unidade (os cabeçalhos ficam no cache)
+void unitFree(TranslationUnit *unit) {
+    if (unit->file) {
+        sourceFileFree(unit->file);
+    }
+    free(unit->spans);
+    free(unit->missingAt);
+    free(unit->symbols);
+    free(unit->onceHeaders);
+    memset(unit, 0, sizeof(*unit));
+}
+
+#endif
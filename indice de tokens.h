@@ -0,0 +1,912 @@
+/*
+ * Índice de busca por tokens
+ *
+ * Indexa um conjunto de arquivos C# para buscar sequências de tokens (ex.:
+ * 'new IDENTIFIER (') sem analisar o código de novo a cada busca. Os
+ * arquivos são lidos em lote (leitura em lote.h) e analisados em paralelo
+ * (cada thread retira o próximo arquivo já lido, na ordem em que as
+ * leituras terminam, e interna os textos dos tokens em uma tabela
+ * própria); a junção ordena os textos, dá a cada um um número e grava um
+ * índice invertido em um único arquivo, que a busca mapeia com mmap e usa
+ * sem copiar nem decodificar nada.
+ *
+ * Formato do arquivo (inteiros na ordem de bytes da máquina, seções
+ * alinhadas em 8 bytes):
+ * - IndexHeader: assinatura, versão, quantidades e a posição de cada seção
+ * - Arquivos: IndexFile (caminho, primeiro token e número de tokens); os
+ *   tokens de todos os arquivos são numerados em sequência (índice global)
+ * - Termos: IndexTerm em ordem de texto (busca binária), cada um com a sua
+ *   lista de ocorrências
+ * - Textos: os textos dos termos e os caminhos, terminados em '\0'
+ * - Tokens: um código de 32 bits por token (termo << 5 | tipo) e o
+ *   deslocamento em bytes de cada token no seu arquivo
+ * - Ocorrências dos termos: índices globais de token, em ordem crescente
+ *   dentro de cada termo
+ * - Trigramas de tipos: para cada sequência de três tipos de token, o
+ *   início das suas ocorrências (INDEX_NGRAM_KEYS + 1 posições) e as
+ *   ocorrências (índice global do primeiro token do trigrama)
+ *
+ * Ao abrir, o índice é conferido antes de qualquer busca: cada seção cabe
+ * no arquivo, os textos dos termos e os caminhos ficam dentro da seção de
+ * textos, as ocorrências de cada termo e os arquivos ficam dentro dos
+ * tokens e cada código aponta para um termo existente.
+ *
+ * Padrões de busca: elementos separados por espaços. Um nome de tipo
+ * (IDENTIFIER, KEYWORD, OPEN_PARENTHESIS, ...) casa com qualquer token
+ * desse tipo, '*' casa com qualquer token e qualquer outro texto casa com o
+ * token de mesmo texto ('texto' entre aspas simples força o texto, para
+ * buscar um identificador que se chama como um tipo). A busca parte do
+ * elemento mais raro: o texto com menos ocorrências ou, sem texto, o
+ * trigrama de tipos com menos ocorrências; só quando o padrão não tem
+ * nenhum dos dois todos os tokens são percorridos. Cada candidato é
+ * conferido nos códigos dos tokens e um padrão nunca atravessa arquivos.
+ *
+ * Limitações:
+ * - Até 2^32 - 1 tokens e 2^27 textos distintos por índice
+ * - O texto de um token é o mesmo guardado pelo analisador léxico
+ *   (truncado em MAX_TOKEN_LENGTH - 1 bytes)
+ * - O índice não acompanha mudanças nos arquivos: deve ser refeito
+ */
+
+#ifndef INDICE_DE_TOKENS_H
+#define INDICE_DE_TOKENS_H
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "arena.h"
+#include "leitura em lote.h"
+#include "vetor dinamico.h"
+
+#define INDEX_MAGIC "CSTOKIDX"
+#define INDEX_VERSION 1
+#define INDEX_TYPE_BITS 5
+#define INDEX_TYPE_MASK ((1u << INDEX_TYPE_BITS) - 1)
+#define INDEX_MAX_TERMS (1u << (32 - INDEX_TYPE_BITS))
+#define INDEX_NGRAM_KEYS (1u << (3 * INDEX_TYPE_BITS))
+#define INDEX_MAX_THREADS 64
+#define INDEX_MAX_PATTERN 64
+
+// Macros para montar e desmontar o código de um token
+#define INDEX_CODE(term, type) ((uint32_t)(term) << INDEX_TYPE_BITS | (uint32_t)(type))
+#define INDEX_TERM(code) ((code) >> INDEX_TYPE_BITS)
+#define INDEX_TYPE(code) ((code) & INDEX_TYPE_MASK)
+#define INDEX_NGRAM(a, b, c) (((uint32_t)(a) << (2 * INDEX_TYPE_BITS)) | ((uint32_t)(b) << INDEX_TYPE_BITS) | (uint32_t)(c))
+
+// Estrutura do cabeçalho do arquivo de índice
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t fileCount;
+    uint32_t termCount;
+    uint32_t tokenCount;
+    uint64_t files;            // Posição de cada seção no arquivo
+    uint64_t terms;
+    uint64_t strings;
+    uint64_t codes;
+    uint64_t offsets;
+    uint64_t postings;
+    uint64_t ngramStarts;
+    uint64_t ngramPostings;
+    uint64_t size;             // Tamanho total (confere se o arquivo está inteiro)
+} IndexHeader;
+
+// Estrutura de um arquivo indexado
+typedef struct {
+    uint32_t path;             // Posição do caminho nos textos
+    uint32_t first;            // Índice global do primeiro token
+    uint32_t count;
+} IndexFile;
+
+// Estrutura de um termo (texto de token)
+typedef struct {
+    uint32_t string;           // Posição do texto nos textos
+    uint32_t postings;         // Primeira ocorrência na seção de ocorrências
+    uint32_t count;
+} IndexTerm;
+
+// Estrutura da tabela de textos de uma thread (textos na arena: hash de 32 bits seguido do texto)
+typedef struct {
+    Arena strings;
+    uint32_t *slots;           // Identificador local + 1 (0 = vazio)
+    uint32_t slotCount;
+    uint32_t *refs;            // Identificador local -> posição do texto na arena
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t *remap;           // Identificador local -> termo (preenchido na junção)
+} IndexInterner;
+
+// Estrutura do resultado da análise de um arquivo
+typedef struct {
+    char *path;
+    uint32_t *codes;           // Identificador local << 5 | tipo (termo depois da junção)
+    uint32_t *offsets;
+    uint32_t count;
+    int worker;                // Tabela de textos usada (-1 se o arquivo não pôde ser lido)
+} IndexedFile;
+
+// Estrutura do trabalho compartilhado pelas threads da indexação
+typedef struct {
+    IndexedFile *files;
+    uint32_t fileCount;
+    IndexInterner *interners;
+    BatchReader reader;
+} IndexJob;
+
+// Estrutura de uma thread da indexação
+typedef struct {
+    IndexJob *job;
+    int id;
+    pthread_t thread;
+} IndexWorker;
+
+// Estrutura das estatísticas da indexação
+typedef struct {
+    uint32_t files;
+    uint32_t unreadable;
+    uint32_t terms;
+    uint64_t tokens;
+    uint64_t bytes;            // Tamanho do índice
+    const char *readMode;      // "io_uring" ou "pread"
+    uint64_t enters;           // Chamadas a io_uring_enter
+    double lexMs;
+    double buildMs;
+} IndexStats;
+
+// Estrutura de um índice aberto (ponteiros para dentro do mapeamento)
+typedef struct {
+    void *map;
+    size_t size;
+    const IndexHeader *header;
+    const IndexFile *files;
+    const IndexTerm *terms;
+    const char *strings;
+    const uint32_t *codes;
+    const uint32_t *offsets;
+    const uint32_t *postings;
+    const uint32_t *ngramStarts;
+    const uint32_t *ngramPostings;
+} TokenIndex;
+
+// Tipos de elemento de um padrão
+typedef enum {
+    PATTERN_ANY,
+    PATTERN_TYPE,
+    PATTERN_TERM
+} PatternKind;
+
+// Estrutura de um elemento de padrão
+typedef struct {
+    PatternKind kind;
+    uint32_t value;            // Tipo ou termo
+} PatternElement;
+
+// Estrutura de um padrão de busca
+typedef struct {
+    PatternElement elements[INDEX_MAX_PATTERN];
+    int count;
+    int missing;               // Algum texto não existe no índice: nenhuma ocorrência possível
+} TokenPattern;
+
+// Função para calcular o hash de um texto (FNV-1a)
+static uint32_t indexHash(const char *text) {
+    uint32_t hash = 2166136261u;
+    for (; *text; text++) {
+        hash = (hash ^ (unsigned char)*text) * 16777619u;
+    }
+    return hash;
+}
+
+// Função para obter o texto do identificador local 'id' de uma tabela
+static const char *internerText(const IndexInterner *interner, uint32_t id) {
+    return interner->strings.base + interner->refs[id] + sizeof(uint32_t);
+}
+
+// Função para dobrar a tabela de espalhamento de uma tabela de textos
+static void internerRehash(IndexInterner *interner) {
+    uint32_t slotCount = interner->slotCount ? interner->slotCount * 2 : 4096;
+    uint32_t *slots = calloc(slotCount, sizeof(uint32_t));
+    if (!slots) {
+        fprintf(stderr, "Erro: Falha ao alocar a tabela de textos.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t id = 0; id < interner->count; id++) {
+        uint32_t hash = *ARENA_AT(&interner->strings, uint32_t, interner->refs[id]);
+        uint32_t slot = hash & (slotCount - 1);
+        while (slots[slot]) slot = (slot + 1) & (slotCount - 1);
+        slots[slot] = id + 1;
+    }
+    free(interner->slots);
+    interner->slots = slots;
+    interner->slotCount = slotCount;
+}
+
+// Função para internar um texto; devolve o seu identificador local
+static uint32_t internerAdd(IndexInterner *interner, const char *text) {
+    if ((uint64_t)(interner->count + 1) * 2 > interner->slotCount) {
+        internerRehash(interner);
+    }
+    uint32_t hash = indexHash(text);
+    uint32_t slot = hash & (interner->slotCount - 1);
+    while (interner->slots[slot]) {
+        uint32_t id = interner->slots[slot] - 1;
+        if (*ARENA_AT(&interner->strings, uint32_t, interner->refs[id]) == hash &&
+            strcmp(internerText(interner, id), text) == 0) {
+            return id;
+        }
+        slot = (slot + 1) & (interner->slotCount - 1);
+    }
+    size_t length = strlen(text);
+    uint32_t ref = arenaAlloc(&interner->strings, (uint32_t)(sizeof(uint32_t) + length + 1));
+    *ARENA_AT(&interner->strings, uint32_t, ref) = hash;
+    memcpy(interner->strings.base + ref + sizeof(uint32_t), text, length + 1);
+    interner->refs = vectorGrow(interner->refs, &interner->capacity, interner->count + 1, sizeof(uint32_t));
+    interner->refs[interner->count] = ref;
+    interner->slots[slot] = interner->count + 1;
+    return interner->count++;
+}
+
+// Função para liberar uma tabela de textos
+static void internerFree(IndexInterner *interner) {
+    if (interner->strings.base) {
+        arenaFree(&interner->strings);
+    }
+    free(interner->slots);
+    free(interner->refs);
+    free(interner->remap);
+    memset(interner, 0, sizeof(*interner));
+}
+
+// Função para analisar um arquivo já lido e guardar os seus tokens como identificadores locais (libera 'code')
+static void indexLexFile(IndexedFile *file, char *code, IndexInterner *interner, int worker) {
+    if (!code) {
+        file->worker = -1;
+        return;
+    }
+    tokenCount = 0;
+    lexTokens(code);
+    file->count = (uint32_t)tokenCount;
+    file->codes = malloc((tokenCount + 1) * sizeof(uint32_t));
+    file->offsets = malloc((tokenCount + 1) * sizeof(uint32_t));
+    if (!file->codes || !file->offsets) {
+        fprintf(stderr, "Erro: Falha ao alocar os tokens de '%s'.\n", file->path);
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < tokenCount; i++) {
+        file->codes[i] = INDEX_CODE(internerAdd(interner, tokens[i].value), tokens[i].type);
+        file->offsets[i] = (uint32_t)tokens[i].offset;
+    }
+    file->worker = worker;
+    free(code);
+}
+
+// Função executada por cada thread da indexação: analisa os arquivos, um de cada vez
+static void *indexWorkerRun(void *context) {
+    IndexWorker *worker = context;
+    IndexJob *job = worker->job;
+    IndexInterner *interner = &job->interners[worker->id];
+    arenaInit(&interner->strings, 1 << 16);
+    uint32_t index;
+    while ((index = batchReaderNext(&job->reader)) != UINT32_MAX) {
+        indexLexFile(&job->files[index], job->reader.files[index].code, interner, worker->id);
+    }
+    freeTokens();
+    return NULL;
+}
+
+// Função para comparar dois caminhos (ordenação de qsort)
+static int indexComparePaths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+// Função para acrescentar um arquivo ou, se for um diretório, os seus arquivos .cs (recursivamente)
+void indexCollect(const char *path, char ***paths, uint32_t *count, uint32_t *capacity) {
+    struct stat info;
+    if (stat(path, &info) != 0) {
+        fprintf(stderr, "Erro: '%s' não encontrado.\n", path);
+        return;
+    }
+    if (!S_ISDIR(info.st_mode)) {
+        char *resolved = realpath(path, NULL);
+        if (!resolved) {
+            return;
+        }
+        *paths = vectorGrow(*paths, capacity, *count + 1, sizeof(char *));
+        (*paths)[(*count)++] = resolved;
+        return;
+    }
+    DIR *dir = opendir(path);
+    if (!dir) {
+        fprintf(stderr, "Erro: Não foi possível abrir o diretório '%s'.\n", path);
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;   // '.', '..' e ocultos
+        }
+        size_t length = strlen(entry->d_name);
+        char child[PATH_MAX];
+        if (snprintf(child, sizeof(child), "%s/%s", path, entry->d_name) >= (int)sizeof(child)) {
+            continue;
+        }
+        int isDir = entry->d_type == DT_DIR || (entry->d_type == DT_UNKNOWN && stat(child, &info) == 0 &&
+                                                 S_ISDIR(info.st_mode));
+        if (isDir || (length > 3 && strcmp(entry->d_name + length - 3, ".cs") == 0)) {
+            indexCollect(child, paths, count, capacity);
+        }
+    }
+    closedir(dir);
+}
+
+// Estrutura de um texto da junção (texto e posição provisória)
+typedef struct {
+    const char *text;
+    uint32_t index;
+} IndexMergeEntry;
+
+// Função para comparar dois textos da junção (ordenação de qsort)
+static int indexCompareEntries(const void *a, const void *b) {
+    return strcmp(((const IndexMergeEntry *)a)->text, ((const IndexMergeEntry *)b)->text);
+}
+
+// Função para juntar as tabelas das threads em termos ordenados por texto; devolve os termos (textos) e a quantidade
+static IndexMergeEntry *indexMergeTerms(IndexInterner *interners, int workers, uint32_t *termCount) {
+    uint64_t total = 0;
+    for (int w = 0; w < workers; w++) {
+        total += interners[w].count;
+    }
+    uint32_t slotCount = 4096;
+    while (slotCount < total * 2) slotCount *= 2;
+    uint32_t *slots = calloc(slotCount, sizeof(uint32_t));
+    IndexMergeEntry *entries = malloc((total + 1) * sizeof(IndexMergeEntry));
+    if (!slots || !entries) {
+        fprintf(stderr, "Erro: Falha ao alocar a junção dos termos.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Textos distintos de todas as threads (a tabela da thread já guarda o hash de cada texto)
+    uint32_t count = 0;
+    for (int w = 0; w < workers; w++) {
+        IndexInterner *interner = &interners[w];
+        interner->remap = malloc((interner->count + 1) * sizeof(uint32_t));
+        if (!interner->remap) {
+            fprintf(stderr, "Erro: Falha ao alocar a junção dos termos.\n");
+            exit(EXIT_FAILURE);
+        }
+        for (uint32_t id = 0; id < interner->count; id++) {
+            uint32_t hash = *ARENA_AT(&interner->strings, uint32_t, interner->refs[id]);
+            const char *text = internerText(interner, id);
+            uint32_t slot = hash & (slotCount - 1);
+            while (slots[slot] && strcmp(entries[slots[slot] - 1].text, text) != 0) {
+                slot = (slot + 1) & (slotCount - 1);
+            }
+            if (!slots[slot]) {
+                entries[count] = (IndexMergeEntry){text, count};
+                slots[slot] = ++count;
+            }
+            interner->remap[id] = slots[slot] - 1;
+        }
+    }
+    free(slots);
+    if (count >= INDEX_MAX_TERMS) {
+        fprintf(stderr, "Erro: Mais de %u textos distintos.\n", INDEX_MAX_TERMS);
+        exit(EXIT_FAILURE);
+    }
+
+    // Número final = posição na ordem de texto (o índice não depende do número de threads)
+    qsort(entries, count, sizeof(IndexMergeEntry), indexCompareEntries);
+    uint32_t *rank = malloc((count + 1) * sizeof(uint32_t));
+    if (!rank) {
+        fprintf(stderr, "Erro: Falha ao alocar a junção dos termos.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        rank[entries[i].index] = i;
+    }
+    for (int w = 0; w < workers; w++) {
+        for (uint32_t id = 0; id < interners[w].count; id++) {
+            interners[w].remap[id] = rank[interners[w].remap[id]];
+        }
+    }
+    free(rank);
+    *termCount = count;
+    return entries;
+}
+
+// Função para gravar uma seção alinhada em 8 bytes; devolve a sua posição no arquivo
+static uint64_t indexWriteSection(FILE *out, const void *data, uint64_t size, int *failed) {
+    static const char zeros[8] = {0};
+    long position = ftell(out);
+    if (position < 0) {
+        *failed = 1;
+        return 0;
+    }
+    uint64_t padding = (8 - (uint64_t)position % 8) % 8;
+    if (padding && fwrite(zeros, 1, padding, out) != padding) {
+        *failed = 1;
+    }
+    if (size && fwrite(data, 1, size, out) != size) {
+        *failed = 1;
+    }
+    return (uint64_t)position + padding;
+}
+
+// Função para indexar os arquivos e gravar o índice em 'output'; devolve 0 ou -1
+int indexBuild(char **paths, uint32_t fileCount, int threads, BatchReadMode readMode, const char *output,
+               IndexStats *stats) {
+    struct timespec start, lexed, end;
+    memset(stats, 0, sizeof(*stats));
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    threads = threads > INDEX_MAX_THREADS ? INDEX_MAX_THREADS : threads;
+    threads = (uint32_t)threads > fileCount ? (int)(fileCount ? fileCount : 1) : threads;
+
+    // Análise em paralelo (a thread principal é a thread 0)
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    IndexJob job = {.files = calloc(fileCount + 1, sizeof(IndexedFile)), .fileCount = fileCount,
+                    .interners = calloc(threads, sizeof(IndexInterner))};
+    IndexWorker workers[INDEX_MAX_THREADS];
+    if (!job.files || !job.interners) {
+        fprintf(stderr, "Erro: Falha ao alocar a indexação.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < fileCount; i++) {
+        job.files[i].path = paths[i];
+    }
+    if (batchReaderStart(&job.reader, paths, fileCount, readMode) != 0) {
+        exit(EXIT_FAILURE);
+    }
+    int started = 1;
+    for (int t = 0; t < threads; t++) {
+        workers[t] = (IndexWorker){.job = &job, .id = t};
+    }
+    while (started < threads && pthread_create(&workers[started].thread, NULL, indexWorkerRun, &workers[started]) == 0) {
+        started++;
+    }
+    indexWorkerRun(&workers[0]);
+    for (int t = 1; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    stats->readMode = job.reader.useRing ? "io_uring" : "pread";
+    stats->enters = job.reader.enters;
+    batchReaderFinish(&job.reader);
+    clock_gettime(CLOCK_MONOTONIC, &lexed);
+
+    // Termos e numeração global dos tokens
+    IndexMergeEntry *entries = indexMergeTerms(job.interners, started, &stats->terms);
+    uint64_t tokenTotal = 0;
+    uint64_t stringsSize = 0;
+    for (uint32_t t = 0; t < stats->terms; t++) {
+        stringsSize += strlen(entries[t].text) + 1;
+    }
+    for (uint32_t i = 0; i < fileCount; i++) {
+        tokenTotal += job.files[i].count;
+        stringsSize += strlen(paths[i]) + 1;
+        stats->unreadable += job.files[i].worker < 0;
+    }
+    if (tokenTotal >= UINT32_MAX || stringsSize >= UINT32_MAX) {
+        fprintf(stderr, "Erro: O corpus excede os limites do índice.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    IndexFile *files = calloc(fileCount + 1, sizeof(IndexFile));
+    IndexTerm *terms = calloc(stats->terms + 1, sizeof(IndexTerm));
+    char *strings = malloc(stringsSize + 1);
+    uint32_t *codes = malloc((tokenTotal + 1) * sizeof(uint32_t));
+    uint32_t *offsets = malloc((tokenTotal + 1) * sizeof(uint32_t));
+    uint32_t *postings = malloc((tokenTotal + 1) * sizeof(uint32_t));
+    uint32_t *ngramStarts = calloc(INDEX_NGRAM_KEYS + 1, sizeof(uint32_t));
+    uint32_t *ngramPostings = malloc((tokenTotal + 1) * sizeof(uint32_t));
+    if (!files || !terms || !strings || !codes || !offsets || !postings || !ngramStarts || !ngramPostings) {
+        fprintf(stderr, "Erro: Falha ao alocar o índice.\n");
+        exit(EXIT_FAILURE);
+    }
+    uint32_t stringUsed = 0;
+    for (uint32_t t = 0; t < stats->terms; t++) {
+        size_t length = strlen(entries[t].text) + 1;
+        terms[t].string = stringUsed;
+        memcpy(strings + stringUsed, entries[t].text, length);
+        stringUsed += (uint32_t)length;
+    }
+    uint32_t next = 0, ngramCount = 0;
+    for (uint32_t i = 0; i < fileCount; i++) {
+        IndexedFile *file = &job.files[i];
+        size_t length = strlen(file->path) + 1;
+        files[i] = (IndexFile){stringUsed, next, file->count};
+        memcpy(strings + stringUsed, file->path, length);
+        stringUsed += (uint32_t)length;
+        for (uint32_t k = 0; k < file->count; k++) {
+            uint32_t code = file->codes[k];
+            codes[next + k] = INDEX_CODE(job.interners[file->worker].remap[INDEX_TERM(code)], INDEX_TYPE(code));
+            offsets[next + k] = file->offsets[k];
+            terms[INDEX_TERM(codes[next + k])].count++;
+            if (k >= 2) {
+                ngramStarts[INDEX_NGRAM(INDEX_TYPE(codes[next + k - 2]), INDEX_TYPE(codes[next + k - 1]),
+                                        INDEX_TYPE(codes[next + k]))]++;
+                ngramCount++;
+            }
+        }
+        next += file->count;
+        free(file->codes);
+        free(file->offsets);
+    }
+
+    // Listas de ocorrências por contagem: percorrer os tokens em ordem deixa cada lista já ordenada
+    uint32_t position = 0;
+    for (uint32_t t = 0; t < stats->terms; t++) {
+        terms[t].postings = position;
+        position += terms[t].count;
+        terms[t].count = 0;
+    }
+    position = 0;
+    for (uint32_t k = 0; k <= INDEX_NGRAM_KEYS; k++) {
+        uint32_t count = k < INDEX_NGRAM_KEYS ? ngramStarts[k] : 0;
+        ngramStarts[k] = position;
+        position += count;
+    }
+    uint32_t *ngramFill = malloc(INDEX_NGRAM_KEYS * sizeof(uint32_t));
+    if (!ngramFill) {
+        fprintf(stderr, "Erro: Falha ao alocar o índice.\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(ngramFill, ngramStarts, INDEX_NGRAM_KEYS * sizeof(uint32_t));
+    for (uint32_t i = 0; i < fileCount; i++) {
+        for (uint32_t g = files[i].first; g < files[i].first + files[i].count; g++) {
+            IndexTerm *term = &terms[INDEX_TERM(codes[g])];
+            postings[term->postings + term->count++] = g;
+            if (g >= files[i].first + 2) {
+                uint32_t key = INDEX_NGRAM(INDEX_TYPE(codes[g - 2]), INDEX_TYPE(codes[g - 1]), INDEX_TYPE(codes[g]));
+                ngramPostings[ngramFill[key]++] = g - 2;
+            }
+        }
+    }
+    free(ngramFill);
+
+    // Gravação: o cabeçalho é regravado no fim, com as posições das seções
+    int failed = 0;
+    FILE *out = fopen(output, "wb");
+    IndexHeader header = {.magic = INDEX_MAGIC, .version = INDEX_VERSION, .fileCount = fileCount,
+                          .termCount = stats->terms, .tokenCount = (uint32_t)tokenTotal};
+    if (!out) {
+        perror("Erro ao criar o índice");
+        failed = 1;
+    } else {
+        indexWriteSection(out, &header, sizeof(header), &failed);
+        header.files = indexWriteSection(out, files, (uint64_t)fileCount * sizeof(IndexFile), &failed);
+        header.terms = indexWriteSection(out, terms, (uint64_t)stats->terms * sizeof(IndexTerm), &failed);
+        header.strings = indexWriteSection(out, strings, stringUsed, &failed);
+        header.codes = indexWriteSection(out, codes, tokenTotal * sizeof(uint32_t), &failed);
+        header.offsets = indexWriteSection(out, offsets, tokenTotal * sizeof(uint32_t), &failed);
+        header.postings = indexWriteSection(out, postings, tokenTotal * sizeof(uint32_t), &failed);
+        header.ngramStarts = indexWriteSection(out, ngramStarts, (INDEX_NGRAM_KEYS + 1) * sizeof(uint32_t), &failed);
+        header.ngramPostings = indexWriteSection(out, ngramPostings, (uint64_t)ngramCount * sizeof(uint32_t), &failed);
+        header.size = (uint64_t)ftell(out);
+        if (fseek(out, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, out) != 1) {
+            failed = 1;
+        }
+        if (fclose(out) != 0) {
+            failed = 1;
+        }
+        if (failed) {
+            fprintf(stderr, "Erro: Falha ao gravar o índice '%s'.\n", output);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    stats->files = fileCount;
+    stats->tokens = tokenTotal;
+    stats->bytes = header.size;
+    stats->lexMs = (lexed.tv_sec - start.tv_sec) * 1e3 + (lexed.tv_nsec - start.tv_nsec) / 1e6;
+    stats->buildMs = (end.tv_sec - lexed.tv_sec) * 1e3 + (end.tv_nsec - lexed.tv_nsec) / 1e6;
+
+    for (int w = 0; w < threads; w++) {
+        internerFree(&job.interners[w]);
+    }
+    free(entries);
+    free(job.interners);
+    free(job.files);
+    free(files);
+    free(terms);
+    free(strings);
+    free(codes);
+    free(offsets);
+    free(postings);
+    free(ngramStarts);
+    free(ngramPostings);
+    return failed ? -1 : 0;
+}
+
+// Função para conferir que 'count' registros de 'size' bytes a partir de 'offset' (alinhado em 8) cabem no índice
+static int indexSectionFits(const TokenIndex *index, uint64_t offset, uint64_t count, size_t size) {
+    return offset % 8 == 0 && offset >= sizeof(IndexHeader) && offset <= index->size &&
+           count <= (index->size - offset) / size;
+}
+
+// Função para conferir as seções de um índice mapeado ('map', 'size' e 'header' já preenchidos) e apontar para
+// elas; um arquivo corrompido ou de outra origem não pode levar a busca para fora do mapeamento. Devolve 1 se
+// o índice for válido
+static int indexMapSections(TokenIndex *index) {
+    const IndexHeader *header = index->header;
+    const char *base = index->map;
+    if (!indexSectionFits(index, header->files, header->fileCount, sizeof(IndexFile)) ||
+        !indexSectionFits(index, header->terms, header->termCount, sizeof(IndexTerm)) ||
+        header->termCount > INDEX_MAX_TERMS || header->strings < sizeof(IndexHeader) ||
+        header->strings > header->codes ||
+        !indexSectionFits(index, header->codes, header->tokenCount, sizeof(uint32_t)) ||
+        !indexSectionFits(index, header->offsets, header->tokenCount, sizeof(uint32_t)) ||
+        !indexSectionFits(index, header->postings, header->tokenCount, sizeof(uint32_t)) ||
+        !indexSectionFits(index, header->ngramStarts, INDEX_NGRAM_KEYS + 1, sizeof(uint32_t))) {
+        return 0;
+    }
+    index->ngramStarts = (const uint32_t *)(base + header->ngramStarts);
+    if (!indexSectionFits(index, header->ngramPostings, index->ngramStarts[INDEX_NGRAM_KEYS], sizeof(uint32_t))) {
+        return 0;
+    }
+    index->files = (const IndexFile *)(base + header->files);
+    index->terms = (const IndexTerm *)(base + header->terms);
+    index->strings = base + header->strings;
+    index->codes = (const uint32_t *)(base + header->codes);
+    index->offsets = (const uint32_t *)(base + header->offsets);
+    index->postings = (const uint32_t *)(base + header->postings);
+    index->ngramPostings = (const uint32_t *)(base + header->ngramPostings);
+
+    // Textos terminados em '\0' dentro da seção: basta o último byte ser '\0'
+    uint64_t stringsSize = header->codes - header->strings;
+    if (stringsSize && index->strings[stringsSize - 1] != '\0') {
+        return 0;
+    }
+    for (uint32_t t = 0; t < header->termCount; t++) {
+        const IndexTerm *term = &index->terms[t];
+        if (term->string >= stringsSize || (uint64_t)term->postings + term->count > header->tokenCount) {
+            return 0;
+        }
+    }
+
+    // Arquivos em sequência, cobrindo todos os tokens (indexFileOf e indexSearch dependem disso)
+    uint64_t next = 0;
+    for (uint32_t f = 0; f < header->fileCount; f++) {
+        if (index->files[f].path >= stringsSize || index->files[f].first != next) {
+            return 0;
+        }
+        next += index->files[f].count;
+    }
+    if (next != header->tokenCount) {
+        return 0;
+    }
+    for (uint32_t k = 0; k < INDEX_NGRAM_KEYS; k++) {
+        if (index->ngramStarts[k] > index->ngramStarts[k + 1]) {
+            return 0;
+        }
+    }
+    for (uint32_t g = 0; g < header->tokenCount; g++) {
+        if (INDEX_TERM(index->codes[g]) >= header->termCount) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Função para abrir um índice com mmap; devolve 0 ou -1
+int indexOpen(TokenIndex *index, const char *path) {
+    memset(index, 0, sizeof(*index));
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(IndexHeader)) {
+        fprintf(stderr, "Erro: Não foi possível abrir o índice '%s'.\n", path);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("Erro ao mapear o índice");
+        return -1;
+    }
+    const IndexHeader *header = map;
+    if (memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0 || header->version != INDEX_VERSION ||
+        header->size != (uint64_t)info.st_size) {
+        fprintf(stderr, "Erro: '%s' não é um índice válido (ou está incompleto).\n", path);
+        munmap(map, (size_t)info.st_size);
+        return -1;
+    }
+    index->map = map;
+    index->size = (size_t)info.st_size;
+    index->header = header;
+    if (!indexMapSections(index)) {
+        fprintf(stderr, "Erro: '%s' não é um índice válido (ou está incompleto).\n", path);
+        munmap(map, (size_t)info.st_size);
+        memset(index, 0, sizeof(*index));
+        return -1;
+    }
+    return 0;
+}
+
+// Função para fechar um índice
+void indexClose(TokenIndex *index) {
+    if (index->map) {
+        munmap(index->map, index->size);
+    }
+    memset(index, 0, sizeof(*index));
+}
+
+// Função para obter o texto de um termo
+const char *indexTermText(const TokenIndex *index, uint32_t term) {
+    return index->strings + index->terms[term].string;
+}
+
+// Função para encontrar o termo de um texto (busca binária); devolve o termo ou -1
+int64_t indexFindTerm(const TokenIndex *index, const char *text) {
+    uint32_t low = 0, high = index->header->termCount;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        int order = strcmp(indexTermText(index, mid), text);
+        if (order == 0) {
+            return mid;
+        }
+        if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return -1;
+}
+
+// Função para encontrar o arquivo de um índice global de token (busca binária)
+uint32_t indexFileOf(const TokenIndex *index, uint32_t token) {
+    uint32_t low = 0, high = index->header->fileCount;
+    while (low + 1 < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (index->files[mid].first <= token) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    // Arquivos sem tokens têm o mesmo 'first' do seguinte: avançar até o que contém o token
+    while (low + 1 < index->header->fileCount && index->files[low].first + index->files[low].count <= token) {
+        low++;
+    }
+    return low;
+}
+
+// Função para converter o texto de um padrão em elementos; devolve 0 ou -1 (padrão vazio ou longo demais)
+int patternParse(const TokenIndex *index, const char *text, TokenPattern *pattern) {
+    pattern->count = 0;
+    pattern->missing = 0;
+    const char *p = text;
+    while (*p) {
+        while (CHAR_IS(*p, CHAR_SPACE)) p++;
+        if (!*p) {
+            break;
+        }
+        const char *start = p;
+        while (*p && !CHAR_IS(*p, CHAR_SPACE)) p++;
+        int length = (int)(p - start);
+        if (pattern->count >= INDEX_MAX_PATTERN || length >= MAX_TOKEN_LENGTH + 2) {
+            return -1;
+        }
+        PatternElement *element = &pattern->elements[pattern->count++];
+        char word[MAX_TOKEN_LENGTH + 2];
+        memcpy(word, start, length);
+        word[length] = '\0';
+        if (strcmp(word, "*") == 0) {
+            *element = (PatternElement){PATTERN_ANY, 0};
+            continue;
+        }
+        int quoted = length >= 2 && word[0] == '\'' && word[length - 1] == '\'';
+        if (!quoted) {
+            int type;
+            for (type = 0; type <= UNKNOWN; type++) {
+                if (strcmp(word, tokenTypeToString((TokenType)type)) == 0) {
+                    break;
+                }
+            }
+            if (type <= UNKNOWN) {
+                *element = (PatternElement){PATTERN_TYPE, (uint32_t)type};
+                continue;
+            }
+        } else {
+            memmove(word, word + 1, length - 2);
+            word[length - 2] = '\0';
+        }
+        int64_t term = indexFindTerm(index, word);
+        pattern->missing |= term < 0;
+        *element = (PatternElement){PATTERN_TERM, term < 0 ? 0 : (uint32_t)term};
+    }
+    return pattern->count ? 0 : -1;
+}
+
+// Função para conferir o padrão a partir do índice global 'start' (dentro de um arquivo)
+static int patternMatchesAt(const TokenIndex *index, const TokenPattern *pattern, uint32_t start) {
+    for (int i = 0; i < pattern->count; i++) {
+        uint32_t code = index->codes[start + i];
+        const PatternElement *element = &pattern->elements[i];
+        if ((element->kind == PATTERN_TYPE && INDEX_TYPE(code) != element->value) ||
+            (element->kind == PATTERN_TERM && INDEX_TERM(code) != element->value)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Função para buscar um padrão; chama 'found' com o índice global do primeiro token de cada ocorrência, em ordem.
+// 'found' devolve 0 para parar. Devolve o número de ocorrências visitadas
+uint64_t indexSearch(const TokenIndex *index, const TokenPattern *pattern,
+                     int (*found)(const TokenIndex *index, uint32_t token, void *context), void *context) {
+    if (pattern->missing || pattern->count == 0) {
+        return 0;
+    }
+
+    // Elemento de partida: o de menos ocorrências (texto ou trigrama de tipos)
+    const uint32_t *candidates = NULL;
+    uint64_t candidateCount = UINT64_MAX;
+    int anchor = 0;
+    for (int i = 0; i < pattern->count; i++) {
+        const PatternElement *element = &pattern->elements[i];
+        if (element->kind == PATTERN_TERM && index->terms[element->value].count < candidateCount) {
+            candidates = index->postings + index->terms[element->value].postings;
+            candidateCount = index->terms[element->value].count;
+            anchor = i;
+        } else if (i + 2 < pattern->count && element->kind == PATTERN_TYPE &&
+                   pattern->elements[i + 1].kind == PATTERN_TYPE && pattern->elements[i + 2].kind == PATTERN_TYPE) {
+            uint32_t key = INDEX_NGRAM(element->value, pattern->elements[i + 1].value, pattern->elements[i + 2].value);
+            uint32_t count = index->ngramStarts[key + 1] - index->ngramStarts[key];
+            if (count < candidateCount) {
+                candidates = index->ngramPostings + index->ngramStarts[key];
+                candidateCount = count;
+                anchor = i;
+            }
+        }
+    }
+
+    uint64_t matches = 0;
+    uint32_t length = (uint32_t)pattern->count;
+    if (!candidates) {
+        // Só '*' e tipos soltos: percorrer todos os tokens
+        for (uint32_t f = 0; f < index->header->fileCount; f++) {
+            const IndexFile *file = &index->files[f];
+            for (uint32_t s = file->first; file->count >= length && s <= file->first + file->count - length; s++) {
+                if (patternMatchesAt(index, pattern, s)) {
+                    matches++;
+                    if (!found(index, s, context)) {
+                        return matches;
+                    }
+                }
+            }
+        }
+        return matches;
+    }
+    uint32_t file = 0;
+    for (uint64_t c = 0; c < candidateCount; c++) {
+        if (candidates[c] < (uint32_t)anchor) {
+            continue;
+        }
+        uint32_t start = candidates[c] - (uint32_t)anchor;
+        // Os candidatos crescem: o arquivo só avança
+        while (file + 1 < index->header->fileCount && index->files[file].first + index->files[file].count <= start) {
+            file++;
+        }
+        const IndexFile *entry = &index->files[file];
+        if (start < entry->first || (uint64_t)start + length > (uint64_t)entry->first + entry->count) {
+            continue;
+        }
+        if (patternMatchesAt(index, pattern, start)) {
+            matches++;
+            if (!found(index, start, context)) {
+                break;
+            }
+        }
+    }
+    return matches;
+}
+
+#endif
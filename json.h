@@ -0,0 +1,397 @@
+/*
+ * Leitura e escrita de JSON
+ *
+ * O suficiente para as mensagens do protocolo do servidor de linguagem:
+ * o texto é lido de uma vez para uma árvore de valores guardada em uma
+ * arena (arena.h), descartada inteira depois de cada mensagem, e as
+ * respostas são montadas em um buffer que cresce sob demanda.
+ *
+ * Estruturas principais:
+ * - JsonValue: Um valor. Filhos de arrays e objetos formam uma lista
+ *   ligada por 'next'; os membros de objetos guardam o nome em 'key'.
+ *   'start' e 'end' delimitam o valor no texto original, para repetir um
+ *   'id' exatamente como veio
+ * - JsonWriter: Texto de saída
+ *
+ * Limitações:
+ * - Profundidade máxima de JSON_MAX_DEPTH níveis
+ * - Números são lidos como double
+ */
+
+#ifndef JSON_H
+#define JSON_H
+
+#include <stdarg.h>
+#include "arena.h"
+
+#define JSON_MAX_DEPTH 64
+
+// Tipos de valor
+typedef enum {
+    JSON_NULL,
+    JSON_FALSE,
+    JSON_TRUE,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT
+} JsonKind;
+
+// Estrutura de um valor (deslocamentos na arena; 0 = nenhum)
+typedef struct {
+    uint32_t kind;
+    uint32_t next;             // Próximo irmão no array ou objeto
+    uint32_t key;              // Membro de objeto: nome (texto na arena)
+    uint32_t first;            // Array e objeto: primeiro filho; string: texto decodificado
+    uint32_t length;           // Array e objeto: número de filhos; string: bytes
+    uint32_t start, end;       // Trecho no texto original
+    double number;
+} JsonValue;
+
+// Estrutura do leitor
+typedef struct {
+    Arena *arena;
+    const char *text;
+    uint32_t length;
+    uint32_t position;
+    int depth;
+} JsonReader;
+
+// Estrutura do texto de saída
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+} JsonWriter;
+
+#define JSON_AT(arena, ref) ARENA_AT(arena, JsonValue, ref)
+
+// Função para pular espaços
+static void jsonSkipSpace(JsonReader *reader) {
+    while (reader->position < reader->length) {
+        char c = reader->text[reader->position];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            break;
+        }
+        reader->position++;
+    }
+}
+
+// Função para ler 4 dígitos hexadecimais; devolve -1 se inválidos
+static int jsonHex4(JsonReader *reader) {
+    if (reader->position + 4 > reader->length) {
+        return -1;
+    }
+    int value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = reader->text[reader->position++];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= c - '0';
+        else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+        else return -1;
+    }
+    return value;
+}
+
+// Função para ler uma string (a posição está depois da aspa); devolve o deslocamento do texto decodificado ou 0
+static uint32_t jsonReadString(JsonReader *reader, uint32_t *length) {
+    // O texto decodificado nunca é maior que o original
+    uint32_t scan = reader->position;
+    while (scan < reader->length && reader->text[scan] != '"') {
+        scan += reader->text[scan] == '\\' ? 2 : 1;
+    }
+    if (scan >= reader->length) {
+        return 0;
+    }
+    uint32_t ref = arenaAlloc(reader->arena, scan - reader->position + 1);
+    char *out = reader->arena->base + ref, *begin = out;
+    while (reader->text[reader->position] != '"') {
+        char c = reader->text[reader->position++];
+        if (c != '\\') {
+            *out++ = c;
+            continue;
+        }
+        c = reader->text[reader->position++];
+        switch (c) {
+            case '"': case '\\': case '/': *out++ = c; break;
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'u': {
+                int code = jsonHex4(reader);
+                if (code < 0) {
+                    return 0;
+                }
+                // Par substituto UTF-16
+                if (code >= 0xD800 && code < 0xDC00 && reader->position + 6 <= reader->length &&
+                    reader->text[reader->position] == '\\' && reader->text[reader->position + 1] == 'u') {
+                    reader->position += 2;
+                    int low = jsonHex4(reader);
+                    if (low < 0xDC00 || low >= 0xE000) {
+                        return 0;
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                if (code < 0x80) {
+                    *out++ = (char)code;
+                } else if (code < 0x800) {
+                    *out++ = (char)(0xC0 | (code >> 6));
+                    *out++ = (char)(0x80 | (code & 0x3F));
+                } else if (code < 0x10000) {
+                    *out++ = (char)(0xE0 | (code >> 12));
+                    *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+                    *out++ = (char)(0x80 | (code & 0x3F));
+                } else {
+                    *out++ = (char)(0xF0 | (code >> 18));
+                    *out++ = (char)(0x80 | ((code >> 12) & 0x3F));
+                    *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+                    *out++ = (char)(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                return 0;
+        }
+    }
+    reader->position++;
+    *out = '\0';
+    *length = (uint32_t)(out - begin);
+    return ref;
+}
+
+// Função para ler um valor; devolve o deslocamento ou 0 em caso de erro
+static uint32_t jsonReadValue(JsonReader *reader) {
+    jsonSkipSpace(reader);
+    if (reader->position >= reader->length || reader->depth >= JSON_MAX_DEPTH) {
+        return 0;
+    }
+    uint32_t ref = arenaAlloc(reader->arena, sizeof(JsonValue));
+    JsonValue value;
+    memset(&value, 0, sizeof(value));
+    value.start = reader->position;
+    char c = reader->text[reader->position];
+
+    if (c == '{' || c == '[') {
+        char close = c == '{' ? '}' : ']';
+        value.kind = c == '{' ? JSON_OBJECT : JSON_ARRAY;
+        reader->position++;
+        reader->depth++;
+        uint32_t last = 0;
+        jsonSkipSpace(reader);
+        if (reader->position < reader->length && reader->text[reader->position] == close) {
+            reader->position++;
+        } else {
+            for (;;) {
+                uint32_t key = 0, keyLength;
+                if (value.kind == JSON_OBJECT) {
+                    jsonSkipSpace(reader);
+                    if (reader->position >= reader->length || reader->text[reader->position] != '"') {
+                        return 0;
+                    }
+                    reader->position++;
+                    if (!(key = jsonReadString(reader, &keyLength))) {
+                        return 0;
+                    }
+                    jsonSkipSpace(reader);
+                    if (reader->position >= reader->length || reader->text[reader->position++] != ':') {
+                        return 0;
+                    }
+                }
+                uint32_t child = jsonReadValue(reader);
+                if (!child) {
+                    return 0;
+                }
+                JSON_AT(reader->arena, child)->key = key;
+                if (last) {
+                    JSON_AT(reader->arena, last)->next = child;
+                } else {
+                    value.first = child;
+                }
+                last = child;
+                value.length++;
+                jsonSkipSpace(reader);
+                if (reader->position >= reader->length) {
+                    return 0;
+                }
+                c = reader->text[reader->position++];
+                if (c == close) {
+                    break;
+                }
+                if (c != ',') {
+                    return 0;
+                }
+            }
+        }
+        reader->depth--;
+    } else if (c == '"') {
+        value.kind = JSON_STRING;
+        reader->position++;
+        if (!(value.first = jsonReadString(reader, &value.length))) {
+            return 0;
+        }
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+        char *end;
+        value.kind = JSON_NUMBER;
+        value.number = strtod(reader->text + reader->position, &end);
+        reader->position = (uint32_t)(end - reader->text);
+    } else {
+        static const char *const words[] = {"null", "false", "true"};
+        int matched = 0;
+        for (int i = 0; i < 3 && !matched; i++) {
+            size_t n = strlen(words[i]);
+            if (reader->position + n <= reader->length && memcmp(reader->text + reader->position, words[i], n) == 0) {
+                value.kind = JSON_NULL + i;
+                reader->position += (uint32_t)n;
+                matched = 1;
+            }
+        }
+        if (!matched) {
+            return 0;
+        }
+    }
+    value.end = reader->position;
+    *JSON_AT(reader->arena, ref) = value;
+    return ref;
+}
+
+// Função para ler um texto JSON (terminado em '\0') para a arena; devolve a raiz ou 0 em caso de erro
+uint32_t jsonParse(Arena *arena, const char *text, uint32_t length) {
+    JsonReader reader = {arena, text, length, 0, 0};
+    uint32_t root = jsonReadValue(&reader);
+    jsonSkipSpace(&reader);
+    return reader.position == length ? root : 0;
+}
+
+// Função para obter um membro de um objeto pelo nome; devolve 0 se não existir
+uint32_t jsonMember(const Arena *arena, uint32_t object, const char *name) {
+    if (!object || JSON_AT(arena, object)->kind != JSON_OBJECT) {
+        return 0;
+    }
+    for (uint32_t child = JSON_AT(arena, object)->first; child; child = JSON_AT(arena, child)->next) {
+        if (strcmp(arena->base + JSON_AT(arena, child)->key, name) == 0) {
+            return child;
+        }
+    }
+    return 0;
+}
+
+// Função para seguir um caminho de membros separados por ponto (ex.: "params.textDocument.uri")
+uint32_t jsonPath(const Arena *arena, uint32_t value, const char *path) {
+    char name[64];
+    while (value && *path) {
+        size_t n = strcspn(path, ".");
+        if (n >= sizeof(name)) {
+            return 0;
+        }
+        memcpy(name, path, n);
+        name[n] = '\0';
+        value = jsonMember(arena, value, name);
+        path += n + (path[n] == '.');
+    }
+    return value;
+}
+
+// Função para obter o texto de uma string; devolve NULL se o valor não for string
+const char *jsonString(const Arena *arena, uint32_t value, uint32_t *length) {
+    if (!value || JSON_AT(arena, value)->kind != JSON_STRING) {
+        return NULL;
+    }
+    if (length) {
+        *length = JSON_AT(arena, value)->length;
+    }
+    return arena->base + JSON_AT(arena, value)->first;
+}
+
+// Função para obter um número; devolve 'fallback' se o valor não for número
+double jsonNumber(const Arena *arena, uint32_t value, double fallback) {
+    return value && JSON_AT(arena, value)->kind == JSON_NUMBER ? JSON_AT(arena, value)->number : fallback;
+}
+
+// Função para garantir espaço para mais 'size' bytes na saída
+static void jsonReserve(JsonWriter *writer, size_t size) {
+    if (writer->length + size <= writer->capacity) {
+        return;
+    }
+    size_t capacity = writer->capacity ? writer->capacity : 4096;
+    while (capacity < writer->length + size) {
+        capacity *= 2;
+    }
+    char *grown = realloc(writer->data, capacity);
+    if (!grown) {
+        fprintf(stderr, "Erro: Falha ao alocar a saída JSON.\n");
+        exit(EXIT_FAILURE);
+    }
+    writer->data = grown;
+    writer->capacity = capacity;
+}
+
+// Função para escrever bytes sem alteração
+void jsonWriteRaw(JsonWriter *writer, const char *bytes, size_t size) {
+    jsonReserve(writer, size);
+    memcpy(writer->data + writer->length, bytes, size);
+    writer->length += size;
+}
+
+// Função para escrever texto formatado sem alteração
+void jsonWritef(JsonWriter *writer, const char *format, ...) {
+    va_list args;
+    jsonReserve(writer, 256);
+    va_start(args, format);
+    int size = vsnprintf(writer->data + writer->length, writer->capacity - writer->length, format, args);
+    va_end(args);
+    if ((size_t)size >= writer->capacity - writer->length) {
+        jsonReserve(writer, (size_t)size + 1);
+        va_start(args, format);
+        vsnprintf(writer->data + writer->length, (size_t)size + 1, format, args);
+        va_end(args);
+    }
+    writer->length += (size_t)size;
+}
+
+// Função para escrever um inteiro sem sinal (caminho rápido para os arrays de tokens)
+void jsonWriteUint(JsonWriter *writer, uint32_t value) {
+    char digits[10];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    jsonReserve(writer, (size_t)n);
+    while (n) {
+        writer->data[writer->length++] = digits[--n];
+    }
+}
+
+// Função para escrever uma string com aspas e escapes
+void jsonWriteString(JsonWriter *writer, const char *text, size_t size) {
+    jsonReserve(writer, size * 6 + 2);
+    char *out = writer->data + writer->length;
+    *out++ = '"';
+    for (size_t i = 0; i < size; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\') {
+            *out++ = '\\';
+            *out++ = (char)c;
+        } else if (c == '\n') {
+            *out++ = '\\';
+            *out++ = 'n';
+        } else if (c < 0x20) {
+            out += sprintf(out, "\\u%04x", c);
+        } else {
+            *out++ = (char)c;
+        }
+    }
+    *out++ = '"';
+    writer->length = (size_t)(out - writer->data);
+}
+
+// Função para liberar a saída
+void jsonWriterFree(JsonWriter *writer) {
+    free(writer->data);
+    memset(writer, 0, sizeof(*writer));
+}
+
+#endif
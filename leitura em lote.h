@@ -0,0 +1,599 @@
+/*
+ * Leitura de arquivos em lote
+ *
+ * Lê muitos arquivos pequenos sem parar a análise a cada leitura: uma
+ * thread de E/S abre, consulta o tamanho e lê os arquivos à frente de quem
+ * os consome, e cada arquivo lido é entregue pronto para o analisador
+ * léxico (convertido para UTF-8 por decodeSource na thread que o recebe).
+ *
+ * Modos:
+ * - io_uring (padrão, se o kernel permitir): a thread de E/S fala com o
+ *   anel diretamente pelas chamadas de sistema io_uring_setup e
+ *   io_uring_enter (sem liburing). Cada arquivo começa com OPENAT e STATX
+ *   (independentes, no mesmo lote); quando os dois terminam, o buffer é
+ *   alocado com o tamanho exato e um READ é enviado; depois do último
+ *   READ, um CLOSE. Todas as operações prontas vão em uma única
+ *   io_uring_enter, que também espera a próxima conclusão
+ * - pread: BATCH_READ_THREADS threads fazem open/fstat/pread/close, um
+ *   arquivo de cada vez (usado quando io_uring_setup falha ou quando
+ *   pedido)
+ *
+ * Entrega: batchReaderTake espera o arquivo de um índice (consumo em
+ * ordem, para saídas que seguem a ordem dos arquivos) e batchReaderNext
+ * devolve o próximo arquivo concluído (consumo por ordem de conclusão,
+ * para várias threads). Os dois não devem ser misturados.
+ *
+ * Leituras avulsas: batchReaderRead lê um arquivo fora da lista (ex.: um
+ * cabeçalho achado durante a análise) pela mesma E/S e espera o resultado.
+ * No io_uring, o pedido ocupa uma das BATCH_READ_FETCHES posições extras e
+ * passa à frente dos arquivos da lista; com pread, a própria thread lê.
+ * Por isso a thread do anel só termina em batchReaderFinish.
+ *
+ * Memória: no máximo BATCH_READ_WINDOW arquivos ficam lidos ou em leitura
+ * sem terem sido entregues; a E/S espera o consumidor quando a janela
+ * enche. As operações em andamento no anel nunca passam do número de
+ * entradas da fila de envio, então a fila de conclusões (o dobro) não
+ * transborda.
+ *
+ * Limitações:
+ * - Um arquivo cujo tamanho muda durante a leitura é lido até o tamanho
+ *   informado pelo STATX (ou até o fim, se encolheu)
+ */
+
+#ifndef LEITURA_EM_LOTE_H
+#define LEITURA_EM_LOTE_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <linux/stat.h>
+#include "analise lexica.h"
+
+#define BATCH_READ_WINDOW 128
+#define BATCH_READ_RING 64
+#define BATCH_READ_THREADS 4
+#define BATCH_READ_CHUNK (1u << 30)   // Maior READ enviado de uma vez
+#define BATCH_READ_FETCHES 16         // Leituras avulsas ao mesmo tempo
+
+// Modos de leitura
+typedef enum {
+    BATCH_READ_AUTO,           // io_uring, ou pread se não houver
+    BATCH_READ_PREAD
+} BatchReadMode;
+
+// Operações no anel (2 bits baixos do user_data; o resto é o índice do arquivo)
+enum {
+    BATCH_OP_OPEN,
+    BATCH_OP_STATX,
+    BATCH_OP_READ,
+    BATCH_OP_CLOSE
+};
+
+// Estrutura de um arquivo do lote
+typedef struct {
+    char *code;                // Conteúdo (UTF-8 terminado em '\0' depois da entrega; NULL se falhou)
+    long size;
+    SourceEncoding encoding;
+    int error;                 // errno da falha (0 = lido)
+    int ready;
+    int taken;                 // Já entregue (o conteúdo é do consumidor)
+    const char *path;          // Leitura avulsa: caminho (NULL = posição livre)
+    int queued;                // Leitura avulsa ainda não enviada ao anel
+    // Estado da leitura pelo io_uring
+    int fd;
+    int waiting;               // OPENAT/STATX ainda sem conclusão
+    uint64_t done;
+    struct statx info;
+} BatchFile;
+
+// Estrutura do anel io_uring mapeado
+typedef struct {
+    int fd;
+    unsigned entries;
+    unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sqMap, *cqMap;
+    size_t sqMapSize, cqMapSize;
+    unsigned queued;           // SQEs preparadas e ainda não enviadas
+    unsigned inFlight;         // Enviadas e sem conclusão
+} BatchRing;
+
+// Estrutura do leitor
+typedef struct {
+    char **paths;
+    uint32_t count;
+    BatchFile *files;          // Os 'count' da lista e depois as BATCH_READ_FETCHES posições avulsas
+    uint32_t started;          // Arquivos cuja leitura começou
+    uint32_t delivered;        // Arquivos entregues ao consumidor
+    uint32_t *readyQueue;      // Índices na ordem de conclusão
+    uint32_t readyHead, readyTail;
+    int stop;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int useRing;
+    int ringFailed;            // O anel parou (as leituras avulsas passam a usar pread)
+    BatchRing ring;
+    pthread_t threads[BATCH_READ_THREADS];
+    int threadCount;
+    uint64_t enters;           // Chamadas a io_uring_enter
+} BatchReader;
+
+// Função para criar o anel; devolve 0 ou -1 (io_uring indisponível)
+static int batchRingInit(BatchRing *ring, unsigned entries) {
+    struct io_uring_params params;
+    memset(ring, 0, sizeof(*ring));
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0) {
+        return -1;
+    }
+    ring->entries = params.sq_entries;
+    ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    int single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && ring->cqMapSize > ring->sqMapSize) {
+        ring->sqMapSize = ring->cqMapSize;
+    }
+    ring->sqMap = mmap(NULL, ring->sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                       IORING_OFF_SQ_RING);
+    ring->cqMap = single ? ring->sqMap
+                         : mmap(NULL, ring->cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                                IORING_OFF_CQ_RING);
+    ring->sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqMap == MAP_FAILED || ring->cqMap == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        if (ring->sqMap != MAP_FAILED) munmap(ring->sqMap, ring->sqMapSize);
+        if (!single && ring->cqMap != MAP_FAILED) munmap(ring->cqMap, ring->cqMapSize);
+        if (ring->sqes != MAP_FAILED) munmap(ring->sqes, params.sq_entries * sizeof(struct io_uring_sqe));
+        close(ring->fd);
+        return -1;
+    }
+    char *sq = ring->sqMap, *cq = ring->cqMap;
+    ring->sqHead = (unsigned *)(sq + params.sq_off.head);
+    ring->sqTail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sqMask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned *)(sq + params.sq_off.array);
+    ring->cqHead = (unsigned *)(cq + params.cq_off.head);
+    ring->cqTail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    return 0;
+}
+
+// Função para liberar o anel
+static void batchRingFree(BatchRing *ring) {
+    munmap(ring->sqes, ring->entries * sizeof(struct io_uring_sqe));
+    if (ring->cqMap != ring->sqMap) {
+        munmap(ring->cqMap, ring->cqMapSize);
+    }
+    munmap(ring->sqMap, ring->sqMapSize);
+    close(ring->fd);
+}
+
+// Função para preparar uma SQE (publicada no fim da fila; enviada na próxima io_uring_enter)
+static struct io_uring_sqe *batchRingPrepare(BatchRing *ring, uint8_t opcode, int fd, uint64_t userData) {
+    unsigned tail = *ring->sqTail;
+    unsigned index = tail & *ring->sqMask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->user_data = userData;
+    ring->sqArray[index] = index;
+    __atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+    ring->queued++;
+    return sqe;
+}
+
+// Função para enviar as SQEs preparadas e esperar ao menos uma conclusão
+static int batchRingSubmit(BatchReader *reader) {
+    BatchRing *ring = &reader->ring;
+    int submitted;
+    do {
+        submitted = (int)syscall(__NR_io_uring_enter, ring->fd, ring->queued, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+    } while (submitted < 0 && errno == EINTR);
+    reader->enters++;
+    if (submitted < 0) {
+        return -1;
+    }
+    ring->queued -= (unsigned)submitted;
+    ring->inFlight += (unsigned)submitted;
+    return 0;
+}
+
+// Função para marcar um arquivo como concluído e acordar os consumidores
+static void batchPublish(BatchReader *reader, uint32_t index) {
+    pthread_mutex_lock(&reader->lock);
+    reader->files[index].ready = 1;
+    if (index < reader->count) {
+        reader->readyQueue[reader->readyTail++] = index;
+    }
+    pthread_cond_broadcast(&reader->changed);
+    pthread_mutex_unlock(&reader->lock);
+}
+
+// Função para enviar o próximo READ de um arquivo (até BATCH_READ_CHUNK bytes)
+static void batchQueueRead(BatchReader *reader, uint32_t index) {
+    BatchFile *file = &reader->files[index];
+    uint64_t remaining = (uint64_t)file->size - file->done;
+    struct io_uring_sqe *sqe = batchRingPrepare(&reader->ring, IORING_OP_READ, file->fd,
+                                                (uint64_t)index << 2 | BATCH_OP_READ);
+    sqe->addr = (uint64_t)(uintptr_t)(file->code + file->done);
+    sqe->len = remaining < BATCH_READ_CHUNK ? (uint32_t)remaining : BATCH_READ_CHUNK;
+    sqe->off = file->done;
+}
+
+// Função para encerrar a leitura de um arquivo: fecha o descritor (sem esperar) e entrega o conteúdo
+static void batchFinish(BatchReader *reader, uint32_t index, int error) {
+    BatchFile *file = &reader->files[index];
+    if (file->fd >= 0) {
+        batchRingPrepare(&reader->ring, IORING_OP_CLOSE, file->fd, (uint64_t)index << 2 | BATCH_OP_CLOSE);
+        file->fd = -1;
+    }
+    if (error) {
+        free(file->code);
+        file->code = NULL;
+        file->error = error;
+    } else {
+        file->size = (long)file->done;
+        file->code[file->done] = '\0';
+    }
+    batchPublish(reader, index);
+}
+
+// Função para tratar uma conclusão do anel
+static void batchComplete(BatchReader *reader, const struct io_uring_cqe *cqe) {
+    uint32_t index = (uint32_t)(cqe->user_data >> 2);
+    BatchFile *file = &reader->files[index];
+    int result = cqe->res;
+    switch (cqe->user_data & 3) {
+        case BATCH_OP_OPEN:
+        case BATCH_OP_STATX:
+            if ((cqe->user_data & 3) == BATCH_OP_OPEN) {
+                file->fd = result >= 0 ? result : -1;
+            }
+            if (result < 0 && !file->error) {
+                file->error = -result;
+            }
+            if (--file->waiting > 0) {
+                return;
+            }
+            if (file->error) {
+                batchFinish(reader, index, file->error);
+                return;
+            }
+            file->size = (long)file->info.stx_size;
+            file->code = malloc((size_t)file->size + 1);
+            if (!file->code) {
+                batchFinish(reader, index, ENOMEM);
+                return;
+            }
+            bigAdvise(file->code, (size_t)file->size + 1);
+            if (file->size == 0) {
+                batchFinish(reader, index, 0);
+            } else {
+                batchQueueRead(reader, index);
+            }
+            return;
+        case BATCH_OP_READ:
+            if (result == -EINTR || result == -EAGAIN) {
+                batchQueueRead(reader, index);
+            } else if (result < 0) {
+                batchFinish(reader, index, -result);
+            } else if (result == 0) {
+                batchFinish(reader, index, 0);   // O arquivo encolheu
+            } else if ((file->done += (uint64_t)result) < (uint64_t)file->size) {
+                batchQueueRead(reader, index);
+            } else {
+                batchFinish(reader, index, 0);
+            }
+            return;
+        default:
+            return;   // CLOSE
+    }
+}
+
+// Função para começar a leitura de um arquivo: OPENAT e STATX, independentes, no mesmo lote
+static void batchQueueOpen(BatchReader *reader, uint32_t index, const char *path) {
+    BatchFile *file = &reader->files[index];
+    file->fd = -1;
+    file->waiting = 2;
+    struct io_uring_sqe *sqe = batchRingPrepare(&reader->ring, IORING_OP_OPENAT, AT_FDCWD,
+                                                (uint64_t)index << 2 | BATCH_OP_OPEN);
+    sqe->addr = (uint64_t)(uintptr_t)path;
+    sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    sqe = batchRingPrepare(&reader->ring, IORING_OP_STATX, AT_FDCWD, (uint64_t)index << 2 | BATCH_OP_STATX);
+    sqe->addr = (uint64_t)(uintptr_t)path;
+    sqe->len = STATX_SIZE;
+    sqe->off = (uint64_t)(uintptr_t)&file->info;
+}
+
+// Função executada pela thread de E/S do io_uring
+static void *batchRingRun(void *context) {
+    BatchReader *reader = context;
+    BatchRing *ring = &reader->ring;
+    uint32_t next = 0;
+    while (1) {
+        // Leituras avulsas primeiro (quem pediu está parado esperando), depois os arquivos da lista, enquanto a
+        // janela e o anel deixarem
+        pthread_mutex_lock(&reader->lock);
+        for (uint32_t slot = reader->count; slot < reader->count + BATCH_READ_FETCHES; slot++) {
+            BatchFile *file = &reader->files[slot];
+            if (!reader->stop && file->queued && ring->queued + ring->inFlight + 2 <= ring->entries) {
+                file->queued = 0;
+                batchQueueOpen(reader, slot, file->path);
+            }
+        }
+        while (!reader->stop && next < reader->count && next - reader->delivered < BATCH_READ_WINDOW &&
+               ring->queued + ring->inFlight + 2 <= ring->entries) {
+            batchQueueOpen(reader, next, reader->paths[next]);
+            next++;
+        }
+        reader->started = next;
+        if (ring->queued + ring->inFlight == 0) {
+            // Nada em andamento: a janela está cheia, a lista acabou ou falta um pedido avulso
+            if (reader->stop) {
+                pthread_mutex_unlock(&reader->lock);
+                break;
+            }
+            pthread_cond_wait(&reader->changed, &reader->lock);
+            pthread_mutex_unlock(&reader->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&reader->lock);
+
+        if (batchRingSubmit(reader) != 0) {
+            // O anel falhou: os arquivos ainda não concluídos viram erro
+            int error = errno ? errno : EIO;
+            pthread_mutex_lock(&reader->lock);
+            for (uint32_t i = 0; i < reader->count + BATCH_READ_FETCHES; i++) {
+                BatchFile *file = &reader->files[i];
+                if (!file->ready && (i < reader->count || file->path)) {
+                    file->error = error;
+                    file->ready = 1;
+                    if (i < reader->count) {
+                        reader->readyQueue[reader->readyTail++] = i;
+                    }
+                }
+            }
+            reader->started = reader->count;
+            reader->ringFailed = 1;
+            pthread_cond_broadcast(&reader->changed);
+            pthread_mutex_unlock(&reader->lock);
+            break;
+        }
+
+        // Conclusões (podem preparar READs e CLOSEs para o próximo envio)
+        unsigned head = *ring->cqHead;
+        unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            struct io_uring_cqe cqe = ring->cqes[head & *ring->cqMask];
+            head++;
+            ring->inFlight--;
+            batchComplete(reader, &cqe);
+        }
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+// Função para ler um arquivo inteiro com open/fstat/pread; devolve 0 ou o errno da falha
+static int batchReadWhole(const char *path, BatchFile *file) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        int error = errno;
+        if (fd >= 0) close(fd);
+        return error;
+    }
+    file->code = malloc((size_t)info.st_size + 1);
+    if (!file->code) {
+        close(fd);
+        return ENOMEM;
+    }
+    bigAdvise(file->code, (size_t)info.st_size + 1);
+    uint64_t done = 0;
+    while (done < (uint64_t)info.st_size) {
+        ssize_t got = pread(fd, file->code + done, (size_t)((uint64_t)info.st_size - done), (off_t)done);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            if (got < 0) {
+                int error = errno;
+                close(fd);
+                return error;
+            }
+            break;   // O arquivo encolheu
+        }
+        done += (uint64_t)got;
+    }
+    close(fd);
+    file->code[done] = '\0';
+    file->size = (long)done;
+    return 0;
+}
+
+// Função executada por cada thread de pread
+static void *batchPreadRun(void *context) {
+    BatchReader *reader = context;
+    while (1) {
+        pthread_mutex_lock(&reader->lock);
+        while (!reader->stop && reader->started < reader->count &&
+               reader->started - reader->delivered >= BATCH_READ_WINDOW) {
+            pthread_cond_wait(&reader->changed, &reader->lock);
+        }
+        if (reader->stop || reader->started >= reader->count) {
+            pthread_mutex_unlock(&reader->lock);
+            return NULL;
+        }
+        uint32_t index = reader->started++;
+        pthread_mutex_unlock(&reader->lock);
+
+        BatchFile *file = &reader->files[index];
+        file->error = batchReadWhole(reader->paths[index], file);
+        if (file->error) {
+            free(file->code);
+            file->code = NULL;
+        }
+        batchPublish(reader, index);
+    }
+}
+
+// Função para começar a ler os arquivos em segundo plano; devolve 0 ou -1
+int batchReaderStart(BatchReader *reader, char **paths, uint32_t count, BatchReadMode mode) {
+    memset(reader, 0, sizeof(*reader));
+    reader->paths = paths;
+    reader->count = count;
+    reader->files = calloc(count + BATCH_READ_FETCHES, sizeof(BatchFile));
+    reader->readyQueue = malloc((count + 1) * sizeof(uint32_t));
+    if (!reader->files || !reader->readyQueue) {
+        fprintf(stderr, "Erro: Falha ao alocar a leitura em lote.\n");
+        free(reader->files);
+        free(reader->readyQueue);
+        return -1;
+    }
+    pthread_mutex_init(&reader->lock, NULL);
+    pthread_cond_init(&reader->changed, NULL);
+    reader->useRing = mode == BATCH_READ_AUTO && batchRingInit(&reader->ring, BATCH_READ_RING) == 0;
+    int wanted = reader->useRing ? 1 : BATCH_READ_THREADS;
+    for (int t = 0; t < wanted; t++) {
+        if (pthread_create(&reader->threads[t], NULL, reader->useRing ? batchRingRun : batchPreadRun, reader) != 0) {
+            break;
+        }
+        reader->threadCount++;
+    }
+    if (reader->threadCount == 0) {
+        fprintf(stderr, "Erro: Falha ao criar a thread de leitura.\n");
+        if (reader->useRing) {
+            batchRingFree(&reader->ring);
+        }
+        pthread_mutex_destroy(&reader->lock);
+        pthread_cond_destroy(&reader->changed);
+        free(reader->files);
+        free(reader->readyQueue);
+        return -1;
+    }
+    return 0;
+}
+
+// Função para concluir a entrega de um arquivo (na thread do consumidor): converte para UTF-8 ou informa o erro
+static BatchFile *batchDeliver(BatchFile *file) {
+    if (file->error) {
+        fprintf(stderr, "Erro ao abrir o arquivo: %s\n", strerror(file->error));
+        return file;
+    }
+    file->encoding = decodeSource(&file->code, &file->size);
+    if (!file->code) {
+        fprintf(stderr, "Erro ao alocar memória\n");
+        file->error = ENOMEM;
+    }
+    return file;
+}
+
+// Função para esperar o arquivo 'index' (consumo em ordem); o conteúdo passa a ser do chamador
+BatchFile *batchReaderTake(BatchReader *reader, uint32_t index) {
+    pthread_mutex_lock(&reader->lock);
+    while (!reader->files[index].ready) {
+        pthread_cond_wait(&reader->changed, &reader->lock);
+    }
+    reader->files[index].taken = 1;
+    reader->delivered++;
+    pthread_cond_broadcast(&reader->changed);
+    pthread_mutex_unlock(&reader->lock);
+    return batchDeliver(&reader->files[index]);
+}
+
+// Função para obter o próximo arquivo concluído (qualquer thread); devolve o índice ou UINT32_MAX no fim
+uint32_t batchReaderNext(BatchReader *reader) {
+    pthread_mutex_lock(&reader->lock);
+    while (reader->readyHead == reader->readyTail && reader->readyHead < reader->count) {
+        pthread_cond_wait(&reader->changed, &reader->lock);
+    }
+    if (reader->readyHead >= reader->count) {
+        pthread_mutex_unlock(&reader->lock);
+        return UINT32_MAX;
+    }
+    uint32_t index = reader->readyQueue[reader->readyHead++];
+    reader->files[index].taken = 1;
+    reader->delivered++;
+    pthread_cond_broadcast(&reader->changed);
+    pthread_mutex_unlock(&reader->lock);
+    batchDeliver(&reader->files[index]);
+    return index;
+}
+
+// Função para ler um arquivo fora da lista pela E/S do lote e esperar por ele (qualquer thread); devolve o
+// conteúdo em UTF-8 (do chamador) ou NULL
+char *batchReaderRead(BatchReader *reader, const char *path, long *size) {
+    BatchFile result = {.fd = -1};
+    pthread_mutex_lock(&reader->lock);
+    if (!reader->useRing || reader->ringFailed) {
+        pthread_mutex_unlock(&reader->lock);
+        result.error = batchReadWhole(path, &result);
+        if (result.error) {
+            free(result.code);
+            result.code = NULL;
+        }
+    } else {
+        // Uma posição avulsa livre; a thread do anel envia o pedido na próxima volta
+        BatchFile *slot = NULL;
+        while (!slot) {
+            for (uint32_t i = reader->count; i < reader->count + BATCH_READ_FETCHES && !slot; i++) {
+                slot = reader->files[i].path ? NULL : &reader->files[i];
+            }
+            if (!slot) {
+                pthread_cond_wait(&reader->changed, &reader->lock);
+            }
+        }
+        memset(slot, 0, sizeof(*slot));
+        slot->path = path;
+        slot->queued = 1;
+        pthread_cond_broadcast(&reader->changed);
+        while (!slot->ready) {
+            pthread_cond_wait(&reader->changed, &reader->lock);
+        }
+        result = *slot;
+        memset(slot, 0, sizeof(*slot));
+        pthread_cond_broadcast(&reader->changed);
+        pthread_mutex_unlock(&reader->lock);
+    }
+    batchDeliver(&result);
+    if (size) {
+        *size = result.code ? result.size : 0;
+    }
+    return result.code;
+}
+
+// Função para encerrar a leitura (os arquivos não entregues são descartados)
+void batchReaderFinish(BatchReader *reader) {
+    pthread_mutex_lock(&reader->lock);
+    reader->stop = 1;
+    pthread_cond_broadcast(&reader->changed);
+    pthread_mutex_unlock(&reader->lock);
+    for (int t = 0; t < reader->threadCount; t++) {
+        pthread_join(reader->threads[t], NULL);
+    }
+    if (reader->useRing) {
+        batchRingFree(&reader->ring);
+    }
+    for (uint32_t i = 0; i < reader->count; i++) {
+        if (!reader->files[i].taken) {
+            free(reader->files[i].code);
+        }
+    }
+    pthread_mutex_destroy(&reader->lock);
+    pthread_cond_destroy(&reader->changed);
+    free(reader->files);
+    free(reader->readyQueue);
+}
+
+#endif
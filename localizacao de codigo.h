@@ -0,0 +1,174 @@
+/*
+ * Localizações compactas (SourceLoc) e tabela de arquivos
+ *
+ * Uma localização é um único inteiro de 32 bits. Cada arquivo carregado
+ * recebe um intervalo [base, base + tamanho] de um espaço de endereços
+ * comum a todos os arquivos do processo, e a localização de um byte é a
+ * base do arquivo mais o seu deslocamento. Com isso, um token de qualquer
+ * arquivo se localiza pelo deslocamento de 32 bits que já guarda, sem linha
+ * nem nome de arquivo, e uma mensagem que cita tokens de arquivos
+ * diferentes resolve cada um exatamente.
+ *
+ * Estruturas principais:
+ * - SourceLoc: Localização (0 = nenhuma)
+ * - FileTableEntry: Caminho, código, base e tamanho de um arquivo, e o seu
+ *   índice de linhas, construído na primeira consulta
+ * - FileTable: Entradas em blocos de endereço fixo, em ordem crescente de
+ *   base. O registro usa um mutex; a consulta não usa trava: lê o número
+ *   de entradas publicado (release/acquire) e faz uma busca binária pela
+ *   base. O índice de linhas é publicado por compare-and-swap (se duas
+ *   threads o constroem ao mesmo tempo, uma descarta o seu)
+ *
+ * Limitações:
+ * - Até 4 GB de código por processo (o registro falha depois disso)
+ * - O código registrado não é copiado: deve continuar válido enquanto as
+ *   suas localizações forem consultadas
+ */
+
+#ifndef LOCALIZACAO_DE_CODIGO_H
+#define LOCALIZACAO_DE_CODIGO_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include "analise lexica.h"
+
+#define FILE_TABLE_CHUNK 1024
+#define FILE_TABLE_MAX_CHUNKS 1024
+
+// Localização de 32 bits no espaço comum dos arquivos
+typedef uint32_t SourceLoc;
+
+// Estrutura do índice de linhas de um arquivo
+typedef struct {
+    int count;
+    int *starts;
+} LineIndex;
+
+// Estrutura de um arquivo registrado
+typedef struct {
+    char *path;
+    const char *code;
+    SourceLoc base;
+    uint32_t size;
+    _Atomic(LineIndex *) lines;
+} FileTableEntry;
+
+// Estrutura da tabela de arquivos
+typedef struct {
+    FileTableEntry *chunks[FILE_TABLE_MAX_CHUNKS];
+    atomic_uint count;           // Entradas publicadas
+    SourceLoc next;              // Próxima base livre (protegido por 'lock')
+    pthread_mutex_t lock;
+} FileTable;
+
+// Tabela de arquivos do processo
+FileTable fileTable = {.next = 1, .lock = PTHREAD_MUTEX_INITIALIZER};
+
+// Função para obter a entrada 'index' da tabela
+static FileTableEntry *fileTableAt(uint32_t index) {
+    return &fileTable.chunks[index / FILE_TABLE_CHUNK][index % FILE_TABLE_CHUNK];
+}
+
+// Função para registrar um arquivo; devolve a sua base (0 se o espaço de 32 bits acabou)
+SourceLoc fileTableAdd(const char *path, const char *code, uint32_t size) {
+    pthread_mutex_lock(&fileTable.lock);
+    uint32_t index = atomic_load_explicit(&fileTable.count, memory_order_relaxed);
+    // Um byte a mais: a posição logo depois do fim do arquivo também é uma localização
+    if ((uint64_t)fileTable.next + size + 1 > UINT32_MAX || index >= FILE_TABLE_CHUNK * FILE_TABLE_MAX_CHUNKS) {
+        pthread_mutex_unlock(&fileTable.lock);
+        return 0;
+    }
+    if (!fileTable.chunks[index / FILE_TABLE_CHUNK]) {
+        fileTable.chunks[index / FILE_TABLE_CHUNK] = calloc(FILE_TABLE_CHUNK, sizeof(FileTableEntry));
+    }
+    char *copy = strdup(path);
+    if (!fileTable.chunks[index / FILE_TABLE_CHUNK] || !copy) {
+        fprintf(stderr, "Erro: Falha ao alocar a tabela de arquivos.\n");
+        exit(EXIT_FAILURE);
+    }
+    FileTableEntry *entry = fileTableAt(index);
+    entry->path = copy;
+    entry->code = code;
+    entry->base = fileTable.next;
+    entry->size = size;
+    atomic_init(&entry->lines, NULL);
+    fileTable.next += size + 1;
+    atomic_store_explicit(&fileTable.count, index + 1, memory_order_release);
+    pthread_mutex_unlock(&fileTable.lock);
+    return entry->base;
+}
+
+// Função para encontrar o arquivo de uma localização (NULL se nenhum)
+const FileTableEntry *sourceLocFile(SourceLoc loc) {
+    uint32_t count = atomic_load_explicit(&fileTable.count, memory_order_acquire);
+    uint32_t low = 0, high = count;
+    while (low < high) {
+        uint32_t mid = (low + high) / 2;
+        if (fileTableAt(mid)->base <= loc) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == 0) {
+        return NULL;
+    }
+    const FileTableEntry *entry = fileTableAt(low - 1);
+    return loc - entry->base <= entry->size ? entry : NULL;
+}
+
+// Função para obter o índice de linhas de um arquivo (construído na primeira consulta)
+static const LineIndex *fileTableLines(FileTableEntry *entry) {
+    LineIndex *lines = atomic_load_explicit(&entry->lines, memory_order_acquire);
+    if (lines) {
+        return lines;
+    }
+    LineIndex *built = malloc(sizeof(LineIndex));
+    if (!built) {
+        fprintf(stderr, "Erro: Falha ao alocar o índice de linhas.\n");
+        exit(EXIT_FAILURE);
+    }
+    built->starts = buildLineStarts(entry->code, &built->count);
+    if (atomic_compare_exchange_strong_explicit(&entry->lines, &lines, built, memory_order_acq_rel,
+                                                memory_order_acquire)) {
+        return built;
+    }
+    free(built->starts);   // Outra thread publicou antes
+    free(built);
+    return lines;
+}
+
+// Função para converter uma localização em arquivo, linha e coluna; devolve 0 ou -1 se a localização não existe
+int sourceLocResolve(SourceLoc loc, const char **path, int *line, int *column) {
+    FileTableEntry *entry = (FileTableEntry *)sourceLocFile(loc);
+    if (!entry) {
+        return -1;
+    }
+    const LineIndex *lines = fileTableLines(entry);
+    locateOffset(lines->starts, lines->count, (int)(loc - entry->base), line, column);
+    *path = entry->path;
+    return 0;
+}
+
+// Função para liberar a tabela (nenhuma thread pode estar consultando)
+void fileTableFree(void) {
+    uint32_t count = atomic_load_explicit(&fileTable.count, memory_order_relaxed);
+    for (uint32_t i = 0; i < count; i++) {
+        FileTableEntry *entry = fileTableAt(i);
+        LineIndex *lines = atomic_load_explicit(&entry->lines, memory_order_relaxed);
+        if (lines) {
+            free(lines->starts);
+            free(lines);
+        }
+        free(entry->path);
+    }
+    for (int i = 0; i < FILE_TABLE_MAX_CHUNKS; i++) {
+        free(fileTable.chunks[i]);
+        fileTable.chunks[i] = NULL;
+    }
+    atomic_store_explicit(&fileTable.count, 0, memory_order_relaxed);
+    fileTable.next = 1;
+}
+
+#endif
@@ -0,0 +1,222 @@
+/*
+ * Programa da máquina virtual
+ *
+ * Lê o arquivo de entrada, executa as análises, gera e otimiza o código
+ * intermediário, compila o bytecode (maquina virtual.h) e executa o programa.
+ *
+ * Opções:
+ * - --codigo: exibe o bytecode antes de executar
+ * - --sem-otimizacao: compila o código intermediário sem os passos de otimização
+ * - --estatisticas: executa no modo de contagem e exibe as instruções executadas
+ * - --benchmark: executa os micro-benchmarks (laços, aritmética e chamadas) e
+ *   exibe o custo de despacho por instrução
+ */
+
+#include "maquina virtual.h"
+
+#define BENCHMARK_RUNS 5
+
+// Estrutura de um micro-benchmark
+typedef struct {
+    const char *name;
+    const char *code;
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+    {"laços",
+     "class B { static void Main() { int s = 0;\n"
+     "  for (int i = 0; i < 3000; i++) { for (int j = 0; j < 1000; j++) { s = s + j; } }\n"
+     "  printf(\"%d\\n\", s); } }\n"},
+    {"aritmética",
+     "class B { static void Main() { int a = 1; double x = 0.5;\n"
+     "  for (int i = 0; i < 1000000; i++) { a = (a * 31 + i) % 1000003; x = x * 0.999 + a / 3.0 - x / 7.0; }\n"
+     "  printf(\"%d %f\\n\", a, x); } }\n"},
+    {"chamadas",
+     "class B { static int Fib(int n) { if (n < 2) return n; return Fib(n - 1) + Fib(n - 2); }\n"
+     "  static int Inc(int x) { return x + 1; }\n"
+     "  static void Main() { int s = 0; for (int i = 0; i < 500000; i++) { s = Inc(s); }\n"
+     "  printf(\"%d %d\\n\", Fib(25), s); } }\n"},
+};
+
+// Função para medir o tempo em milissegundos
+double elapsedMs(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e3 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Função para compilar o código fonte até o bytecode; devolve 0 em caso de sucesso
+int compileProgram(const char *code, int optimize, VmProgram *program) {
+    int status = -1;
+    lexicalAnalysis(code);
+
+    Ast ast;
+    Parser parser;
+    astInit(&ast, code, tokenCount);
+    parserInit(&parser, &ast, tokens, tokenCount);
+    parseProgram(&parser);
+
+    Checker checker;
+    if (parser.errorCount) {
+        printf("\n%d erro(s) sintático(s); programa não executado.\n", parser.errorCount);
+    } else if (semanticAnalysis(&checker, &ast, NULL)) {
+        printf("\n%d erro(s) semântico(s); programa não executado.\n", checker.errorCount);
+    } else {
+        IrModule module;
+        IrGenerator generator;
+        int errors = generateIr(&generator, &module, &ast);
+        if (errors) {
+            printf("\n%d erro(s) na geração de código; programa não executado.\n", errors);
+        } else {
+            OptStats stats;
+            if (optimize) {
+                optimizeModule(&module, &stats, 0);
+            }
+            errors = vmCompile(program, &module);
+            if (errors) {
+                printf("\n%d erro(s) na geração de bytecode; programa não executado.\n", errors);
+                vmProgramFree(program);
+            } else {
+                status = 0;
+            }
+        }
+        irModuleFree(&module);
+    }
+    astFree(&ast);
+    freeTokens();
+    freeLineIndex();
+    return status;
+}
+
+// Função para exibir as instruções executadas por opcode (modo de contagem)
+void printCounts(const Vm *vm) {
+    uint64_t total = 0;
+    for (int op = 0; op < VM_OPCODE_COUNT; op++) {
+        total += vm->counts[op];
+    }
+    printf("\nInstruções executadas: %llu\n", (unsigned long long)total);
+    for (int op = 0; op < VM_OPCODE_COUNT; op++) {
+        if (vm->counts[op]) {
+            printf("  %-8s %12llu  (%5.1f%%)\n", vmOpcodeNames[op], (unsigned long long)vm->counts[op],
+                   100.0 * vm->counts[op] / total);
+        }
+    }
+}
+
+// Função para executar os micro-benchmarks
+int runBenchmarks(int optimize) {
+    static Vm vm;
+    printf("%-12s %12s %10s %10s %12s %8s\n", "Benchmark", "Instruções", "Tempo (ms)", "ns/instr",
+           "Minstr/s", "Super");
+    for (size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++) {
+        VmProgram program;
+        if (compileProgram(benchmarks[b].code, optimize, &program) != 0) {
+            return EXIT_FAILURE;
+        }
+
+        // Contagem das instruções em uma execução separada; a saída é descartada
+        vmInit(&vm, &program, NULL);
+        vm.counting = 1;
+        if (vmRun(&vm) != 0) {
+            fprintf(stderr, "%s\n", vm.error);
+            return EXIT_FAILURE;
+        }
+        uint64_t executed = 0;
+        for (int op = 0; op < VM_OPCODE_COUNT; op++) {
+            executed += vm.counts[op];
+        }
+        vmFree(&vm);
+
+        // Melhor tempo entre as execuções normais
+        double best = 0;
+        for (int run = 0; run < BENCHMARK_RUNS; run++) {
+            struct timespec start;
+            vmInit(&vm, &program, NULL);
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            vmRun(&vm);
+            double ms = elapsedMs(&start);
+            vmFree(&vm);
+            if (run == 0 || ms < best) {
+                best = ms;
+            }
+        }
+        // %-*s conta bytes; compensa os acentos em UTF-8 do nome
+        int extra = 0;
+        for (const char *c = benchmarks[b].name; *c; c++) {
+            extra += ((unsigned char)*c & 0xC0) == 0x80;
+        }
+        printf("%-*s %12llu %10.3f %10.3f %12.1f %8u\n", 12 + extra, benchmarks[b].name,
+               (unsigned long long)executed, best, best * 1e6 / executed, executed / (best * 1e3), program.fused);
+        vmProgramFree(&program);
+    }
+    return EXIT_SUCCESS;
+}
+
+// Função principal
+int main(int argc, char *argv[]) {
+    const char *path = "../input.txt";
+    int showCode = 0, optimize = 1, statistics = 0, benchmark = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--codigo") == 0) {
+            showCode = 1;
+        } else if (strcmp(argv[i], "--sem-otimizacao") == 0) {
+            optimize = 0;
+        } else if (strcmp(argv[i], "--estatisticas") == 0) {
+            statistics = 1;
+        } else if (strcmp(argv[i], "--benchmark") == 0) {
+            benchmark = 1;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (benchmark) {
+        return runBenchmarks(optimize);
+    }
+
+    // Ler todo o conteúdo do arquivo fonte
+    char *code = readSourceFile(path, NULL);
+    if (!code) {
+        return EXIT_FAILURE;
+    }
+
+    VmProgram program;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (compileProgram(code, optimize, &program) != 0) {
+        free(code);
+        return EXIT_FAILURE;
+    }
+    double compileMs = elapsedMs(&start);
+    if (showCode) {
+        printf("Bytecode (%u instruções, %u superinstruções):\n", program.count, program.fused);
+        vmPrintProgram(stdout, &program);
+        printf("\nSaída do programa:\n");
+        fflush(stdout);
+    }
+
+    static Vm vm;
+    vmInit(&vm, &program, stdout);
+    vm.counting = statistics;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int failed = vmRun(&vm) != 0;
+    double runMs = elapsedMs(&start);
+    if (failed) {
+        fprintf(stderr, "%s\n", vm.error);
+    }
+    if (statistics) {
+        printf("\nCompilação: %.3f ms (%u instruções, %u superinstruções)\n", compileMs, program.count,
+               program.fused);
+        printf("Execução: %.3f ms, %llu bytes alocados\n", runMs, (unsigned long long)vm.heapBytes);
+        printCounts(&vm);
+    }
+
+    int status = failed ? EXIT_FAILURE : EXIT_SUCCESS;
+    if (!failed && program.entry >= 0 && program.functions[program.entry].returnType == IR_INT) {
+        status = vm.result.i & 0xFF;
+    }
+    vmFree(&vm);
+    vmProgramFree(&program);
+    free(code);
+    return status;
+}
@@ -0,0 +1,1365 @@
+/*
+ * Máquina virtual de registradores
+ *
+ * Compila o código intermediário otimizado (otimizacao.h) para um bytecode
+ * de registradores e o executa com despacho por "computed goto": cada
+ * instrução guarda o endereço do seu tratador, então passar à próxima
+ * instrução custa um único salto indireto (direct threading), sem o switch
+ * e a verificação de limites de um laço de despacho convencional.
+ *
+ * Estruturas principais:
+ * - VmInstr: Instrução de 24 bytes (tratador, opcode e três operandos).
+ *   Os registradores virtuais do código intermediário viram diretamente
+ *   posições do quadro da função, sem alocação de registradores
+ * - VmProgram: Código de todas as funções em um vetor único, strings
+ *   constantes e formatos pré-analisados de printf/Console.Write
+ * - Vm: Pilha de registradores, pilha de chamadas, variáveis globais,
+ *   objetos alocados e saída com buffer
+ *
+ * Superinstruções geradas para os pares mais comuns:
+ * - Comparação inteira seguida de desvio condicional (JLT, JGE, ...), com
+ *   o segundo operando registrador ou constante (JLTK, JGEK, ...)
+ * - Aritmética inteira com constante (ADDK, MULK), sem carregar a constante
+ * - Cópia seguida de desvio incondicional (MOVJMP), o fim típico de um laço
+ *   depois da saída da SSA
+ *
+ * Chamadas de printf com formato constante (o padrão de input.txt) são
+ * analisadas na compilação: cada conversão vira um segmento com o
+ * registrador do argumento, e na execução %d, %c e %s são escritos
+ * diretamente no buffer de saída, sem passar pelo vfprintf.
+ *
+ * Modo de contagem: o mesmo laço de despacho tem um segundo conjunto de
+ * tratadores que somam a execução de cada opcode e saltam para o tratador
+ * normal. O código é "enfiado" com um ou outro conjunto na entrada de
+ * vmRun, então a execução normal não paga nada pela contagem.
+ *
+ * Limitações:
+ * - Não há coletor de lixo: strings e vetores são liberados em vmFree
+ * - Objetos continuam sem representação (referência nula), como no
+ *   código intermediário
+ */
+
+#ifndef MAQUINA_VIRTUAL_H
+#define MAQUINA_VIRTUAL_H
+
+#include <math.h>
+#include <stddef.h>
+#include "otimizacao.h"
+
+#define VM_STACK_VALUES (1u << 20)
+#define VM_MAX_FRAMES (1u << 16)
+#define VM_OUTPUT_BUFFER (1u << 16)
+
+#if defined(__GNUC__)
+#define VM_THREADED 1
+#else
+#define VM_THREADED 0
+#endif
+
+// Opcodes da máquina virtual: X(nome, texto)
+#define VM_OPCODES(X) \
+    X(LOADK, "loadk") X(LOADF, "loadf") X(LOADS, "loads") X(MOV, "mov") \
+    X(ADD, "add") X(SUB, "sub") X(MUL, "mul") X(DIV, "div") X(MOD, "mod") X(NEG, "neg") \
+    X(ADDK, "addk") X(MULK, "mulk") \
+    X(FADD, "fadd") X(FSUB, "fsub") X(FMUL, "fmul") X(FDIV, "fdiv") X(FMOD, "fmod") X(FNEG, "fneg") \
+    X(NOT, "not") \
+    X(LT, "lt") X(LE, "le") X(GT, "gt") X(GE, "ge") X(EQ, "eq") X(NE, "ne") \
+    X(FLT, "flt") X(FLE, "fle") X(FGT, "fgt") X(FGE, "fge") X(FEQ, "feq") X(FNE, "fne") \
+    X(SEQ, "seq") X(SNE, "sne") X(PEQ, "peq") X(PNE, "pne") \
+    X(I2F, "i2f") X(F2I, "f2i") X(TOSTR, "tostr") X(CONCAT, "concat") \
+    X(GETG, "getg") X(SETG, "setg") \
+    X(NEWARR, "newarr") X(GETIDX, "getidx") X(SETIDX, "setidx") X(LENA, "lena") X(LENS, "lens") \
+    X(JMP, "jmp") X(JT, "jt") X(JF, "jf") \
+    X(JLT, "jlt") X(JLE, "jle") X(JGT, "jgt") X(JGE, "jge") X(JEQ, "jeq") X(JNE, "jne") \
+    X(JLTK, "jltk") X(JLEK, "jlek") X(JGTK, "jgtk") X(JGEK, "jgek") X(JEQK, "jeqk") X(JNEK, "jnek") \
+    X(MOVJMP, "movjmp") \
+    X(CALL, "call") X(RET, "ret") \
+    X(SQRT, "sqrt") X(POW, "pow") X(ABS, "abs") X(FABS, "fabs") \
+    X(MAX, "max") X(MIN, "min") X(FMAX, "fmax") X(FMIN, "fmin") \
+    X(FORMAT, "format") X(PRINTF, "printf")
+
+#define VM_ENUM(name, text) VM_##name,
+#define VM_NAME(name, text) text,
+
+// Enumeração dos opcodes
+typedef enum {
+    VM_OPCODES(VM_ENUM)
+    VM_OPCODE_COUNT
+} VmOpcode;
+
+static const char *vmOpcodeNames[VM_OPCODE_COUNT] = {
+    VM_OPCODES(VM_NAME)
+};
+
+// Estrutura de um valor (registrador, global ou elemento de vetor)
+typedef union {
+    int32_t i;      // int, char e bool
+    double f;
+    void *p;        // VmString ou VmArray (NULL = referência nula)
+    int64_t bits;
+} Value;
+
+// Estrutura de uma instrução
+typedef struct {
+    const void *handler;   // Tratador (preenchido ao "enfiar" o código)
+    uint16_t op;
+    uint32_t a, b, c;      // Operandos: registradores, constantes ou índices
+} VmInstr;
+
+_Static_assert(sizeof(VmInstr) == 24, "VmInstr deve ocupar 24 bytes");
+
+// Estrutura do cabeçalho dos objetos alocados durante a execução
+typedef struct VmObject {
+    struct VmObject *next;
+} VmObject;
+
+// Estrutura de uma string
+typedef struct {
+    VmObject header;
+    uint32_t length;
+    char data[];    // Terminada em '\0'
+} VmString;
+
+// Estrutura de um vetor
+typedef struct {
+    VmObject header;
+    uint32_t length;
+    uint8_t type;   // Tipo dos elementos (IrType)
+    Value items[];
+} VmArray;
+
+// Tipos de segmento de um formato
+typedef enum {
+    SEG_TEXT,         // Texto literal
+    SEG_INT,          // %d e %i sem largura nem precisão
+    SEG_CHAR,         // %c
+    SEG_STRING,       // %s
+    SEG_VALUE,        // Valor no formato do C# (Console.Write e {0})
+    SEG_SPEC_INT,     // Conversão inteira com largura/precisão (snprintf)
+    SEG_SPEC_DOUBLE,  // Conversão de ponto flutuante (snprintf)
+    SEG_SPEC_STRING   // %s com largura/precisão (snprintf)
+} VmSegmentKind;
+
+// Estrutura de um segmento de formato
+typedef struct {
+    uint8_t kind;
+    uint8_t type;        // Tipo do argumento
+    uint32_t reg;        // Registrador do argumento
+    const char *text;    // SEG_TEXT
+    uint32_t length;
+    char spec[16];       // Conversão para o snprintf
+} VmSegment;
+
+// Estrutura de um formato (printf, Console.Write e Console.WriteLine)
+typedef struct {
+    uint32_t first;      // Segmentos em program->segments[first .. first + count)
+    uint32_t count;
+    uint8_t newline;
+} VmFormat;
+
+// Estrutura de uma função compilada
+typedef struct {
+    const char *name;
+    uint32_t nameLength;
+    uint32_t entry;       // Primeira instrução em program->code
+    uint32_t end;
+    uint32_t callOffset;  // Quadro da função chamada começa em base + callOffset
+    uint32_t frameSize;   // Registradores + área de argumentos das chamadas
+    uint32_t paramCount;
+    uint8_t returnType;
+} VmFunction;
+
+// Estrutura do programa
+typedef struct {
+    VmInstr *code;
+    uint32_t count;
+    uint32_t capacity;
+    VmFunction *functions;
+    uint32_t functionCount;
+    VmString **strings;       // Constantes, com endereço estável
+    uint32_t stringCount;
+    uint32_t stringCapacity;
+    VmSegment *segments;
+    uint32_t segmentCount;
+    uint32_t segmentCapacity;
+    VmFormat *formats;
+    uint32_t formatCount;
+    uint32_t formatCapacity;
+    uint32_t globalCount;
+    int entry;
+    uint32_t fused;           // Superinstruções geradas
+    int threading;            // 0 = não enfiado, 1 = normal, 2 = contagem
+    int errorCount;
+} VmProgram;
+
+// Estrutura da saída com buffer
+typedef struct {
+    FILE *file;               // NULL descarta a saída (benchmarks)
+    size_t length;
+    uint64_t written;
+    char buffer[VM_OUTPUT_BUFFER];
+} VmOutput;
+
+// Estrutura de um registro de ativação
+typedef struct {
+    const VmInstr *ret;
+    Value *base;
+    uint32_t dst;
+} VmFrame;
+
+// Estrutura da máquina virtual
+typedef struct {
+    const VmProgram *program;
+    Value *stack;
+    VmFrame *frames;
+    Value *globals;
+    VmObject *heap;
+    uint64_t heapBytes;
+    VmSegment *scratch;       // Segmentos de printf com formato variável
+    uint32_t scratchCount;
+    uint32_t scratchCapacity;
+    int counting;
+    uint64_t counts[VM_OPCODE_COUNT];
+    Value result;
+    char error[256];
+    VmOutput out;
+} Vm;
+
+// ---------------------------------------------------------------------------
+// Saída
+// ---------------------------------------------------------------------------
+
+// Função para descarregar o buffer de saída
+void vmFlush(VmOutput *out) {
+    if (out->file && out->length) {
+        fwrite(out->buffer, 1, out->length, out->file);
+        fflush(out->file);
+    }
+    out->length = 0;
+}
+
+// Função para escrever bytes na saída
+void vmWrite(VmOutput *out, const char *data, size_t length) {
+    out->written += length;
+    if (out->length + length > VM_OUTPUT_BUFFER) {
+        vmFlush(out);
+        if (length > VM_OUTPUT_BUFFER) {
+            if (out->file) fwrite(data, 1, length, out->file);
+            return;
+        }
+    }
+    memcpy(out->buffer + out->length, data, length);
+    out->length += length;
+}
+
+// Função para escrever um inteiro em decimal sem passar pelo printf
+void vmWriteInt(VmOutput *out, int32_t value) {
+    char digits[12];
+    char *p = digits + sizeof(digits);
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    do {
+        *--p = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) {
+        *--p = '-';
+    }
+    vmWrite(out, p, digits + sizeof(digits) - p);
+}
+
+// Função para escrever um caractere (código Unicode) em UTF-8
+void vmWriteChar(VmOutput *out, int32_t code) {
+    char bytes[4];
+    int length;
+    uint32_t c = (uint32_t)code;
+    if (c < 0x80) {
+        bytes[0] = (char)c;
+        length = 1;
+    } else if (c < 0x800) {
+        bytes[0] = (char)(0xC0 | (c >> 6));
+        bytes[1] = (char)(0x80 | (c & 0x3F));
+        length = 2;
+    } else {
+        bytes[0] = (char)(0xE0 | ((c >> 12) & 0x0F));
+        bytes[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+        bytes[2] = (char)(0x80 | (c & 0x3F));
+        length = 3;
+    }
+    vmWrite(out, bytes, length);
+}
+
+// Função para formatar um double como o C# (menor representação que volta ao mesmo valor)
+int vmFormatDouble(char *buffer, size_t size, double value) {
+    if (isnan(value)) return snprintf(buffer, size, "NaN");
+    if (isinf(value)) return snprintf(buffer, size, value > 0 ? "∞" : "-∞");
+    int length = 0;
+    for (int precision = 15; precision <= 17; precision++) {
+        length = snprintf(buffer, size, "%.*g", precision, value);
+        if (strtod(buffer, NULL) == value) {
+            break;
+        }
+    }
+    for (char *c = buffer; *c; c++) {
+        if (*c == 'e') *c = 'E';
+    }
+    return length;
+}
+
+// Função para escrever um valor como o ToString() do C#
+void vmWriteValue(VmOutput *out, Value value, uint8_t type) {
+    char buffer[64];
+    switch (type) {
+        case IR_INT:
+            vmWriteInt(out, value.i);
+            break;
+        case IR_CHAR:
+            vmWriteChar(out, value.i);
+            break;
+        case IR_BOOL:
+            vmWrite(out, value.i ? "True" : "False", value.i ? 4 : 5);
+            break;
+        case IR_DOUBLE:
+            vmWrite(out, buffer, vmFormatDouble(buffer, sizeof(buffer), value.f));
+            break;
+        case IR_STRING:
+            if (value.p) {
+                vmWrite(out, ((VmString *)value.p)->data, ((VmString *)value.p)->length);
+            }
+            break;
+        default:
+            if (value.p) {
+                const VmArray *array = value.p;
+                static const char *names[] = {"Void", "Int32", "Boolean", "Char", "Double", "String", "Object"};
+                int length = snprintf(buffer, sizeof(buffer), "System.%s[]", names[array->type]);
+                vmWrite(out, buffer, length);
+            }
+            break;
+    }
+}
+
+// Função para escrever os segmentos de um formato; devolve o número de bytes escritos
+int vmWriteFormat(VmOutput *out, const VmSegment *segments, uint32_t count, const Value *base) {
+    uint64_t start = out->written;
+    char buffer[512];
+    for (uint32_t i = 0; i < count; i++) {
+        const VmSegment *segment = &segments[i];
+        Value value = base[segment->reg];
+        int length;
+        switch (segment->kind) {
+            case SEG_TEXT:
+                vmWrite(out, segment->text, segment->length);
+                break;
+            case SEG_INT:
+                vmWriteInt(out, segment->type == IR_DOUBLE ? (int32_t)value.f : value.i);
+                break;
+            case SEG_CHAR: {
+                char c = (char)value.i;
+                vmWrite(out, &c, 1);
+                break;
+            }
+            case SEG_STRING:
+            case SEG_VALUE:
+                vmWriteValue(out, value, segment->type);
+                break;
+            case SEG_SPEC_INT:
+                length = snprintf(buffer, sizeof(buffer), segment->spec,
+                                  segment->type == IR_DOUBLE ? (int32_t)value.f : value.i);
+                vmWrite(out, buffer, length < (int)sizeof(buffer) ? length : (int)sizeof(buffer) - 1);
+                break;
+            case SEG_SPEC_DOUBLE:
+                length = snprintf(buffer, sizeof(buffer), segment->spec,
+                                  segment->type == IR_DOUBLE ? value.f : (double)value.i);
+                vmWrite(out, buffer, length < (int)sizeof(buffer) ? length : (int)sizeof(buffer) - 1);
+                break;
+            case SEG_SPEC_STRING:
+                length = snprintf(buffer, sizeof(buffer), segment->spec,
+                                  value.p ? ((VmString *)value.p)->data : "");
+                vmWrite(out, buffer, length < (int)sizeof(buffer) ? length : (int)sizeof(buffer) - 1);
+                break;
+        }
+    }
+    return (int)(out->written - start);
+}
+
+// ---------------------------------------------------------------------------
+// Formatos
+// ---------------------------------------------------------------------------
+
+// Função para acrescentar um segmento
+VmSegment *vmAddSegment(VmSegment **segments, uint32_t *count, uint32_t *capacity, uint8_t kind) {
+    *segments = vectorGrow(*segments, capacity, *count + 1, sizeof(VmSegment));
+    VmSegment *segment = &(*segments)[(*count)++];
+    memset(segment, 0, sizeof(*segment));
+    segment->kind = kind;
+    return segment;
+}
+
+// Função para acrescentar um segmento de texto literal
+void vmAddText(VmSegment **segments, uint32_t *count, uint32_t *capacity, const char *text, uint32_t length) {
+    if (length) {
+        VmSegment *segment = vmAddSegment(segments, count, capacity, SEG_TEXT);
+        segment->text = text;
+        segment->length = length;
+    }
+}
+
+// Função para analisar um formato do printf; cada conversão consome o próximo argumento
+void vmParsePrintf(VmSegment **segments, uint32_t *count, uint32_t *capacity, const char *text,
+                   uint32_t length, const uint32_t *regs, const uint8_t *types, uint32_t argc) {
+    uint32_t arg = 0, literal = 0, i = 0;
+    while (i < length) {
+        if (text[i] != '%') {
+            i++;
+            continue;
+        }
+        vmAddText(segments, count, capacity, text + literal, i - literal);
+        uint32_t start = i++;
+        if (i < length && text[i] == '%') {
+            vmAddText(segments, count, capacity, "%", 1);
+            literal = ++i;
+            continue;
+        }
+
+        // %[flags][largura][.precisão][tamanho]conversão
+        char spec[16];
+        uint32_t specLength = 0;
+        int plain = 1;
+        spec[specLength++] = '%';
+        while (i < length && strchr("-+ #0", text[i])) {
+            if (specLength < 12) spec[specLength++] = text[i];
+            i++;
+            plain = 0;
+        }
+        while (i < length && ((text[i] >= '0' && text[i] <= '9') || text[i] == '.')) {
+            if (specLength < 12) spec[specLength++] = text[i];
+            i++;
+            plain = 0;
+        }
+        while (i < length && strchr("hlLqjzt", text[i])) {
+            i++;
+        }
+        if (i >= length || arg >= argc) {
+            // Conversão incompleta ou sem argumento: o texto é mantido
+            literal = start;
+            i = i < length ? i + 1 : i;
+            continue;
+        }
+        char conversion = text[i++];
+        spec[specLength++] = conversion == 'i' ? 'd' : conversion;
+        spec[specLength] = '\0';
+        literal = i;
+
+        uint8_t kind;
+        uint8_t type = types[arg];
+        switch (conversion) {
+            case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
+                kind = plain && (conversion == 'd' || conversion == 'i') ? SEG_INT : SEG_SPEC_INT;
+                break;
+            case 'c':
+                kind = plain ? SEG_CHAR : SEG_SPEC_INT;
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                kind = SEG_SPEC_DOUBLE;
+                break;
+            case 's':
+                kind = type != IR_STRING ? SEG_VALUE : plain ? SEG_STRING : SEG_SPEC_STRING;
+                break;
+            default:
+                literal = start;
+                continue;
+        }
+        VmSegment *segment = vmAddSegment(segments, count, capacity, kind);
+        segment->type = type;
+        segment->reg = regs[arg++];
+        memcpy(segment->spec, spec, specLength + 1);
+    }
+    vmAddText(segments, count, capacity, text + literal, length - literal);
+}
+
+// Função para analisar um formato composto do C# ("{0} e {1}"); argumentos a partir de regs[1]
+void vmParseComposite(VmSegment **segments, uint32_t *count, uint32_t *capacity, const char *text,
+                      uint32_t length, const uint32_t *regs, const uint8_t *types, uint32_t argc) {
+    uint32_t literal = 0, i = 0;
+    while (i < length) {
+        if ((text[i] == '{' || text[i] == '}') && i + 1 < length && text[i + 1] == text[i]) {
+            vmAddText(segments, count, capacity, text + literal, i - literal + 1);
+            i += 2;
+            literal = i;
+            continue;
+        }
+        if (text[i] != '{') {
+            i++;
+            continue;
+        }
+        uint32_t j = i + 1, index = 0;
+        while (j < length && text[j] >= '0' && text[j] <= '9') {
+            index = index * 10 + (uint32_t)(text[j++] - '0');
+        }
+        uint32_t close = j;
+        while (close < length && text[close] != '}') {
+            close++;
+        }
+        if (j == i + 1 || close == length || index + 1 >= argc) {
+            i++;
+            continue;
+        }
+        vmAddText(segments, count, capacity, text + literal, i - literal);
+        VmSegment *segment = vmAddSegment(segments, count, capacity, SEG_VALUE);
+        segment->type = types[index + 1];
+        segment->reg = regs[index + 1];
+        i = literal = close + 1;
+    }
+    vmAddText(segments, count, capacity, text + literal, length - literal);
+}
+
+// ---------------------------------------------------------------------------
+// Compilação do código intermediário
+// ---------------------------------------------------------------------------
+
+// Estrutura do estado da compilação de uma função
+typedef struct {
+    VmProgram *program;
+    const IrModule *module;
+    const IrFunction *fn;
+    VmFunction *function;
+    uint32_t *labels;         // Rótulo -> instrução (OPT_NONE até ser emitido)
+    uint32_t *uses;           // Usos de cada registrador
+    uint32_t *definition;     // Instrução que define cada registrador (OPT_NONE para parâmetros)
+    uint32_t *constDef;       // Instrução IR_ICONST que define o registrador (OPT_NONE se não for constante)
+    uint32_t *emittedConst;   // Registrador -> instrução LOADK emitida
+    uint32_t labelAt;         // Posição do último rótulo emitido
+    uint32_t args[IR_MAX_ARGUMENTS];
+    uint32_t argCount;
+    uint32_t maxArgs;
+    uint32_t scratch;         // Registradores auxiliares após os virtuais
+} VmCompiler;
+
+// Função para exibir um erro de compilação
+void vmError(VmCompiler *c, const char *message) {
+    fprintf(stderr, "Erro na geração de bytecode (%.*s): %s\n", (int)c->fn->nameLength, c->fn->name, message);
+    c->program->errorCount++;
+}
+
+// Função para emitir uma instrução; devolve o índice
+uint32_t vmEmit(VmProgram *program, uint16_t op, uint32_t a, uint32_t b, uint32_t c) {
+    program->code = vectorGrow(program->code, &program->capacity, program->count + 1, sizeof(VmInstr));
+    VmInstr *instr = &program->code[program->count];
+    instr->handler = NULL;
+    instr->op = op;
+    instr->a = a;
+    instr->b = b;
+    instr->c = c;
+    return program->count++;
+}
+
+// Função para criar uma string constante do programa
+uint32_t vmAddString(VmProgram *program, const char *text, uint32_t length) {
+    VmString *string = optCalloc(1, sizeof(VmString) + length + 1);
+    string->length = length;
+    memcpy(string->data, text, length);
+    program->strings = vectorGrow(program->strings, &program->stringCapacity, program->stringCount + 1,
+                                  sizeof(VmString *));
+    program->strings[program->stringCount] = string;
+    return program->stringCount++;
+}
+
+// Função para criar um formato com os segmentos acrescentados a partir de 'first'
+uint32_t vmAddFormat(VmProgram *program, uint32_t first, int newline) {
+    program->formats = vectorGrow(program->formats, &program->formatCapacity, program->formatCount + 1,
+                                  sizeof(VmFormat));
+    VmFormat *format = &program->formats[program->formatCount];
+    format->first = first;
+    format->count = program->segmentCount - first;
+    format->newline = (uint8_t)newline;
+    return program->formatCount++;
+}
+
+// Função para obter o valor de um registrador constante (inteiro); devolve 0 se não for constante
+int vmConstant(const VmCompiler *c, VReg v, int32_t *value) {
+    if (v == 0 || c->constDef[v] == OPT_NONE) {
+        return 0;
+    }
+    *value = (int32_t)c->fn->code[c->constDef[v]].src1;
+    return 1;
+}
+
+// Função para obter o texto de um registrador definido por uma string constante
+const char *vmConstantString(const VmCompiler *c, VReg v) {
+    uint32_t def = c->definition[v];
+    if (def == OPT_NONE || c->fn->code[def].op != IR_SCONST) {
+        return NULL;
+    }
+    return irStringText(c->fn, c->fn->code[def].src1);
+}
+
+// Função que indica se um tipo é representado como inteiro
+int vmIsInteger(uint8_t type) {
+    return type == IR_INT || type == IR_CHAR || type == IR_BOOL;
+}
+
+// Tabelas de opcodes por operação do código intermediário (inteiro, double, string, referência)
+static const uint16_t vmArithmetic[][2] = {
+    [IR_ADD - IR_ADD] = {VM_ADD, VM_FADD}, [IR_SUB - IR_ADD] = {VM_SUB, VM_FSUB},
+    [IR_MUL - IR_ADD] = {VM_MUL, VM_FMUL}, [IR_DIV - IR_ADD] = {VM_DIV, VM_FDIV},
+    [IR_MOD - IR_ADD] = {VM_MOD, VM_FMOD}, [IR_NEG - IR_ADD] = {VM_NEG, VM_FNEG},
+};
+static const uint16_t vmCompare[][4] = {
+    [IR_LT - IR_LT] = {VM_LT, VM_FLT, 0, 0}, [IR_GT - IR_LT] = {VM_GT, VM_FGT, 0, 0},
+    [IR_LE - IR_LT] = {VM_LE, VM_FLE, 0, 0}, [IR_GE - IR_LT] = {VM_GE, VM_FGE, 0, 0},
+    [IR_EQ - IR_LT] = {VM_EQ, VM_FEQ, VM_SEQ, VM_PEQ}, [IR_NE - IR_LT] = {VM_NE, VM_FNE, VM_SNE, VM_PNE},
+};
+
+// Desvio que salta quando a comparação é verdadeira, indexado por IR_LT..IR_NE; negado e com constante
+static const uint16_t vmBranchTrue[6] = {VM_JLT, VM_JGT, VM_JLE, VM_JGE, VM_JEQ, VM_JNE};
+static const uint16_t vmBranchFalse[6] = {VM_JGE, VM_JLE, VM_JGT, VM_JLT, VM_JNE, VM_JEQ};
+// Comparação com os operandos trocados (k < x equivale a x > k)
+static const uint8_t vmSwapped[6] = {IR_GT, IR_LT, IR_GE, IR_LE, IR_EQ, IR_NE};
+
+// Função para obter o registrador de um operando, como string (TOSTR) quando necessário
+uint32_t vmStringOperand(VmCompiler *c, VReg v, uint32_t scratch) {
+    uint8_t type = c->fn->vregTypes[v];
+    if (type == IR_STRING) {
+        return v;
+    }
+    uint32_t reg = c->fn->vregCount + scratch;
+    vmEmit(c->program, VM_TOSTR, reg, v, type);
+    return reg;
+}
+
+// Função para compilar uma chamada de função da biblioteca
+void vmCompileBuiltin(VmCompiler *c, const IrInstr *instr) {
+    VmProgram *program = c->program;
+    const uint8_t *types = c->fn->vregTypes;
+    uint32_t argc = c->argCount;
+    const uint32_t *args = c->args;
+    uint8_t argTypes[IR_MAX_ARGUMENTS];
+    int isDouble = instr->type == IR_DOUBLE;
+
+    for (uint32_t i = 0; i < argc; i++) {
+        argTypes[i] = types[args[i]];
+    }
+    switch ((IrBuiltin)instr->src1) {
+        case BUILTIN_PRINTF: {
+            uint32_t first = program->segmentCount;
+            const char *text = argc ? vmConstantString(c, args[0]) : NULL;
+            if (argc && argTypes[0] == IR_STRING && text) {
+                // Formato constante: analisado agora, sobre uma cópia que pertence ao programa
+                const VmString *format = program->strings[vmAddString(program, text, (uint32_t)strlen(text))];
+                vmParsePrintf(&program->segments, &program->segmentCount, &program->segmentCapacity,
+                              format->data, format->length, args + 1, argTypes + 1, argc - 1);
+                vmEmit(program, VM_FORMAT, instr->dst, vmAddFormat(program, first, 0), 0);
+            } else {
+                // Formato variável: os argumentos ficam registrados e o formato é analisado na execução
+                for (uint32_t i = 0; i < argc; i++) {
+                    VmSegment *segment = vmAddSegment(&program->segments, &program->segmentCount,
+                                                      &program->segmentCapacity, SEG_VALUE);
+                    segment->reg = args[i];
+                    segment->type = argTypes[i];
+                }
+                vmEmit(program, VM_PRINTF, instr->dst, vmAddFormat(program, first, 0), 0);
+            }
+            break;
+        }
+        case BUILTIN_WRITE:
+        case BUILTIN_WRITELINE: {
+            uint32_t first = program->segmentCount;
+            const char *text = argc > 1 && argTypes[0] == IR_STRING ? vmConstantString(c, args[0]) : NULL;
+            if (text) {
+                const VmString *format = program->strings[vmAddString(program, text, (uint32_t)strlen(text))];
+                vmParseComposite(&program->segments, &program->segmentCount, &program->segmentCapacity,
+                                 format->data, format->length, args, argTypes, argc);
+            } else if (argc) {
+                if (argc > 1) {
+                    vmError(c, "formato composto não constante não suportado");
+                }
+                VmSegment *segment = vmAddSegment(&program->segments, &program->segmentCount,
+                                                  &program->segmentCapacity, SEG_VALUE);
+                segment->reg = args[0];
+                segment->type = argTypes[0];
+            }
+            vmEmit(program, VM_FORMAT, 0, vmAddFormat(program, first, instr->src1 == BUILTIN_WRITELINE), 0);
+            break;
+        }
+        case BUILTIN_SQRT:
+        case BUILTIN_ABS:
+            if (argc != 1) {
+                vmError(c, "número de argumentos inválido");
+                break;
+            }
+            vmEmit(program, instr->src1 == BUILTIN_SQRT ? VM_SQRT : isDouble ? VM_FABS : VM_ABS, instr->dst, args[0], 0);
+            break;
+        case BUILTIN_POW:
+        case BUILTIN_MAX:
+        case BUILTIN_MIN:
+            if (argc != 2) {
+                vmError(c, "número de argumentos inválido");
+                break;
+            }
+            vmEmit(program, instr->src1 == BUILTIN_POW ? VM_POW :
+                            instr->src1 == BUILTIN_MAX ? (isDouble ? VM_FMAX : VM_MAX) :
+                                                         (isDouble ? VM_FMIN : VM_MIN),
+                   instr->dst, args[0], args[1]);
+            break;
+        default:
+            vmError(c, "função da biblioteca não suportada");
+            break;
+    }
+}
+
+// Função para compilar uma instrução; devolve 1 se consumiu também a instrução seguinte
+int vmCompileInstr(VmCompiler *c, const IrInstr *instr, const IrInstr *next) {
+    VmProgram *program = c->program;
+    const uint8_t *types = c->fn->vregTypes;
+    int32_t k;
+
+    switch (instr->op) {
+        case IR_NOP:
+            return 0;
+        case IR_LABEL:
+            c->labels[instr->src1] = program->count;
+            c->labelAt = program->count;
+            return 0;
+        case IR_ICONST:
+            c->emittedConst[instr->dst] = vmEmit(program, VM_LOADK, instr->dst, instr->src1, 0);
+            return 0;
+        case IR_FCONST: {
+            uint64_t bits;
+            memcpy(&bits, &c->fn->floats[instr->src1], sizeof(bits));
+            vmEmit(program, VM_LOADF, instr->dst, (uint32_t)bits, (uint32_t)(bits >> 32));
+            return 0;
+        }
+        case IR_SCONST: {
+            const char *text = irStringText(c->fn, instr->src1);
+            vmEmit(program, VM_LOADS, instr->dst, vmAddString(program, text, c->fn->strings[instr->src1].length), 0);
+            return 0;
+        }
+        case IR_MOV:
+            vmEmit(program, VM_MOV, instr->dst, instr->src1, 0);
+            return 0;
+        case IR_ADD: case IR_SUB: case IR_MUL: case IR_DIV: case IR_MOD: case IR_NEG:
+            if (instr->type == IR_DOUBLE) {
+                vmEmit(program, vmArithmetic[instr->op - IR_ADD][1], instr->dst, instr->src1, instr->src2);
+            } else if ((instr->op == IR_ADD || instr->op == IR_SUB || instr->op == IR_MUL) && vmConstant(c, instr->src2, &k)) {
+                c->uses[instr->src2]--;
+                vmEmit(program, instr->op == IR_MUL ? VM_MULK : VM_ADDK, instr->dst, instr->src1,
+                       instr->op == IR_SUB ? 0u - (uint32_t)k : (uint32_t)k);
+                program->fused++;
+            } else if ((instr->op == IR_ADD || instr->op == IR_MUL) && vmConstant(c, instr->src1, &k)) {
+                c->uses[instr->src1]--;
+                vmEmit(program, instr->op == IR_MUL ? VM_MULK : VM_ADDK, instr->dst, instr->src2, (uint32_t)k);
+                program->fused++;
+            } else {
+                vmEmit(program, vmArithmetic[instr->op - IR_ADD][0], instr->dst, instr->src1, instr->src2);
+            }
+            return 0;
+        case IR_NOT:
+            vmEmit(program, VM_NOT, instr->dst, instr->src1, 0);
+            return 0;
+        case IR_LT: case IR_GT: case IR_LE: case IR_GE: case IR_EQ: case IR_NE: {
+            int index = instr->op - IR_LT;
+            if (vmIsInteger(instr->type) && next && (next->op == IR_JUMP_IF || next->op == IR_JUMP_IFNOT) &&
+                next->src1 == instr->dst && c->uses[instr->dst] == 1) {
+                // Comparação + desvio: salta direto pela condição (negada para jumpifnot)
+                VReg left = instr->src1, right = instr->src2;
+                if (!vmConstant(c, right, &k) && vmConstant(c, left, &k)) {
+                    index = vmSwapped[index] - IR_LT;
+                    left = instr->src2;
+                    right = instr->src1;
+                }
+                uint16_t op = next->op == IR_JUMP_IF ? vmBranchTrue[index] : vmBranchFalse[index];
+                if (vmConstant(c, right, &k)) {
+                    c->uses[right]--;
+                    vmEmit(program, op + (VM_JLTK - VM_JLT), left, (uint32_t)k, next->src2);
+                } else {
+                    vmEmit(program, op, left, right, next->src2);
+                }
+                program->fused++;
+                return 1;
+            }
+            int column = vmIsInteger(instr->type) ? 0 : instr->type == IR_DOUBLE ? 1 : instr->type == IR_STRING ? 2 : 3;
+            if (!vmCompare[index][column]) {
+                vmError(c, "comparação não suportada para o tipo");
+                return 0;
+            }
+            vmEmit(program, vmCompare[index][column], instr->dst, instr->src1, instr->src2);
+            return 0;
+        }
+        case IR_I2F:
+            vmEmit(program, VM_I2F, instr->dst, instr->src1, 0);
+            return 0;
+        case IR_F2I:
+            vmEmit(program, VM_F2I, instr->dst, instr->src1, 0);
+            return 0;
+        case IR_CONCAT: {
+            uint32_t left = vmStringOperand(c, instr->src1, 0);
+            uint32_t right = vmStringOperand(c, instr->src2, 1);
+            vmEmit(program, VM_CONCAT, instr->dst, left, right);
+            return 0;
+        }
+        case IR_LOAD_GLOBAL:
+            vmEmit(program, VM_GETG, instr->dst, instr->src1, 0);
+            return 0;
+        case IR_STORE_GLOBAL:
+            vmEmit(program, VM_SETG, instr->src2, instr->src1, 0);
+            return 0;
+        case IR_NEW_ARRAY:
+            vmEmit(program, VM_NEWARR, instr->dst, instr->src1, instr->type);
+            return 0;
+        case IR_LOAD_INDEX:
+            vmEmit(program, VM_GETIDX, instr->dst, instr->src1, instr->src2);
+            return 0;
+        case IR_STORE_INDEX:
+            vmEmit(program, VM_SETIDX, instr->dst, instr->src1, instr->src2);
+            return 0;
+        case IR_LENGTH:
+            vmEmit(program, types[instr->src1] == IR_STRING ? VM_LENS : VM_LENA, instr->dst, instr->src1, 0);
+            return 0;
+        case IR_ARG:
+            // Os argumentos são copiados (ou lidos diretamente) na chamada
+            c->args[c->argCount++] = instr->src1;
+            return 0;
+        case IR_CALL: {
+            uint32_t offset = c->function->callOffset;
+            for (uint32_t i = 0; i < c->argCount; i++) {
+                vmEmit(program, VM_MOV, offset + 1 + i, c->args[i], 0);
+            }
+            if (c->argCount > c->maxArgs) {
+                c->maxArgs = c->argCount;
+            }
+            vmEmit(program, VM_CALL, instr->dst, instr->src1, offset);
+            c->argCount = 0;
+            return 0;
+        }
+        case IR_CALL_BUILTIN:
+            vmCompileBuiltin(c, instr);
+            c->argCount = 0;
+            return 0;
+        case IR_RET:
+            vmEmit(program, VM_RET, instr->src1, 0, 0);
+            return 0;
+        case IR_JUMP: {
+            // Cópia + desvio (fim de laço após a saída da SSA)
+            VmInstr *last = program->count ? &program->code[program->count - 1] : NULL;
+            if (last && last->op == VM_MOV && c->labelAt != program->count && program->count > c->function->entry) {
+                last->op = VM_MOVJMP;
+                last->c = instr->src1;
+                program->fused++;
+            } else {
+                vmEmit(program, VM_JMP, instr->src1, 0, 0);
+            }
+            return 0;
+        }
+        case IR_JUMP_IF:
+            vmEmit(program, VM_JT, instr->src1, instr->src2, 0);
+            return 0;
+        case IR_JUMP_IFNOT:
+            vmEmit(program, VM_JF, instr->src1, instr->src2, 0);
+            return 0;
+        default:
+            vmError(c, "instrução não suportada (a função ainda está na forma SSA?)");
+            return 0;
+    }
+}
+
+// Função que indica em qual operando um opcode guarda o rótulo de destino (-1 se não desvia)
+int vmTargetOperand(uint16_t op) {
+    switch (op) {
+        case VM_JMP: return 0;
+        case VM_JT: case VM_JF: return 1;
+        case VM_MOVJMP: return 2;
+        default: return op >= VM_JLT && op <= VM_JNEK ? 2 : -1;
+    }
+}
+
+// Função para compilar uma função do código intermediário
+void vmCompileFunction(VmCompiler *c, uint32_t index) {
+    VmProgram *program = c->program;
+    const IrFunction *fn = &c->module->functions[index];
+    VmFunction *function = &program->functions[index];
+    uint32_t start = program->count;
+
+    c->fn = fn;
+    c->function = function;
+    c->labels = optCalloc(fn->labelCount, sizeof(uint32_t));
+    c->uses = optCalloc(fn->vregCount, sizeof(uint32_t));
+    c->definition = optDefinitions(fn);
+    c->constDef = optCalloc(fn->vregCount, sizeof(uint32_t));
+    c->emittedConst = optCalloc(fn->vregCount, sizeof(uint32_t));
+    c->labelAt = OPT_NONE;
+    c->argCount = 0;
+    c->maxArgs = 0;
+
+    // Usos e registradores com uma única definição constante inteira
+    uint8_t *defs = optCalloc(fn->vregCount, 1);
+    memset(c->constDef, 0xFF, fn->vregCount * sizeof(uint32_t));
+    memset(c->emittedConst, 0xFF, fn->vregCount * sizeof(uint32_t));
+    for (uint32_t i = 0; i < fn->count; i++) {
+        const IrInstr *instr = &fn->code[i];
+        VReg uses[3];
+        int count = irUses(instr, uses);
+        for (int k = 0; k < count; k++) {
+            c->uses[uses[k]]++;
+        }
+        VReg def = irDefinition(instr);
+        if (def && defs[def] < 2) {
+            defs[def]++;
+            c->constDef[def] = instr->op == IR_ICONST && vmIsInteger(instr->type) ? i : OPT_NONE;
+        }
+    }
+    for (VReg v = 1; v < fn->vregCount; v++) {
+        if (defs[v] != 1 || v <= fn->paramCount) {
+            c->constDef[v] = OPT_NONE;
+        }
+    }
+    free(defs);
+
+    function->name = fn->name;
+    function->nameLength = fn->nameLength;
+    function->entry = start;
+    function->paramCount = fn->paramCount;
+    function->returnType = fn->returnType;
+    function->callOffset = fn->vregCount + 2;  // Dois registradores auxiliares para CONCAT
+
+    for (uint32_t i = 0; i < fn->count; i++) {
+        i += vmCompileInstr(c, &fn->code[i], i + 1 < fn->count ? &fn->code[i + 1] : NULL);
+    }
+    if (program->count == start || program->code[program->count - 1].op != VM_RET) {
+        vmEmit(program, VM_RET, 0, 0, 0);
+    }
+    function->frameSize = function->callOffset + 1 + c->maxArgs;
+
+    // Remove as constantes que só eram usadas como imediatos e ajusta os desvios
+    uint32_t *position = optCalloc(program->count - start + 1, sizeof(uint32_t));
+    uint8_t *dead = optCalloc(program->count - start, 1);
+    for (VReg v = 1; v < fn->vregCount; v++) {
+        if (c->emittedConst[v] != OPT_NONE && c->uses[v] == 0) {
+            dead[c->emittedConst[v] - start] = 1;
+        }
+    }
+    uint32_t out = start;
+    for (uint32_t i = start; i < program->count; i++) {
+        position[i - start] = out;
+        if (!dead[i - start]) {
+            program->code[out++] = program->code[i];
+        }
+    }
+    position[program->count - start] = out;
+    program->count = out;
+    for (uint32_t i = start; i < program->count; i++) {
+        VmInstr *instr = &program->code[i];
+        uint32_t *target = NULL;
+        switch (vmTargetOperand(instr->op)) {
+            case 0: target = &instr->a; break;
+            case 1: target = &instr->b; break;
+            case 2: target = &instr->c; break;
+            default: break;
+        }
+        if (target) {
+            *target = position[c->labels[*target] - start];
+        }
+    }
+    function->end = program->count;
+
+    free(position);
+    free(dead);
+    free(c->labels);
+    free(c->uses);
+    free(c->definition);
+    free(c->constDef);
+    free(c->emittedConst);
+}
+
+// Função para compilar o módulo (já fora da forma SSA); devolve o número de erros
+int vmCompile(VmProgram *program, const IrModule *module) {
+    VmCompiler compiler;
+    memset(program, 0, sizeof(*program));
+    memset(&compiler, 0, sizeof(compiler));
+    compiler.program = program;
+    compiler.module = module;
+
+    program->functionCount = module->functionCount;
+    program->functions = optCalloc(module->functionCount, sizeof(VmFunction));
+    program->globalCount = module->globalCount;
+    program->entry = module->entry;
+    for (uint32_t i = 0; i < module->functionCount; i++) {
+        vmCompileFunction(&compiler, i);
+    }
+    return program->errorCount;
+}
+
+// Função para liberar o programa
+void vmProgramFree(VmProgram *program) {
+    for (uint32_t i = 0; i < program->stringCount; i++) {
+        free(program->strings[i]);
+    }
+    free(program->strings);
+    free(program->code);
+    free(program->functions);
+    free(program->segments);
+    free(program->formats);
+    memset(program, 0, sizeof(*program));
+}
+
+// Função para exibir o bytecode
+void vmPrintProgram(FILE *out, const VmProgram *program) {
+    for (uint32_t f = 0; f < program->functionCount; f++) {
+        const VmFunction *function = &program->functions[f];
+        fprintf(out, "\nfunção %.*s  [%u instruções, quadro de %u registradores]\n", (int)function->nameLength,
+                function->name, function->end - function->entry, function->frameSize);
+        for (uint32_t i = function->entry; i < function->end; i++) {
+            const VmInstr *instr = &program->code[i];
+            fprintf(out, "%6u  %-8s %u, %u, %u\n", i, vmOpcodeNames[instr->op], instr->a, instr->b, instr->c);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Execução
+// ---------------------------------------------------------------------------
+
+// Função para alocar um objeto da execução (liberado em vmFree)
+void *vmAllocate(Vm *vm, size_t size) {
+    VmObject *object = optCalloc(1, size);
+    object->next = vm->heap;
+    vm->heap = object;
+    vm->heapBytes += size;
+    return object;
+}
+
+// Função para criar uma string a partir de um valor
+VmString *vmToString(Vm *vm, Value value, uint8_t type) {
+    VmOutput *out = &vm->out;
+    // Reaproveita o fim do buffer de saída como área temporária
+    if (out->length + 512 > VM_OUTPUT_BUFFER) {
+        vmFlush(out);
+    }
+    size_t mark = out->length;
+    uint64_t written = out->written;
+    vmWriteValue(out, value, type);
+    uint32_t length = (uint32_t)(out->length - mark);
+    VmString *string = vmAllocate(vm, sizeof(VmString) + length + 1);
+    string->length = length;
+    memcpy(string->data, out->buffer + mark, length);
+    out->length = mark;
+    out->written = written;
+    return string;
+}
+
+// Função para inicializar a máquina virtual
+void vmInit(Vm *vm, const VmProgram *program, FILE *output) {
+    memset(vm, 0, offsetof(Vm, out));
+    vm->program = program;
+    vm->stack = optCalloc(VM_STACK_VALUES, sizeof(Value));
+    vm->frames = optCalloc(VM_MAX_FRAMES, sizeof(VmFrame));
+    vm->globals = optCalloc(program->globalCount, sizeof(Value));
+    vm->out.file = output;
+    vm->out.length = 0;
+    vm->out.written = 0;
+}
+
+// Função para liberar a máquina virtual e os objetos alocados
+void vmFree(Vm *vm) {
+    vmFlush(&vm->out);
+    while (vm->heap) {
+        VmObject *next = vm->heap->next;
+        free(vm->heap);
+        vm->heap = next;
+    }
+    free(vm->stack);
+    free(vm->frames);
+    free(vm->globals);
+    free(vm->scratch);
+}
+
+// Função para localizar a função que contém uma instrução
+const VmFunction *vmFunctionAt(const VmProgram *program, uint32_t index) {
+    for (uint32_t f = 0; f < program->functionCount; f++) {
+        if (index >= program->functions[f].entry && index < program->functions[f].end) {
+            return &program->functions[f];
+        }
+    }
+    return NULL;
+}
+
+// Macros do laço de despacho
+#define R(x) base[x]
+#if VM_THREADED
+#define VM_CASE(name) vm_##name:
+#define VM_DISPATCH() goto *ip->handler
+#define VM_LABEL(name, text) [VM_##name] = &&vm_##name,
+#define VM_COUNT_LABEL(name, text) [VM_##name] = &&count_##name,
+#define VM_COUNTER(name, text) count_##name: vm->counts[VM_##name]++; goto vm_##name;
+#else
+#define VM_CASE(name) case VM_##name:
+#define VM_DISPATCH() goto dispatch
+#endif
+#define VM_NEXT() do { ip++; VM_DISPATCH(); } while (0)
+#define VM_FAIL(message) do { failure = message; goto fail; } while (0)
+
+// Função para executar a função 'function' até o retorno; devolve 0 ou -1 em erro de execução
+int vmExecute(Vm *vm, uint32_t function) {
+    const VmProgram *program = vm->program;
+    VmInstr *code = program->code;
+    const VmFunction *functions = program->functions;
+    Value *base = vm->stack;
+    Value *stackEnd = vm->stack + VM_STACK_VALUES;
+    VmFrame *frame = vm->frames;
+    VmFrame *frameEnd = vm->frames + VM_MAX_FRAMES;
+    Value *globals = vm->globals;
+    const char *failure = NULL;
+
+#if VM_THREADED
+    static const void *const handlers[VM_OPCODE_COUNT] = {VM_OPCODES(VM_LABEL)};
+    static const void *const counters[VM_OPCODE_COUNT] = {VM_OPCODES(VM_COUNT_LABEL)};
+    int threading = vm->counting ? 2 : 1;
+    if (program->threading != threading) {
+        // "Enfia" o código: cada instrução passa a apontar para o seu tratador
+        const void *const *table = vm->counting ? counters : handlers;
+        for (uint32_t i = 0; i < program->count; i++) {
+            code[i].handler = table[code[i].op];
+        }
+        ((VmProgram *)program)->threading = threading;
+    }
+#endif
+
+    const VmInstr *ip = code + functions[function].entry;
+    VM_DISPATCH();
+
+#if VM_THREADED
+    VM_OPCODES(VM_COUNTER)
+#else
+dispatch:
+    if (vm->counting) {
+        vm->counts[ip->op]++;
+    }
+    switch (ip->op) {
+#endif
+
+    VM_CASE(LOADK) R(ip->a).bits = (int32_t)ip->b; VM_NEXT();
+    VM_CASE(LOADF) R(ip->a).bits = (int64_t)((uint64_t)ip->c << 32 | ip->b); VM_NEXT();
+    VM_CASE(LOADS) R(ip->a).p = program->strings[ip->b]; VM_NEXT();
+    VM_CASE(MOV) R(ip->a) = R(ip->b); VM_NEXT();
+
+    VM_CASE(ADD) R(ip->a).i = (int32_t)((uint32_t)R(ip->b).i + (uint32_t)R(ip->c).i); VM_NEXT();
+    VM_CASE(SUB) R(ip->a).i = (int32_t)((uint32_t)R(ip->b).i - (uint32_t)R(ip->c).i); VM_NEXT();
+    VM_CASE(MUL) R(ip->a).i = (int32_t)((uint32_t)R(ip->b).i * (uint32_t)R(ip->c).i); VM_NEXT();
+    VM_CASE(DIV) {
+        int32_t divisor = R(ip->c).i;
+        if (divisor == 0) VM_FAIL("divisão por zero");
+        if (divisor == -1 && R(ip->b).i == INT32_MIN) VM_FAIL("transbordamento aritmético");
+        R(ip->a).i = R(ip->b).i / divisor;
+        VM_NEXT();
+    }
+    VM_CASE(MOD) {
+        int32_t divisor = R(ip->c).i;
+        if (divisor == 0) VM_FAIL("divisão por zero");
+        if (divisor == -1 && R(ip->b).i == INT32_MIN) VM_FAIL("transbordamento aritmético");
+        R(ip->a).i = R(ip->b).i % divisor;
+        VM_NEXT();
+    }
+    VM_CASE(NEG) R(ip->a).i = (int32_t)(0u - (uint32_t)R(ip->b).i); VM_NEXT();
+    VM_CASE(ADDK) R(ip->a).i = (int32_t)((uint32_t)R(ip->b).i + ip->c); VM_NEXT();
+    VM_CASE(MULK) R(ip->a).i = (int32_t)((uint32_t)R(ip->b).i * ip->c); VM_NEXT();
+
+    VM_CASE(FADD) R(ip->a).f = R(ip->b).f + R(ip->c).f; VM_NEXT();
+    VM_CASE(FSUB) R(ip->a).f = R(ip->b).f - R(ip->c).f; VM_NEXT();
+    VM_CASE(FMUL) R(ip->a).f = R(ip->b).f * R(ip->c).f; VM_NEXT();
+    VM_CASE(FDIV) R(ip->a).f = R(ip->b).f / R(ip->c).f; VM_NEXT();
+    VM_CASE(FMOD) R(ip->a).f = fmod(R(ip->b).f, R(ip->c).f); VM_NEXT();
+    VM_CASE(FNEG) R(ip->a).f = -R(ip->b).f; VM_NEXT();
+    VM_CASE(NOT) R(ip->a).i = !R(ip->b).i; VM_NEXT();
+
+    VM_CASE(LT) R(ip->a).i = R(ip->b).i < R(ip->c).i; VM_NEXT();
+    VM_CASE(LE) R(ip->a).i = R(ip->b).i <= R(ip->c).i; VM_NEXT();
+    VM_CASE(GT) R(ip->a).i = R(ip->b).i > R(ip->c).i; VM_NEXT();
+    VM_CASE(GE) R(ip->a).i = R(ip->b).i >= R(ip->c).i; VM_NEXT();
+    VM_CASE(EQ) R(ip->a).i = R(ip->b).i == R(ip->c).i; VM_NEXT();
+    VM_CASE(NE) R(ip->a).i = R(ip->b).i != R(ip->c).i; VM_NEXT();
+    VM_CASE(FLT) R(ip->a).i = R(ip->b).f < R(ip->c).f; VM_NEXT();
+    VM_CASE(FLE) R(ip->a).i = R(ip->b).f <= R(ip->c).f; VM_NEXT();
+    VM_CASE(FGT) R(ip->a).i = R(ip->b).f > R(ip->c).f; VM_NEXT();
+    VM_CASE(FGE) R(ip->a).i = R(ip->b).f >= R(ip->c).f; VM_NEXT();
+    VM_CASE(FEQ) R(ip->a).i = R(ip->b).f == R(ip->c).f; VM_NEXT();
+    VM_CASE(FNE) R(ip->a).i = R(ip->b).f != R(ip->c).f; VM_NEXT();
+    VM_CASE(SEQ)
+    VM_CASE(SNE) {
+        const VmString *left = R(ip->b).p, *right = R(ip->c).p;
+        int equal = left == right || (left && right && left->length == right->length &&
+                                      memcmp(left->data, right->data, left->length) == 0);
+        R(ip->a).i = ip->op == VM_SEQ ? equal : !equal;
+        VM_NEXT();
+    }
+    VM_CASE(PEQ) R(ip->a).i = R(ip->b).p == R(ip->c).p; VM_NEXT();
+    VM_CASE(PNE) R(ip->a).i = R(ip->b).p != R(ip->c).p; VM_NEXT();
+
+    VM_CASE(I2F) R(ip->a).f = (double)R(ip->b).i; VM_NEXT();
+    VM_CASE(F2I) {
+        double value = R(ip->b).f;
+        R(ip->a).i = value > -2147483649.0 && value < 2147483648.0 ? (int32_t)value : INT32_MIN;
+        VM_NEXT();
+    }
+    VM_CASE(TOSTR) R(ip->a).p = vmToString(vm, R(ip->b), (uint8_t)ip->c); VM_NEXT();
+    VM_CASE(CONCAT) {
+        const VmString *left = R(ip->b).p, *right = R(ip->c).p;
+        uint32_t leftLength = left ? left->length : 0, rightLength = right ? right->length : 0;
+        VmString *result = vmAllocate(vm, sizeof(VmString) + leftLength + rightLength + 1);
+        result->length = leftLength + rightLength;
+        if (leftLength) memcpy(result->data, left->data, leftLength);
+        if (rightLength) memcpy(result->data + leftLength, right->data, rightLength);
+        R(ip->a).p = result;
+        VM_NEXT();
+    }
+
+    VM_CASE(GETG) R(ip->a) = globals[ip->b]; VM_NEXT();
+    VM_CASE(SETG) globals[ip->b] = R(ip->a); VM_NEXT();
+
+    VM_CASE(NEWARR) {
+        int32_t length = R(ip->b).i;
+        if (length < 0) VM_FAIL("tamanho de vetor negativo");
+        VmArray *array = vmAllocate(vm, sizeof(VmArray) + (size_t)length * sizeof(Value));
+        array->length = (uint32_t)length;
+        array->type = (uint8_t)ip->c;
+        R(ip->a).p = array;
+        VM_NEXT();
+    }
+    VM_CASE(GETIDX) {
+        const VmArray *array = R(ip->b).p;
+        if (!array) VM_FAIL("referência nula");
+        if ((uint32_t)R(ip->c).i >= array->length) VM_FAIL("índice fora dos limites do vetor");
+        R(ip->a) = array->items[R(ip->c).i];
+        VM_NEXT();
+    }
+    VM_CASE(SETIDX) {
+        VmArray *array = R(ip->b).p;
+        if (!array) VM_FAIL("referência nula");
+        if ((uint32_t)R(ip->c).i >= array->length) VM_FAIL("índice fora dos limites do vetor");
+        array->items[R(ip->c).i] = R(ip->a);
+        VM_NEXT();
+    }
+    VM_CASE(LENA) {
+        if (!R(ip->b).p) VM_FAIL("referência nula");
+        R(ip->a).i = (int32_t)((const VmArray *)R(ip->b).p)->length;
+        VM_NEXT();
+    }
+    VM_CASE(LENS) {
+        if (!R(ip->b).p) VM_FAIL("referência nula");
+        R(ip->a).i = (int32_t)((const VmString *)R(ip->b).p)->length;
+        VM_NEXT();
+    }
+
+    VM_CASE(JMP) ip = code + ip->a; VM_DISPATCH();
+    VM_CASE(JT) ip = R(ip->a).i ? code + ip->b : ip + 1; VM_DISPATCH();
+    VM_CASE(JF) ip = R(ip->a).i ? ip + 1 : code + ip->b; VM_DISPATCH();
+    VM_CASE(JLT) ip = R(ip->a).i < R(ip->b).i ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(JLE) ip = R(ip->a).i <= R(ip->b).i ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(JGT) ip = R(ip->a).i > R(ip->b).i ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(JGE) ip = R(ip->a).i >= R(ip->b).i ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(JEQ) ip = R(ip->a).i == R(ip->b).i ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(JNE) ip = R(ip->a).i != R(ip->b).i ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(JLTK) ip = R(ip->a).i < (int32_t)ip->b ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(JLEK) ip = R(ip->a).i <= (int32_t)ip->b ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(JGTK) ip = R(ip->a).i > (int32_t)ip->b ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(JGEK) ip = R(ip->a).i >= (int32_t)ip->b ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(JEQK) ip = R(ip->a).i == (int32_t)ip->b ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(JNEK) ip = R(ip->a).i != (int32_t)ip->b ? code + ip->c : ip + 1; VM_DISPATCH();
+    VM_CASE(MOVJMP) R(ip->a) = R(ip->b); ip = code + ip->c; VM_DISPATCH();
+
+    VM_CASE(CALL) {
+        const VmFunction *callee = &functions[ip->b];
+        Value *next = base + ip->c;
+        if (frame + 1 >= frameEnd || next + callee->frameSize > stackEnd) VM_FAIL("estouro da pilha");
+        frame->ret = ip + 1;
+        frame->base = base;
+        frame->dst = ip->a;
+        frame++;
+        base = next;
+        ip = code + callee->entry;
+        VM_DISPATCH();
+    }
+    VM_CASE(RET) {
+        Value result = R(ip->a);
+        if (frame == vm->frames) {
+            vm->result = result;
+            return 0;
+        }
+        frame--;
+        base = frame->base;
+        ip = frame->ret;
+        R(frame->dst) = result;  // dst 0 (chamada void) cai no registrador 0, sem uso
+        VM_DISPATCH();
+    }
+
+    VM_CASE(SQRT) R(ip->a).f = sqrt(R(ip->b).f); VM_NEXT();
+    VM_CASE(POW) R(ip->a).f = pow(R(ip->b).f, R(ip->c).f); VM_NEXT();
+    VM_CASE(ABS) R(ip->a).i = R(ip->b).i < 0 ? (int32_t)(0u - (uint32_t)R(ip->b).i) : R(ip->b).i; VM_NEXT();
+    VM_CASE(FABS) R(ip->a).f = fabs(R(ip->b).f); VM_NEXT();
+    VM_CASE(MAX) R(ip->a).i = R(ip->b).i > R(ip->c).i ? R(ip->b).i : R(ip->c).i; VM_NEXT();
+    VM_CASE(MIN) R(ip->a).i = R(ip->b).i < R(ip->c).i ? R(ip->b).i : R(ip->c).i; VM_NEXT();
+    VM_CASE(FMAX) R(ip->a).f = fmax(R(ip->b).f, R(ip->c).f); VM_NEXT();
+    VM_CASE(FMIN) R(ip->a).f = fmin(R(ip->b).f, R(ip->c).f); VM_NEXT();
+
+    VM_CASE(FORMAT) {
+        const VmFormat *format = &program->formats[ip->b];
+        int written = vmWriteFormat(&vm->out, program->segments + format->first, format->count, base);
+        if (format->newline) {
+            vmWrite(&vm->out, "\n", 1);
+        }
+        R(ip->a).i = written;
+        VM_NEXT();
+    }
+    VM_CASE(PRINTF) {
+        // Formato variável: analisado a cada execução
+        const VmFormat *format = &program->formats[ip->b];
+        const VmSegment *args = program->segments + format->first;
+        uint32_t regs[IR_MAX_ARGUMENTS];
+        uint8_t types[IR_MAX_ARGUMENTS];
+        const VmString *text = R(args[0].reg).p;
+        for (uint32_t i = 1; i < format->count; i++) {
+            regs[i - 1] = args[i].reg;
+            types[i - 1] = args[i].type;
+        }
+        vm->scratchCount = 0;
+        if (text) {
+            vmParsePrintf(&vm->scratch, &vm->scratchCount, &vm->scratchCapacity, text->data, text->length,
+                          regs, types, format->count - 1);
+        }
+        R(ip->a).i = vmWriteFormat(&vm->out, vm->scratch, vm->scratchCount, base);
+        VM_NEXT();
+    }
+
+#if !VM_THREADED
+    default:
+        VM_FAIL("opcode inválido");
+    }
+#endif
+
+fail: {
+        const VmFunction *where = vmFunctionAt(program, (uint32_t)(ip - code));
+        snprintf(vm->error, sizeof(vm->error), "Erro em tempo de execução em '%.*s': %s",
+                 where ? (int)where->nameLength : 1, where ? where->name : "?", failure);
+        return -1;
+    }
+}
+
+#undef R
+
+// Função para executar o programa: inicialização dos campos e Main; devolve 0 ou -1 em erro
+int vmRun(Vm *vm) {
+    const VmProgram *program = vm->program;
+    if (program->entry < 0) {
+        snprintf(vm->error, sizeof(vm->error), "Erro: o programa não tem um método Main");
+        return -1;
+    }
+    // O registrador 1 de Main(string[] args) fica nulo
+    memset(vm->stack, 0, (program->functions[program->entry].frameSize + 1) * sizeof(Value));
+    if (program->functionCount && vmExecute(vm, 0) != 0) {
+        vmFlush(&vm->out);
+        return -1;
+    }
+    memset(vm->stack, 0, (program->functions[program->entry].frameSize + 1) * sizeof(Value));
+    int status = vmExecute(vm, (uint32_t)program->entry);
+    vmFlush(&vm->out);
+    return status;
+}
+
+#endif
@@ -0,0 +1,285 @@
+/*
+ * Memória para blocos grandes (páginas grandes e NUMA)
+ *
+ * As listas de tokens, os índices paralelos e as arenas de arquivos grandes
+ * chegam a centenas de MB, e com páginas de 4 KB cada acesso a um trecho
+ * novo custa uma falha de TLB. Este módulo entrega esses blocos em páginas
+ * de 2 MB:
+ * - HUGE_PAGES_TRANSPARENT (padrão): mapeamento alinhado em 2 MB com
+ *   madvise(MADV_HUGEPAGE), então o kernel usa páginas grandes
+ *   transparentes mesmo com /sys/kernel/mm/transparent_hugepage/enabled em
+ *   "madvise"
+ * - HUGE_PAGES_EXPLICIT: MAP_HUGETLB (páginas reservadas em
+ *   /proc/sys/vm/nr_hugepages); sem páginas reservadas, cai para as
+ *   transparentes e conta a falha em bigHugetlbFallbacks
+ * - HUGE_PAGES_NONE: malloc/realloc, como antes
+ *
+ * Blocos menores que BIG_ALLOC_THRESHOLD continuam no malloc. Um bloco
+ * mapeado cresce reservando a nova área alinhada e movendo as páginas já
+ * usadas para o seu início com mremap, sem copiar os dados.
+ *
+ * NUMA: com mais de um nó, cada bloco mapeado recebe a política
+ * MPOL_PREFERRED do nó onde a thread que o aloca está rodando (getcpu).
+ * Como cada thread de análise cresce a sua própria lista de tokens, as
+ * listas das threads ficam no nó de cada uma.
+ *
+ * Estruturas principais:
+ * - BigHeader: cabeçalho antes de cada bloco com o tamanho, a reserva e a
+ *   origem (malloc, mapeado, hugetlb), de modo que bigFree não precisa do
+ *   tamanho
+ * - bigAdvise: só o madvise e a política NUMA, para buffers que continuam
+ *   vindo do malloc e são liberados com free() (o código fonte lido)
+ * - tlbCounterOpen/tlbCounterStop: contadores do perf_event_open (falhas
+ *   de leitura no dTLB e falhas de página) para medir o efeito
+ *
+ * Limitações:
+ * - Os blocos de bigAlloc/bigRealloc só podem ser liberados com bigFree
+ * - Com HUGE_PAGES_EXPLICIT o crescimento copia os dados (mremap de
+ *   hugetlb não é garantido)
+ */
+
+#ifndef MEMORIA_GRANDE_H
+#define MEMORIA_GRANDE_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+#include <linux/perf_event.h>
+
+#define BIG_PAGE_SIZE ((size_t)2 << 20)
+#define BIG_ALLOC_THRESHOLD (2 * BIG_PAGE_SIZE)
+#define BIG_HEADER_SIZE 32
+#define BIG_MAX_NODES 1024
+#define BIG_MREMAP_MAYMOVE 1      // MREMAP_MAYMOVE e MREMAP_FIXED (sys/mman.h só os declara com _GNU_SOURCE)
+#define BIG_MREMAP_FIXED 2
+
+// Tipos de página para os blocos grandes
+typedef enum {
+    HUGE_PAGES_NONE,
+    HUGE_PAGES_TRANSPARENT,
+    HUGE_PAGES_EXPLICIT
+} HugePageMode;
+
+// Origem de um bloco
+enum {
+    BIG_BLOCK_HEAP,
+    BIG_BLOCK_MAPPED,
+    BIG_BLOCK_HUGETLB
+};
+
+// Estrutura do cabeçalho de um bloco (BIG_HEADER_SIZE bytes antes dos dados)
+typedef struct {
+    size_t size;               // Bytes em uso, com o cabeçalho
+    size_t length;             // Bytes reservados, com o cabeçalho
+    int kind;
+} BigHeader;
+
+// Configuração (antes da primeira alocação) e estatísticas
+HugePageMode hugePageMode = HUGE_PAGES_TRANSPARENT;
+atomic_long bigHugetlbFallbacks;
+static int bigNodeCount = 1;
+static pthread_once_t bigMemoryOnce = PTHREAD_ONCE_INIT;
+
+// Função para converter o nome de um modo ("nenhuma", "transparentes", "explicitas"); devolve 0 ou -1
+int hugePageModeParse(const char *name, HugePageMode *mode) {
+    static const char *names[] = {"nenhuma", "transparentes", "explicitas"};
+    for (int i = 0; i < 3; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *mode = (HugePageMode)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Função para obter o nome de um modo
+const char *hugePageModeName(HugePageMode mode) {
+    return mode == HUGE_PAGES_NONE ? "nenhuma" : mode == HUGE_PAGES_TRANSPARENT ? "transparentes" : "explícitas";
+}
+
+// Função para contar os nós NUMA possíveis ("0" ou "0-3" em /sys)
+static void bigMemoryInit(void) {
+    FILE *file = fopen("/sys/devices/system/node/possible", "r");
+    char text[64] = {0};
+    if (file) {
+        if (fgets(text, sizeof(text), file)) {
+            const char *last = strrchr(text, '-');
+            int nodes = atoi(last ? last + 1 : text) + 1;
+            bigNodeCount = nodes > 1 && nodes <= BIG_MAX_NODES ? nodes : 1;
+        }
+        fclose(file);
+    }
+}
+
+// Função para preferir o nó NUMA da thread atual para as páginas de [address, address + length)
+static void bigPlace(void *address, size_t length) {
+    pthread_once(&bigMemoryOnce, bigMemoryInit);
+    unsigned cpu, node;
+    if (bigNodeCount <= 1 || syscall(SYS_getcpu, &cpu, &node, NULL) != 0 || node >= BIG_MAX_NODES) {
+        return;
+    }
+    unsigned long mask[BIG_MAX_NODES / (8 * sizeof(unsigned long))] = {0};
+    mask[node / (8 * sizeof(unsigned long))] = 1ul << (node % (8 * sizeof(unsigned long)));
+    syscall(SYS_mbind, address, length, MPOL_PREFERRED, mask, (unsigned long)BIG_MAX_NODES, 0);   // Só uma preferência: falhar não é erro
+}
+
+// Função para pedir páginas grandes e o nó local para a parte alinhada de um buffer do malloc
+void bigAdvise(void *address, size_t length) {
+    uintptr_t start = ((uintptr_t)address + BIG_PAGE_SIZE - 1) & ~(uintptr_t)(BIG_PAGE_SIZE - 1);
+    uintptr_t end = ((uintptr_t)address + length) & ~(uintptr_t)(BIG_PAGE_SIZE - 1);
+    if (hugePageMode == HUGE_PAGES_NONE || end <= start) {
+        return;
+    }
+    madvise((void *)start, end - start, MADV_HUGEPAGE);
+    bigPlace((void *)start, end - start);
+}
+
+// Função para mapear 'length' bytes (múltiplo de BIG_PAGE_SIZE) alinhados em 2 MB; devolve NULL se falhar
+static char *bigMap(size_t length, int *kind) {
+    if (hugePageMode == HUGE_PAGES_EXPLICIT) {
+        void *pages = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (pages != MAP_FAILED) {
+            *kind = BIG_BLOCK_HUGETLB;
+            bigPlace(pages, length);
+            return pages;
+        }
+        atomic_fetch_add_explicit(&bigHugetlbFallbacks, 1, memory_order_relaxed);
+    }
+
+    // Reserva 2 MB a mais e corta as pontas para alinhar o início
+    char *area = mmap(NULL, length + BIG_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED) {
+        return NULL;
+    }
+    char *pages = (char *)(((uintptr_t)area + BIG_PAGE_SIZE - 1) & ~(uintptr_t)(BIG_PAGE_SIZE - 1));
+    if (pages > area) {
+        munmap(area, pages - area);
+    }
+    if (area + BIG_PAGE_SIZE > pages) {
+        munmap(pages + length, (area + BIG_PAGE_SIZE) - pages);
+    }
+    if (hugePageMode != HUGE_PAGES_NONE) {
+        madvise(pages, length, MADV_HUGEPAGE);
+    }
+    bigPlace(pages, length);
+    *kind = BIG_BLOCK_MAPPED;
+    return pages;
+}
+
+// Função para redimensionar um bloco (NULL = novo bloco); devolve NULL se faltar memória (o bloco antigo continua válido)
+void *bigRealloc(void *block, size_t size) {
+    BigHeader *header = block ? (BigHeader *)((char *)block - BIG_HEADER_SIZE) : NULL;
+    size_t total = size + BIG_HEADER_SIZE;
+
+    // Blocos pequenos (ou sem páginas grandes) ficam no malloc
+    if ((!header || header->kind == BIG_BLOCK_HEAP) &&
+        (hugePageMode == HUGE_PAGES_NONE || total < BIG_ALLOC_THRESHOLD)) {
+        header = realloc(header, total);
+        if (!header) {
+            return NULL;
+        }
+        header->size = header->length = total;
+        header->kind = BIG_BLOCK_HEAP;
+        return (char *)header + BIG_HEADER_SIZE;
+    }
+    if (header && header->kind != BIG_BLOCK_HEAP && total <= header->length) {
+        header->size = total;
+        return block;
+    }
+
+    size_t length = (total + BIG_PAGE_SIZE - 1) & ~(BIG_PAGE_SIZE - 1);
+    int kind;
+    char *pages = bigMap(length, &kind);
+    if (!pages) {
+        return NULL;
+    }
+    if (header) {
+        // Um bloco mapeado muda de lugar sem cópia: as suas páginas passam para o início da área nova
+        int moved = header->kind == BIG_BLOCK_MAPPED && kind == BIG_BLOCK_MAPPED &&
+                    (void *)syscall(SYS_mremap, header, header->length, header->length,
+                                    BIG_MREMAP_MAYMOVE | BIG_MREMAP_FIXED, pages) != MAP_FAILED;
+        if (!moved) {
+            memcpy(pages, header, header->size < total ? header->size : total);
+            if (header->kind == BIG_BLOCK_HEAP) {
+                free(header);
+            } else {
+                munmap(header, header->length);
+            }
+        }
+    }
+    header = (BigHeader *)pages;
+    header->size = total;
+    header->length = length;
+    header->kind = kind;
+    return pages + BIG_HEADER_SIZE;
+}
+
+// Função para alocar um bloco de 'size' bytes (não zerado); devolve NULL se faltar memória
+void *bigAlloc(size_t size) {
+    return bigRealloc(NULL, size);
+}
+
+// Função para liberar um bloco de bigAlloc/bigRealloc
+void bigFree(void *block) {
+    if (!block) {
+        return;
+    }
+    BigHeader *header = (BigHeader *)((char *)block - BIG_HEADER_SIZE);
+    if (header->kind == BIG_BLOCK_HEAP) {
+        free(header);
+    } else {
+        munmap(header, header->length);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Contadores de TLB
+// ---------------------------------------------------------------------------
+
+// Função para abrir um contador da thread atual ('tlb' = falhas de leitura no dTLB, senão falhas de página)
+// Devolve o descritor ou -1 (sem PMU ou sem permissão em perf_event_paranoid)
+int tlbCounterOpen(int tlb) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    if (tlb) {
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    } else {
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+    }
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+// Função para zerar e ligar um contador
+void tlbCounterStart(int counter) {
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+// Função para desligar um contador; devolve a contagem (UINT64_MAX se o contador não existe)
+uint64_t tlbCounterStop(int counter) {
+    uint64_t value;
+    if (counter < 0) {
+        return UINT64_MAX;
+    }
+    ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+    return read(counter, &value, sizeof(value)) == sizeof(value) ? value : UINT64_MAX;
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * Programa do otimizador
+ *
+ * Lê o arquivo de entrada, executa as análises, gera o código
+ * intermediário e aplica os passos de otimização (otimizacao.h), exibindo
+ * o tempo e o número de instruções antes e depois de cada passo.
+ *
+ * Opções:
+ * - --codigo: exibe também o código otimizado
+ * - --ssa: mantém o resultado na forma SSA (com phi), sem o passo de saída
+ */
+
+#include "otimizacao.h"
+
+// Função principal
+int main(int argc, char *argv[]) {
+    const char *path = "../input.txt";
+    int showCode = 0, keepSsa = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--codigo") == 0) {
+            showCode = 1;
+        } else if (strcmp(argv[i], "--ssa") == 0) {
+            keepSsa = 1;
+            showCode = 1;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    // Ler todo o conteúdo do arquivo fonte
+    char *code = readSourceFile(path, NULL);
+    if (!code) {
+        return EXIT_FAILURE;
+    }
+
+    // Analisar o código
+    printf("Analisando código do arquivo: %s\n", path);
+    lexicalAnalysis(code);
+
+    Ast ast;
+    Parser parser;
+    astInit(&ast, code, tokenCount);
+    parserInit(&parser, &ast, tokens, tokenCount);
+    parseProgram(&parser);
+
+    int status = EXIT_FAILURE;
+    Checker checker;
+    if (parser.errorCount) {
+        printf("\n%d erro(s) sintático(s); código não otimizado.\n", parser.errorCount);
+    } else if (semanticAnalysis(&checker, &ast, NULL)) {
+        printf("\n%d erro(s) semântico(s); código não otimizado.\n", checker.errorCount);
+    } else {
+        IrModule module;
+        IrGenerator generator;
+        int errors = generateIr(&generator, &module, &ast);
+        if (errors) {
+            printf("\n%d erro(s) na geração de código; código não otimizado.\n", errors);
+        } else {
+            OptStats stats;
+            optimizeModule(&module, &stats, keepSsa);
+            if (showCode) {
+                printf("\nCódigo otimizado%s:\n", keepSsa ? " (forma SSA)" : "");
+                irPrintModule(stdout, &module);
+            }
+            printf("\nPassos de otimização (%u função(ões)):\n", module.functionCount);
+            optPrintStats(stdout, &stats);
+            status = EXIT_SUCCESS;
+        }
+        irModuleFree(&module);
+    }
+
+    // Limpar memória
+    astFree(&ast);
+    freeTokens();
+    freeLineIndex();
+    free(code);
+    return status;
+}
@@ -0,0 +1,1687 @@
+/*
+ * Otimizador do código intermediário
+ *
+ * Converte cada função do código intermediário (codigo intermediario.h)
+ * para a forma SSA, aplica os passos de otimização e volta à forma com
+ * cópias, que o interpretador e os geradores de código consomem.
+ *
+ * Passos (na ordem em que são aplicados):
+ * - Construção da SSA: algoritmo de Braun et al. ("Simple and Efficient
+ *   Construction of SSA Form"): as variáveis são renomeadas bloco a bloco e
+ *   os phi são criados sob demanda, com blocos "selados" quando todos os
+ *   predecessores foram visitados; phi triviais são removidos em seguida
+ * - Constantes e cópias: dobra operações com operandos constantes, propaga
+ *   cópias e constantes, simplifica identidades (x + 0, x * 1) e resolve
+ *   desvios com condição constante, removendo os blocos inalcançáveis
+ * - Invariantes de laço: move para o pré-cabeçalho as operações puras cujos
+ *   operandos são definidos fora do laço
+ * - Subexpressões comuns: numeração de valores por hash-consing, percorrendo
+ *   a árvore de dominadores com uma tabela com escopos (depois dos
+ *   invariantes, para unir as constantes movidas para fora dos laços)
+ * - Código morto: marca as instruções necessárias a partir das que têm
+ *   efeitos colaterais e remove as demais
+ * - Saída da SSA: cada phi vira cópias nos predecessores. As cópias vão
+ *   direto para o registrador do phi quando isso é seguro; senão passam por
+ *   um registrador novo, o que evita os problemas de cópia perdida e de troca
+ *
+ * Cada passo mede o tempo gasto e o número de instruções antes e depois
+ * (OptStats), para comparar o custo de compilação com o ganho.
+ *
+ * Invariantes mantidos entre os passos:
+ * - Todo bloco básico começa com IR_LABEL e só a última instrução desvia
+ * - Os phi ficam logo após o rótulo; seus operandos são identificados pelo
+ *   rótulo do predecessor, o que sobrevive à remoção de blocos e arestas
+ * - O bloco 0 é a entrada e não tem predecessores
+ */
+
+#ifndef OTIMIZACAO_H
+#define OTIMIZACAO_H
+
+#include <time.h>
+#include "codigo intermediario.h"
+
+#define OPT_NONE UINT32_MAX
+#define OPT_LICM_ROUNDS 8
+
+// Estrutura de um bloco básico
+typedef struct {
+    uint32_t start;       // Índice do IR_LABEL do bloco
+    uint32_t end;         // Uma posição após a última instrução
+    uint32_t label;
+    uint32_t predStart;   // Predecessores em cfg->preds[predStart .. predStart + predCount)
+    uint32_t predCount;
+    uint32_t succ[2];
+    uint32_t succCount;
+    uint32_t idom;        // Dominador imediato (OPT_NONE se inalcançável)
+    uint32_t childStart;  // Filhos na árvore de dominadores em cfg->domChildren
+    uint32_t childCount;
+    uint32_t preorder;    // Numeração da árvore de dominadores (teste de dominância)
+    uint32_t postorder;
+} BasicBlock;
+
+// Estrutura do grafo de fluxo de controle
+typedef struct {
+    BasicBlock *blocks;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t *preds;
+    uint32_t predCapacity;
+    uint32_t *labelBlock;     // Rótulo -> bloco (OPT_NONE se o rótulo não existe mais)
+    uint32_t labelCapacity;
+    uint32_t *order;          // Blocos em pós-ordem reversa
+    uint32_t orderCount;
+    uint32_t orderCapacity;
+    uint32_t *domChildren;
+    uint32_t domCapacity;
+} Cfg;
+
+// Enumeração para os passos
+typedef enum {
+    PASS_SSA,
+    PASS_CONSTANTS,
+    PASS_LICM,
+    PASS_CSE,
+    PASS_DCE,
+    PASS_OUT_OF_SSA,
+    PASS_COUNT
+} OptPass;
+
+static const char *optPassNames[PASS_COUNT] = {
+    "construção da SSA", "constantes e cópias", "invariantes de laço",
+    "subexpressões comuns", "código morto", "saída da SSA"
+};
+
+// Estrutura das estatísticas dos passos (somadas sobre todas as funções)
+typedef struct {
+    double milliseconds[PASS_COUNT];
+    uint64_t before[PASS_COUNT];
+    uint64_t after[PASS_COUNT];
+    uint64_t changes[PASS_COUNT];   // Instruções dobradas, removidas ou movidas
+} OptStats;
+
+// Estrutura de uma instrução a inserir no fim de um bloco (antes do desvio)
+typedef struct {
+    uint32_t block;
+    IrInstr instr;
+} OptInsertion;
+
+// ---------------------------------------------------------------------------
+// Utilitários
+// ---------------------------------------------------------------------------
+
+// Função para alocar memória zerada para os passos
+void *optCalloc(size_t count, size_t size) {
+    void *memory = calloc(count ? count : 1, size);
+    if (!memory) {
+        fprintf(stderr, "Erro: Falha ao alocar memória para a otimização.\n");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+// Função para obter ponteiros para os operandos lidos de uma instrução (exceto phi)
+int optUseOperands(IrInstr *instr, uint32_t *operands[3]) {
+    const IrOpcodeInfo *info = &irOpcodeInfo[instr->op];
+    int count = 0;
+    if (info->src1 == OPND_VREG && instr->src1) operands[count++] = &instr->src1;
+    if (info->src2 == OPND_VREG && instr->src2) operands[count++] = &instr->src2;
+    if ((info->properties & IRF_DST_READ) && instr->dst) operands[count++] = &instr->dst;
+    return count;
+}
+
+// Função para contar as instruções efetivas (sem rótulos e NOP)
+uint32_t optInstructionCount(const IrFunction *fn) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < fn->count; i++) {
+        count += fn->code[i].op != IR_LABEL && fn->code[i].op != IR_NOP;
+    }
+    return count;
+}
+
+// Função para remover as instruções IR_NOP; devolve quantas foram removidas
+uint32_t optCompact(IrFunction *fn) {
+    uint32_t out = 0;
+    for (uint32_t i = 0; i < fn->count; i++) {
+        if (fn->code[i].op != IR_NOP) {
+            fn->code[out++] = fn->code[i];
+        }
+    }
+    uint32_t removed = fn->count - out;
+    fn->count = out;
+    return removed;
+}
+
+// Função para criar o mapa de substituição de registradores (identidade)
+VReg *optNewReplacements(const IrFunction *fn) {
+    VReg *replace = optCalloc(fn->vregCount, sizeof(VReg));
+    for (VReg v = 0; v < fn->vregCount; v++) {
+        replace[v] = v;
+    }
+    return replace;
+}
+
+// Função para obter o registrador que substitui 'v' (com compressão de caminho)
+VReg optResolve(VReg *replace, VReg v) {
+    while (replace[v] != v) {
+        replace[v] = replace[replace[v]];
+        v = replace[v];
+    }
+    return v;
+}
+
+// Função para aplicar o mapa de substituição a todos os operandos lidos
+void optApplyReplacements(IrFunction *fn, VReg *replace) {
+    for (uint32_t i = 0; i < fn->count; i++) {
+        IrInstr *instr = &fn->code[i];
+        if (instr->op == IR_PHI) {
+            for (uint32_t k = 0; k < instr->src2; k++) {
+                IrPhiOperand *operand = &fn->phiOperands[instr->src1 + k];
+                operand->value = optResolve(replace, operand->value);
+            }
+            continue;
+        }
+        uint32_t *operands[3];
+        int count = optUseOperands(instr, operands);
+        for (int k = 0; k < count; k++) {
+            *operands[k] = optResolve(replace, *operands[k]);
+        }
+    }
+}
+
+// Função para indexar a instrução que define cada registrador (OPT_NONE para parâmetros)
+uint32_t *optDefinitions(const IrFunction *fn) {
+    uint32_t *defs = optCalloc(fn->vregCount, sizeof(uint32_t));
+    memset(defs, 0xFF, fn->vregCount * sizeof(uint32_t));
+    for (uint32_t i = 0; i < fn->count; i++) {
+        VReg def = irDefinition(&fn->code[i]);
+        if (def) {
+            defs[def] = i;
+        }
+    }
+    return defs;
+}
+
+// ---------------------------------------------------------------------------
+// Grafo de fluxo de controle e dominadores
+// ---------------------------------------------------------------------------
+
+// Função para liberar o grafo
+void cfgFree(Cfg *cfg) {
+    free(cfg->blocks);
+    free(cfg->preds);
+    free(cfg->labelBlock);
+    free(cfg->order);
+    free(cfg->domChildren);
+    memset(cfg, 0, sizeof(*cfg));
+}
+
+// Função para construir o grafo a partir do código (cada bloco começa com um IR_LABEL)
+void cfgBuild(Cfg *cfg, const IrFunction *fn) {
+    cfg->count = 0;
+    for (uint32_t i = 0; i < fn->count; i++) {
+        if (fn->code[i].op == IR_LABEL) {
+            if (cfg->count) {
+                cfg->blocks[cfg->count - 1].end = i;
+            }
+            cfg->blocks = vectorGrow(cfg->blocks, &cfg->capacity, cfg->count + 1, sizeof(BasicBlock));
+            BasicBlock *block = &cfg->blocks[cfg->count++];
+            memset(block, 0, sizeof(*block));
+            block->start = i;
+            block->label = fn->code[i].src1;
+        }
+    }
+    if (cfg->count) {
+        cfg->blocks[cfg->count - 1].end = fn->count;
+    }
+
+    cfg->labelBlock = vectorGrow(cfg->labelBlock, &cfg->labelCapacity, fn->labelCount, sizeof(uint32_t));
+    memset(cfg->labelBlock, 0xFF, fn->labelCount * sizeof(uint32_t));
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        cfg->labelBlock[cfg->blocks[b].label] = b;
+    }
+
+    // Sucessores pela última instrução do bloco
+    uint32_t edges = 0;
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        BasicBlock *block = &cfg->blocks[b];
+        const IrInstr *last = &fn->code[block->end - 1];
+        uint32_t next = b + 1 < cfg->count ? b + 1 : OPT_NONE;
+        switch (last->op) {
+            case IR_JUMP:
+                block->succ[block->succCount++] = cfg->labelBlock[last->src1];
+                break;
+            case IR_JUMP_IF:
+            case IR_JUMP_IFNOT:
+                if (next != OPT_NONE) {
+                    block->succ[block->succCount++] = next;
+                }
+                if (cfg->labelBlock[last->src2] != next) {
+                    block->succ[block->succCount++] = cfg->labelBlock[last->src2];
+                }
+                break;
+            case IR_RET:
+                break;
+            default:
+                if (next != OPT_NONE) {
+                    block->succ[block->succCount++] = next;
+                }
+                break;
+        }
+        edges += block->succCount;
+    }
+
+    // Predecessores em ordem de bloco
+    cfg->preds = vectorGrow(cfg->preds, &cfg->predCapacity, edges, sizeof(uint32_t));
+    uint32_t total = 0;
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        for (uint32_t s = 0; s < cfg->blocks[b].succCount; s++) {
+            cfg->blocks[cfg->blocks[b].succ[s]].predCount++;
+        }
+    }
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        cfg->blocks[b].predStart = total;
+        total += cfg->blocks[b].predCount;
+        cfg->blocks[b].predCount = 0;
+    }
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        for (uint32_t s = 0; s < cfg->blocks[b].succCount; s++) {
+            BasicBlock *succ = &cfg->blocks[cfg->blocks[b].succ[s]];
+            cfg->preds[succ->predStart + succ->predCount++] = b;
+        }
+    }
+}
+
+// Função para verificar se 'pred' é predecessor de 'block'
+int cfgHasPred(const Cfg *cfg, uint32_t block, uint32_t pred) {
+    const BasicBlock *b = &cfg->blocks[block];
+    for (uint32_t i = 0; i < b->predCount; i++) {
+        if (cfg->preds[b->predStart + i] == pred) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Função para calcular a pós-ordem reversa a partir da entrada (DFS iterativa)
+void cfgOrder(Cfg *cfg) {
+    uint32_t *stack = optCalloc(cfg->count + 1, sizeof(uint32_t));
+    uint32_t *next = optCalloc(cfg->count, sizeof(uint32_t));   // Próximo sucessor a visitar
+    uint8_t *visited = optCalloc(cfg->count, 1);
+    uint32_t depth = 0;
+
+    cfg->order = vectorGrow(cfg->order, &cfg->orderCapacity, cfg->count, sizeof(uint32_t));
+    cfg->orderCount = 0;
+    if (cfg->count) {
+        stack[depth++] = 0;
+        visited[0] = 1;
+    }
+    while (depth) {
+        uint32_t b = stack[depth - 1];
+        if (next[b] < cfg->blocks[b].succCount) {
+            uint32_t s = cfg->blocks[b].succ[next[b]++];
+            if (!visited[s]) {
+                visited[s] = 1;
+                stack[depth++] = s;
+            }
+        } else {
+            cfg->order[cfg->orderCount++] = b;
+            depth--;
+        }
+    }
+    // Inverte a pós-ordem
+    for (uint32_t i = 0; i < cfg->orderCount / 2; i++) {
+        uint32_t t = cfg->order[i];
+        cfg->order[i] = cfg->order[cfg->orderCount - 1 - i];
+        cfg->order[cfg->orderCount - 1 - i] = t;
+    }
+    free(stack);
+    free(next);
+    free(visited);
+}
+
+// Função para calcular os dominadores (Cooper, Harvey e Kennedy) e a árvore de dominadores
+void cfgDominators(Cfg *cfg) {
+    cfgOrder(cfg);
+    uint32_t *rank = optCalloc(cfg->count, sizeof(uint32_t));
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        cfg->blocks[b].idom = OPT_NONE;
+    }
+    for (uint32_t i = 0; i < cfg->orderCount; i++) {
+        rank[cfg->order[i]] = i;
+    }
+    cfg->blocks[0].idom = 0;
+
+    for (int changed = 1; changed;) {
+        changed = 0;
+        for (uint32_t i = 1; i < cfg->orderCount; i++) {
+            uint32_t b = cfg->order[i];
+            const BasicBlock *block = &cfg->blocks[b];
+            uint32_t idom = OPT_NONE;
+            for (uint32_t p = 0; p < block->predCount; p++) {
+                uint32_t pred = cfg->preds[block->predStart + p];
+                if (cfg->blocks[pred].idom == OPT_NONE) {
+                    continue;
+                }
+                if (idom == OPT_NONE) {
+                    idom = pred;
+                    continue;
+                }
+                uint32_t a = pred, c = idom;
+                while (a != c) {
+                    while (rank[a] > rank[c]) a = cfg->blocks[a].idom;
+                    while (rank[c] > rank[a]) c = cfg->blocks[c].idom;
+                }
+                idom = a;
+            }
+            if (cfg->blocks[b].idom != idom) {
+                cfg->blocks[b].idom = idom;
+                changed = 1;
+            }
+        }
+    }
+
+    // Filhos da árvore de dominadores (em ordem de bloco)
+    cfg->domChildren = vectorGrow(cfg->domChildren, &cfg->domCapacity, cfg->count, sizeof(uint32_t));
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        cfg->blocks[b].childCount = 0;
+    }
+    for (uint32_t b = 1; b < cfg->count; b++) {
+        if (cfg->blocks[b].idom != OPT_NONE) {
+            cfg->blocks[cfg->blocks[b].idom].childCount++;
+        }
+    }
+    uint32_t total = 0;
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        cfg->blocks[b].childStart = total;
+        total += cfg->blocks[b].childCount;
+        cfg->blocks[b].childCount = 0;
+    }
+    for (uint32_t b = 1; b < cfg->count; b++) {
+        uint32_t idom = cfg->blocks[b].idom;
+        if (idom != OPT_NONE) {
+            cfg->domChildren[cfg->blocks[idom].childStart + cfg->blocks[idom].childCount++] = b;
+        }
+    }
+
+    // Numeração em pré-ordem e pós-ordem da árvore (DFS iterativa)
+    uint32_t *stack = optCalloc(cfg->count + 1, sizeof(uint32_t));
+    uint32_t *next = rank;  // Reaproveitado: próximo filho a visitar
+    memset(next, 0, cfg->count * sizeof(uint32_t));
+    uint32_t depth = 0, pre = 0, post = 0;
+    stack[depth++] = 0;
+    cfg->blocks[0].preorder = pre++;
+    while (depth) {
+        BasicBlock *block = &cfg->blocks[stack[depth - 1]];
+        if (next[stack[depth - 1]] < block->childCount) {
+            uint32_t child = cfg->domChildren[block->childStart + next[stack[depth - 1]]++];
+            cfg->blocks[child].preorder = pre++;
+            stack[depth++] = child;
+        } else {
+            block->postorder = post++;
+            depth--;
+        }
+    }
+    free(stack);
+    free(rank);
+}
+
+// Função para verificar se o bloco 'a' domina o bloco 'b'
+int cfgDominates(const Cfg *cfg, uint32_t a, uint32_t b) {
+    return cfg->blocks[a].preorder <= cfg->blocks[b].preorder &&
+           cfg->blocks[b].postorder <= cfg->blocks[a].postorder;
+}
+
+// Função para remover os operandos de phi cujo rótulo não é mais predecessor do bloco
+void cfgPrunePhis(const Cfg *cfg, IrFunction *fn) {
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        for (uint32_t i = cfg->blocks[b].start + 1; i < cfg->blocks[b].end && fn->code[i].op == IR_PHI; i++) {
+            IrInstr *phi = &fn->code[i];
+            uint32_t kept = 0;
+            for (uint32_t k = 0; k < phi->src2; k++) {
+                IrPhiOperand operand = fn->phiOperands[phi->src1 + k];
+                uint32_t pred = cfg->labelBlock[operand.label];
+                if (pred != OPT_NONE && cfgHasPred(cfg, b, pred)) {
+                    fn->phiOperands[phi->src1 + kept++] = operand;
+                }
+            }
+            phi->src2 = kept;
+        }
+    }
+}
+
+// Função para remover os blocos inalcançáveis a partir da entrada; devolve 1 se removeu algum
+int cfgRemoveUnreachable(Cfg *cfg, IrFunction *fn) {
+    cfgOrder(cfg);
+    if (cfg->orderCount == cfg->count) {
+        return 0;
+    }
+    uint8_t *reachable = optCalloc(cfg->count, 1);
+    for (uint32_t i = 0; i < cfg->orderCount; i++) {
+        reachable[cfg->order[i]] = 1;
+    }
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        if (!reachable[b]) {
+            for (uint32_t i = cfg->blocks[b].start; i < cfg->blocks[b].end; i++) {
+                fn->code[i].op = IR_NOP;
+            }
+        }
+    }
+    free(reachable);
+    optCompact(fn);
+    cfgBuild(cfg, fn);
+    cfgPrunePhis(cfg, fn);
+    return 1;
+}
+
+// Função para inserir instruções no fim dos blocos (antes do desvio final), descartando os NOP
+void optInsertAtBlockEnds(IrFunction *fn, const Cfg *cfg, const OptInsertion *insertions, uint32_t count) {
+    uint32_t *start = optCalloc(cfg->count + 1, sizeof(uint32_t));
+    const OptInsertion **sorted = optCalloc(count, sizeof(OptInsertion *));
+    for (uint32_t i = 0; i < count; i++) {
+        start[insertions[i].block + 1]++;
+    }
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        start[b + 1] += start[b];
+    }
+    uint32_t *fill = optCalloc(cfg->count, sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t b = insertions[i].block;
+        sorted[start[b] + fill[b]++] = &insertions[i];
+    }
+
+    IrInstr *code = optCalloc(fn->count + count, sizeof(IrInstr));
+    uint32_t out = 0;
+    for (uint32_t b = 0; b < cfg->count; b++) {
+        const BasicBlock *block = &cfg->blocks[b];
+        uint32_t end = block->end;
+        int branch = (irOpcodeInfo[fn->code[end - 1].op].properties & IRF_BRANCH) != 0;
+        for (uint32_t i = block->start; i < end - branch; i++) {
+            if (fn->code[i].op != IR_NOP) code[out++] = fn->code[i];
+        }
+        for (uint32_t i = start[b]; i < start[b + 1]; i++) {
+            code[out++] = sorted[i]->instr;
+        }
+        if (branch) {
+            code[out++] = fn->code[end - 1];
+        }
+    }
+    free(fn->code);
+    fn->code = code;
+    fn->count = out;
+    fn->capacity = fn->count + count > out ? fn->count + count : out;
+    free(start);
+    free(sorted);
+    free(fill);
+}
+
+// ---------------------------------------------------------------------------
+// Construção da SSA (Braun et al.)
+// ---------------------------------------------------------------------------
+
+// Estrutura de um phi durante a construção
+typedef struct {
+    uint32_t block;
+    VReg dst;
+    VReg variable;
+    uint32_t operandStart;
+    uint32_t operandCount;
+    uint32_t nextIncomplete;  // Próximo phi incompleto do mesmo bloco
+    uint8_t removed;
+} SsaPhi;
+
+// Estrutura de uma definição atual (variável, bloco) -> registrador
+typedef struct {
+    uint64_t key;   // 0 = livre
+    VReg value;
+} SsaDefinition;
+
+// Estrutura do construtor da SSA
+typedef struct {
+    IrFunction *fn;
+    const Cfg *cfg;
+    uint32_t variableCount;     // Registradores originais (índices de 'isVariable')
+    uint8_t *isVariable;
+    SsaDefinition *defs;
+    uint32_t defMask;
+    uint32_t defCount;
+    SsaPhi *phis;
+    uint32_t phiCount;
+    uint32_t phiCapacity;
+    IrPhiOperand *operands;
+    uint32_t operandCount;
+    uint32_t operandCapacity;
+    uint8_t *sealed;
+    uint8_t *filled;
+    uint32_t *incomplete;       // Primeiro phi incompleto de cada bloco
+    IrInstr *undefined;         // Valores indefinidos criados na entrada
+    uint32_t undefinedCount;
+    uint32_t undefinedCapacity;
+} SsaBuilder;
+
+// Função para localizar a entrada de (variável, bloco) no mapa de definições
+SsaDefinition *ssaFindDefinition(SsaBuilder *s, uint64_t key) {
+    uint32_t i = (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 40) & s->defMask;
+    while (s->defs[i].key && s->defs[i].key != key) {
+        i = (i + 1) & s->defMask;
+    }
+    return &s->defs[i];
+}
+
+// Função para registrar a definição atual de uma variável em um bloco
+void ssaWriteVariable(SsaBuilder *s, VReg variable, uint32_t block, VReg value) {
+    uint64_t key = ((uint64_t)variable << 32) | (block + 1);
+    if ((s->defCount + 1) * 2 > s->defMask + 1) {
+        SsaDefinition *old = s->defs;
+        uint32_t oldSize = s->defMask + 1;
+        s->defMask = oldSize * 2 - 1;
+        s->defs = optCalloc(oldSize * 2, sizeof(SsaDefinition));
+        for (uint32_t i = 0; i < oldSize; i++) {
+            if (old[i].key) {
+                *ssaFindDefinition(s, old[i].key) = old[i];
+            }
+        }
+        free(old);
+    }
+    SsaDefinition *entry = ssaFindDefinition(s, key);
+    if (!entry->key) {
+        entry->key = key;
+        s->defCount++;
+    }
+    entry->value = value;
+}
+
+// Função para criar um phi vazio para 'variable' no início de 'block'
+uint32_t ssaNewPhi(SsaBuilder *s, VReg variable, uint32_t block) {
+    s->phis = vectorGrow(s->phis, &s->phiCapacity, s->phiCount + 1, sizeof(SsaPhi));
+    SsaPhi *phi = &s->phis[s->phiCount];
+    memset(phi, 0, sizeof(*phi));
+    phi->block = block;
+    phi->variable = variable;
+    phi->dst = irNewVreg(s->fn, s->fn->vregTypes[variable]);
+    phi->nextIncomplete = OPT_NONE;
+    return s->phiCount++;
+}
+
+// Função para criar um valor indefinido (zero do tipo) no início da entrada
+VReg ssaUndefined(SsaBuilder *s, VReg variable) {
+    uint8_t type = s->fn->vregTypes[variable];
+    VReg dst = irNewVreg(s->fn, type);
+    s->undefined = vectorGrow(s->undefined, &s->undefinedCapacity, s->undefinedCount + 1, sizeof(IrInstr));
+    IrInstr *instr = &s->undefined[s->undefinedCount++];
+    memset(instr, 0, sizeof(*instr));
+    instr->op = type == IR_DOUBLE ? IR_FCONST : IR_ICONST;
+    instr->type = type;
+    instr->dst = dst;
+    instr->src1 = type == IR_DOUBLE ? irAddFloat(s->fn, 0.0) : 0;
+    return dst;
+}
+
+VReg ssaReadVariable(SsaBuilder *s, VReg variable, uint32_t block);
+
+// Função para preencher os operandos de um phi com as definições que chegam de cada predecessor
+void ssaAddPhiOperands(SsaBuilder *s, uint32_t phiIndex) {
+    const BasicBlock *block = &s->cfg->blocks[s->phis[phiIndex].block];
+    VReg variable = s->phis[phiIndex].variable;
+    IrPhiOperand *values = optCalloc(block->predCount, sizeof(IrPhiOperand));
+
+    // As leituras podem criar outros phi; os operandos deste são anexados juntos no fim
+    for (uint32_t p = 0; p < block->predCount; p++) {
+        uint32_t pred = s->cfg->preds[block->predStart + p];
+        values[p].label = s->cfg->blocks[pred].label;
+        values[p].value = ssaReadVariable(s, variable, pred);
+    }
+    s->operands = vectorGrow(s->operands, &s->operandCapacity, s->operandCount + block->predCount,
+                             sizeof(IrPhiOperand));
+    memcpy(s->operands + s->operandCount, values, block->predCount * sizeof(IrPhiOperand));
+    s->phis[phiIndex].operandStart = s->operandCount;
+    s->phis[phiIndex].operandCount = block->predCount;
+    s->operandCount += block->predCount;
+    free(values);
+}
+
+// Função para obter a definição de uma variável que alcança o bloco
+VReg ssaReadVariable(SsaBuilder *s, VReg variable, uint32_t block) {
+    uint64_t key = ((uint64_t)variable << 32) | (block + 1);
+    const SsaDefinition *entry = ssaFindDefinition(s, key);
+    if (entry->key) {
+        return entry->value;
+    }
+
+    const BasicBlock *b = &s->cfg->blocks[block];
+    VReg value;
+    if (!s->sealed[block]) {
+        // Predecessores ainda desconhecidos: phi incompleto, completado ao selar o bloco
+        uint32_t phi = ssaNewPhi(s, variable, block);
+        s->phis[phi].nextIncomplete = s->incomplete[block];
+        s->incomplete[block] = phi;
+        value = s->phis[phi].dst;
+    } else if (b->predCount == 0) {
+        value = ssaUndefined(s, variable);
+    } else if (b->predCount == 1) {
+        value = ssaReadVariable(s, variable, s->cfg->preds[b->predStart]);
+    } else {
+        // Registra o phi antes de ler os predecessores para interromper ciclos
+        uint32_t phi = ssaNewPhi(s, variable, block);
+        ssaWriteVariable(s, variable, block, s->phis[phi].dst);
+        ssaAddPhiOperands(s, phi);
+        value = s->phis[phi].dst;
+    }
+    ssaWriteVariable(s, variable, block, value);
+    return value;
+}
+
+// Função para selar um bloco (todos os predecessores já foram preenchidos)
+void ssaSealBlock(SsaBuilder *s, uint32_t block) {
+    for (uint32_t phi = s->incomplete[block]; phi != OPT_NONE; phi = s->phis[phi].nextIncomplete) {
+        ssaAddPhiOperands(s, phi);
+    }
+    s->incomplete[block] = OPT_NONE;
+    s->sealed[block] = 1;
+}
+
+// Função para selar um bloco se todos os seus predecessores já foram preenchidos
+void ssaTrySeal(SsaBuilder *s, uint32_t block) {
+    const BasicBlock *b = &s->cfg->blocks[block];
+    if (s->sealed[block]) {
+        return;
+    }
+    for (uint32_t p = 0; p < b->predCount; p++) {
+        if (!s->filled[s->cfg->preds[b->predStart + p]]) {
+            return;
+        }
+    }
+    ssaSealBlock(s, block);
+}
+
+// Função para normalizar o código: entrada sem predecessores, rótulo no início de cada
+// bloco e nada após um desvio dentro do mesmo bloco; remove os blocos inalcançáveis
+void ssaNormalize(IrFunction *fn, Cfg *cfg) {
+    IrInstr *code = optCalloc(fn->count * 2 + 1, sizeof(IrInstr));
+    uint32_t out = 0;
+
+    code[out].op = IR_LABEL;
+    code[out++].src1 = fn->labelCount++;
+    for (uint32_t i = 0; i < fn->count; i++) {
+        if (i > 0 && (irOpcodeInfo[fn->code[i - 1].op].properties & IRF_BRANCH) && fn->code[i].op != IR_LABEL) {
+            code[out].op = IR_LABEL;
+            code[out++].src1 = fn->labelCount++;
+        }
+        if (fn->code[i].op != IR_NOP) {
+            code[out++] = fn->code[i];
+        }
+    }
+    free(fn->code);
+    fn->code = code;
+    fn->count = out;
+    fn->capacity = fn->count * 2 + 1 > out ? fn->count * 2 + 1 : out;
+
+    cfgBuild(cfg, fn);
+    cfgRemoveUnreachable(cfg, fn);
+}
+
+// Função para converter a função para a forma SSA; devolve o número de phi criados
+uint32_t ssaConstruct(IrFunction *fn) {
+    Cfg cfg = {0};
+    SsaBuilder s;
+    memset(&s, 0, sizeof(s));
+    ssaNormalize(fn, &cfg);
+
+    s.fn = fn;
+    s.cfg = &cfg;
+    s.variableCount = fn->vregCount;
+    s.isVariable = optCalloc(fn->vregCount, 1);
+    s.defMask = 63;
+    s.defs = optCalloc(64, sizeof(SsaDefinition));
+    s.sealed = optCalloc(cfg.count, 1);
+    s.filled = optCalloc(cfg.count, 1);
+    s.incomplete = optCalloc(cfg.count, sizeof(uint32_t));
+    memset(s.incomplete, 0xFF, cfg.count * sizeof(uint32_t));
+
+    // Variáveis: registradores atribuídos mais de uma vez ou parâmetros reatribuídos
+    uint8_t *defCount = optCalloc(fn->vregCount, 1);
+    for (uint32_t i = 0; i < fn->count; i++) {
+        VReg def = irDefinition(&fn->code[i]);
+        if (def && defCount[def] < 2) {
+            defCount[def]++;
+        }
+    }
+    for (VReg v = 1; v < fn->vregCount; v++) {
+        s.isVariable[v] = defCount[v] > 1 || (v <= fn->paramCount && defCount[v] > 0);
+        if (s.isVariable[v] && v <= fn->paramCount) {
+            ssaWriteVariable(&s, v, 0, v);  // O parâmetro é a definição inicial
+        }
+    }
+    free(defCount);
+
+    // Renomeia bloco a bloco na ordem do código
+    ssaSealBlock(&s, 0);
+    for (uint32_t b = 0; b < cfg.count; b++) {
+        ssaTrySeal(&s, b);
+        for (uint32_t i = cfg.blocks[b].start; i < cfg.blocks[b].end; i++) {
+            IrInstr *instr = &fn->code[i];
+            uint32_t *operands[3];
+            int count = optUseOperands(instr, operands);
+            for (int k = 0; k < count; k++) {
+                if (*operands[k] < s.variableCount && s.isVariable[*operands[k]]) {
+                    *operands[k] = ssaReadVariable(&s, *operands[k], b);
+                }
+            }
+            VReg def = irDefinition(instr);
+            if (def && def < s.variableCount && s.isVariable[def]) {
+                VReg renamed = irNewVreg(fn, fn->vregTypes[def]);
+                fn->code[i].dst = renamed;
+                ssaWriteVariable(&s, def, b, renamed);
+            }
+        }
+        s.filled[b] = 1;
+        for (uint32_t k = 0; k < cfg.blocks[b].succCount; k++) {
+            ssaTrySeal(&s, cfg.blocks[b].succ[k]);
+        }
+    }
+
+    // Remove os phi triviais (todos os operandos iguais, exceto o próprio phi)
+    VReg *replace = optNewReplacements(fn);
+    for (int changed = 1; changed;) {
+        changed = 0;
+        for (uint32_t p = 0; p < s.phiCount; p++) {
+            SsaPhi *phi = &s.phis[p];
+            if (phi->removed) {
+                continue;
+            }
+            VReg same = 0;
+            int trivial = 1;
+            for (uint32_t k = 0; k < phi->operandCount; k++) {
+                VReg value = optResolve(replace, s.operands[phi->operandStart + k].value);
+                if (value == phi->dst || value == same) {
+                    continue;
+                }
+                if (same) {
+                    trivial = 0;
+                    break;
+                }
+                same = value;
+            }
+            if (trivial && same) {
+                replace[phi->dst] = same;
+                phi->removed = 1;
+                changed = 1;
+            }
+        }
+    }
+
+    // Reconstrói o código com os phi restantes logo após o rótulo de cada bloco
+    uint32_t *phiStart = optCalloc(cfg.count + 1, sizeof(uint32_t));
+    uint32_t *phiOrder = optCalloc(s.phiCount, sizeof(uint32_t));
+    uint32_t *fill = optCalloc(cfg.count, sizeof(uint32_t));
+    uint32_t live = 0;
+    for (uint32_t p = 0; p < s.phiCount; p++) {
+        if (!s.phis[p].removed) {
+            phiStart[s.phis[p].block + 1]++;
+            live++;
+        }
+    }
+    for (uint32_t b = 0; b < cfg.count; b++) {
+        phiStart[b + 1] += phiStart[b];
+    }
+    for (uint32_t p = 0; p < s.phiCount; p++) {
+        if (!s.phis[p].removed) {
+            uint32_t b = s.phis[p].block;
+            phiOrder[phiStart[b] + fill[b]++] = p;
+        }
+    }
+
+    IrInstr *code = optCalloc(fn->count + live + s.undefinedCount, sizeof(IrInstr));
+    uint32_t out = 0;
+    for (uint32_t b = 0; b < cfg.count; b++) {
+        code[out++] = fn->code[cfg.blocks[b].start];
+        if (b == 0) {
+            for (uint32_t i = 0; i < s.undefinedCount; i++) {
+                code[out++] = s.undefined[i];
+            }
+        }
+        for (uint32_t i = phiStart[b]; i < phiStart[b + 1]; i++) {
+            const SsaPhi *phi = &s.phis[phiOrder[i]];
+            IrInstr *instr = &code[out++];
+            memset(instr, 0, sizeof(*instr));
+            instr->op = IR_PHI;
+            instr->type = fn->vregTypes[phi->dst];
+            instr->dst = phi->dst;
+            instr->src1 = irAddPhiOperands(fn, s.operands + phi->operandStart, phi->operandCount);
+            instr->src2 = phi->operandCount;
+        }
+        for (uint32_t i = cfg.blocks[b].start + 1; i < cfg.blocks[b].end; i++) {
+            code[out++] = fn->code[i];
+        }
+    }
+    free(fn->code);
+    fn->code = code;
+    fn->count = out;
+    fn->capacity = out;
+    optApplyReplacements(fn, replace);
+
+    free(phiStart);
+    free(phiOrder);
+    free(fill);
+    free(replace);
+    free(s.isVariable);
+    free(s.defs);
+    free(s.phis);
+    free(s.operands);
+    free(s.sealed);
+    free(s.filled);
+    free(s.incomplete);
+    free(s.undefined);
+    cfgFree(&cfg);
+    return live;
+}
+
+// ---------------------------------------------------------------------------
+// Constantes e cópias
+// ---------------------------------------------------------------------------
+
+// Estrutura de um valor constante
+typedef struct {
+    int isDouble;
+    int32_t i;
+    double f;
+} OptValue;
+
+// Função para obter o valor constante de um registrador; devolve 0 se não for constante
+int optConstantValue(const IrFunction *fn, const uint32_t *defs, VReg v, OptValue *value) {
+    if (defs[v] == OPT_NONE) {
+        return 0;
+    }
+    const IrInstr *def = &fn->code[defs[v]];
+    if (def->op == IR_ICONST && def->type != IR_STRING && def->type != IR_REF) {
+        value->isDouble = 0;
+        value->i = (int32_t)def->src1;
+        return 1;
+    }
+    if (def->op == IR_FCONST) {
+        value->isDouble = 1;
+        value->f = fn->floats[def->src1];
+        return 1;
+    }
+    return 0;
+}
+
+// Função para transformar uma instrução em uma constante
+void optMakeConstant(IrFunction *fn, IrInstr *instr, int isDouble, int32_t i, double f) {
+    uint8_t type = fn->vregTypes[instr->dst];
+    if (isDouble) {
+        instr->op = IR_FCONST;
+        instr->src1 = irAddFloat(fn, f);
+    } else {
+        instr->op = IR_ICONST;
+        instr->src1 = (uint32_t)i;
+    }
+    instr->type = type;
+    instr->src2 = 0;
+}
+
+// Função para dobrar uma operação com operandos constantes; devolve 1 se dobrou
+int optFold(IrFunction *fn, const uint32_t *defs, IrInstr *instr) {
+    OptValue a, b;
+    int op = instr->op;
+
+    if (op == IR_NEG || op == IR_NOT || op == IR_I2F || op == IR_F2I) {
+        if (!optConstantValue(fn, defs, instr->src1, &a)) {
+            return 0;
+        }
+        switch (op) {
+            case IR_NEG:
+                if (a.isDouble) optMakeConstant(fn, instr, 1, 0, -a.f);
+                else optMakeConstant(fn, instr, 0, (int32_t)(0u - (uint32_t)a.i), 0);
+                return 1;
+            case IR_NOT:
+                optMakeConstant(fn, instr, 0, !a.i, 0);
+                return 1;
+            case IR_I2F:
+                optMakeConstant(fn, instr, 1, 0, (double)a.i);
+                return 1;
+            default:
+                if (!(a.f > -2147483649.0 && a.f < 2147483648.0)) {
+                    return 0;  // Fora do intervalo (ou NaN): decidido em tempo de execução
+                }
+                optMakeConstant(fn, instr, 0, (int32_t)a.f, 0);
+                return 1;
+        }
+    }
+    if (op < IR_ADD || op > IR_NE || op == IR_NEG || op == IR_NOT ||
+        !optConstantValue(fn, defs, instr->src1, &a) || !optConstantValue(fn, defs, instr->src2, &b) ||
+        a.isDouble != b.isDouble) {
+        return 0;
+    }
+
+    if (a.isDouble) {
+        double x = a.f, y = b.f;
+        switch (op) {
+            case IR_ADD: optMakeConstant(fn, instr, 1, 0, x + y); return 1;
+            case IR_SUB: optMakeConstant(fn, instr, 1, 0, x - y); return 1;
+            case IR_MUL: optMakeConstant(fn, instr, 1, 0, x * y); return 1;
+            case IR_DIV: optMakeConstant(fn, instr, 1, 0, x / y); return 1;
+            case IR_LT: optMakeConstant(fn, instr, 0, x < y, 0); return 1;
+            case IR_GT: optMakeConstant(fn, instr, 0, x > y, 0); return 1;
+            case IR_LE: optMakeConstant(fn, instr, 0, x <= y, 0); return 1;
+            case IR_GE: optMakeConstant(fn, instr, 0, x >= y, 0); return 1;
+            case IR_EQ: optMakeConstant(fn, instr, 0, x == y, 0); return 1;
+            case IR_NE: optMakeConstant(fn, instr, 0, x != y, 0); return 1;
+            default: return 0;  // fmod fica para o tempo de execução
+        }
+    }
+
+    // Inteiros: aritmética com transbordo circular, como em C# (unchecked)
+    uint32_t x = (uint32_t)a.i, y = (uint32_t)b.i;
+    switch (op) {
+        case IR_ADD: optMakeConstant(fn, instr, 0, (int32_t)(x + y), 0); return 1;
+        case IR_SUB: optMakeConstant(fn, instr, 0, (int32_t)(x - y), 0); return 1;
+        case IR_MUL: optMakeConstant(fn, instr, 0, (int32_t)(x * y), 0); return 1;
+        case IR_DIV:
+        case IR_MOD:
+            if (b.i == 0 || (a.i == INT32_MIN && b.i == -1)) {
+                return 0;  // Mantém a falha em tempo de execução
+            }
+            optMakeConstant(fn, instr, 0, op == IR_DIV ? a.i / b.i : a.i % b.i, 0);
+            return 1;
+        case IR_LT: optMakeConstant(fn, instr, 0, a.i < b.i, 0); return 1;
+        case IR_GT: optMakeConstant(fn, instr, 0, a.i > b.i, 0); return 1;
+        case IR_LE: optMakeConstant(fn, instr, 0, a.i <= b.i, 0); return 1;
+        case IR_GE: optMakeConstant(fn, instr, 0, a.i >= b.i, 0); return 1;
+        case IR_EQ: optMakeConstant(fn, instr, 0, a.i == b.i, 0); return 1;
+        case IR_NE: optMakeConstant(fn, instr, 0, a.i != b.i, 0); return 1;
+        default: return 0;
+    }
+}
+
+// Função para simplificar identidades inteiras (x + 0, x - 0, x * 1, x * 0); devolve o registrador equivalente
+VReg optIdentity(IrFunction *fn, const uint32_t *defs, IrInstr *instr) {
+    OptValue a, b;
+    if (instr->type != IR_INT || (instr->op != IR_ADD && instr->op != IR_SUB && instr->op != IR_MUL)) {
+        return 0;
+    }
+    int left = optConstantValue(fn, defs, instr->src1, &a) && !a.isDouble;
+    int right = optConstantValue(fn, defs, instr->src2, &b) && !b.isDouble;
+    VReg result = 0;
+
+    if (right && ((b.i == 0 && instr->op != IR_MUL) || (b.i == 1 && instr->op == IR_MUL))) {
+        result = instr->src1;
+    } else if (left && instr->op != IR_SUB && ((a.i == 0 && instr->op == IR_ADD) || (a.i == 1 && instr->op == IR_MUL))) {
+        result = instr->src2;
+    } else if ((right && b.i == 0) || (left && a.i == 0)) {
+        if (instr->op == IR_MUL) {
+            optMakeConstant(fn, instr, 0, 0, 0);
+        }
+        return 0;
+    }
+    // Só substitui quando o tipo é o mesmo (char + 0 continua int)
+    return (result && fn->vregTypes[result] == fn->vregTypes[instr->dst]) ? result : 0;
+}
+
+// Função para comparar duas instruções constantes
+int optSameConstant(const IrInstr *a, const IrInstr *b) {
+    return (a->op == IR_ICONST || a->op == IR_FCONST) && a->op == b->op && a->type == b->type && a->src1 == b->src1;
+}
+
+// Função do passo de constantes e cópias; devolve o número de instruções simplificadas
+uint32_t optConstants(IrFunction *fn) {
+    uint32_t simplified = 0;
+    Cfg cfg = {0};
+
+    for (int changed = 1; changed;) {
+        changed = 0;
+        int branchFolded = 0;
+        uint32_t *defs = optDefinitions(fn);
+        VReg *replace = optNewReplacements(fn);
+
+        for (uint32_t i = 0; i < fn->count; i++) {
+            IrInstr *instr = &fn->code[i];
+            uint32_t *operands[3];
+            int count = optUseOperands(instr, operands);
+            for (int k = 0; k < count; k++) {
+                *operands[k] = optResolve(replace, *operands[k]);
+            }
+
+            VReg same = 0;
+            switch (instr->op) {
+                case IR_MOV:
+                    // Cópias que mudam o tipo (char = int) ficam
+                    if (fn->vregTypes[instr->src1] == fn->vregTypes[instr->dst]) {
+                        same = instr->src1;
+                    }
+                    break;
+                case IR_PHI: {
+                    // Phi com um único valor (além de si mesmo) ou com constantes iguais
+                    const IrInstr *constant = NULL;
+                    int unique = 1, constants = 1;
+                    for (uint32_t k = 0; k < instr->src2; k++) {
+                        VReg value = optResolve(replace, fn->phiOperands[instr->src1 + k].value);
+                        const IrInstr *def = defs[value] != OPT_NONE ? &fn->code[defs[value]] : NULL;
+                        if (value == instr->dst) {
+                            continue;
+                        }
+                        if (same && value != same) {
+                            unique = 0;
+                        }
+                        same = same ? same : value;
+                        if (!def || !(constant ? optSameConstant(constant, def) : (def->op == IR_ICONST || def->op == IR_FCONST))) {
+                            constants = 0;
+                        }
+                        constant = constant ? constant : def;
+                    }
+                    if (!unique && constants && constant) {
+                        IrInstr folded = *constant;
+                        folded.dst = instr->dst;
+                        *instr = folded;
+                        simplified++;
+                        changed = 1;
+                    }
+                    if (!unique) {
+                        same = 0;
+                    }
+                    break;
+                }
+                case IR_JUMP_IF:
+                case IR_JUMP_IFNOT: {
+                    OptValue condition;
+                    if (optConstantValue(fn, defs, instr->src1, &condition)) {
+                        int taken = (condition.i != 0) == (instr->op == IR_JUMP_IF);
+                        if (taken) {
+                            instr->op = IR_JUMP;
+                            instr->src1 = instr->src2;
+                            instr->src2 = 0;
+                        } else {
+                            instr->op = IR_NOP;
+                        }
+                        instr->type = IR_VOID;
+                        simplified++;
+                        branchFolded = 1;
+                    }
+                    break;
+                }
+                default:
+                    if (optFold(fn, defs, instr)) {
+                        simplified++;
+                        changed = 1;
+                    } else {
+                        same = optIdentity(fn, defs, instr);
+                    }
+                    break;
+            }
+            if (same) {
+                replace[instr->dst] = same;
+                instr->op = IR_NOP;
+                simplified++;
+                changed = 1;
+            }
+        }
+
+        optApplyReplacements(fn, replace);
+        free(defs);
+        free(replace);
+
+        if (branchFolded) {
+            // Um desvio condicional resolvido pode deixar blocos inalcançáveis e phi com menos operandos
+            optCompact(fn);
+            cfgBuild(&cfg, fn);
+            cfgPrunePhis(&cfg, fn);
+            cfgRemoveUnreachable(&cfg, fn);
+            changed = 1;
+        } else {
+            optCompact(fn);
+        }
+    }
+    cfgFree(&cfg);
+    return simplified;
+}
+
+// ---------------------------------------------------------------------------
+// Subexpressões comuns (hash-consing sobre a árvore de dominadores)
+// ---------------------------------------------------------------------------
+
+// Estrutura de uma entrada da tabela de valores
+typedef struct {
+    uint8_t op;
+    uint8_t type;
+    uint8_t used;
+    uint32_t src1;
+    uint32_t src2;
+    VReg value;
+} CseEntry;
+
+// Estrutura de um registro para desfazer inserções ao sair de um escopo
+typedef struct {
+    uint32_t slot;
+    CseEntry previous;
+} CseUndo;
+
+// Função que indica se o resultado de um opcode depende apenas dos operandos
+int cseCandidate(uint8_t op) {
+    return op == IR_ICONST || op == IR_FCONST || op == IR_SCONST ||
+           (op >= IR_ADD && op <= IR_CONCAT) || op == IR_LENGTH;
+}
+
+// Função que indica se um opcode é comutativo
+int cseCommutative(uint8_t op) {
+    return op == IR_ADD || op == IR_MUL || op == IR_EQ || op == IR_NE;
+}
+
+// Função para calcular o hash de uma expressão
+uint32_t cseHash(uint8_t op, uint8_t type, uint32_t src1, uint32_t src2) {
+    uint64_t h = ((uint64_t)op << 56) ^ ((uint64_t)type << 48) ^ ((uint64_t)src1 << 24) ^ src2;
+    h *= 0x9E3779B97F4A7C15ull;
+    return (uint32_t)(h >> 32);
+}
+
+// Função do passo de subexpressões comuns; devolve o número de instruções removidas
+uint32_t optCommonSubexpressions(IrFunction *fn) {
+    Cfg cfg = {0};
+    cfgBuild(&cfg, fn);
+    cfgDominators(&cfg);
+
+    uint32_t size = 64;
+    while (size < fn->count * 2) {
+        size *= 2;
+    }
+    CseEntry *table = optCalloc(size, sizeof(CseEntry));
+    CseUndo *undo = optCalloc(fn->count + 1, sizeof(CseUndo));
+    uint32_t undoCount = 0;
+    VReg *replace = optNewReplacements(fn);
+    uint32_t removed = 0;
+
+    // Pilha da DFS na árvore de dominadores: bloco, próximo filho e marca do registro de desfazer
+    uint32_t *stack = optCalloc(cfg.count * 3 + 3, sizeof(uint32_t));
+    uint32_t depth = 0;
+    stack[0] = 0;
+    stack[1] = 0;
+    stack[2] = 0;
+    depth = 1;
+    int enter = 1;
+
+    while (depth) {
+        uint32_t *frame = &stack[(depth - 1) * 3];
+        const BasicBlock *block = &cfg.blocks[frame[0]];
+
+        if (enter) {
+            frame[2] = undoCount;
+            for (uint32_t i = block->start; i < block->end; i++) {
+                IrInstr *instr = &fn->code[i];
+                uint32_t *operands[3];
+                int count = optUseOperands(instr, operands);
+                for (int k = 0; k < count; k++) {
+                    *operands[k] = optResolve(replace, *operands[k]);
+                }
+                if (!cseCandidate(instr->op) || !instr->dst) {
+                    continue;
+                }
+                uint32_t a = instr->src1, b = instr->src2;
+                if (cseCommutative(instr->op) && a > b) {
+                    uint32_t t = a;
+                    a = b;
+                    b = t;
+                }
+                uint32_t slot = cseHash(instr->op, instr->type, a, b) & (size - 1);
+                while (table[slot].used && !(table[slot].op == instr->op && table[slot].type == instr->type &&
+                                             table[slot].src1 == a && table[slot].src2 == b)) {
+                    slot = (slot + 1) & (size - 1);
+                }
+                if (table[slot].used) {
+                    replace[instr->dst] = table[slot].value;
+                    instr->op = IR_NOP;
+                    removed++;
+                } else {
+                    undo[undoCount].slot = slot;
+                    undo[undoCount++].previous = table[slot];
+                    table[slot] = (CseEntry){instr->op, instr->type, 1, a, b, instr->dst};
+                }
+            }
+        }
+
+        if (frame[1] < block->childCount) {
+            uint32_t child = cfg.domChildren[block->childStart + frame[1]++];
+            uint32_t *next = &stack[depth * 3];
+            next[0] = child;
+            next[1] = 0;
+            depth++;
+            enter = 1;
+        } else {
+            // Sai do escopo: desfaz as inserções deste bloco
+            while (undoCount > frame[2]) {
+                undoCount--;
+                table[undo[undoCount].slot] = undo[undoCount].previous;
+            }
+            depth--;
+            enter = 0;
+        }
+    }
+
+    optApplyReplacements(fn, replace);
+    optCompact(fn);
+    free(stack);
+    free(table);
+    free(undo);
+    free(replace);
+    cfgFree(&cfg);
+    return removed;
+}
+
+// ---------------------------------------------------------------------------
+// Invariantes de laço
+// ---------------------------------------------------------------------------
+
+// Função que indica se uma instrução pode ser executada especulativamente no pré-cabeçalho
+int licmCandidate(uint8_t op) {
+    return op == IR_ICONST || op == IR_FCONST || op == IR_SCONST || op == IR_ADD || op == IR_SUB ||
+           op == IR_MUL || op == IR_NEG || op == IR_NOT || (op >= IR_LT && op <= IR_F2I);
+}
+
+// Função para mover as instruções invariantes de todos os laços uma vez; devolve quantas moveu
+uint32_t licmRound(IrFunction *fn) {
+    Cfg cfg = {0};
+    cfgBuild(&cfg, fn);
+    cfgDominators(&cfg);
+
+    uint32_t *defBlock = optCalloc(fn->vregCount, sizeof(uint32_t));  // Parâmetros: bloco 0
+    for (uint32_t b = 0; b < cfg.count; b++) {
+        for (uint32_t i = cfg.blocks[b].start; i < cfg.blocks[b].end; i++) {
+            VReg def = irDefinition(&fn->code[i]);
+            if (def) {
+                defBlock[def] = b;
+            }
+        }
+    }
+
+    // Cabeçalhos de laço (destinos de arestas de retorno), dos laços internos para os externos
+    uint32_t *loopOf = optCalloc(cfg.count, sizeof(uint32_t));
+    uint32_t *worklist = optCalloc(cfg.count, sizeof(uint32_t));
+    uint32_t *headers = optCalloc(cfg.count, sizeof(uint32_t));
+    uint32_t *sizes = optCalloc(cfg.count, sizeof(uint32_t));
+    uint32_t headerCount = 0;
+    for (uint32_t h = 0; h < cfg.count; h++) {
+        const BasicBlock *header = &cfg.blocks[h];
+        if (header->idom == OPT_NONE) {
+            continue;
+        }
+        uint32_t size = 0, stamp = h + 1, top = 0;
+        for (uint32_t p = 0; p < header->predCount; p++) {
+            uint32_t pred = cfg.preds[header->predStart + p];
+            if (cfgDominates(&cfg, h, pred) && loopOf[pred] != stamp) {
+                loopOf[pred] = stamp;
+                worklist[top++] = pred;
+            }
+        }
+        if (!top) {
+            continue;
+        }
+        loopOf[h] = stamp;
+        while (top) {
+            uint32_t b = worklist[--top];
+            size++;
+            for (uint32_t p = 0; p < cfg.blocks[b].predCount; p++) {
+                uint32_t pred = cfg.preds[cfg.blocks[b].predStart + p];
+                if (loopOf[pred] != stamp) {
+                    loopOf[pred] = stamp;
+                    worklist[top++] = pred;
+                }
+            }
+        }
+        sizes[headerCount] = size;
+        headers[headerCount++] = h;
+    }
+    for (uint32_t i = 1; i < headerCount; i++) {
+        for (uint32_t j = i; j > 0 && sizes[j - 1] > sizes[j]; j--) {
+            uint32_t t = sizes[j]; sizes[j] = sizes[j - 1]; sizes[j - 1] = t;
+            t = headers[j]; headers[j] = headers[j - 1]; headers[j - 1] = t;
+        }
+    }
+
+    OptInsertion *insertions = NULL;
+    uint32_t insertionCount = 0, insertionCapacity = 0;
+    uint8_t *inLoop = optCalloc(cfg.count, 1);
+
+    for (uint32_t l = 0; l < headerCount; l++) {
+        uint32_t h = headers[l];
+        const BasicBlock *header = &cfg.blocks[h];
+
+        // Corpo do laço (recalculado: 'loopOf' guarda apenas o último laço de cada bloco)
+        memset(inLoop, 0, cfg.count);
+        uint32_t top = 0;
+        inLoop[h] = 1;
+        for (uint32_t p = 0; p < header->predCount; p++) {
+            uint32_t pred = cfg.preds[header->predStart + p];
+            if (cfgDominates(&cfg, h, pred) && !inLoop[pred]) {
+                inLoop[pred] = 1;
+                worklist[top++] = pred;
+            }
+        }
+        while (top) {
+            uint32_t b = worklist[--top];
+            for (uint32_t p = 0; p < cfg.blocks[b].predCount; p++) {
+                uint32_t pred = cfg.preds[cfg.blocks[b].predStart + p];
+                if (!inLoop[pred]) {
+                    inLoop[pred] = 1;
+                    worklist[top++] = pred;
+                }
+            }
+        }
+
+        // Pré-cabeçalho: único predecessor externo, com um único sucessor
+        uint32_t preheader = OPT_NONE, outside = 0;
+        for (uint32_t p = 0; p < header->predCount; p++) {
+            uint32_t pred = cfg.preds[header->predStart + p];
+            if (!inLoop[pred]) {
+                preheader = pred;
+                outside++;
+            }
+        }
+        if (outside != 1 || cfg.blocks[preheader].succCount != 1) {
+            continue;
+        }
+
+        for (uint32_t b = 0; b < cfg.count; b++) {
+            if (!inLoop[b]) {
+                continue;
+            }
+            for (uint32_t i = cfg.blocks[b].start; i < cfg.blocks[b].end; i++) {
+                IrInstr *instr = &fn->code[i];
+                if (!licmCandidate(instr->op)) {
+                    continue;
+                }
+                VReg uses[3];
+                int count = irUses(instr, uses), invariant = 1;
+                for (int k = 0; k < count && invariant; k++) {
+                    invariant = !inLoop[defBlock[uses[k]]];
+                }
+                if (!invariant) {
+                    continue;
+                }
+                insertions = vectorGrow(insertions, &insertionCapacity, insertionCount + 1, sizeof(OptInsertion));
+                insertions[insertionCount].block = preheader;
+                insertions[insertionCount++].instr = *instr;
+                defBlock[instr->dst] = preheader;
+                instr->op = IR_NOP;
+            }
+        }
+    }
+
+    if (insertionCount) {
+        optInsertAtBlockEnds(fn, &cfg, insertions, insertionCount);
+    }
+    free(insertions);
+    free(inLoop);
+    free(defBlock);
+    free(loopOf);
+    free(worklist);
+    free(headers);
+    free(sizes);
+    cfgFree(&cfg);
+    return insertionCount;
+}
+
+// Função do passo de invariantes de laço; devolve o número de instruções movidas
+uint32_t optLoopInvariants(IrFunction *fn) {
+    uint32_t moved = 0;
+    for (int round = 0; round < OPT_LICM_ROUNDS; round++) {
+        uint32_t count = licmRound(fn);
+        if (!count) {
+            break;
+        }
+        moved += count;
+    }
+    return moved;
+}
+
+// ---------------------------------------------------------------------------
+// Código morto
+// ---------------------------------------------------------------------------
+
+// Função do passo de código morto; devolve o número de instruções removidas
+uint32_t optDeadCode(IrFunction *fn) {
+    uint32_t *defs = optDefinitions(fn);
+    uint8_t *live = optCalloc(fn->count, 1);
+    uint32_t *worklist = optCalloc(fn->count, sizeof(uint32_t));
+    uint32_t top = 0, removed = 0;
+
+    // Raízes: efeitos colaterais e operações que podem falhar em tempo de execução
+    for (uint32_t i = 0; i < fn->count; i++) {
+        uint8_t properties = irOpcodeInfo[fn->code[i].op].properties;
+        if (properties & (IRF_SIDE_EFFECT | IRF_MAY_TRAP)) {
+            live[i] = 1;
+            worklist[top++] = i;
+        }
+    }
+    while (top) {
+        IrInstr *instr = &fn->code[worklist[--top]];
+        VReg uses[3];
+        int count = irUses(instr, uses);
+        for (int k = 0; k < count; k++) {
+            uint32_t def = defs[uses[k]];
+            if (def != OPT_NONE && !live[def]) {
+                live[def] = 1;
+                worklist[top++] = def;
+            }
+        }
+        for (uint32_t k = 0; instr->op == IR_PHI && k < instr->src2; k++) {
+            uint32_t def = defs[fn->phiOperands[instr->src1 + k].value];
+            if (def != OPT_NONE && !live[def]) {
+                live[def] = 1;
+                worklist[top++] = def;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < fn->count; i++) {
+        if (!live[i] && fn->code[i].op != IR_NOP) {
+            fn->code[i].op = IR_NOP;
+            removed++;
+        }
+    }
+    optCompact(fn);
+    free(defs);
+    free(live);
+    free(worklist);
+    return removed;
+}
+
+// ---------------------------------------------------------------------------
+// Saída da SSA
+// ---------------------------------------------------------------------------
+
+// Função para remover desvios para o rótulo seguinte e rótulos sem referência
+// (fora da SSA os blocos não precisam mais começar com um rótulo)
+void optCleanupJumps(IrFunction *fn) {
+    for (int changed = 1; changed;) {
+        changed = 0;
+        uint8_t *referenced = optCalloc(fn->labelCount, 1);
+        for (uint32_t i = 0; i < fn->count; i++) {
+            const IrInstr *instr = &fn->code[i];
+            if (instr->op == IR_JUMP) {
+                referenced[instr->src1] = 1;
+            } else if (instr->op == IR_JUMP_IF || instr->op == IR_JUMP_IFNOT) {
+                referenced[instr->src2] = 1;
+            }
+        }
+        for (uint32_t i = 0; i < fn->count; i++) {
+            IrInstr *instr = &fn->code[i];
+            if (instr->op == IR_LABEL && !referenced[instr->src1]) {
+                instr->op = IR_NOP;
+                changed = 1;
+            }
+        }
+        optCompact(fn);
+        for (uint32_t i = 0; i + 1 < fn->count; i++) {
+            IrInstr *instr = &fn->code[i];
+            const IrInstr *next = &fn->code[i + 1];
+            uint32_t target = instr->op == IR_JUMP ? instr->src1 : instr->src2;
+            if ((irOpcodeInfo[instr->op].properties & IRF_BRANCH) && instr->op != IR_RET &&
+                next->op == IR_LABEL && next->src1 == target) {
+                instr->op = IR_NOP;
+                changed = 1;
+            }
+        }
+        optCompact(fn);
+        free(referenced);
+    }
+}
+
+// Função que indica se o phi pode receber as cópias diretamente no seu registrador: cada
+// predecessor tem um único sucessor (a cópia não vaza para outro caminho), o desvio final
+// não lê o registrador e nenhum operando é outro phi do bloco (ordem das cópias)
+int ssaCoalescible(const Cfg *cfg, const IrFunction *fn, const IrInstr *phi, const uint32_t *phiBlock, uint32_t block) {
+    for (uint32_t k = 0; k < phi->src2; k++) {
+        const IrPhiOperand *operand = &fn->phiOperands[phi->src1 + k];
+        const BasicBlock *pred = &cfg->blocks[cfg->labelBlock[operand->label]];
+        if (pred->succCount != 1 || (operand->value != phi->dst && phiBlock[operand->value] == block + 1)) {
+            return 0;
+        }
+        VReg uses[3];
+        int count = irUses(&fn->code[pred->end - 1], uses);
+        for (int u = 0; u < count; u++) {
+            if (uses[u] == phi->dst) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+// Função para substituir os phi por cópias; devolve o número de cópias inseridas
+uint32_t ssaDestruct(IrFunction *fn) {
+    Cfg cfg = {0};
+    cfgBuild(&cfg, fn);
+
+    // Bloco (+1) em que cada registrador é definido por um phi
+    uint32_t *phiBlock = optCalloc(fn->vregCount, sizeof(uint32_t));
+    for (uint32_t b = 0; b < cfg.count; b++) {
+        for (uint32_t i = cfg.blocks[b].start + 1; i < cfg.blocks[b].end && fn->code[i].op == IR_PHI; i++) {
+            phiBlock[fn->code[i].dst] = b + 1;
+        }
+    }
+
+    // Cópias para registradores novos primeiro: leem os valores antes das cópias diretas
+    OptInsertion *insertions = NULL, *direct = NULL;
+    uint32_t count = 0, capacity = 0, directCount = 0, directCapacity = 0;
+    for (uint32_t b = 0; b < cfg.count; b++) {
+        for (uint32_t i = cfg.blocks[b].start + 1; i < cfg.blocks[b].end && fn->code[i].op == IR_PHI; i++) {
+            IrInstr *phi = &fn->code[i];
+            if (ssaCoalescible(&cfg, fn, phi, phiBlock, b)) {
+                for (uint32_t k = 0; k < phi->src2; k++) {
+                    const IrPhiOperand *operand = &fn->phiOperands[phi->src1 + k];
+                    if (operand->value == phi->dst) {
+                        continue;
+                    }
+                    direct = vectorGrow(direct, &directCapacity, directCount + 1, sizeof(OptInsertion));
+                    direct[directCount].block = cfg.labelBlock[operand->label];
+                    direct[directCount++].instr = (IrInstr){IR_MOV, phi->type, 0, phi->dst, operand->value, 0};
+                }
+                phi->op = IR_NOP;
+                continue;
+            }
+            // Um registrador novo por phi: cada predecessor copia para ele e o phi vira uma cópia
+            VReg temp = irNewVreg(fn, phi->type);
+            for (uint32_t k = 0; k < phi->src2; k++) {
+                const IrPhiOperand *operand = &fn->phiOperands[phi->src1 + k];
+                insertions = vectorGrow(insertions, &capacity, count + 1, sizeof(OptInsertion));
+                insertions[count].block = cfg.labelBlock[operand->label];
+                insertions[count++].instr = (IrInstr){IR_MOV, phi->type, 0, temp, operand->value, 0};
+            }
+            *phi = (IrInstr){IR_MOV, phi->type, 0, phi->dst, temp, 0};
+        }
+    }
+    if (count + directCount) {
+        insertions = vectorGrow(insertions, &capacity, count + directCount, sizeof(OptInsertion));
+        memcpy(insertions + count, direct, directCount * sizeof(OptInsertion));
+        count += directCount;
+        optInsertAtBlockEnds(fn, &cfg, insertions, count);
+    }
+    fn->phiOperandCount = 0;
+    free(insertions);
+    free(direct);
+    free(phiBlock);
+    cfgFree(&cfg);
+    optCleanupJumps(fn);
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// Sequência de passos
+// ---------------------------------------------------------------------------
+
+// Função para medir o tempo em milissegundos
+double optNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+// Função para executar um passo sobre uma função, acumulando as estatísticas
+void optRunPass(IrFunction *fn, OptPass pass, OptStats *stats) {
+    uint32_t before = optInstructionCount(fn);
+    double start = optNow();
+    uint32_t changes = 0;
+    switch (pass) {
+        case PASS_SSA: changes = ssaConstruct(fn); break;
+        case PASS_CONSTANTS: changes = optConstants(fn); break;
+        case PASS_CSE: changes = optCommonSubexpressions(fn); break;
+        case PASS_LICM: changes = optLoopInvariants(fn); break;
+        case PASS_DCE: changes = optDeadCode(fn); break;
+        case PASS_OUT_OF_SSA: changes = ssaDestruct(fn); break;
+        default: break;
+    }
+    stats->milliseconds[pass] += optNow() - start;
+    stats->before[pass] += before;
+    stats->after[pass] += optInstructionCount(fn);
+    stats->changes[pass] += changes;
+}
+
+// Função para otimizar uma função; com keepSsa = 1 o resultado fica na forma SSA
+void optimizeFunction(IrFunction *fn, OptStats *stats, int keepSsa) {
+    optRunPass(fn, PASS_SSA, stats);
+    optRunPass(fn, PASS_CONSTANTS, stats);
+    optRunPass(fn, PASS_LICM, stats);
+    optRunPass(fn, PASS_CSE, stats);
+    optRunPass(fn, PASS_DCE, stats);
+    if (!keepSsa) {
+        optRunPass(fn, PASS_OUT_OF_SSA, stats);
+    }
+}
+
+// Função para otimizar todas as funções do módulo
+void optimizeModule(IrModule *module, OptStats *stats, int keepSsa) {
+    memset(stats, 0, sizeof(*stats));
+    for (uint32_t i = 0; i < module->functionCount; i++) {
+        optimizeFunction(&module->functions[i], stats, keepSsa);
+    }
+}
+
+// Função para somar as estatísticas de 'part' em 'total'
+void optAddStats(OptStats *total, const OptStats *part) {
+    for (int pass = 0; pass < PASS_COUNT; pass++) {
+        total->milliseconds[pass] += part->milliseconds[pass];
+        total->before[pass] += part->before[pass];
+        total->after[pass] += part->after[pass];
+        total->changes[pass] += part->changes[pass];
+    }
+}
+
+// Função para exibir as estatísticas dos passos
+void optPrintStats(FILE *out, const OptStats *stats) {
+    double total = 0;
+    fprintf(out, "%-22s %12s %12s %12s %12s\n", "Passo", "Tempo (ms)", "Antes", "Depois", "Alterações");
+    for (int pass = 0; pass < PASS_COUNT; pass++) {
+        if (!stats->before[pass] && !stats->after[pass]) {
+            continue;
+        }
+        // %-*s conta bytes; compensa os acentos em UTF-8 do nome
+        const char *name = optPassNames[pass];
+        int extra = 0;
+        for (const char *c = name; *c; c++) {
+            extra += ((unsigned char)*c & 0xC0) == 0x80;
+        }
+        fprintf(out, "%-*s %12.3f %12llu %12llu %12llu\n", 22 + extra, name, stats->milliseconds[pass],
+                (unsigned long long)stats->before[pass], (unsigned long long)stats->after[pass],
+                (unsigned long long)stats->changes[pass]);
+        total += stats->milliseconds[pass];
+    }
+    fprintf(out, "%-22s %12.3f\n", "Total", total);
+}
+
+#endif
@@ -0,0 +1,284 @@
+/*
+ * Pipeline léxico -> sintático em duas threads
+ *
+ * O analisador léxico roda em uma thread produtora e grava os tokens
+ * diretamente em lotes de um anel SPSC (um produtor, um consumidor) sem
+ * travas; o analisador sintático consome os lotes em outra thread enquanto
+ * o restante do arquivo ainda está sendo lido.
+ *
+ * Estruturas principais:
+ * - TokenBatch: Lote de PIPELINE_BATCH_TOKENS tokens. Com 128 tokens de
+ *   112 bytes (~14 KB) por lote e 8 lotes no anel (~112 KB), o anel inteiro
+ *   cabe na cache L2 de cada núcleo enquanto os dados passam de um para o outro
+ * - TokenRing: Anel de lotes; 'head' é escrito só pelo produtor e 'tail' só
+ *   pelo consumidor, em linhas de cache separadas
+ * - Pipeline: Anel e janela do consumidor. A janela copia cada lote para um
+ *   bloco de endereço estável e devolve o lote ao anel imediatamente; os
+ *   blocos são reciclados quando o analisador sintático libera os tokens
+ *
+ * Por que copiar em vez de analisar nos lotes do anel: o analisador
+ * sintático só libera os tokens no início de cada comando ou declaração e,
+ * até lá, guarda ponteiros para eles (lookahead), e um comando pode ter
+ * mais tokens do que o anel inteiro (uma expressão ou um inicializador
+ * longo). Segurando os lotes, o consumidor esperaria por tokens que o
+ * produtor não consegue gravar com o anel cheio. A cópia é sequencial, de
+ * um lote que acabou de passar pela cache: em um arquivo de 10 milhões de
+ * tokens, fazer três cópias em vez de uma não mudou o tempo além da
+ * variação entre execuções.
+ *
+ * Contrapressão: quando o anel está cheio o produtor espera (pausa curta e
+ * depois sched_yield) até o consumidor liberar um lote, então a memória em
+ * uso fica limitada ao anel mais a janela do comando sendo analisado,
+ * independentemente do tamanho do arquivo.
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include "analise sintatica.h"
+
+#define PIPELINE_BATCH_TOKENS 128
+#define PIPELINE_RING_SLOTS 8
+#define PIPELINE_SPIN_LIMIT 64
+
+// Estrutura de um lote de tokens
+typedef struct {
+    Token tokens[PIPELINE_BATCH_TOKENS];
+    int count;
+} TokenBatch;
+
+// Estrutura do anel SPSC
+typedef struct {
+    TokenBatch slots[PIPELINE_RING_SLOTS];
+    alignas(64) atomic_size_t head;   // Lotes publicados (produtor)
+    alignas(64) atomic_size_t tail;   // Lotes devolvidos (consumidor)
+    alignas(64) atomic_int done;      // Produtor terminou
+} TokenRing;
+
+// Estrutura do pipeline
+typedef struct {
+    TokenRing ring;
+    const char *code;
+
+    // Lado do produtor
+    size_t produceSlot;
+    int producing;
+    long producerWaits;   // Vezes em que o anel estava cheio
+
+    // Lado do consumidor (janela de blocos com endereço estável)
+    Token **chunks;       // chunks[i] guarda os tokens do bloco chunkBase + i
+    int chunkBase;
+    int chunkCount;
+    int chunkCapacity;
+    Token **freeChunks;   // Blocos liberados, reaproveitados sem malloc
+    int freeCount;
+    int available;        // Tokens já recebidos (índice absoluto)
+    int finished;
+    long consumerWaits;   // Vezes em que o anel estava vazio
+    long batches;
+    int peakChunks;       // Maior janela usada, em blocos
+} Pipeline;
+
+// Função de espera: pausa curta nas primeiras tentativas e depois cede o núcleo
+void pipelineBackoff(int *spins) {
+    if (++*spins < PIPELINE_SPIN_LIMIT) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    } else {
+        sched_yield();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Produtor (analisador léxico)
+// ---------------------------------------------------------------------------
+
+// Função para esperar até haver um lote livre para o produtor
+void pipelineWaitForSpace(Pipeline *pl) {
+    int spins = 0;
+    if (pl->produceSlot - atomic_load_explicit(&pl->ring.tail, memory_order_acquire) >= PIPELINE_RING_SLOTS) {
+        pl->producerWaits++;
+        while (pl->produceSlot - atomic_load_explicit(&pl->ring.tail, memory_order_acquire) >= PIPELINE_RING_SLOTS) {
+            pipelineBackoff(&spins);
+        }
+    }
+}
+
+// Função para publicar o lote atual ao consumidor
+void pipelinePublish(Pipeline *pl) {
+    atomic_store_explicit(&pl->ring.head, ++pl->produceSlot, memory_order_release);
+}
+
+// Função usada como tokenSink: devolve a posição do próximo token no lote atual
+Token *pipelineNextToken(void *context) {
+    Pipeline *pl = context;
+    TokenBatch *batch = &pl->ring.slots[pl->produceSlot % PIPELINE_RING_SLOTS];
+
+    if (pl->producing && batch->count == PIPELINE_BATCH_TOKENS) {
+        pipelinePublish(pl);
+        pl->producing = 0;
+        batch = &pl->ring.slots[pl->produceSlot % PIPELINE_RING_SLOTS];
+    }
+    if (!pl->producing) {
+        pipelineWaitForSpace(pl);
+        batch->count = 0;
+        pl->producing = 1;
+    }
+    return &batch->tokens[batch->count++];
+}
+
+// Função da thread produtora: executa a análise léxica e sinaliza o fim
+void *pipelineProducer(void *context) {
+    Pipeline *pl = context;
+    lexTokens(pl->code);   // sourceCode e o índice de linhas já foram reiniciados pelo consumidor
+    if (pl->producing && pl->ring.slots[pl->produceSlot % PIPELINE_RING_SLOTS].count > 0) {
+        pipelinePublish(pl);
+    }
+    pl->producing = 0;
+    atomic_store_explicit(&pl->ring.done, 1, memory_order_release);
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Consumidor (analisador sintático)
+// ---------------------------------------------------------------------------
+
+// Função para obter um bloco livre para a janela
+Token *pipelineTakeChunk(Pipeline *pl) {
+    if (pl->freeCount > 0) {
+        return pl->freeChunks[--pl->freeCount];
+    }
+    Token *chunk = malloc(PIPELINE_BATCH_TOKENS * sizeof(Token));
+    if (!chunk) {
+        fprintf(stderr, "Erro: Falha ao alocar a janela de tokens.\n");
+        exit(EXIT_FAILURE);
+    }
+    return chunk;
+}
+
+// Função para receber o próximo lote do anel; devolve 0 quando o fluxo acabou
+int pipelineReceive(Pipeline *pl) {
+    size_t tail = atomic_load_explicit(&pl->ring.tail, memory_order_relaxed);
+    int spins = 0;
+
+    if (tail == atomic_load_explicit(&pl->ring.head, memory_order_acquire)) {
+        pl->consumerWaits++;
+        while (tail == atomic_load_explicit(&pl->ring.head, memory_order_acquire)) {
+            if (atomic_load_explicit(&pl->ring.done, memory_order_acquire) &&
+                tail == atomic_load_explicit(&pl->ring.head, memory_order_acquire)) {
+                pl->finished = 1;
+                return 0;
+            }
+            pipelineBackoff(&spins);
+        }
+    }
+
+    // Copia o lote para a janela e devolve-o ao produtor
+    const TokenBatch *batch = &pl->ring.slots[tail % PIPELINE_RING_SLOTS];
+    if (pl->chunkCount >= pl->chunkCapacity) {
+        pl->chunkCapacity = pl->chunkCapacity ? pl->chunkCapacity * 2 : 8;
+        pl->chunks = realloc(pl->chunks, pl->chunkCapacity * sizeof(Token *));
+        pl->freeChunks = realloc(pl->freeChunks, pl->chunkCapacity * sizeof(Token *));
+        if (!pl->chunks || !pl->freeChunks) {
+            fprintf(stderr, "Erro: Falha ao alocar a janela de tokens.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    Token *chunk = pipelineTakeChunk(pl);
+    memcpy(chunk, batch->tokens, batch->count * sizeof(Token));
+    pl->chunks[pl->chunkCount++] = chunk;
+    pl->available += batch->count;
+    pl->batches++;
+    if (pl->chunkCount > pl->peakChunks) {
+        pl->peakChunks = pl->chunkCount;
+    }
+    atomic_store_explicit(&pl->ring.tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+// Função usada como fetchToken do analisador sintático
+const Token *pipelineFetch(void *context, int index) {
+    Pipeline *pl = context;
+    while (index >= pl->available) {
+        if (pl->finished || !pipelineReceive(pl)) {
+            return NULL;
+        }
+    }
+    // Todos os lotes, exceto o último, estão cheios
+    return &pl->chunks[index / PIPELINE_BATCH_TOKENS - pl->chunkBase][index % PIPELINE_BATCH_TOKENS];
+}
+
+// Função usada como releaseTokens: recicla os blocos inteiramente antes de 'index'
+void pipelineRelease(void *context, int index) {
+    Pipeline *pl = context;
+    int releasable = index / PIPELINE_BATCH_TOKENS - pl->chunkBase;
+    if (releasable <= 0) {
+        return;
+    }
+    if (releasable > pl->chunkCount) {
+        releasable = pl->chunkCount;
+    }
+    for (int i = 0; i < releasable; i++) {
+        pl->freeChunks[pl->freeCount++] = pl->chunks[i];
+    }
+    memmove(pl->chunks, pl->chunks + releasable, (pl->chunkCount - releasable) * sizeof(Token *));
+    pl->chunkCount -= releasable;
+    pl->chunkBase += releasable;
+}
+
+// Função principal do pipeline: analisa 'code' com o léxico e o sintático em paralelo
+NodeId pipelineParse(Pipeline *pl, Parser *parser, Ast *ast, const char *code) {
+    pthread_t producer;
+
+    memset(pl, 0, sizeof(*pl));
+    pl->code = code;
+    tokenCount = 0;
+    tokenSink = pipelineNextToken;
+    tokenSinkContext = pl;
+
+    // O índice de linhas é reiniciado antes de o consumidor poder consultá-lo
+    sourceCode = code;
+    freeLineIndex();
+
+    parserInit(parser, ast, NULL, 0);
+    parser->fetchToken = pipelineFetch;
+    parser->releaseTokens = pipelineRelease;
+    parser->streamContext = pl;
+
+    if (pthread_create(&producer, NULL, pipelineProducer, pl) != 0) {
+        fprintf(stderr, "Erro: Falha ao criar a thread do analisador léxico.\n");
+        exit(EXIT_FAILURE);
+    }
+    NodeId root = parseProgram(parser);
+
+    // Esvazia o anel caso a análise termine antes do fim do fluxo
+    while (pipelineReceive(pl)) {
+        pipelineRelease(pl, pl->available);
+    }
+    pthread_join(producer, NULL);
+    tokenCount = pl->available;   // A contagem do produtor fica na sua própria thread
+    tokenSink = NULL;
+    tokenSinkContext = NULL;
+    return root;
+}
+
+// Função para liberar a janela do pipeline
+void pipelineFree(Pipeline *pl) {
+    for (int i = 0; i < pl->chunkCount; i++) {
+        free(pl->chunks[i]);
+    }
+    for (int i = 0; i < pl->freeCount; i++) {
+        free(pl->freeChunks[i]);
+    }
+    free(pl->chunks);
+    free(pl->freeChunks);
+    pl->chunks = pl->freeChunks = NULL;
+    pl->chunkCount = pl->freeCount = 0;
+}
+
+#endif
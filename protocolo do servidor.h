@@ -0,0 +1,175 @@
+/*
+ * Protocolo do servidor de compilação
+ *
+ * Cliente e servidor conversam por um socket Unix local (SOCK_STREAM) com
+ * quadros de tamanho explícito. Cada quadro tem um cabeçalho fixo de 12
+ * bytes seguido de 'length' bytes de conteúdo:
+ *
+ *   magic (4 bytes, "CMP1") | type (4 bytes) | length (4 bytes)
+ *
+ * Uma conversa:
+ * - Cliente: FRAME_REQUEST com o diretório atual e os argumentos, cada um
+ *   terminado em '\0' (os caminhos relativos são resolvidos no diretório do
+ *   cliente)
+ * - Servidor: zero ou mais FRAME_STDOUT e FRAME_STDERR com a saída do
+ *   comando e, por último, FRAME_EXIT com o código de saída (int32). Uma
+ *   saída maior que um quadro vem em vários quadros do mesmo tipo, que o
+ *   cliente concatena
+ *
+ * Os inteiros estão na ordem de bytes da máquina: cliente e servidor rodam
+ * sempre na mesma máquina.
+ *
+ * O socket padrão fica em um diretório só do usuário: $XDG_RUNTIME_DIR ou,
+ * sem ele, /tmp/compilador-<uid> (criado com modo 0700 e recusado se for de
+ * outro usuário ou aberto aos demais), para que outro usuário não possa
+ * criar o socket no lugar do servidor. O cliente ainda confere, com
+ * SO_PEERCRED, que o servidor roda com o seu uid.
+ *
+ * Este cabeçalho não depende do compilador, para que o cliente continue
+ * pequeno.
+ */
+
+#ifndef PROTOCOLO_DO_SERVIDOR_H
+#define PROTOCOLO_DO_SERVIDOR_H
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define FRAME_MAGIC 0x31504D43u            // "CMP1"
+#define FRAME_MAX_LENGTH (64u << 20)
+#define SERVER_SOCKET_VARIABLE "COMPILADOR_SOCKET"
+#define SERVER_SOCKET_NAME "compilador.sock"
+
+// Tipos de quadro
+typedef enum {
+    FRAME_REQUEST = 1,
+    FRAME_STDOUT,
+    FRAME_STDERR,
+    FRAME_EXIT
+} FrameType;
+
+// Estrutura do cabeçalho de um quadro
+typedef struct {
+    uint32_t magic;
+    uint32_t type;
+    uint32_t length;
+} FrameHeader;
+
+// Função para obter o diretório /tmp/compilador-<uid>, criado com modo 0700 se ainda não existir; devolve -1 se
+// ele não for um diretório do usuário fechado para os demais
+int serverPrivateDirectory(char *path, size_t size) {
+    struct stat info;
+    snprintf(path, size, "/tmp/compilador-%u", (unsigned)getuid());
+    if (mkdir(path, 0700) != 0 && errno != EEXIST) {
+        perror("Erro ao criar o diretório do socket");
+        return -1;
+    }
+    if (lstat(path, &info) != 0 || !S_ISDIR(info.st_mode) || info.st_uid != getuid() || (info.st_mode & 077)) {
+        fprintf(stderr, "Erro: %s não é um diretório privado deste usuário\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// Função para obter o caminho do socket: --socket, a variável de ambiente, $XDG_RUNTIME_DIR/compilador.sock ou
+// /tmp/compilador-<uid>/compilador.sock; devolve -1 se o diretório padrão não for seguro
+int serverSocketPath(char *path, size_t size, const char *option) {
+    const char *variable = getenv(SERVER_SOCKET_VARIABLE), *runtime = getenv("XDG_RUNTIME_DIR");
+    char directory[64];
+    if (option) {
+        snprintf(path, size, "%s", option);
+    } else if (variable && *variable) {
+        snprintf(path, size, "%s", variable);
+    } else if (runtime && *runtime) {
+        snprintf(path, size, "%s/%s", runtime, SERVER_SOCKET_NAME);
+    } else if (serverPrivateDirectory(directory, sizeof(directory)) == 0) {
+        snprintf(path, size, "%s/%s", directory, SERVER_SOCKET_NAME);
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+// Função para preencher o endereço do socket; devolve -1 se o caminho for longo demais
+int serverAddress(struct sockaddr_un *address, const char *path) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address->sun_path)) {
+        fprintf(stderr, "Erro: caminho do socket longo demais (%s)\n", path);
+        return -1;
+    }
+    strcpy(address->sun_path, path);
+    return 0;
+}
+
+// Função para escrever exatamente 'size' bytes; devolve 0 em caso de sucesso
+int frameWriteAll(int fd, const void *bytes, size_t size) {
+    const char *p = bytes;
+    while (size) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+// Função para ler exatamente 'size' bytes; devolve 0 em caso de sucesso (-1 no fim ou em erro)
+int frameReadAll(int fd, void *bytes, size_t size) {
+    char *p = bytes;
+    while (size) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+// Função para enviar um quadro; devolve 0 em caso de sucesso
+int frameSend(int fd, FrameType type, const void *payload, uint32_t length) {
+    FrameHeader header = {FRAME_MAGIC, (uint32_t)type, length};
+    if (frameWriteAll(fd, &header, sizeof(header)) != 0) {
+        return -1;
+    }
+    return length ? frameWriteAll(fd, payload, length) : 0;
+}
+
+// Função para receber um quadro; o conteúdo (terminado em '\0') deve ser liberado com free. Devolve 0 em caso de sucesso
+int frameReceive(int fd, FrameType *type, char **payload, uint32_t *length) {
+    FrameHeader header;
+    *payload = NULL;
+    if (frameReadAll(fd, &header, sizeof(header)) != 0 || header.magic != FRAME_MAGIC ||
+        header.length > FRAME_MAX_LENGTH) {
+        return -1;
+    }
+    char *bytes = malloc((size_t)header.length + 1);
+    if (!bytes || (header.length && frameReadAll(fd, bytes, header.length) != 0)) {
+        free(bytes);
+        return -1;
+    }
+    bytes[header.length] = '\0';
+    *type = (FrameType)header.type;
+    *payload = bytes;
+    *length = header.length;
+    return 0;
+}
+
+#endif
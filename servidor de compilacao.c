@@ -0,0 +1,155 @@
+/*
+ * Programa do servidor de compilação
+ *
+ * Fica em execução escutando um socket Unix e atende os pedidos do cliente
+ * (cliente de compilacao.c) mantendo em memória os tokens, as ASTs e as
+ * mensagens dos arquivos já vistos (servidor de compilacao.h). Um pedido
+ * repetido sobre um arquivo que não mudou não relê, não reanalisa e não
+ * reconstrói nada antes da geração de código.
+ *
+ * Opções:
+ * - --socket <caminho>: caminho do socket (padrão: variável de ambiente
+ *   COMPILADOR_SOCKET, $XDG_RUNTIME_DIR/compilador.sock ou
+ *   /tmp/compilador-<uid>/compilador.sock)
+ * - --segundo-plano: desliga-se do terminal e continua em segundo plano
+ *
+ * O servidor termina com o comando 'parar' do cliente ou com SIGINT/SIGTERM.
+ */
+
+#define _GNU_SOURCE   // memfd_create
+#include <signal.h>
+#include "servidor de compilacao.h"
+
+// Sinal de término recebido
+static volatile sig_atomic_t interrupted = 0;
+
+// Função para tratar SIGINT e SIGTERM
+void handleSignal(int signal) {
+    (void)signal;
+    interrupted = 1;
+}
+
+// Função para passar o processo para o segundo plano; devolve 0 no processo filho
+int daemonize(void) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("Erro ao criar o processo do servidor");
+        return -1;
+    }
+    if (pid > 0) {
+        _exit(EXIT_SUCCESS);
+    }
+    setsid();
+    int null = open("/dev/null", O_RDWR);
+    if (null >= 0) {
+        dup2(null, STDIN_FILENO);
+        dup2(null, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        if (null > STDERR_FILENO) {
+            close(null);
+        }
+    }
+    return 0;
+}
+
+// Função para criar o socket de escuta; devolve o descritor ou -1
+int listenSocket(const char *path) {
+    struct sockaddr_un address;
+    if (serverAddress(&address, path) != 0) {
+        return -1;
+    }
+
+    // Um servidor já em execução responde à conexão; um socket que não responde ficou de uma execução anterior
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe >= 0 && connect(probe, (struct sockaddr *)&address, sizeof(address)) == 0) {
+        fprintf(stderr, "Erro: já existe um servidor em execução (%s)\n", path);
+        close(probe);
+        return -1;
+    }
+    if (probe >= 0) {
+        close(probe);
+    }
+    unlink(path);
+
+    // O socket já nasce com modo 0600 (sem intervalo entre o bind e um chmod)
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    mode_t mask = umask(0077);
+    int bound = fd >= 0 && bind(fd, (struct sockaddr *)&address, sizeof(address)) == 0;
+    umask(mask);
+    if (!bound || listen(fd, 64) != 0) {
+        perror("Erro ao criar o socket do servidor");
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+// Função principal
+int main(int argc, char *argv[]) {
+    const char *socketOption = NULL;
+    int background = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketOption = argv[++i];
+        } else if (strcmp(argv[i], "--segundo-plano") == 0) {
+            background = 1;
+        } else {
+            fprintf(stderr, "Uso: %s [--socket <caminho>] [--segundo-plano]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Caminho absoluto: o servidor trabalha a partir de '/' e remove o socket ao terminar
+    char option[512], cwd[PATH_MAX], path[PATH_MAX + 512];
+    if (serverSocketPath(option, sizeof(option), socketOption) != 0) {
+        return EXIT_FAILURE;
+    }
+    if (option[0] != '/' && getcwd(cwd, sizeof(cwd))) {
+        snprintf(path, sizeof(path), "%s/%s", cwd, option);
+    } else {
+        snprintf(path, sizeof(path), "%s", option);
+    }
+    int listener = listenSocket(path);
+    if (listener < 0) {
+        return EXIT_FAILURE;
+    }
+    printf("Servidor de compilação em %s\n", path);
+    fflush(stdout);
+    if (background && daemonize() != 0) {
+        unlink(path);
+        return EXIT_FAILURE;
+    }
+
+    // Sem SA_RESTART: o sinal interrompe o accept
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleSignal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);   // Cliente que desconecta no meio da resposta
+    if (chdir("/") != 0) {
+        perror("Erro ao mudar de diretório");
+    }
+
+    Server server;
+    serverInit(&server);
+    while (!server.stop && !interrupted) {
+        int client = accept(listener, NULL, NULL);
+        if (client < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Erro ao aceitar uma conexão");
+            break;
+        }
+        serverHandle(&server, client);
+        close(client);
+    }
+
+    close(listener);
+    unlink(path);
+    serverFree(&server);
+    return EXIT_SUCCESS;
+}
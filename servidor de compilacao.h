@@ -0,0 +1,575 @@
+/*
+ * Servidor de compilação
+ *
+ * Mantém o estado do compilador entre os pedidos de um sistema de build,
+ * que chama o compilador milhares de vezes quase sempre com os mesmos
+ * arquivos. Os pedidos chegam pelo protocolo de protocolo do servidor.h e
+ * são atendidos um de cada vez (a compilação em si usa as threads de
+ * compilacao paralela.h).
+ *
+ * Estado mantido entre os pedidos:
+ * - CachedPath: Caminho absoluto -> (dispositivo, inode, tamanho, data de
+ *   modificação) e conteúdo. Se o stat não mudou, o arquivo nem é lido de
+ *   novo (como o modo direto do ccache)
+ * - CacheEntry: Conteúdo (chave: hash FNV-1a de 64 bits e tamanho,
+ *   conferidos com memcmp) -> tokens, pares de chaves, índice de linhas e,
+ *   depois do primeiro 'compilar', a AST já verificada pela análise
+ *   semântica e as mensagens que as análises escreveram. Arquivos
+ *   idênticos em caminhos diferentes compartilham a entrada. Os tokens
+ *   ficam compactados (fluxo de tokens.h, cerca de 3 bytes por token em
+ *   vez de sizeof(Token)) e são decodificados em uma lista de rascunho do
+ *   servidor só quando um pedido precisa deles: 'lexico' e a primeira
+ *   análise do conteúdo
+ *
+ * Comandos (o primeiro argumento do pedido):
+ * - lexico <arquivo>: lista os tokens, como o programa analise lexica
+ * - compilar [--saida <nome>] [--sem-otimizacao] [--threads <n>] <arquivo>:
+ *   gera <nome>.o (padrão: programa.o), como codigo de maquina, sem a
+ *   ligação com o runtime
+ * - estado: estatísticas do cache
+ * - limpar: esvazia o cache
+ * - parar: encerra o servidor depois de responder
+ *
+ * A saída do comando é capturada redirecionando stdout e stderr para
+ * arquivos em memória (memfd) durante o pedido, então as funções do
+ * compilador escrevem exatamente o que escreveriam na linha de comando.
+ * Os caminhos relativos são resolvidos no diretório do cliente.
+ *
+ * Limitações:
+ * - Um erro fatal do compilador (exit em falta de memória) encerra o servidor
+ */
+
+#ifndef SERVIDOR_DE_COMPILACAO_H
+#define SERVIDOR_DE_COMPILACAO_H
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "compilacao paralela.h"
+#include "fluxo de tokens.h"
+#include "protocolo do servidor.h"
+
+#define CACHE_MAX_ENTRIES 256
+#define CACHE_MAX_PATHS 4096
+#define SERVER_MAX_ARGUMENTS 64
+#define SERVER_OUTPUT_CHUNK (1u << 20)   // Bytes por quadro de saída (no máximo FRAME_MAX_LENGTH)
+
+// Estrutura de um arquivo já visto
+typedef struct {
+    char *path;                // Caminho absoluto
+    uint64_t pathHash;
+    dev_t device;
+    ino_t inode;
+    off_t size;
+    struct timespec modified;
+    uint64_t hash;             // Conteúdo
+    uint32_t length;
+    SourceEncoding encoding;   // Codificação do arquivo antes da conversão para UTF-8
+} CachedPath;
+
+// Estrutura de um conteúdo analisado
+typedef struct {
+    uint64_t hash;
+    uint32_t length;
+    char *code;
+    TokenStream stream;        // Tokens compactados
+    Token *tokens;             // Só se a compactação falhar
+    int tokenCount;
+    int *braceMatch;
+    int *lineStarts;
+    int lineCount;
+    int analyzed;              // Análises sintática e semântica feitas (AST válida)
+    Ast ast;
+    int syntaxErrors;
+    int semanticErrors;
+    char *diagnostics[2];      // Texto que as análises escreveram em stdout e stderr
+    uint32_t diagnosticLength[2];
+    uint64_t lastUse;
+} CacheEntry;
+
+// Estrutura do servidor
+typedef struct {
+    CacheEntry *entries;
+    uint32_t entryCount;
+    CachedPath *paths;
+    uint32_t pathCount;
+    uint64_t clock;            // Contador de uso (LRU)
+    uint64_t requests;
+    uint64_t unchanged;        // Arquivo não relido (stat igual)
+    uint64_t reused;           // Arquivo relido, conteúdo já analisado
+    uint64_t misses;
+    uint64_t evictions;
+    Token *scratch;            // Tokens decodificados para o pedido atual
+    int scratchCapacity;
+    uint64_t decodes;
+    double decodeMs;
+    double busyMs;
+    int stop;
+} Server;
+
+// Função para calcular o hash FNV-1a de 64 bits
+uint64_t serverHash(const void *bytes, size_t length) {
+    const uint8_t *p = bytes;
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ p[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// Função para inicializar o servidor
+void serverInit(Server *server) {
+    memset(server, 0, sizeof(*server));
+    server->entries = optCalloc(CACHE_MAX_ENTRIES, sizeof(CacheEntry));
+    server->paths = optCalloc(CACHE_MAX_PATHS, sizeof(CachedPath));
+}
+
+// Função para liberar uma entrada do cache
+void serverFreeEntry(CacheEntry *entry) {
+    free(entry->code);
+    tokenStreamFree(&entry->stream);
+    bigFree(entry->tokens);
+    bigFree(entry->braceMatch);
+    free(entry->lineStarts);
+    if (entry->analyzed) {
+        astFree(&entry->ast);
+    }
+    free(entry->diagnostics[0]);
+    free(entry->diagnostics[1]);
+    memset(entry, 0, sizeof(*entry));
+}
+
+// Função para esvaziar o cache
+void serverClear(Server *server) {
+    for (uint32_t i = 0; i < server->entryCount; i++) {
+        serverFreeEntry(&server->entries[i]);
+    }
+    for (uint32_t i = 0; i < server->pathCount; i++) {
+        free(server->paths[i].path);
+    }
+    server->entryCount = server->pathCount = 0;
+}
+
+// Função para liberar o servidor
+void serverFree(Server *server) {
+    serverClear(server);
+    free(server->scratch);
+    free(server->entries);
+    free(server->paths);
+}
+
+// Função para instalar uma entrada nas variáveis globais do analisador léxico (linha e coluna das mensagens)
+void serverInstall(const CacheEntry *entry) {
+    sourceCode = entry->code;
+    lineStarts = entry->lineStarts;
+    lineCount = entry->lineCount;
+}
+
+// Função para desligar as variáveis globais da entrada instalada (a memória é do cache)
+void serverUninstall(void) {
+    sourceCode = NULL;
+    lineStarts = NULL;
+    lineCount = 0;
+}
+
+// Função para procurar um conteúdo no cache
+CacheEntry *serverFindEntry(Server *server, uint64_t hash, uint32_t length, const char *code) {
+    for (uint32_t i = 0; i < server->entryCount; i++) {
+        CacheEntry *entry = &server->entries[i];
+        if (entry->hash == hash && entry->length == length && (!code || memcmp(entry->code, code, length) == 0)) {
+            entry->lastUse = ++server->clock;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Função para criar a entrada de um conteúdo novo (assume a posse de 'code'), descartando a menos usada se preciso
+CacheEntry *serverAddEntry(Server *server, char *code, uint64_t hash, uint32_t length) {
+    CacheEntry *entry;
+    if (server->entryCount < CACHE_MAX_ENTRIES) {
+        entry = &server->entries[server->entryCount++];
+    } else {
+        entry = &server->entries[0];
+        for (uint32_t i = 1; i < server->entryCount; i++) {
+            if (server->entries[i].lastUse < entry->lastUse) {
+                entry = &server->entries[i];
+            }
+        }
+        serverFreeEntry(entry);
+        server->evictions++;
+    }
+    entry->hash = hash;
+    entry->length = length;
+    entry->code = code;
+    entry->lastUse = ++server->clock;
+
+    // Tokens e índices passam das variáveis globais para a entrada
+    lexicalAnalysis(code);
+    buildLineIndex();
+    if (tokenStreamEncode(&entry->stream, tokens, tokenCount, code) == 0) {
+        bigFree(tokens);
+        entry->tokens = NULL;
+    } else {
+        entry->tokens = tokens;
+    }
+    entry->tokenCount = tokenCount;
+    entry->braceMatch = braceMatch;
+    entry->lineStarts = lineStarts;
+    entry->lineCount = lineCount;
+    bigFree(braceStack);
+    tokens = NULL;
+    braceMatch = braceStack = NULL;
+    tokenCount = tokenCapacity = 0;
+    serverUninstall();
+    return entry;
+}
+
+// Função para obter a entrada de um arquivo (relido só se o stat mudou) e, se 'encoding' não for NULL, a sua
+// codificação; devolve NULL se não puder ser lido
+CacheEntry *serverLoad(Server *server, const char *path, SourceEncoding *encoding) {
+    char absolute[PATH_MAX];
+    struct stat info;
+    if (!realpath(path, absolute) || stat(absolute, &info) != 0) {
+        perror("Erro ao abrir o arquivo");
+        return NULL;
+    }
+    uint64_t pathHash = serverHash(absolute, strlen(absolute));
+    CachedPath *record = NULL;
+    for (uint32_t i = 0; i < server->pathCount; i++) {
+        if (server->paths[i].pathHash == pathHash && strcmp(server->paths[i].path, absolute) == 0) {
+            record = &server->paths[i];
+            break;
+        }
+    }
+    if (record && record->device == info.st_dev && record->inode == info.st_ino && record->size == info.st_size &&
+        record->modified.tv_sec == info.st_mtim.tv_sec && record->modified.tv_nsec == info.st_mtim.tv_nsec) {
+        CacheEntry *entry = serverFindEntry(server, record->hash, record->length, NULL);
+        if (entry) {
+            server->unchanged++;
+            if (encoding) {
+                *encoding = record->encoding;
+            }
+            return entry;
+        }
+    }
+
+    long size;
+    SourceEncoding sourceEncoding;
+    char *code = readSourceFileEncoded(absolute, &size, &sourceEncoding);
+    if (!code) {
+        return NULL;
+    }
+    uint64_t hash = serverHash(code, (size_t)size);
+    if (!record) {
+        if (server->pathCount == CACHE_MAX_PATHS) {
+            // Tabela cheia: recomeça (os conteúdos continuam no cache)
+            for (uint32_t i = 0; i < server->pathCount; i++) {
+                free(server->paths[i].path);
+            }
+            server->pathCount = 0;
+        }
+        record = &server->paths[server->pathCount++];
+        record->path = strdup(absolute);
+        record->pathHash = pathHash;
+    }
+    record->device = info.st_dev;
+    record->inode = info.st_ino;
+    record->size = info.st_size;
+    record->modified = info.st_mtim;
+    record->hash = hash;
+    record->length = (uint32_t)size;
+    record->encoding = sourceEncoding;
+    if (encoding) {
+        *encoding = sourceEncoding;
+    }
+
+    CacheEntry *entry = serverFindEntry(server, hash, (uint32_t)size, code);
+    if (entry) {
+        server->reused++;
+        free(code);
+        return entry;
+    }
+    server->misses++;
+    return serverAddEntry(server, code, hash, (uint32_t)size);
+}
+
+// Função para ler um trecho de um descritor (arquivo em memória) a partir de 'start'
+char *serverReadRange(int fd, off_t start, off_t end, uint32_t *length) {
+    *length = end > start ? (uint32_t)(end - start) : 0;
+    char *text = malloc(*length + 1);
+    if (text && *length && pread(fd, text, *length, start) != (ssize_t)*length) {
+        *length = 0;
+    }
+    return text;
+}
+
+// Função para obter os tokens de uma entrada (decodificados na lista de rascunho, válida até o próximo pedido)
+const Token *serverTokens(Server *server, const CacheEntry *entry) {
+    if (entry->tokens) {
+        return entry->tokens;
+    }
+    if (entry->tokenCount > server->scratchCapacity) {
+        Token *grown = realloc(server->scratch, (size_t)entry->tokenCount * sizeof(Token));
+        if (!grown) {
+            fprintf(stderr, "Erro: Falha ao alocar a lista de tokens.\n");
+            exit(EXIT_FAILURE);
+        }
+        server->scratch = grown;
+        server->scratchCapacity = entry->tokenCount;
+    }
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    tokenStreamDecode(&entry->stream, entry->code, server->scratch);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    server->decodes++;
+    server->decodeMs += (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    return server->scratch;
+}
+
+// Função para executar as análises sintática e semântica (uma vez por conteúdo) ou repetir as suas mensagens
+void serverAnalyze(Server *server, CacheEntry *entry) {
+    if (entry->analyzed) {
+        fwrite(entry->diagnostics[0], 1, entry->diagnosticLength[0], stdout);
+        fwrite(entry->diagnostics[1], 1, entry->diagnosticLength[1], stderr);
+        return;
+    }
+    fflush(stdout);
+    fflush(stderr);
+    off_t start[2] = {lseek(STDOUT_FILENO, 0, SEEK_CUR), lseek(STDERR_FILENO, 0, SEEK_CUR)};
+
+    Parser parser;
+    astInit(&entry->ast, entry->code, entry->tokenCount);
+    parserInit(&parser, &entry->ast, serverTokens(server, entry), entry->tokenCount);
+    parseProgram(&parser);
+    entry->syntaxErrors = parser.errorCount;
+    if (!parser.errorCount) {
+        Checker checker;
+        entry->semanticErrors = semanticAnalysis(&checker, &entry->ast, NULL);
+    }
+    entry->analyzed = 1;
+
+    fflush(stdout);
+    fflush(stderr);
+    for (int stream = 0; stream < 2; stream++) {
+        int fd = stream ? STDERR_FILENO : STDOUT_FILENO;
+        entry->diagnostics[stream] = serverReadRange(fd, start[stream], lseek(fd, 0, SEEK_CUR),
+                                                     &entry->diagnosticLength[stream]);
+    }
+}
+
+// Função do comando 'lexico'; devolve o código de saída
+int serverLex(Server *server, int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "../input.txt";
+    SourceEncoding encoding;
+    CacheEntry *entry = serverLoad(server, path, &encoding);
+    if (!entry) {
+        return EXIT_FAILURE;
+    }
+    serverInstall(entry);
+    const Token *tokens = serverTokens(server, entry);
+    printf("Analisando código do arquivo: %s\n", path);
+    if (encoding != ENCODING_UTF8) {
+        printf("Codificação: %s, %s\n", encodingName(encoding),
+               encoding == ENCODING_UTF8_BOM ? "BOM removido" : "convertido para UTF-8");
+    }
+    printf("\nTokens encontrados:\n");
+    for (int i = 0; i < entry->tokenCount; i++) {
+        const Token *token = &tokens[i];
+        int line, column;
+        offsetToLocation(token->offset, &line, &column);
+        printf("Token: %-15s Linha: %-4d Coluna: %-4d Tipo: %-19s Tamanho: %-3d Byte\n",
+               token->value, line, column, tokenTypeToString(token->type), token->size);
+    }
+    serverUninstall();
+    return EXIT_SUCCESS;
+}
+
+// Função do comando 'compilar'; devolve o código de saída
+int serverCompile(Server *server, int argc, char **argv) {
+    const char *path = "../input.txt", *output = "programa";
+    int optimize = 1;
+    uint32_t threads = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--saida") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--sem-otimizacao") == 0) {
+            optimize = 0;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = (uint32_t)atoi(argv[++i]);
+        } else {
+            path = argv[i];
+        }
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    CacheEntry *entry = serverLoad(server, path, NULL);
+    if (!entry) {
+        return EXIT_FAILURE;
+    }
+    serverInstall(entry);
+    serverAnalyze(server, entry);
+    int status = EXIT_FAILURE;
+    if (entry->syntaxErrors) {
+        printf("\n%d erro(s) sintático(s); código não gerado.\n", entry->syntaxErrors);
+    } else if (entry->semanticErrors) {
+        printf("\n%d erro(s) semântico(s); código não gerado.\n", entry->semanticErrors);
+    } else {
+        X86Asm as;
+        IrModule module;
+        ParallelStats stats;
+        memset(&as, 0, sizeof(as));
+        int errors = parallelCompile(&as, &module, &entry->ast, optimize, threads, &stats);
+        char objectPath[PATH_MAX];
+        snprintf(objectPath, sizeof(objectPath), "%s.o", output);
+        if (errors) {
+            printf("\n%d erro(s) na geração de código; código não gerado.\n", errors);
+        } else if (module.entry < 0) {
+            fprintf(stderr, "Erro: o programa não tem um método Main\n");
+        } else if (x86WriteElf(&as, objectPath) == 0) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            printf("Código de máquina: %u função(ões), %u bytes de código, %u bytes de dados, %u relocações\n",
+                   stats.x86.functions, as.size, as.rodataSize, as.relocCount);
+            printf("Registradores: %u intervalos, %u na pilha\n", stats.x86.intervals, stats.x86.spilled);
+            printf("Tempo: compilação %.3f ms (%u thread(s))\n",
+                   (now.tv_sec - start.tv_sec) * 1e3 + (now.tv_nsec - start.tv_nsec) / 1e6, stats.threads);
+            printf("Objeto: %s\n", objectPath);
+            status = EXIT_SUCCESS;
+        }
+        irModuleFree(&module); // Já vazio se parallelCompile falhou
+        x86Free(&as);
+    }
+    serverUninstall();
+    return status;
+}
+
+// Função do comando 'estado'
+int serverStatus(const Server *server) {
+    size_t bytes = 0, streamBytes = 0, tokenTotal = 0;
+    uint32_t analyzed = 0;
+    for (uint32_t i = 0; i < server->entryCount; i++) {
+        const CacheEntry *entry = &server->entries[i];
+        size_t tokenBytes = entry->tokens ? (size_t)entry->tokenCount * sizeof(Token) : entry->stream.size;
+        bytes += entry->length + tokenBytes + (size_t)entry->tokenCount * sizeof(int) +
+                 (size_t)entry->lineCount * sizeof(int) + (entry->analyzed ? entry->ast.arena.capacity : 0);
+        streamBytes += tokenBytes;
+        tokenTotal += (size_t)entry->tokenCount;
+        analyzed += entry->analyzed != 0;
+    }
+    printf("Pedidos: %llu (%.3f ms no total)\n", (unsigned long long)server->requests, server->busyMs);
+    printf("Arquivos: %u caminho(s), %llu sem releitura, %llu relido(s) sem mudança, %llu analisado(s)\n",
+           server->pathCount, (unsigned long long)server->unchanged, (unsigned long long)server->reused,
+           (unsigned long long)server->misses);
+    printf("Cache: %u conteúdo(s), %u com AST, %zu KB, %llu descartado(s)\n", server->entryCount, analyzed,
+           bytes / 1024, (unsigned long long)server->evictions);
+    printf("Tokens: %zu em %zu KB (%zu KB como lista de Token), %llu decodificação(ões) em %.3f ms\n", tokenTotal,
+           streamBytes / 1024, tokenTotal * sizeof(Token) / 1024, (unsigned long long)server->decodes,
+           server->decodeMs);
+    return EXIT_SUCCESS;
+}
+
+// Função para executar um comando; devolve o código de saída
+int serverDispatch(Server *server, int argc, char **argv) {
+    if (argc == 0) {
+        fprintf(stderr, "Erro: pedido sem comando\n");
+        return EXIT_FAILURE;
+    }
+    if (strcmp(argv[0], "lexico") == 0) {
+        return serverLex(server, argc, argv);
+    } else if (strcmp(argv[0], "compilar") == 0) {
+        return serverCompile(server, argc, argv);
+    } else if (strcmp(argv[0], "estado") == 0) {
+        return serverStatus(server);
+    } else if (strcmp(argv[0], "limpar") == 0) {
+        serverClear(server);
+        return EXIT_SUCCESS;
+    } else if (strcmp(argv[0], "parar") == 0) {
+        server->stop = 1;
+        return EXIT_SUCCESS;
+    }
+    fprintf(stderr, "Erro: comando desconhecido '%s' (lexico, compilar, estado, limpar, parar)\n", argv[0]);
+    return EXIT_FAILURE;
+}
+
+// Função para enviar ao cliente o conteúdo de um arquivo em memória, em quadros de até SERVER_OUTPUT_CHUNK bytes
+// (a saída de 'lexico' de um arquivo grande passa de FRAME_MAX_LENGTH); devolve 0 ou -1
+int serverSendOutput(int client, int fd, FrameType type) {
+    off_t end = lseek(fd, 0, SEEK_END);
+    char *chunk = malloc(SERVER_OUTPUT_CHUNK);
+    int status = chunk ? 0 : -1;
+    for (off_t start = 0; start < end && status == 0; start += SERVER_OUTPUT_CHUNK) {
+        uint32_t length = end - start < SERVER_OUTPUT_CHUNK ? (uint32_t)(end - start) : SERVER_OUTPUT_CHUNK;
+        if (pread(fd, chunk, length, start) != (ssize_t)length || frameSend(client, type, chunk, length) != 0) {
+            status = -1;
+        }
+    }
+    free(chunk);
+    return status;
+}
+
+// Função para atender um pedido de um cliente conectado
+void serverHandle(Server *server, int client) {
+    FrameType type;
+    char *request;
+    uint32_t length;
+    if (frameReceive(client, &type, &request, &length) != 0 || type != FRAME_REQUEST || !length) {
+        free(request);
+        return;
+    }
+
+    // Diretório do cliente e argumentos, separados por '\0'
+    char *argv[SERVER_MAX_ARGUMENTS + 1];
+    int argc = 0;
+    const char *cwd = request;
+    for (char *p = request + strlen(request) + 1; p < request + length && argc < SERVER_MAX_ARGUMENTS;
+         p += strlen(p) + 1) {
+        argv[argc++] = p;
+    }
+    argv[argc] = NULL;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int output = memfd_create("saida", 0), errors = memfd_create("erros", 0);
+    int status = EXIT_FAILURE;
+    if (output < 0 || errors < 0) {
+        const char *message = "Erro: o servidor não conseguiu capturar a saída\n";
+        frameSend(client, FRAME_STDERR, message, (uint32_t)strlen(message));
+    } else {
+        fflush(stdout);
+        fflush(stderr);
+        int savedOutput = dup(STDOUT_FILENO), savedErrors = dup(STDERR_FILENO);
+        dup2(output, STDOUT_FILENO);
+        dup2(errors, STDERR_FILENO);
+        if (chdir(cwd) != 0) {
+            perror("Erro ao entrar no diretório do cliente");
+        } else {
+            status = serverDispatch(server, argc, argv);
+        }
+        fflush(stdout);
+        fflush(stderr);
+        dup2(savedOutput, STDOUT_FILENO);
+        dup2(savedErrors, STDERR_FILENO);
+        close(savedOutput);
+        close(savedErrors);
+        if (chdir("/") != 0) {
+            // Sem efeito: o servidor só usa caminhos absolutos fora dos pedidos
+        }
+        serverSendOutput(client, output, FRAME_STDOUT);
+        serverSendOutput(client, errors, FRAME_STDERR);
+    }
+    if (output >= 0) close(output);
+    if (errors >= 0) close(errors);
+
+    int32_t code = status;
+    frameSend(client, FRAME_EXIT, &code, sizeof(code));
+    server->requests++;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    server->busyMs += (now.tv_sec - start.tv_sec) * 1e3 + (now.tv_nsec - start.tv_nsec) / 1e6;
+    free(request);
+}
+
+#endif
@@ -0,0 +1,495 @@
+/*
+ * Programa do servidor de linguagem
+ *
+ * Sem opções, conversa com o editor pela entrada e saída padrão
+ * (servidor de linguagem.h). As mensagens de diagnóstico vão para stderr.
+ *
+ * Opções:
+ * - --gravar <sessao>: grava cada mensagem recebida do editor em <sessao>,
+ *   para repetir a mesma sessão de edição depois
+ * - --repetir <sessao>: repete uma sessão gravada sem editor, mede a
+ *   latência de cada mensagem e compara os percentis com o orçamento de
+ *   cada método. Cada resposta de tokens é aplicada a uma cópia do array,
+ *   como o editor faz, e comparada com o array completo do documento. No
+ *   fim, confere se os tokens mantidos de forma incremental são iguais aos
+ *   de uma análise completa do texto final. Termina com código 1 se algum
+ *   p99 passar do orçamento ou alguma conferência falhar
+ * - --simular <fonte> <sessao>: grava uma sessão sintética: abre <fonte>,
+ *   redigita as suas primeiras linhas no meio do arquivo, um caractere por
+ *   vez, com erros de digitação apagados logo depois, e abre e fecha um
+ *   comentário de bloco no topo; cada tecla é seguida de um pedido
+ *   semanticTokens/full/delta, como um editor faz
+ * - --simular-completa <fonte> <sessao>: a mesma sessão, mas cada edição
+ *   envia o texto inteiro (sincronização completa, 'didChange' sem 'range')
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include "servidor de linguagem.h"
+
+#define SIMULATION_TYPED_LINES 60
+#define SIMULATION_TYPO_INTERVAL 7
+
+// Estrutura do orçamento de latência de um método
+typedef struct {
+    const char *method;
+    double budgetUs;
+} LatencyBudget;
+
+static const LatencyBudget budgets[] = {
+    {"textDocument/didChange", 1000},
+    {"textDocument/semanticTokens/full/delta", 2000},
+    {"textDocument/semanticTokens/full", 10000},
+    {"textDocument/didOpen", 50000},
+};
+
+// Estrutura das latências medidas de um método
+typedef struct {
+    char *method;
+    double *samples;
+    uint32_t count;
+    uint32_t capacity;
+} LatencySeries;
+
+// Estrutura da cópia do array de tokens de um documento, mantida como o editor a mantém
+typedef struct {
+    char *uri;
+    uint32_t *data;
+    uint32_t count;
+    uint32_t capacity;
+} TokenMirror;
+
+// Função para medir o tempo em microssegundos
+double nowUs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+// Função para comparar duas latências (qsort)
+int compareSamples(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Função para obter um percentil de amostras ordenadas
+double percentile(const double *samples, uint32_t count, double p) {
+    uint32_t index = (uint32_t)ceil(p * count) - 1;
+    return samples[index < count ? index : count - 1];
+}
+
+// Função para registrar uma latência
+void addSample(LatencySeries **series, uint32_t *seriesCount, uint32_t *capacity, const char *method, double us) {
+    LatencySeries *s = NULL;
+    for (uint32_t i = 0; i < *seriesCount && !s; i++) {
+        if (strcmp((*series)[i].method, method) == 0) {
+            s = &(*series)[i];
+        }
+    }
+    if (!s) {
+        *series = vectorGrow(*series, capacity, *seriesCount + 1, sizeof(LatencySeries));
+        s = &(*series)[(*seriesCount)++];
+        memset(s, 0, sizeof(*s));
+        s->method = strdup(method);
+    }
+    s->samples = vectorGrow(s->samples, &s->capacity, s->count + 1, sizeof(double));
+    s->samples[s->count++] = us;
+}
+
+// Função para conferir um documento com uma análise completa do seu texto; devolve o número de linhas diferentes
+uint32_t verifyDocument(LspServer *server, LspDocument *doc) {
+    char *text = malloc((size_t)doc->text.length + 1);
+    pieceTableCopy(&doc->text, 0, doc->text.length, text);
+    LspDocument fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    lspLoadText(server, &fresh, text, doc->text.length);
+    uint32_t mismatches = 0;
+    if (fresh.lineCount != doc->lineCount) {
+        mismatches = fresh.lineCount > doc->lineCount ? fresh.lineCount : doc->lineCount;
+    } else {
+        for (uint32_t i = 0; i < doc->lineCount; i++) {
+            const LspLine *a = &doc->lines[i], *b = &fresh.lines[i];
+            if (a->start != b->start || a->inComment != b->inComment || a->tokenCount != b->tokenCount ||
+                (a->tokenCount && memcmp(a->tokens, b->tokens, a->tokenCount * sizeof(LspToken)) != 0)) {
+                mismatches++;
+            }
+        }
+    }
+    lspDocumentFree(&fresh);
+    free(text);
+    return mismatches;
+}
+
+// Função para aplicar uma resposta de tokens à cópia do editor e compará-la com o array completo do documento
+// ('request' é o pedido, 'response' a resposta com o cabeçalho); devolve 1 se a cópia ficou diferente
+uint32_t checkTokenResponse(LspServer *server, Arena *arena, TokenMirror **mirrors, uint32_t *mirrorCount,
+                            uint32_t *mirrorCapacity, const char *request, uint32_t requestLength,
+                            const char *response, size_t responseLength) {
+    arenaReset(arena);
+    uint32_t root = jsonParse(arena, request, requestLength);
+    const char *uri = jsonString(arena, jsonPath(arena, root, "params.textDocument.uri"), NULL);
+    LspDocument *doc = lspFindDocument(server, uri);
+    if (!doc) {
+        return 0;
+    }
+    TokenMirror *mirror = NULL;
+    for (uint32_t i = 0; i < *mirrorCount && !mirror; i++) {
+        if (strcmp((*mirrors)[i].uri, uri) == 0) {
+            mirror = &(*mirrors)[i];
+        }
+    }
+    if (!mirror) {
+        *mirrors = vectorGrow(*mirrors, mirrorCapacity, *mirrorCount + 1, sizeof(TokenMirror));
+        mirror = &(*mirrors)[(*mirrorCount)++];
+        memset(mirror, 0, sizeof(*mirror));
+        mirror->uri = strdup(uri);
+    }
+
+    // Corpo da resposta: depois da linha vazia do cabeçalho
+    const char *body = strstr(response, "\r\n\r\n");
+    if (!body) {
+        return 1;
+    }
+    body += 4;
+    arenaReset(arena);
+    root = jsonParse(arena, body, (uint32_t)(response + responseLength - body));
+    uint32_t result = jsonMember(arena, root, "result"), data = jsonMember(arena, result, "data");
+    uint32_t edits = jsonMember(arena, result, "edits");
+    if (data) {
+        mirror->count = 0;
+        for (uint32_t item = JSON_AT(arena, data)->first; item; item = JSON_AT(arena, item)->next) {
+            mirror->data = vectorGrow(mirror->data, &mirror->capacity, mirror->count + 1, sizeof(uint32_t));
+            mirror->data[mirror->count++] = (uint32_t)jsonNumber(arena, item, 0);
+        }
+    } else if (edits) {
+        for (uint32_t edit = JSON_AT(arena, edits)->first; edit; edit = JSON_AT(arena, edit)->next) {
+            uint32_t start = (uint32_t)jsonNumber(arena, jsonMember(arena, edit, "start"), 0);
+            uint32_t removed = (uint32_t)jsonNumber(arena, jsonMember(arena, edit, "deleteCount"), 0);
+            uint32_t inserted = 0, values = jsonMember(arena, edit, "data");
+            for (uint32_t item = values ? JSON_AT(arena, values)->first : 0; item; item = JSON_AT(arena, item)->next) {
+                inserted++;
+            }
+            if (start + removed > mirror->count) {
+                return 1;
+            }
+            mirror->data = vectorGrow(mirror->data, &mirror->capacity, mirror->count - removed + inserted + 1,
+                                      sizeof(uint32_t));
+            memmove(mirror->data + start + inserted, mirror->data + start + removed,
+                    (mirror->count - start - removed) * sizeof(uint32_t));
+            mirror->count = mirror->count - removed + inserted;
+            uint32_t *out = mirror->data + start;
+            for (uint32_t item = values ? JSON_AT(arena, values)->first : 0; item; item = JSON_AT(arena, item)->next) {
+                *out++ = (uint32_t)jsonNumber(arena, item, 0);
+            }
+        }
+    } else {
+        return 1;
+    }
+    uint32_t count = lspBuildData(server, doc);
+    return count != mirror->count || (count && memcmp(server->data, mirror->data, count * sizeof(uint32_t)) != 0);
+}
+
+// Função para repetir uma sessão gravada; devolve o código de saída
+int replaySession(const char *path) {
+    long size;
+    char *session = readSourceFile(path, &size);
+    if (!session) {
+        return EXIT_FAILURE;
+    }
+    FILE *input = fmemopen(session, (size_t)size, "r");
+    if (!input) {
+        perror("Erro ao abrir a sessão");
+        free(session);
+        return EXIT_FAILURE;
+    }
+
+    // As respostas vão para a memória, para a conferência dos tokens
+    char *responses = NULL;
+    size_t responseLength = 0;
+    FILE *output = open_memstream(&responses, &responseLength);
+    if (!output) {
+        perror("Erro ao abrir a saída da sessão");
+        fclose(input);
+        free(session);
+        return EXIT_FAILURE;
+    }
+
+    LspServer server;
+    lspInit(&server, output);
+    Arena check;
+    arenaInit(&check, 1 << 16);
+    TokenMirror *mirrors = NULL;
+    LatencySeries *series = NULL;
+    uint32_t seriesCount = 0, seriesCapacity = 0, messages = 0, mirrorCount = 0, mirrorCapacity = 0;
+    uint32_t tokenResponses = 0, tokenMismatches = 0;
+    double totalUs = 0;
+    char *body;
+    uint32_t length;
+    while ((body = lspReadMessage(input, &length)) != NULL) {
+        fseek(output, 0, SEEK_SET);
+        double start = nowUs();
+        const char *method = lspHandleMessage(&server, body, length);
+        double elapsed = nowUs() - start;
+        addSample(&series, &seriesCount, &seriesCapacity, method ? method : "(resposta)", elapsed);
+        totalUs += elapsed;
+        messages++;
+        fflush(output);
+        if (method && strncmp(method, "textDocument/semanticTokens/full", 32) == 0 && responseLength) {
+            tokenResponses++;
+            tokenMismatches += checkTokenResponse(&server, &check, &mirrors, &mirrorCount, &mirrorCapacity, body,
+                                                  length, responses, responseLength);
+        }
+        free(body);
+    }
+    fclose(input);
+
+    int status = EXIT_SUCCESS;
+    printf("Sessão: %s (%u mensagens, %.3f ms no total)\n\n", path, messages, totalUs / 1e3);
+    printf("%-42s %9s %11s %11s %12s   %s\n", "Método", "Mensagens", "p50 (µs)", "p99 (µs)", "máx (µs)",
+           "Orçamento (µs)");
+    for (uint32_t i = 0; i < seriesCount; i++) {
+        LatencySeries *s = &series[i];
+        qsort(s->samples, s->count, sizeof(double), compareSamples);
+        double p99 = percentile(s->samples, s->count, 0.99);
+        char budget[32] = "-";
+        for (size_t b = 0; b < sizeof(budgets) / sizeof(budgets[0]); b++) {
+            if (strcmp(budgets[b].method, s->method) == 0) {
+                int over = p99 > budgets[b].budgetUs;
+                snprintf(budget, sizeof(budget), "%.0f %s", budgets[b].budgetUs, over ? "EXCEDIDO" : "ok");
+                status = over ? EXIT_FAILURE : status;
+            }
+        }
+        printf("%-41s %9u %10.1f %10.1f %10.1f   %s\n", s->method, s->count, percentile(s->samples, s->count, 0.5),
+               p99, s->samples[s->count - 1], budget);
+        free(s->samples);
+        free(s->method);
+    }
+    free(series);
+
+    printf("\nTokens: %u resposta(s) aplicadas como o editor; ", tokenResponses);
+    if (tokenMismatches) {
+        printf("%u DIFERENTE(S) do array completo\n", tokenMismatches);
+        status = EXIT_FAILURE;
+    } else {
+        printf("todas iguais ao array completo\n");
+    }
+    for (uint32_t i = 0; i < mirrorCount; i++) {
+        free(mirrors[i].uri);
+        free(mirrors[i].data);
+    }
+    free(mirrors);
+    arenaFree(&check);
+
+    for (uint32_t i = 0; i < server.documentCount; i++) {
+        LspDocument *doc = &server.documents[i];
+        uint32_t mismatches = verifyDocument(&server, doc);
+        printf("\nDocumento: %s\n", doc->uri);
+        printf("Texto: %u bytes, %u linhas, %u pedaços\n", doc->text.length, doc->lineCount, doc->text.pieceCount);
+        printf("Edições: %llu, %.1f linha(s) reanalisada(s) por edição\n", (unsigned long long)doc->edits,
+               doc->edits ? (double)doc->relexedLines / doc->edits : 0.0);
+        if (mismatches) {
+            printf("Conferência: %u linha(s) DIFERENTE(S) da análise completa\n", mismatches);
+            status = EXIT_FAILURE;
+        } else {
+            printf("Conferência: tokens idênticos aos da análise completa\n");
+        }
+    }
+    lspFree(&server);
+    fclose(output);
+    free(responses);
+    free(session);
+    return status;
+}
+
+// Função para gravar uma mensagem montada em 'writer' (com o cabeçalho do protocolo)
+void writeMessage(FILE *file, JsonWriter *writer) {
+    fprintf(file, "Content-Length: %zu\r\n\r\n", writer->length);
+    fwrite(writer->data, 1, writer->length, file);
+    writer->length = 0;
+}
+
+// Estrutura da sessão sintética sendo gravada
+typedef struct {
+    FILE *file;
+    JsonWriter writer;
+    const char *uri;
+    int version;
+    int id;
+    uint32_t resultId;
+    char *text;                // Texto atual (só na sincronização completa)
+    size_t length;
+} Simulation;
+
+// Função para gravar uma edição da sessão sintética (e o pedido de tokens que o editor faz em seguida).
+// A edição troca 'removed' bytes a partir do byte 'at', que ficam entre as duas posições
+void writeEdit(Simulation *sim, uint32_t startLine, uint32_t startColumn, uint32_t endLine, uint32_t endColumn,
+               size_t at, size_t removed, const char *text, size_t length) {
+    JsonWriter *writer = &sim->writer;
+    jsonWritef(writer, "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/didChange\",\"params\":{\"textDocument\":{\"uri\":");
+    jsonWriteString(writer, sim->uri, strlen(sim->uri));
+    if (sim->text) {
+        memmove(sim->text + at + length, sim->text + at + removed, sim->length - at - removed);
+        memcpy(sim->text + at, text, length);
+        sim->length = sim->length - removed + length;
+        jsonWritef(writer, ",\"version\":%d},\"contentChanges\":[{\"text\":", ++sim->version);
+        jsonWriteString(writer, sim->text, sim->length);
+    } else {
+        jsonWritef(writer, ",\"version\":%d},\"contentChanges\":[{\"range\":{\"start\":{\"line\":%u,\"character\":%u},"
+                           "\"end\":{\"line\":%u,\"character\":%u}},\"text\":",
+                   ++sim->version, startLine, startColumn, endLine, endColumn);
+        jsonWriteString(writer, text, length);
+    }
+    jsonWriteRaw(writer, "}]}}", 4);
+    writeMessage(sim->file, writer);
+
+    jsonWritef(writer, "{\"jsonrpc\":\"2.0\",\"id\":%d,\"method\":\"textDocument/semanticTokens/full/delta\","
+                       "\"params\":{\"textDocument\":{\"uri\":", ++sim->id);
+    jsonWriteString(writer, sim->uri, strlen(sim->uri));
+    jsonWritef(writer, "},\"previousResultId\":\"%u\"}}", sim->resultId++);
+    writeMessage(sim->file, writer);
+}
+
+// Função para gravar a sessão sintética ('full' = sincronização completa); devolve o código de saída
+int simulateSession(const char *source, const char *path, int full) {
+    long size;
+    char *code = readSourceFile(source, &size);
+    if (!code) {
+        return EXIT_FAILURE;
+    }
+    Simulation sim;
+    memset(&sim, 0, sizeof(sim));
+    if (!(sim.file = fopen(path, "wb"))) {
+        fprintf(stderr, "Erro: Não foi possível criar o arquivo %s\n", path);
+        free(code);
+        return EXIT_FAILURE;
+    }
+    if (full) {
+        // O texto cresce no máximo o tamanho do fonte redigitado, mais os erros e o comentário
+        sim.text = malloc(2 * (size_t)size + 16);
+        if (!sim.text) {
+            fprintf(stderr, "Erro: Falha ao alocar o texto da sessão.\n");
+            fclose(sim.file);
+            free(code);
+            return EXIT_FAILURE;
+        }
+        memcpy(sim.text, code, (size_t)size);
+        sim.length = (size_t)size;
+    }
+    char absolute[PATH_MAX], uri[PATH_MAX + 8];
+    snprintf(uri, sizeof(uri), "file://%s", realpath(source, absolute) ? absolute : source);
+    sim.uri = uri;
+    sim.version = 1;
+    sim.resultId = 1;
+
+    JsonWriter *writer = &sim.writer;
+    jsonWritef(writer, "{\"jsonrpc\":\"2.0\",\"id\":%d,\"method\":\"initialize\",\"params\":{\"processId\":null,"
+                       "\"capabilities\":{\"general\":{\"positionEncodings\":[\"utf-16\"]}}}}", ++sim.id);
+    writeMessage(sim.file, writer);
+    jsonWritef(writer, "{\"jsonrpc\":\"2.0\",\"method\":\"initialized\",\"params\":{}}");
+    writeMessage(sim.file, writer);
+    jsonWritef(writer, "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/didOpen\",\"params\":{\"textDocument\":{\"uri\":");
+    jsonWriteString(writer, uri, strlen(uri));
+    jsonWritef(writer, ",\"languageId\":\"csharp\",\"version\":%d,\"text\":", sim.version);
+    jsonWriteString(writer, code, (size_t)size);
+    jsonWriteRaw(writer, "}}}", 3);
+    writeMessage(sim.file, writer);
+    jsonWritef(writer, "{\"jsonrpc\":\"2.0\",\"id\":%d,\"method\":\"textDocument/semanticTokens/full\","
+                       "\"params\":{\"textDocument\":{\"uri\":", ++sim.id);
+    jsonWriteString(writer, uri, strlen(uri));
+    jsonWriteRaw(writer, "}}}", 3);
+    writeMessage(sim.file, writer);
+
+    // Redigitar as primeiras linhas do arquivo a partir da linha do meio
+    uint32_t lines = 1;
+    for (long i = 0; i < size; i++) {
+        lines += code[i] == '\n';
+    }
+    uint32_t line = lines / 2, column = 0, typed = 0, keys = 0;
+    size_t at = 0;
+    for (uint32_t l = 0; l < line; at++) {
+        l += code[at] == '\n';
+    }
+    for (long i = 0; i < size && typed < SIMULATION_TYPED_LINES; keys++) {
+        size_t n = 1;
+        while (i + (long)n < size && ((unsigned char)code[i + n] & 0xC0) == 0x80) {
+            n++;
+        }
+        if (keys % SIMULATION_TYPO_INTERVAL == SIMULATION_TYPO_INTERVAL - 1) {
+            writeEdit(&sim, line, column, line, column, at, 0, "x", 1);
+            writeEdit(&sim, line, column, line, column + 1, at, 1, "", 0);
+        }
+        writeEdit(&sim, line, column, line, column, at, 0, code + i, n);
+        at += n;
+        if (code[i] == '\n') {
+            line++;
+            column = 0;
+            typed++;
+        } else {
+            column += (unsigned char)code[i] >= 0xF0 ? 2 : 1;
+        }
+        i += (long)n;
+    }
+
+    // Comentário de bloco aberto no topo (reanalisa até o fim) e fechado em seguida
+    writeEdit(&sim, 0, 0, 0, 0, 0, 0, "/*", 2);
+    writeEdit(&sim, 0, 0, 0, 2, 0, 2, "", 0);
+
+    jsonWritef(writer, "{\"jsonrpc\":\"2.0\",\"id\":%d,\"method\":\"shutdown\"}", ++sim.id);
+    writeMessage(sim.file, writer);
+    jsonWritef(writer, "{\"jsonrpc\":\"2.0\",\"method\":\"exit\"}");
+    writeMessage(sim.file, writer);
+
+    printf("Sessão: %s (%u teclas, %u linhas redigitadas%s)\n", path, keys, typed,
+           full ? ", sincronização completa" : "");
+    jsonWriterFree(writer);
+    fclose(sim.file);
+    free(sim.text);
+    free(code);
+    return EXIT_SUCCESS;
+}
+
+// Função principal
+int main(int argc, char *argv[]) {
+    const char *recordPath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repetir") == 0 && i + 1 < argc) {
+            return replaySession(argv[i + 1]);
+        } else if ((strcmp(argv[i], "--simular") == 0 || strcmp(argv[i], "--simular-completa") == 0) &&
+                   i + 2 < argc) {
+            return simulateSession(argv[i + 1], argv[i + 2], strcmp(argv[i], "--simular-completa") == 0);
+        } else if (strcmp(argv[i], "--gravar") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else {
+            fprintf(stderr, "Uso: %s [--gravar <sessao> | --repetir <sessao> | --simular[-completa] <fonte> <sessao>]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    FILE *record = NULL;
+    if (recordPath && !(record = fopen(recordPath, "wb"))) {
+        fprintf(stderr, "Erro: Não foi possível criar o arquivo %s\n", recordPath);
+        return EXIT_FAILURE;
+    }
+
+    LspServer server;
+    lspInit(&server, stdout);
+    char *body;
+    uint32_t length;
+    while (!server.exited && (body = lspReadMessage(stdin, &length)) != NULL) {
+        if (record) {
+            fprintf(record, "Content-Length: %u\r\n\r\n", length);
+            fwrite(body, 1, length, record);
+            fflush(record);
+        }
+        lspHandleMessage(&server, body, length);
+        free(body);
+    }
+    if (record) {
+        fclose(record);
+    }
+    int status = server.shutdown ? EXIT_SUCCESS : EXIT_FAILURE;
+    lspFree(&server);
+    return status;
+}
@@ -0,0 +1,836 @@
+/*
+ * Servidor de linguagem (Language Server Protocol)
+ *
+ * Dá ao editor o realce de sintaxe produzido pelo próprio analisador
+ * léxico. Os documentos abertos ficam em tabelas de pedaços (tabela de
+ * pedacos.h); a cada 'didChange' só as linhas tocadas pela edição são
+ * analisadas de novo, e 'textDocument/semanticTokens/full/delta' responde
+ * com a diferença entre o fluxo de tokens atual e o último enviado.
+ *
+ * Análise incremental: nenhum token atravessa uma quebra de linha (as
+ * strings e as diretivas também terminam no fim da linha), então o único estado que passa
+ * de uma linha para a seguinte é estar ou não dentro de um comentário de
+ * bloco. Cada linha guarda esse estado no seu início e os seus tokens já
+ * convertidos para o protocolo. Uma edição analisa as linhas que mudaram e
+ * continua linha a linha só enquanto o estado no início da linha seguinte
+ * for diferente do que era antes (ex.: abrir um comentário de bloco
+ * reanalisa até o seu fechamento).
+ *
+ * Sincronização completa (um 'didChange' sem 'range'): cada linha guarda o
+ * hash do seu texto, e só as linhas entre o maior prefixo e o maior sufixo
+ * de linhas iguais nos dois textos viram uma edição.
+ *
+ * Delta: o documento guarda o trecho de linhas mudado desde o último array
+ * enviado. Os tokens antes e depois dele são os mesmos, então a resposta
+ * codifica só as linhas do trecho (e o primeiro token seguinte, cuja
+ * distância em linhas pode ter mudado), sem montar o array inteiro.
+ *
+ * Estruturas principais:
+ * - LspToken: Token como o protocolo o descreve (coluna e tamanho na
+ *   codificação combinada com o editor, tipo da legenda)
+ * - LspLine: Início da linha no documento, estado de comentário no início,
+ *   hash do texto e tokens da linha
+ * - LspDocument: Texto, linhas, tamanho do último array de tokens enviado
+ *   e linhas mudadas desde então (base para a resposta delta)
+ * - LspServer: Documentos abertos, arena da mensagem atual (json.h) e a
+ *   resposta sendo montada
+ *
+ * Tipos de token (legenda): TokenType vira keyword, type, number, operator
+ * e macro (diretivas); um identificador vira class depois de 'class' ou
+ * 'new', method antes de '(' e variable nos demais casos; de aspa a aspa
+ * vira um único string; os comentários (que o analisador léxico descarta)
+ * vêm da varredura de estado de cada linha. Pontuação e tokens
+ * desconhecidos não são enviados. Como cada linha é analisada sozinha, os
+ * trechos inativos de '#if' continuam realçados como código.
+ *
+ * Posições: UTF-16, como o protocolo exige por padrão, ou UTF-8 quando o
+ * editor oferece (general.positionEncodings), o que dispensa a conversão.
+ */
+
+#ifndef SERVIDOR_DE_LINGUAGEM_H
+#define SERVIDOR_DE_LINGUAGEM_H
+
+#include <strings.h>
+#include "analise lexica.h"
+#include "json.h"
+#include "tabela de pedacos.h"
+
+// Tipos de token da legenda
+typedef enum {
+    LSP_KEYWORD,
+    LSP_TYPE,
+    LSP_CLASS,
+    LSP_METHOD,
+    LSP_VARIABLE,
+    LSP_NUMBER,
+    LSP_STRING,
+    LSP_OPERATOR,
+    LSP_COMMENT,
+    LSP_MACRO,
+    LSP_TOKEN_TYPES,
+    LSP_NONE = LSP_TOKEN_TYPES
+} LspTokenType;
+
+static const char *const lspTokenTypeNames[LSP_TOKEN_TYPES] = {
+    "keyword", "type", "class", "method", "variable", "number", "string", "operator", "comment", "macro"
+};
+
+// Estrutura de um token no protocolo
+typedef struct {
+    uint32_t column;
+    uint32_t length;
+    uint32_t type;
+} LspToken;
+
+// Estrutura de uma linha
+typedef struct {
+    uint32_t start;            // Deslocamento no documento
+    uint32_t inComment;        // Começa dentro de um comentário de bloco
+    uint64_t hash;             // Hash do texto da linha (sincronização completa)
+    LspToken *tokens;
+    uint32_t tokenCount;
+    uint32_t tokenCapacity;
+} LspLine;
+
+// Estrutura de um documento aberto
+typedef struct {
+    char *uri;
+    int version;
+    PieceTable text;
+    LspLine *lines;
+    uint32_t lineCount;
+    uint32_t lineCapacity;
+    uint32_t resultId;         // Identificador do último array enviado (0 = nenhum)
+    uint32_t dataCount;        // Inteiros do último array enviado (5 por token)
+    uint32_t dirtyFirst;       // Linhas mudadas desde o último envio (dirtyFirst > dirtyLast = nenhuma)
+    uint32_t dirtyLast;
+    uint64_t edits;
+    uint64_t relexedLines;
+} LspDocument;
+
+// Estrutura de um trecho de comentário na linha [start, end)
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+} LspSpan;
+
+// Estrutura do servidor
+typedef struct {
+    LspDocument *documents;
+    uint32_t documentCount;
+    uint32_t documentCapacity;
+    int utf8;                  // Posições em bytes UTF-8 em vez de unidades UTF-16
+    int shutdown;              // 'shutdown' recebido
+    int exited;                // 'exit' recebido
+    Arena arena;               // Árvore JSON da mensagem atual
+    JsonWriter out;            // Resposta sendo montada
+    FILE *output;              // Destino das respostas (NULL = descartar)
+    const char *message;       // Texto da mensagem atual
+    char *line;                // Texto da linha sendo analisada
+    uint32_t lineCapacity;
+    LspSpan *spans;
+    uint32_t spanCapacity;
+    uint32_t *data;            // Array de tokens sendo montado
+    uint32_t dataCapacity;
+} LspServer;
+
+// Função para inicializar o servidor
+void lspInit(LspServer *server, FILE *output) {
+    memset(server, 0, sizeof(*server));
+    server->output = output;
+    arenaInit(&server->arena, 1 << 16);
+}
+
+// Função para liberar um documento
+void lspDocumentFree(LspDocument *doc) {
+    for (uint32_t i = 0; i < doc->lineCount; i++) {
+        free(doc->lines[i].tokens);
+    }
+    free(doc->lines);
+    free(doc->uri);
+    pieceTableFree(&doc->text);
+    memset(doc, 0, sizeof(*doc));
+}
+
+// Função para liberar o servidor
+void lspFree(LspServer *server) {
+    for (uint32_t i = 0; i < server->documentCount; i++) {
+        lspDocumentFree(&server->documents[i]);
+    }
+    free(server->documents);
+    free(server->line);
+    free(server->spans);
+    free(server->data);
+    arenaFree(&server->arena);
+    jsonWriterFree(&server->out);
+    freeTokens();
+}
+
+// Função para contar as unidades de posição entre dois bytes de uma linha
+static uint32_t lspUnits(const LspServer *server, const char *text, uint32_t from, uint32_t to) {
+    if (server->utf8) {
+        return to - from;
+    }
+    uint32_t units = 0;
+    for (uint32_t i = from; i < to; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if ((c & 0xC0) != 0x80) {
+            units += c >= 0xF0 ? 2 : 1;   // Fora do plano básico: par substituto
+        }
+    }
+    return units;
+}
+
+// Função para converter uma coluna do protocolo no byte correspondente da linha (limitado ao fim da linha)
+static uint32_t lspByteAt(const LspServer *server, const char *text, uint32_t length, uint32_t column) {
+    if (server->utf8) {
+        return column < length ? column : length;
+    }
+    uint32_t i = 0, units = 0;
+    while (i < length && units < column) {
+        unsigned char c = (unsigned char)text[i];
+        units += c >= 0xF0 ? 2 : 1;
+        i++;
+        while (i < length && ((unsigned char)text[i] & 0xC0) == 0x80) {
+            i++;
+        }
+    }
+    return i;
+}
+
+// Função para mapear um token do analisador léxico para a legenda
+LspTokenType lspTokenType(const Token *list, int index, int count) {
+    const Token *token = &list[index];
+    switch (token->type) {
+        case KEYWORD: return LSP_KEYWORD;
+        case TYPE: return LSP_TYPE;
+        case NUM_LITERAL: return LSP_NUMBER;
+        case STRING_LITERAL: return LSP_STRING;
+        case OPERATOR:
+        case ASSIGNMENT:
+        case COMPARATOR: return LSP_OPERATOR;
+        case DIRECTIVE: return LSP_MACRO;
+        case IDENTIFIER:
+            if (index > 0 && list[index - 1].type == KEYWORD &&
+                (strcmp(list[index - 1].value, "class") == 0 || strcmp(list[index - 1].value, "new") == 0)) {
+                return LSP_CLASS;
+            }
+            if (index + 1 < count && list[index + 1].type == OPEN_PARENTHESIS) {
+                return LSP_METHOD;
+            }
+            return LSP_VARIABLE;
+        default: return LSP_NONE;
+    }
+}
+
+// Função para obter o tamanho da linha 'index' (sem a quebra)
+static uint32_t lspLineLength(const LspDocument *doc, uint32_t index) {
+    uint32_t end = index + 1 < doc->lineCount ? doc->lines[index + 1].start - 1 : doc->text.length;
+    return end - doc->lines[index].start;
+}
+
+// Função para copiar o texto da linha 'index' (sem a quebra) para o buffer do servidor; devolve o tamanho
+static uint32_t lspLineText(LspServer *server, LspDocument *doc, uint32_t index) {
+    uint32_t start = doc->lines[index].start, length = lspLineLength(doc, index);
+    server->line = vectorGrow(server->line, &server->lineCapacity, length + 1, 1);
+    pieceTableCopy(&doc->text, start, start + length, server->line);
+    server->line[length] = '\0';
+    return length;
+}
+
+// Função para calcular o hash do texto de uma linha (FNV-1a de 64 bits)
+static uint64_t lspLineHash(const char *text, uint32_t length) {
+    uint64_t hash = 14695981039346656037ull;
+    for (uint32_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)text[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Função para incluir as linhas [first, last] no trecho mudado desde o último envio
+static void lspMarkDirty(LspDocument *doc, uint32_t first, uint32_t last) {
+    if (doc->dirtyFirst > doc->dirtyLast) {
+        doc->dirtyFirst = first;
+        doc->dirtyLast = last;
+        return;
+    }
+    doc->dirtyFirst = first < doc->dirtyFirst ? first : doc->dirtyFirst;
+    doc->dirtyLast = last > doc->dirtyLast ? last : doc->dirtyLast;
+}
+
+// Estrutura do cursor de conversão byte -> coluna (os tokens da linha chegam em ordem)
+typedef struct {
+    uint32_t byte;
+    uint32_t units;
+} LspCursor;
+
+// Função para acrescentar um token à linha
+static void lspEmit(LspServer *server, LspLine *line, LspCursor *cursor, uint32_t start, uint32_t end,
+                    LspTokenType type) {
+    cursor->units += lspUnits(server, server->line, cursor->byte, start);
+    cursor->byte = start;
+    line->tokens = vectorGrow(line->tokens, &line->tokenCapacity, line->tokenCount + 1, sizeof(LspToken));
+    line->tokens[line->tokenCount++] = (LspToken){cursor->units, lspUnits(server, server->line, start, end), type};
+}
+
+// Função para analisar uma linha a partir do seu estado inicial; devolve o estado no fim (dentro de comentário)
+uint32_t lspLexLine(LspServer *server, LspDocument *doc, uint32_t index) {
+    uint32_t length = lspLineText(server, doc, index);
+    const char *text = server->line;
+    LspLine *line = &doc->lines[index];
+    line->tokenCount = 0;
+    line->hash = lspLineHash(text, length);
+    doc->relexedLines++;
+
+    // Comentários e estado no fim da linha, com as mesmas regras de lexicalAnalysis
+    uint32_t spanCount = 0, codeStart = 0, i = 0, spanStart = 0;
+    uint32_t inComment = line->inComment, insideString = 0;
+    while (i < length) {
+        if (inComment) {
+            const char *close = strstr(text + i, "*/");
+            uint32_t end = close ? (uint32_t)(close - text) + 2 : length;
+            server->spans = vectorGrow(server->spans, &server->spanCapacity, spanCount + 1, sizeof(LspSpan));
+            server->spans[spanCount++] = (LspSpan){spanStart, end};
+            if (spanStart == 0 && line->inComment) {
+                codeStart = end;
+            }
+            inComment = !close;
+            i = end;
+        } else if (insideString && text[i] == '\\' && i + 1 < length) {
+            i += 2;
+        } else if (!insideString && text[i] == '/' && text[i + 1] == '/') {
+            server->spans = vectorGrow(server->spans, &server->spanCapacity, spanCount + 1, sizeof(LspSpan));
+            server->spans[spanCount++] = (LspSpan){i, length};
+            i = length;
+        } else if (!insideString && text[i] == '/' && text[i + 1] == '*') {
+            inComment = 1;
+            spanStart = i;
+            i += 2;
+        } else {
+            insideString ^= text[i] == '"';
+            i++;
+        }
+    }
+
+    // Tokens do código depois do comentário que vem da linha anterior
+    tokenCount = 0;
+    if (codeStart < length) {
+        lexMidLine = codeStart > 0;   // Depois do '*/': como na análise completa, '#' aqui não é diretiva
+        lexicalAnalysis(text + codeStart);
+    }
+
+    // Junção ordenada de tokens, strings e comentários
+    LspCursor cursor = {0, 0};
+    uint32_t span = 0, quote = 0;
+    int inString = 0;
+    for (int t = 0; t < tokenCount; t++) {
+        uint32_t start = codeStart + (uint32_t)tokens[t].offset;
+        while (span < spanCount && server->spans[span].start < start) {
+            lspEmit(server, line, &cursor, server->spans[span].start, server->spans[span].end, LSP_COMMENT);
+            span++;
+        }
+        if (tokens[t].type == QUOTE) {
+            if (inString) {
+                lspEmit(server, line, &cursor, quote, start + 1, LSP_STRING);
+            }
+            quote = start;
+            inString = !inString;
+            continue;
+        }
+        if (inString) {
+            continue;
+        }
+        LspTokenType type = lspTokenType(tokens, t, tokenCount);
+        if (type != LSP_NONE) {
+            lspEmit(server, line, &cursor, start, start + (uint32_t)tokens[t].size, type);
+        }
+    }
+    if (inString) {
+        uint32_t end = length;
+        while (end > quote + 1 && CHAR_IS(text[end - 1], CHAR_SPACE)) {
+            end--;
+        }
+        lspEmit(server, line, &cursor, quote, end, LSP_STRING);
+    }
+    for (; span < spanCount; span++) {
+        lspEmit(server, line, &cursor, server->spans[span].start, server->spans[span].end, LSP_COMMENT);
+    }
+    return inComment;
+}
+
+// Função para analisar as linhas a partir de 'first' até o estado voltar a coincidir depois de 'last'
+static void lspRelex(LspServer *server, LspDocument *doc, uint32_t first, uint32_t last) {
+    uint32_t state = doc->lines[first].inComment, i;
+    for (i = first; i < doc->lineCount; i++) {
+        if (i > last && doc->lines[i].inComment == state) {
+            break;
+        }
+        doc->lines[i].inComment = state;
+        state = lspLexLine(server, doc, i);
+    }
+    lspMarkDirty(doc, first, i - 1);
+}
+
+// Função para carregar o texto inteiro de um documento
+void lspLoadText(LspServer *server, LspDocument *doc, const char *text, uint32_t length) {
+    for (uint32_t i = 0; i < doc->lineCount; i++) {
+        free(doc->lines[i].tokens);
+    }
+    pieceTableFree(&doc->text);
+    pieceTableInit(&doc->text, text, length);
+
+    doc->lineCount = 0;
+    doc->dirtyFirst = UINT32_MAX;
+    doc->dirtyLast = 0;
+    const char *p = text, *end = text + length;
+    for (;;) {
+        doc->lines = vectorGrow(doc->lines, &doc->lineCapacity, doc->lineCount + 1, sizeof(LspLine));
+        doc->lines[doc->lineCount++] = (LspLine){(uint32_t)(p - text), 0, 0, NULL, 0, 0};
+        const char *newline = memchr(p, '\n', (size_t)(end - p));
+        if (!newline) {
+            break;
+        }
+        p = newline + 1;
+    }
+    uint64_t relexed = doc->relexedLines;   // Só as edições contam nas estatísticas
+    lspRelex(server, doc, 0, doc->lineCount - 1);
+    doc->relexedLines = relexed;
+}
+
+// Função para converter uma posição (linha, coluna) em deslocamento no documento
+static uint32_t lspOffset(LspServer *server, LspDocument *doc, uint32_t line, uint32_t column) {
+    if (line >= doc->lineCount) {
+        return doc->text.length;
+    }
+    uint32_t length = lspLineText(server, doc, line);
+    return doc->lines[line].start + lspByteAt(server, server->line, length, column);
+}
+
+// Função para trocar os bytes [start, end) do documento, que vão da linha startLine à endLine, por 'text'
+static void lspReplaceRange(LspServer *server, LspDocument *doc, uint32_t startLine, uint32_t endLine, uint32_t start,
+                            uint32_t end, const char *text, uint32_t length) {
+    pieceTableReplace(&doc->text, start, end, text, length);
+    doc->edits++;
+
+    // As linhas startLine+1..endLine saem; entram as quebras do texto novo
+    uint32_t added = 0;
+    for (const char *p = text; (p = memchr(p, '\n', (size_t)(text + length - p))) != NULL; p++) {
+        added++;
+    }
+    uint32_t removed = endLine - startLine;
+    for (uint32_t i = startLine + 1; i <= endLine; i++) {
+        free(doc->lines[i].tokens);
+    }
+
+    // O trecho mudado desde o último envio acompanha as linhas que entram e saem
+    if (doc->dirtyFirst <= doc->dirtyLast) {
+        uint32_t *bounds[2] = {&doc->dirtyFirst, &doc->dirtyLast};
+        for (int b = 0; b < 2; b++) {
+            if (*bounds[b] > endLine) {
+                *bounds[b] = *bounds[b] - removed + added;
+            } else if (*bounds[b] > startLine) {
+                *bounds[b] = b ? startLine + added : startLine;
+            }
+        }
+    }
+    uint32_t count = doc->lineCount - removed + added;
+    doc->lines = vectorGrow(doc->lines, &doc->lineCapacity, count, sizeof(LspLine));
+    memmove(&doc->lines[startLine + 1 + added], &doc->lines[endLine + 1],
+            (doc->lineCount - endLine - 1) * sizeof(LspLine));
+    uint32_t next = startLine + 1;
+    for (const char *p = text; (p = memchr(p, '\n', (size_t)(text + length - p))) != NULL; p++) {
+        doc->lines[next++] = (LspLine){start + (uint32_t)(p - text) + 1, 0, 0, NULL, 0, 0};
+    }
+    int64_t delta = (int64_t)length - (int64_t)(end - start);
+    for (uint32_t i = startLine + 1 + added; i < count; i++) {
+        doc->lines[i].start = (uint32_t)(doc->lines[i].start + delta);
+    }
+    doc->lineCount = count;
+    lspRelex(server, doc, startLine, startLine + added);
+}
+
+// Função para aplicar uma edição (o trecho entre duas posições vira 'text')
+void lspApplyEdit(LspServer *server, LspDocument *doc, uint32_t startLine, uint32_t startColumn, uint32_t endLine,
+                  uint32_t endColumn, const char *text, uint32_t length) {
+    uint32_t start = lspOffset(server, doc, startLine, startColumn);
+    uint32_t end = lspOffset(server, doc, endLine, endColumn);
+    if (startLine >= doc->lineCount) {
+        startLine = doc->lineCount - 1;
+    }
+    if (endLine >= doc->lineCount) {
+        endLine = doc->lineCount - 1;
+    }
+    if (end < start) {
+        end = start;
+        endLine = startLine;
+    }
+    lspReplaceRange(server, doc, startLine, endLine, start, end, text, length);
+}
+
+// Função para trocar o texto inteiro (sincronização completa): as linhas do maior prefixo e do maior sufixo
+// iguais nos dois textos (pelo tamanho e pelo hash) ficam, e só o trecho entre eles vira uma edição
+void lspReplaceText(LspServer *server, LspDocument *doc, const char *text, uint32_t length) {
+    uint32_t oldCount = doc->lineCount, prefix = 0, suffix = 0;
+    const char *p = text, *end = text + length, *newline;
+
+    // Prefixo: linhas com quebra (a última linha nunca entra)
+    while (prefix + 1 < oldCount && (newline = memchr(p, '\n', (size_t)(end - p))) != NULL) {
+        uint32_t size = (uint32_t)(newline - p);
+        if (size != lspLineLength(doc, prefix) || lspLineHash(p, size) != doc->lines[prefix].hash) {
+            break;
+        }
+        p = newline + 1;
+        prefix++;
+    }
+
+    // Sufixo: a partir do fim, sem alcançar a linha do prefixo nos dois textos
+    const char *tail = end;
+    while (oldCount - 1 - suffix > prefix) {
+        const char *lineEnd = suffix ? tail - 1 : tail, *line = lineEnd;   // tail - 1 é a quebra da linha
+        while (line > p && line[-1] != '\n') {
+            line--;
+        }
+        uint32_t index = oldCount - 1 - suffix, size = (uint32_t)(lineEnd - line);
+        if (line == p || size != lspLineLength(doc, index) || lspLineHash(line, size) != doc->lines[index].hash) {
+            break;
+        }
+        tail = line;
+        suffix++;
+    }
+
+    uint32_t endLine = suffix ? oldCount - suffix : oldCount - 1;
+    uint32_t oldEnd = suffix ? doc->lines[endLine].start : doc->text.length;
+    lspReplaceRange(server, doc, prefix, endLine, doc->lines[prefix].start, oldEnd, p, (uint32_t)(tail - p));
+}
+
+// Estrutura da posição do último token codificado (a codificação é relativa a ele)
+typedef struct {
+    uint32_t line;
+    uint32_t column;
+} LspPrevious;
+
+// Função para codificar os 'tokens' primeiros tokens da linha 'index' no buffer do servidor a partir de 'count'
+// inteiros; devolve o novo total
+static uint32_t lspEncodeLine(LspServer *server, const LspDocument *doc, uint32_t index, uint32_t tokens,
+                              uint32_t count, LspPrevious *previous) {
+    const LspLine *line = &doc->lines[index];
+    server->data = vectorGrow(server->data, &server->dataCapacity, count + 5 * tokens, sizeof(uint32_t));
+    for (uint32_t t = 0; t < tokens; t++) {
+        uint32_t *out = server->data + count;
+        out[0] = index - previous->line;
+        out[1] = index == previous->line ? line->tokens[t].column - previous->column : line->tokens[t].column;
+        out[2] = line->tokens[t].length;
+        out[3] = line->tokens[t].type;
+        out[4] = 0;
+        previous->line = index;
+        previous->column = line->tokens[t].column;
+        count += 5;
+    }
+    return count;
+}
+
+// Função para montar o array de tokens do documento no buffer do servidor; devolve o número de inteiros
+static uint32_t lspBuildData(LspServer *server, const LspDocument *doc) {
+    uint32_t count = 0;
+    LspPrevious previous = {0, 0};
+    for (uint32_t i = 0; i < doc->lineCount; i++) {
+        count = lspEncodeLine(server, doc, i, doc->lines[i].tokenCount, count, &previous);
+    }
+    return count;
+}
+
+// Função para montar a edição delta: os tokens das linhas mudadas desde o último envio e o primeiro token
+// depois delas; 'start' e 'deleteCount' recebem a posição e o tamanho do trecho trocado no array enviado.
+// Devolve o número de inteiros da edição ('total' recebe o tamanho do array completo)
+static uint32_t lspBuildDelta(LspServer *server, const LspDocument *doc, uint32_t *start, uint32_t *deleteCount,
+                              uint32_t *total) {
+    uint32_t first = doc->dirtyFirst, last = doc->dirtyLast;
+    uint32_t before = 0, after = 0, count = 0, middle = 0;
+    LspPrevious previous = {0, 0};
+    if (first > last) {
+        *start = *deleteCount = 0;
+        *total = doc->dataCount;
+        return 0;
+    }
+    for (uint32_t i = 0; i < first; i++) {
+        const LspLine *line = &doc->lines[i];
+        if (line->tokenCount) {
+            before += line->tokenCount;
+            previous = (LspPrevious){i, line->tokens[line->tokenCount - 1].column};
+        }
+    }
+    for (uint32_t i = last + 1; i < doc->lineCount; i++) {
+        after += doc->lines[i].tokenCount;
+    }
+    for (uint32_t i = first; i <= last; i++) {
+        count = lspEncodeLine(server, doc, i, doc->lines[i].tokenCount, count, &previous);
+    }
+    middle = count / 5;
+
+    // O primeiro token depois do trecho guarda a distância em linhas até o anterior
+    for (uint32_t i = last + 1; after && i < doc->lineCount; i++) {
+        if (doc->lines[i].tokenCount) {
+            count = lspEncodeLine(server, doc, i, 1, count, &previous);
+            after--;
+            break;
+        }
+    }
+    *start = 5 * before;
+    *deleteCount = doc->dataCount - 5 * (before + after);
+    *total = 5 * (before + middle + after) + (count - 5 * middle);
+    return count;
+}
+
+// Função para escrever um trecho do array de tokens como array JSON
+static void lspWriteData(LspServer *server, const uint32_t *data, uint32_t count) {
+    jsonWriteRaw(&server->out, "[", 1);
+    for (uint32_t i = 0; i < count; i++) {
+        if (i) {
+            jsonWriteRaw(&server->out, ",", 1);
+        }
+        jsonWriteUint(&server->out, data[i]);
+    }
+    jsonWriteRaw(&server->out, "]", 1);
+}
+
+// Função para registrar o tamanho do array enviado (o trecho mudado recomeça vazio)
+static void lspKeepData(LspDocument *doc, uint32_t count) {
+    doc->dataCount = count;
+    doc->dirtyFirst = UINT32_MAX;
+    doc->dirtyLast = 0;
+    doc->resultId++;
+}
+
+// Função para procurar um documento aberto
+LspDocument *lspFindDocument(LspServer *server, const char *uri) {
+    for (uint32_t i = 0; uri && i < server->documentCount; i++) {
+        if (strcmp(server->documents[i].uri, uri) == 0) {
+            return &server->documents[i];
+        }
+    }
+    return NULL;
+}
+
+// Função para enviar a resposta montada (cabeçalho Content-Length e corpo)
+static void lspSend(LspServer *server) {
+    if (server->output) {
+        fprintf(server->output, "Content-Length: %zu\r\n\r\n", server->out.length);
+        fwrite(server->out.data, 1, server->out.length, server->output);
+        fflush(server->output);
+    }
+    server->out.length = 0;
+}
+
+// Função para escrever o 'id' do pedido exatamente como veio (null se não houver)
+static void lspWriteId(LspServer *server, uint32_t id) {
+    jsonWriteRaw(&server->out, "{\"jsonrpc\":\"2.0\",\"id\":", 22);
+    if (id) {
+        const JsonValue *value = JSON_AT(&server->arena, id);
+        jsonWriteRaw(&server->out, server->message + value->start, value->end - value->start);
+    } else {
+        jsonWriteRaw(&server->out, "null", 4);
+    }
+}
+
+// Função para responder com um erro
+static void lspError(LspServer *server, uint32_t id, int code, const char *message) {
+    lspWriteId(server, id);
+    jsonWritef(&server->out, ",\"error\":{\"code\":%d,\"message\":", code);
+    jsonWriteString(&server->out, message, strlen(message));
+    jsonWriteRaw(&server->out, "}}", 2);
+    lspSend(server);
+}
+
+// Função do pedido 'initialize': combina a codificação de posições e anuncia as capacidades
+static void lspInitialize(LspServer *server, uint32_t id, uint32_t params) {
+    uint32_t encodings = jsonPath(&server->arena, params, "capabilities.general.positionEncodings");
+    if (encodings && JSON_AT(&server->arena, encodings)->kind == JSON_ARRAY) {
+        for (uint32_t item = JSON_AT(&server->arena, encodings)->first; item; item = JSON_AT(&server->arena, item)->next) {
+            const char *name = jsonString(&server->arena, item, NULL);
+            if (name && strcmp(name, "utf-8") == 0) {
+                server->utf8 = 1;
+            }
+        }
+    }
+    lspWriteId(server, id);
+    jsonWritef(&server->out,
+               ",\"result\":{\"capabilities\":{\"positionEncoding\":\"%s\","
+               "\"textDocumentSync\":{\"openClose\":true,\"change\":2},"
+               "\"semanticTokensProvider\":{\"legend\":{\"tokenTypes\":[",
+               server->utf8 ? "utf-8" : "utf-16");
+    for (int i = 0; i < LSP_TOKEN_TYPES; i++) {
+        jsonWritef(&server->out, "%s\"%s\"", i ? "," : "", lspTokenTypeNames[i]);
+    }
+    jsonWritef(&server->out, "],\"tokenModifiers\":[]},\"full\":{\"delta\":true},\"range\":false}},"
+                             "\"serverInfo\":{\"name\":\"servidor de linguagem\",\"version\":\"1.0\"}}}");
+    lspSend(server);
+}
+
+// Função da notificação 'textDocument/didOpen'
+static void lspDidOpen(LspServer *server, uint32_t params) {
+    const char *uri = jsonString(&server->arena, jsonPath(&server->arena, params, "textDocument.uri"), NULL);
+    uint32_t length;
+    const char *text = jsonString(&server->arena, jsonPath(&server->arena, params, "textDocument.text"), &length);
+    if (!uri || !text) {
+        return;
+    }
+    LspDocument *doc = lspFindDocument(server, uri);
+    if (!doc) {
+        server->documents = vectorGrow(server->documents, &server->documentCapacity, server->documentCount + 1,
+                                       sizeof(LspDocument));
+        doc = &server->documents[server->documentCount++];
+        memset(doc, 0, sizeof(*doc));
+        doc->uri = strdup(uri);
+    }
+    doc->version = (int)jsonNumber(&server->arena, jsonPath(&server->arena, params, "textDocument.version"), 0);
+    lspLoadText(server, doc, text, length);
+}
+
+// Função da notificação 'textDocument/didChange' (edições em ordem; sem 'range', o texto inteiro)
+static void lspDidChange(LspServer *server, uint32_t params) {
+    const Arena *arena = &server->arena;
+    LspDocument *doc = lspFindDocument(server, jsonString(arena, jsonPath(arena, params, "textDocument.uri"), NULL));
+    uint32_t changes = jsonMember(arena, params, "contentChanges");
+    if (!doc || !changes || JSON_AT(arena, changes)->kind != JSON_ARRAY) {
+        return;
+    }
+    doc->version = (int)jsonNumber(arena, jsonPath(arena, params, "textDocument.version"), doc->version);
+    for (uint32_t change = JSON_AT(arena, changes)->first; change; change = JSON_AT(arena, change)->next) {
+        uint32_t length;
+        const char *text = jsonString(arena, jsonMember(arena, change, "text"), &length);
+        uint32_t range = jsonMember(arena, change, "range");
+        if (!text) {
+            continue;
+        }
+        if (!range) {
+            lspReplaceText(server, doc, text, length);
+            continue;
+        }
+        lspApplyEdit(server, doc, (uint32_t)jsonNumber(arena, jsonPath(arena, range, "start.line"), 0),
+                     (uint32_t)jsonNumber(arena, jsonPath(arena, range, "start.character"), 0),
+                     (uint32_t)jsonNumber(arena, jsonPath(arena, range, "end.line"), 0),
+                     (uint32_t)jsonNumber(arena, jsonPath(arena, range, "end.character"), 0), text, length);
+    }
+}
+
+// Função da notificação 'textDocument/didClose'
+static void lspDidClose(LspServer *server, uint32_t params) {
+    const Arena *arena = &server->arena;
+    LspDocument *doc = lspFindDocument(server, jsonString(arena, jsonPath(arena, params, "textDocument.uri"), NULL));
+    if (doc) {
+        lspDocumentFree(doc);
+        *doc = server->documents[--server->documentCount];
+    }
+}
+
+// Função dos pedidos 'textDocument/semanticTokens/full' e '.../full/delta'
+static void lspSemanticTokens(LspServer *server, uint32_t id, uint32_t params, int delta) {
+    const Arena *arena = &server->arena;
+    LspDocument *doc = lspFindDocument(server, jsonString(arena, jsonPath(arena, params, "textDocument.uri"), NULL));
+    if (!doc) {
+        lspError(server, id, -32602, "documento não está aberto");
+        return;
+    }
+    const char *previous = jsonString(arena, jsonMember(arena, params, "previousResultId"), NULL);
+    lspWriteId(server, id);
+    jsonWritef(&server->out, ",\"result\":{\"resultId\":\"%u\",", doc->resultId + 1);
+
+    uint32_t count;
+    if (delta && previous && doc->resultId && strtoul(previous, NULL, 10) == doc->resultId) {
+        // Uma única edição: só as linhas mudadas desde o último envio
+        uint32_t start, deleteCount;
+        uint32_t size = lspBuildDelta(server, doc, &start, &deleteCount, &count);
+        jsonWriteRaw(&server->out, "\"edits\":[", 9);
+        if (size || deleteCount) {
+            jsonWritef(&server->out, "{\"start\":%u,\"deleteCount\":%u,\"data\":", start, deleteCount);
+            lspWriteData(server, server->data, size);
+            jsonWriteRaw(&server->out, "}", 1);
+        }
+        jsonWriteRaw(&server->out, "]}}", 3);
+    } else {
+        count = lspBuildData(server, doc);
+        jsonWriteRaw(&server->out, "\"data\":", 7);
+        lspWriteData(server, server->data, count);
+        jsonWriteRaw(&server->out, "}}", 2);
+    }
+    lspKeepData(doc, count);
+    lspSend(server);
+}
+
+// Função para tratar uma mensagem; devolve o nome do método (válido até a próxima mensagem) ou NULL
+const char *lspHandleMessage(LspServer *server, const char *body, uint32_t length) {
+    arenaReset(&server->arena);
+    server->out.length = 0;
+    server->message = body;
+    uint32_t root = jsonParse(&server->arena, body, length);
+    if (!root) {
+        lspError(server, 0, -32700, "mensagem JSON inválida");
+        return NULL;
+    }
+    const char *method = jsonString(&server->arena, jsonMember(&server->arena, root, "method"), NULL);
+    uint32_t id = jsonMember(&server->arena, root, "id");
+    uint32_t params = jsonMember(&server->arena, root, "params");
+    if (!method) {
+        return NULL;   // Resposta do editor: o servidor não faz pedidos
+    }
+
+    if (strcmp(method, "exit") == 0) {
+        server->exited = 1;
+    } else if (server->shutdown) {
+        if (id) {
+            lspError(server, id, -32600, "o servidor está sendo encerrado");
+        }
+    } else if (strcmp(method, "initialize") == 0) {
+        lspInitialize(server, id, params);
+    } else if (strcmp(method, "shutdown") == 0) {
+        server->shutdown = 1;
+        lspWriteId(server, id);
+        jsonWriteRaw(&server->out, ",\"result\":null}", 15);
+        lspSend(server);
+    } else if (strcmp(method, "textDocument/didOpen") == 0) {
+        lspDidOpen(server, params);
+    } else if (strcmp(method, "textDocument/didChange") == 0) {
+        lspDidChange(server, params);
+    } else if (strcmp(method, "textDocument/didClose") == 0) {
+        lspDidClose(server, params);
+    } else if (strcmp(method, "textDocument/semanticTokens/full") == 0) {
+        lspSemanticTokens(server, id, params, 0);
+    } else if (strcmp(method, "textDocument/semanticTokens/full/delta") == 0) {
+        lspSemanticTokens(server, id, params, 1);
+    } else if (id) {
+        char message[160];
+        snprintf(message, sizeof(message), "método não suportado: %s", method);
+        lspError(server, id, -32601, message);
+    }
+    return method;
+}
+
+// Função para ler uma mensagem (cabeçalhos até a linha vazia, depois o corpo); devolve o corpo ou NULL no fim
+char *lspReadMessage(FILE *input, uint32_t *length) {
+    char header[256];
+    long size = -1;
+    for (;;) {
+        if (!fgets(header, sizeof(header), input)) {
+            return NULL;
+        }
+        if (strcmp(header, "\r\n") == 0 || strcmp(header, "\n") == 0) {
+            if (size >= 0) {
+                break;
+            }
+            continue;
+        }
+        if (strncasecmp(header, "Content-Length:", 15) == 0) {
+            size = strtol(header + 15, NULL, 10);
+        }
+    }
+    char *body = malloc((size_t)size + 1);
+    if (!body || fread(body, 1, (size_t)size, input) != (size_t)size) {
+        free(body);
+        return NULL;
+    }
+    body[size] = '\0';
+    *length = (uint32_t)size;
+    return body;
+}
+
+#endif
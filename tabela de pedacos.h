@@ -0,0 +1,197 @@
+/*
+ * Tabela de pedaços (piece table)
+ *
+ * Guarda um texto editado sem nunca mover o texto existente: o conteúdo
+ * original fica em um buffer somente leitura, tudo o que é inserido vai
+ * para o fim de um buffer de acréscimos, e o documento é a sequência de
+ * pedaços (trechos de um dos dois buffers) na ordem em que aparecem. Uma
+ * edição só divide e substitui pedaços; o custo não depende do tamanho do
+ * documento.
+ *
+ * Estruturas principais:
+ * - Piece: Trecho de um dos buffers
+ * - PieceTable: Buffers, pedaços e um cursor com o último pedaço
+ *   encontrado (as edições de quem digita são vizinhas umas das outras,
+ *   então a busca quase sempre anda poucos pedaços)
+ *
+ * Digitação: um caractere inserido logo depois da última inserção estende o
+ * último pedaço em vez de criar outro. Quando os pedaços passam de
+ * PIECE_TABLE_COMPACT, o texto é reescrito como um novo original.
+ */
+
+#ifndef TABELA_DE_PEDACOS_H
+#define TABELA_DE_PEDACOS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vetor dinamico.h"
+
+#define PIECE_TABLE_COMPACT 2048
+
+// Buffers de origem
+typedef enum {
+    PIECE_ORIGINAL,
+    PIECE_ADDED
+} PieceBuffer;
+
+// Estrutura de um pedaço
+typedef struct {
+    uint32_t buffer;
+    uint32_t start;
+    uint32_t length;
+} Piece;
+
+// Estrutura da tabela de pedaços
+typedef struct {
+    char *original;
+    char *added;
+    uint32_t addedLength;
+    uint32_t addedCapacity;
+    Piece *pieces;
+    uint32_t pieceCount;
+    uint32_t pieceCapacity;
+    uint32_t length;           // Tamanho do documento
+    uint32_t cursorPiece;      // Último pedaço encontrado e a sua posição no documento
+    uint32_t cursorOffset;
+} PieceTable;
+
+// Função para inicializar a tabela com uma cópia de 'text'
+void pieceTableInit(PieceTable *table, const char *text, uint32_t length) {
+    memset(table, 0, sizeof(*table));
+    table->original = malloc((size_t)length + 1);
+    if (!table->original) {
+        fprintf(stderr, "Erro: Falha ao alocar a tabela de pedaços.\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(table->original, text, length);
+    table->original[length] = '\0';
+    table->length = length;
+    if (length) {
+        table->pieces = vectorGrow(NULL, &table->pieceCapacity, 1, sizeof(Piece));
+        table->pieces[0] = (Piece){PIECE_ORIGINAL, 0, length};
+        table->pieceCount = 1;
+    }
+}
+
+// Função para liberar a tabela
+void pieceTableFree(PieceTable *table) {
+    free(table->original);
+    free(table->added);
+    free(table->pieces);
+    memset(table, 0, sizeof(*table));
+}
+
+// Função para obter o texto de um pedaço
+static const char *pieceText(const PieceTable *table, const Piece *piece) {
+    return (piece->buffer == PIECE_ORIGINAL ? table->original : table->added) + piece->start;
+}
+
+// Função para encontrar o pedaço que contém 'offset' (pieceCount no fim do documento); 'pieceStart' recebe a sua posição
+uint32_t pieceTableFind(PieceTable *table, uint32_t offset, uint32_t *pieceStart) {
+    uint32_t index = table->cursorPiece, start = table->cursorOffset;
+    if (index > table->pieceCount) {
+        index = start = 0;
+    }
+    while (index > 0 && start > offset) {
+        start -= table->pieces[--index].length;
+    }
+    while (index < table->pieceCount && start + table->pieces[index].length <= offset) {
+        start += table->pieces[index++].length;
+    }
+    table->cursorPiece = index;
+    table->cursorOffset = start;
+    *pieceStart = start;
+    return index;
+}
+
+// Função para garantir que um pedaço comece em 'offset'; devolve o seu índice
+static uint32_t pieceTableSplit(PieceTable *table, uint32_t offset) {
+    uint32_t start, index = pieceTableFind(table, offset, &start);
+    if (index == table->pieceCount || start == offset) {
+        return index;
+    }
+    table->pieces = vectorGrow(table->pieces, &table->pieceCapacity, table->pieceCount + 1, sizeof(Piece));
+    memmove(&table->pieces[index + 2], &table->pieces[index + 1],
+            (table->pieceCount - index - 1) * sizeof(Piece));
+    Piece *piece = &table->pieces[index];
+    uint32_t head = offset - start;
+    table->pieces[index + 1] = (Piece){piece->buffer, piece->start + head, piece->length - head};
+    piece->length = head;
+    table->pieceCount++;
+    return index + 1;
+}
+
+// Função para copiar o trecho [start, end) do documento para 'out' (sem '\0')
+void pieceTableCopy(PieceTable *table, uint32_t start, uint32_t end, char *out) {
+    uint32_t pieceStart, index = pieceTableFind(table, start, &pieceStart);
+    while (start < end && index < table->pieceCount) {
+        const Piece *piece = &table->pieces[index];
+        uint32_t skip = start - pieceStart;
+        uint32_t n = piece->length - skip < end - start ? piece->length - skip : end - start;
+        memcpy(out, pieceText(table, piece) + skip, n);
+        out += n;
+        start += n;
+        pieceStart += piece->length;
+        index++;
+    }
+}
+
+// Função para reescrever o documento como um único pedaço original
+static void pieceTableCompact(PieceTable *table) {
+    char *text = malloc((size_t)table->length + 1);
+    if (!text) {
+        fprintf(stderr, "Erro: Falha ao alocar a tabela de pedaços.\n");
+        exit(EXIT_FAILURE);
+    }
+    table->cursorPiece = table->cursorOffset = 0;
+    pieceTableCopy(table, 0, table->length, text);
+    text[table->length] = '\0';
+    free(table->original);
+    table->original = text;
+    table->addedLength = 0;
+    table->pieceCount = table->length ? 1 : 0;
+    if (table->length) {
+        table->pieces[0] = (Piece){PIECE_ORIGINAL, 0, table->length};
+    }
+    table->cursorPiece = table->cursorOffset = 0;
+}
+
+// Função para substituir o trecho [start, end) por 'text'
+void pieceTableReplace(PieceTable *table, uint32_t start, uint32_t end, const char *text, uint32_t length) {
+    uint32_t first = pieceTableSplit(table, start);
+    uint32_t last = pieceTableSplit(table, end);
+    if (first != last) {
+        memmove(&table->pieces[first], &table->pieces[last], (table->pieceCount - last) * sizeof(Piece));
+        table->pieceCount -= last - first;
+    }
+    table->length -= end - start;
+    table->cursorPiece = first;
+    table->cursorOffset = start;
+    if (!length) {
+        return;
+    }
+
+    table->added = vectorGrow(table->added, &table->addedCapacity, table->addedLength + length, 1);
+    memcpy(table->added + table->addedLength, text, length);
+    Piece *previous = first > 0 ? &table->pieces[first - 1] : NULL;
+    if (previous && previous->buffer == PIECE_ADDED && previous->start + previous->length == table->addedLength) {
+        // Continuação da última inserção
+        previous->length += length;
+        table->cursorPiece = first - 1;
+        table->cursorOffset = start + length - previous->length;
+    } else {
+        table->pieces = vectorGrow(table->pieces, &table->pieceCapacity, table->pieceCount + 1, sizeof(Piece));
+        memmove(&table->pieces[first + 1], &table->pieces[first], (table->pieceCount - first) * sizeof(Piece));
+        table->pieces[first] = (Piece){PIECE_ADDED, table->addedLength, length};
+        table->pieceCount++;
+    }
+    table->addedLength += length;
+    table->length += length;
+    if (table->pieceCount > PIECE_TABLE_COMPACT) {
+        pieceTableCompact(table);
+    }
+}
+
+#endif
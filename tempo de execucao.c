@@ -0,0 +1,20 @@
+/*
+ * Ponto de entrada dos programas compilados
+ *
+ * Ligado junto com o objeto gerado por 'codigo de maquina': inicia o
+ * runtime (tempo de execucao.h), executa o programa e devolve o código
+ * de saída do Main.
+ */
+
+#include "tempo de execucao.h"
+
+// Função do objeto gerado: inicialização dos campos e Main
+int32_t programa_executar(void);
+
+// Função principal
+int main(void) {
+    rtStart(stdout);
+    int32_t status = programa_executar();
+    rtFinish();
+    return status & 0xFF;
+}
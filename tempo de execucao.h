@@ -0,0 +1,156 @@
+/*
+ * Runtime do código de máquina
+ *
+ * Funções chamadas pelo código x86-64 gerado (codigo de maquina.h) para o
+ * que não vale a pena gerar em linha: saída formatada, conversão para
+ * string, concatenação, comparação de strings, criação de vetores e
+ * falhas em tempo de execução. Todas seguem a ABI System V e reaproveitam
+ * a representação e a saída da máquina virtual (maquina virtual.h), de
+ * modo que o programa compilado escreve exatamente o mesmo que o
+ * interpretado.
+ *
+ * O mesmo runtime serve ao executável ligado (tempo de execucao.c) e ao
+ * JIT, que chama as funções diretamente no próprio processo.
+ */
+
+#ifndef TEMPO_DE_EXECUCAO_H
+#define TEMPO_DE_EXECUCAO_H
+
+#include "codigo de maquina.h"
+
+#define RT_FORMAT_CACHE 256
+
+// Estrutura de um formato já analisado (printf e Write com formato composto)
+typedef struct {
+    const void *text;          // String do formato (chave junto com os tipos)
+    const uint8_t *types;
+    VmSegment *segments;
+    uint32_t count;
+    uint32_t capacity;
+} RtFormat;
+
+// Estrutura do estado do runtime
+typedef struct {
+    Vm vm;                     // Apenas a lista de objetos e a saída
+    RtFormat formats[RT_FORMAT_CACHE];
+    uint32_t regs[IR_MAX_ARGUMENTS];
+} Runtime;
+
+static Runtime runtime;
+
+static const char *rtFailures[] = {
+    "divisão por zero", "transbordamento aritmético", "índice fora dos limites do vetor",
+    "referência nula", "tamanho de vetor negativo"
+};
+
+// Função para iniciar o runtime com a saída em 'output'
+void rtStart(FILE *output) {
+    memset(&runtime.vm, 0, offsetof(Vm, out));
+    runtime.vm.out.file = output;
+    runtime.vm.out.length = 0;
+    runtime.vm.out.written = 0;
+    for (uint32_t i = 0; i < IR_MAX_ARGUMENTS; i++) {
+        runtime.regs[i] = i;
+    }
+}
+
+// Função para encerrar o runtime: descarrega a saída e libera os objetos e os formatos
+void rtFinish(void) {
+    vmFlush(&runtime.vm.out);
+    while (runtime.vm.heap) {
+        VmObject *next = runtime.vm.heap->next;
+        free(runtime.vm.heap);
+        runtime.vm.heap = next;
+    }
+    for (uint32_t i = 0; i < RT_FORMAT_CACHE; i++) {
+        free(runtime.formats[i].segments);
+    }
+    memset(runtime.formats, 0, sizeof(runtime.formats));
+}
+
+// Função chamada nas falhas detectadas pelo código gerado; não retorna
+void rtFail(int32_t code, const VmString *function) {
+    vmFlush(&runtime.vm.out);
+    fprintf(stderr, "Erro em tempo de execução em '%.*s': %s\n", function ? (int)function->length : 1,
+            function ? function->data : "?", rtFailures[code]);
+    exit(EXIT_FAILURE);
+}
+
+// Função para obter um formato analisado; 'composite' escolhe a sintaxe de Write ({0})
+RtFormat *rtFormat(const VmString *text, const uint8_t *types, uint32_t count, int composite) {
+    // Cada chamada no código gerado tem o seu vetor de tipos: o par (texto, tipos) identifica o formato
+    uintptr_t hash = ((uintptr_t)text * 31 + (uintptr_t)types) * 0x9E3779B97F4A7C15ull;
+    RtFormat *format = &runtime.formats[(hash >> 32) % RT_FORMAT_CACHE];
+    if (format->text == text && format->types == types) {
+        return format;
+    }
+    format->text = text;
+    format->types = types;
+    format->count = 0;
+    if (composite) {
+        vmParseComposite(&format->segments, &format->count, &format->capacity, text->data, text->length,
+                         runtime.regs, types, count);
+    } else {
+        vmParsePrintf(&format->segments, &format->count, &format->capacity, text->data, text->length,
+                      runtime.regs, types, count);
+    }
+    return format;
+}
+
+// Função para printf(formato, argumentos...); devolve o número de bytes escritos
+int32_t rtPrintf(const VmString *text, const Value *args, const uint8_t *types, uint32_t count) {
+    if (!text) {
+        return 0;
+    }
+    RtFormat *format = rtFormat(text, types, count, 0);
+    return vmWriteFormat(&runtime.vm.out, format->segments, format->count, args);
+}
+
+// Função para Console.Write/WriteLine (com formato composto quando há mais de um argumento)
+void rtWrite(const Value *args, const uint8_t *types, uint32_t count, int32_t newline) {
+    if (count > 1 && types[0] == IR_STRING && args[0].p) {
+        RtFormat *format = rtFormat(args[0].p, types, count, 1);
+        vmWriteFormat(&runtime.vm.out, format->segments, format->count, args);
+    } else if (count) {
+        vmWriteValue(&runtime.vm.out, args[0], types[0]);
+    }
+    if (newline) {
+        vmWrite(&runtime.vm.out, "\n", 1);
+    }
+}
+
+// Função para converter um valor (bits do Value) em string
+VmString *rtToString(int64_t bits, int32_t type) {
+    Value value;
+    value.bits = bits;
+    return vmToString(&runtime.vm, value, (uint8_t)type);
+}
+
+// Função para concatenar duas strings (nulo vale como vazia)
+VmString *rtConcat(const VmString *left, const VmString *right) {
+    uint32_t leftLength = left ? left->length : 0, rightLength = right ? right->length : 0;
+    VmString *result = vmAllocate(&runtime.vm, sizeof(VmString) + leftLength + rightLength + 1);
+    result->length = leftLength + rightLength;
+    if (leftLength) memcpy(result->data, left->data, leftLength);
+    if (rightLength) memcpy(result->data + leftLength, right->data, rightLength);
+    return result;
+}
+
+// Função para comparar duas strings pelo conteúdo
+int32_t rtStringEquals(const VmString *left, const VmString *right) {
+    return left == right || (left && right && left->length == right->length &&
+                             memcmp(left->data, right->data, left->length) == 0);
+}
+
+// Função para criar um vetor com 'length' elementos zerados
+VmArray *rtNewArray(int32_t length, int32_t type, const VmString *function) {
+    if (length < 0) {
+        rtFail(FAIL_NEGATIVE_LENGTH, function);
+    }
+    VmArray *array = vmAllocate(&runtime.vm, sizeof(VmArray) + (size_t)length * sizeof(Value));
+    array->length = (uint32_t)length;
+    array->type = (uint8_t)type;
+    return array;
+}
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * Teste do argumento das diretivas
+ *
+ * Para cada arquivo, analisa o código e exibe, para cada token DIRECTIVE,
+ * a linha, o tamanho do token e o argumento obtido com directiveArgument,
+ * copiado do código fonte (não do texto do token, que é truncado em
+ * MAX_TOKEN_LENGTH - 1 bytes). A saída é comparada com a esperada.
+ */
+
+#include "../analise lexica.h"
+
+// Função principal
+int main(int argc, char *argv[]) {
+    int status = EXIT_SUCCESS;
+    for (int i = 1; i < argc; i++) {
+        long size;
+        char *code = readSourceFile(argv[i], &size);
+        if (!code) {
+            status = EXIT_FAILURE;
+            continue;
+        }
+        tokenCount = 0;
+        lexicalAnalysis(code);
+        for (int t = 0; t < tokenCount; t++) {
+            if (tokens[t].type != DIRECTIVE) {
+                continue;
+            }
+            int line, column, length;
+            int offset = directiveArgument(&tokens[t], &length);
+            offsetToLocation(tokens[t].offset, &line, &column);
+            printf("Linha %d: %d byte(s), argumento [%.*s]\n", line, tokens[t].size, length, code + offset);
+        }
+        freeTokens();
+        freeLineIndex();
+        free(code);
+    }
+    return status;
+}
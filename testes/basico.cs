@@ -0,0 +1,33 @@
+class V {
+    static int[] data;
+    static string name = "vm";
+    static int Sum(int[] v) { int s = 0; for (int i = 0; i < v.Length; i++) s += v[i]; return s; }
+    static int Gcd(int a, int b) { while (b != 0) { int t = a % b; a = b; b = t; } return a; }
+    static double Avg(int a, int b) { return (a + b) / 2.0; }
+    static bool Even(int x) { return x % 2 == 0; }
+    static void Main() {
+        data = new int[8];
+        for (int i = 0; i < data.Length; i++) data[i] = i * i - 3;
+        Console.WriteLine("soma = " + Sum(data));
+        Console.WriteLine("mdc {0} e {1} = {2}", 84, 36, Gcd(84, 36));
+        printf("media %.3f, par %d, nome %s, char %c\n", Avg(3, 4), Even(10), name, 'z');
+        int k = 0; int n = 10;
+        while (k < n) { if (k == 5) n = n - 2; k++; }
+        Console.WriteLine(k);
+        bool b = k > 3 && !(k == 4);
+        Console.WriteLine(b);
+        char c = 'a'; c++;
+        Console.WriteLine(c);
+        double d = 1.0 / 3.0;
+        Console.WriteLine(d);
+        Console.WriteLine(Math.Max(3, 9) + Math.Abs(-4) + Math.Min(2.5, 1.5));
+        string s = "";
+        for (int i = 0; i < 3; i++) s = s + i + ",";
+        Console.WriteLine(s + s.Length);
+        int x = 7; x *= 3; x -= 1; x /= 4;
+        printf("%5d|%-4d|%x|%%\n", x, x, 255);
+        Console.Write("fim");
+        Console.WriteLine();
+        int z = data[9];
+    }
+}
@@ -0,0 +1,5 @@
+#ifndef CONSTANTES_H
+#define CONSTANTES_H
+#include "limites.h"
+static const int Base = 10;
+#endif
@@ -0,0 +1,2 @@
+#pragma once
+static const int Maximo = 100;
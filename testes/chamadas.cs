@@ -0,0 +1,15 @@
+class X {
+    static int counter;
+    static string tag = "t";
+    static double Mix(double a, int b, double c, string s, int d) {
+        counter++;
+        return a * b + c / d + s.Length;
+    }
+    static void Main() {
+        double acc = 0;
+        for (int i = 0; i < 3; i++) {
+            acc = acc + Mix(0.5, i, acc, tag + i, i + 1);
+        }
+        printf("acc=%f counter=%d\n", acc, counter);
+    }
+}
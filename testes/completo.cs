@@ -0,0 +1,53 @@
+class X {
+    static double scale = 1.5;
+    static int counter;
+    static string tag = "t";
+    static double[] weights;
+    static int Fib(int n) { if (n < 2) return n; return Fib(n - 1) + Fib(n - 2); }
+    static double Mix(double a, int b, double c, string s, int d) {
+        counter++;
+        return a * b + c / d + s.Length;
+    }
+    static int Many(int a, int b, int c, int d, int e, int f, int g, int h, int i, int j) {
+        int x1 = a + b, x2 = b + c, x3 = c + d, x4 = d + e, x5 = e + f, x6 = f + g, x7 = g + h, x8 = h + i, x9 = i + j;
+        int y = x1 * x2 - x3 * x4 + x5 * x6 - x7 * x8 + x9;
+        return y + x1 + x2 + x3 + x4 + x5 + x6 + x7 + x8 + x9 + a * j;
+    }
+    static void Main() {
+        weights = new double[5];
+        for (int i = 0; i < weights.Length; i++) weights[i] = i * scale - 2.25;
+        double acc = 0;
+        for (int i = 0; i < weights.Length; i++) {
+            double w = weights[i];
+            acc = acc + Mix(w, i, acc, tag + i, i + 1);
+        }
+        printf("acc=%f counter=%d fib=%d\n", acc, counter, Fib(20));
+        printf("many=%d\n", Many(1, 2, 3, 4, 5, 6, 7, 8, 9, 10));
+        int p = 1, q = 2, r = 3, s = 4, t = 5, u = 6, v = 7, w2 = 8, y = 9;
+        for (int k = 0; k < 100; k++) {
+            p = p + q; q = q + r; r = r + s * 3; s = s - t; t = t + u % 5; u = u + v; v = v * 3 % 1000; w2 = w2 + y; y = y - k;
+            if (Fib(5) > 100) { p = 0; }
+        }
+        Console.WriteLine("{0} {1} {2} {3} {4} {5} {6} {7} {8}", p, q, r, s, t, u, v, w2, y);
+        double a = -0.0, nan = 0.0 / 0.0;
+        Console.WriteLine(a == 0.0);
+        Console.WriteLine(nan == nan);
+        Console.WriteLine(nan != nan);
+        Console.WriteLine(nan < 1.0);
+        Console.WriteLine(1.0 <= nan);
+        Console.WriteLine(Math.Abs(-2.5) + Math.Sqrt(16.0) + Math.Pow(2.0, 10.0));
+        Console.WriteLine(Math.Max(-3, -9) * Math.Min(7, 2) + Math.Abs(-11));
+        Console.WriteLine(-7 / 2 + " " + -7 % 2 + " " + 7.5 % 2.0);
+        string e = "ab" + "c";
+        Console.WriteLine(e == "abc");
+        Console.WriteLine(e != "abc");
+        Console.WriteLine(7 / -2);
+        char ch = 'A';
+        Console.WriteLine(ch + 1);
+        Console.WriteLine(tag + ch + 2.5 + true);
+        int big = 2147483647;
+        Console.WriteLine(big + 1);
+        int zero = counter - counter;
+        Console.WriteLine(10 / zero);
+    }
+}
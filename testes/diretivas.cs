@@ -0,0 +1,28 @@
+#include <stdio.h>
+#define DEBUG
+#region Principal
+class P {
+#if DEBUG && !RELEASE
+    static int Modo() { return 1; }
+#elif TRACE
+    static int Modo() { return 2; }
+#else
+    static int Modo() { return 3; } // #endif aqui não conta
+#endif
+#if false
+  lixo que não compila { { (
+  #if X
+  #else
+  #endif
+#elif (defined(DEBUG) || TRACE) && true
+    static int Extra() { return 10; }
+#endif
+#undef DEBUG
+#ifdef DEBUG
+    erro
+#endif
+#ifndef DEBUG
+    static void Main() { printf("%d\n", Modo() + Extra()); }  /* #if */
+#endif
+}
+#endregion
@@ -0,0 +1,183 @@
+// Compilação condicional: símbolos, ramos inativos e '#' que não inicia diretiva
+// (analisado com --definir TRACE)
+#define DEBUG
+#undef RELEASE
+class Condicionais {
+#if DEBUG && !RELEASE
+    int depurar;
+#elif TRACE
+    int rastrear;
+#else
+    int nenhum;
+#endif
+#if RELEASE
+    lixo { ( " não analisado
+  #if DEBUG
+    int aninhadoInativo;
+  #else
+    int outroInativo;
+  #endif
+#elif TRACE && (DEBUG || false)
+    int ramoElif;
+#else
+    int ramoElse;
+#endif
+#undef DEBUG
+#ifdef DEBUG
+    int semDebug;
+#endif
+#ifndef DEBUG
+    int depoisDoUndef;
+#endif
+    /* comentário */ #define A
+    /* comentário de
+       duas linhas */ #define B
+#if A || B
+    int nemAnemB;
+#endif
+    #region   Região com argumento   // comentário fora do argumento
+#pragma warning disable CS0168, CS0219, CS0414, CS0649, CS0169, CS1998, CS4014, CS8618, CS8600, CS8602, CS8604 // mais de 100 bytes
+#endregion
+
+// Mais fundo que MAX_CONDITIONAL_DEPTH (64): o '#if' 65 e os seus ramos ficam ativos e cada '#endif' fecha o seu '#if'
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if TRACE
+#if false
+    int profundoIf;
+#else
+    int profundoElse;
+#endif
+    int nivel64;
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#endif
+#else
+    int nivel1Inativo;
+#endif
+#if false
+    int inativoNoFim;
+#endif
+    int fim;
+}
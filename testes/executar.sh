@@ -0,0 +1,356 @@
+#!/bin/bash
+#
+# Testes do compilador
+#
+# Compila os programas da raiz em um diretório de trabalho e confere, com
+# os programas .cs deste diretório, que caminhos diferentes até o mesmo
+# resultado concordam entre si. Cada conferência exibe "ok" ou "FALHA".
+#
+# Uso: testes/executar.sh [diretório de trabalho]
+# - O diretório de trabalho (padrão: um novo em $TMPDIR) guarda os
+#   executáveis e as saídas comparadas
+# - CC escolhe o compilador C (padrão: gcc)
+#
+# Termina com código 1 se alguma conferência falhar.
+
+set -u
+
+TESTES=$(cd "$(dirname "$0")" && pwd)
+RAIZ=$(dirname "$TESTES")
+TRABALHO=${1:-$(mktemp -d "${TMPDIR:-/tmp}/testes.XXXXXX")}
+CC=${CC:-gcc}
+FALHAS=0
+CONFERENCIAS=0
+
+mkdir -p "$TRABALHO" || exit 1
+
+# Função para compilar um programa da raiz: compilar <executável> <fonte .c> [opções do compilador]...
+compilar() {
+    local executavel=$1 fonte=$2
+    shift 2
+    if ! "$CC" -O2 "$@" -o "$TRABALHO/$executavel" "$RAIZ/$fonte" -lm -lpthread; then
+        echo "Erro: $fonte não compilou" >&2
+        exit 1
+    fi
+}
+
+# Função para registrar uma conferência: conferir <descrição> <comando>...
+conferir() {
+    local descricao=$1
+    shift
+    CONFERENCIAS=$((CONFERENCIAS + 1))
+    if "$@"; then
+        echo "ok    $descricao"
+    else
+        echo "FALHA $descricao"
+        FALHAS=$((FALHAS + 1))
+    fi
+}
+
+# Função para gravar a saída padrão e o código de saída de um comando: executar <arquivo> <comando>...
+executar() {
+    local saida=$1
+    shift
+    "$@" > "$saida" 2> /dev/null
+    echo "código de saída: $?" >> "$saida"
+}
+
+# Função para comparar arquivos em silêncio: iguais <referência> <arquivo>...
+iguais() {
+    local referencia=$1 arquivo
+    shift
+    for arquivo in "$@"; do
+        cmp -s "$referencia" "$arquivo" || return 1
+    done
+}
+
+# Função para executar um comando sem exibir a sua saída padrão
+quieto() {
+    "$@" > /dev/null
+}
+
+# Função para gravar a saída da análise léxica sem as medidas de tempo e, depois dela, os avisos:
+# analisar <arquivo> <opções>...
+analisar() {
+    local saida=$1
+    shift
+    "$TRABALHO/analise lexica" "$@" 2> "$saida.avisos" | sed -e '/^Tempo:/d' -e 's/ ([0-9.]* ms)//' > "$saida"
+    cat "$saida.avisos" >> "$saida"
+}
+
+# Função para extrair de uma árvore sintática (entrada padrão) as subárvores dos métodos com o nome dado:
+# metodos <nome>
+metodos() {
+    awk -v metodo="'$1'" '
+        dentro { match($0, /^ */); if (RLENGTH > recuo) { print; next } dentro = 0 }
+        $1 == "METHOD" && $2 == metodo { dentro = 1; match($0, /^ */); recuo = RLENGTH; print }'
+}
+
+# Função para conferir que o corpo de cada método analisado sob demanda (--metodo) tem a mesma subárvore da
+# análise completa: corposIguais <programa .cs>
+corposIguais() {
+    local programa=$1 nome completa
+    completa=$("$TRABALHO/analise sintatica" "$programa" 2> /dev/null)
+    for nome in $(echo "$completa" | awk '$1 == "METHOD" { gsub("\x27", "", $2); print $2 }' | sort -u); do
+        [ "$(echo "$completa" | metodos "$nome")" = \
+          "$("$TRABALHO/analise sintatica" --metodo "$nome" "$programa" 2> /dev/null | metodos "$nome")" ] || return 1
+    done
+}
+
+# Função para conferir, na saída da análise léxica, que o texto de cada token está no arquivo, na linha e na coluna
+# (em bytes) exibidos: localizacoesConferem <saída>
+localizacoesConferem() {
+    LC_ALL=C awk '
+        function carregar(caminho,    texto, n) {
+            if (caminho in carregado) return
+            carregado[caminho] = 1
+            n = 0
+            while ((getline texto < caminho) > 0) linhas[caminho, ++n] = texto
+            close(caminho)
+        }
+        /^Analisando / { arquivo = $0; sub(/^Analisando [^:]*: /, "", arquivo); principal = arquivo }
+        /^Arquivo: / { arquivo = substr($0, 10) }
+        /^Token: / {
+            valor = $0
+            sub(/^Token: /, "", valor)
+            sub(/ +Linha: [0-9]+ +Coluna: [0-9]+ +Tipo: .*$/, "", valor)
+            split(substr($0, index($0, " Linha: ")), campos, /[^0-9]+/)
+            carregar(arquivo)
+            if (substr(linhas[arquivo, campos[2]], campos[3], length(valor)) != valor) {
+                print "Token \"" valor "\" fora do lugar em " arquivo ":" campos[2] ":" campos[3] > "/dev/stderr"
+                erros++
+            }
+            tokens++
+        }
+        END { exit erros > 0 || tokens == 0 }' "$1"
+}
+
+# Função para repetir uma sessão do servidor de linguagem e conferir só os tokens (os tempos dependem da máquina)
+sessaoConfere() {
+    local relatorio=$1.relatorio
+    "$TRABALHO/servidor de linguagem" --repetir "$1" > "$relatorio"
+    grep -q "todas iguais ao array completo" "$relatorio" &&
+        grep -q "Conferência: tokens idênticos aos da análise completa" "$relatorio" &&
+        ! grep -q "DIFERENTE" "$relatorio"
+}
+
+echo "Compilando em $TRABALHO"
+compilar "maquina virtual" "maquina virtual.c"
+compilar "codigo de maquina" "codigo de maquina.c"
+compilar "codigo de maquina jit" "codigo de maquina jit.c"
+compilar "servidor de linguagem" "servidor de linguagem.c"
+compilar "analise lexica" "analise lexica.c"
+compilar "analise sintatica" "analise sintatica.c"
+compilar "analise semantica" "analise semantica.c"
+compilar "busca de codigo" "busca de codigo.c"
+compilar "fluxo de tokens" "testes/fluxo de tokens.c"
+compilar "argumentos de diretivas" "testes/argumentos de diretivas.c"
+compilar "tokens com localidade" "testes/tokens com localidade.c"
+compilar "servidor de compilacao" "servidor de compilacao.c"
+compilar "cliente de compilacao" "cliente de compilacao.c"
+if grep -qw ssse3 /proc/cpuinfo 2> /dev/null; then
+    compilar "fluxo de tokens ssse3" "testes/fluxo de tokens.c" -mssse3
+fi
+
+# Otimização (otimizacao.h): o programa otimizado faz o mesmo que o original na máquina virtual
+for programa in "$TESTES"/*.cs; do
+    nome=$(basename "$programa" .cs)
+    executar "$TRABALHO/$nome.vm" "$TRABALHO/maquina virtual" "$programa"
+    executar "$TRABALHO/$nome.vm-sem-otimizacao" "$TRABALHO/maquina virtual" --sem-otimizacao "$programa"
+    conferir "otimização: $nome.cs" iguais "$TRABALHO/$nome.vm" "$TRABALHO/$nome.vm-sem-otimizacao"
+done
+
+# Código de máquina (codigo de maquina.h): o executável nativo tem a mesma saída e o mesmo código de saída
+# que a máquina virtual (--comparar)
+for programa in "$TESTES"/*.cs; do
+    nome=$(basename "$programa" .cs)
+    conferir "nativo x máquina virtual: $nome.cs" \
+        quieto "$TRABALHO/codigo de maquina" "$programa" --saida "$TRABALHO/$nome.nativo" --comparar
+done
+
+# JIT (codigo de maquina jit.h): o Main executado no próprio processo faz o mesmo que a máquina virtual
+for programa in "$TESTES"/*.cs; do
+    nome=$(basename "$programa" .cs)
+    executar "$TRABALHO/$nome.jit" "$TRABALHO/codigo de maquina jit" "$programa"
+    conferir "JIT x máquina virtual: $nome.cs" iguais "$TRABALHO/$nome.jit" "$TRABALHO/$nome.vm"
+done
+
+# Compilação paralela (compilacao paralela.h): o objeto é o mesmo byte a byte com qualquer número de threads
+for programa in "$TESTES"/*.cs; do
+    nome=$(basename "$programa" .cs)
+    for threads in 1 2 4; do
+        quieto "$TRABALHO/codigo de maquina" "$programa" --saida "$TRABALHO/$nome.threads$threads" \
+            --threads "$threads"
+    done
+    conferir "objeto com 1, 2 e 4 threads: $nome.cs" \
+        iguais "$TRABALHO/$nome.threads1.o" "$TRABALHO/$nome.threads2.o" "$TRABALHO/$nome.threads4.o"
+done
+
+# Servidor de linguagem (servidor de linguagem.h): depois de cada edição da sessão simulada, as respostas de tokens
+# aplicadas como o editor faz e os tokens mantidos de forma incremental são iguais aos de uma análise completa
+# (a sincronização completa reenvia o texto a cada tecla, então fica com os programas menores)
+for sessao in simular:completo simular:funcoes simular:unicode simular-completa:completo simular-completa:unicode; do
+    modo=${sessao%%:*}
+    nome=${sessao#*:}
+    sessao="$TRABALHO/$nome.$modo.lsp"
+    quieto "$TRABALHO/servidor de linguagem" "--$modo" "$TESTES/$nome.cs" "$sessao"
+    conferir "servidor de linguagem ($modo): $nome.cs" sessaoConfere "$sessao"
+done
+
+# Pipeline (pipeline.h): com o analisador léxico em outra thread, a árvore sintática é a mesma da análise
+# sequencial (só a linha de tempo e a das estatísticas do pipeline mudam), inclusive com um comando de mais
+# tokens que o anel inteiro
+{
+    echo "class Longa {"
+    echo "    static void Main() {"
+    printf "        int x = 1"
+    for i in $(seq 3000); do
+        printf " + 1"
+    done
+    echo ";"
+    echo '        printf("%d\n", x);'
+    echo "    }"
+    echo "}"
+} > "$TRABALHO/longa.cs"
+for programa in "$TESTES"/*.cs "$TRABALHO/longa.cs"; do
+    nome=$(basename "$programa" .cs)
+    for modo in sequencial pipeline; do
+        opcao=$([ "$modo" = pipeline ] && echo --pipeline)
+        "$TRABALHO/analise sintatica" $opcao "$programa" 2>&1 |
+            sed -e '/^Tempo das análises/d' -e '/^Pipeline:/d' > "$TRABALHO/$nome.$modo"
+    done
+    conferir "pipeline x sequencial: $nome.cs" iguais "$TRABALHO/$nome.sequencial" "$TRABALHO/$nome.pipeline"
+done
+
+# Análise preguiçosa (analise sintatica.h): o corpo de cada método analisado sob demanda tem a mesma subárvore que
+# na análise completa
+for programa in "$TESTES"/*.cs; do
+    conferir "corpos sob demanda x análise completa: $(basename "$programa")" corposIguais "$programa"
+done
+
+# Análise semântica (analise semantica.h): os símbolos e os erros de cada programa de semantica/ (atribuição
+# composta na declaração, nomes não declarados e sombreamento entre escopos aninhados) são os esperados
+for programa in "$TESTES"/semantica/*.cs; do
+    nome=$(basename "$programa" .cs)
+    "$TRABALHO/analise semantica" "$programa" > "$TRABALHO/$nome.txt" 2> "$TRABALHO/$nome.txt.erros"
+    cat "$TRABALHO/$nome.txt.erros" >> "$TRABALHO/$nome.txt"
+    sed -i "s|$TESTES/||" "$TRABALHO/$nome.txt"
+    conferir "análise semântica: $nome.cs" iguais "$TESTES/esperado/$nome.txt" "$TRABALHO/$nome.txt"
+done
+
+# Diretivas (analise lexica.h): os tokens de diretivas/condicionais.cs (símbolos de '#define', '#undef' e
+# --definir, ramos de '#if', '#elif' e '#else', trechos inativos, '#' depois de comentário e '#if' mais fundo
+# que MAX_CONDITIONAL_DEPTH) e o argumento de cada diretiva são os esperados
+analisar "$TRABALHO/condicionais.txt" --definir TRACE "$TESTES/diretivas/condicionais.cs"
+sed -i "s|$TESTES/||" "$TRABALHO/condicionais.txt"
+conferir "diretivas: tokens de condicionais.cs" iguais "$TESTES/esperado/condicionais.txt" "$TRABALHO/condicionais.txt"
+"$TRABALHO/argumentos de diretivas" "$TESTES/diretivas/condicionais.cs" > "$TRABALHO/argumentos.txt"
+conferir "diretivas: argumentos de condicionais.cs" iguais "$TESTES/esperado/argumentos.txt" "$TRABALHO/argumentos.txt"
+
+# Trivia (analise lexica.h): a tabela de trivia e os comentários de documentação ('///' e os de bloco com duas
+# estrelas, mas não '////' nem os de três estrelas) de trivia/documentacao.cs são os esperados, e gravar a
+# trivia não muda os tokens de nenhum programa
+analisar "$TRABALHO/documentacao.txt" --trivia "$TESTES/trivia/documentacao.cs"
+sed -i "s|$TESTES/||" "$TRABALHO/documentacao.txt"
+conferir "trivia: documentacao.cs" iguais "$TESTES/esperado/documentacao.txt" "$TRABALHO/documentacao.txt"
+"$TRABALHO/analise lexica" --trivia "$TESTES"/*.cs | grep -e '^Analisando' -e '^Token:' > "$TRABALHO/trivia.com"
+"$TRABALHO/analise lexica" "$TESTES"/*.cs | grep -e '^Analisando' -e '^Token:' > "$TRABALHO/trivia.sem"
+conferir "trivia: tokens iguais com e sem --trivia" iguais "$TRABALHO/trivia.sem" "$TRABALHO/trivia.com"
+
+# Localizações (analise lexica.h e localizacao de codigo.h): a linha e a coluna de cada token, calculadas sob
+# demanda pelo índice de inícios de linha, e o arquivo, a linha e a coluna resolvidos da SourceLoc de cada token
+# de --inclusoes, inclusive nos cabeçalhos incluídos, apontam para o texto do token (utf16.cs fica de fora: é
+# convertido em memória e as colunas são do texto convertido)
+programas=()
+for programa in "$TESTES"/*.cs; do
+    [ "$(basename "$programa")" = utf16.cs ] || programas+=("$programa")
+done
+"$TRABALHO/analise lexica" "${programas[@]}" > "$TRABALHO/localizacoes.lexico" 2> /dev/null
+conferir "localizações: linha e coluna do índice sob demanda" localizacoesConferem "$TRABALHO/localizacoes.lexico"
+"$TRABALHO/analise lexica" --inclusoes --threads 4 --incluir "$TESTES/cabecalhos" "${programas[@]}" \
+    > "$TRABALHO/localizacoes.inclusoes" 2> /dev/null
+conferir "localizações: arquivo, linha e coluna da SourceLoc com --inclusoes" \
+    localizacoesConferem "$TRABALHO/localizacoes.inclusoes"
+
+# Localidade (analise lexica.h): sob outra LC_CTYPE, de preferência uma de um byte por caractere (em que a
+# <ctype.h> classifica os bytes acima de 127), os tokens são os mesmos da localidade C, inclusive num programa
+# gerado com cada um desses bytes em identificadores, números, literais e comentários
+localidade=$(locale -a 2> /dev/null | grep -ivx -e C -e POSIX | awk '{ print (tolower($0) ~ /utf-?8/), $0 }' |
+    sort -n | head -n 1 | cut -d ' ' -f 2-)
+if [ -n "$localidade" ]; then
+    for byte in $(seq 128 255); do
+        caractere=$(printf '\\%o' "$byte")
+        printf "x${caractere}y ${caractere} 1${caractere}2 \"${caractere}\" //${caractere}\n"
+    done > "$TRABALHO/bytes altos.cs"
+    LC_ALL=C "$TRABALHO/tokens com localidade" "$TRABALHO/bytes altos.cs" "$TESTES"/*.cs \
+        > "$TRABALHO/localidade.c" 2>&1
+    LC_ALL=$localidade "$TRABALHO/tokens com localidade" "$TRABALHO/bytes altos.cs" "$TESTES"/*.cs \
+        > "$TRABALHO/localidade.outra" 2>&1
+    conferir "localidade C x $localidade: análise léxica" iguais "$TRABALHO/localidade.c" "$TRABALHO/localidade.outra"
+fi
+
+# Fluxo de tokens (fluxo de tokens.h): compactar e decodificar devolve a mesma lista de lexTokens, com e sem SSSE3
+for programa in "$TESTES"/*.cs; do
+    nome=$(basename "$programa" .cs)
+    for decodificador in "fluxo de tokens" "fluxo de tokens ssse3"; do
+        if [ -x "$TRABALHO/$decodificador" ]; then
+            conferir "$decodificador: $nome.cs" quieto "$TRABALHO/$decodificador" "$programa"
+        fi
+    done
+done
+
+# Leitura em lote (leitura em lote.h): io_uring e pread entregam o mesmo conteúdo, inclusive os cabeçalhos lidos
+# avulsos durante --inclusoes e os arquivos em outra codificação
+for leitura in io_uring pread; do
+    analisar "$TRABALHO/lexico.$leitura" --leitura "$leitura" "$TESTES"/*.cs
+    analisar "$TRABALHO/inclusoes.$leitura" --leitura "$leitura" --threads 4 --incluir "$TESTES/cabecalhos" \
+        "$TESTES"/*.cs
+    quieto "$TRABALHO/busca de codigo" --leitura "$leitura" --threads 4 --indexar "$TRABALHO/indice.$leitura" "$TESTES"
+done
+conferir "leitura io_uring x pread: análise léxica" iguais "$TRABALHO/lexico.io_uring" "$TRABALHO/lexico.pread"
+conferir "leitura io_uring x pread: --inclusoes" iguais "$TRABALHO/inclusoes.io_uring" "$TRABALHO/inclusoes.pread"
+conferir "leitura io_uring x pread: índice de tokens" iguais "$TRABALHO/indice.io_uring" "$TRABALHO/indice.pread"
+
+# Busca de código (indice de tokens.h): as ocorrências de padrões conhecidos nos programas deste diretório são as
+# esperadas (esperado/busca.txt), com o caminho relativo a este diretório e sem as medidas
+quieto "$TRABALHO/busca de codigo" --indexar "$TRABALHO/indice.busca" "$TESTES"/*.cs
+for padrao in "new IDENTIFIER (" "Fib (" "Fib ( IDENTIFIER * NUM_LITERAL )" "Math . IDENTIFIER (" "Inexistente ("; do
+    echo "== $padrao"
+    read -r -a elementos <<< "$padrao"
+    "$TRABALHO/busca de codigo" --buscar "$TRABALHO/indice.busca" "${elementos[@]}"
+done | sed -e "s|^$TESTES/||" -e 's/ em [0-9]* arquivo(s) indexado(s) ([0-9.]* ms)$//' > "$TRABALHO/busca.txt"
+conferir "busca de código: ocorrências esperadas" iguais "$TESTES/esperado/busca.txt" "$TRABALHO/busca.txt"
+
+# Memória grande (memoria grande.h): o tipo de página da lista de tokens e do código não muda a análise
+for paginas in nenhuma transparentes explicitas; do
+    analisar "$TRABALHO/paginas.$paginas" --paginas "$paginas" "$TESTES"/*.cs
+done
+conferir "páginas nenhuma, transparentes e explícitas: análise léxica" \
+    iguais "$TRABALHO/paginas.nenhuma" "$TRABALHO/paginas.transparentes" "$TRABALHO/paginas.explicitas"
+
+# Servidor de compilação (servidor de compilacao.h): 'lexico' pelo cliente escreve o mesmo que a análise léxica
+# direta, inclusive a linha de codificação e uma saída maior que um quadro do protocolo (FRAME_MAX_LENGTH)
+for i in $(seq 100); do
+    cat "$TESTES/funcoes.cs"
+done > "$TRABALHO/grande.cs"
+soquete="$TRABALHO/servidor.sock"
+quieto "$TRABALHO/servidor de compilacao" --socket "$soquete" &
+for i in $(seq 50); do
+    [ -S "$soquete" ] && break
+    sleep 0.1
+done
+for programa in "$TESTES"/*.cs "$TRABALHO/grande.cs"; do
+    nome=$(basename "$programa" .cs)
+    "$TRABALHO/cliente de compilacao" --socket "$soquete" lexico "$programa" > "$TRABALHO/$nome.servidor" \
+        2> "$TRABALHO/$nome.servidor.avisos"
+    cat "$TRABALHO/$nome.servidor.avisos" >> "$TRABALHO/$nome.servidor"
+    analisar "$TRABALHO/$nome.direto" "$programa"
+    conferir "servidor de compilação x análise léxica: $nome.cs" iguais "$TRABALHO/$nome.direto" "$TRABALHO/$nome.servidor"
+done
+quieto "$TRABALHO/cliente de compilacao" --socket "$soquete" parar
+wait
+
+# Resumo
+echo
+echo "$((CONFERENCIAS - FALHAS)) de $CONFERENCIAS conferência(s) ok"
+[ "$FALHAS" -eq 0 ]
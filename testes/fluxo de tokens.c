@@ -0,0 +1,79 @@
+/*
+ * Teste do fluxo de tokens compactado
+ *
+ * Para cada arquivo, analisa o código com lexTokens, compacta a lista
+ * (fluxo de tokens.h), decodifica de novo e confere que cada token tem o
+ * mesmo texto, deslocamento, tipo e tamanho da lista original, tanto pela
+ * decodificação completa quanto pela dos campos. Exibe uma linha por
+ * arquivo e termina com código 1 se algum for diferente ou não puder ser
+ * compactado.
+ *
+ * Compilado com e sem SSSE3, confere os dois caminhos da decodificação.
+ */
+
+#include "../fluxo de tokens.h"
+
+// Função para conferir o fluxo de um arquivo; devolve 0 ou 1 (diferente)
+int checkFile(const char *path) {
+    long size;
+    char *code = readSourceFile(path, &size);
+    if (!code) {
+        return 1;
+    }
+    tokenCount = 0;
+    lexTokens(code);
+
+    TokenStream stream;
+    if (tokenStreamEncode(&stream, tokens, tokenCount, code) != 0) {
+        printf("%s: o fluxo não pôde ser compactado\n", path);
+        free(code);
+        return 1;
+    }
+    Token *decoded = malloc(((size_t)tokenCount + 1) * sizeof(Token));
+    uint32_t *offsets = malloc(((size_t)tokenCount + 1) * sizeof(uint32_t));
+    uint32_t *sizes = malloc(((size_t)tokenCount + 1) * sizeof(uint32_t));
+    uint8_t *types = malloc((size_t)tokenCount + 1);
+    if (!decoded || !offsets || !sizes || !types) {
+        fprintf(stderr, "Erro: Falha ao alocar a decodificação.\n");
+        exit(EXIT_FAILURE);
+    }
+    tokenStreamDecode(&stream, code, decoded);
+    tokenStreamDecodeFields(&stream, offsets, sizes, types);
+
+    int first = -1;
+    for (int i = 0; i < tokenCount && first < 0; i++) {
+        const Token *original = &tokens[i], *copy = &decoded[i];
+        if (strcmp(original->value, copy->value) != 0 || original->offset != copy->offset ||
+            original->type != copy->type || original->size != copy->size || offsets[i] != (uint32_t)original->offset ||
+            sizes[i] != (uint32_t)original->size || types[i] != (uint8_t)original->type) {
+            first = i;
+        }
+    }
+    if (stream.count != (uint32_t)tokenCount) {
+        first = first < 0 ? (int)stream.count : first;
+    }
+    if (first >= 0) {
+        printf("%s: DIFERENTE no token %d de %d\n", path, first, tokenCount);
+    } else {
+        printf("%s: %d token(s) em %u bytes (%.2f bytes por token)\n", path, tokenCount, stream.size,
+               tokenCount ? (double)stream.size / tokenCount : 0.0);
+    }
+
+    tokenStreamFree(&stream);
+    free(decoded);
+    free(offsets);
+    free(sizes);
+    free(types);
+    freeTokens();
+    free(code);
+    return first >= 0;
+}
+
+// Função principal
+int main(int argc, char *argv[]) {
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        failures += checkFile(argv[i]);
+    }
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
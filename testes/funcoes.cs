@@ -0,0 +1,247 @@
+class Gen {
+    static int total;
+    static string label = "g";
+    static string F0(int a, int b) { string t = "s0:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static double F1(int a, int b) { double x = a * 0.5 + 1.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F2(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 2; }
+    static int F3(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 4 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F4(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 5 - b; } if (s > 100) { s = s % 97; } return s; }
+    static string F5(int a, int b) { string t = "s5:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static int F6(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 7 - b; } if (s > 100) { s = s % 97; } return s; }
+    static double F7(int a, int b) { double x = a * 0.5 + 7.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F8(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 2 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F9(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 3 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F10(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 10; }
+    static int F11(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 5 - b; } if (s > 100) { s = s % 97; } return s; }
+    static double F12(int a, int b) { double x = a * 0.5 + 12.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F13(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 7 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F14(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 14; }
+    static int F15(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 2 - b; } if (s > 100) { s = s % 97; } return s; }
+    static double F16(int a, int b) { double x = a * 0.5 + 16.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F17(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 4 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F18(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 18; }
+    static double F19(int a, int b) { double x = a * 0.5 + 19.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F20(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 7 - b; } if (s > 100) { s = s % 97; } return s; }
+    static double F21(int a, int b) { double x = a * 0.5 + 21.25; if (b > 2) { x = x / 3.0; } return x; }
+    static string F22(int a, int b) { string t = "s22:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static int F23(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 23; }
+    static int F24(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 4 - b; } if (s > 100) { s = s % 97; } return s; }
+    static string F25(int a, int b) { string t = "s25:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static double F26(int a, int b) { double x = a * 0.5 + 26.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F27(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 7 - b; } if (s > 100) { s = s % 97; } return s; }
+    static double F28(int a, int b) { double x = a * 0.5 + 28.25; if (b > 2) { x = x / 3.0; } return x; }
+    static string F29(int a, int b) { string t = "s29:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static int F30(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 3 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F31(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 4 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F32(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 5 - b; } if (s > 100) { s = s % 97; } return s; }
+    static double F33(int a, int b) { double x = a * 0.5 + 33.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F34(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 34; }
+    static string F35(int a, int b) { string t = "s35:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static int F36(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 36; }
+    static string F37(int a, int b) { string t = "s37:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static string F38(int a, int b) { string t = "s38:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static double F39(int a, int b) { double x = a * 0.5 + 39.25; if (b > 2) { x = x / 3.0; } return x; }
+    static double F40(int a, int b) { double x = a * 0.5 + 40.25; if (b > 2) { x = x / 3.0; } return x; }
+    static double F41(int a, int b) { double x = a * 0.5 + 41.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F42(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 1 - b; } if (s > 100) { s = s % 97; } return s; }
+    static string F43(int a, int b) { string t = "s43:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static int F44(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 44; }
+    static int F45(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 45; }
+    static int F46(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 5 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F47(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 6 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F48(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 48; }
+    static string F49(int a, int b) { string t = "s49:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static double F50(int a, int b) { double x = a * 0.5 + 50.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F51(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 51; }
+    static int F52(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 4 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F53(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 5 - b; } if (s > 100) { s = s % 97; } return s; }
+    static string F54(int a, int b) { string t = "s54:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static string F55(int a, int b) { string t = "s55:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static string F56(int a, int b) { string t = "s56:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static int F57(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 57; }
+    static int F58(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 58; }
+    static int F59(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 4 - b; } if (s > 100) { s = s % 97; } return s; }
+    static string F60(int a, int b) { string t = "s60:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static int F61(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 61; }
+    static int F62(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 7 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F63(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 1 - b; } if (s > 100) { s = s % 97; } return s; }
+    static string F64(int a, int b) { string t = "s64:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static int F65(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 65; }
+    static int F66(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 66; }
+    static int F67(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 5 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F68(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 68; }
+    static double F69(int a, int b) { double x = a * 0.5 + 69.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F70(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 1 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F71(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 71; }
+    static double F72(int a, int b) { double x = a * 0.5 + 72.25; if (b > 2) { x = x / 3.0; } return x; }
+    static string F73(int a, int b) { string t = "s73:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static double F74(int a, int b) { double x = a * 0.5 + 74.25; if (b > 2) { x = x / 3.0; } return x; }
+    static double F75(int a, int b) { double x = a * 0.5 + 75.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F76(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 76; }
+    static int F77(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 77; }
+    static double F78(int a, int b) { double x = a * 0.5 + 78.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F79(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 79; }
+    static string F80(int a, int b) { string t = "s80:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static double F81(int a, int b) { double x = a * 0.5 + 81.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F82(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 82; }
+    static string F83(int a, int b) { string t = "s83:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static int F84(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 84; }
+    static int F85(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 85; }
+    static double F86(int a, int b) { double x = a * 0.5 + 86.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F87(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 4 - b; } if (s > 100) { s = s % 97; } return s; }
+    static double F88(int a, int b) { double x = a * 0.5 + 88.25; if (b > 2) { x = x / 3.0; } return x; }
+    static double F89(int a, int b) { double x = a * 0.5 + 89.25; if (b > 2) { x = x / 3.0; } return x; }
+    static double F90(int a, int b) { double x = a * 0.5 + 90.25; if (b > 2) { x = x / 3.0; } return x; }
+    static double F91(int a, int b) { double x = a * 0.5 + 91.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F92(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 2 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F93(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 93; }
+    static double F94(int a, int b) { double x = a * 0.5 + 94.25; if (b > 2) { x = x / 3.0; } return x; }
+    static string F95(int a, int b) { string t = "s95:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static string F96(int a, int b) { string t = "s96:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static int F97(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 7 - b; } if (s > 100) { s = s % 97; } return s; }
+    static double F98(int a, int b) { double x = a * 0.5 + 98.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F99(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 99; }
+    static string F100(int a, int b) { string t = "s100:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static string F101(int a, int b) { string t = "s101:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static double F102(int a, int b) { double x = a * 0.5 + 102.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F103(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 6 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F104(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 104; }
+    static int F105(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 105; }
+    static int F106(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 106; }
+    static int F107(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 3 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F108(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 108; }
+    static int F109(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 109; }
+    static double F110(int a, int b) { double x = a * 0.5 + 110.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F111(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 7 - b; } if (s > 100) { s = s % 97; } return s; }
+    static double F112(int a, int b) { double x = a * 0.5 + 112.25; if (b > 2) { x = x / 3.0; } return x; }
+    static int F113(int a, int b) { int[] v = new int[a + 3]; for (int j = 0; j < v.Length; j++) { v[j] = j * b; } total = total + v[a]; return v[1] + 113; }
+    static int F114(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 3 - b; } if (s > 100) { s = s % 97; } return s; }
+    static string F115(int a, int b) { string t = "s115:" + a; if (b % 2 == 0) { t = t + "!" + label; } return t; }
+    static int F116(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 5 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F117(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 6 - b; } if (s > 100) { s = s % 97; } return s; }
+    static int F118(int a, int b) { int s = 0; for (int j = 0; j < a; j++) { s = s + j * 7 - b; } if (s > 100) { s = s % 97; } return s; }
+    static double F119(int a, int b) { double x = a * 0.5 + 119.25; if (b > 2) { x = x / 3.0; } return x; }
+    static void Main() {
+        Console.WriteLine(F0(1, 0));
+        Console.WriteLine(F1(2, 1));
+        Console.WriteLine(F2(3, 2));
+        Console.WriteLine(F3(4, 3));
+        Console.WriteLine(F4(5, 4));
+        Console.WriteLine(F5(6, 0));
+        Console.WriteLine(F6(7, 1));
+        Console.WriteLine(F7(8, 2));
+        Console.WriteLine(F8(9, 3));
+        Console.WriteLine(F9(1, 4));
+        Console.WriteLine(F10(2, 0));
+        Console.WriteLine(F11(3, 1));
+        Console.WriteLine(F12(4, 2));
+        Console.WriteLine(F13(5, 3));
+        Console.WriteLine(F14(6, 4));
+        Console.WriteLine(F15(7, 0));
+        Console.WriteLine(F16(8, 1));
+        Console.WriteLine(F17(9, 2));
+        Console.WriteLine(F18(1, 3));
+        Console.WriteLine(F19(2, 4));
+        Console.WriteLine(F20(3, 0));
+        Console.WriteLine(F21(4, 1));
+        Console.WriteLine(F22(5, 2));
+        Console.WriteLine(F23(6, 3));
+        Console.WriteLine(F24(7, 4));
+        Console.WriteLine(F25(8, 0));
+        Console.WriteLine(F26(9, 1));
+        Console.WriteLine(F27(1, 2));
+        Console.WriteLine(F28(2, 3));
+        Console.WriteLine(F29(3, 4));
+        Console.WriteLine(F30(4, 0));
+        Console.WriteLine(F31(5, 1));
+        Console.WriteLine(F32(6, 2));
+        Console.WriteLine(F33(7, 3));
+        Console.WriteLine(F34(8, 4));
+        Console.WriteLine(F35(9, 0));
+        Console.WriteLine(F36(1, 1));
+        Console.WriteLine(F37(2, 2));
+        Console.WriteLine(F38(3, 3));
+        Console.WriteLine(F39(4, 4));
+        Console.WriteLine(F40(5, 0));
+        Console.WriteLine(F41(6, 1));
+        Console.WriteLine(F42(7, 2));
+        Console.WriteLine(F43(8, 3));
+        Console.WriteLine(F44(9, 4));
+        Console.WriteLine(F45(1, 0));
+        Console.WriteLine(F46(2, 1));
+        Console.WriteLine(F47(3, 2));
+        Console.WriteLine(F48(4, 3));
+        Console.WriteLine(F49(5, 4));
+        Console.WriteLine(F50(6, 0));
+        Console.WriteLine(F51(7, 1));
+        Console.WriteLine(F52(8, 2));
+        Console.WriteLine(F53(9, 3));
+        Console.WriteLine(F54(1, 4));
+        Console.WriteLine(F55(2, 0));
+        Console.WriteLine(F56(3, 1));
+        Console.WriteLine(F57(4, 2));
+        Console.WriteLine(F58(5, 3));
+        Console.WriteLine(F59(6, 4));
+        Console.WriteLine(F60(7, 0));
+        Console.WriteLine(F61(8, 1));
+        Console.WriteLine(F62(9, 2));
+        Console.WriteLine(F63(1, 3));
+        Console.WriteLine(F64(2, 4));
+        Console.WriteLine(F65(3, 0));
+        Console.WriteLine(F66(4, 1));
+        Console.WriteLine(F67(5, 2));
+        Console.WriteLine(F68(6, 3));
+        Console.WriteLine(F69(7, 4));
+        Console.WriteLine(F70(8, 0));
+        Console.WriteLine(F71(9, 1));
+        Console.WriteLine(F72(1, 2));
+        Console.WriteLine(F73(2, 3));
+        Console.WriteLine(F74(3, 4));
+        Console.WriteLine(F75(4, 0));
+        Console.WriteLine(F76(5, 1));
+        Console.WriteLine(F77(6, 2));
+        Console.WriteLine(F78(7, 3));
+        Console.WriteLine(F79(8, 4));
+        Console.WriteLine(F80(9, 0));
+        Console.WriteLine(F81(1, 1));
+        Console.WriteLine(F82(2, 2));
+        Console.WriteLine(F83(3, 3));
+        Console.WriteLine(F84(4, 4));
+        Console.WriteLine(F85(5, 0));
+        Console.WriteLine(F86(6, 1));
+        Console.WriteLine(F87(7, 2));
+        Console.WriteLine(F88(8, 3));
+        Console.WriteLine(F89(9, 4));
+        Console.WriteLine(F90(1, 0));
+        Console.WriteLine(F91(2, 1));
+        Console.WriteLine(F92(3, 2));
+        Console.WriteLine(F93(4, 3));
+        Console.WriteLine(F94(5, 4));
+        Console.WriteLine(F95(6, 0));
+        Console.WriteLine(F96(7, 1));
+        Console.WriteLine(F97(8, 2));
+        Console.WriteLine(F98(9, 3));
+        Console.WriteLine(F99(1, 4));
+        Console.WriteLine(F100(2, 0));
+        Console.WriteLine(F101(3, 1));
+        Console.WriteLine(F102(4, 2));
+        Console.WriteLine(F103(5, 3));
+        Console.WriteLine(F104(6, 4));
+        Console.WriteLine(F105(7, 0));
+        Console.WriteLine(F106(8, 1));
+        Console.WriteLine(F107(9, 2));
+        Console.WriteLine(F108(1, 3));
+        Console.WriteLine(F109(2, 4));
+        Console.WriteLine(F110(3, 0));
+        Console.WriteLine(F111(4, 1));
+        Console.WriteLine(F112(5, 2));
+        Console.WriteLine(F113(6, 3));
+        Console.WriteLine(F114(7, 4));
+        Console.WriteLine(F115(8, 0));
+        Console.WriteLine(F116(9, 1));
+        Console.WriteLine(F117(1, 2));
+        Console.WriteLine(F118(2, 3));
+        Console.WriteLine(F119(3, 4));
+        Console.WriteLine(total);
+    }
+}
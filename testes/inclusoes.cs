@@ -0,0 +1,10 @@
+#include "cabecalhos/constantes.h"
+#include "cabecalhos/constantes.h"
+#include <limites.h>
+#include "nao existe.h"
+class Inclusoes {
+    static int Dobro(int x) { return x * 2; }
+    static void Main() {
+        Console.WriteLine(Dobro(21));
+    }
+}
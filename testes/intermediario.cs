@@ -0,0 +1,16 @@
+class P {
+    static double scale = 1.5;
+    static int Fib(int n) { if (n < 2) return n; return Fib(n - 1) + Fib(n - 2); }
+    static void Main() {
+        int s = 0;
+        double d = 2;
+        for (int i = 0; i < 10 && s < 100 || i == 3; i++) { s += i * 2; d *= scale; }
+        string t = "s=" + s + " d=" + d;
+        Console.WriteLine(t);
+        printf("%d %f\n", Fib(10), Math.Sqrt(d));
+        int[] a = new int[4];
+        a[1]++;
+        char c = 'a';
+        int m = Math.Max(s, 3);
+    }
+}
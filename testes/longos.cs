@@ -0,0 +1,9 @@
+class Longos {
+    static int quantidadeDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTexto;
+    static void Main() {
+        quantidadeDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTexto = 42;
+        string texto = "abcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghij";
+        Console.WriteLine(texto.Length);
+        Console.WriteLine(quantidadeDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTextoDeElementosMuitoLongaParaCaberNoTexto + 1);
+    }
+}
@@ -0,0 +1,26 @@
+class X {
+    static int counter;
+    static string tag = "t";
+    static void Main() {
+        double a = -0.0, nan = 0.0 / 0.0;
+        Console.WriteLine(a == 0.0);
+        Console.WriteLine(nan == nan);
+        Console.WriteLine(nan != nan);
+        Console.WriteLine(nan < 1.0);
+        Console.WriteLine(1.0 <= nan);
+        Console.WriteLine(Math.Abs(-2.5) + Math.Sqrt(16.0) + Math.Pow(2.0, 10.0));
+        Console.WriteLine(Math.Max(-3, -9) * Math.Min(7, 2) + Math.Abs(-11));
+        Console.WriteLine(-7 / 2 + " " + -7 % 2 + " " + 7.5 % 2.0);
+        string e = "ab" + "c";
+        Console.WriteLine(e == "abc");
+        Console.WriteLine(e != "abc");
+        Console.WriteLine(7 / -2);
+        char ch = 'A';
+        Console.WriteLine(ch + 1);
+        Console.WriteLine(tag + ch + 2.5 + true);
+        int big = 2147483647;
+        Console.WriteLine(big + 1);
+        int zero = counter - counter;
+        Console.WriteLine(10 / zero);
+    }
+}
@@ -0,0 +1,17 @@
+class Q {
+    static int F(int n, int k) {
+        int total = 0;
+        while (n > 0) {
+            for (int j = 0; j < k; j++) {
+                int inv = k * 4 + 1;
+                if (j == 2) total = total - 1;
+                if (j > 5) n = n - 1;
+                total += inv + j;
+            }
+            n--;
+        }
+        if (1 < 2) total = total + 0; else total = 99;
+        return total * 1;
+    }
+    static void Main() { int a = 3; int b = a; printf("%d\n", F(b, 7) / 0); }
+}
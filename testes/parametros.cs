@@ -0,0 +1,10 @@
+class X {
+    static int Many(int a, int b, int c, int d, int e, int f, int g, int h, int i, int j) {
+        int x1 = a + b, x2 = b + c, x3 = c + d, x4 = d + e, x5 = e + f, x6 = f + g, x7 = g + h, x8 = h + i, x9 = i + j;
+        int y = x1 * x2 - x3 * x4 + x5 * x6 - x7 * x8 + x9;
+        return y + x1 + x2 + x3 + x4 + x5 + x6 + x7 + x8 + x9 + a * j;
+    }
+    static void Main() {
+        printf("many=%d\n", Many(1, 2, 3, 4, 5, 6, 7, 8, 9, 10));
+    }
+}
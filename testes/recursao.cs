@@ -0,0 +1,11 @@
+class X {
+    static int Fib(int n) { if (n < 2) return n; return Fib(n - 1) + Fib(n - 2); }
+    static void Main() {
+        int p = 1, q = 2, r = 3, s = 4, t = 5, u = 6, v = 7, w2 = 8, y = 9;
+        for (int k = 0; k < 100; k++) {
+            p = p + q; q = q + r; r = r + s * 3; s = s - t; t = t + u % 5; u = u + v; v = v * 3 % 1000; w2 = w2 + y; y = y - k;
+            if (Fib(5) > 100) { p = 0; }
+        }
+        Console.WriteLine("{0} {1} {2} {3} {4} {5} {6} {7} {8}", p, q, r, s, t, u, v, w2, y);
+    }
+}
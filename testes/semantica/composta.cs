@@ -0,0 +1,10 @@
+// Atribuição composta na declaração: 'b' ainda não tem valor
+class Composta {
+    static void Main() {
+        float a = 1.5;
+        float b += 3.14;
+        int c = 2;
+        c += 3;
+        printf("%f %d\n", a, c);
+    }
+}
@@ -0,0 +1,14 @@
+// Nomes não declarados: variável, variável de outro método e função
+class Indefinido {
+    static int Dobro(int x) {
+        int local = x * 2;
+        return local;
+    }
+    static void Main() {
+        int total = 0;
+        total = total + contador;
+        total = local;
+        total = Triplo(total);
+        printf("%d\n", total + Dobro(1));
+    }
+}
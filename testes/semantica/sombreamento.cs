@@ -0,0 +1,32 @@
+// Sombreamento entre escopos aninhados: o nome interno oculta o externo só até o fim do seu escopo
+// (como em C, um escopo aninhado pode redeclarar um nome; só a redeclaração no mesmo escopo é erro)
+class Sombreamento {
+    static bool valor = true;
+    static int Soma(int n) {
+        int valor = n;
+        int total = valor + 1;
+        for (int i = 0; i < n; i++) {
+            bool valor = i > 1;
+            int errado = valor;
+            {
+                double valor = 2.5;
+                int truncado = valor;
+                bool condicao = valor;
+            }
+            if (valor) {
+                total = total + i;
+            }
+        }
+        {
+            int interno = 1;
+            int interno = 2;
+        }
+        total = total + interno;
+        return valor + total;
+    }
+    static void Main() {
+        bool b = valor;
+        int x = valor;
+        printf("%d\n", Soma(3));
+    }
+}
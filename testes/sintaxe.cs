@@ -0,0 +1,29 @@
+using System;
+using System.Collections;
+
+namespace Demo {
+    public class Program {
+        private int count = 0, total;
+        static double ratio;
+
+        public Program(int start) { count = start; }
+
+        public static int Soma(int a, int b) {
+            return a + b * 2 - (a / b);
+        }
+
+        static void Main(string[] args) {
+            int[] v = new int[10];
+            string s = "oi // nao e comentario \" fim";
+            char c = 'x';
+            bool ok = !false;
+            for (int i = 0; i < 10; i = i + 1) {
+                v[i] = Soma(i, 2);
+                if (v[i] >= 5) total += v[i]; else total -= 1;
+            }
+            while (count != 0) { count = count - 1; }
+            try { Console.WriteLine(s); } catch (Exception e) { Console.WriteLine("erro"); }
+            Program p = new Program(3);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * Teste da análise léxica sob a localidade do ambiente
+ *
+ * Adota a categoria LC_CTYPE do ambiente (setlocale(LC_CTYPE, "")), o que
+ * nenhum programa da raiz faz, e exibe os tokens de cada arquivo como a
+ * análise léxica. Executado com LC_ALL=C e com outra localidade, confere que
+ * a classificação dos caracteres (charClasses) não depende dela, inclusive
+ * nos bytes acima de 127.
+ *
+ * Termina com código 1 se a localidade do ambiente não existir.
+ */
+
+#include <locale.h>
+
+#include "../analise lexica.h"
+
+// Função principal
+int main(int argc, char *argv[]) {
+    if (!setlocale(LC_CTYPE, "")) {
+        fprintf(stderr, "Erro: Localidade do ambiente indisponível.\n");
+        return EXIT_FAILURE;
+    }
+    int status = EXIT_SUCCESS;
+    for (int i = 1; i < argc; i++) {
+        long size;
+        char *code = readSourceFile(argv[i], &size);
+        if (!code) {
+            status = EXIT_FAILURE;
+            continue;
+        }
+        printf("Arquivo: %s\n", argv[i]);
+        tokenCount = 0;
+        lexicalAnalysis(code);
+        for (int t = 0; t < tokenCount; t++) {
+            int line, column;
+            offsetToLocation(tokens[t].offset, &line, &column);
+            printf("Token: %-15s Linha: %-4d Coluna: %-4d Tipo: %-19s Tamanho: %-3d Byte\n", tokens[t].value, line,
+                   column, tokenTypeToString(tokens[t].type), tokens[t].size);
+        }
+        freeTokens();
+        freeLineIndex();
+        free(code);
+    }
+    return status;
+}
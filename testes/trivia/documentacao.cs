@@ -0,0 +1,18 @@
+// Trivia: espaços, comentários de linha e de bloco e comentários de documentação
+/// <summary>Soma dois números</summary>
+/// <param name="a">primeiro</param>
+//// quatro barras: comentário comum
+class Documentada {
+    /** Campo documentado em bloco */
+    static int campo = 1;
+    /*** três estrelas: comentário comum */
+    /**/
+    static int semDocumentacao = 2; // fim de linha
+
+    /// Linha única
+    /* comum entre a documentação e o método */
+    static void Main() {
+        printf("%d\n", campo + semDocumentacao);	/* tabulação antes */
+    }
+}
+/// Documentação no fim do arquivo, sem token depois
@@ -0,0 +1,12 @@
+class Programa {
+    static double escala = 1.5;
+    static int somaDosNúmeros(int límite) {
+        int total = 0;
+        for (int í = 0; í < límite; í++) total = total + í;
+        return total;
+    }
+    static void Main() {
+        int 结果 = somaDosNúmeros(10);
+        printf("%d %f\n", 结果, escala);
+    }
+}
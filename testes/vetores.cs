@@ -0,0 +1,9 @@
+class X {
+    static double scale = 1.5;
+    static double[] weights;
+    static void Main() {
+        weights = new double[5];
+        for (int i = 0; i < weights.Length; i++) weights[i] = i * scale - 2.25;
+        printf("%f\n", weights[3]);
+    }
+}
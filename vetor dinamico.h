@@ -0,0 +1,39 @@
+/*
+ * Vetores dinâmicos
+ *
+ * Função comum para aumentar os vetores que crescem com realloc (código
+ * intermediário, máquina virtual, código de máquina, inclusão de arquivos,
+ * índice de tokens e tabela de pedaços), com a contagem de elementos em 32
+ * bits. A capacidade começa em 16 e dobra; se o vetor não couber em
+ * UINT32_MAX elementos ou na memória, o programa é abandonado.
+ */
+
+#ifndef VETOR_DINAMICO_H
+#define VETOR_DINAMICO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Função para garantir espaço para 'needed' elementos de 'elementSize' bytes em um vetor dinâmico
+void *vectorGrow(void *array, uint32_t *capacity, uint64_t needed, size_t elementSize) {
+    if (needed <= *capacity) {
+        return array;
+    }
+    uint64_t grown = *capacity ? *capacity : 16;
+    while (grown < needed) {
+        grown *= 2;
+    }
+    if (grown > UINT32_MAX && needed <= UINT32_MAX) {
+        grown = UINT32_MAX;
+    }
+    void *block = grown <= UINT32_MAX && grown <= SIZE_MAX / elementSize ? realloc(array, grown * elementSize) : NULL;
+    if (!block) {
+        fprintf(stderr, "Erro: Falha ao aumentar um vetor para %llu elemento(s).\n", (unsigned long long)needed);
+        exit(EXIT_FAILURE);
+    }
+    *capacity = (uint32_t)grown;
+    return block;
+}
+
+#endif